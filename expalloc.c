@@ -0,0 +1,308 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expalloc.c implements expalloc.h. A program in static single         */
+/*assignment form is one block in order, so the life of a result is the*/
+/*interval from its instruction to its last use and a linear scan in   */
+/*program order is exact: it never holds more registers than results   */
+/*are live at once. Spilled results are chosen in one scan and given   */
+/*scratch slots in a second, since a result is spilled only once it is */
+/*already live, too late to take a slot freed before it started        */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "expalloc.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the holder of a register no result holds                      */
+/*---------------------------------------------------------------------*/
+#define NO_HOLDER (~0u)
+
+/*---------------------------------------------------------------------*/
+/*An ExpAlloc holds, for every instruction of its program, the last    */
+/*instruction that uses its result, the register or scratch slot of the*/
+/*result and whether it is spilled, with the counts reported           */
+/*---------------------------------------------------------------------*/
+struct ExpAlloc
+{
+  ExpSSA_T oExpSSA;
+  /*last instruction using each result, its own if none does*/
+  unsigned int* puiLast;
+  /*register or scratch slot of each result*/
+  unsigned int* puiPlaces;
+  /*nonzero for each result in the scratch array*/
+  char* pcSpilled;
+  unsigned int uiMaxLive;
+  unsigned int uiRegisters;
+  unsigned int uiScratch;
+  unsigned int uiSpilled;
+};
+
+/*---------------------------------------------------------------------*/
+/*Store in *puiArgs the instructions whose result instruction          */
+/*uiInstruction of oExpAlloc uses for the last time, once each, and    */
+/*return how many there are                                            */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpAlloc_ending(ExpAlloc_T oExpAlloc,\
+				    unsigned int uiInstruction,\
+				    unsigned int* puiArgs){
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned int uiArg, uiSeen, uiValue, uiFirst, uiEnding = 0u;
+  piInstruction = ExpSSA_instruction(oExpAlloc -> oExpSSA, uiInstruction);
+  uiFirst = ExpSSA_firstInstruction(oExpAlloc -> oExpSSA);
+  for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++){
+    uiValue = piInstruction -> puiArgs[uiArg];
+    if(uiValue < uiFirst ||\
+       oExpAlloc -> puiLast[uiValue - uiFirst] != uiInstruction)
+      continue;
+    //x*x ends x once
+    for(uiSeen = 0u; uiSeen < uiEnding; uiSeen++)
+      if(puiArgs[uiSeen] == uiValue - uiFirst)
+	break;
+    if(uiSeen == uiEnding)
+      puiArgs[uiEnding++] = uiValue - uiFirst;
+  }
+  return uiEnding;
+}
+
+/*---------------------------------------------------------------------*/
+/*Place the results of oExpAlloc that are not spilled in registers,    */
+/*spilling some if there are more than uiRegisters live at once, using */
+/*puiFree, with room for a register per instruction, for the free      */
+/*registers and puiHolders for the result holding each register        */
+/*---------------------------------------------------------------------*/
+static void ExpAlloc_registers(ExpAlloc_T oExpAlloc,\
+			       unsigned int uiRegisters,\
+			       unsigned int* puiFree,\
+			       unsigned int* puiHolders){
+  unsigned int puiArgs[EXPSSA_MAX_ARGS];
+  unsigned int uiInstruction, uiEnding, uiIndex, uiRegister, uiHolder;
+  unsigned int uiFree = 0u, uiLive = 0u;
+  unsigned int* puiLast = oExpAlloc -> puiLast;
+  for(uiInstruction = 0u;\
+      uiInstruction < ExpSSA_instructions(oExpAlloc -> oExpSSA);\
+      uiInstruction++){
+    //an operand used for the last time frees its register to the result
+    uiEnding = ExpAlloc_ending(oExpAlloc, uiInstruction, puiArgs);
+    for(uiIndex = 0u; uiIndex < uiEnding; uiIndex++){
+      uiLive--;
+      if(oExpAlloc -> pcSpilled[puiArgs[uiIndex]] != 0)
+	continue;
+      uiRegister = oExpAlloc -> puiPlaces[puiArgs[uiIndex]];
+      puiHolders[uiRegister] = NO_HOLDER;
+      puiFree[uiFree++] = uiRegister;
+    }
+    if(++uiLive > oExpAlloc -> uiMaxLive)
+      oExpAlloc -> uiMaxLive = uiLive;
+    if(uiFree > 0u)
+      uiRegister = puiFree[--uiFree];
+    else if(uiRegisters == EXPALLOC_UNLIMITED ||\
+	    oExpAlloc -> uiRegisters < uiRegisters)
+      uiRegister = oExpAlloc -> uiRegisters++;
+    else{
+      //every register is held, so the result used furthest ahead spills
+      uiRegister = 0u;
+      for(uiIndex = 1u; uiIndex < oExpAlloc -> uiRegisters; uiIndex++)
+	if(puiLast[puiHolders[uiIndex]] > puiLast[puiHolders[uiRegister]])
+	  uiRegister = uiIndex;
+      uiHolder = puiHolders[uiRegister];
+      oExpAlloc -> uiSpilled++;
+      if(puiLast[uiHolder] > puiLast[uiInstruction])
+	oExpAlloc -> pcSpilled[uiHolder] = 1;
+      else{
+	oExpAlloc -> pcSpilled[uiInstruction] = 1;
+	uiRegister = NO_HOLDER;
+      }
+    }
+    if(uiRegister != NO_HOLDER){
+      oExpAlloc -> puiPlaces[uiInstruction] = uiRegister;
+      puiHolders[uiRegister] = uiInstruction;
+    }
+    //a result nothing uses again is only stored to its outputs
+    if(puiLast[uiInstruction] == uiInstruction){
+      uiLive--;
+      if(uiRegister != NO_HOLDER){
+	puiHolders[uiRegister] = NO_HOLDER;
+	puiFree[uiFree++] = uiRegister;
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Place the spilled results of oExpAlloc in scratch slots, sharing them*/
+/*as registers are shared, using puiFree for the free slots            */
+/*---------------------------------------------------------------------*/
+static void ExpAlloc_scratch(ExpAlloc_T oExpAlloc, unsigned int* puiFree){
+  unsigned int puiArgs[EXPSSA_MAX_ARGS];
+  unsigned int uiInstruction, uiEnding, uiIndex, uiFree = 0u;
+  for(uiInstruction = 0u;\
+      uiInstruction < ExpSSA_instructions(oExpAlloc -> oExpSSA);\
+      uiInstruction++){
+    uiEnding = ExpAlloc_ending(oExpAlloc, uiInstruction, puiArgs);
+    for(uiIndex = 0u; uiIndex < uiEnding; uiIndex++)
+      if(oExpAlloc -> pcSpilled[puiArgs[uiIndex]] != 0)
+	puiFree[uiFree++] = oExpAlloc -> puiPlaces[puiArgs[uiIndex]];
+    if(oExpAlloc -> pcSpilled[uiInstruction] == 0)
+      continue;
+    oExpAlloc -> puiPlaces[uiInstruction] = (uiFree > 0u) ?\
+      puiFree[--uiFree] : oExpAlloc -> uiScratch++;
+    if(oExpAlloc -> puiLast[uiInstruction] == uiInstruction)
+      puiFree[uiFree++] = oExpAlloc -> puiPlaces[uiInstruction];
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Place the results of the instructions of oExpSSA                     */
+/*---------------------------------------------------------------------*/
+ExpAlloc_T ExpAlloc_new(ExpSSA_T oExpSSA, unsigned int uiRegisters){
+  ExpAlloc_T oExpAlloc;
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned int* puiFree;
+  unsigned int* puiHolders;
+  unsigned int uiInstruction, uiArg, uiFirst, uiInstructions;
+  assert(oExpSSA != NULL);
+  uiInstructions = ExpSSA_instructions(oExpSSA);
+  uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  oExpAlloc = (ExpAlloc_T)calloc(1u, sizeof(struct ExpAlloc));
+  if(oExpAlloc == NULL)
+    return NULL;
+  oExpAlloc -> oExpSSA = oExpSSA;
+  oExpAlloc -> puiLast = (unsigned int*)malloc((uiInstructions + 1u) *\
+					       sizeof(unsigned int));
+  oExpAlloc -> puiPlaces = (unsigned int*)malloc((uiInstructions + 1u) *\
+						 sizeof(unsigned int));
+  oExpAlloc -> pcSpilled = (char*)calloc(uiInstructions + 1u, sizeof(char));
+  puiFree = (unsigned int*)malloc((uiInstructions + 1u) *\
+				  sizeof(unsigned int));
+  puiHolders = (unsigned int*)malloc((uiInstructions + 1u) *\
+				     sizeof(unsigned int));
+  if(oExpAlloc -> puiLast == NULL || oExpAlloc -> puiPlaces == NULL ||\
+     oExpAlloc -> pcSpilled == NULL || puiFree == NULL ||\
+     puiHolders == NULL){
+    free(puiFree);
+    free(puiHolders);
+    ExpAlloc_free(oExpAlloc);
+    return NULL;
+  }
+  //instructions only use earlier values, so the last user is found last
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++){
+    oExpAlloc -> puiLast[uiInstruction] = uiInstruction;
+    piInstruction = ExpSSA_instruction(oExpSSA, uiInstruction);
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++)
+      if(piInstruction -> puiArgs[uiArg] >= uiFirst)
+	oExpAlloc -> puiLast[piInstruction -> puiArgs[uiArg] - uiFirst] =\
+	  uiInstruction;
+  }
+  ExpAlloc_registers(oExpAlloc, uiRegisters, puiFree, puiHolders);
+  ExpAlloc_scratch(oExpAlloc, puiFree);
+  free(puiFree);
+  free(puiHolders);
+  return oExpAlloc;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpAlloc                                                       */
+/*---------------------------------------------------------------------*/
+void ExpAlloc_free(ExpAlloc_T oExpAlloc){
+  if(oExpAlloc == NULL)
+    return;
+  free(oExpAlloc -> puiLast);
+  free(oExpAlloc -> puiPlaces);
+  free(oExpAlloc -> pcSpilled);
+  free(oExpAlloc);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the counts of oExpAlloc                                        */
+/*---------------------------------------------------------------------*/
+void ExpAlloc_counts(ExpAlloc_T oExpAlloc, unsigned int* puiMaxLive,\
+		     unsigned int* puiRegisters, unsigned int* puiScratch,\
+		     unsigned int* puiSpilled){
+  assert(oExpAlloc != NULL);
+  *puiMaxLive = oExpAlloc -> uiMaxLive;
+  *puiRegisters = oExpAlloc -> uiRegisters;
+  *puiScratch = oExpAlloc -> uiScratch;
+  *puiSpilled = oExpAlloc -> uiSpilled;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return whether instruction uiInstruction of oExpAlloc is spilled     */
+/*---------------------------------------------------------------------*/
+int ExpAlloc_isSpilled(ExpAlloc_T oExpAlloc, unsigned int uiInstruction){
+  assert(oExpAlloc != NULL);
+  assert(uiInstruction < ExpSSA_instructions(oExpAlloc -> oExpSSA));
+  return oExpAlloc -> pcSpilled[uiInstruction];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the place of instruction uiInstruction of oExpAlloc           */
+/*---------------------------------------------------------------------*/
+unsigned int ExpAlloc_place(ExpAlloc_T oExpAlloc, unsigned int uiInstruction){
+  assert(oExpAlloc != NULL);
+  assert(uiInstruction < ExpSSA_instructions(oExpAlloc -> oExpSSA));
+  return oExpAlloc -> puiPlaces[uiInstruction];
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expalloc.c                                                      */
+/*---------------------------------------------------------------------*/
+/*
+#include <stdio.h>
+#include "exptokentree.h"
+#include "exptoken.h"
+
+int main(void){
+  ExpProgram_T oExpProgram;
+  ExpSSA_T oExpSSA;
+  ExpAlloc_T oExpAlloc;
+  LinkList_T pllTrees;
+  unsigned int uiMaxLive, uiRegisters, uiScratch, uiSpilled;
+
+  //#0 = a*b, #1 = c*d, #2 = #0+#1, #3 = #2*#0, output #3: #0 lives
+  //until #3 and #1 until #2, so at most two results are live at once
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("c"),\
+				      ExpTokenTree_newLeaf("d")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("#1")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("#2"),\
+				      ExpTokenTree_newLeaf("#0")));
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf("#3"));
+  oExpSSA = ExpSSA_new(oExpProgram, pllTrees);
+  oExpAlloc = ExpAlloc_new(oExpSSA, EXPALLOC_UNLIMITED);
+  if(oExpSSA == NULL || oExpAlloc == NULL)
+    printf("failed test 1\n");
+  ExpAlloc_counts(oExpAlloc, &uiMaxLive, &uiRegisters, &uiScratch,\
+		  &uiSpilled);
+  if(uiMaxLive != 2u || uiRegisters != 2u || uiScratch != 0u ||\
+     uiSpilled != 0u)
+    printf("failed test 2\n");
+  //#1 frees its register to #2, and #0, freed after #2, its own to #3
+  if(ExpAlloc_place(oExpAlloc, 2u) != ExpAlloc_place(oExpAlloc, 1u) ||\
+     ExpAlloc_place(oExpAlloc, 3u) != ExpAlloc_place(oExpAlloc, 0u))
+    printf("failed test 3\n");
+  ExpAlloc_free(oExpAlloc);
+  //with one register, #0, used furthest ahead, goes to scratch
+  oExpAlloc = ExpAlloc_new(oExpSSA, 1u);
+  ExpAlloc_counts(oExpAlloc, &uiMaxLive, &uiRegisters, &uiScratch,\
+		  &uiSpilled);
+  if(uiMaxLive != 2u || uiRegisters != 1u || uiScratch != 1u ||\
+     uiSpilled != 1u || !ExpAlloc_isSpilled(oExpAlloc, 0u) ||\
+     ExpAlloc_isSpilled(oExpAlloc, 1u))
+    printf("failed test 4\n");
+  ExpAlloc_free(oExpAlloc);
+  ExpSSA_free(oExpSSA);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
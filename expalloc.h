@@ -0,0 +1,68 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expalloc.h describes a register allocator over the static single     */
+/*assignment form of a program. Instructions whose results are not     */
+/*live at once share a local, so generated code declares as many       */
+/*locals as values are ever live together rather than one per          */
+/*instruction, and a budget of locals may spill the rest to an array   */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPALLOC_INCLUDED
+#define EXPALLOC_INCLUDED
+
+#include "expssa.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the budget of registers that places no limit on them          */
+/*---------------------------------------------------------------------*/
+#define EXPALLOC_UNLIMITED 0u
+
+/*---------------------------------------------------------------------*/
+/*An ExpAlloc is the place of the result of every instruction of a     */
+/*program: a register, one of a set of locals, or a slot of a scratch  */
+/*array, held from the instruction to the last instruction that uses   */
+/*it. An instruction used only as an output is stored to it at once,   */
+/*so holds its place for that instruction alone                        */
+/*---------------------------------------------------------------------*/
+typedef struct ExpAlloc* ExpAlloc_T;
+
+/*---------------------------------------------------------------------*/
+/*Place the results of the instructions of oExpSSA by a linear scan in */
+/*program order, in at most uiRegisters registers, or as many as are   */
+/*needed if uiRegisters is EXPALLOC_UNLIMITED, and return the result,  */
+/*or NULL if memory is insufficient. When every register is taken, the */
+/*result used furthest ahead, the new one or one already placed, goes  */
+/*to the scratch array for its whole life, and the scratch slots are   */
+/*shared the same way. The ExpAlloc refers to oExpSSA, which must      */
+/*outlive it                                                           */
+/*---------------------------------------------------------------------*/
+ExpAlloc_T ExpAlloc_new(ExpSSA_T oExpSSA, unsigned int uiRegisters);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpAlloc                                */
+/*---------------------------------------------------------------------*/
+void ExpAlloc_free(ExpAlloc_T oExpAlloc);
+
+/*---------------------------------------------------------------------*/
+/*Store in *puiMaxLive the most results of oExpAlloc live at once, in  */
+/**puiRegisters the number of registers used, in *puiScratch the size  */
+/*of the scratch array, and in *puiSpilled the number of results placed*/
+/*in it                                                                */
+/*---------------------------------------------------------------------*/
+void ExpAlloc_counts(ExpAlloc_T oExpAlloc, unsigned int* puiMaxLive,\
+		     unsigned int* puiRegisters, unsigned int* puiScratch,\
+		     unsigned int* puiSpilled);
+
+/*---------------------------------------------------------------------*/
+/*Return nonzero if the result of instruction uiInstruction of         */
+/*oExpAlloc is in the scratch array, and zero if it is in a register   */
+/*---------------------------------------------------------------------*/
+int ExpAlloc_isSpilled(ExpAlloc_T oExpAlloc, unsigned int uiInstruction);
+
+/*---------------------------------------------------------------------*/
+/*Return the register or scratch slot, as ExpAlloc_isSpilled tells, of */
+/*the result of instruction uiInstruction of oExpAlloc                 */
+/*---------------------------------------------------------------------*/
+unsigned int ExpAlloc_place(ExpAlloc_T oExpAlloc, unsigned int uiInstruction);
+
+#endif
@@ -0,0 +1,623 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbalance.c implements expbalance.h. The statements are visited in  */
+/*order, so the depth of every temporary is known before it is used.   */
+/*The terms of a sum or product are gathered with the nodes that joined*/
+/*them, and the same nodes are then relinked into the balanced tree, so*/
+/*regrouping moves subtrees and never allocates them                   */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expbalance.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of the arrays of a chain                 */
+/*---------------------------------------------------------------------*/
+#define INITIAL_TERMS 16u
+
+/*---------------------------------------------------------------------*/
+/*A BalanceTerm is a subtree joined into a sum or product, and the     */
+/*number of operations on its critical path                            */
+/*---------------------------------------------------------------------*/
+struct BalanceTerm
+{
+  TreeNode_T oTreeNode;
+  unsigned int uiDepth;
+};
+
+/*---------------------------------------------------------------------*/
+/*A BalanceChain is a sum or product being regrouped: its terms, and   */
+/*the binary nodes that joined them, the root first                    */
+/*---------------------------------------------------------------------*/
+struct BalanceChain
+{
+  /*ADD or MULTIPLY*/
+  enum ExpTokenType ettType;
+  /*the terms, and space to combine them, uiMaxTerms of each*/
+  struct BalanceTerm* ptTerms;
+  struct BalanceTerm* ptQueue;
+  unsigned int uiTerms;
+  unsigned int uiMaxTerms;
+  /*the nodes that joined the terms*/
+  TreeNode_T* poOps;
+  unsigned int uiOps;
+  unsigned int uiMaxOps;
+};
+
+/*---------------------------------------------------------------------*/
+/*A Balance is the state of the pass over one program                  */
+/*---------------------------------------------------------------------*/
+struct Balance
+{
+  ExpProgram_T oExpProgram;
+  /*uses of each temporary, outputs included*/
+  unsigned int* puiUses;
+  /*critical path of each statement visited so far*/
+  unsigned int* puiDepths;
+  unsigned int uiLength;
+  /*largest shared temporary that may be copied, in operations*/
+  unsigned int uiMaxCopy;
+  /*operations added by copies*/
+  unsigned int uiCopied;
+  /*set if memory ran out on the way*/
+  int iMemoryError;
+};
+
+static unsigned int ExpBalance_tree(struct Balance* poBalance,\
+				    TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token of oTreeNode                            */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpBalance_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 and store the number of the temporary in *puiIndex if       */
+/*oTreeNode is a temporary k with k < uiLength, 0 if not               */
+/*---------------------------------------------------------------------*/
+static int ExpBalance_isTemp(TreeNode_T oTreeNode, unsigned int uiLength,\
+			     unsigned int* puiIndex){
+  return TreeNode_isLeaf(oTreeNode) &&\
+    ExpProgram_isTemp(ExpToken_getName(ExpTokenTree_getValue(oTreeNode)),\
+		      puiIndex) && *puiIndex < uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the critical path of oTreeNode, given the critical path of    */
+/*each of the uiLength temporaries in puiDepths                        */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_depth(TreeNode_T oTreeNode,\
+				     const unsigned int* puiDepths,\
+				     unsigned int uiLength){
+  LinkList_T oLinkList;
+  unsigned int uiIndex, uiDepth = 0u, uiChild;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return ExpBalance_isTemp(oTreeNode, uiLength, &uiIndex) ?\
+      puiDepths[uiIndex] : 0u;
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList)){
+    uiChild = ExpBalance_depth((TreeNode_T)LinkList_getValue(oLinkList),\
+			       puiDepths, uiLength);
+    if(uiChild > uiDepth)
+      uiDepth = uiChild;
+  }
+  return uiDepth + 1u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations in oTreeNode                         */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_operations(TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned int uiOperations = 0u;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return 0u;
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    uiOperations +=\
+      ExpBalance_operations((TreeNode_T)LinkList_getValue(oLinkList));
+  return uiOperations + 1u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of nodes of type ettType joining the terms of the  */
+/*sum or product oTreeNode, itself included                            */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_chainSize(TreeNode_T oTreeNode,\
+					 enum ExpTokenType ettType){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild;
+  unsigned int uiSize = 1u;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    if(TreeNode_isLeaf(oTreeNodeChild) == 0 &&\
+       ExpBalance_type(oTreeNodeChild) == ettType)
+      uiSize += ExpBalance_chainSize(oTreeNodeChild, ettType);
+  }
+  return uiSize;
+}
+
+/*---------------------------------------------------------------------*/
+/*Append the critical paths of the terms of the sum or product         */
+/*oTreeNode to puiDepths, from *puiLength on, without changing it      */
+/*---------------------------------------------------------------------*/
+static void ExpBalance_termDepths(struct Balance* poBalance,\
+				  TreeNode_T oTreeNode,\
+				  enum ExpTokenType ettType,\
+				  unsigned int* puiDepths,\
+				  unsigned int* puiLength){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    if(TreeNode_isLeaf(oTreeNodeChild) == 0 &&\
+       ExpBalance_type(oTreeNodeChild) == ettType)
+      ExpBalance_termDepths(poBalance, oTreeNodeChild, ettType,\
+			    puiDepths, puiLength);
+    else
+      puiDepths[(*puiLength)++] =\
+	ExpBalance_depth(oTreeNodeChild, poBalance -> puiDepths,\
+			 poBalance -> uiLength);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Make room in pcChain for uiTerms more terms and uiOps more nodes.    */
+/*Return 0 if successful, 1 if memory is insufficient                  */
+/*---------------------------------------------------------------------*/
+static int ExpBalance_reserve(struct BalanceChain* pcChain,\
+			      unsigned int uiTerms, unsigned int uiOps){
+  struct BalanceTerm* ptTerms;
+  TreeNode_T* poOps;
+  unsigned int uiMax;
+  if(pcChain -> uiTerms + uiTerms > pcChain -> uiMaxTerms){
+    uiMax = 2u * (pcChain -> uiTerms + uiTerms);
+    ptTerms = (struct BalanceTerm*)realloc(pcChain -> ptTerms, uiMax *\
+					   sizeof(struct BalanceTerm));
+    if(ptTerms == NULL)
+      return 1;
+    pcChain -> ptTerms = ptTerms;
+    ptTerms = (struct BalanceTerm*)realloc(pcChain -> ptQueue, uiMax *\
+					   sizeof(struct BalanceTerm));
+    if(ptTerms == NULL)
+      return 1;
+    pcChain -> ptQueue = ptTerms;
+    pcChain -> uiMaxTerms = uiMax;
+  }
+  if(pcChain -> uiOps + uiOps > pcChain -> uiMaxOps){
+    uiMax = 2u * (pcChain -> uiOps + uiOps);
+    poOps = (TreeNode_T*)realloc(pcChain -> poOps,\
+				 uiMax * sizeof(TreeNode_T));
+    if(poOps == NULL)
+      return 1;
+    pcChain -> poOps = poOps;
+    pcChain -> uiMaxOps = uiMax;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Gather the terms of the sum or product oTreeNode, which is already in*/
+/*the nodes of pcChain, into pcChain. A temporary of the same type used*/
+/*only here is inlined and gathered too. Every other term is balanced  */
+/*first. Return 0 if successful, 1 if memory is insufficient, in which */
+/*case oTreeNode is still valid                                        */
+/*---------------------------------------------------------------------*/
+static int ExpBalance_collect(struct Balance* poBalance,\
+			      struct BalanceChain* pcChain,\
+			      TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild, oTreeNodeValue;
+  unsigned int uiIndex, uiDepth;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    //merging a temporary into the chain is inlining it
+    if(ExpBalance_isTemp(oTreeNodeChild, poBalance -> uiLength, &uiIndex) &&\
+       poBalance -> puiUses[uiIndex] == 1u){
+      oTreeNodeValue =\
+	ExpProgram_getValue(poBalance -> oExpProgram, uiIndex);
+      if(oTreeNodeValue != NULL && TreeNode_isLeaf(oTreeNodeValue) == 0 &&\
+	 ExpBalance_type(oTreeNodeValue) == pcChain -> ettType){
+	LinkList_setValue(oLinkList, ExpProgram_take\
+			  (poBalance -> oExpProgram, uiIndex));
+	ExpTokenTree_free(oTreeNodeChild);
+	poBalance -> puiUses[uiIndex] = 0u;
+	oTreeNodeChild = oTreeNodeValue;
+      }
+    }
+    if(TreeNode_isLeaf(oTreeNodeChild) == 0 &&\
+       ExpBalance_type(oTreeNodeChild) == pcChain -> ettType){
+      if(ExpBalance_reserve(pcChain, 0u, 1u) != 0)
+	return 1;
+      pcChain -> poOps[pcChain -> uiOps++] = oTreeNodeChild;
+      if(ExpBalance_collect(poBalance, pcChain, oTreeNodeChild) != 0)
+	return 1;
+      continue;
+    }
+    uiDepth = ExpBalance_tree(poBalance, oTreeNodeChild);
+    if(ExpBalance_reserve(pcChain, 1u, 0u) != 0)
+      return 1;
+    pcChain -> ptTerms[pcChain -> uiTerms].oTreeNode = oTreeNodeChild;
+    pcChain -> ptTerms[pcChain -> uiTerms++].uiDepth = uiDepth;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare two terms for qsort, shallowest first                        */
+/*---------------------------------------------------------------------*/
+static int ExpBalance_compareTerms(const void* pvTerm1, const void* pvTerm2){
+  unsigned int uiDepth1 = ((const struct BalanceTerm*)pvTerm1) -> uiDepth;
+  unsigned int uiDepth2 = ((const struct BalanceTerm*)pvTerm2) -> uiDepth;
+  return (uiDepth1 > uiDepth2) - (uiDepth1 < uiDepth2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare two depths for qsort                                         */
+/*---------------------------------------------------------------------*/
+static int ExpBalance_compareDepths(const void* pvDepth1,\
+				    const void* pvDepth2){
+  unsigned int uiDepth1 = *(const unsigned int*)pvDepth1;
+  unsigned int uiDepth2 = *(const unsigned int*)pvDepth2;
+  return (uiDepth1 > uiDepth2) - (uiDepth1 < uiDepth2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the critical path of the uiLength terms with the critical     */
+/*paths in puiDepths once combined two at a time, the two available    */
+/*earliest first. puiDepths is sorted, and puiQueue must hold uiLength */
+/*entries                                                              */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_height(unsigned int* puiDepths,\
+				      unsigned int uiLength,\
+				      unsigned int* puiQueue){
+  unsigned int uiNext = 0u, uiHead = 0u, uiTail = 0u;
+  unsigned int uiPick, uiPicked, uiDepth;
+  qsort(puiDepths, uiLength, sizeof(unsigned int), ExpBalance_compareDepths);
+  //the combined terms come out in order, so two queues act as a heap
+  while(uiLength - uiNext + uiTail - uiHead > 1u){
+    uiDepth = 0u;
+    for(uiPick = 0u; uiPick < 2u; uiPick++){
+      if(uiHead == uiTail ||\
+	 (uiNext < uiLength && puiDepths[uiNext] <= puiQueue[uiHead]))
+	uiPicked = puiDepths[uiNext++];
+      else
+	uiPicked = puiQueue[uiHead++];
+      if(uiPicked > uiDepth)
+	uiDepth = uiPicked;
+    }
+    puiQueue[uiTail++] = uiDepth + 1u;
+  }
+  return (uiTail > uiHead) ? puiQueue[uiHead] : puiDepths[0];
+}
+
+/*---------------------------------------------------------------------*/
+/*Relink the nodes of pcChain into a balanced tree of its terms, with  */
+/*the root node on top. Return the critical path of the tree           */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_rebuild(struct BalanceChain* pcChain){
+  struct BalanceTerm atPick[2];
+  LinkList_T oLinkList;
+  unsigned int uiNext = 0u, uiHead = 0u, uiTail = 0u, uiPick;
+  assert(pcChain -> uiOps + 1u == pcChain -> uiTerms);
+  qsort(pcChain -> ptTerms, pcChain -> uiTerms, sizeof(struct BalanceTerm),\
+	ExpBalance_compareTerms);
+  while(pcChain -> uiTerms - uiNext + uiTail - uiHead > 1u){
+    for(uiPick = 0u; uiPick < 2u; uiPick++)
+      if(uiHead == uiTail || (uiNext < pcChain -> uiTerms &&\
+			      pcChain -> ptTerms[uiNext].uiDepth <=\
+			      pcChain -> ptQueue[uiHead].uiDepth))
+	atPick[uiPick] = pcChain -> ptTerms[uiNext++];
+      else
+	atPick[uiPick] = pcChain -> ptQueue[uiHead++];
+    //the last node used is the root, which its parent still points to
+    pcChain -> ptQueue[uiTail].oTreeNode =\
+      pcChain -> poOps[pcChain -> uiOps - 1u - uiTail];
+    pcChain -> ptQueue[uiTail].uiDepth =\
+      ((atPick[0].uiDepth > atPick[1].uiDepth) ?\
+       atPick[0].uiDepth : atPick[1].uiDepth) + 1u;
+    oLinkList = ExpTokenTree_getChildren(pcChain -> ptQueue[uiTail].oTreeNode);
+    LinkList_setValue(oLinkList, atPick[0].oTreeNode);
+    LinkList_setValue(LinkList_getNext(oLinkList), atPick[1].oTreeNode);
+    uiTail++;
+  }
+  return pcChain -> ptQueue[uiHead].uiDepth;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the critical path pcChain would have if its term uiTerm, a    */
+/*shared temporary holding the sum or product oTreeNodeValue, were     */
+/*replaced by the terms of oTreeNodeValue, or 0xFFFFFFFF, which is     */
+/*never shorter, if memory is insufficient                             */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_tryCopy(struct Balance* poBalance,\
+				       struct BalanceChain* pcChain,\
+				       unsigned int uiTerm,\
+				       TreeNode_T oTreeNodeValue){
+  unsigned int* puiDepths;
+  unsigned int uiLength = 0u, uiIndex, uiHeight;
+  uiLength = pcChain -> uiTerms +\
+    ExpBalance_chainSize(oTreeNodeValue, pcChain -> ettType);
+  puiDepths = (unsigned int*)malloc(2u * uiLength * sizeof(unsigned int));
+  if(puiDepths == NULL)
+    return 0xFFFFFFFFu;
+  uiLength = 0u;
+  for(uiIndex = 0u; uiIndex < pcChain -> uiTerms; uiIndex++)
+    if(uiIndex != uiTerm)
+      puiDepths[uiLength++] = pcChain -> ptTerms[uiIndex].uiDepth;
+  ExpBalance_termDepths(poBalance, oTreeNodeValue, pcChain -> ettType,\
+			puiDepths, &uiLength);
+  uiHeight = ExpBalance_height(puiDepths, uiLength, puiDepths + uiLength);
+  free(puiDepths);
+  return uiHeight;
+}
+
+/*---------------------------------------------------------------------*/
+/*Copy into pcChain, one at a time, the shared temporaries among its   */
+/*terms that are small enough and whose copy shortens its critical     */
+/*path, the deepest first. The chain is left ready to rebuild          */
+/*---------------------------------------------------------------------*/
+static void ExpBalance_copyShared(struct Balance* poBalance,\
+				  struct BalanceChain* pcChain){
+  TreeNode_T oTreeNodeValue, oTreeNodeCopy;
+  unsigned int* puiDepths;
+  unsigned int uiTerm, uiIndex, uiHeight, uiSize;
+  int iFound;
+  if(poBalance -> uiMaxCopy == 0u)
+    return;
+  while(poBalance -> iMemoryError == 0){
+    puiDepths = (unsigned int*)malloc(2u * pcChain -> uiTerms *\
+				      sizeof(unsigned int));
+    if(puiDepths == NULL){
+      poBalance -> iMemoryError = 1;
+      return;
+    }
+    for(uiTerm = 0u; uiTerm < pcChain -> uiTerms; uiTerm++)
+      puiDepths[uiTerm] = pcChain -> ptTerms[uiTerm].uiDepth;
+    uiHeight = ExpBalance_height(puiDepths, pcChain -> uiTerms,\
+				 puiDepths + pcChain -> uiTerms);
+    free(puiDepths);
+    //only a term on the critical path can shorten it
+    qsort(pcChain -> ptTerms, pcChain -> uiTerms,\
+	  sizeof(struct BalanceTerm), ExpBalance_compareTerms);
+    iFound = 0;
+    for(uiTerm = pcChain -> uiTerms; iFound == 0 && uiTerm > 0u;){
+      uiTerm--;
+      if(ExpBalance_isTemp(pcChain -> ptTerms[uiTerm].oTreeNode,\
+			   poBalance -> uiLength, &uiIndex) == 0)
+	continue;
+      oTreeNodeValue =\
+	ExpProgram_getValue(poBalance -> oExpProgram, uiIndex);
+      if(oTreeNodeValue == NULL || TreeNode_isLeaf(oTreeNodeValue) ||\
+	 ExpBalance_type(oTreeNodeValue) != pcChain -> ettType ||\
+	 ExpBalance_operations(oTreeNodeValue) > poBalance -> uiMaxCopy)
+	continue;
+      iFound = (ExpBalance_tryCopy(poBalance, pcChain, uiTerm,\
+				   oTreeNodeValue) < uiHeight);
+    }
+    if(iFound == 0)
+      return;
+    //room is made first, so gathering the copy cannot fail
+    uiSize = ExpBalance_chainSize(oTreeNodeValue, pcChain -> ettType);
+    oTreeNodeCopy = ExpTokenTree_copy(oTreeNodeValue);
+    if(oTreeNodeCopy == NULL ||\
+       ExpBalance_reserve(pcChain, uiSize + 1u, uiSize) != 0){
+      if(oTreeNodeCopy != NULL)
+	ExpTokenTree_free(oTreeNodeCopy);
+      poBalance -> iMemoryError = 1;
+      return;
+    }
+    //the temporaries under the copy gain a use, so none is inlined
+    ExpProgram_countUses(oTreeNodeCopy, poBalance -> puiUses,\
+			 poBalance -> uiLength);
+    poBalance -> puiUses[uiIndex]--;
+    poBalance -> uiCopied += ExpBalance_operations(oTreeNodeCopy);
+    //the leaf is still linked in the chain, but every link is rebuilt
+    ExpTokenTree_free(pcChain -> ptTerms[uiTerm].oTreeNode);
+    pcChain -> ptTerms[uiTerm] = pcChain -> ptTerms[--pcChain -> uiTerms];
+    pcChain -> poOps[pcChain -> uiOps++] = oTreeNodeCopy;
+    ExpBalance_collect(poBalance, pcChain, oTreeNodeCopy);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Balance the sum or product oTreeNode and return its critical path    */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_chain(struct Balance* poBalance,\
+				     TreeNode_T oTreeNode){
+  struct BalanceChain cChain;
+  unsigned int uiDepth;
+  int iResult = 1;
+  memset(&cChain, 0, sizeof(struct BalanceChain));
+  cChain.ettType = ExpBalance_type(oTreeNode);
+  if(ExpBalance_reserve(&cChain, INITIAL_TERMS, INITIAL_TERMS) == 0){
+    cChain.poOps[cChain.uiOps++] = oTreeNode;
+    iResult = ExpBalance_collect(poBalance, &cChain, oTreeNode);
+  }
+  if(iResult != 0){
+    poBalance -> iMemoryError = 1;
+    uiDepth = ExpBalance_depth(oTreeNode, poBalance -> puiDepths,\
+			       poBalance -> uiLength);
+  }
+  else{
+    ExpBalance_copyShared(poBalance, &cChain);
+    uiDepth = ExpBalance_rebuild(&cChain);
+  }
+  free(cChain.ptTerms);
+  free(cChain.ptQueue);
+  free(cChain.poOps);
+  return uiDepth;
+}
+
+/*---------------------------------------------------------------------*/
+/*Balance every sum and product in oTreeNode and return its critical   */
+/*path                                                                 */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBalance_tree(struct Balance* poBalance,\
+				    TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned int uiIndex, uiDepth = 0u, uiChild;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return ExpBalance_isTemp(oTreeNode, poBalance -> uiLength, &uiIndex) ?\
+      poBalance -> puiDepths[uiIndex] : 0u;
+  if(ExpBalance_type(oTreeNode) == ADD ||\
+     ExpBalance_type(oTreeNode) == MULTIPLY)
+    return ExpBalance_chain(poBalance, oTreeNode);
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList)){
+    uiChild = ExpBalance_tree(poBalance,\
+			      (TreeNode_T)LinkList_getValue(oLinkList));
+    if(uiChild > uiDepth)
+      uiDepth = uiChild;
+  }
+  return uiDepth + 1u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Take one use from each temporary under oTreeNode in puiUses          */
+/*---------------------------------------------------------------------*/
+static void ExpBalance_release(TreeNode_T oTreeNode, unsigned int* puiUses,\
+			       unsigned int uiLength){
+  LinkList_T oLinkList;
+  unsigned int uiIndex;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL){
+    if(ExpBalance_isTemp(oTreeNode, uiLength, &uiIndex))
+      puiUses[uiIndex]--;
+    return;
+  }
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    ExpBalance_release((TreeNode_T)LinkList_getValue(oLinkList),\
+		       puiUses, uiLength);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the critical path of oExpProgram                              */
+/*---------------------------------------------------------------------*/
+unsigned int ExpBalance_criticalPath(ExpProgram_T oExpProgram){
+  unsigned int* puiDepths;
+  unsigned int uiIndex, uiLength, uiDepth = 0u;
+  assert(oExpProgram != NULL);
+  uiLength = ExpProgram_howMany(oExpProgram);
+  puiDepths = (unsigned int*)malloc((uiLength + 1u) * sizeof(unsigned int));
+  if(puiDepths == NULL)
+    return 0u;
+  for(uiIndex = 0u; uiIndex < uiLength; uiIndex++){
+    puiDepths[uiIndex] =\
+      ExpBalance_depth(ExpProgram_getValue(oExpProgram, uiIndex),\
+		       puiDepths, uiIndex);
+    if(puiDepths[uiIndex] > uiDepth)
+      uiDepth = puiDepths[uiIndex];
+  }
+  free(puiDepths);
+  return uiDepth;
+}
+
+/*---------------------------------------------------------------------*/
+/*Balance every sum and product of oExpProgram                         */
+/*---------------------------------------------------------------------*/
+int ExpBalance_apply(ExpProgram_T oExpProgram, LinkList_T pllTrees,\
+		     unsigned int uiMaxCopy, unsigned int* puiBefore,\
+		     unsigned int* puiAfter, unsigned int* puiCopied){
+  struct Balance bBalance;
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNode;
+  unsigned int uiIndex, uiBefore;
+  assert(oExpProgram != NULL);
+  uiBefore = ExpBalance_criticalPath(oExpProgram);
+  bBalance.oExpProgram = oExpProgram;
+  bBalance.uiLength = ExpProgram_howMany(oExpProgram);
+  bBalance.uiMaxCopy = uiMaxCopy;
+  bBalance.uiCopied = 0u;
+  bBalance.iMemoryError = 0;
+  bBalance.puiUses =\
+    (unsigned int*)calloc(bBalance.uiLength + 1u, sizeof(unsigned int));
+  bBalance.puiDepths =\
+    (unsigned int*)calloc(bBalance.uiLength + 1u, sizeof(unsigned int));
+  if(bBalance.puiUses == NULL || bBalance.puiDepths == NULL)
+    bBalance.iMemoryError = 1;
+  else{
+    for(uiIndex = 0u; uiIndex < bBalance.uiLength; uiIndex++)
+      ExpProgram_countUses(ExpProgram_getValue(oExpProgram, uiIndex),\
+			   bBalance.puiUses, bBalance.uiLength);
+    //an output is a use that can never be merged
+    for(oLinkList = pllTrees;
+	oLinkList != NULL;
+	oLinkList = LinkList_getNext(oLinkList))
+      if(LinkList_getValue(oLinkList) != NULL)
+	ExpProgram_countUses((TreeNode_T)LinkList_getValue(oLinkList),\
+			     bBalance.puiUses, bBalance.uiLength);
+    //a statement merged into a later one is taken before it is reached
+    for(uiIndex = 0u; uiIndex < bBalance.uiLength; uiIndex++)
+      if(ExpProgram_getValue(oExpProgram, uiIndex) != NULL)
+	bBalance.puiDepths[uiIndex] =\
+	  ExpBalance_tree(&bBalance,\
+			  ExpProgram_getValue(oExpProgram, uiIndex));
+    //a temporary copied into all of its users is no longer needed
+    for(uiIndex = bBalance.uiLength; uiIndex-- > 0u;){
+      oTreeNode = ExpProgram_getValue(oExpProgram, uiIndex);
+      if(oTreeNode == NULL || bBalance.puiUses[uiIndex] != 0u)
+	continue;
+      ExpBalance_release(oTreeNode, bBalance.puiUses, bBalance.uiLength);
+      ExpTokenTree_free(ExpProgram_take(oExpProgram, uiIndex));
+    }
+    ExpProgram_compact(oExpProgram, pllTrees, bBalance.puiUses);
+  }
+  free(bBalance.puiUses);
+  free(bBalance.puiDepths);
+  if(puiBefore != NULL)
+    *puiBefore = uiBefore;
+  if(puiAfter != NULL)
+    *puiAfter = ExpBalance_criticalPath(oExpProgram);
+  if(puiCopied != NULL)
+    *puiCopied = bBalance.uiCopied;
+  return bBalance.iMemoryError;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expbalance.c                                                    */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  ExpProgram_T oExpProgram;
+  LinkList_T pllTrees;
+  unsigned int uiBefore, uiAfter;
+
+  //#0 = a+b, #1 = #0+c, #2 = #1+d, output #2
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("c")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("#1"),\
+				      ExpTokenTree_newLeaf("d")));
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf("#2"));
+  if(ExpBalance_apply(oExpProgram, pllTrees, 0u, &uiBefore, &uiAfter,\
+		      NULL) != 0)
+    printf("failed test 1\n");
+  if(uiBefore != 3u || uiAfter != 2u || ExpProgram_howMany(oExpProgram) != 1u)
+    printf("failed test 2\n");
+  ExpProgram_print(oExpProgram);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
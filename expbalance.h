@@ -0,0 +1,42 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbalance.h describes tree height reduction for ExpPrograms. A long */
+/*sum or product is usually emitted as a chain, each operation waiting */
+/*for the one before, so its critical path is as long as it has terms. */
+/*Regrouping the terms into a balanced tree lets them be evaluated in  */
+/*parallel for the same number of operations                           */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPBALANCE_INCLUDED
+#define EXPBALANCE_INCLUDED
+
+#include "linklist.h"
+#include "expprogram.h"
+
+/*---------------------------------------------------------------------*/
+/*Return the critical path of oExpProgram, the greatest number of      */
+/*operations on any chain of dependencies through its statements       */
+/*---------------------------------------------------------------------*/
+unsigned int ExpBalance_criticalPath(ExpProgram_T oExpProgram);
+
+/*---------------------------------------------------------------------*/
+/*Regroup every sum and product in oExpProgram so that its critical    */
+/*path is as short as possible. A sum or product is followed into the  */
+/*temporaries it uses that are sums or products too and are used       */
+/*nowhere else, which are merged into it; shared temporaries are kept, */
+/*so no sharing is lost. Terms are combined two at a time, those       */
+/*available earliest first. Besides, a shared temporary of at most     */
+/*uiMaxCopy operations may be copied into a sum or product that uses   */
+/*it, when that shortens its critical path, trading operations for     */
+/*depth. The trees stored in the list pllTrees are the outputs of the  */
+/*program, and are renumbered along with it. Store the critical path   */
+/*before and after in puiBefore and puiAfter, and the number of        */
+/*operations added by copies in puiCopied, if they are not NULL. Return*/
+/*0 if successful, 1 if memory is insufficient, in which case the      */
+/*program is valid but may be only partly balanced                     */
+/*---------------------------------------------------------------------*/
+int ExpBalance_apply(ExpProgram_T oExpProgram, LinkList_T pllTrees,\
+		     unsigned int uiMaxCopy, unsigned int* puiBefore,\
+		     unsigned int* puiAfter, unsigned int* puiCopied);
+
+#endif
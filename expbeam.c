@@ -0,0 +1,959 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbeam.c implements expbeam.h. Every node is hash-consed into one   */
+/*pool shared by all states, with the operands of flattened sums and   */
+/*products kept sorted, so equal subexpressions are one node and a     */
+/*state is no more than the list of its roots. Pairing x and y in a    */
+/*state rebuilds only the nodes above a sum or product holding both,   */
+/*and leaves the rest of the graph shared with the state it came from  */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "expbeam.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the id that stands for no node, the number of pairings tried  */
+/*from each state, the most nodes the pool may hold, and its initial   */
+/*size                                                                 */
+/*---------------------------------------------------------------------*/
+#define BEAM_NONE 0xFFFFFFFFu
+#define BEAM_BRANCHING 4u
+#define BEAM_MAX_NODES 4000000u
+#define INITIAL_NODES 1024u
+
+/*---------------------------------------------------------------------*/
+/*A BeamNode is an operand or an operation in the pool                 */
+/*---------------------------------------------------------------------*/
+struct BeamNode
+{
+  /*the type of the token*/
+  enum ExpTokenType ettType;
+  /*a copy of the token of an operand, NULL for an operation*/
+  ExpToken_T oExpToken;
+  /*index of the first child in the child array, and the number of them*/
+  unsigned int uiFirst;
+  unsigned int uiArity;
+  /*hash of the node, and the next node in the same bucket*/
+  unsigned long ulHash;
+  unsigned int uiNext;
+};
+
+/*---------------------------------------------------------------------*/
+/*A BeamPool holds the nodes of every state. Stamps and memos are per  */
+/*node scratch space for traversals, valid while a node's stamp equals */
+/*uiGeneration                                                         */
+/*---------------------------------------------------------------------*/
+struct BeamPool
+{
+  /*the nodes, and the heads of the hash buckets, uiMaxNodes of each*/
+  struct BeamNode* pnNodes;
+  unsigned int* puiBuckets;
+  unsigned int uiNodes;
+  unsigned int uiMaxNodes;
+  /*the children of every node*/
+  unsigned int* puiChildren;
+  unsigned int uiChildren;
+  unsigned int uiMaxChildren;
+  /*traversal scratch space, uiMaxNodes of each*/
+  unsigned int* puiStamps;
+  unsigned int* puiMemos;
+  unsigned int uiGeneration;
+};
+
+/*---------------------------------------------------------------------*/
+/*A BeamAction pairs the operands uiX and uiY of every operation of    */
+/*type ettType that holds both, saving uiGain operations               */
+/*---------------------------------------------------------------------*/
+struct BeamAction
+{
+  enum ExpTokenType ettType;
+  unsigned int uiX;
+  unsigned int uiY;
+  unsigned int uiGain;
+};
+
+/*---------------------------------------------------------------------*/
+/*A BeamState is one root per tree, the operations needed to evaluate  */
+/*them, and the best pairings to try next                              */
+/*---------------------------------------------------------------------*/
+struct BeamState
+{
+  /*the root of each tree*/
+  unsigned int* puiRoots;
+  /*operations needed with every common subexpression shared*/
+  unsigned int uiCost;
+  /*cost less the gain of the best next pairing*/
+  unsigned int uiScore;
+  /*the pairings to try next, best first*/
+  struct BeamAction paActions[BEAM_BRANCHING];
+  unsigned int uiActions;
+};
+
+/*---------------------------------------------------------------------*/
+/*A BeamPair counts the operations that hold both operands of a pairing*/
+/*---------------------------------------------------------------------*/
+struct BeamPair
+{
+  enum ExpTokenType ettType;
+  unsigned int uiX;
+  unsigned int uiY;
+  /*operations of three or more operands that hold the pair*/
+  unsigned int uiCount;
+  /*nonzero if the pair is already an operation of its own*/
+  int iExists;
+  /*the last operation counted, so each counts once, or BEAM_NONE*/
+  unsigned int uiLast;
+};
+
+/*---------------------------------------------------------------------*/
+/*A BeamList is a growable array of node ids                           */
+/*---------------------------------------------------------------------*/
+struct BeamList
+{
+  unsigned int* puiItems;
+  unsigned int uiLength;
+  unsigned int uiMax;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the operands of operations of type ettType are flattened */
+/*and may be reordered, 0 if not                                       */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_isFlat(enum ExpTokenType ettType){
+  return (ettType == ADD) | (ettType == MULTIPLY);
+}
+
+/*---------------------------------------------------------------------*/
+/*Append uiItem to plList. Return 0 if successful, 1 if memory is      */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_push(struct BeamList* plList, unsigned int uiItem){
+  unsigned int* puiItems;
+  if(plList -> uiLength == plList -> uiMax){
+    puiItems = (unsigned int*)realloc(plList -> puiItems,\
+				      (2u * plList -> uiMax + 4u) *\
+				      sizeof(unsigned int));
+    if(puiItems == NULL)
+      return 1;
+    plList -> puiItems = puiItems;
+    plList -> uiMax = 2u * plList -> uiMax + 4u;
+  }
+  plList -> puiItems[plList -> uiLength++] = uiItem;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare two node ids for qsort                                       */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_compareIds(const void* pvId1, const void* pvId2){
+  unsigned int uiId1 = *(const unsigned int*)pvId1;
+  unsigned int uiId2 = *(const unsigned int*)pvId2;
+  return (uiId1 > uiId2) - (uiId1 < uiId2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Initialize poPool. Return 0 if successful, 1 if memory is            */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_newPool(struct BeamPool* poPool){
+  poPool -> uiNodes = 0u;
+  poPool -> uiMaxNodes = INITIAL_NODES;
+  poPool -> uiChildren = 0u;
+  poPool -> uiMaxChildren = 2u * INITIAL_NODES;
+  poPool -> uiGeneration = 0u;
+  poPool -> pnNodes = (struct BeamNode*)\
+    malloc(INITIAL_NODES * sizeof(struct BeamNode));
+  poPool -> puiBuckets =\
+    (unsigned int*)malloc(INITIAL_NODES * sizeof(unsigned int));
+  poPool -> puiChildren =\
+    (unsigned int*)malloc(2u * INITIAL_NODES * sizeof(unsigned int));
+  poPool -> puiStamps =\
+    (unsigned int*)calloc(INITIAL_NODES, sizeof(unsigned int));
+  poPool -> puiMemos =\
+    (unsigned int*)malloc(INITIAL_NODES * sizeof(unsigned int));
+  if(poPool -> pnNodes == NULL || poPool -> puiBuckets == NULL ||\
+     poPool -> puiChildren == NULL || poPool -> puiStamps == NULL ||\
+     poPool -> puiMemos == NULL)
+    return 1;
+  memset(poPool -> puiBuckets, 0xFF, INITIAL_NODES * sizeof(unsigned int));
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the memory held by poPool                                       */
+/*---------------------------------------------------------------------*/
+static void ExpBeam_freePool(struct BeamPool* poPool){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < poPool -> uiNodes; uiIndex++)
+    if(poPool -> pnNodes[uiIndex].oExpToken != NULL)
+      ExpToken_free(poPool -> pnNodes[uiIndex].oExpToken);
+  free(poPool -> pnNodes);
+  free(poPool -> puiBuckets);
+  free(poPool -> puiChildren);
+  free(poPool -> puiStamps);
+  free(poPool -> puiMemos);
+}
+
+/*---------------------------------------------------------------------*/
+/*Double the number of nodes poPool can hold, and rebuild its buckets. */
+/*Return 0 if successful, 1 if memory is insufficient                  */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_growNodes(struct BeamPool* poPool){
+  struct BeamNode* pnNodes;
+  unsigned int* puiArray;
+  unsigned int uiMax, uiIndex, uiBucket;
+  uiMax = 2u * poPool -> uiMaxNodes;
+  pnNodes = (struct BeamNode*)realloc(poPool -> pnNodes,\
+				      uiMax * sizeof(struct BeamNode));
+  if(pnNodes == NULL)
+    return 1;
+  poPool -> pnNodes = pnNodes;
+  puiArray = (unsigned int*)realloc(poPool -> puiStamps,\
+				    uiMax * sizeof(unsigned int));
+  if(puiArray == NULL)
+    return 1;
+  poPool -> puiStamps = puiArray;
+  //new nodes must not look visited
+  memset(poPool -> puiStamps + poPool -> uiMaxNodes, 0,\
+	 poPool -> uiMaxNodes * sizeof(unsigned int));
+  puiArray = (unsigned int*)realloc(poPool -> puiMemos,\
+				    uiMax * sizeof(unsigned int));
+  if(puiArray == NULL)
+    return 1;
+  poPool -> puiMemos = puiArray;
+  puiArray = (unsigned int*)malloc(uiMax * sizeof(unsigned int));
+  if(puiArray == NULL)
+    return 1;
+  free(poPool -> puiBuckets);
+  poPool -> puiBuckets = puiArray;
+  poPool -> uiMaxNodes = uiMax;
+  memset(poPool -> puiBuckets, 0xFF, uiMax * sizeof(unsigned int));
+  for(uiIndex = 0u; uiIndex < poPool -> uiNodes; uiIndex++){
+    uiBucket = (unsigned int)poPool -> pnNodes[uiIndex].ulHash & (uiMax - 1u);
+    poPool -> pnNodes[uiIndex].uiNext = poPool -> puiBuckets[uiBucket];
+    poPool -> puiBuckets[uiBucket] = uiIndex;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the id of the node of type ettType with the token oExpToken,  */
+/*if it is an operand, or else the uiArity children in puiChildren,    */
+/*adding it to poPool if it is not there. puiChildren must not point   */
+/*into the pool. Return BEAM_NONE if memory is insufficient or the pool*/
+/*is full                                                              */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBeam_intern(struct BeamPool* poPool,\
+				   enum ExpTokenType ettType,\
+				   ExpToken_T oExpToken,\
+				   const unsigned int* puiChildren,\
+				   unsigned int uiArity){
+  struct BeamNode* pnNode;
+  unsigned int* puiArray;
+  const char* pcName;
+  unsigned long ulHash;
+  unsigned int uiIndex, uiId;
+  ulHash = 2166136261ul + (unsigned long)ettType;
+  if(oExpToken != NULL)
+    for(pcName = ExpToken_getName(oExpToken); *pcName != '\0'; pcName++)
+      ulHash = (ulHash ^ (unsigned char)*pcName) * 16777619ul;
+  for(uiIndex = 0u; uiIndex < uiArity; uiIndex++)
+    ulHash = (ulHash ^ puiChildren[uiIndex]) * 1099511628211ul;
+  for(uiId = poPool -> puiBuckets[ulHash & (poPool -> uiMaxNodes - 1u)];
+      uiId != BEAM_NONE;
+      uiId = poPool -> pnNodes[uiId].uiNext){
+    pnNode = &poPool -> pnNodes[uiId];
+    if(pnNode -> ulHash != ulHash || pnNode -> ettType != ettType ||\
+       pnNode -> uiArity != uiArity)
+      continue;
+    if(oExpToken != NULL){
+      if(ExpToken_compare(pnNode -> oExpToken, oExpToken) == 0)
+	return uiId;
+    }
+    else if(uiArity == 0u ||\
+	    memcmp(poPool -> puiChildren + pnNode -> uiFirst, puiChildren,\
+		   uiArity * sizeof(unsigned int)) == 0)
+      return uiId;
+  }
+  if(poPool -> uiNodes == BEAM_MAX_NODES)
+    return BEAM_NONE;
+  if(poPool -> uiNodes == poPool -> uiMaxNodes &&\
+     ExpBeam_growNodes(poPool) != 0)
+    return BEAM_NONE;
+  while(poPool -> uiChildren + uiArity > poPool -> uiMaxChildren){
+    puiArray = (unsigned int*)realloc(poPool -> puiChildren,\
+				      2u * poPool -> uiMaxChildren *\
+				      sizeof(unsigned int));
+    if(puiArray == NULL)
+      return BEAM_NONE;
+    poPool -> puiChildren = puiArray;
+    poPool -> uiMaxChildren *= 2u;
+  }
+  uiId = poPool -> uiNodes;
+  pnNode = &poPool -> pnNodes[uiId];
+  pnNode -> oExpToken = NULL;
+  if(oExpToken != NULL){
+    pnNode -> oExpToken = ExpToken_copy(oExpToken);
+    if(pnNode -> oExpToken == NULL)
+      return BEAM_NONE;
+  }
+  pnNode -> ettType = ettType;
+  pnNode -> uiFirst = poPool -> uiChildren;
+  pnNode -> uiArity = uiArity;
+  pnNode -> ulHash = ulHash;
+  //an operand has no children, and may pass none
+  if(uiArity > 0u)
+    memcpy(poPool -> puiChildren + poPool -> uiChildren, puiChildren,\
+	   uiArity * sizeof(unsigned int));
+  poPool -> uiChildren += uiArity;
+  pnNode -> uiNext =\
+    poPool -> puiBuckets[ulHash & (poPool -> uiMaxNodes - 1u)];
+  poPool -> puiBuckets[ulHash & (poPool -> uiMaxNodes - 1u)] = uiId;
+  poPool -> uiNodes++;
+  return uiId;
+}
+
+static unsigned int ExpBeam_fromTree(struct BeamPool* poPool,\
+				     TreeNode_T oTreeNode, int iFlatten);
+
+/*---------------------------------------------------------------------*/
+/*Append to plList the ids of the operands of the chain of operations  */
+/*of type ettType rooted at oTreeNode. Return 0 if successful, 1 if    */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_gather(struct BeamPool* poPool, TreeNode_T oTreeNode,\
+			  enum ExpTokenType ettType,\
+			  struct BeamList* plList){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild;
+  unsigned int uiId;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    if(TreeNode_isLeaf(oTreeNodeChild) == 0 &&\
+       ExpToken_getType(ExpTokenTree_getValue(oTreeNodeChild)) == ettType){
+      if(ExpBeam_gather(poPool, oTreeNodeChild, ettType, plList) != 0)
+	return 1;
+      continue;
+    }
+    uiId = ExpBeam_fromTree(poPool, oTreeNodeChild, 1);
+    if(uiId == BEAM_NONE || ExpBeam_push(plList, uiId) != 0)
+      return 1;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the id of oTreeNode in poPool, with its sums and products     */
+/*flattened if iFlatten is nonzero, or else with only the two operands */
+/*of each put in order. Return BEAM_NONE if memory is insufficient     */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBeam_fromTree(struct BeamPool* poPool,\
+				     TreeNode_T oTreeNode, int iFlatten){
+  struct BeamList lList = {NULL, 0u, 0u};
+  LinkList_T oLinkList;
+  ExpToken_T oExpToken;
+  unsigned int uiId;
+  oExpToken = ExpTokenTree_getValue(oTreeNode);
+  if(TreeNode_isLeaf(oTreeNode))
+    return ExpBeam_intern(poPool, ExpToken_getType(oExpToken), oExpToken,\
+			  NULL, 0u);
+  if(iFlatten && ExpBeam_isFlat(ExpToken_getType(oExpToken))){
+    if(ExpBeam_gather(poPool, oTreeNode, ExpToken_getType(oExpToken),\
+		      &lList) != 0){
+      free(lList.puiItems);
+      return BEAM_NONE;
+    }
+  }
+  else
+    for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+	oLinkList != NULL;
+	oLinkList = LinkList_getNext(oLinkList)){
+      uiId = ExpBeam_fromTree(poPool,\
+			      (TreeNode_T)LinkList_getValue(oLinkList),\
+			      iFlatten);
+      if(uiId == BEAM_NONE || ExpBeam_push(&lList, uiId) != 0){
+	free(lList.puiItems);
+	return BEAM_NONE;
+      }
+    }
+  if(ExpBeam_isFlat(ExpToken_getType(oExpToken)))
+    qsort(lList.puiItems, lList.uiLength, sizeof(unsigned int),\
+	  ExpBeam_compareIds);
+  uiId = ExpBeam_intern(poPool, ExpToken_getType(oExpToken), NULL,\
+			lList.puiItems, lList.uiLength);
+  free(lList.puiItems);
+  return uiId;
+}
+
+/*---------------------------------------------------------------------*/
+/*Start a new traversal of poPool, in which no node is marked          */
+/*---------------------------------------------------------------------*/
+static void ExpBeam_newGeneration(struct BeamPool* poPool){
+  poPool -> uiGeneration++;
+  //after wrapping around every old stamp could look current
+  if(poPool -> uiGeneration == 0u){
+    memset(poPool -> puiStamps, 0,\
+	   poPool -> uiMaxNodes * sizeof(unsigned int));
+    poPool -> uiGeneration = 1u;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Append every node reachable from uiId that is not yet marked to      */
+/*plList, children first, marking them. Return 0 if successful, 1 if   */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_reach(struct BeamPool* poPool, unsigned int uiId,\
+			 struct BeamList* plList){
+  unsigned int uiIndex;
+  if(poPool -> puiStamps[uiId] == poPool -> uiGeneration)
+    return 0;
+  poPool -> puiStamps[uiId] = poPool -> uiGeneration;
+  for(uiIndex = 0u; uiIndex < poPool -> pnNodes[uiId].uiArity; uiIndex++)
+    if(ExpBeam_reach(poPool, poPool -> puiChildren\
+		     [poPool -> pnNodes[uiId].uiFirst + uiIndex], plList) != 0)
+      return 1;
+  return ExpBeam_push(plList, uiId);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in plList every node reachable from the uiRoots roots in       */
+/*puiRoots. Return 0 if successful, 1 if memory is insufficient        */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_reachAll(struct BeamPool* poPool,\
+			    const unsigned int* puiRoots,\
+			    unsigned int uiRoots, struct BeamList* plList){
+  unsigned int uiIndex;
+  plList -> uiLength = 0u;
+  ExpBeam_newGeneration(poPool);
+  for(uiIndex = 0u; uiIndex < uiRoots; uiIndex++)
+    if(ExpBeam_reach(poPool, puiRoots[uiIndex], plList) != 0)
+      return 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations needed to evaluate the node uiId     */
+/*alone: one for a unary operation, and one less than the number of    */
+/*operands otherwise                                                   */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBeam_nodeCost(struct BeamPool* poPool,\
+				     unsigned int uiId){
+  unsigned int uiArity = poPool -> pnNodes[uiId].uiArity;
+  return (uiArity < 2u) ? uiArity : uiArity - 1u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations in the nodes of plList               */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBeam_cost(struct BeamPool* poPool,\
+				 struct BeamList* plList){
+  unsigned int uiIndex, uiCost = 0u;
+  for(uiIndex = 0u; uiIndex < plList -> uiLength; uiIndex++)
+    uiCost += ExpBeam_nodeCost(poPool, plList -> puiItems[uiIndex]);
+  return uiCost;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the entry for the pair uiX, uiY of type ettType in the table  */
+/*ppPairs of uiSize entries, a power of two, claiming an empty one if  */
+/*it is not there                                                      */
+/*---------------------------------------------------------------------*/
+static struct BeamPair* ExpBeam_findPair(struct BeamPair* ppPairs,\
+					 unsigned int uiSize,\
+					 enum ExpTokenType ettType,\
+					 unsigned int uiX, unsigned int uiY){
+  struct BeamPair* ppPair;
+  unsigned int uiSlot;
+  uiSlot = (uiX * 2654435761u ^ uiY * 40503u ^ (unsigned int)ettType) &\
+    (uiSize - 1u);
+  for(;; uiSlot = (uiSlot + 1u) & (uiSize - 1u)){
+    ppPair = &ppPairs[uiSlot];
+    if(ppPair -> uiLast == BEAM_NONE && ppPair -> iExists == 0 &&\
+       ppPair -> uiCount == 0u){
+      ppPair -> ettType = ettType;
+      ppPair -> uiX = uiX;
+      ppPair -> uiY = uiY;
+      return ppPair;
+    }
+    if(ppPair -> ettType == ettType && ppPair -> uiX == uiX &&\
+       ppPair -> uiY == uiY)
+      return ppPair;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if paAction1 should be tried before paAction2, 0 if not     */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_better(const struct BeamAction* paAction1,\
+			  const struct BeamAction* paAction2){
+  if(paAction1 -> uiGain != paAction2 -> uiGain)
+    return paAction1 -> uiGain > paAction2 -> uiGain;
+  if(paAction1 -> uiX != paAction2 -> uiX)
+    return paAction1 -> uiX < paAction2 -> uiX;
+  return paAction1 -> uiY < paAction2 -> uiY;
+}
+
+/*---------------------------------------------------------------------*/
+/*Find the cost of psState, whose roots are set, and its best pairings,*/
+/*and score it. Return 0 if successful, 1 if memory is insufficient    */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_score(struct BeamPool* poPool, struct BeamState* psState,\
+			 unsigned int uiRoots, struct BeamList* plReach){
+  struct BeamPair* ppPairs;
+  struct BeamPair* ppPair;
+  struct BeamAction aAction;
+  struct BeamNode* pnNode;
+  const unsigned int* puiChildren;
+  unsigned int uiIndex, uiI, uiJ, uiPairs = 0u, uiSize, uiSlot, uiId;
+  if(ExpBeam_reachAll(poPool, psState -> puiRoots, uiRoots, plReach) != 0)
+    return 1;
+  psState -> uiCost = ExpBeam_cost(poPool, plReach);
+  psState -> uiActions = 0u;
+  //size the pair table for at most half full
+  for(uiIndex = 0u; uiIndex < plReach -> uiLength; uiIndex++){
+    pnNode = &poPool -> pnNodes[plReach -> puiItems[uiIndex]];
+    if(ExpBeam_isFlat(pnNode -> ettType))
+      uiPairs += pnNode -> uiArity * (pnNode -> uiArity - 1u) / 2u;
+  }
+  for(uiSize = 16u; uiSize < 2u * uiPairs; uiSize *= 2u);
+  ppPairs = (struct BeamPair*)malloc(uiSize * sizeof(struct BeamPair));
+  if(ppPairs == NULL)
+    return 1;
+  for(uiSlot = 0u; uiSlot < uiSize; uiSlot++){
+    ppPairs[uiSlot].uiCount = 0u;
+    ppPairs[uiSlot].iExists = 0;
+    ppPairs[uiSlot].uiLast = BEAM_NONE;
+  }
+  //count every pair of operands of every sum and product
+  for(uiIndex = 0u; uiIndex < plReach -> uiLength; uiIndex++){
+    uiId = plReach -> puiItems[uiIndex];
+    pnNode = &poPool -> pnNodes[uiId];
+    if(ExpBeam_isFlat(pnNode -> ettType) == 0)
+      continue;
+    puiChildren = poPool -> puiChildren + pnNode -> uiFirst;
+    for(uiI = 0u; uiI < pnNode -> uiArity; uiI++)
+      for(uiJ = uiI + 1u; uiJ < pnNode -> uiArity; uiJ++){
+	ppPair = ExpBeam_findPair(ppPairs, uiSize, pnNode -> ettType,\
+				  puiChildren[uiI], puiChildren[uiJ]);
+	if(pnNode -> uiArity == 2u)
+	  ppPair -> iExists = 1;
+	else if(ppPair -> uiLast != uiId)
+	  ppPair -> uiCount++;
+	ppPair -> uiLast = uiId;
+      }
+  }
+  //keep the pairings that save the most
+  for(uiSlot = 0u; uiSlot < uiSize; uiSlot++){
+    ppPair = &ppPairs[uiSlot];
+    if(ppPair -> uiCount + (unsigned int)ppPair -> iExists < 2u)
+      continue;
+    aAction.ettType = ppPair -> ettType;
+    aAction.uiX = ppPair -> uiX;
+    aAction.uiY = ppPair -> uiY;
+    aAction.uiGain = ppPair -> uiCount - (ppPair -> iExists == 0);
+    for(uiIndex = psState -> uiActions;
+	uiIndex > 0u &&\
+	  ExpBeam_better(&aAction, &psState -> paActions[uiIndex - 1u]);
+	uiIndex--)
+      if(uiIndex < BEAM_BRANCHING)
+	psState -> paActions[uiIndex] = psState -> paActions[uiIndex - 1u];
+    if(uiIndex < BEAM_BRANCHING){
+      psState -> paActions[uiIndex] = aAction;
+      if(psState -> uiActions < BEAM_BRANCHING)
+	psState -> uiActions++;
+    }
+  }
+  free(ppPairs);
+  //look one pairing ahead
+  psState -> uiScore = psState -> uiCost;
+  if(psState -> uiActions > 0u)
+    psState -> uiScore -= psState -> paActions[0].uiGain;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the id of the node uiId with the action paAction applied to it*/
+/*and the nodes under it, or BEAM_NONE if memory is insufficient. The  */
+/*result for each node is memoized for the current generation          */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBeam_pair(struct BeamPool* poPool, unsigned int uiId,\
+				 const struct BeamAction* paAction){
+  struct BeamList lChildren = {NULL, 0u, 0u};
+  enum ExpTokenType ettType;
+  unsigned int uiIndex, uiArity, uiChild, uiFoundX, uiFoundY, uiPair;
+  unsigned int puiPair[2];
+  int iChanged = 0;
+  if(poPool -> puiStamps[uiId] == poPool -> uiGeneration)
+    return poPool -> puiMemos[uiId];
+  uiArity = poPool -> pnNodes[uiId].uiArity;
+  ettType = poPool -> pnNodes[uiId].ettType;
+  if(uiArity == 0u){
+    poPool -> puiStamps[uiId] = poPool -> uiGeneration;
+    poPool -> puiMemos[uiId] = uiId;
+    return uiId;
+  }
+  for(uiIndex = 0u; uiIndex < uiArity; uiIndex++){
+    //the pool may move while a child is rebuilt
+    uiChild = ExpBeam_pair(poPool, poPool -> puiChildren\
+			   [poPool -> pnNodes[uiId].uiFirst + uiIndex],\
+			   paAction);
+    if(uiChild == BEAM_NONE || ExpBeam_push(&lChildren, uiChild) != 0){
+      free(lChildren.puiItems);
+      return BEAM_NONE;
+    }
+    iChanged |= (uiChild != poPool -> puiChildren\
+		 [poPool -> pnNodes[uiId].uiFirst + uiIndex]);
+  }
+  //replace one x and one y by the pair
+  if(ettType == paAction -> ettType && uiArity > 2u){
+    uiFoundX = uiFoundY = BEAM_NONE;
+    for(uiIndex = 0u; uiIndex < uiArity; uiIndex++){
+      if(uiFoundX == BEAM_NONE && lChildren.puiItems[uiIndex] ==\
+	 paAction -> uiX)
+	uiFoundX = uiIndex;
+      else if(uiFoundY == BEAM_NONE && lChildren.puiItems[uiIndex] ==\
+	      paAction -> uiY)
+	uiFoundY = uiIndex;
+    }
+    if(uiFoundX != BEAM_NONE && uiFoundY != BEAM_NONE){
+      puiPair[0] = paAction -> uiX;
+      puiPair[1] = paAction -> uiY;
+      uiPair = ExpBeam_intern(poPool, ettType, NULL, puiPair, 2u);
+      if(uiPair == BEAM_NONE){
+	free(lChildren.puiItems);
+	return BEAM_NONE;
+      }
+      lChildren.puiItems[uiFoundX] = uiPair;
+      lChildren.puiItems[uiFoundY] =\
+	lChildren.puiItems[--lChildren.uiLength];
+      qsort(lChildren.puiItems, lChildren.uiLength, sizeof(unsigned int),\
+	    ExpBeam_compareIds);
+      iChanged = 1;
+    }
+  }
+  uiChild = uiId;
+  if(iChanged)
+    uiChild = ExpBeam_intern(poPool, ettType, NULL, lChildren.puiItems,\
+			     lChildren.uiLength);
+  free(lChildren.puiItems);
+  if(uiChild != BEAM_NONE){
+    poPool -> puiStamps[uiId] = poPool -> uiGeneration;
+    poPool -> puiMemos[uiId] = uiChild;
+  }
+  return uiChild;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree node holding a copy of the token of the node uiId, */
+/*without children, or NULL if memory is insufficient                  */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpBeam_newNode(struct BeamPool* poPool,\
+				  unsigned int uiId){
+  TreeNode_T oTreeNode;
+  ExpToken_T oExpToken;
+  oTreeNode = ExpTokenTree_new();
+  if(poPool -> pnNodes[uiId].oExpToken != NULL)
+    oExpToken = ExpToken_copy(poPool -> pnNodes[uiId].oExpToken);
+  else{
+    oExpToken = ExpToken_new();
+    if(oExpToken != NULL)
+      ExpToken_setType(oExpToken, poPool -> pnNodes[uiId].ettType);
+  }
+  if(oTreeNode == NULL || oExpToken == NULL){
+    if(oTreeNode != NULL)
+      ExpTokenTree_free(oTreeNode);
+    if(oExpToken != NULL)
+      ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree for the node uiId, with sums and products of more  */
+/*than two operands written as a chain, or NULL if memory is           */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpBeam_toTree(struct BeamPool* poPool,\
+				 unsigned int uiId){
+  TreeNode_T oTreeNode, oTreeNodeChain, oTreeNodeChild;
+  unsigned int uiIndex;
+  oTreeNode = ExpBeam_newNode(poPool, uiId);
+  if(oTreeNode == NULL)
+    return NULL;
+  for(uiIndex = 0u; uiIndex < poPool -> pnNodes[uiId].uiArity; uiIndex++){
+    //each operand after the second starts a new link of the chain
+    if(uiIndex >= 2u){
+      oTreeNodeChain = ExpBeam_newNode(poPool, uiId);
+      if(oTreeNodeChain == NULL ||\
+	 ExpTokenTree_addChild(oTreeNodeChain, oTreeNode) != 0){
+	if(oTreeNodeChain != NULL)
+	  ExpTokenTree_free(oTreeNodeChain);
+	ExpTokenTree_free(oTreeNode);
+	return NULL;
+      }
+      oTreeNode = oTreeNodeChain;
+    }
+    oTreeNodeChild = ExpBeam_toTree\
+      (poPool, poPool -> puiChildren[poPool -> pnNodes[uiId].uiFirst +\
+				     uiIndex]);
+    if(oTreeNodeChild == NULL ||\
+       ExpTokenTree_addChild(oTreeNode, oTreeNodeChild) != 0){
+      if(oTreeNodeChild != NULL)
+	ExpTokenTree_free(oTreeNodeChild);
+      ExpTokenTree_free(oTreeNode);
+      return NULL;
+    }
+  }
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare two states for qsort, lowest score first                     */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_compareStates(const void* pvState1, const void* pvState2){
+  const struct BeamState* psState1 = (const struct BeamState*)pvState1;
+  const struct BeamState* psState2 = (const struct BeamState*)pvState2;
+  if(psState1 -> uiScore != psState2 -> uiScore)
+    return (psState1 -> uiScore > psState2 -> uiScore) -\
+      (psState1 -> uiScore < psState2 -> uiScore);
+  return (psState1 -> uiCost > psState2 -> uiCost) -\
+    (psState1 -> uiCost < psState2 -> uiCost);
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the roots of the uiStates states in psStates                    */
+/*---------------------------------------------------------------------*/
+static void ExpBeam_freeStates(struct BeamState* psStates,\
+			       unsigned int uiStates){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < uiStates; uiIndex++)
+    free(psStates[uiIndex].puiRoots);
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the uiRoots trees in pllTrees by the trees of the nodes in   */
+/*puiRoots. Return 0 if successful, 1 if memory is insufficient, in    */
+/*which case the trees are left as they were                           */
+/*---------------------------------------------------------------------*/
+static int ExpBeam_rewrite(struct BeamPool* poPool, LinkList_T pllTrees,\
+			   const unsigned int* puiRoots,\
+			   unsigned int uiRoots){
+  LinkList_T oLinkList;
+  TreeNode_T* poTrees;
+  unsigned int uiIndex;
+  poTrees = (TreeNode_T*)calloc(uiRoots, sizeof(TreeNode_T));
+  if(poTrees == NULL)
+    return 1;
+  //build every tree before replacing any
+  for(uiIndex = 0u; uiIndex < uiRoots; uiIndex++){
+    poTrees[uiIndex] = ExpBeam_toTree(poPool, puiRoots[uiIndex]);
+    if(poTrees[uiIndex] == NULL){
+      while(uiIndex-- > 0u)
+	ExpTokenTree_free(poTrees[uiIndex]);
+      free(poTrees);
+      return 1;
+    }
+  }
+  for(oLinkList = pllTrees, uiIndex = 0u;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList), uiIndex++){
+    ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkList));
+    LinkList_setValue(oLinkList, poTrees[uiIndex]);
+  }
+  free(poTrees);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Search for the cheapest pairing of the trees in pllTrees             */
+/*---------------------------------------------------------------------*/
+int ExpBeam_apply(LinkList_T pllTrees, unsigned int uiWidth,\
+		  double dSeconds, ExpBudget_T oExpBudget,\
+		  unsigned int* puiBefore, unsigned int* puiAfter){
+  struct BeamPool oPool;
+  struct BeamList lReach = {NULL, 0u, 0u};
+  struct BeamState* psBeam = NULL;
+  struct BeamState* psNext = NULL;
+  struct BeamState* psState;
+  LinkList_T oLinkList;
+  unsigned int* puiBest = NULL;
+  unsigned int uiRoots = 0u, uiBefore, uiBestCost, uiIndex, uiAction;
+  unsigned int uiStates = 0u, uiNext = 0u, uiCandidate;
+  clock_t cStart = clock();
+  int iResult = 0, iStop = 0;
+  assert(uiWidth > 0u);
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    uiRoots++;
+  if(ExpBeam_newPool(&oPool) != 0){
+    ExpBeam_freePool(&oPool);
+    return 1;
+  }
+  psBeam = (struct BeamState*)malloc(uiWidth * sizeof(struct BeamState));
+  psNext = (struct BeamState*)malloc(uiWidth * BEAM_BRANCHING *\
+				     sizeof(struct BeamState));
+  puiBest = (unsigned int*)malloc((uiRoots + 1u) * sizeof(unsigned int));
+  if(psBeam == NULL || psNext == NULL || puiBest == NULL)
+    iResult = 1;
+  //the trees as they are, and the trees flattened
+  for(oLinkList = pllTrees, uiIndex = 0u;
+      oLinkList != NULL && iResult == 0;
+      oLinkList = LinkList_getNext(oLinkList), uiIndex++){
+    puiBest[uiIndex] =\
+      ExpBeam_fromTree(&oPool, (TreeNode_T)LinkList_getValue(oLinkList), 0);
+    iResult = (puiBest[uiIndex] == BEAM_NONE);
+  }
+  if(iResult == 0)
+    iResult = ExpBeam_reachAll(&oPool, puiBest, uiRoots, &lReach);
+  uiBefore = uiBestCost = ExpBeam_cost(&oPool, &lReach);
+  if(iResult == 0){
+    psBeam[0].puiRoots =\
+      (unsigned int*)malloc((uiRoots + 1u) * sizeof(unsigned int));
+    iResult = (psBeam[0].puiRoots == NULL);
+    uiStates = (iResult == 0);
+  }
+  for(oLinkList = pllTrees, uiIndex = 0u;
+      oLinkList != NULL && iResult == 0;
+      oLinkList = LinkList_getNext(oLinkList), uiIndex++){
+    psBeam[0].puiRoots[uiIndex] =\
+      ExpBeam_fromTree(&oPool, (TreeNode_T)LinkList_getValue(oLinkList), 1);
+    iResult = (psBeam[0].puiRoots[uiIndex] == BEAM_NONE);
+  }
+  if(iResult == 0)
+    iResult = ExpBeam_score(&oPool, &psBeam[0], uiRoots, &lReach);
+  if(iResult == 0 && psBeam[0].uiCost < uiBestCost){
+    uiBestCost = psBeam[0].uiCost;
+    memcpy(puiBest, psBeam[0].puiRoots, uiRoots * sizeof(unsigned int));
+  }
+  //expand every state by its best pairings, and keep the best of them
+  while(iResult == 0 && iStop == 0 && uiStates > 0u){
+    uiNext = 0u;
+    for(uiIndex = 0u; uiIndex < uiStates && iResult == 0 && iStop == 0;
+	uiIndex++)
+      for(uiAction = 0u;
+	  uiAction < psBeam[uiIndex].uiActions && iResult == 0 && iStop == 0;
+	  uiAction++){
+	if((double)(clock() - cStart) / CLOCKS_PER_SEC > dSeconds ||\
+	   ExpBudget_isExhausted(oExpBudget)){
+	  iStop = 1;
+	  break;
+	}
+	psState = &psNext[uiNext];
+	psState -> puiRoots =\
+	  (unsigned int*)malloc((uiRoots + 1u) * sizeof(unsigned int));
+	if(psState -> puiRoots == NULL){
+	  iResult = 1;
+	  break;
+	}
+	ExpBeam_newGeneration(&oPool);
+	for(uiCandidate = 0u; uiCandidate < uiRoots; uiCandidate++){
+	  psState -> puiRoots[uiCandidate] =\
+	    ExpBeam_pair(&oPool, psBeam[uiIndex].puiRoots[uiCandidate],\
+			 &psBeam[uiIndex].paActions[uiAction]);
+	  if(psState -> puiRoots[uiCandidate] == BEAM_NONE)
+	    break;
+	}
+	if(uiCandidate < uiRoots){
+	  free(psState -> puiRoots);
+	  //a full pool ends the search, but is not a failure
+	  if(oPool.uiNodes == BEAM_MAX_NODES)
+	    iStop = 1;
+	  else
+	    iResult = 1;
+	  break;
+	}
+	//different pairing orders often meet in the same state
+	for(uiCandidate = 0u; uiCandidate < uiNext; uiCandidate++)
+	  if(memcmp(psNext[uiCandidate].puiRoots, psState -> puiRoots,\
+		    uiRoots * sizeof(unsigned int)) == 0)
+	    break;
+	if(uiCandidate < uiNext){
+	  free(psState -> puiRoots);
+	  continue;
+	}
+	if(ExpBeam_score(&oPool, psState, uiRoots, &lReach) != 0){
+	  free(psState -> puiRoots);
+	  iResult = 1;
+	  break;
+	}
+	uiNext++;
+	if(psState -> uiCost < uiBestCost){
+	  uiBestCost = psState -> uiCost;
+	  memcpy(puiBest, psState -> puiRoots, uiRoots * sizeof(unsigned int));
+	}
+      }
+    ExpBeam_freeStates(psBeam, uiStates);
+    qsort(psNext, uiNext, sizeof(struct BeamState), ExpBeam_compareStates);
+    uiStates = (uiNext < uiWidth) ? uiNext : uiWidth;
+    memcpy(psBeam, psNext, uiStates * sizeof(struct BeamState));
+    ExpBeam_freeStates(psNext + uiStates, uiNext - uiStates);
+  }
+  if(psBeam != NULL)
+    ExpBeam_freeStates(psBeam, uiStates);
+  if(iResult == 0 && uiBestCost < uiBefore)
+    iResult = ExpBeam_rewrite(&oPool, pllTrees, puiBest, uiRoots);
+  if(iResult != 0)
+    uiBestCost = uiBefore;
+  if(puiBefore != NULL)
+    *puiBefore = uiBefore;
+  if(puiAfter != NULL)
+    *puiAfter = uiBestCost;
+  free(psBeam);
+  free(psNext);
+  free(puiBest);
+  free(lReach.puiItems);
+  ExpBeam_freePool(&oPool);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expbeam.c                                                       */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  LinkList_T pllTrees, oLinkList;
+  unsigned int uiBefore, uiAfter;
+
+  //(a+b)+c and (a+c)+d share nothing until a+c is computed first
+  pllTrees = LinkList_new();
+  oLinkList = LinkList_new();
+  LinkList_setValue(pllTrees,\
+		    ExpTokenTree_newNode(ADD,\
+					 ExpTokenTree_newNode(ADD,\
+					   ExpTokenTree_newLeaf("a"),\
+					   ExpTokenTree_newLeaf("b")),\
+					 ExpTokenTree_newLeaf("c")));
+  LinkList_setValue(oLinkList,\
+		    ExpTokenTree_newNode(ADD,\
+					 ExpTokenTree_newNode(ADD,\
+					   ExpTokenTree_newLeaf("a"),\
+					   ExpTokenTree_newLeaf("c")),\
+					 ExpTokenTree_newLeaf("d")));
+  LinkList_setNext(pllTrees, oLinkList);
+  if(ExpBeam_apply(pllTrees, 4u, 1.0, NULL, &uiBefore, &uiAfter) != 0)
+    printf("failed test 1\n");
+  if(uiBefore != 4u || uiAfter != 3u)
+    printf("failed test 2\n");
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    ExpTokenTree_print((TreeNode_T)LinkList_getValue(oLinkList));
+    printf("\n");
+    ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkList));
+  }
+  LinkList_freeRecursive(pllTrees);
+  return 0;
+}
+*/
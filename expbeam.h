@@ -0,0 +1,33 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbeam.h describes a beam search over the order in which operands of*/
+/*sums and products are paired up. ExpParser_simplify only shares a    */
+/*pairing that the parse happened to produce, ex. a+b in (a+b)+c; here */
+/*every chain of + or * is flattened, and the search chooses which     */
+/*pairs to compute first so that as many as possible are shared        */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPBEAM_INCLUDED
+#define EXPBEAM_INCLUDED
+
+#include "linklist.h"
+#include "expbudget.h"
+
+/*---------------------------------------------------------------------*/
+/*Search for a cheap way to pair the operands of every sum and product */
+/*in the trees stored in the list pllTrees, and rewrite the trees into */
+/*it if it needs fewer operations, once common subexpressions are      */
+/*shared, than the trees as they are. The search keeps the uiWidth best*/
+/*partial states, scored by their operation count less the saving of   */
+/*their best next pairing, and stops when no pairing saves anything,   */
+/*after dSeconds, or once oExpBudget, which may be NULL, is exhausted. */
+/*A width of 1 is a greedy search. Store the number of operations      */
+/*before and after in puiBefore and puiAfter if they are not NULL.     */
+/*Return 0 if successful, 1 if memory is insufficient, in which case   */
+/*the trees are left as they were                                      */
+/*---------------------------------------------------------------------*/
+int ExpBeam_apply(LinkList_T pllTrees, unsigned int uiWidth,\
+		  double dSeconds, ExpBudget_T oExpBudget,\
+		  unsigned int* puiBefore, unsigned int* puiAfter);
+
+#endif
@@ -0,0 +1,323 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbind.c implements expbind.h. Bindings are kept in two parallel    */
+/*arrays, and each value is stored as a ready made tree that is copied */
+/*in wherever its operand appears                                      */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expbind.h"
+#include "exprational.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of an ExpBind, and the longest binding   */
+/*ExpBind_read accepts                                                 */
+/*---------------------------------------------------------------------*/
+#define INITIAL_BINDINGS 16u
+#define MAX_BINDING 64u
+
+/*---------------------------------------------------------------------*/
+/*An ExpBind holds the names of the bound operands and the trees they  */
+/*are replaced with                                                    */
+/*---------------------------------------------------------------------*/
+struct ExpBind
+{
+  /*the bound operand names*/
+  char** ppcNames;
+  /*the value of each name, as an operand or the negation of one*/
+  TreeNode_T* poValues;
+  /*number of bindings stored*/
+  unsigned int uiLength;
+  /*number of bindings that fit*/
+  unsigned int uiMax;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpBind                                          */
+/*---------------------------------------------------------------------*/
+ExpBind_T ExpBind_new(void){
+  ExpBind_T oExpBind = (ExpBind_T)malloc(sizeof(struct ExpBind));
+  if(oExpBind == NULL)
+    return NULL;
+  oExpBind -> ppcNames = (char**)malloc(INITIAL_BINDINGS * sizeof(char*));
+  oExpBind -> poValues =\
+    (TreeNode_T*)malloc(INITIAL_BINDINGS * sizeof(TreeNode_T));
+  if(oExpBind -> ppcNames == NULL || oExpBind -> poValues == NULL){
+    free(oExpBind -> ppcNames);
+    free(oExpBind -> poValues);
+    free(oExpBind);
+    return NULL;
+  }
+  oExpBind -> uiLength = 0u;
+  oExpBind -> uiMax = INITIAL_BINDINGS;
+  return oExpBind;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpBind                                                        */
+/*---------------------------------------------------------------------*/
+void ExpBind_free(ExpBind_T oExpBind){
+  unsigned int uiIndex;
+  assert(oExpBind != NULL);
+  for(uiIndex = 0u; uiIndex < oExpBind -> uiLength; uiIndex++){
+    free(oExpBind -> ppcNames[uiIndex]);
+    ExpTokenTree_free(oExpBind -> poValues[uiIndex]);
+  }
+  free(oExpBind -> ppcNames);
+  free(oExpBind -> poValues);
+  free(oExpBind);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the index of the binding of pcName in oExpBind, or uiLength if*/
+/*pcName is not bound                                                  */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpBind_find(ExpBind_T oExpBind, const char* pcName){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < oExpBind -> uiLength; uiIndex++)
+    if(strcmp(oExpBind -> ppcNames[uiIndex], pcName) == 0)
+      break;
+  return uiIndex;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in *poTreeNode a new tree for the literal pcValue, which may be*/
+/*preceded by -. Return 0 if successful, 1 if memory is insufficient,  */
+/*-1 if pcValue is not a literal that fits in an operand               */
+/*---------------------------------------------------------------------*/
+static int ExpBind_value(const char* pcValue, TreeNode_T* poTreeNode){
+  struct ExpRational rValue;
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode, oTreeNodeNegative;
+  int iNegative;
+  iNegative = (*pcValue == '-');
+  pcValue += iNegative;
+  if(ExpRational_parse(pcValue, &rValue) != 0 ||\
+     strlen(pcValue) > ExpToken_maxChars())
+    return -1;
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return 1;
+  for(; *pcValue != '\0'; pcValue++)
+    ExpToken_appendChar(oExpToken, *pcValue);
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return 1;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  if(iNegative){
+    //-0 is just 0, which folding would make of it anyway
+    oExpToken = ExpToken_new();
+    oTreeNodeNegative = ExpTokenTree_new();
+    if(oExpToken == NULL || oTreeNodeNegative == NULL ||\
+       ExpTokenTree_addChild(oTreeNodeNegative, oTreeNode) != 0){
+      if(oExpToken != NULL)
+	ExpToken_free(oExpToken);
+      if(oTreeNodeNegative != NULL)
+	ExpTokenTree_free(oTreeNodeNegative);
+      ExpTokenTree_free(oTreeNode);
+      return 1;
+    }
+    ExpToken_setType(oExpToken, NEGATIVE);
+    ExpTokenTree_setValue(oTreeNodeNegative, oExpToken);
+    oTreeNode = oTreeNodeNegative;
+  }
+  *poTreeNode = oTreeNode;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the binding pcBinding to oExpBind                                */
+/*---------------------------------------------------------------------*/
+int ExpBind_add(ExpBind_T oExpBind, const char* pcBinding){
+  const char* pcEquals;
+  char* pcName;
+  char** ppcNames;
+  TreeNode_T* poValues;
+  TreeNode_T oTreeNodeValue;
+  unsigned int uiNameLength, uiIndex;
+  int iStatus;
+  assert(oExpBind != NULL);
+  assert(pcBinding != NULL);
+  pcEquals = strchr(pcBinding, '=');
+  if(pcEquals == NULL || pcEquals == pcBinding ||\
+     (unsigned int)(pcEquals - pcBinding) > ExpToken_maxChars()){
+    fprintf(stderr, "ExpBind_add: bad binding '%s'\n", pcBinding);
+    return -1;
+  }
+  uiNameLength = (unsigned int)(pcEquals - pcBinding);
+  iStatus = ExpBind_value(pcEquals + 1, &oTreeNodeValue);
+  if(iStatus == -1)
+    fprintf(stderr, "ExpBind_add: bad value in '%s'\n", pcBinding);
+  if(iStatus != 0)
+    return iStatus;
+  pcName = (char*)malloc(uiNameLength + 1u);
+  if(pcName == NULL){
+    ExpTokenTree_free(oTreeNodeValue);
+    return 1;
+  }
+  memcpy(pcName, pcBinding, uiNameLength);
+  pcName[uiNameLength] = '\0';
+  //rebinding a name replaces its value
+  uiIndex = ExpBind_find(oExpBind, pcName);
+  if(uiIndex < oExpBind -> uiLength){
+    free(pcName);
+    ExpTokenTree_free(oExpBind -> poValues[uiIndex]);
+    oExpBind -> poValues[uiIndex] = oTreeNodeValue;
+    return 0;
+  }
+  if(oExpBind -> uiLength == oExpBind -> uiMax){
+    ppcNames = (char**)realloc(oExpBind -> ppcNames,\
+			       2u * oExpBind -> uiMax * sizeof(char*));
+    if(ppcNames != NULL)
+      oExpBind -> ppcNames = ppcNames;
+    poValues = (TreeNode_T*)realloc(oExpBind -> poValues,\
+				    2u * oExpBind -> uiMax *\
+				    sizeof(TreeNode_T));
+    if(poValues != NULL)
+      oExpBind -> poValues = poValues;
+    if(ppcNames == NULL || poValues == NULL){
+      free(pcName);
+      ExpTokenTree_free(oTreeNodeValue);
+      return 1;
+    }
+    oExpBind -> uiMax *= 2u;
+  }
+  oExpBind -> ppcNames[oExpBind -> uiLength] = pcName;
+  oExpBind -> poValues[oExpBind -> uiLength] = oTreeNodeValue;
+  oExpBind -> uiLength++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add every binding in psFile to oExpBind                              */
+/*---------------------------------------------------------------------*/
+int ExpBind_read(ExpBind_T oExpBind, FILE* psFile){
+  char pcBinding[MAX_BINDING + 1u];
+  unsigned int uiLength = 0u;
+  int iChar, iStatus;
+  assert(oExpBind != NULL);
+  assert(psFile != NULL);
+  do{
+    iChar = getc(psFile);
+    //skip comments
+    if(iChar == '#')
+      while(iChar != '\n' && iChar != EOF)
+	iChar = getc(psFile);
+    if(iChar == EOF || iChar == ',' || iChar == ' ' || iChar == '\t' ||\
+       iChar == '\n' || iChar == '\r'){
+      //a separator ends the binding being read, if any
+      if(uiLength == 0u)
+	continue;
+      pcBinding[uiLength] = '\0';
+      uiLength = 0u;
+      iStatus = ExpBind_add(oExpBind, pcBinding);
+      if(iStatus != 0)
+	return iStatus;
+    }
+    else if(uiLength == MAX_BINDING){
+      pcBinding[uiLength] = '\0';
+      fprintf(stderr, "ExpBind_read: binding too long '%s...'\n",\
+	      pcBinding);
+      return -1;
+    }
+    else
+      pcBinding[uiLength++] = (char)iChar;
+  }while(iChar != EOF);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of bindings in oExpBind                            */
+/*---------------------------------------------------------------------*/
+unsigned int ExpBind_howMany(ExpBind_T oExpBind){
+  assert(oExpBind != NULL);
+  return oExpBind -> uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the bound operands in oTreeNode, and return the result, which*/
+/*is oTreeNode itself unless oTreeNode is a bound operand. Add the     */
+/*number of operands replaced to *puiBound. Set *piStatus to 1 if      */
+/*memory is insufficient, in which case the operand is left in place   */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpBind_rewrite(ExpBind_T oExpBind, TreeNode_T oTreeNode,\
+				  unsigned int* puiBound, int* piStatus){
+  ExpToken_T oExpToken;
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeValue;
+  unsigned int uiIndex;
+  oExpToken = ExpTokenTree_getValue(oTreeNode);
+  if(ExpToken_getType(oExpToken) != OPERAND){
+    for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+	oLinkList != NULL;
+	oLinkList = LinkList_getNext(oLinkList))
+      LinkList_setValue(oLinkList, ExpBind_rewrite\
+			(oExpBind, (TreeNode_T)LinkList_getValue(oLinkList),\
+			 puiBound, piStatus));
+    return oTreeNode;
+  }
+  uiIndex = ExpBind_find(oExpBind, ExpToken_getName(oExpToken));
+  if(uiIndex == oExpBind -> uiLength)
+    return oTreeNode;
+  oTreeNodeValue = ExpTokenTree_copy(oExpBind -> poValues[uiIndex]);
+  if(oTreeNodeValue == NULL){
+    *piStatus = 1;
+    return oTreeNode;
+  }
+  ExpTokenTree_free(oTreeNode);
+  (*puiBound)++;
+  return oTreeNodeValue;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace every bound operand in the trees stored in pllTrees          */
+/*---------------------------------------------------------------------*/
+int ExpBind_apply(ExpBind_T oExpBind, LinkList_T pllTrees,\
+		  unsigned int* puiBound){
+  LinkList_T oLinkList;
+  unsigned int uiBound = 0u;
+  int iStatus = 0;
+  assert(oExpBind != NULL);
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(LinkList_getValue(oLinkList) != NULL)
+      LinkList_setValue(oLinkList, ExpBind_rewrite\
+			(oExpBind, (TreeNode_T)LinkList_getValue(oLinkList),\
+			 &uiBound, &iStatus));
+  if(puiBound != NULL)
+    *puiBound = uiBound;
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expbind.c                                                       */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  ExpBind_T oExpBind;
+
+  oExpBind = ExpBind_new();
+  if(oExpBind == NULL)
+    printf("failed test 1\n");
+  if(ExpBind_add(oExpBind, "a1_2=0") != 0)
+    printf("failed test 2\n");
+  if(ExpBind_add(oExpBind, "a2_1=-0.5") != 0)
+    printf("failed test 3\n");
+  if(ExpBind_add(oExpBind, "a1_2=1") != 0 || ExpBind_howMany(oExpBind) != 2u)
+    printf("failed test 4\n");
+  if(ExpBind_add(oExpBind, "a3_3=x") != -1)
+    printf("failed test 5\n");
+  if(ExpBind_add(oExpBind, "=1") != -1)
+    printf("failed test 6\n");
+  ExpBind_free(oExpBind);
+  return 0;
+}
+*/
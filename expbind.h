@@ -0,0 +1,60 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbind.h describes a set of bindings that give known operands a     */
+/*constant value, ex. a1_3=0 for a structural zero of a banded matrix. */
+/*Substituting the bindings and then folding specializes one dense     */
+/*symbolic input to a particular sparsity pattern                      */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPBIND_INCLUDED
+#define EXPBIND_INCLUDED
+
+#include <stdio.h>
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*An ExpBind is a set of operand names, each bound to a literal value  */
+/*---------------------------------------------------------------------*/
+typedef struct ExpBind* ExpBind_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpBind, or NULL if memory is insufficient       */
+/*---------------------------------------------------------------------*/
+ExpBind_T ExpBind_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpBind                                 */
+/*---------------------------------------------------------------------*/
+void ExpBind_free(ExpBind_T oExpBind);
+
+/*---------------------------------------------------------------------*/
+/*Add the binding pcBinding, of the form name=value, to oExpBind. The  */
+/*value is a literal (ex. 0, 2 or 0.5), optionally preceded by -. A    */
+/*later binding of the same name replaces an earlier one. Return 0 if  */
+/*successful, 1 if memory is insufficient, -1 if pcBinding is malformed*/
+/*---------------------------------------------------------------------*/
+int ExpBind_add(ExpBind_T oExpBind, const char* pcBinding);
+
+/*---------------------------------------------------------------------*/
+/*Add every binding in psFile to oExpBind. Bindings are separated by   */
+/*whitespace or commas, and a # starts a comment that runs to the end  */
+/*of the line. Return 0 if successful, 1 if memory is insufficient, -1 */
+/*if a binding is malformed                                            */
+/*---------------------------------------------------------------------*/
+int ExpBind_read(ExpBind_T oExpBind, FILE* psFile);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of bindings in oExpBind                            */
+/*---------------------------------------------------------------------*/
+unsigned int ExpBind_howMany(ExpBind_T oExpBind);
+
+/*---------------------------------------------------------------------*/
+/*Replace every bound operand in the trees stored in the list pllTrees */
+/*with its value. Store the number of operands replaced in puiBound if */
+/*it is not NULL. Return 0 if successful, 1 if memory is insufficient, */
+/*in which case some operands may not have been replaced               */
+/*---------------------------------------------------------------------*/
+int ExpBind_apply(ExpBind_T oExpBind, LinkList_T pllTrees,\
+		  unsigned int* puiBound);
+
+#endif
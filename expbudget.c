@@ -0,0 +1,165 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbudget.c implements expbudget.h. Time is read from the monotonic  */
+/*clock, and memory from the peak resident size the system reports     */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "expbudget.h"
+
+/*---------------------------------------------------------------------*/
+/*An ExpBudget holds its limits and the time it was created            */
+/*---------------------------------------------------------------------*/
+struct ExpBudget
+{
+  /*time the budget was created*/
+  struct timespec tsStart;
+  /*seconds allowed, or 0 for no limit*/
+  double dSeconds;
+  /*peak resident kilobytes allowed, or 0 for no limit*/
+  unsigned long ulKilobytes;
+  /*nonzero once a limit has been reached*/
+  int iExhausted;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return the seconds since oExpBudget was created                      */
+/*---------------------------------------------------------------------*/
+static double ExpBudget_elapsed(ExpBudget_T oExpBudget){
+  struct timespec tsNow;
+  clock_gettime(CLOCK_MONOTONIC, &tsNow);
+  return (double)(tsNow.tv_sec - oExpBudget -> tsStart.tv_sec) +\
+    (double)(tsNow.tv_nsec - oExpBudget -> tsStart.tv_nsec) / 1e9;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpBudget with no limits                                */
+/*---------------------------------------------------------------------*/
+ExpBudget_T ExpBudget_new(void){
+  ExpBudget_T oExpBudget;
+  oExpBudget = (ExpBudget_T)malloc(sizeof(struct ExpBudget));
+  if(oExpBudget == NULL)
+    return NULL;
+  clock_gettime(CLOCK_MONOTONIC, &oExpBudget -> tsStart);
+  oExpBudget -> dSeconds = 0.0;
+  oExpBudget -> ulKilobytes = 0ul;
+  oExpBudget -> iExhausted = 0;
+  return oExpBudget;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpBudget with dShare of the limits of oExpBudget       */
+/*---------------------------------------------------------------------*/
+ExpBudget_T ExpBudget_newShare(ExpBudget_T oExpBudget, double dShare){
+  ExpBudget_T oExpBudgetShare;
+  assert(oExpBudget != NULL);
+  oExpBudgetShare = (ExpBudget_T)malloc(sizeof(struct ExpBudget));
+  if(oExpBudgetShare == NULL)
+    return NULL;
+  oExpBudgetShare -> tsStart = oExpBudget -> tsStart;
+  oExpBudgetShare -> dSeconds = oExpBudget -> dSeconds * dShare;
+  oExpBudgetShare -> ulKilobytes =\
+    (unsigned long)((double)oExpBudget -> ulKilobytes * dShare);
+  //a limit of 0 would mean no limit
+  if(oExpBudget -> ulKilobytes != 0ul && oExpBudgetShare -> ulKilobytes == 0ul)
+    oExpBudgetShare -> ulKilobytes = 1ul;
+  oExpBudgetShare -> iExhausted = 0;
+  return oExpBudgetShare;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpBudget                               */
+/*---------------------------------------------------------------------*/
+void ExpBudget_free(ExpBudget_T oExpBudget){
+  free(oExpBudget);
+}
+
+/*---------------------------------------------------------------------*/
+/*Limit oExpBudget to dSeconds                                         */
+/*---------------------------------------------------------------------*/
+void ExpBudget_setTime(ExpBudget_T oExpBudget, double dSeconds){
+  assert(oExpBudget != NULL);
+  oExpBudget -> dSeconds = dSeconds;
+}
+
+/*---------------------------------------------------------------------*/
+/*Limit oExpBudget to ulMegabytes                                      */
+/*---------------------------------------------------------------------*/
+void ExpBudget_setMemory(ExpBudget_T oExpBudget, unsigned long ulMegabytes){
+  assert(oExpBudget != NULL);
+  oExpBudget -> ulKilobytes = ulMegabytes * 1024ul;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if a limit of oExpBudget has been reached, 0 if not         */
+/*---------------------------------------------------------------------*/
+int ExpBudget_isExhausted(ExpBudget_T oExpBudget){
+  struct rusage ruUsage;
+  if(oExpBudget == NULL)
+    return 0;
+  if(oExpBudget -> iExhausted != 0)
+    return 1;
+  if(oExpBudget -> dSeconds > 0.0 &&\
+     ExpBudget_elapsed(oExpBudget) >= oExpBudget -> dSeconds)
+    oExpBudget -> iExhausted = 1;
+  //ru_maxrss is in kilobytes on Linux
+  if(oExpBudget -> ulKilobytes != 0ul &&\
+     getrusage(RUSAGE_SELF, &ruUsage) == 0 &&\
+     (unsigned long)ruUsage.ru_maxrss >= oExpBudget -> ulKilobytes)
+    oExpBudget -> iExhausted = 1;
+  return oExpBudget -> iExhausted;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the smaller of the seconds left in oExpBudget and dSeconds    */
+/*---------------------------------------------------------------------*/
+double ExpBudget_timeLeft(ExpBudget_T oExpBudget, double dSeconds){
+  double dLeft;
+  if(oExpBudget == NULL || oExpBudget -> dSeconds <= 0.0)
+    return dSeconds;
+  dLeft = oExpBudget -> dSeconds - ExpBudget_elapsed(oExpBudget);
+  //a limit of 0 would mean no limit, so stop at once instead
+  if(dLeft <= 0.0)
+    dLeft = 1e-9;
+  if(dSeconds > 0.0 && dSeconds < dLeft)
+    return dSeconds;
+  return dLeft;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expbudget.c                                                     */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  ExpBudget_T oExpBudget, oExpBudgetShare;
+
+  if(ExpBudget_isExhausted(NULL) != 0)
+    printf("failed test 1\n");
+  oExpBudget = ExpBudget_new();
+  if(ExpBudget_isExhausted(oExpBudget) != 0)
+    printf("failed test 2\n");
+  if(ExpBudget_timeLeft(oExpBudget, 2.0) != 2.0)
+    printf("failed test 3\n");
+  ExpBudget_setTime(oExpBudget, 1e-6);
+  while(ExpBudget_isExhausted(oExpBudget) == 0);
+  if(ExpBudget_timeLeft(oExpBudget, 0.0) > 1e-6)
+    printf("failed test 4\n");
+  ExpBudget_setMemory(oExpBudget, 1ul);
+  if(ExpBudget_isExhausted(oExpBudget) != 1)
+    printf("failed test 5\n");
+  ExpBudget_free(oExpBudget);
+  oExpBudget = ExpBudget_new();
+  ExpBudget_setTime(oExpBudget, 100.0);
+  oExpBudgetShare = ExpBudget_newShare(oExpBudget, 0.5);
+  if(ExpBudget_timeLeft(oExpBudgetShare, 0.0) > 50.0 ||\
+     ExpBudget_timeLeft(oExpBudget, 0.0) <= 50.0)
+    printf("failed test 6\n");
+  ExpBudget_free(oExpBudgetShare);
+  ExpBudget_free(oExpBudget);
+  return 0;
+}
+*/
@@ -0,0 +1,64 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expbudget.h describes the time and memory budget shared by the passes*/
+/*of the optimizer. A pass that takes long checks the budget as it goes*/
+/*and stops with the best valid result it has, so that the tool can    */
+/*always answer within the budget, if only with the trees as parsed    */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPBUDGET_INCLUDED
+#define EXPBUDGET_INCLUDED
+
+/*---------------------------------------------------------------------*/
+/*An ExpBudget is a wall clock limit and a memory limit, either of     */
+/*which may be absent. A NULL ExpBudget_T is a budget with no limits   */
+/*---------------------------------------------------------------------*/
+typedef struct ExpBudget* ExpBudget_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpBudget with no limits, whose clock starts now, or    */
+/*NULL if memory is insufficient                                       */
+/*---------------------------------------------------------------------*/
+ExpBudget_T ExpBudget_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpBudget on the clock of oExpBudget whose limits are   */
+/*dShare of its limits, so that the passes given it stop with the rest */
+/*of oExpBudget left for the passes after them, or NULL if memory is   */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+ExpBudget_T ExpBudget_newShare(ExpBudget_T oExpBudget, double dShare);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpBudget                               */
+/*---------------------------------------------------------------------*/
+void ExpBudget_free(ExpBudget_T oExpBudget);
+
+/*---------------------------------------------------------------------*/
+/*Limit oExpBudget to dSeconds of wall clock time since it was created.*/
+/*A dSeconds of 0 removes the limit                                    */
+/*---------------------------------------------------------------------*/
+void ExpBudget_setTime(ExpBudget_T oExpBudget, double dSeconds);
+
+/*---------------------------------------------------------------------*/
+/*Limit oExpBudget to a peak resident size of ulMegabytes, or remove   */
+/*the limit if ulMegabytes is 0. The limit is checked, not enforced, so*/
+/*a pass may go a little over it before it stops                       */
+/*---------------------------------------------------------------------*/
+void ExpBudget_setMemory(ExpBudget_T oExpBudget, unsigned long ulMegabytes);
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if either limit of oExpBudget has been reached, 0 if not.   */
+/*Once a limit is reached the budget stays exhausted, so every pass    */
+/*after the first to notice sees it at once                            */
+/*---------------------------------------------------------------------*/
+int ExpBudget_isExhausted(ExpBudget_T oExpBudget);
+
+/*---------------------------------------------------------------------*/
+/*Return the seconds left in oExpBudget, or dSeconds if that is less,  */
+/*so that a pass with a time limit of its own can be given the smaller */
+/*of the two. A dSeconds of 0 means the pass has no limit of its own   */
+/*---------------------------------------------------------------------*/
+double ExpBudget_timeLeft(ExpBudget_T oExpBudget, double dSeconds);
+
+#endif
@@ -0,0 +1,862 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expcgen.c implements expcgen.h. Mappings are kept in two parallel    */
+/*arrays, as bindings are, and the slot of every input is worked out   */
+/*before anything is printed, so a mapping that does not fit the inputs*/
+/*leaves no half written function behind                               */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expcgen.h"
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of the mappings of an ExpCGen, and the   */
+/*longest mapping ExpCGen_readSlots accepts                            */
+/*---------------------------------------------------------------------*/
+#define INITIAL_SLOTS 16u
+#define MAX_SLOT 128u
+
+/*---------------------------------------------------------------------*/
+/*Define the index of an input that is not mapped to one               */
+/*---------------------------------------------------------------------*/
+#define NO_INDEX (~0u)
+
+/*---------------------------------------------------------------------*/
+/*An ExpCGen holds the name of the function, the type of the input     */
+/*struct, and the operand names mapped to a slot with their slots      */
+/*---------------------------------------------------------------------*/
+struct ExpCGen
+{
+  char* pcFunction;
+  /*type of the input struct, or NULL if the inputs are an array*/
+  char* pcStruct;
+  char** ppcNames;
+  char** ppcSlots;
+  /*number of mappings stored*/
+  unsigned int uiLength;
+  /*number of mappings that fit*/
+  unsigned int uiMax;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return a copy of the first uiLength chars of pcString, or NULL if    */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static char* ExpCGen_copy(const char* pcString, size_t uiLength){
+  char* pcCopy = (char*)malloc(uiLength + 1u);
+  if(pcCopy == NULL)
+    return NULL;
+  memcpy(pcCopy, pcString, uiLength);
+  pcCopy[uiLength] = '\0';
+  return pcCopy;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpCGen                                                 */
+/*---------------------------------------------------------------------*/
+ExpCGen_T ExpCGen_new(void){
+  ExpCGen_T oExpCGen = (ExpCGen_T)malloc(sizeof(struct ExpCGen));
+  if(oExpCGen == NULL)
+    return NULL;
+  oExpCGen -> pcFunction =\
+    ExpCGen_copy(EXPCGEN_FUNCTION, strlen(EXPCGEN_FUNCTION));
+  oExpCGen -> ppcNames = (char**)malloc(INITIAL_SLOTS * sizeof(char*));
+  oExpCGen -> ppcSlots = (char**)malloc(INITIAL_SLOTS * sizeof(char*));
+  if(oExpCGen -> pcFunction == NULL || oExpCGen -> ppcNames == NULL ||\
+     oExpCGen -> ppcSlots == NULL){
+    free(oExpCGen -> pcFunction);
+    free(oExpCGen -> ppcNames);
+    free(oExpCGen -> ppcSlots);
+    free(oExpCGen);
+    return NULL;
+  }
+  oExpCGen -> pcStruct = NULL;
+  oExpCGen -> uiLength = 0u;
+  oExpCGen -> uiMax = INITIAL_SLOTS;
+  return oExpCGen;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpCGen                                                        */
+/*---------------------------------------------------------------------*/
+void ExpCGen_free(ExpCGen_T oExpCGen){
+  unsigned int uiIndex;
+  assert(oExpCGen != NULL);
+  for(uiIndex = 0u; uiIndex < oExpCGen -> uiLength; uiIndex++){
+    free(oExpCGen -> ppcNames[uiIndex]);
+    free(oExpCGen -> ppcSlots[uiIndex]);
+  }
+  free(oExpCGen -> ppcNames);
+  free(oExpCGen -> ppcSlots);
+  free(oExpCGen -> pcFunction);
+  free(oExpCGen -> pcStruct);
+  free(oExpCGen);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of chars at the start of pcString that form a C    */
+/*identifier, or 0 if it does not start with one                       */
+/*---------------------------------------------------------------------*/
+static size_t ExpCGen_identifier(const char* pcString){
+  size_t uiLength = 0u;
+  char c;
+  for(c = pcString[0]; c != '\0'; c = pcString[++uiLength]){
+    if(!(c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||\
+	 (uiLength > 0u && c >= '0' && c <= '9')))
+      break;
+  }
+  return uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if pcString is a C identifier, 0 otherwise                  */
+/*---------------------------------------------------------------------*/
+static int ExpCGen_isIdentifier(const char* pcString){
+  size_t uiLength = ExpCGen_identifier(pcString);
+  return uiLength > 0u && pcString[uiLength] == '\0';
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if pcString designates a member of a struct, a C identifier */
+/*followed by any number of array indexes and further members, ex.     */
+/*pos.x or v[2], 0 otherwise                                           */
+/*---------------------------------------------------------------------*/
+static int ExpCGen_isMember(const char* pcString){
+  const char* pcDigits;
+  size_t uiLength;
+  for(;;){
+    uiLength = ExpCGen_identifier(pcString);
+    if(uiLength == 0u)
+      return 0;
+    pcString += uiLength;
+    while(*pcString == '['){
+      for(pcDigits = ++pcString; *pcString >= '0' && *pcString <= '9';)
+	pcString++;
+      if(pcString == pcDigits || *pcString != ']')
+	return 0;
+      pcString++;
+    }
+    if(*pcString == '\0')
+      return 1;
+    if(*pcString != '.')
+      return 0;
+    pcString++;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the array index pcSlot in *puiIndex. Return 0 if successful, -1*/
+/*if pcSlot is not an index                                            */
+/*---------------------------------------------------------------------*/
+static int ExpCGen_index(const char* pcSlot, unsigned int* puiIndex){
+  char* pcEnd;
+  unsigned long ulIndex;
+  if(*pcSlot < '0' || *pcSlot > '9')
+    return -1;
+  ulIndex = strtoul(pcSlot, &pcEnd, 10);
+  if(*pcEnd != '\0' || ulIndex >= (unsigned long)NO_INDEX)
+    return -1;
+  *puiIndex = (unsigned int)ulIndex;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the string *ppcString by a copy of pcValue. Return 0 if      */
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpCGen_setString(char** ppcString, const char* pcValue){
+  char* pcCopy = ExpCGen_copy(pcValue, strlen(pcValue));
+  if(pcCopy == NULL)
+    return 1;
+  free(*ppcString);
+  *ppcString = pcCopy;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Name the generated function                                          */
+/*---------------------------------------------------------------------*/
+int ExpCGen_setFunction(ExpCGen_T oExpCGen, const char* pcName){
+  assert(oExpCGen != NULL);
+  assert(pcName != NULL);
+  if(!ExpCGen_isIdentifier(pcName)){
+    fprintf(stderr, "ExpCGen_setFunction: bad name '%s'\n", pcName);
+    return -1;
+  }
+  return ExpCGen_setString(&oExpCGen -> pcFunction, pcName);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the name of the generated function                            */
+/*---------------------------------------------------------------------*/
+const char* ExpCGen_function(ExpCGen_T oExpCGen){
+  assert(oExpCGen != NULL);
+  return oExpCGen -> pcFunction;
+}
+
+/*---------------------------------------------------------------------*/
+/*Read the inputs from a struct of type pcType                         */
+/*---------------------------------------------------------------------*/
+int ExpCGen_setStruct(ExpCGen_T oExpCGen, const char* pcType){
+  assert(oExpCGen != NULL);
+  assert(pcType != NULL);
+  if(!ExpCGen_isIdentifier(pcType)){
+    fprintf(stderr, "ExpCGen_setStruct: bad type '%s'\n", pcType);
+    return -1;
+  }
+  return ExpCGen_setString(&oExpCGen -> pcStruct, pcType);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the index of the mapping of pcName in oExpCGen, or uiLength if*/
+/*pcName is not mapped                                                 */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpCGen_find(ExpCGen_T oExpCGen, const char* pcName){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < oExpCGen -> uiLength; uiIndex++)
+    if(strcmp(oExpCGen -> ppcNames[uiIndex], pcName) == 0)
+      break;
+  return uiIndex;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the mapping pcSlot to oExpCGen                                   */
+/*---------------------------------------------------------------------*/
+int ExpCGen_addSlot(ExpCGen_T oExpCGen, const char* pcSlot){
+  const char* pcEquals;
+  char* pcName;
+  char* pcValue;
+  char** ppcNames;
+  char** ppcSlots;
+  unsigned int uiIndex;
+  assert(oExpCGen != NULL);
+  assert(pcSlot != NULL);
+  pcEquals = strchr(pcSlot, '=');
+  if(pcEquals == NULL || pcEquals == pcSlot ||\
+     (ExpCGen_index(pcEquals + 1, &uiIndex) != 0 &&\
+      !ExpCGen_isMember(pcEquals + 1))){
+    fprintf(stderr, "ExpCGen_addSlot: bad mapping '%s'\n", pcSlot);
+    return -1;
+  }
+  pcName = ExpCGen_copy(pcSlot, (size_t)(pcEquals - pcSlot));
+  pcValue = ExpCGen_copy(pcEquals + 1, strlen(pcEquals + 1));
+  if(pcName == NULL || pcValue == NULL){
+    free(pcName);
+    free(pcValue);
+    return 1;
+  }
+  //mapping a name again replaces its slot
+  uiIndex = ExpCGen_find(oExpCGen, pcName);
+  if(uiIndex < oExpCGen -> uiLength){
+    free(pcName);
+    free(oExpCGen -> ppcSlots[uiIndex]);
+    oExpCGen -> ppcSlots[uiIndex] = pcValue;
+    return 0;
+  }
+  if(oExpCGen -> uiLength == oExpCGen -> uiMax){
+    ppcNames = (char**)realloc(oExpCGen -> ppcNames,\
+			       2u * oExpCGen -> uiMax * sizeof(char*));
+    if(ppcNames != NULL)
+      oExpCGen -> ppcNames = ppcNames;
+    ppcSlots = (char**)realloc(oExpCGen -> ppcSlots,\
+			       2u * oExpCGen -> uiMax * sizeof(char*));
+    if(ppcSlots != NULL)
+      oExpCGen -> ppcSlots = ppcSlots;
+    if(ppcNames == NULL || ppcSlots == NULL){
+      free(pcName);
+      free(pcValue);
+      return 1;
+    }
+    oExpCGen -> uiMax *= 2u;
+  }
+  oExpCGen -> ppcNames[oExpCGen -> uiLength] = pcName;
+  oExpCGen -> ppcSlots[oExpCGen -> uiLength] = pcValue;
+  oExpCGen -> uiLength++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add every mapping in psFile to oExpCGen                              */
+/*---------------------------------------------------------------------*/
+int ExpCGen_readSlots(ExpCGen_T oExpCGen, FILE* psFile){
+  char pcSlot[MAX_SLOT + 1u];
+  unsigned int uiLength = 0u;
+  int iChar, iStatus;
+  assert(oExpCGen != NULL);
+  assert(psFile != NULL);
+  do{
+    iChar = getc(psFile);
+    //skip comments
+    if(iChar == '#')
+      while(iChar != '\n' && iChar != EOF)
+	iChar = getc(psFile);
+    if(iChar == EOF || iChar == ',' || iChar == ' ' || iChar == '\t' ||\
+       iChar == '\n' || iChar == '\r'){
+      //a separator ends the mapping being read, if any
+      if(uiLength == 0u)
+	continue;
+      pcSlot[uiLength] = '\0';
+      uiLength = 0u;
+      iStatus = ExpCGen_addSlot(oExpCGen, pcSlot);
+      if(iStatus != 0)
+	return iStatus;
+    }
+    else if(uiLength == MAX_SLOT){
+      pcSlot[uiLength] = '\0';
+      fprintf(stderr, "ExpCGen_readSlots: mapping too long '%s...'\n",\
+	      pcSlot);
+      return -1;
+    }
+    else
+      pcSlot[uiLength++] = (char)iChar;
+  }while(iChar != EOF);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare the unsigned ints pvFirst and pvSecond for qsort             */
+/*---------------------------------------------------------------------*/
+static int ExpCGen_compareIndex(const void* pvFirst, const void* pvSecond){
+  unsigned int uiFirst = *(const unsigned int*)pvFirst;
+  unsigned int uiSecond = *(const unsigned int*)pvSecond;
+  return (uiFirst > uiSecond) - (uiFirst < uiSecond);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in puiIndexes the array index every input of oExpSSA is read   */
+/*from                                                                 */
+/*---------------------------------------------------------------------*/
+int ExpCGen_indexes(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+		    unsigned int* puiIndexes){
+  unsigned int* puiTaken;
+  unsigned int uiInput, uiMapping, uiTaken = 0u, uiNext = 0u, uiIndex = 0u;
+  assert(oExpCGen != NULL);
+  assert(oExpSSA != NULL);
+  if(oExpCGen -> pcStruct != NULL){
+    fprintf(stderr, "ExpCGen_indexes: the inputs are a struct %s, not an "\
+	    "array\n", oExpCGen -> pcStruct);
+    return -1;
+  }
+  puiTaken = (unsigned int*)malloc((oExpCGen -> uiLength + 1u) *\
+				   sizeof(unsigned int));
+  if(puiTaken == NULL)
+    return 1;
+  //every mapping reserves its index, even one whose operand folded away,
+  //so the layout of the array does not depend on the input
+  for(uiMapping = 0u; uiMapping < oExpCGen -> uiLength; uiMapping++){
+    if(ExpCGen_index(oExpCGen -> ppcSlots[uiMapping],\
+		     &puiTaken[uiTaken]) != 0){
+      fprintf(stderr, "ExpCGen_indexes: slot '%s' of '%s' is not an "\
+	      "index\n",\
+	      oExpCGen -> ppcSlots[uiMapping],\
+	      oExpCGen -> ppcNames[uiMapping]);
+      free(puiTaken);
+      return -1;
+    }
+    uiTaken++;
+  }
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++){
+    puiIndexes[uiInput] = NO_INDEX;
+    uiMapping = ExpCGen_find(oExpCGen, ExpSSA_inputName(oExpSSA, uiInput));
+    if(uiMapping < oExpCGen -> uiLength)
+      ExpCGen_index(oExpCGen -> ppcSlots[uiMapping], &puiIndexes[uiInput]);
+  }
+  //the free indexes are found by walking the taken ones in order
+  qsort(puiTaken, uiTaken, sizeof(unsigned int), ExpCGen_compareIndex);
+  for(uiIndex = 1u; uiIndex < uiTaken; uiIndex++)
+    if(puiTaken[uiIndex] == puiTaken[uiIndex - 1u]){
+      fprintf(stderr, "ExpCGen_indexes: index %u taken twice\n",\
+	      puiTaken[uiIndex]);
+      free(puiTaken);
+      return -1;
+    }
+  uiIndex = 0u;
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++){
+    if(puiIndexes[uiInput] != NO_INDEX)
+      continue;
+    for(; uiNext < uiTaken && puiTaken[uiNext] <= uiIndex; uiNext++)
+      if(puiTaken[uiNext] == uiIndex)
+	uiIndex++;
+    puiIndexes[uiInput] = uiIndex++;
+  }
+  free(puiTaken);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in ppcMembers the member of the input struct every input of    */
+/*oExpSSA is read from: its mapped member, or else its own name. Return*/
+/*0 if successful, -1 if a mapped slot is not a member or an input that*/
+/*is not mapped is not a C identifier                                  */
+/*---------------------------------------------------------------------*/
+static int ExpCGen_members(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+			   const char** ppcMembers){
+  const char* pcName;
+  unsigned int uiInput, uiMapping;
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++){
+    pcName = ExpSSA_inputName(oExpSSA, uiInput);
+    uiMapping = ExpCGen_find(oExpCGen, pcName);
+    ppcMembers[uiInput] = (uiMapping == oExpCGen -> uiLength) ?\
+      pcName : oExpCGen -> ppcSlots[uiMapping];
+    if(!ExpCGen_isMember(ppcMembers[uiInput])){
+      fprintf(stderr, "ExpCGen_print: input '%s' needs a member of "\
+	      "struct %s\n", pcName, oExpCGen -> pcStruct);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Print dValue as a C double literal                                   */
+/*---------------------------------------------------------------------*/
+void ExpCGen_printLiteral(double dValue){
+  char pcNumber[32];
+  int iPrecision;
+  if(dValue != dValue){
+    ExpOut_string("NAN");
+    return;
+  }
+  if(dValue - dValue != 0.0){
+    ExpOut_string((dValue < 0.0) ? "-HUGE_VAL" : "HUGE_VAL");
+    return;
+  }
+  for(iPrecision = 1; iPrecision < 17; iPrecision++){
+    sprintf(pcNumber, "%.*g", iPrecision, dValue);
+    if(strtod(pcNumber, NULL) == dValue)
+      break;
+  }
+  sprintf(pcNumber, "%.*g", iPrecision, dValue);
+  ExpOut_string(pcNumber);
+  //without a point or an exponent the literal would be an int
+  if(strpbrk(pcNumber, ".e") == NULL)
+    ExpOut_string(".0");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print value uiValue of oExpSSA as a C expression: an input read      */
+/*through in, by its index in puiIndexes if ppcMembers is NULL and by  */
+/*its member in ppcMembers otherwise, a constant as a literal, and an  */
+/*instruction as its local, or as its place in oExpAlloc if that is not*/
+/*NULL                                                                 */
+/*---------------------------------------------------------------------*/
+static void ExpCGen_printValue(ExpSSA_T oExpSSA, unsigned int uiValue,\
+			       const unsigned int* puiIndexes,\
+			       const char** ppcMembers,\
+			       ExpAlloc_T oExpAlloc){
+  unsigned int uiInstruction;
+  if(uiValue >= ExpSSA_firstInstruction(oExpSSA)){
+    uiInstruction = uiValue - ExpSSA_firstInstruction(oExpSSA);
+    if(oExpAlloc == NULL){
+      ExpOut_char('t');
+      ExpOut_unsigned(uiInstruction);
+    }
+    else if(ExpAlloc_isSpilled(oExpAlloc, uiInstruction)){
+      ExpOut_string("s[");
+      ExpOut_unsigned(ExpAlloc_place(oExpAlloc, uiInstruction));
+      ExpOut_char(']');
+    }
+    else{
+      ExpOut_char('r');
+      ExpOut_unsigned(ExpAlloc_place(oExpAlloc, uiInstruction));
+    }
+  }
+  else if(uiValue >= ExpSSA_inputs(oExpSSA))
+    ExpCGen_printLiteral(ExpSSA_constantValue\
+			  (oExpSSA, uiValue - ExpSSA_inputs(oExpSSA)));
+  else if(ppcMembers == NULL){
+    ExpOut_string("in[");
+    ExpOut_unsigned(puiIndexes[uiValue]);
+    ExpOut_char(']');
+  }
+  else{
+    ExpOut_string("in -> ");
+    ExpOut_string(ppcMembers[uiValue]);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the fused multiply-add piInstruction of oExpSSA as a call to   */
+/*fma, its signs on the operands, which the compiler folds into the    */
+/*instruction, and its operands printed as by ExpCGen_printValue       */
+/*---------------------------------------------------------------------*/
+static void ExpCGen_printFused\
+(ExpSSA_T oExpSSA, const struct ExpSSAInstruction* piInstruction,\
+ const unsigned int* puiIndexes, const char** ppcMembers,\
+ ExpAlloc_T oExpAlloc){
+  ExpOut_string(piInstruction -> esoOp == EXPSSA_FNMA ||\
+		piInstruction -> esoOp == EXPSSA_FNMS ? "fma(-" : "fma(");
+  ExpCGen_printValue(oExpSSA, piInstruction -> puiArgs[0], puiIndexes,\
+		     ppcMembers, oExpAlloc);
+  ExpOut_string(", ");
+  ExpCGen_printValue(oExpSSA, piInstruction -> puiArgs[1], puiIndexes,\
+		     ppcMembers, oExpAlloc);
+  ExpOut_string(piInstruction -> esoOp == EXPSSA_FMS ||\
+		piInstruction -> esoOp == EXPSSA_FNMS ? ", -" : ", ");
+  ExpCGen_printValue(oExpSSA, piInstruction -> puiArgs[2], puiIndexes,\
+		     ppcMembers, oExpAlloc);
+  ExpOut_char(')');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the instruction piInstruction of oExpSSA as a C expression of  */
+/*its operands, printed as by ExpCGen_printValue                       */
+/*---------------------------------------------------------------------*/
+static void ExpCGen_printInstruction\
+(ExpSSA_T oExpSSA, const struct ExpSSAInstruction* piInstruction,\
+ const unsigned int* puiIndexes, const char** ppcMembers,\
+ ExpAlloc_T oExpAlloc){
+  const char* pcOperator = NULL;
+  switch(piInstruction -> esoOp)
+    {
+    case EXPSSA_FMA:
+    case EXPSSA_FMS:
+    case EXPSSA_FNMA:
+    case EXPSSA_FNMS:
+      ExpCGen_printFused(oExpSSA, piInstruction, puiIndexes, ppcMembers,\
+			 oExpAlloc);
+      return;
+    case EXPSSA_ADD:
+      pcOperator = " + ";
+      break;
+    case EXPSSA_SUBTRACT:
+      pcOperator = " - ";
+      break;
+    case EXPSSA_MULTIPLY:
+      pcOperator = " * ";
+      break;
+    case EXPSSA_DIVIDE:
+      pcOperator = " / ";
+      break;
+    case EXPSSA_POWER:
+      ExpOut_string("pow(");
+      pcOperator = ", ";
+      break;
+    case EXPSSA_NEGATIVE:
+      ExpOut_char('-');
+      break;
+    case EXPSSA_RECIPROCAL:
+      ExpOut_string("1.0 / ");
+      break;
+    case EXPSSA_SQRT:
+      ExpOut_string("sqrt(");
+      break;
+    }
+  ExpCGen_printValue(oExpSSA, piInstruction -> puiArgs[0], puiIndexes,\
+		     ppcMembers, oExpAlloc);
+  if(pcOperator != NULL){
+    ExpOut_string(pcOperator);
+    ExpCGen_printValue(oExpSSA, piInstruction -> puiArgs[1], puiIndexes,\
+		       ppcMembers, oExpAlloc);
+  }
+  if(piInstruction -> esoOp == EXPSSA_POWER ||\
+     piInstruction -> esoOp == EXPSSA_SQRT)
+    ExpOut_char(')');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print a comment listing the slot every input of oExpSSA is read from,*/
+/*ordered as the inputs are                                            */
+/*---------------------------------------------------------------------*/
+static void ExpCGen_printInputs(ExpSSA_T oExpSSA,\
+				const unsigned int* puiIndexes,\
+				const char** ppcMembers){
+  unsigned int uiInput;
+  ExpOut_string("/*\n * Generated by expparser: ");
+  ExpOut_unsigned(ExpSSA_inputs(oExpSSA));
+  ExpOut_string(" inputs, ");
+  ExpOut_unsigned(ExpSSA_instructions(oExpSSA));
+  ExpOut_string(" operations, ");
+  ExpOut_unsigned(ExpSSA_outputs(oExpSSA));
+  ExpOut_string(" outputs.\n * out[i] is expression i, and the operands "\
+		"are read from\n *\n");
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++){
+    ExpOut_string(" *   ");
+    ExpOut_string(ExpSSA_inputName(oExpSSA, uiInput));
+    ExpOut_string("  ");
+    ExpCGen_printValue(oExpSSA, uiInput, puiIndexes, ppcMembers, NULL);
+    ExpOut_char('\n');
+  }
+  ExpOut_string(" */\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the declarations of the registers and the scratch array of     */
+/*oExpAlloc, as many registers to a line as fit                        */
+/*---------------------------------------------------------------------*/
+static void ExpCGen_printPlaces(ExpAlloc_T oExpAlloc){
+  unsigned int uiMaxLive, uiRegisters, uiScratch, uiSpilled, uiRegister;
+  unsigned int uiDigits, uiColumn = 0u;
+  ExpAlloc_counts(oExpAlloc, &uiMaxLive, &uiRegisters, &uiScratch,\
+		  &uiSpilled);
+  for(uiRegister = 0u; uiRegister < uiRegisters; uiRegister++){
+    if(uiColumn == 0u){
+      ExpOut_string("  double");
+      uiColumn = 8u;
+    }
+    ExpOut_string(" r");
+    ExpOut_unsigned(uiRegister);
+    uiColumn += 4u;
+    for(uiDigits = uiRegister; uiDigits >= 10u; uiDigits /= 10u)
+      uiColumn++;
+    if(uiRegister + 1u == uiRegisters || uiColumn > 64u){
+      ExpOut_string(";\n");
+      uiColumn = 0u;
+    }
+    else
+      ExpOut_char(',');
+  }
+  if(uiScratch > 0u){
+    ExpOut_string("  double s[");
+    ExpOut_unsigned(uiScratch);
+    ExpOut_string("];\n");
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Chain the outputs of oExpSSA computed by each instruction, in order, */
+/*from puiFirst, indexed by instruction, through puiNext, indexed by   */
+/*output                                                               */
+/*---------------------------------------------------------------------*/
+static void ExpCGen_chainOutputs(ExpSSA_T oExpSSA, unsigned int* puiFirst,\
+				 unsigned int* puiNext){
+  unsigned int uiIndex, uiValue;
+  unsigned int uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++)
+    puiFirst[uiIndex] = NO_INDEX;
+  for(uiIndex = ExpSSA_outputs(oExpSSA); uiIndex-- > 0u;){
+    uiValue = ExpSSA_output(oExpSSA, uiIndex);
+    if(uiValue < uiFirst)
+      continue;
+    puiNext[uiIndex] = puiFirst[uiValue - uiFirst];
+    puiFirst[uiValue - uiFirst] = uiIndex;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the body of the function computing oExpSSA, with the results of*/
+/*its instructions in the places of oExpAlloc if it is not NULL, in    */
+/*which case the outputs of each instruction are chained by puiFirst   */
+/*and puiNext and stored straight after it                             */
+/*---------------------------------------------------------------------*/
+static void ExpCGen_printBody(ExpSSA_T oExpSSA,\
+			      const unsigned int* puiIndexes,\
+			      const char** ppcMembers, ExpAlloc_T oExpAlloc,\
+			      const unsigned int* puiFirst,\
+			      const unsigned int* puiNext){
+  unsigned int uiIndex, uiOutput, uiValue;
+  unsigned int uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  if(oExpAlloc != NULL)
+    ExpCGen_printPlaces(oExpAlloc);
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++){
+    if(oExpAlloc == NULL){
+      ExpOut_string("  const double t");
+      ExpOut_unsigned(uiIndex);
+    }
+    else{
+      ExpOut_string("  ");
+      ExpCGen_printValue(oExpSSA, uiFirst + uiIndex, puiIndexes,\
+			 ppcMembers, oExpAlloc);
+    }
+    ExpOut_string(" = ");
+    ExpCGen_printInstruction(oExpSSA, ExpSSA_instruction(oExpSSA, uiIndex),\
+			     puiIndexes, ppcMembers, oExpAlloc);
+    ExpOut_string(";\n");
+    if(oExpAlloc == NULL)
+      continue;
+    //the place may be taken by a later result, so it is stored now
+    for(uiOutput = puiFirst[uiIndex]; uiOutput != NO_INDEX;\
+	uiOutput = puiNext[uiOutput]){
+      ExpOut_string("  out[");
+      ExpOut_unsigned(uiOutput);
+      ExpOut_string("] = ");
+      ExpCGen_printValue(oExpSSA, uiFirst + uiIndex, puiIndexes,\
+			 ppcMembers, oExpAlloc);
+      ExpOut_string(";\n");
+    }
+  }
+  for(uiIndex = 0u; uiIndex < ExpSSA_outputs(oExpSSA); uiIndex++){
+    uiValue = ExpSSA_output(oExpSSA, uiIndex);
+    if(oExpAlloc != NULL && uiValue >= uiFirst)
+      continue;
+    ExpOut_string("  out[");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string("] = ");
+    ExpCGen_printValue(oExpSSA, uiValue, puiIndexes, ppcMembers, oExpAlloc);
+    ExpOut_string(";\n");
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print oExpSSA as a C function, with the results of its instructions  */
+/*in the places of oExpAlloc if it is not NULL                         */
+/*---------------------------------------------------------------------*/
+static int ExpCGen_printFunction(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+				 ExpAlloc_T oExpAlloc){
+  unsigned int* puiIndexes = NULL;
+  unsigned int* puiFirst = NULL;
+  unsigned int* puiNext = NULL;
+  const char** ppcMembers = NULL;
+  int iStatus;
+  assert(oExpCGen != NULL);
+  assert(oExpSSA != NULL);
+  if(oExpAlloc != NULL){
+    puiFirst = (unsigned int*)malloc((ExpSSA_instructions(oExpSSA) + 1u) *\
+				     sizeof(unsigned int));
+    puiNext = (unsigned int*)malloc((ExpSSA_outputs(oExpSSA) + 1u) *\
+				    sizeof(unsigned int));
+    if(puiFirst == NULL || puiNext == NULL){
+      free(puiFirst);
+      free(puiNext);
+      return 1;
+    }
+    ExpCGen_chainOutputs(oExpSSA, puiFirst, puiNext);
+  }
+  //the slots are all found before anything is printed
+  if(oExpCGen -> pcStruct == NULL){
+    puiIndexes = (unsigned int*)malloc((ExpSSA_inputs(oExpSSA) + 1u) *\
+				       sizeof(unsigned int));
+    iStatus = (puiIndexes == NULL) ? 1 :\
+      ExpCGen_indexes(oExpCGen, oExpSSA, puiIndexes);
+  }
+  else{
+    ppcMembers = (const char**)malloc((ExpSSA_inputs(oExpSSA) + 1u) *\
+				      sizeof(const char*));
+    iStatus = (ppcMembers == NULL) ? 1 :\
+      ExpCGen_members(oExpCGen, oExpSSA, ppcMembers);
+  }
+  if(iStatus != 0){
+    free(puiIndexes);
+    free(ppcMembers);
+    free(puiFirst);
+    free(puiNext);
+    return iStatus;
+  }
+  ExpCGen_printInputs(oExpSSA, puiIndexes, ppcMembers);
+  ExpOut_string("#include <math.h>\n\nvoid ");
+  ExpOut_string(oExpCGen -> pcFunction);
+  if(oExpCGen -> pcStruct == NULL)
+    ExpOut_string("(const double* restrict in,");
+  else{
+    ExpOut_string("(const struct ");
+    ExpOut_string(oExpCGen -> pcStruct);
+    ExpOut_string("* restrict in,");
+  }
+  ExpOut_string(" double* restrict out){\n");
+  ExpCGen_printBody(oExpSSA, puiIndexes, ppcMembers, oExpAlloc, puiFirst,\
+		    puiNext);
+  ExpOut_string("}\n");
+  free(puiIndexes);
+  free(ppcMembers);
+  free(puiFirst);
+  free(puiNext);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Print oExpSSA as a C function                                        */
+/*---------------------------------------------------------------------*/
+int ExpCGen_print(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA){
+  return ExpCGen_printFunction(oExpCGen, oExpSSA, NULL);
+}
+
+/*---------------------------------------------------------------------*/
+/*Print oExpSSA as a C function with its results placed by oExpAlloc   */
+/*---------------------------------------------------------------------*/
+int ExpCGen_printAllocated(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+			   ExpAlloc_T oExpAlloc){
+  assert(oExpAlloc != NULL);
+  return ExpCGen_printFunction(oExpCGen, oExpSSA, oExpAlloc);
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expcgen.c                                                       */
+/*---------------------------------------------------------------------*/
+/*
+#include "exptokentree.h"
+#include "exptoken.h"
+
+int main(void){
+  ExpProgram_T oExpProgram;
+  ExpSSA_T oExpSSA;
+  ExpCGen_T oExpCGen;
+  LinkList_T pllTrees;
+  double dHuge;
+
+  //#0 = a*b+2, #1 = #0/c, outputs #1 and a
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD,\
+				      ExpTokenTree_newNode(MULTIPLY,\
+					ExpTokenTree_newLeaf("a"),\
+					ExpTokenTree_newLeaf("b")),\
+				      ExpTokenTree_newLeaf("2")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(DIVIDE, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("c")));
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf("#1"));
+  LinkList_setNext(pllTrees, LinkList_new());
+  LinkList_setValue(LinkList_getNext(pllTrees), ExpTokenTree_newLeaf("a"));
+  oExpSSA = ExpSSA_new(oExpProgram, pllTrees);
+  oExpCGen = ExpCGen_new();
+  if(oExpSSA == NULL || oExpCGen == NULL)
+    printf("failed test 1\n");
+  if(ExpCGen_addSlot(oExpCGen, "x") != -1 ||\
+     ExpCGen_addSlot(oExpCGen, "a=") != -1 ||\
+     ExpCGen_addSlot(oExpCGen, "a=p.") != -1 ||\
+     ExpCGen_addSlot(oExpCGen, "a=v[]") != -1 ||\
+     ExpCGen_setFunction(oExpCGen, "2f") != -1 ||\
+     ExpCGen_setStruct(oExpCGen, "a b") != -1)
+    printf("failed test 2\n");
+  //b takes index 0 and c the lowest free index, 1
+  if(ExpCGen_addSlot(oExpCGen, "a=2") != 0 ||\
+     ExpCGen_setFunction(oExpCGen, "kernel") != 0 ||\
+     ExpCGen_print(oExpCGen, oExpSSA) != 0)
+    printf("failed test 3\n");
+  //a member is not an index, and c is not a member of its own name
+  ExpCGen_addSlot(oExpCGen, "a=pos.v[0]");
+  if(ExpCGen_print(oExpCGen, oExpSSA) != -1)
+    printf("failed test 4\n");
+  ExpCGen_setStruct(oExpCGen, "Point");
+  ExpCGen_addSlot(oExpCGen, "c=scale");
+  if(ExpCGen_print(oExpCGen, oExpSSA) != 0)
+    printf("failed test 5\n");
+  ExpCGen_free(oExpCGen);
+  //a and b both read index 1
+  oExpCGen = ExpCGen_new();
+  if(ExpCGen_addSlot(oExpCGen, "a=1") != 0 ||\
+     ExpCGen_addSlot(oExpCGen, "b=1") != 0 ||\
+     ExpCGen_print(oExpCGen, oExpSSA) != -1)
+    printf("failed test 6\n");
+  ExpCGen_free(oExpCGen);
+  //q is not an input but keeps index 0, so b reads 1 and c reads 3
+  oExpCGen = ExpCGen_new();
+  if(ExpCGen_addSlot(oExpCGen, "q=0") != 0 ||\
+     ExpCGen_addSlot(oExpCGen, "a=2") != 0 ||\
+     ExpCGen_print(oExpCGen, oExpSSA) != 0)
+    printf("failed test 7\n");
+  //prints NAN -HUGE_VAL HUGE_VAL
+  dHuge = 1e308;
+  dHuge *= 10.0;
+  ExpCGen_printLiteral(dHuge - dHuge);
+  ExpOut_char(' ');
+  ExpCGen_printLiteral(-dHuge);
+  ExpOut_char(' ');
+  ExpCGen_printLiteral(dHuge);
+  ExpOut_char('\n');
+  ExpOut_flush();
+  ExpCGen_free(oExpCGen);
+  ExpSSA_free(oExpSSA);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(LinkList_getNext(pllTrees)));
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(LinkList_getNext(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expcgen.h describes a code generator that writes the static single   */
+/*assignment form of a program as a self-contained C function, ready to*/
+/*be compiled into another program. Which input each operand is read   */
+/*from is configurable, so the function fits the data layout of its    */
+/*caller                                                               */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPCGEN_INCLUDED
+#define EXPCGEN_INCLUDED
+
+#include <stdio.h>
+#include "expssa.h"
+#include "expalloc.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the name of the generated function unless another is set      */
+/*---------------------------------------------------------------------*/
+#define EXPCGEN_FUNCTION "expparser_eval"
+
+/*---------------------------------------------------------------------*/
+/*An ExpCGen is the configuration of the generated function: its name, */
+/*whether the inputs are an array of doubles or the members of a       */
+/*struct, and the slot, an index or a member, that operands are read   */
+/*from                                                                 */
+/*---------------------------------------------------------------------*/
+typedef struct ExpCGen* ExpCGen_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpCGen that writes a function named EXPCGEN_FUNCTION   */
+/*reading its inputs from an array, with no operand mapped to a slot,  */
+/*or NULL if memory is insufficient                                    */
+/*---------------------------------------------------------------------*/
+ExpCGen_T ExpCGen_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpCGen                                 */
+/*---------------------------------------------------------------------*/
+void ExpCGen_free(ExpCGen_T oExpCGen);
+
+/*---------------------------------------------------------------------*/
+/*Name the function oExpCGen writes pcName. Return 0 if successful, 1  */
+/*if memory is insufficient, -1 if pcName is not a C identifier        */
+/*---------------------------------------------------------------------*/
+int ExpCGen_setFunction(ExpCGen_T oExpCGen, const char* pcName);
+
+/*---------------------------------------------------------------------*/
+/*Return the name of the function oExpCGen writes. oExpCGen keeps      */
+/*ownership                                                            */
+/*---------------------------------------------------------------------*/
+const char* ExpCGen_function(ExpCGen_T oExpCGen);
+
+/*---------------------------------------------------------------------*/
+/*Read the inputs of the function oExpCGen writes from the members of a*/
+/*struct of type pcType, defined by the caller, rather than from an    */
+/*array. Return 0 if successful, 1 if memory is insufficient, -1 if    */
+/*pcType is not a C identifier                                         */
+/*---------------------------------------------------------------------*/
+int ExpCGen_setStruct(ExpCGen_T oExpCGen, const char* pcType);
+
+/*---------------------------------------------------------------------*/
+/*Add the mapping pcSlot, of the form name=slot, to oExpCGen. The slot */
+/*is the index the operand is read from in the input array, ex. x=3, or*/
+/*the member it is read from in the input struct, ex. x=pos.x. A later */
+/*mapping of the same name replaces an earlier one. Return 0 if        */
+/*successful, 1 if memory is insufficient, -1 if pcSlot is malformed   */
+/*---------------------------------------------------------------------*/
+int ExpCGen_addSlot(ExpCGen_T oExpCGen, const char* pcSlot);
+
+/*---------------------------------------------------------------------*/
+/*Add every mapping in psFile to oExpCGen. Mappings are separated by   */
+/*whitespace or commas, and a # starts a comment that runs to the end  */
+/*of the line. Return 0 if successful, 1 if memory is insufficient, -1 */
+/*if a mapping is malformed                                            */
+/*---------------------------------------------------------------------*/
+int ExpCGen_readSlots(ExpCGen_T oExpCGen, FILE* psFile);
+
+/*---------------------------------------------------------------------*/
+/*Store in puiIndexes, which holds one entry per input of oExpSSA, the */
+/*index of the input array each input is read from: its mapped index,  */
+/*or else the lowest index neither mapped nor taken by an earlier      */
+/*input. Every mapping reserves its index, including one whose operand */
+/*is not an input of oExpSSA. Return 0 if successful, 1 if memory is   */
+/*insufficient, -1 if the inputs are a struct, a mapped slot is not an */
+/*index or two operands are mapped to the same index                   */
+/*---------------------------------------------------------------------*/
+int ExpCGen_indexes(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+		    unsigned int* puiIndexes);
+
+/*---------------------------------------------------------------------*/
+/*Print dValue to stdout as a C double literal with the fewest digits  */
+/*that read back as the same double. An infinity, which only a literal */
+/*too large or folding can give, is printed as HUGE_VAL or -HUGE_VAL   */
+/*and a NaN as NAN, from math.h                                        */
+/*---------------------------------------------------------------------*/
+void ExpCGen_printLiteral(double dValue);
+
+/*---------------------------------------------------------------------*/
+/*Print to stdout a C function computing oExpSSA, configured by        */
+/*oExpCGen. The function reads its inputs through a const restrict     */
+/*pointer, to an array of doubles or to the input struct, and stores   */
+/*output i at index i of a restrict array of doubles. Every instruction*/
+/*becomes a local, and every constant a literal. In an array, an       */
+/*operand that is not mapped takes the lowest index no other operand is*/
+/*read from; in a struct, it is read from the member of its own name.  */
+/*Return 0 if successful, 1 if memory is insufficient, -1 if a slot    */
+/*does not fit the inputs, in which case nothing is printed            */
+/*---------------------------------------------------------------------*/
+int ExpCGen_print(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Print to stdout the C function of ExpCGen_print, with the result of  */
+/*every instruction in the place oExpAlloc gives it rather than a local*/
+/*of its own: a register, one of the double locals r0, r1 and so on, or*/
+/*a slot of the local array s. An output computed by an instruction is */
+/*stored straight after it, while the place is still its own. Return as*/
+/*ExpCGen_print does                                                   */
+/*---------------------------------------------------------------------*/
+int ExpCGen_printAllocated(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+			   ExpAlloc_T oExpAlloc);
+
+#endif
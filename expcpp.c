@@ -0,0 +1,303 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expcpp.c implements expcpp.h. The body of the kernel is written once,*/
+/*as NAME_into, over whatever the inputs and outputs are indexed       */
+/*through, and the std::array and std::span entry points only forward  */
+/*to it, so every instance of T shares one body per container          */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "expcpp.h"
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*Print value uiValue of oExpSSA as a C++ expression of type T: an     */
+/*input read through in by its index in puiIndexes, a constant as a    */
+/*literal converted to T, and an instruction as its local              */
+/*---------------------------------------------------------------------*/
+static void ExpCpp_printValue(ExpSSA_T oExpSSA, unsigned int uiValue,\
+			      const unsigned int* puiIndexes){
+  if(uiValue >= ExpSSA_firstInstruction(oExpSSA)){
+    ExpOut_char('t');
+    ExpOut_unsigned(uiValue - ExpSSA_firstInstruction(oExpSSA));
+  }
+  else if(uiValue >= ExpSSA_inputs(oExpSSA)){
+    ExpOut_string("T(");
+    ExpCGen_printLiteral(ExpSSA_constantValue\
+			  (oExpSSA, uiValue - ExpSSA_inputs(oExpSSA)));
+    ExpOut_char(')');
+  }
+  else{
+    ExpOut_string("in[");
+    ExpOut_unsigned(puiIndexes[uiValue]);
+    ExpOut_char(']');
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the instruction piInstruction of oExpSSA as a C++ expression of*/
+/*its operands, printed as by ExpCpp_printValue. Square roots, powers  */
+/*and fused multiply-adds are called unqualified, so those of T are    */
+/*found beside the ones of std brought in by the function              */
+/*---------------------------------------------------------------------*/
+static void ExpCpp_printInstruction\
+(ExpSSA_T oExpSSA, const struct ExpSSAInstruction* piInstruction,\
+ const unsigned int* puiIndexes){
+  const char* pcOperator = NULL;
+  switch(piInstruction -> esoOp)
+    {
+    case EXPSSA_FMA:
+    case EXPSSA_FMS:
+    case EXPSSA_FNMA:
+    case EXPSSA_FNMS:
+      ExpOut_string(piInstruction -> esoOp == EXPSSA_FNMA ||\
+		    piInstruction -> esoOp == EXPSSA_FNMS ? "fma(-" : "fma(");
+      ExpCpp_printValue(oExpSSA, piInstruction -> puiArgs[0], puiIndexes);
+      ExpOut_string(", ");
+      ExpCpp_printValue(oExpSSA, piInstruction -> puiArgs[1], puiIndexes);
+      ExpOut_string(piInstruction -> esoOp == EXPSSA_FMS ||\
+		    piInstruction -> esoOp == EXPSSA_FNMS ? ", -" : ", ");
+      ExpCpp_printValue(oExpSSA, piInstruction -> puiArgs[2], puiIndexes);
+      ExpOut_char(')');
+      return;
+    case EXPSSA_ADD:
+      pcOperator = " + ";
+      break;
+    case EXPSSA_SUBTRACT:
+      pcOperator = " - ";
+      break;
+    case EXPSSA_MULTIPLY:
+      pcOperator = " * ";
+      break;
+    case EXPSSA_DIVIDE:
+      pcOperator = " / ";
+      break;
+    case EXPSSA_POWER:
+      ExpOut_string("pow(");
+      pcOperator = ", ";
+      break;
+    case EXPSSA_NEGATIVE:
+      ExpOut_char('-');
+      break;
+    case EXPSSA_RECIPROCAL:
+      ExpOut_string("T(1.0) / ");
+      break;
+    case EXPSSA_SQRT:
+      ExpOut_string("sqrt(");
+      break;
+    }
+  ExpCpp_printValue(oExpSSA, piInstruction -> puiArgs[0], puiIndexes);
+  if(pcOperator != NULL){
+    ExpOut_string(pcOperator);
+    ExpCpp_printValue(oExpSSA, piInstruction -> puiArgs[1], puiIndexes);
+  }
+  if(piInstruction -> esoOp == EXPSSA_POWER ||\
+     piInstruction -> esoOp == EXPSSA_SQRT)
+    ExpOut_char(')');
+}
+
+/*---------------------------------------------------------------------*/
+/*Return nonzero if some instruction of oExpSSA is of operation esoOp  */
+/*---------------------------------------------------------------------*/
+static int ExpCpp_uses(ExpSSA_T oExpSSA, enum ExpSSAOp esoOp){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++)
+    if(ExpSSA_instruction(oExpSSA, uiIndex) -> esoOp == esoOp)
+      return 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Print a comment listing the index every input of oExpSSA is read     */
+/*from, then the include guard, named after pcFunction, and the headers*/
+/*---------------------------------------------------------------------*/
+static void ExpCpp_printHeader(ExpSSA_T oExpSSA, const char* pcFunction,\
+			       const unsigned int* puiIndexes){
+  unsigned int uiInput;
+  const char* pcChar;
+  ExpOut_string("/*\n * Generated by expparser: ");
+  ExpOut_unsigned(ExpSSA_inputs(oExpSSA));
+  ExpOut_string(" inputs, ");
+  ExpOut_unsigned(ExpSSA_instructions(oExpSSA));
+  ExpOut_string(" operations, ");
+  ExpOut_unsigned(ExpSSA_outputs(oExpSSA));
+  ExpOut_string(" outputs.\n * out[i] is expression i, and the operands "\
+		"are read from\n *\n");
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++){
+    ExpOut_string(" *   ");
+    ExpOut_string(ExpSSA_inputName(oExpSSA, uiInput));
+    ExpOut_string("  ");
+    ExpCpp_printValue(oExpSSA, uiInput, puiIndexes);
+    ExpOut_char('\n');
+  }
+  ExpOut_string(" */\n#ifndef ");
+  for(pcChar = pcFunction; *pcChar != '\0'; pcChar++)
+    ExpOut_char((char)toupper((unsigned char)*pcChar));
+  ExpOut_string("_HPP_INCLUDED\n#define ");
+  for(pcChar = pcFunction; *pcChar != '\0'; pcChar++)
+    ExpOut_char((char)toupper((unsigned char)*pcChar));
+  ExpOut_string("_HPP_INCLUDED\n\n#include <array>\n#include <cmath>\n"\
+		"#include <cstddef>\n#if defined(__has_include)\n"\
+		"#if __has_include(<span>)\n#include <span>\n#endif\n"\
+		"#endif\n\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the definition of NAME_into, for the function named pcFunction,*/
+/*computing oExpSSA with its inputs at puiIndexes                      */
+/*---------------------------------------------------------------------*/
+static void ExpCpp_printBody(ExpSSA_T oExpSSA, const char* pcFunction,\
+			     const unsigned int* puiIndexes){
+  unsigned int uiIndex;
+  ExpOut_string("template <typename T, typename In, typename Out>\n"\
+		"constexpr void ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_into(const In& in, Out&& out){\n");
+  if(ExpCpp_uses(oExpSSA, EXPSSA_SQRT))
+    ExpOut_string("  using std::sqrt;\n");
+  if(ExpCpp_uses(oExpSSA, EXPSSA_POWER))
+    ExpOut_string("  using std::pow;\n");
+  if(ExpCpp_uses(oExpSSA, EXPSSA_FMA) || ExpCpp_uses(oExpSSA, EXPSSA_FMS) ||\
+     ExpCpp_uses(oExpSSA, EXPSSA_FNMA) || ExpCpp_uses(oExpSSA, EXPSSA_FNMS))
+    ExpOut_string("  using std::fma;\n");
+  //a program without inputs or outputs leaves a parameter unused
+  if(ExpSSA_inputs(oExpSSA) == 0u)
+    ExpOut_string("  static_cast<void>(in);\n");
+  if(ExpSSA_outputs(oExpSSA) == 0u)
+    ExpOut_string("  static_cast<void>(out);\n");
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++){
+    ExpOut_string("  const T t");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string(" = ");
+    ExpCpp_printInstruction(oExpSSA, ExpSSA_instruction(oExpSSA, uiIndex),\
+			    puiIndexes);
+    ExpOut_string(";\n");
+  }
+  for(uiIndex = 0u; uiIndex < ExpSSA_outputs(oExpSSA); uiIndex++){
+    ExpOut_string("  out[");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string("] = ");
+    ExpCpp_printValue(oExpSSA, ExpSSA_output(oExpSSA, uiIndex),\
+		      puiIndexes);
+    ExpOut_string(";\n");
+  }
+  ExpOut_string("}\n\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the std::array and std::span entry points of the function named*/
+/*pcFunction, of uiInputs inputs and uiOutputs outputs, forwarding to  */
+/*NAME_into                                                            */
+/*---------------------------------------------------------------------*/
+static void ExpCpp_printEntries(const char* pcFunction,\
+				unsigned int uiInputs,\
+				unsigned int uiOutputs){
+  ExpOut_string("template <typename T>\nconstexpr std::array<T, ");
+  ExpOut_unsigned(uiOutputs);
+  ExpOut_string("> ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("(const std::array<T, ");
+  ExpOut_unsigned(uiInputs);
+  ExpOut_string(">& in){\n  std::array<T, ");
+  ExpOut_unsigned(uiOutputs);
+  ExpOut_string("> out{};\n  ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_into<T>(in, out);\n  return out;\n}\n\n"\
+		"#if defined(__cpp_lib_span)\ntemplate <typename T>\n"\
+		"constexpr void ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("(std::span<const T, ");
+  ExpOut_unsigned(uiInputs);
+  ExpOut_string("> in, std::span<T, ");
+  ExpOut_unsigned(uiOutputs);
+  ExpOut_string("> out){\n  ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_into<T>(in, out);\n}\n#endif\n\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print oExpSSA as a C++ header                                        */
+/*---------------------------------------------------------------------*/
+int ExpCpp_print(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA){
+  unsigned int* puiIndexes;
+  unsigned int uiInput, uiInputs = 0u;
+  int iStatus;
+  assert(oExpCGen != NULL);
+  assert(oExpSSA != NULL);
+  puiIndexes = (unsigned int*)malloc((ExpSSA_inputs(oExpSSA) + 1u) *\
+				     sizeof(unsigned int));
+  if(puiIndexes == NULL)
+    return 1;
+  iStatus = ExpCGen_indexes(oExpCGen, oExpSSA, puiIndexes);
+  if(iStatus != 0){
+    free(puiIndexes);
+    return iStatus;
+  }
+  //the input array reaches the highest index read, mapped or not
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++)
+    if(puiIndexes[uiInput] >= uiInputs)
+      uiInputs = puiIndexes[uiInput] + 1u;
+  ExpCpp_printHeader(oExpSSA, ExpCGen_function(oExpCGen), puiIndexes);
+  ExpCpp_printBody(oExpSSA, ExpCGen_function(oExpCGen), puiIndexes);
+  ExpCpp_printEntries(ExpCGen_function(oExpCGen), uiInputs,\
+		      ExpSSA_outputs(oExpSSA));
+  ExpOut_string("#endif\n");
+  free(puiIndexes);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expcpp.c                                                        */
+/*---------------------------------------------------------------------*/
+/*
+#include "exptokentree.h"
+#include "exptoken.h"
+
+int main(void){
+  ExpProgram_T oExpProgram;
+  ExpSSA_T oExpSSA;
+  ExpCGen_T oExpCGen;
+  LinkList_T pllTrees;
+
+  //#0 = a*b+2, #1 = #0/c, outputs #1 and a
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD,\
+				      ExpTokenTree_newNode(MULTIPLY,\
+					ExpTokenTree_newLeaf("a"),\
+					ExpTokenTree_newLeaf("b")),\
+				      ExpTokenTree_newLeaf("2")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(DIVIDE, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("c")));
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf("#1"));
+  LinkList_setNext(pllTrees, LinkList_new());
+  LinkList_setValue(LinkList_getNext(pllTrees), ExpTokenTree_newLeaf("a"));
+  oExpSSA = ExpSSA_new(oExpProgram, pllTrees);
+  oExpCGen = ExpCGen_new();
+  if(oExpSSA == NULL || oExpCGen == NULL)
+    printf("failed test 1\n");
+  //a at index 4 makes the input array 5 long, b and c take 0 and 1
+  if(ExpCGen_addSlot(oExpCGen, "a=4") != 0 ||\
+     ExpCGen_setFunction(oExpCGen, "kernel") != 0 ||\
+     ExpCpp_print(oExpCGen, oExpSSA) != 0)
+    printf("failed test 2\n");
+  //the inputs of a template are always an array
+  ExpCGen_setStruct(oExpCGen, "Point");
+  if(ExpCpp_print(oExpCGen, oExpSSA) != -1)
+    printf("failed test 3\n");
+  ExpOut_flush();
+  ExpCGen_free(oExpCGen);
+  ExpSSA_free(oExpSSA);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(LinkList_getNext(pllTrees)));
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(LinkList_getNext(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
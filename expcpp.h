@@ -0,0 +1,33 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expcpp.h describes a code generator that writes the static single    */
+/*assignment form of a program as a header-only C++ function template  */
+/*over the scalar type, so one kernel serves doubles, floats, vector   */
+/*wrapper types and dual numbers alike                                 */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPCPP_INCLUDED
+#define EXPCPP_INCLUDED
+
+#include "expcgen.h"
+#include "expssa.h"
+
+/*---------------------------------------------------------------------*/
+/*Print to stdout a C++17 header defining function templates over the  */
+/*scalar type T computing oExpSSA, named and with its inputs mapped to */
+/*indexes by oExpCGen as for ExpCGen_print. NAME<T>(in) takes the      */
+/*inputs as a std::array of T and returns the outputs as one,          */
+/*NAME<T>(in, out) takes them as std::spans where the library has them,*/
+/*and NAME_into<T>(in, out) reads and writes through anything          */
+/*indexable. Every template is constexpr, so constant inputs fold at   */
+/*compile time wherever the operations on T are constexpr, and square  */
+/*roots and powers are looked up by argument dependent lookup beside   */
+/*those of std, so a wrapper type brings its own. Every constant is    */
+/*converted with T(c). Return 0 if successful, 1 if memory is          */
+/*insufficient, -1 if oExpCGen reads the inputs from a struct or maps  */
+/*one to something other than an index, in which case nothing is       */
+/*printed                                                              */
+/*---------------------------------------------------------------------*/
+int ExpCpp_print(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA);
+
+#endif
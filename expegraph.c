@@ -0,0 +1,1525 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expegraph.c implements expegraph.h, an equality saturation engine for*/
+/*expression trees. Nodes are hash consed, so an equivalence class is  */
+/*never stored twice, and commutativity is handled by keeping the      */
+/*children of ADD and MULTIPLY nodes in sorted order                   */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include "expegraph.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacities of the node array and the hash tables  */
+/*---------------------------------------------------------------------*/
+#define INITIAL_NODES 1024u
+#define INITIAL_SYMBOLS 64u
+
+/*---------------------------------------------------------------------*/
+/*Define how many nodes are examined between checks of the clock       */
+/*---------------------------------------------------------------------*/
+#define CLOCK_INTERVAL 256u
+
+/*---------------------------------------------------------------------*/
+/*Define the maximum number of passes made by the sharing-aware        */
+/*extraction                                                           */
+/*---------------------------------------------------------------------*/
+#define SHARE_PASSES 16
+
+/*---------------------------------------------------------------------*/
+/*Define the most nodes the joint extraction of several classes may    */
+/*visit before it gives up and keeps the choices made for each alone   */
+/*---------------------------------------------------------------------*/
+#define JOINT_VISITS 50000000ul
+
+/*---------------------------------------------------------------------*/
+/*An ENode is a single operator or operand. The children of an ENode   */
+/*are equivalence classes rather than other ENodes. ENodes found to    */
+/*duplicate another ENode during a rebuild are marked dead and ignored */
+/*thereafter                                                           */
+/*---------------------------------------------------------------------*/
+struct ENode
+{
+  /*operator or operand type*/
+  enum ExpTokenType ettType;
+  /*index of the operand name for OPERANDs, -1 otherwise*/
+  int iSymbol;
+  /*child classes, -1 if unused*/
+  int aiChild[2];
+  /*nonzero if this node duplicates another live node*/
+  int iDead;
+};
+
+/*---------------------------------------------------------------------*/
+/*An EPair is a class and the cost of the node chosen for it           */
+/*---------------------------------------------------------------------*/
+struct EPair
+{
+  /*class id*/
+  int iClass;
+  /*cost of the chosen node*/
+  double dCost;
+};
+
+/*---------------------------------------------------------------------*/
+/*An ECostSet is the set of classes that make up the shared DAG chosen */
+/*to compute a class, excluding the class itself, sorted by class id   */
+/*---------------------------------------------------------------------*/
+struct ECostSet
+{
+  /*the classes and their costs*/
+  struct EPair* pepPairs;
+  /*number of classes in the set*/
+  unsigned int uiLength;
+};
+
+/*---------------------------------------------------------------------*/
+/*ExpEGraphs store an array of ENodes, a union-find forest over the    */
+/*node ids (the id of a class is the id of its representative node), a */
+/*hash table used to hash cons the nodes, a table of operand names, the*/
+/*list of unions discovered during the current iteration, and the      */
+/*limits on saturation                                                 */
+/*---------------------------------------------------------------------*/
+struct ExpEGraph
+{
+  /*the nodes*/
+  struct ENode* penNodes;
+  unsigned int uiNumNodes;
+  unsigned int uiMaxNodes;
+  /*union-find parents, one per node*/
+  int* piParent;
+  /*hash cons table of node ids, -1 if empty*/
+  int* piTable;
+  unsigned int uiTableSize;
+  /*operand names and their hash table*/
+  char** ppcSymbols;
+  unsigned int uiNumSymbols;
+  unsigned int uiMaxSymbols;
+  int* piSymbolTable;
+  unsigned int uiSymbolTableSize;
+  /*pairs of classes waiting to be merged*/
+  int* piPending;
+  unsigned int uiNumPending;
+  unsigned int uiMaxPending;
+  /*class membership, rebuilt at the start of every iteration*/
+  int* piMemberStart;
+  int* piMembers;
+  /*extraction costs and choices, indexed by class*/
+  double* pdCost;
+  int* piBest;
+  int iCostsValid;
+  /*number of live classes*/
+  unsigned int uiNumClasses;
+  /*limits*/
+  unsigned int uiNodeLimit;
+  double dTimeLimit;
+  clock_t ctStart;
+  /*budget shared with the other passes, or NULL*/
+  ExpBudget_T oExpBudget;
+  /*set while saturating, when a limit is reached, or memory runs out*/
+  int iSaturating;
+  int iStopped;
+  int iMemoryError;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return the number of children a node of type ettType has             */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_arity(enum ExpTokenType ettType){
+  switch(ettType)
+    {
+    case OPERAND:
+      return 0;
+    case POSITIVE:
+    case NEGATIVE:
+    case RECIPROCAL:
+      return 1;
+    default:
+      return 2;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpEGraph, or NULL if memory is insufficient     */
+/*---------------------------------------------------------------------*/
+ExpEGraph_T ExpEGraph_new(unsigned int uiNodeLimit, double dTimeLimit){
+  ExpEGraph_T oExpEGraph;
+  unsigned int uiIndex;
+  oExpEGraph = (ExpEGraph_T)calloc(1u, sizeof(struct ExpEGraph));
+  if(oExpEGraph == NULL)
+    return NULL;
+  oExpEGraph -> uiMaxNodes = INITIAL_NODES;
+  oExpEGraph -> penNodes =\
+    (struct ENode*)malloc(INITIAL_NODES * sizeof(struct ENode));
+  oExpEGraph -> piParent = (int*)malloc(INITIAL_NODES * sizeof(int));
+  oExpEGraph -> uiTableSize = 2u * INITIAL_NODES;
+  oExpEGraph -> piTable =\
+    (int*)malloc(oExpEGraph -> uiTableSize * sizeof(int));
+  oExpEGraph -> uiMaxSymbols = INITIAL_SYMBOLS;
+  oExpEGraph -> ppcSymbols =\
+    (char**)malloc(INITIAL_SYMBOLS * sizeof(char*));
+  oExpEGraph -> uiSymbolTableSize = 2u * INITIAL_SYMBOLS;
+  oExpEGraph -> piSymbolTable =\
+    (int*)malloc(oExpEGraph -> uiSymbolTableSize * sizeof(int));
+  if(oExpEGraph -> penNodes == NULL | oExpEGraph -> piParent == NULL |\
+     oExpEGraph -> piTable == NULL | oExpEGraph -> ppcSymbols == NULL |\
+     oExpEGraph -> piSymbolTable == NULL){
+    ExpEGraph_free(oExpEGraph);
+    return NULL;
+  }
+  for(uiIndex = 0u; uiIndex < oExpEGraph -> uiTableSize; uiIndex++)
+    oExpEGraph -> piTable[uiIndex] = -1;
+  for(uiIndex = 0u; uiIndex < oExpEGraph -> uiSymbolTableSize; uiIndex++)
+    oExpEGraph -> piSymbolTable[uiIndex] = -1;
+  oExpEGraph -> uiNodeLimit = uiNodeLimit;
+  oExpEGraph -> dTimeLimit = dTimeLimit;
+  return oExpEGraph;
+}
+
+/*---------------------------------------------------------------------*/
+/*Make oExpEGraph stop saturating once oExpBudget is exhausted         */
+/*---------------------------------------------------------------------*/
+void ExpEGraph_setBudget(ExpEGraph_T oExpEGraph, ExpBudget_T oExpBudget){
+  assert(oExpEGraph != NULL);
+  oExpEGraph -> oExpBudget = oExpBudget;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpEGraph                               */
+/*---------------------------------------------------------------------*/
+void ExpEGraph_free(ExpEGraph_T oExpEGraph){
+  unsigned int uiIndex;
+  assert(oExpEGraph != NULL);
+  if(oExpEGraph -> ppcSymbols != NULL){
+    for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumSymbols; uiIndex++)
+      free(oExpEGraph -> ppcSymbols[uiIndex]);
+  }
+  free(oExpEGraph -> penNodes);
+  free(oExpEGraph -> piParent);
+  free(oExpEGraph -> piTable);
+  free(oExpEGraph -> ppcSymbols);
+  free(oExpEGraph -> piSymbolTable);
+  free(oExpEGraph -> piPending);
+  free(oExpEGraph -> piMemberStart);
+  free(oExpEGraph -> piMembers);
+  free(oExpEGraph -> pdCost);
+  free(oExpEGraph -> piBest);
+  free(oExpEGraph);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the representative of the class containing node iNode, halving*/
+/*the paths walked along the way                                       */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_find(ExpEGraph_T oExpEGraph, int iNode){
+  int* piParent;
+  assert(oExpEGraph != NULL);
+  assert(iNode >= 0 && (unsigned int)iNode < oExpEGraph -> uiNumNodes);
+  piParent = oExpEGraph -> piParent;
+  while(piParent[iNode] != iNode){
+    piParent[iNode] = piParent[piParent[iNode]];
+    iNode = piParent[iNode];
+  }
+  return iNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Merge the classes containing iNode1 and iNode2. The older class (the */
+/*one with the lower id) becomes the representative. Return 1 if two   */
+/*distinct classes were merged, 0 if they were already the same        */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_union(ExpEGraph_T oExpEGraph, int iNode1, int iNode2){
+  int iRoot1, iRoot2;
+  iRoot1 = ExpEGraph_find(oExpEGraph, iNode1);
+  iRoot2 = ExpEGraph_find(oExpEGraph, iNode2);
+  if(iRoot1 == iRoot2)
+    return 0;
+  if(iRoot1 < iRoot2)
+    oExpEGraph -> piParent[iRoot2] = iRoot1;
+  else
+    oExpEGraph -> piParent[iRoot1] = iRoot2;
+  oExpEGraph -> uiNumClasses--;
+  oExpEGraph -> iCostsValid = 0;
+  return 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a hash of the string pcName                                   */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpEGraph_hashString(const char* pcName){
+  unsigned int uiHash = 2166136261u;
+  for(; *pcName != '\0'; pcName++)
+    uiHash = (uiHash ^ (unsigned char)*pcName) * 16777619u;
+  return uiHash;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the index of the operand name pcName, adding it to the symbol */
+/*table if it is new. Return -1 if memory is insufficient              */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_intern(ExpEGraph_T oExpEGraph, const char* pcName){
+  unsigned int uiSlot, uiMask, uiIndex;
+  int* piNewTable;
+  char** ppcNewSymbols;
+  char* pcCopy;
+  uiMask = oExpEGraph -> uiSymbolTableSize - 1u;
+  for(uiSlot = ExpEGraph_hashString(pcName) & uiMask;
+      oExpEGraph -> piSymbolTable[uiSlot] != -1;
+      uiSlot = (uiSlot + 1u) & uiMask){
+    if(strcmp(oExpEGraph -> ppcSymbols\
+	      [oExpEGraph -> piSymbolTable[uiSlot]], pcName) == 0)
+      return oExpEGraph -> piSymbolTable[uiSlot];
+  }
+  //make room for the new name
+  if(oExpEGraph -> uiNumSymbols == oExpEGraph -> uiMaxSymbols){
+    ppcNewSymbols = (char**)realloc(oExpEGraph -> ppcSymbols,\
+				    2u * oExpEGraph -> uiMaxSymbols *\
+				    sizeof(char*));
+    if(ppcNewSymbols == NULL)
+      return -1;
+    oExpEGraph -> ppcSymbols = ppcNewSymbols;
+    oExpEGraph -> uiMaxSymbols *= 2u;
+    //grow the symbol hash table along with the names
+    piNewTable = (int*)malloc(2u * oExpEGraph -> uiMaxSymbols *\
+			      sizeof(int));
+    if(piNewTable == NULL)
+      return -1;
+    free(oExpEGraph -> piSymbolTable);
+    oExpEGraph -> piSymbolTable = piNewTable;
+    oExpEGraph -> uiSymbolTableSize = 2u * oExpEGraph -> uiMaxSymbols;
+    uiMask = oExpEGraph -> uiSymbolTableSize - 1u;
+    for(uiIndex = 0u; uiIndex < oExpEGraph -> uiSymbolTableSize; uiIndex++)
+      piNewTable[uiIndex] = -1;
+    for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumSymbols; uiIndex++){
+      for(uiSlot = ExpEGraph_hashString(oExpEGraph -> ppcSymbols[uiIndex])\
+	    & uiMask;
+	  piNewTable[uiSlot] != -1;
+	  uiSlot = (uiSlot + 1u) & uiMask);
+      piNewTable[uiSlot] = (int)uiIndex;
+    }
+    for(uiSlot = ExpEGraph_hashString(pcName) & uiMask;
+	piNewTable[uiSlot] != -1;
+	uiSlot = (uiSlot + 1u) & uiMask);
+  }
+  pcCopy = (char*)malloc(strlen(pcName) + 1u);
+  if(pcCopy == NULL)
+    return -1;
+  strcpy(pcCopy, pcName);
+  oExpEGraph -> ppcSymbols[oExpEGraph -> uiNumSymbols] = pcCopy;
+  oExpEGraph -> piSymbolTable[uiSlot] = (int)oExpEGraph -> uiNumSymbols;
+  oExpEGraph -> uiNumSymbols++;
+  return (int)oExpEGraph -> uiNumSymbols - 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a hash of the contents of penNode                             */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpEGraph_hashNode(const struct ENode* penNode){
+  unsigned int uiHash;
+  uiHash = (unsigned int)penNode -> ettType * 2654435761u;
+  uiHash = (uiHash ^ (unsigned int)(penNode -> iSymbol + 1)) * 2246822519u;
+  uiHash = (uiHash ^ (unsigned int)(penNode -> aiChild[0] + 1)) *\
+    3266489917u;
+  uiHash = (uiHash ^ (unsigned int)(penNode -> aiChild[1] + 1)) *\
+    668265263u;
+  return uiHash ^ (uiHash >> 15);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the contents of penNode1 and penNode2 are identical, 0 if*/
+/*not                                                                  */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_sameNode(const struct ENode* penNode1,\
+			      const struct ENode* penNode2){
+  return penNode1 -> ettType == penNode2 -> ettType &&\
+    penNode1 -> iSymbol == penNode2 -> iSymbol &&\
+    penNode1 -> aiChild[0] == penNode2 -> aiChild[0] &&\
+    penNode1 -> aiChild[1] == penNode2 -> aiChild[1];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the id of a live node with the same contents as penNode, or -1*/
+/*if there is none                                                     */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_lookup(ExpEGraph_T oExpEGraph,\
+			    const struct ENode* penNode){
+  unsigned int uiSlot, uiMask;
+  int iNode;
+  uiMask = oExpEGraph -> uiTableSize - 1u;
+  for(uiSlot = ExpEGraph_hashNode(penNode) & uiMask;
+      (iNode = oExpEGraph -> piTable[uiSlot]) != -1;
+      uiSlot = (uiSlot + 1u) & uiMask){
+    if(ExpEGraph_sameNode(&oExpEGraph -> penNodes[iNode], penNode))
+      return iNode;
+  }
+  return -1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store node iNode in the hash table. The table is always kept larger  */
+/*than the node array, so there is always room                         */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_insert(ExpEGraph_T oExpEGraph, int iNode){
+  unsigned int uiSlot, uiMask;
+  uiMask = oExpEGraph -> uiTableSize - 1u;
+  for(uiSlot = ExpEGraph_hashNode(&oExpEGraph -> penNodes[iNode]) & uiMask;
+      oExpEGraph -> piTable[uiSlot] != -1;
+      uiSlot = (uiSlot + 1u) & uiMask);
+  oExpEGraph -> piTable[uiSlot] = iNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Clear the hash table and reinsert every live node. Used after the    */
+/*table has been resized and after classes have been merged            */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_rehash(ExpEGraph_T oExpEGraph){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < oExpEGraph -> uiTableSize; uiIndex++)
+    oExpEGraph -> piTable[uiIndex] = -1;
+  for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumNodes; uiIndex++)
+    if(oExpEGraph -> penNodes[uiIndex].iDead == 0)
+      ExpEGraph_insert(oExpEGraph, (int)uiIndex);
+}
+
+/*---------------------------------------------------------------------*/
+/*Double the capacity of the node array and the hash table. Return 0 if*/
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_grow(ExpEGraph_T oExpEGraph){
+  struct ENode* penNewNodes;
+  int* piNewParent;
+  int* piNewTable;
+  unsigned int uiNewMax = 2u * oExpEGraph -> uiMaxNodes;
+  penNewNodes = (struct ENode*)realloc(oExpEGraph -> penNodes,\
+				       uiNewMax * sizeof(struct ENode));
+  if(penNewNodes == NULL)
+    return 1;
+  oExpEGraph -> penNodes = penNewNodes;
+  piNewParent = (int*)realloc(oExpEGraph -> piParent,\
+			      uiNewMax * sizeof(int));
+  if(piNewParent == NULL)
+    return 1;
+  oExpEGraph -> piParent = piNewParent;
+  piNewTable = (int*)malloc(2u * uiNewMax * sizeof(int));
+  if(piNewTable == NULL)
+    return 1;
+  free(oExpEGraph -> piTable);
+  oExpEGraph -> piTable = piNewTable;
+  oExpEGraph -> uiTableSize = 2u * uiNewMax;
+  oExpEGraph -> uiMaxNodes = uiNewMax;
+  ExpEGraph_rehash(oExpEGraph);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Put the children of penNode in canonical form: every child is        */
+/*replaced by the representative of its class, and the children of     */
+/*commutative operators are sorted                                     */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_canonicalize(ExpEGraph_T oExpEGraph,\
+				   struct ENode* penNode){
+  int iIndex, iSwap;
+  for(iIndex = 0; iIndex < 2; iIndex++)
+    if(penNode -> aiChild[iIndex] != -1)
+      penNode -> aiChild[iIndex] =\
+	ExpEGraph_find(oExpEGraph, penNode -> aiChild[iIndex]);
+  if((penNode -> ettType == ADD | penNode -> ettType == MULTIPLY) &&\
+     penNode -> aiChild[0] > penNode -> aiChild[1]){
+    iSwap = penNode -> aiChild[0];
+    penNode -> aiChild[0] = penNode -> aiChild[1];
+    penNode -> aiChild[1] = iSwap;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the class of the node with type ettType, symbol iSymbol and   */
+/*children iChild0 and iChild1, adding the node if it does not exist   */
+/*yet. Return -1 if memory is insufficient and -2 if the node is new   */
+/*but the node limit has been reached                                  */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_addNode(ExpEGraph_T oExpEGraph,\
+			     enum ExpTokenType ettType, int iSymbol,\
+			     int iChild0, int iChild1){
+  struct ENode enNode;
+  int iNode;
+  enNode.ettType = ettType;
+  enNode.iSymbol = iSymbol;
+  enNode.aiChild[0] = iChild0;
+  enNode.aiChild[1] = iChild1;
+  enNode.iDead = 0;
+  ExpEGraph_canonicalize(oExpEGraph, &enNode);
+  iNode = ExpEGraph_lookup(oExpEGraph, &enNode);
+  if(iNode != -1)
+    return ExpEGraph_find(oExpEGraph, iNode);
+  //respect the node limit while saturating
+  if(oExpEGraph -> uiNodeLimit != 0u &&\
+     oExpEGraph -> uiNumNodes >= oExpEGraph -> uiNodeLimit &&\
+     oExpEGraph -> iSaturating != 0){
+    oExpEGraph -> iStopped = 1;
+    return -2;
+  }
+  if(oExpEGraph -> uiNumNodes == oExpEGraph -> uiMaxNodes){
+    if(ExpEGraph_grow(oExpEGraph) != 0){
+      oExpEGraph -> iMemoryError = 1;
+      return -1;
+    }
+  }
+  iNode = (int)oExpEGraph -> uiNumNodes;
+  oExpEGraph -> penNodes[iNode] = enNode;
+  oExpEGraph -> piParent[iNode] = iNode;
+  oExpEGraph -> uiNumNodes++;
+  oExpEGraph -> uiNumClasses++;
+  oExpEGraph -> iCostsValid = 0;
+  ExpEGraph_insert(oExpEGraph, iNode);
+  return iNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the expression oTreeNode to oExpEGraph. Return the id of its     */
+/*class, or -1 if memory is insufficient                               */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_addTree(ExpEGraph_T oExpEGraph, TreeNode_T oTreeNode){
+  LinkList_T oLinkListChild;
+  ExpToken_T oExpToken;
+  int aiChild[2] = {-1, -1};
+  int iNumChildren = 0;
+  int iSymbol = -1;
+  assert(oExpEGraph != NULL);
+  assert(oTreeNode != NULL);
+  oExpToken = ExpTokenTree_getValue(oTreeNode);
+  //add the children first
+  for(oLinkListChild = ExpTokenTree_getChildren(oTreeNode);
+      oLinkListChild != NULL;
+      oLinkListChild = LinkList_getNext(oLinkListChild)){
+    assert(iNumChildren < 2);
+    aiChild[iNumChildren] =\
+      ExpEGraph_addTree(oExpEGraph,\
+			(TreeNode_T)LinkList_getValue(oLinkListChild));
+    if(aiChild[iNumChildren] < 0)
+      return -1;
+    iNumChildren++;
+  }
+  if(ExpToken_getType(oExpToken) == OPERAND){
+    iSymbol = ExpEGraph_intern(oExpEGraph, ExpToken_getName(oExpToken));
+    if(iSymbol == -1)
+      return -1;
+  }
+  return ExpEGraph_addNode(oExpEGraph, ExpToken_getType(oExpToken),\
+			   iSymbol, aiChild[0], aiChild[1]);
+}
+
+/*---------------------------------------------------------------------*/
+/*Record that the classes of iNode1 and iNode2 are equivalent. The     */
+/*merge happens at the end of the iteration. Negative ids, which signal*/
+/*that a right hand side could not be built, are ignored               */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_pend(ExpEGraph_T oExpEGraph, int iNode1, int iNode2){
+  int* piNewPending;
+  unsigned int uiNewMax;
+  if(iNode1 < 0 | iNode2 < 0)
+    return;
+  if(ExpEGraph_find(oExpEGraph, iNode1) == ExpEGraph_find(oExpEGraph, iNode2))
+    return;
+  if(oExpEGraph -> uiNumPending == oExpEGraph -> uiMaxPending){
+    uiNewMax = 2u * oExpEGraph -> uiMaxPending + 64u;
+    piNewPending = (int*)realloc(oExpEGraph -> piPending,\
+				 2u * uiNewMax * sizeof(int));
+    if(piNewPending == NULL){
+      oExpEGraph -> iMemoryError = 1;
+      return;
+    }
+    oExpEGraph -> piPending = piNewPending;
+    oExpEGraph -> uiMaxPending = uiNewMax;
+  }
+  oExpEGraph -> piPending[2u * oExpEGraph -> uiNumPending] = iNode1;
+  oExpEGraph -> piPending[2u * oExpEGraph -> uiNumPending + 1u] = iNode2;
+  oExpEGraph -> uiNumPending++;
+}
+
+/*---------------------------------------------------------------------*/
+/*Restore the hash cons invariant after classes have been merged. Every*/
+/*live node is canonicalized and rehashed; two nodes that now have the */
+/*same contents are congruent, so their classes are merged as well and */
+/*the duplicate is marked dead. Repeat until nothing changes           */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_rebuild(ExpEGraph_T oExpEGraph){
+  unsigned int uiIndex;
+  int iChanged, iMatch;
+  struct ENode* penNode;
+  do{
+    iChanged = 0;
+    for(uiIndex = 0u; uiIndex < oExpEGraph -> uiTableSize; uiIndex++)
+      oExpEGraph -> piTable[uiIndex] = -1;
+    for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumNodes; uiIndex++){
+      penNode = &oExpEGraph -> penNodes[uiIndex];
+      if(penNode -> iDead != 0)
+	continue;
+      ExpEGraph_canonicalize(oExpEGraph, penNode);
+      iMatch = ExpEGraph_lookup(oExpEGraph, penNode);
+      if(iMatch == -1)
+	ExpEGraph_insert(oExpEGraph, (int)uiIndex);
+      else{
+	iChanged |= ExpEGraph_union(oExpEGraph, iMatch, (int)uiIndex);
+	penNode -> iDead = 1;
+      }
+    }
+  } while(iChanged != 0);
+}
+
+/*---------------------------------------------------------------------*/
+/*Group the first uiSnapshot nodes by class so that rules can iterate  */
+/*over the members of a class. Return 0 if successful, 1 if memory is  */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_buildMembers(ExpEGraph_T oExpEGraph,\
+				  unsigned int uiSnapshot){
+  unsigned int uiIndex;
+  int* piFill;
+  int iClass;
+  free(oExpEGraph -> piMemberStart);
+  free(oExpEGraph -> piMembers);
+  oExpEGraph -> piMemberStart =\
+    (int*)calloc(uiSnapshot + 1u, sizeof(int));
+  oExpEGraph -> piMembers = (int*)malloc((uiSnapshot + 1u) * sizeof(int));
+  piFill = (int*)malloc((uiSnapshot + 1u) * sizeof(int));
+  if(oExpEGraph -> piMemberStart == NULL |\
+     oExpEGraph -> piMembers == NULL | piFill == NULL){
+    free(piFill);
+    return 1;
+  }
+  //count the members of every class
+  for(uiIndex = 0u; uiIndex < uiSnapshot; uiIndex++)
+    if(oExpEGraph -> penNodes[uiIndex].iDead == 0)
+      oExpEGraph -> piMemberStart\
+	[ExpEGraph_find(oExpEGraph, (int)uiIndex) + 1]++;
+  for(uiIndex = 0u; uiIndex < uiSnapshot; uiIndex++)
+    oExpEGraph -> piMemberStart[uiIndex + 1u] +=\
+      oExpEGraph -> piMemberStart[uiIndex];
+  //then place them
+  memcpy(piFill, oExpEGraph -> piMemberStart, uiSnapshot * sizeof(int));
+  for(uiIndex = 0u; uiIndex < uiSnapshot; uiIndex++){
+    if(oExpEGraph -> penNodes[uiIndex].iDead != 0)
+      continue;
+    iClass = ExpEGraph_find(oExpEGraph, (int)uiIndex);
+    oExpEGraph -> piMembers[piFill[iClass]++] = (int)uiIndex;
+  }
+  free(piFill);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Apply the rules that rewrite a sum or difference iNode = X op Y whose*/
+/*operands may have been negated or may share a factor. ettType is ADD */
+/*or SUBTRACT                                                          */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_ruleFactor(ExpEGraph_T oExpEGraph, int iNode,\
+				 enum ExpTokenType ettType,\
+				 int iLeft, int iRight){
+  int iMember1, iMember2, iIndex1, iIndex2, iInner, iNew;
+  int iShared, iRest1, iRest2;
+  struct ENode* penNode1;
+  struct ENode* penNode2;
+  //a*b op a*c = a*(b op c)
+  for(iMember1 = oExpEGraph -> piMemberStart[iLeft];
+      iMember1 < oExpEGraph -> piMemberStart[iLeft + 1];
+      iMember1++){
+    penNode1 = &oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember1]];
+    if(penNode1 -> ettType != MULTIPLY)
+      continue;
+    for(iMember2 = oExpEGraph -> piMemberStart[iRight];
+	iMember2 < oExpEGraph -> piMemberStart[iRight + 1];
+	iMember2++){
+      penNode2 =\
+	&oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember2]];
+      if(penNode2 -> ettType != MULTIPLY)
+	continue;
+      for(iIndex1 = 0; iIndex1 < 2; iIndex1++)
+	for(iIndex2 = 0; iIndex2 < 2; iIndex2++){
+	  if(penNode1 -> aiChild[iIndex1] != penNode2 -> aiChild[iIndex2])
+	    continue;
+	  //adding a node may move the node array, so read the children first
+	  iShared = penNode1 -> aiChild[iIndex1];
+	  iRest1 = penNode1 -> aiChild[1 - iIndex1];
+	  iRest2 = penNode2 -> aiChild[1 - iIndex2];
+	  iInner = ExpEGraph_addNode(oExpEGraph, ettType, -1, iRest1, iRest2);
+	  if(iInner < 0)
+	    return;
+	  iNew = ExpEGraph_addNode(oExpEGraph, MULTIPLY, -1, iShared, iInner);
+	  ExpEGraph_pend(oExpEGraph, iNode, iNew);
+	  penNode1 = &oExpEGraph -> penNodes\
+	    [oExpEGraph -> piMembers[iMember1]];
+	  penNode2 = &oExpEGraph -> penNodes\
+	    [oExpEGraph -> piMembers[iMember2]];
+	}
+    }
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Apply the associativity rule to iNode = X op Y where op is ADD or    */
+/*MULTIPLY: for every member (A op B) of class iInner, where iInner is */
+/*X or Y and iOther is the other operand, (A op B) op Z equals both (Z */
+/*op A) op B and (Z op B) op A                                         */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_ruleAssociate(ExpEGraph_T oExpEGraph, int iNode,\
+				    enum ExpTokenType ettType,\
+				    int iInner, int iOther){
+  int iMember, iChildA, iChildB, iPair, iNew;
+  for(iMember = oExpEGraph -> piMemberStart[iInner];
+      iMember < oExpEGraph -> piMemberStart[iInner + 1];
+      iMember++){
+    if(oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]].ettType\
+       != ettType)
+      continue;
+    iChildA =\
+      oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]].aiChild[0];
+    iChildB =\
+      oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]].aiChild[1];
+    iPair = ExpEGraph_addNode(oExpEGraph, ettType, -1, iOther, iChildA);
+    if(iPair < 0)
+      return;
+    iNew = ExpEGraph_addNode(oExpEGraph, ettType, -1, iPair, iChildB);
+    ExpEGraph_pend(oExpEGraph, iNode, iNew);
+    iPair = ExpEGraph_addNode(oExpEGraph, ettType, -1, iOther, iChildB);
+    if(iPair < 0)
+      return;
+    iNew = ExpEGraph_addNode(oExpEGraph, ettType, -1, iPair, iChildA);
+    ExpEGraph_pend(oExpEGraph, iNode, iNew);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Apply every rule whose left hand side is rooted at node iNode        */
+/*---------------------------------------------------------------------*/
+static void ExpEGraph_applyRules(ExpEGraph_T oExpEGraph, int iNode){
+  struct ENode enNode;
+  int iMember, iSide, iInner, iOther, iNew, iTemp, iChild1;
+  enum ExpTokenType ettInner;
+  struct ENode* penMember;
+  enNode = oExpEGraph -> penNodes[iNode];
+  switch(enNode.ettType)
+    {
+    case POSITIVE:
+      //+a = a
+      ExpEGraph_pend(oExpEGraph, iNode, enNode.aiChild[0]);
+      break;
+    case NEGATIVE:
+      for(iMember = oExpEGraph -> piMemberStart[enNode.aiChild[0]];
+	  iMember < oExpEGraph -> piMemberStart[enNode.aiChild[0] + 1];
+	  iMember++){
+	penMember =\
+	  &oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]];
+	//-(-a) = a
+	if(penMember -> ettType == NEGATIVE)
+	  ExpEGraph_pend(oExpEGraph, iNode, penMember -> aiChild[0]);
+	//-(a-b) = b-a
+	else if(penMember -> ettType == SUBTRACT){
+	  iNew = ExpEGraph_addNode(oExpEGraph, SUBTRACT, -1,\
+				   penMember -> aiChild[1],\
+				   penMember -> aiChild[0]);
+	  ExpEGraph_pend(oExpEGraph, iNode, iNew);
+	}
+      }
+      break;
+    case ADD:
+      for(iSide = 0; iSide < 2; iSide++){
+	iInner = enNode.aiChild[iSide];
+	iOther = enNode.aiChild[1 - iSide];
+	//a+(-b) = a-b
+	for(iMember = oExpEGraph -> piMemberStart[iInner];
+	    iMember < oExpEGraph -> piMemberStart[iInner + 1];
+	    iMember++){
+	  penMember =\
+	    &oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]];
+	  if(penMember -> ettType == NEGATIVE){
+	    iNew = ExpEGraph_addNode(oExpEGraph, SUBTRACT, -1, iOther,\
+				     penMember -> aiChild[0]);
+	    ExpEGraph_pend(oExpEGraph, iNode, iNew);
+	  }
+	}
+	ExpEGraph_ruleAssociate(oExpEGraph, iNode, ADD, iInner, iOther);
+      }
+      ExpEGraph_ruleFactor(oExpEGraph, iNode, ADD,\
+			   enNode.aiChild[0], enNode.aiChild[1]);
+      break;
+    case SUBTRACT:
+      //a-b = a+(-b)
+      iTemp = ExpEGraph_addNode(oExpEGraph, NEGATIVE, -1,\
+				enNode.aiChild[1], -1);
+      if(iTemp >= 0){
+	iNew = ExpEGraph_addNode(oExpEGraph, ADD, -1,\
+				 enNode.aiChild[0], iTemp);
+	ExpEGraph_pend(oExpEGraph, iNode, iNew);
+      }
+      //a-(-b) = a+b
+      for(iMember = oExpEGraph -> piMemberStart[enNode.aiChild[1]];
+	  iMember < oExpEGraph -> piMemberStart[enNode.aiChild[1] + 1];
+	  iMember++){
+	penMember =\
+	  &oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]];
+	if(penMember -> ettType == NEGATIVE){
+	  iNew = ExpEGraph_addNode(oExpEGraph, ADD, -1, enNode.aiChild[0],\
+				   penMember -> aiChild[0]);
+	  ExpEGraph_pend(oExpEGraph, iNode, iNew);
+	}
+      }
+      ExpEGraph_ruleFactor(oExpEGraph, iNode, SUBTRACT,\
+			   enNode.aiChild[0], enNode.aiChild[1]);
+      break;
+    case MULTIPLY:
+      for(iSide = 0; iSide < 2; iSide++){
+	iInner = enNode.aiChild[iSide];
+	iOther = enNode.aiChild[1 - iSide];
+	for(iMember = oExpEGraph -> piMemberStart[iInner];
+	    iMember < oExpEGraph -> piMemberStart[iInner + 1];
+	    iMember++){
+	  penMember =\
+	    &oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]];
+	  //(-a)*b = -(a*b)
+	  if(penMember -> ettType == NEGATIVE){
+	    iTemp = ExpEGraph_addNode(oExpEGraph, MULTIPLY, -1,\
+				      penMember -> aiChild[0], iOther);
+	    if(iTemp < 0)
+	      continue;
+	    iNew = ExpEGraph_addNode(oExpEGraph, NEGATIVE, -1, iTemp, -1);
+	    ExpEGraph_pend(oExpEGraph, iNode, iNew);
+	  }
+	  //(a op b)*c = a*c op b*c for op ADD or SUBTRACT
+	  else if(penMember -> ettType == ADD |\
+		  penMember -> ettType == SUBTRACT){
+	    ettInner = penMember -> ettType;
+	    iChild1 = penMember -> aiChild[1];
+	    iTemp = ExpEGraph_addNode(oExpEGraph, MULTIPLY, -1,\
+				      penMember -> aiChild[0], iOther);
+	    if(iTemp < 0)
+	      continue;
+	    iNew = ExpEGraph_addNode(oExpEGraph, MULTIPLY, -1, iChild1,\
+				     iOther);
+	    if(iNew < 0)
+	      continue;
+	    iNew = ExpEGraph_addNode(oExpEGraph, ettInner, -1, iTemp, iNew);
+	    ExpEGraph_pend(oExpEGraph, iNode, iNew);
+	  }
+	}
+	ExpEGraph_ruleAssociate(oExpEGraph, iNode, MULTIPLY, iInner, iOther);
+      }
+      break;
+    case DIVIDE:
+      //(-a)/b = a/(-b) = -(a/b)
+      for(iSide = 0; iSide < 2; iSide++){
+	iInner = enNode.aiChild[iSide];
+	for(iMember = oExpEGraph -> piMemberStart[iInner];
+	    iMember < oExpEGraph -> piMemberStart[iInner + 1];
+	    iMember++){
+	  penMember =\
+	    &oExpEGraph -> penNodes[oExpEGraph -> piMembers[iMember]];
+	  if(penMember -> ettType != NEGATIVE)
+	    continue;
+	  if(iSide == 0)
+	    iTemp = ExpEGraph_addNode(oExpEGraph, DIVIDE, -1,\
+				      penMember -> aiChild[0],\
+				      enNode.aiChild[1]);
+	  else
+	    iTemp = ExpEGraph_addNode(oExpEGraph, DIVIDE, -1,\
+				      enNode.aiChild[0],\
+				      penMember -> aiChild[0]);
+	  if(iTemp < 0)
+	    continue;
+	  iNew = ExpEGraph_addNode(oExpEGraph, NEGATIVE, -1, iTemp, -1);
+	  ExpEGraph_pend(oExpEGraph, iNode, iNew);
+	}
+      }
+      break;
+    default:
+      break;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the time limit of oExpEGraph has been exceeded or its    */
+/*budget is exhausted, 0 if not                                        */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_outOfTime(ExpEGraph_T oExpEGraph){
+  if(ExpBudget_isExhausted(oExpEGraph -> oExpBudget))
+    return 1;
+  if(oExpEGraph -> dTimeLimit <= 0.0)
+    return 0;
+  return (double)(clock() - oExpEGraph -> ctStart) / CLOCKS_PER_SEC >\
+    oExpEGraph -> dTimeLimit;
+}
+
+/*---------------------------------------------------------------------*/
+/*Apply the rewrite rules to oExpEGraph until saturation or until a    */
+/*limit is reached. Each iteration matches every rule against a        */
+/*snapshot of the graph, collecting the equalities it finds, and then  */
+/*merges them all and rebuilds. Return the number of iterations, or -1 */
+/*if memory is insufficient                                            */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_saturate(ExpEGraph_T oExpEGraph){
+  unsigned int uiSnapshot, uiIndex;
+  int iIterations = 0;
+  int iMerged;
+  assert(oExpEGraph != NULL);
+  oExpEGraph -> ctStart = clock();
+  oExpEGraph -> iSaturating = 1;
+  oExpEGraph -> iStopped = 0;
+  ExpEGraph_rebuild(oExpEGraph);
+  while(oExpEGraph -> iStopped == 0){
+    uiSnapshot = oExpEGraph -> uiNumNodes;
+    if(ExpEGraph_buildMembers(oExpEGraph, uiSnapshot) != 0){
+      oExpEGraph -> iMemoryError = 1;
+      break;
+    }
+    oExpEGraph -> uiNumPending = 0u;
+    for(uiIndex = 0u; uiIndex < uiSnapshot; uiIndex++){
+      if(oExpEGraph -> penNodes[uiIndex].iDead != 0)
+	continue;
+      ExpEGraph_applyRules(oExpEGraph, (int)uiIndex);
+      if(oExpEGraph -> iMemoryError != 0)
+	break;
+      if(uiIndex % CLOCK_INTERVAL == 0u && ExpEGraph_outOfTime(oExpEGraph))
+	oExpEGraph -> iStopped = 1;
+      if(oExpEGraph -> iStopped != 0)
+	break;
+    }
+    //merge everything found this iteration, even if it was cut short
+    iMerged = 0;
+    for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumPending; uiIndex++)
+      iMerged |= ExpEGraph_union(oExpEGraph,\
+				 oExpEGraph -> piPending[2u * uiIndex],\
+				 oExpEGraph -> piPending[2u * uiIndex + 1u]);
+    ExpEGraph_rebuild(oExpEGraph);
+    iIterations++;
+    if(oExpEGraph -> iMemoryError != 0)
+      break;
+    //saturated when an iteration neither adds nor merges anything
+    if(iMerged == 0 && oExpEGraph -> uiNumNodes == uiSnapshot)
+      break;
+  }
+  free(oExpEGraph -> piMemberStart);
+  free(oExpEGraph -> piMembers);
+  oExpEGraph -> piMemberStart = NULL;
+  oExpEGraph -> piMembers = NULL;
+  oExpEGraph -> iSaturating = 0;
+  if(oExpEGraph -> iMemoryError != 0)
+    return -1;
+  return iIterations;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the choices in piChoice, one node per class, form a cycle*/
+/*anywhere in oExpEGraph, 0 if they do not, and -1 if memory is        */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_hasCycle(ExpEGraph_T oExpEGraph, const int* piChoice){
+  unsigned char* pucColor;
+  int* piStack;
+  int* piNext;
+  unsigned int uiStart, uiDepth;
+  int iClass, iChild, iNode;
+  pucColor = (unsigned char*)calloc(oExpEGraph -> uiNumNodes, 1u);
+  piStack = (int*)malloc(oExpEGraph -> uiNumNodes * sizeof(int));
+  piNext = (int*)malloc(oExpEGraph -> uiNumNodes * sizeof(int));
+  if(pucColor == NULL | piStack == NULL | piNext == NULL){
+    free(pucColor);
+    free(piStack);
+    free(piNext);
+    return -1;
+  }
+  //iterative depth first search, color 1 is on the stack, 2 is done
+  for(uiStart = 0u; uiStart < oExpEGraph -> uiNumNodes; uiStart++){
+    if(piChoice[uiStart] == -1 || pucColor[uiStart] != 0)
+      continue;
+    uiDepth = 0u;
+    piStack[uiDepth] = (int)uiStart;
+    piNext[uiDepth] = 0;
+    pucColor[uiStart] = 1;
+    while(1){
+      iClass = piStack[uiDepth];
+      iNode = piChoice[iClass];
+      if(piNext[uiDepth] <\
+	 ExpEGraph_arity(oExpEGraph -> penNodes[iNode].ettType)){
+	iChild = ExpEGraph_find(oExpEGraph, oExpEGraph -> penNodes[iNode].\
+				aiChild[piNext[uiDepth]]);
+	piNext[uiDepth]++;
+	if(pucColor[iChild] == 1){
+	  free(pucColor);
+	  free(piStack);
+	  free(piNext);
+	  return 1;
+	}
+	if(pucColor[iChild] == 0){
+	  pucColor[iChild] = 1;
+	  uiDepth++;
+	  piStack[uiDepth] = iChild;
+	  piNext[uiDepth] = 0;
+	}
+      }
+      else{
+	pucColor[iClass] = 2;
+	if(uiDepth == 0u)
+	  break;
+	uiDepth--;
+      }
+    }
+  }
+  free(pucColor);
+  free(piStack);
+  free(piNext);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare two EPairs by class id for qsort                             */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_comparePairs(const void* pv1, const void* pv2){
+  int i1 = ((const struct EPair*)pv1) -> iClass;
+  int i2 = ((const struct EPair*)pv2) -> iClass;
+  return (i1 > i2) - (i1 < i2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Improve the tree cost choices in piBest so that they account for     */
+/*sharing. Every class keeps the set of classes its chosen DAG needs; a*/
+/*node is then charged for the union of the sets of its children, so a */
+/*subexpression used twice is only paid for once. The passes stop after*/
+/*SHARE_PASSES or once the budget is exhausted. The result replaces    */
+/*piBest only if it is acyclic. Return 0 if successful, 1 if memory is */
+/*insufficient (piBest is left as it was)                              */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_shareCosts(ExpEGraph_T oExpEGraph){
+  struct ECostSet* pecsSets;
+  struct ECostSet* pecsChild;
+  struct EPair* pepBuffer;
+  struct EPair* pepNew;
+  double* pdTotal;
+  int* piShared;
+  unsigned int uiNumNodes, uiIndex, uiMax, uiLength, uiUnique, uiScan;
+  int iChanged, iPass, iChild, iArity, iClass, iChildClass, iFailed, iCycle;
+  double dTotal;
+  struct ENode* penNode;
+  uiNumNodes = oExpEGraph -> uiNumNodes;
+  pecsSets = (struct ECostSet*)calloc(uiNumNodes, sizeof(struct ECostSet));
+  pdTotal = (double*)malloc(uiNumNodes * sizeof(double));
+  piShared = (int*)malloc(uiNumNodes * sizeof(int));
+  uiMax = 64u;
+  pepBuffer = (struct EPair*)malloc(uiMax * sizeof(struct EPair));
+  iFailed = (pecsSets == NULL | pdTotal == NULL | piShared == NULL |\
+	     pepBuffer == NULL);
+  for(uiIndex = 0u; iFailed == 0 && uiIndex < uiNumNodes; uiIndex++){
+    pdTotal[uiIndex] = -1.0;
+    piShared[uiIndex] = -1;
+  }
+  for(iPass = 0, iChanged = 1;
+      iFailed == 0 && iChanged != 0 && iPass < SHARE_PASSES &&\
+	ExpBudget_isExhausted(oExpEGraph -> oExpBudget) == 0;
+      iPass++){
+    iChanged = 0;
+    for(uiIndex = 0u; uiIndex < uiNumNodes && iFailed == 0; uiIndex++){
+      //every choice so far accounts for the sets it was made from
+      if(uiIndex % CLOCK_INTERVAL == 0u &&\
+	 ExpBudget_isExhausted(oExpEGraph -> oExpBudget))
+	break;
+      penNode = &oExpEGraph -> penNodes[uiIndex];
+      if(penNode -> iDead != 0)
+	continue;
+      iClass = ExpEGraph_find(oExpEGraph, (int)uiIndex);
+      iArity = ExpEGraph_arity(penNode -> ettType);
+      //gather the sets of the children, and the children themselves
+      uiLength = 0u;
+      for(iChild = 0; iChild < iArity; iChild++){
+	iChildClass = ExpEGraph_find(oExpEGraph, penNode -> aiChild[iChild]);
+	if(pdTotal[iChildClass] < 0.0)
+	  break;
+	pecsChild = &pecsSets[iChildClass];
+	if(uiLength + pecsChild -> uiLength + 1u > uiMax){
+	  uiMax = 2u * (uiLength + pecsChild -> uiLength + 1u);
+	  pepNew = (struct EPair*)realloc(pepBuffer,\
+					  uiMax * sizeof(struct EPair));
+	  if(pepNew == NULL){
+	    iFailed = 1;
+	    break;
+	  }
+	  pepBuffer = pepNew;
+	}
+	memcpy(pepBuffer + uiLength, pecsChild -> pepPairs,\
+	       pecsChild -> uiLength * sizeof(struct EPair));
+	uiLength += pecsChild -> uiLength;
+	pepBuffer[uiLength].iClass = iChildClass;
+	pepBuffer[uiLength].dCost = (double)ExpToken_typeCost\
+	  (oExpEGraph -> penNodes[piShared[iChildClass]].ettType);
+	uiLength++;
+      }
+      if(iChild < iArity)
+	continue;
+      //sort the union so that duplicates are adjacent, then drop them
+      qsort(pepBuffer, uiLength, sizeof(struct EPair),\
+	    ExpEGraph_comparePairs);
+      dTotal = (double)ExpToken_typeCost(penNode -> ettType);
+      uiUnique = 0u;
+      for(uiScan = 0u; uiScan < uiLength; uiScan++){
+	if(uiUnique > 0u &&\
+	   pepBuffer[uiScan].iClass == pepBuffer[uiUnique - 1u].iClass)
+	  continue;
+	//a node that needs its own class is part of a cycle
+	if(pepBuffer[uiScan].iClass == iClass)
+	  break;
+	dTotal += pepBuffer[uiScan].dCost;
+	pepBuffer[uiUnique++] = pepBuffer[uiScan];
+      }
+      if(uiScan < uiLength)
+	continue;
+      if(pdTotal[iClass] >= 0.0 && dTotal >= pdTotal[iClass])
+	continue;
+      //store the new set for this class
+      pepNew = (struct EPair*)malloc((uiUnique + 1u) *\
+				     sizeof(struct EPair));
+      if(pepNew == NULL){
+	iFailed = 1;
+	break;
+      }
+      memcpy(pepNew, pepBuffer, uiUnique * sizeof(struct EPair));
+      free(pecsSets[iClass].pepPairs);
+      pecsSets[iClass].pepPairs = pepNew;
+      pecsSets[iClass].uiLength = uiUnique;
+      pdTotal[iClass] = dTotal;
+      piShared[iClass] = (int)uiIndex;
+      iChanged = 1;
+    }
+  }
+  //only adopt the shared choices if they are complete and acyclic
+  iCycle = 1;
+  if(iFailed == 0)
+    iCycle = ExpEGraph_hasCycle(oExpEGraph, piShared);
+  if(iCycle == 0){
+    for(uiIndex = 0u; uiIndex < uiNumNodes; uiIndex++)
+      if(piShared[uiIndex] != -1)
+	oExpEGraph -> piBest[uiIndex] = piShared[uiIndex];
+  }
+  if(pecsSets != NULL){
+    for(uiIndex = 0u; uiIndex < uiNumNodes; uiIndex++)
+      free(pecsSets[uiIndex].pepPairs);
+  }
+  free(pecsSets);
+  free(pdTotal);
+  free(piShared);
+  free(pepBuffer);
+  return (iFailed != 0 || iCycle < 0) ? 1 : 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compute the cheapest cost of every class and the node that achieves  */
+/*it. Costs are relaxed repeatedly until they stop changing. Because   */
+/*every operator costs at least 1, a class is always cheaper than any  */
+/*class that contains it, so the choices never form a cycle. Return 0  */
+/*if successful, 1 if memory is insufficient                           */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_computeCosts(ExpEGraph_T oExpEGraph){
+  unsigned int uiIndex;
+  int iChanged, iChild, iClass, iArity;
+  double dCost, dChild;
+  struct ENode* penNode;
+  if(oExpEGraph -> iCostsValid != 0)
+    return 0;
+  free(oExpEGraph -> pdCost);
+  free(oExpEGraph -> piBest);
+  oExpEGraph -> pdCost =\
+    (double*)malloc(oExpEGraph -> uiNumNodes * sizeof(double));
+  oExpEGraph -> piBest =\
+    (int*)malloc(oExpEGraph -> uiNumNodes * sizeof(int));
+  if(oExpEGraph -> pdCost == NULL | oExpEGraph -> piBest == NULL)
+    return 1;
+  for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumNodes; uiIndex++){
+    oExpEGraph -> pdCost[uiIndex] = -1.0;
+    oExpEGraph -> piBest[uiIndex] = -1;
+  }
+  do{
+    iChanged = 0;
+    for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumNodes; uiIndex++){
+      penNode = &oExpEGraph -> penNodes[uiIndex];
+      if(penNode -> iDead != 0)
+	continue;
+      dCost = (double)ExpToken_typeCost(penNode -> ettType);
+      iArity = ExpEGraph_arity(penNode -> ettType);
+      for(iChild = 0; iChild < iArity; iChild++){
+	dChild = oExpEGraph -> pdCost\
+	  [ExpEGraph_find(oExpEGraph, penNode -> aiChild[iChild])];
+	if(dChild < 0.0)
+	  break;
+	dCost += dChild;
+      }
+      if(iChild < iArity)
+	continue;
+      iClass = ExpEGraph_find(oExpEGraph, (int)uiIndex);
+      if(oExpEGraph -> pdCost[iClass] < 0.0 ||\
+	 dCost < oExpEGraph -> pdCost[iClass]){
+	oExpEGraph -> pdCost[iClass] = dCost;
+	oExpEGraph -> piBest[iClass] = (int)uiIndex;
+	iChanged = 1;
+      }
+    }
+  } while(iChanged != 0);
+  //then account for sharing, keeping the tree choices on failure
+  ExpEGraph_shareCosts(oExpEGraph);
+  oExpEGraph -> iCostsValid = 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare two EPairs by cost, then by class id, for qsort              */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_compareCosts(const void* pv1, const void* pv2){
+  double d1 = ((const struct EPair*)pv1) -> dCost;
+  double d2 = ((const struct EPair*)pv2) -> dCost;
+  if(d1 != d2)
+    return (d1 > d2) - (d1 < d2);
+  return ExpEGraph_comparePairs(pv1, pv2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Mark in pucNeeded class iClass and every class the choices in        */
+/*piChoice need to compute it, stopping at classes already marked.     */
+/*Return the summed cost of the chosen nodes of the classes newly      */
+/*marked                                                               */
+/*---------------------------------------------------------------------*/
+static unsigned long ExpEGraph_mark(ExpEGraph_T oExpEGraph,\
+				    const int* piChoice,\
+				    unsigned char* pucNeeded, int iClass){
+  const struct ENode* penNode;
+  unsigned long ulCost;
+  int iChild;
+  iClass = ExpEGraph_find(oExpEGraph, iClass);
+  if(pucNeeded[iClass] != 0)
+    return 0ul;
+  pucNeeded[iClass] = 1;
+  assert(piChoice[iClass] != -1);
+  penNode = &oExpEGraph -> penNodes[piChoice[iClass]];
+  ulCost = (unsigned long)ExpToken_typeCost(penNode -> ettType);
+  for(iChild = 0; iChild < ExpEGraph_arity(penNode -> ettType); iChild++)
+    ulCost += ExpEGraph_mark(oExpEGraph, piChoice, pucNeeded,\
+			     penNode -> aiChild[iChild]);
+  return ulCost;
+}
+
+/*---------------------------------------------------------------------*/
+/*Choose the nodes of the uiRoots classes in piRoots together, so that */
+/*a class several of them need is paid for once. The roots are taken   */
+/*from the cheapest, and each is extracted by relaxing the tree costs  */
+/*with every class needed by the roots before it counted as free. The  */
+/*result replaces piBest only if it is acyclic and costs less over all */
+/*of the roots. Return 0 if successful, 1 if memory is insufficient    */
+/*(piBest is left as it was)                                           */
+/*---------------------------------------------------------------------*/
+static int ExpEGraph_shareRoots(ExpEGraph_T oExpEGraph, const int* piRoots,\
+				unsigned int uiRoots){
+  struct EPair* pepOrder;
+  unsigned char* pucFixed;
+  unsigned char* pucNeeded;
+  double* pdJoint;
+  int* piChoice;
+  unsigned long ulVisits = 0ul, ulBefore = 0ul, ulAfter = 0ul;
+  unsigned int uiNumNodes, uiIndex, uiRoot;
+  int iChanged = 0, iChild, iArity, iClass, iChildClass, iCycle;
+  double dCost, dChild;
+  const struct ENode* penNode;
+  uiNumNodes = oExpEGraph -> uiNumNodes;
+  pepOrder = (struct EPair*)malloc((uiRoots + 1u) * sizeof(struct EPair));
+  pucFixed = (unsigned char*)calloc(uiNumNodes, 1u);
+  pucNeeded = (unsigned char*)calloc(uiNumNodes, 1u);
+  pdJoint = (double*)malloc(uiNumNodes * sizeof(double));
+  piChoice = (int*)malloc(uiNumNodes * sizeof(int));
+  if(pepOrder == NULL | pucFixed == NULL | pucNeeded == NULL |\
+     pdJoint == NULL | piChoice == NULL){
+    free(pepOrder);
+    free(pucFixed);
+    free(pucNeeded);
+    free(pdJoint);
+    free(piChoice);
+    return 1;
+  }
+  for(uiIndex = 0u; uiIndex < uiNumNodes; uiIndex++){
+    pdJoint[uiIndex] = -1.0;
+    piChoice[uiIndex] = -1;
+  }
+  //a larger root may then be built from the smaller ones
+  for(uiRoot = 0u; uiRoot < uiRoots; uiRoot++){
+    pepOrder[uiRoot].iClass = ExpEGraph_find(oExpEGraph, piRoots[uiRoot]);
+    pepOrder[uiRoot].dCost = oExpEGraph -> pdCost[pepOrder[uiRoot].iClass];
+  }
+  qsort(pepOrder, uiRoots, sizeof(struct EPair), ExpEGraph_compareCosts);
+  for(uiRoot = 0u; uiRoot < uiRoots; uiRoot++){
+    //freeing classes only lowers costs, so the last ones are a start
+    do{
+      iChanged = 0;
+      ulVisits += uiNumNodes;
+      for(uiIndex = 0u; uiIndex < uiNumNodes; uiIndex++){
+	penNode = &oExpEGraph -> penNodes[uiIndex];
+	if(penNode -> iDead != 0)
+	  continue;
+	iClass = ExpEGraph_find(oExpEGraph, (int)uiIndex);
+	if(pucFixed[iClass] != 0)
+	  continue;
+	dCost = (double)ExpToken_typeCost(penNode -> ettType);
+	iArity = ExpEGraph_arity(penNode -> ettType);
+	for(iChild = 0; iChild < iArity; iChild++){
+	  iChildClass = ExpEGraph_find(oExpEGraph, penNode -> aiChild[iChild]);
+	  dChild = (pucFixed[iChildClass] != 0) ? 0.0 : pdJoint[iChildClass];
+	  if(dChild < 0.0)
+	    break;
+	  dCost += dChild;
+	}
+	if(iChild < iArity)
+	  continue;
+	if(pdJoint[iClass] < 0.0 || dCost < pdJoint[iClass]){
+	  pdJoint[iClass] = dCost;
+	  piChoice[iClass] = (int)uiIndex;
+	  iChanged = 1;
+	}
+      }
+    } while(iChanged != 0 && ulVisits < JOINT_VISITS &&\
+	    ExpBudget_isExhausted(oExpEGraph -> oExpBudget) == 0);
+    if(iChanged != 0)
+      break;
+    ExpEGraph_mark(oExpEGraph, piChoice, pucFixed, pepOrder[uiRoot].iClass);
+  }
+  //only the classes the roots need are compared and adopted
+  iCycle = 1;
+  if(uiRoot == uiRoots){
+    for(uiIndex = 0u; uiIndex < uiNumNodes; uiIndex++)
+      if(pucFixed[uiIndex] == 0)
+	piChoice[uiIndex] = -1;
+    iCycle = ExpEGraph_hasCycle(oExpEGraph, piChoice);
+  }
+  if(iCycle == 0){
+    for(uiRoot = 0u; uiRoot < uiRoots; uiRoot++)
+      ulBefore += ExpEGraph_mark(oExpEGraph, oExpEGraph -> piBest,\
+				 pucNeeded, piRoots[uiRoot]);
+    memset(pucNeeded, 0, uiNumNodes);
+    for(uiRoot = 0u; uiRoot < uiRoots; uiRoot++)
+      ulAfter += ExpEGraph_mark(oExpEGraph, piChoice, pucNeeded,\
+				piRoots[uiRoot]);
+    if(ulAfter < ulBefore)
+      for(uiIndex = 0u; uiIndex < uiNumNodes; uiIndex++)
+	if(piChoice[uiIndex] != -1)
+	  oExpEGraph -> piBest[uiIndex] = piChoice[uiIndex];
+  }
+  free(pepOrder);
+  free(pucFixed);
+  free(pucNeeded);
+  free(pdJoint);
+  free(piChoice);
+  return (iCycle < 0) ? 1 : 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree for the cheapest member of class iClass. Costs must*/
+/*already have been computed. Return NULL if memory is insufficient    */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpEGraph_build(ExpEGraph_T oExpEGraph, int iClass){
+  TreeNode_T oTreeNode, oTreeNodeChild;
+  ExpToken_T oExpToken;
+  struct ENode enNode;
+  const char* pcName;
+  int iChild;
+  iClass = ExpEGraph_find(oExpEGraph, iClass);
+  assert(oExpEGraph -> piBest[iClass] != -1);
+  enNode = oExpEGraph -> penNodes[oExpEGraph -> piBest[iClass]];
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return NULL;
+  ExpToken_setType(oExpToken, enNode.ettType);
+  if(enNode.ettType == OPERAND){
+    for(pcName = oExpEGraph -> ppcSymbols[enNode.iSymbol];
+	*pcName != '\0';
+	pcName++)
+      ExpToken_appendChar(oExpToken, *pcName);
+  }
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  for(iChild = 0; iChild < ExpEGraph_arity(enNode.ettType); iChild++){
+    oTreeNodeChild = ExpEGraph_build(oExpEGraph, enNode.aiChild[iChild]);
+    if(oTreeNodeChild == NULL){
+      ExpTokenTree_free(oTreeNode);
+      return NULL;
+    }
+    if(ExpTokenTree_addChild(oTreeNode, oTreeNodeChild) != 0){
+      ExpTokenTree_free(oTreeNodeChild);
+      ExpTokenTree_free(oTreeNode);
+      return NULL;
+    }
+  }
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree holding the cheapest expression in class iClass, or*/
+/*NULL if memory is insufficient                                       */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpEGraph_extract(ExpEGraph_T oExpEGraph, int iClass){
+  assert(oExpEGraph != NULL);
+  assert(iClass >= 0 && (unsigned int)iClass < oExpEGraph -> uiNumNodes);
+  if(ExpEGraph_computeCosts(oExpEGraph) != 0)
+    return NULL;
+  return ExpEGraph_build(oExpEGraph, iClass);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store a new tree holding the cheapest expression of every class in   */
+/*piClasses in ppTrees, choosing them together. On a memory failure    */
+/*free the trees built so far                                          */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_extractAll(ExpEGraph_T oExpEGraph, const int* piClasses,\
+			 unsigned int uiClasses, TreeNode_T* ppTrees){
+  unsigned int uiIndex;
+  assert(oExpEGraph != NULL);
+  assert(piClasses != NULL);
+  assert(ppTrees != NULL);
+  if(ExpEGraph_computeCosts(oExpEGraph) != 0)
+    return 1;
+  //on failure the classes are chosen one at a time
+  ExpEGraph_shareRoots(oExpEGraph, piClasses, uiClasses);
+  for(uiIndex = 0u; uiIndex < uiClasses; uiIndex++){
+    ppTrees[uiIndex] = ExpEGraph_build(oExpEGraph, piClasses[uiIndex]);
+    if(ppTrees[uiIndex] == NULL){
+      while(uiIndex-- > 0u)
+	ExpTokenTree_free(ppTrees[uiIndex]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the summed cost of every live node in oExpEGraph. Before      */
+/*saturation this is the cost of evaluating every added expression with*/
+/*all common subexpressions shared                                     */
+/*---------------------------------------------------------------------*/
+unsigned long ExpEGraph_totalCost(ExpEGraph_T oExpEGraph){
+  unsigned int uiIndex;
+  unsigned long ulCost = 0ul;
+  assert(oExpEGraph != NULL);
+  for(uiIndex = 0u; uiIndex < oExpEGraph -> uiNumNodes; uiIndex++)
+    if(oExpEGraph -> penNodes[uiIndex].iDead == 0)
+      ulCost += (unsigned long)\
+	ExpToken_typeCost(oExpEGraph -> penNodes[uiIndex].ettType);
+  return ulCost;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of nodes currently stored in oExpEGraph            */
+/*---------------------------------------------------------------------*/
+unsigned int ExpEGraph_numNodes(ExpEGraph_T oExpEGraph){
+  assert(oExpEGraph != NULL);
+  return oExpEGraph -> uiNumNodes;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return whether saturation stopped at a limit                         */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_stopped(ExpEGraph_T oExpEGraph){
+  assert(oExpEGraph != NULL);
+  return oExpEGraph -> iStopped;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of equivalence classes currently in oExpEGraph     */
+/*---------------------------------------------------------------------*/
+unsigned int ExpEGraph_numClasses(ExpEGraph_T oExpEGraph){
+  assert(oExpEGraph != NULL);
+  return oExpEGraph -> uiNumClasses;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expegraph.c                                                     */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  ExpEGraph_T oExpEGraph;
+  TreeNode_T ppTrees[3];
+  TreeNode_T ppExtracted[3];
+  TreeNode_T oTreeNode;
+  int piClasses[3];
+  int iIndex;
+
+  //[-c], [((1-c)-(x1-c))*(d*c+(-3))]: factoring a sum grows the node
+  //array while the factored products are still being read
+  ppTrees[0] = ExpTokenTree_newNode(NEGATIVE, ExpTokenTree_newLeaf("c"), NULL);
+  ppTrees[1] = ExpTokenTree_newNode(MULTIPLY,\
+				    ExpTokenTree_newNode(SUBTRACT,\
+				      ExpTokenTree_newNode(SUBTRACT,\
+					ExpTokenTree_newLeaf("1"),\
+					ExpTokenTree_newLeaf("c")),\
+				      ExpTokenTree_newNode(SUBTRACT,\
+					ExpTokenTree_newLeaf("x1"),\
+					ExpTokenTree_newLeaf("c"))),\
+				    ExpTokenTree_newNode(ADD,\
+				      ExpTokenTree_newNode(MULTIPLY,\
+					ExpTokenTree_newLeaf("d"),\
+					ExpTokenTree_newLeaf("c")),\
+				      ExpTokenTree_newNode(NEGATIVE,\
+					ExpTokenTree_newLeaf("3"), NULL)));
+  oExpEGraph = ExpEGraph_new(200000u, 10.0);
+  if(oExpEGraph == NULL)
+    printf("failed test 1\n");
+  for(iIndex = 0; iIndex < 2; iIndex++)
+    piClasses[iIndex] = ExpEGraph_addTree(oExpEGraph, ppTrees[iIndex]);
+  if(piClasses[0] < 0 || piClasses[1] < 0)
+    printf("failed test 2\n");
+  if(ExpEGraph_saturate(oExpEGraph) < 0)
+    printf("failed test 3\n");
+  for(iIndex = 0; iIndex < 2; iIndex++){
+    oTreeNode = ExpEGraph_extract(oExpEGraph, ExpEGraph_find\
+				  (oExpEGraph, piClasses[iIndex]));
+    if(oTreeNode == NULL)
+      printf("failed test 4\n");
+    ExpTokenTree_printBracketed(oTreeNode);
+    ExpOut_char('\n');
+    ExpTokenTree_free(oTreeNode);
+    ExpTokenTree_free(ppTrees[iIndex]);
+  }
+  ExpEGraph_free(oExpEGraph);
+
+  //[a*b*c], [c*b*a], [b*c]: chosen together, both products use b*c
+  ppTrees[0] = ExpTokenTree_newNode(MULTIPLY,\
+				    ExpTokenTree_newNode(MULTIPLY,\
+				      ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")),\
+				    ExpTokenTree_newLeaf("c"));
+  ppTrees[1] = ExpTokenTree_newNode(MULTIPLY,\
+				    ExpTokenTree_newNode(MULTIPLY,\
+				      ExpTokenTree_newLeaf("c"),\
+				      ExpTokenTree_newLeaf("b")),\
+				    ExpTokenTree_newLeaf("a"));
+  ppTrees[2] = ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("b"),\
+				    ExpTokenTree_newLeaf("c"));
+  oExpEGraph = ExpEGraph_new(200000u, 10.0);
+  for(iIndex = 0; iIndex < 3; iIndex++)
+    piClasses[iIndex] = ExpEGraph_addTree(oExpEGraph, ppTrees[iIndex]);
+  ExpEGraph_saturate(oExpEGraph);
+  for(iIndex = 0; iIndex < 3; iIndex++){
+    piClasses[iIndex] = ExpEGraph_find(oExpEGraph, piClasses[iIndex]);
+    ExpTokenTree_free(ppTrees[iIndex]);
+  }
+  if(ExpEGraph_extractAll(oExpEGraph, piClasses, 3u, ppExtracted) != 0)
+    printf("failed test 5\n");
+  //prints a*(b*c) twice, then b*c
+  for(iIndex = 0; iIndex < 3; iIndex++){
+    ExpTokenTree_printBracketed(ppExtracted[iIndex]);
+    ExpOut_char('\n');
+    ExpTokenTree_free(ppExtracted[iIndex]);
+  }
+  ExpOut_flush();
+  ExpEGraph_free(oExpEGraph);
+  return 0;
+}
+*/
@@ -0,0 +1,107 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expegraph.h describes an equality saturation engine (an e-graph) for */
+/*ExpTokenTrees. Expressions are added to the graph, rewritten with    */
+/*commutativity, associativity, distributivity and sign rules until no */
+/*rule applies or a node or time limit is reached, and then the        */
+/*cheapest equivalent expression is extracted under the operator cost  */
+/*model. Extraction is greedy rather than optimal: each class takes its*/
+/*cheapest node given the choices below it, so a graph cut off by its  */
+/*limits, or one where the best program shares a subexpression no      */
+/*single expression would choose, may extract no cheaper than it was   */
+/*added                                                                */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPEGRAPH_INCLUDED
+#define EXPEGRAPH_INCLUDED
+
+#include "treenode.h"
+#include "expbudget.h"
+
+/*---------------------------------------------------------------------*/
+/*An ExpEGraph stores equivalence classes of expressions               */
+/*---------------------------------------------------------------------*/
+typedef struct ExpEGraph* ExpEGraph_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpEGraph that will stop saturating once it holds*/
+/*uiNodeLimit nodes or has spent dTimeLimit seconds saturating. Return */
+/*NULL if memory is insufficient                                       */
+/*---------------------------------------------------------------------*/
+ExpEGraph_T ExpEGraph_new(unsigned int uiNodeLimit, double dTimeLimit);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpEGraph                               */
+/*---------------------------------------------------------------------*/
+void ExpEGraph_free(ExpEGraph_T oExpEGraph);
+
+/*---------------------------------------------------------------------*/
+/*Make oExpEGraph also stop saturating, and stop choosing expressions  */
+/*together, once oExpBudget is exhausted. oExpBudget is not owned by   */
+/*oExpEGraph and must outlive it                                       */
+/*---------------------------------------------------------------------*/
+void ExpEGraph_setBudget(ExpEGraph_T oExpEGraph, ExpBudget_T oExpBudget);
+
+/*---------------------------------------------------------------------*/
+/*Add the expression oTreeNode to oExpEGraph. Return the id of the     */
+/*equivalence class representing it, or -1 if memory is insufficient.  */
+/*Class ids are only meaningful until the next call to                 */
+/*ExpEGraph_saturate, after which ExpEGraph_find must be used          */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_addTree(ExpEGraph_T oExpEGraph, TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Return the current representative of the class iClass                */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_find(ExpEGraph_T oExpEGraph, int iClass);
+
+/*---------------------------------------------------------------------*/
+/*Apply the rewrite rules to oExpEGraph until no rule adds anything new*/
+/*or a limit is reached. Return the number of iterations performed, or */
+/*-1 if memory is insufficient. The graph remains valid either way     */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_saturate(ExpEGraph_T oExpEGraph);
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree holding the cheapest expression in class iClass    */
+/*under the operator cost model, or NULL if memory is insufficient     */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpEGraph_extract(ExpEGraph_T oExpEGraph, int iClass);
+
+/*---------------------------------------------------------------------*/
+/*Store in ppTrees, which holds uiClasses entries, a new tree for each */
+/*class in piClasses holding its cheapest expression. The expressions  */
+/*are chosen together, from the cheapest, so an expression is built    */
+/*from what the ones before it compute where that is cheaper over all  */
+/*of them than choosing each alone. The choice is still greedy: an     */
+/*earlier class is never changed to suit a later one. If the budget    */
+/*runs out first, each is chosen alone. Return 0 if successful, 1 if   */
+/*memory is insufficient, in which case no trees are stored            */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_extractAll(ExpEGraph_T oExpEGraph, const int* piClasses,\
+			 unsigned int uiClasses, TreeNode_T* ppTrees);
+
+/*---------------------------------------------------------------------*/
+/*Return the summed cost of every node in oExpEGraph. Before saturation*/
+/*this is the cost of evaluating every added expression with all common*/
+/*subexpressions shared                                                */
+/*---------------------------------------------------------------------*/
+unsigned long ExpEGraph_totalCost(ExpEGraph_T oExpEGraph);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of nodes currently stored in oExpEGraph            */
+/*---------------------------------------------------------------------*/
+unsigned int ExpEGraph_numNodes(ExpEGraph_T oExpEGraph);
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the last call to ExpEGraph_saturate on oExpEGraph stopped*/
+/*at a limit before the graph was saturated, 0 if not                  */
+/*---------------------------------------------------------------------*/
+int ExpEGraph_stopped(ExpEGraph_T oExpEGraph);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of equivalence classes currently in oExpEGraph     */
+/*---------------------------------------------------------------------*/
+unsigned int ExpEGraph_numClasses(ExpEGraph_T oExpEGraph);
+
+#endif
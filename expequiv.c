@@ -0,0 +1,534 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expequiv.c implements expequiv.h. Explicit classes are kept in a     */
+/*union-find whose roots are always the smallest name of their class.  */
+/*Patterns are kept as written and matched against each name on demand.*/
+/*Both only ever replace a name by a smaller one, so following them    */
+/*until nothing changes always ends, at the representative             */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expequiv.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of the arrays of an ExpEquiv, the longest*/
+/*form or name handled, and the most placeholders a pattern may have   */
+/*---------------------------------------------------------------------*/
+#define INITIAL_EQUIV 16u
+#define MAX_FORM 64u
+#define MAX_PLACEHOLDERS 8u
+
+/*---------------------------------------------------------------------*/
+/*An EquivName is a name in the union-find, with the index of its      */
+/*parent                                                               */
+/*---------------------------------------------------------------------*/
+struct EquivName
+{
+  /*the operand name*/
+  char* pcName;
+  /*index of the parent, or of the name itself if it is a root*/
+  unsigned int uiParent;
+};
+
+/*---------------------------------------------------------------------*/
+/*An EquivMatch holds the digits bound to each placeholder when a      */
+/*pattern form matches a name                                          */
+/*---------------------------------------------------------------------*/
+struct EquivMatch
+{
+  /*placeholder names*/
+  char ppcPlaceholders[MAX_PLACEHOLDERS][MAX_FORM];
+  /*the digits each placeholder matched*/
+  char ppcValues[MAX_PLACEHOLDERS][MAX_FORM];
+  /*number of placeholders bound*/
+  unsigned int uiLength;
+};
+
+/*---------------------------------------------------------------------*/
+/*An ExpEquiv holds the union-find of explicitly equivalent names and  */
+/*the declarations that are patterns                                   */
+/*---------------------------------------------------------------------*/
+struct ExpEquiv
+{
+  /*the names declared in explicit classes*/
+  struct EquivName* pnNames;
+  unsigned int uiNames;
+  unsigned int uiMaxNames;
+  /*the pattern declarations, each stored as written*/
+  char** ppcPatterns;
+  unsigned int uiPatterns;
+  unsigned int uiMaxPatterns;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpEquiv                                         */
+/*---------------------------------------------------------------------*/
+ExpEquiv_T ExpEquiv_new(void){
+  ExpEquiv_T oExpEquiv = (ExpEquiv_T)malloc(sizeof(struct ExpEquiv));
+  if(oExpEquiv == NULL)
+    return NULL;
+  oExpEquiv -> pnNames = (struct EquivName*)\
+    malloc(INITIAL_EQUIV * sizeof(struct EquivName));
+  oExpEquiv -> ppcPatterns = (char**)malloc(INITIAL_EQUIV * sizeof(char*));
+  if(oExpEquiv -> pnNames == NULL || oExpEquiv -> ppcPatterns == NULL){
+    free(oExpEquiv -> pnNames);
+    free(oExpEquiv -> ppcPatterns);
+    free(oExpEquiv);
+    return NULL;
+  }
+  oExpEquiv -> uiNames = 0u;
+  oExpEquiv -> uiMaxNames = INITIAL_EQUIV;
+  oExpEquiv -> uiPatterns = 0u;
+  oExpEquiv -> uiMaxPatterns = INITIAL_EQUIV;
+  return oExpEquiv;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpEquiv                                                       */
+/*---------------------------------------------------------------------*/
+void ExpEquiv_free(ExpEquiv_T oExpEquiv){
+  unsigned int uiIndex;
+  assert(oExpEquiv != NULL);
+  for(uiIndex = 0u; uiIndex < oExpEquiv -> uiNames; uiIndex++)
+    free(oExpEquiv -> pnNames[uiIndex].pcName);
+  for(uiIndex = 0u; uiIndex < oExpEquiv -> uiPatterns; uiIndex++)
+    free(oExpEquiv -> ppcPatterns[uiIndex]);
+  free(oExpEquiv -> pnNames);
+  free(oExpEquiv -> ppcPatterns);
+  free(oExpEquiv);
+}
+
+/*---------------------------------------------------------------------*/
+/*Copy form number uiIndex of pcSpec, counting from 0, into pcForm,    */
+/*which holds MAX_FORM chars. Return 0 if successful, -1 if pcSpec has */
+/*no such form or it is empty or too long                              */
+/*---------------------------------------------------------------------*/
+static int ExpEquiv_form(const char* pcSpec, unsigned int uiIndex,\
+			 char* pcForm){
+  const char* pcEnd;
+  for(; uiIndex > 0u; uiIndex--){
+    pcSpec = strchr(pcSpec, '=');
+    if(pcSpec == NULL)
+      return -1;
+    pcSpec++;
+  }
+  pcEnd = strchr(pcSpec, '=');
+  if(pcEnd == NULL)
+    pcEnd = pcSpec + strlen(pcSpec);
+  if(pcEnd == pcSpec || (unsigned int)(pcEnd - pcSpec) >= MAX_FORM)
+    return -1;
+  memcpy(pcForm, pcSpec, (size_t)(pcEnd - pcSpec));
+  pcForm[pcEnd - pcSpec] = '\0';
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the index of the placeholder pcPlaceholder in poMatch, or     */
+/*uiLength if it is not bound                                          */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpEquiv_placeholder(struct EquivMatch* poMatch,\
+					 const char* pcPlaceholder){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < poMatch -> uiLength; uiIndex++)
+    if(strcmp(poMatch -> ppcPlaceholders[uiIndex], pcPlaceholder) == 0)
+      break;
+  return uiIndex;
+}
+
+/*---------------------------------------------------------------------*/
+/*Match the pattern form pcForm against pcName, storing the digits each*/
+/*placeholder stands for in *poMatch. Return 1 if pcName matches, 0 if */
+/*not. A placeholder used twice must match the same digits both times  */
+/*---------------------------------------------------------------------*/
+static int ExpEquiv_match(const char* pcForm, const char* pcName,\
+			  struct EquivMatch* poMatch){
+  char pcPlaceholder[MAX_FORM], pcValue[MAX_FORM];
+  unsigned int uiLength, uiIndex;
+  poMatch -> uiLength = 0u;
+  while(*pcForm != '\0'){
+    if(*pcForm != '{'){
+      if(*pcForm != *pcName)
+	return 0;
+      pcForm++;
+      pcName++;
+      continue;
+    }
+    //read the placeholder name
+    for(pcForm++, uiLength = 0u; *pcForm != '}'; pcForm++)
+      pcPlaceholder[uiLength++] = *pcForm;
+    pcPlaceholder[uiLength] = '\0';
+    pcForm++;
+    //a placeholder matches every digit that follows
+    for(uiLength = 0u; *pcName >= '0' && *pcName <= '9'; pcName++)
+      if(uiLength + 1u < MAX_FORM)
+	pcValue[uiLength++] = *pcName;
+    pcValue[uiLength] = '\0';
+    if(uiLength == 0u)
+      return 0;
+    uiIndex = ExpEquiv_placeholder(poMatch, pcPlaceholder);
+    if(uiIndex < poMatch -> uiLength){
+      if(strcmp(poMatch -> ppcValues[uiIndex], pcValue) != 0)
+	return 0;
+      continue;
+    }
+    if(uiIndex == MAX_PLACEHOLDERS)
+      return 0;
+    strcpy(poMatch -> ppcPlaceholders[uiIndex], pcPlaceholder);
+    strcpy(poMatch -> ppcValues[uiIndex], pcValue);
+    poMatch -> uiLength++;
+  }
+  return *pcName == '\0';
+}
+
+/*---------------------------------------------------------------------*/
+/*Write pcForm, with every placeholder replaced by its digits in       */
+/**poMatch, to pcName, which holds MAX_FORM chars. Return 0 if         */
+/*successful, -1 if the result is too long                             */
+/*---------------------------------------------------------------------*/
+static int ExpEquiv_instantiate(const char* pcForm,\
+				struct EquivMatch* poMatch, char* pcName){
+  char pcPlaceholder[MAX_FORM];
+  const char* pcValue;
+  unsigned int uiLength = 0u, uiPlaceholder, uiIndex;
+  while(*pcForm != '\0'){
+    if(*pcForm != '{'){
+      pcValue = pcForm;
+      uiPlaceholder = 1u;
+      pcForm++;
+    }
+    else{
+      for(pcForm++, uiIndex = 0u; *pcForm != '}'; pcForm++)
+	pcPlaceholder[uiIndex++] = *pcForm;
+      pcPlaceholder[uiIndex] = '\0';
+      pcForm++;
+      uiIndex = ExpEquiv_placeholder(poMatch, pcPlaceholder);
+      assert(uiIndex < poMatch -> uiLength);
+      pcValue = poMatch -> ppcValues[uiIndex];
+      uiPlaceholder = (unsigned int)strlen(pcValue);
+    }
+    if(uiLength + uiPlaceholder >= MAX_FORM)
+      return -1;
+    memcpy(pcName + uiLength, pcValue, uiPlaceholder);
+    uiLength += uiPlaceholder;
+  }
+  pcName[uiLength] = '\0';
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Check the syntax of the form pcForm and store its placeholders in    */
+/**poMatch, with empty values. Return the number of placeholders, or -1*/
+/*if pcForm is malformed                                               */
+/*---------------------------------------------------------------------*/
+static int ExpEquiv_placeholders(const char* pcForm,\
+				 struct EquivMatch* poMatch){
+  char pcPlaceholder[MAX_FORM];
+  unsigned int uiLength, uiIndex;
+  poMatch -> uiLength = 0u;
+  while(*pcForm != '\0'){
+    if(*pcForm == '}')
+      return -1;
+    if(*pcForm++ != '{')
+      continue;
+    for(uiLength = 0u; *pcForm != '}'; pcForm++){
+      if(*pcForm == '\0' || *pcForm == '{')
+	return -1;
+      pcPlaceholder[uiLength++] = *pcForm;
+    }
+    pcPlaceholder[uiLength] = '\0';
+    pcForm++;
+    //the end of the digits must be unambiguous
+    if(uiLength == 0u || *pcForm == '{' || (*pcForm >= '0' && *pcForm <= '9'))
+      return -1;
+    uiIndex = ExpEquiv_placeholder(poMatch, pcPlaceholder);
+    if(uiIndex == MAX_PLACEHOLDERS)
+      return -1;
+    if(uiIndex == poMatch -> uiLength){
+      strcpy(poMatch -> ppcPlaceholders[uiIndex], pcPlaceholder);
+      poMatch -> ppcValues[uiIndex][0] = '\0';
+      poMatch -> uiLength++;
+    }
+  }
+  return (int)poMatch -> uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the index of the root of the class of name uiIndex            */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpEquiv_root(ExpEquiv_T oExpEquiv,\
+				  unsigned int uiIndex){
+  while(oExpEquiv -> pnNames[uiIndex].uiParent != uiIndex){
+    //halve the path on the way up
+    oExpEquiv -> pnNames[uiIndex].uiParent =\
+      oExpEquiv -> pnNames[oExpEquiv -> pnNames[uiIndex].uiParent].uiParent;
+    uiIndex = oExpEquiv -> pnNames[uiIndex].uiParent;
+  }
+  return uiIndex;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the index of pcName in the union-find of oExpEquiv, or uiNames*/
+/*if it is not there                                                   */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpEquiv_find(ExpEquiv_T oExpEquiv,\
+				  const char* pcName){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < oExpEquiv -> uiNames; uiIndex++)
+    if(strcmp(oExpEquiv -> pnNames[uiIndex].pcName, pcName) == 0)
+      break;
+  return uiIndex;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in *puiIndex the index of pcName in the union-find of          */
+/*oExpEquiv, adding it as a class of its own if it is not there. Return*/
+/*0 if successful, 1 if memory is insufficient                         */
+/*---------------------------------------------------------------------*/
+static int ExpEquiv_insert(ExpEquiv_T oExpEquiv, const char* pcName,\
+			   unsigned int* puiIndex){
+  struct EquivName* pnNames;
+  char* pcCopy;
+  *puiIndex = ExpEquiv_find(oExpEquiv, pcName);
+  if(*puiIndex < oExpEquiv -> uiNames)
+    return 0;
+  if(oExpEquiv -> uiNames == oExpEquiv -> uiMaxNames){
+    pnNames = (struct EquivName*)\
+      realloc(oExpEquiv -> pnNames,\
+	      2u * oExpEquiv -> uiMaxNames * sizeof(struct EquivName));
+    if(pnNames == NULL)
+      return 1;
+    oExpEquiv -> pnNames = pnNames;
+    oExpEquiv -> uiMaxNames *= 2u;
+  }
+  pcCopy = (char*)malloc(strlen(pcName) + 1u);
+  if(pcCopy == NULL)
+    return 1;
+  strcpy(pcCopy, pcName);
+  oExpEquiv -> pnNames[*puiIndex].pcName = pcCopy;
+  oExpEquiv -> pnNames[*puiIndex].uiParent = *puiIndex;
+  oExpEquiv -> uiNames++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the pattern declaration pcSpec to oExpEquiv. Return 0 if         */
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpEquiv_addPattern(ExpEquiv_T oExpEquiv, const char* pcSpec){
+  char** ppcPatterns;
+  char* pcCopy;
+  if(oExpEquiv -> uiPatterns == oExpEquiv -> uiMaxPatterns){
+    ppcPatterns = (char**)realloc(oExpEquiv -> ppcPatterns,\
+				  2u * oExpEquiv -> uiMaxPatterns *\
+				  sizeof(char*));
+    if(ppcPatterns == NULL)
+      return 1;
+    oExpEquiv -> ppcPatterns = ppcPatterns;
+    oExpEquiv -> uiMaxPatterns *= 2u;
+  }
+  pcCopy = (char*)malloc(strlen(pcSpec) + 1u);
+  if(pcCopy == NULL)
+    return 1;
+  strcpy(pcCopy, pcSpec);
+  oExpEquiv -> ppcPatterns[oExpEquiv -> uiPatterns++] = pcCopy;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the declaration pcSpec to oExpEquiv                              */
+/*---------------------------------------------------------------------*/
+int ExpEquiv_add(ExpEquiv_T oExpEquiv, const char* pcSpec){
+  char pcForm[MAX_FORM];
+  struct EquivMatch mFirst, mOther;
+  unsigned int uiForm, uiIndex, uiRoot, uiOther;
+  int iPlaceholders, iFirst = 0;
+  assert(oExpEquiv != NULL);
+  assert(pcSpec != NULL);
+  //check every form, and that the forms agree on their placeholders
+  for(uiForm = 0u; ExpEquiv_form(pcSpec, uiForm, pcForm) == 0; uiForm++){
+    iPlaceholders = ExpEquiv_placeholders(pcForm, &mOther);
+    if(uiForm == 0u){
+      iFirst = iPlaceholders;
+      mFirst = mOther;
+    }
+    if(iPlaceholders != iFirst || iPlaceholders < 0)
+      break;
+    for(uiIndex = 0u; uiIndex < mOther.uiLength; uiIndex++)
+      if(ExpEquiv_placeholder(&mFirst, mOther.ppcPlaceholders[uiIndex]) ==\
+	 mFirst.uiLength)
+	break;
+    if(uiIndex < mOther.uiLength)
+      break;
+  }
+  //a valid declaration has at least two forms and nothing left over
+  if(uiForm < 2u || ExpEquiv_form(pcSpec, uiForm, pcForm) == 0 ||\
+     strstr(pcSpec, "==") != NULL || pcSpec[strlen(pcSpec) - 1u] == '='){
+    fprintf(stderr, "ExpEquiv_add: bad declaration '%s'\n", pcSpec);
+    return -1;
+  }
+  if(iFirst > 0)
+    return ExpEquiv_addPattern(oExpEquiv, pcSpec);
+  //union every name with the first, keeping the smallest as the root
+  ExpEquiv_form(pcSpec, 0u, pcForm);
+  if(ExpEquiv_insert(oExpEquiv, pcForm, &uiRoot) != 0)
+    return 1;
+  for(uiForm = 1u; ExpEquiv_form(pcSpec, uiForm, pcForm) == 0; uiForm++){
+    if(ExpEquiv_insert(oExpEquiv, pcForm, &uiOther) != 0)
+      return 1;
+    uiRoot = ExpEquiv_root(oExpEquiv, uiRoot);
+    uiOther = ExpEquiv_root(oExpEquiv, uiOther);
+    if(uiRoot == uiOther)
+      continue;
+    if(strcmp(oExpEquiv -> pnNames[uiOther].pcName,\
+	      oExpEquiv -> pnNames[uiRoot].pcName) < 0){
+      uiIndex = uiRoot;
+      uiRoot = uiOther;
+      uiOther = uiIndex;
+    }
+    oExpEquiv -> pnNames[uiOther].uiParent = uiRoot;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace pcName, which holds MAX_FORM chars, by the smallest name one */
+/*declaration makes it equivalent to. Return 1 if pcName changed, 0 if */
+/*not                                                                  */
+/*---------------------------------------------------------------------*/
+static int ExpEquiv_step(ExpEquiv_T oExpEquiv, char* pcName){
+  char pcForm[MAX_FORM], pcOther[MAX_FORM];
+  struct EquivMatch mMatch;
+  unsigned int uiPattern, uiForm, uiOther, uiIndex;
+  int iChanged = 0;
+  uiIndex = ExpEquiv_find(oExpEquiv, pcName);
+  if(uiIndex < oExpEquiv -> uiNames){
+    uiIndex = ExpEquiv_root(oExpEquiv, uiIndex);
+    if(strcmp(oExpEquiv -> pnNames[uiIndex].pcName, pcName) < 0){
+      strcpy(pcName, oExpEquiv -> pnNames[uiIndex].pcName);
+      iChanged = 1;
+    }
+  }
+  for(uiPattern = 0u; uiPattern < oExpEquiv -> uiPatterns; uiPattern++)
+    for(uiForm = 0u; ExpEquiv_form(oExpEquiv -> ppcPatterns[uiPattern],\
+				   uiForm, pcForm) == 0; uiForm++){
+      if(ExpEquiv_match(pcForm, pcName, &mMatch) == 0)
+	continue;
+      for(uiOther = 0u;\
+	    ExpEquiv_form(oExpEquiv -> ppcPatterns[uiPattern],\
+			  uiOther, pcForm) == 0; uiOther++)
+	if(ExpEquiv_instantiate(pcForm, &mMatch, pcOther) == 0 &&\
+	   strlen(pcOther) <= ExpToken_maxChars() &&\
+	   strcmp(pcOther, pcName) < 0){
+	  strcpy(pcName, pcOther);
+	  iChanged = 1;
+	}
+      break;
+    }
+  return iChanged;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the representative of pcName in pcRepresentative               */
+/*---------------------------------------------------------------------*/
+void ExpEquiv_representative(ExpEquiv_T oExpEquiv, const char* pcName,\
+			     char* pcRepresentative, unsigned int uiSize){
+  char pcCurrent[MAX_FORM];
+  assert(oExpEquiv != NULL);
+  assert(pcName != NULL);
+  assert(pcRepresentative != NULL);
+  if(strlen(pcName) < MAX_FORM){
+    strcpy(pcCurrent, pcName);
+    //every step makes the name smaller, so this ends
+    while(ExpEquiv_step(oExpEquiv, pcCurrent) != 0);
+    pcName = pcCurrent;
+  }
+  if(strlen(pcName) >= uiSize)
+    pcName = "";
+  strcpy(pcRepresentative, pcName);
+}
+
+/*---------------------------------------------------------------------*/
+/*Rename the operands of oTreeNode, adding the number renamed to       */
+/**puiRenamed                                                          */
+/*---------------------------------------------------------------------*/
+static void ExpEquiv_rename(ExpEquiv_T oExpEquiv, TreeNode_T oTreeNode,\
+			    unsigned int* puiRenamed){
+  char pcRepresentative[MAX_FORM];
+  ExpToken_T oExpToken;
+  LinkList_T oLinkList;
+  oExpToken = ExpTokenTree_getValue(oTreeNode);
+  if(ExpToken_getType(oExpToken) != OPERAND){
+    for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+	oLinkList != NULL;
+	oLinkList = LinkList_getNext(oLinkList))
+      ExpEquiv_rename(oExpEquiv, (TreeNode_T)LinkList_getValue(oLinkList),\
+		      puiRenamed);
+    return;
+  }
+  ExpEquiv_representative(oExpEquiv, ExpToken_getName(oExpToken),\
+			  pcRepresentative, sizeof(pcRepresentative));
+  //a representative is never longer than the name it replaces allows
+  if(strcmp(pcRepresentative, ExpToken_getName(oExpToken)) == 0 ||\
+     strlen(pcRepresentative) > ExpToken_maxChars())
+    return;
+  strcpy(ExpToken_getName(oExpToken), pcRepresentative);
+  (*puiRenamed)++;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rename every operand in the trees stored in pllTrees                 */
+/*---------------------------------------------------------------------*/
+void ExpEquiv_apply(ExpEquiv_T oExpEquiv, LinkList_T pllTrees,\
+		    unsigned int* puiRenamed){
+  LinkList_T oLinkList;
+  unsigned int uiRenamed = 0u;
+  assert(oExpEquiv != NULL);
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(LinkList_getValue(oLinkList) != NULL)
+      ExpEquiv_rename(oExpEquiv, (TreeNode_T)LinkList_getValue(oLinkList),\
+		      &uiRenamed);
+  if(puiRenamed != NULL)
+    *puiRenamed = uiRenamed;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expequiv.c                                                      */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  ExpEquiv_T oExpEquiv;
+  char pcName[MAX_FORM];
+
+  oExpEquiv = ExpEquiv_new();
+  if(oExpEquiv == NULL)
+    printf("failed test 1\n");
+  if(ExpEquiv_add(oExpEquiv, "a{i}_{j}=a{j}_{i}") != 0)
+    printf("failed test 2\n");
+  ExpEquiv_representative(oExpEquiv, "a2_1", pcName, MAX_FORM);
+  if(strcmp(pcName, "a1_2") != 0)
+    printf("failed test 3\n");
+  if(ExpEquiv_add(oExpEquiv, "z=y=a1_2") != 0)
+    printf("failed test 4\n");
+  ExpEquiv_representative(oExpEquiv, "z", pcName, MAX_FORM);
+  if(strcmp(pcName, "a1_2") != 0)
+    printf("failed test 5\n");
+  ExpEquiv_representative(oExpEquiv, "a3_3", pcName, MAX_FORM);
+  if(strcmp(pcName, "a3_3") != 0)
+    printf("failed test 6\n");
+  if(ExpEquiv_add(oExpEquiv, "a{i}{j}=a{j}{i}") != -1)
+    printf("failed test 7\n");
+  if(ExpEquiv_add(oExpEquiv, "a{i}_{j}=b{i}") != -1)
+    printf("failed test 8\n");
+  if(ExpEquiv_add(oExpEquiv, "x") != -1)
+    printf("failed test 9\n");
+  ExpEquiv_free(oExpEquiv);
+  return 0;
+}
+*/
@@ -0,0 +1,61 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expequiv.h describes declarations that distinct operand names hold   */
+/*the same value, ex. a1_2 and a2_1 of a symmetric matrix. Every       */
+/*operand is renamed to one representative of its class, so that       */
+/*mirrored subexpressions become identical and are computed once       */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPEQUIV_INCLUDED
+#define EXPEQUIV_INCLUDED
+
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*An ExpEquiv is a set of explicit equivalence classes of operand names*/
+/*together with a set of patterns                                      */
+/*---------------------------------------------------------------------*/
+typedef struct ExpEquiv* ExpEquiv_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpEquiv that declares nothing equivalent, or NULL if   */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+ExpEquiv_T ExpEquiv_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpEquiv                                */
+/*---------------------------------------------------------------------*/
+void ExpEquiv_free(ExpEquiv_T oExpEquiv);
+
+/*---------------------------------------------------------------------*/
+/*Add the declaration pcSpec to oExpEquiv. pcSpec is two or more forms */
+/*separated by =. Forms without braces are operand names, ex. x=y=z    */
+/*makes x, y and z equivalent. Forms with braces are patterns, where   */
+/*{name} stands for a run of digits, ex. a{i}_{j}=a{j}_{i} makes every */
+/*a1_2 equivalent to a2_1. Every form of a pattern must use the same   */
+/*placeholders, and a placeholder may not be followed directly by      */
+/*another placeholder or by a digit. Return 0 if successful, 1 if      */
+/*memory is insufficient, -1 if pcSpec is malformed                    */
+/*---------------------------------------------------------------------*/
+int ExpEquiv_add(ExpEquiv_T oExpEquiv, const char* pcSpec);
+
+/*---------------------------------------------------------------------*/
+/*Store in pcRepresentative, which holds uiSize chars including the    */
+/*terminating '\0', the representative of the class of the operand     */
+/*pcName: the smallest name, in strcmp order, that pcName is declared  */
+/*equivalent to, possibly through several declarations. Names too long */
+/*to be operands are never representatives                             */
+/*---------------------------------------------------------------------*/
+void ExpEquiv_representative(ExpEquiv_T oExpEquiv, const char* pcName,\
+			     char* pcRepresentative, unsigned int uiSize);
+
+/*---------------------------------------------------------------------*/
+/*Rename every operand in the trees stored in the list pllTrees to the */
+/*representative of its class. Store the number of operands renamed in */
+/*puiRenamed if it is not NULL                                         */
+/*---------------------------------------------------------------------*/
+void ExpEquiv_apply(ExpEquiv_T oExpEquiv, LinkList_T pllTrees,\
+		    unsigned int* puiRenamed);
+
+#endif
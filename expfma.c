@@ -0,0 +1,378 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expfma.c implements expfma.h. The statements are visited in order,   */
+/*and each tree below its root first, so a sum sees its operands       */
+/*already contracted. A contracted sum keeps its node, which becomes   */
+/*the fused multiply-add, and takes over the factors of the product,   */
+/*so only a node for a new sign and the link to the third operand are  */
+/*ever allocated, unless factors are copied                            */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "expfma.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the temporary of a product written in the statement itself    */
+/*---------------------------------------------------------------------*/
+#define NO_TEMP 0xFFFFFFFFu
+
+/*---------------------------------------------------------------------*/
+/*A Contract is the state of the pass over one program                 */
+/*---------------------------------------------------------------------*/
+struct Contract
+{
+  ExpProgram_T oExpProgram;
+  /*uses of each temporary, outputs included*/
+  unsigned int* puiUses;
+  unsigned int uiLength;
+  /*the statement being visited*/
+  unsigned int uiStatement;
+  int iAll;
+  unsigned int uiContracted;
+  /*whether a statement was removed*/
+  int iRemoved;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the operator at oTreeNode, or OPERAND for a leaf  */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpFMA_type(TreeNode_T oTreeNode){
+  if(ExpTokenTree_getChildren(oTreeNode) == NULL)
+    return OPERAND;
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oTreeNode, its token and the links to its children, but not the */
+/*children, which have been taken over by another node                 */
+/*---------------------------------------------------------------------*/
+static void ExpFMA_freeShell(TreeNode_T oTreeNode){
+  LinkList_T oLinkList, oLinkListNext;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode); oLinkList != NULL;
+      oLinkList = oLinkListNext){
+    oLinkListNext = LinkList_getNext(oLinkList);
+    LinkList_free(oLinkList);
+  }
+  ExpToken_free(ExpTokenTree_getValue(oTreeNode));
+  TreeNode_free(oTreeNode);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the product the operand oTreeNode of a sum in the statement   */
+/*being visited stands for, storing in *puiTemp the temporary holding  */
+/*it, or NO_TEMP if it is oTreeNode itself. Return NULL if it is not a */
+/*product that may be contracted                                       */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFMA_product(struct Contract* pcContract,\
+				 TreeNode_T oTreeNode,\
+				 unsigned int* puiTemp){
+  TreeNode_T oTreeNodeProduct;
+  LinkList_T oLinkList;
+  unsigned int uiTemp;
+  *puiTemp = NO_TEMP;
+  if(ExpFMA_type(oTreeNode) == MULTIPLY)
+    return oTreeNode;
+  if(ExpFMA_type(oTreeNode) != OPERAND ||\
+     ExpProgram_isTemp(ExpToken_getName(ExpTokenTree_getValue(oTreeNode)),\
+		       &uiTemp) == 0 ||\
+     uiTemp >= pcContract -> uiStatement)
+    return NULL;
+  oTreeNodeProduct = ExpProgram_getValue(pcContract -> oExpProgram, uiTemp);
+  if(oTreeNodeProduct == NULL || ExpFMA_type(oTreeNodeProduct) != MULTIPLY)
+    return NULL;
+  //a shared product is only copied if its factors cost nothing to copy
+  if(pcContract -> puiUses[uiTemp] > 1u){
+    if(pcContract -> iAll == 0)
+      return NULL;
+    for(oLinkList = ExpTokenTree_getChildren(oTreeNodeProduct);
+	oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+      if(ExpFMA_type((TreeNode_T)LinkList_getValue(oLinkList)) != OPERAND)
+	return NULL;
+  }
+  *puiTemp = uiTemp;
+  return oTreeNodeProduct;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return oTreeNode negated: its operand if it is a negative sign, whose*/
+/*node is stored in *poTreeNodeSign to be freed once the contraction   */
+/*cannot fail, or else a new negative sign over it. Return NULL if     */
+/*memory is insufficient, leaving oTreeNode unchanged                  */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFMA_negate(TreeNode_T oTreeNode,\
+				TreeNode_T* poTreeNodeSign){
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNodeSign;
+  if(ExpFMA_type(oTreeNode) == NEGATIVE){
+    *poTreeNodeSign = oTreeNode;
+    return (TreeNode_T)LinkList_getValue(ExpTokenTree_getChildren(oTreeNode));
+  }
+  oExpToken = ExpToken_new();
+  oTreeNodeSign = ExpTokenTree_new();
+  if(oExpToken == NULL || oTreeNodeSign == NULL ||\
+     ExpTokenTree_addChild(oTreeNodeSign, oTreeNode) != 0){
+    if(oExpToken != NULL)
+      ExpToken_free(oExpToken);
+    if(oTreeNodeSign != NULL)
+      TreeNode_free(oTreeNodeSign);
+    return NULL;
+  }
+  ExpToken_setType(oExpToken, NEGATIVE);
+  ExpTokenTree_setValue(oTreeNodeSign, oExpToken);
+  return oTreeNodeSign;
+}
+
+/*---------------------------------------------------------------------*/
+/*Contract the sum or difference oTreeNode, whose operand uiSide, 0 or */
+/*1, stands for the product oTreeNodeProduct held by uiTemp, as by     */
+/*ExpFMA_product. Return 0 if successful, 1 if memory is insufficient, */
+/*in which case nothing is changed                                     */
+/*---------------------------------------------------------------------*/
+static int ExpFMA_fuse(struct Contract* pcContract, TreeNode_T oTreeNode,\
+		       unsigned int uiSide, TreeNode_T oTreeNodeProduct,\
+		       unsigned int uiTemp){
+  LinkList_T oLinkListSum, oLinkListProduct, oLinkListAddend;
+  TreeNode_T poFactors[2];
+  TreeNode_T oTreeNodeAddend, oTreeNodeOperand, oTreeNodeFirst;
+  TreeNode_T oTreeNodeSign = NULL;
+  int iCopy, iSubtract;
+  oLinkListSum = ExpTokenTree_getChildren(oTreeNode);
+  oTreeNodeOperand = (TreeNode_T)LinkList_getValue\
+    (uiSide == 0u ? oLinkListSum : LinkList_getNext(oLinkListSum));
+  oTreeNodeAddend = (TreeNode_T)LinkList_getValue\
+    (uiSide == 0u ? LinkList_getNext(oLinkListSum) : oLinkListSum);
+  oLinkListProduct = ExpTokenTree_getChildren(oTreeNodeProduct);
+  poFactors[0] = (TreeNode_T)LinkList_getValue(oLinkListProduct);
+  poFactors[1] = (TreeNode_T)LinkList_getValue\
+    (LinkList_getNext(oLinkListProduct));
+  iCopy = (uiTemp != NO_TEMP && pcContract -> puiUses[uiTemp] > 1u);
+  iSubtract = (ExpFMA_type(oTreeNode) == SUBTRACT);
+  //allocate everything before changing anything
+  oLinkListAddend = LinkList_new();
+  if(oLinkListAddend == NULL)
+    return 1;
+  if(iCopy){
+    poFactors[0] = ExpTokenTree_copy(poFactors[0]);
+    poFactors[1] = (poFactors[0] == NULL) ? NULL :\
+      ExpTokenTree_copy(poFactors[1]);
+    if(poFactors[1] == NULL){
+      if(poFactors[0] != NULL)
+	ExpTokenTree_free(poFactors[0]);
+      LinkList_free(oLinkListAddend);
+      return 1;
+    }
+  }
+  //x*y-z negates the addend, and z-x*y the product by its first factor
+  oTreeNodeFirst = poFactors[0];
+  if(iSubtract && uiSide == 0u)
+    oTreeNodeAddend = ExpFMA_negate(oTreeNodeAddend, &oTreeNodeSign);
+  else if(iSubtract)
+    oTreeNodeFirst = ExpFMA_negate(poFactors[0], &oTreeNodeSign);
+  if(oTreeNodeAddend == NULL || oTreeNodeFirst == NULL){
+    if(iCopy){
+      ExpTokenTree_free(poFactors[0]);
+      ExpTokenTree_free(poFactors[1]);
+    }
+    LinkList_free(oLinkListAddend);
+    return 1;
+  }
+  if(oTreeNodeSign != NULL)
+    ExpFMA_freeShell(oTreeNodeSign);
+  if(uiTemp != NO_TEMP){
+    ExpTokenTree_free(oTreeNodeOperand);
+    pcContract -> puiUses[uiTemp]--;
+  }
+  //the factors of a copied product gain a use, and a product used
+  //nowhere else is removed from where it was
+  if(iCopy){
+    ExpProgram_countUses(poFactors[0], pcContract -> puiUses,\
+			 pcContract -> uiLength);
+    ExpProgram_countUses(poFactors[1], pcContract -> puiUses,\
+			 pcContract -> uiLength);
+  }
+  else if(uiTemp != NO_TEMP){
+    ExpFMA_freeShell(ExpProgram_take(pcContract -> oExpProgram, uiTemp));
+    pcContract -> iRemoved = 1;
+  }
+  else
+    ExpFMA_freeShell(oTreeNodeProduct);
+  LinkList_setValue(oLinkListSum, oTreeNodeFirst);
+  LinkList_setValue(LinkList_getNext(oLinkListSum), poFactors[1]);
+  LinkList_setValue(oLinkListAddend, oTreeNodeAddend);
+  LinkList_setNext(LinkList_getNext(oLinkListSum), oLinkListAddend);
+  ExpToken_setType(ExpTokenTree_getValue(oTreeNode), FMA);
+  pcContract -> uiContracted++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Contract oTreeNode and every node below it, in the statement being   */
+/*visited. Of two products, one written in the statement is preferred, */
+/*then the first. Return 0 if successful, 1 if memory is insufficient  */
+/*---------------------------------------------------------------------*/
+static int ExpFMA_visit(struct Contract* pcContract, TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  TreeNode_T poProducts[2];
+  unsigned int puiTemps[2];
+  unsigned int uiSide;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode); oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(ExpFMA_visit(pcContract, (TreeNode_T)LinkList_getValue(oLinkList)))
+      return 1;
+  if(ExpFMA_type(oTreeNode) != ADD && ExpFMA_type(oTreeNode) != SUBTRACT)
+    return 0;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  for(uiSide = 0u; uiSide < 2u; uiSide++){
+    poProducts[uiSide] = ExpFMA_product\
+      (pcContract, (TreeNode_T)LinkList_getValue(oLinkList),\
+       &puiTemps[uiSide]);
+    oLinkList = LinkList_getNext(oLinkList);
+  }
+  uiSide = (poProducts[0] == NULL ||\
+	    (poProducts[1] != NULL && puiTemps[0] != NO_TEMP &&\
+	     puiTemps[1] == NO_TEMP));
+  if(poProducts[uiSide] == NULL)
+    return 0;
+  return ExpFMA_fuse(pcContract, oTreeNode, uiSide, poProducts[uiSide],\
+		     puiTemps[uiSide]);
+}
+
+/*---------------------------------------------------------------------*/
+/*Contract the multiply-add pairs of oExpProgram                       */
+/*---------------------------------------------------------------------*/
+int ExpFMA_contract(ExpProgram_T oExpProgram, LinkList_T pllTrees,\
+		    int iAll, unsigned int* puiContracted){
+  struct Contract cContract;
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNode;
+  int iStatus = 0;
+  assert(oExpProgram != NULL);
+  if(puiContracted != NULL)
+    *puiContracted = 0u;
+  cContract.oExpProgram = oExpProgram;
+  cContract.uiLength = ExpProgram_howMany(oExpProgram);
+  cContract.iAll = iAll;
+  cContract.uiContracted = 0u;
+  cContract.iRemoved = 0;
+  cContract.puiUses = (unsigned int*)calloc(cContract.uiLength + 1u,\
+					    sizeof(unsigned int));
+  if(cContract.puiUses == NULL)
+    return 1;
+  for(cContract.uiStatement = 0u;
+      cContract.uiStatement < cContract.uiLength;
+      cContract.uiStatement++)
+    ExpProgram_countUses(ExpProgram_getValue(oExpProgram,\
+					     cContract.uiStatement),\
+			 cContract.puiUses, cContract.uiLength);
+  for(oLinkList = pllTrees; oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(LinkList_getValue(oLinkList) != NULL)
+      ExpProgram_countUses((TreeNode_T)LinkList_getValue(oLinkList),\
+			   cContract.puiUses, cContract.uiLength);
+  for(cContract.uiStatement = 0u;
+      cContract.uiStatement < cContract.uiLength && iStatus == 0;
+      cContract.uiStatement++){
+    oTreeNode = ExpProgram_getValue(oExpProgram, cContract.uiStatement);
+    if(oTreeNode != NULL)
+      iStatus = ExpFMA_visit(&cContract, oTreeNode);
+  }
+  //the uses are no longer needed, and make room for the new numbers
+  if(cContract.iRemoved != 0)
+    ExpProgram_compact(oExpProgram, pllTrees, cContract.puiUses);
+  free(cContract.puiUses);
+  if(puiContracted != NULL)
+    *puiContracted = cContract.uiContracted;
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expfma.c                                                        */
+/*---------------------------------------------------------------------*/
+/*
+#include <stdio.h>
+#include "expout.h"
+
+static LinkList_T makeOutputs(const char* pcFirst, const char* pcSecond){
+  LinkList_T pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf(pcFirst));
+  LinkList_setNext(pllTrees, LinkList_new());
+  LinkList_setValue(LinkList_getNext(pllTrees),\
+		    ExpTokenTree_newLeaf(pcSecond));
+  return pllTrees;
+}
+
+static void freeOutputs(LinkList_T pllTrees){
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(LinkList_getNext(pllTrees)));
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(LinkList_getNext(pllTrees));
+  LinkList_free(pllTrees);
+}
+
+int main(void){
+  ExpProgram_T oExpProgram;
+  LinkList_T pllTrees;
+  unsigned int uiContracted;
+
+  //#0 = a*b, #1 = #0+c, #2 = d-e*f, #3 = x*y, #4 = #3-#1
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("c")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(SUBTRACT, ExpTokenTree_newLeaf("d"),\
+				      ExpTokenTree_newNode(MULTIPLY,\
+					ExpTokenTree_newLeaf("e"),\
+					ExpTokenTree_newLeaf("f"))));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("x"),\
+				      ExpTokenTree_newLeaf("y")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(SUBTRACT, ExpTokenTree_newLeaf("#3"),\
+				      ExpTokenTree_newLeaf("#1")));
+  pllTrees = makeOutputs("#2", "#4");
+  if(ExpFMA_contract(oExpProgram, pllTrees, 0, &uiContracted) != 0 ||\
+     uiContracted != 3u || ExpProgram_howMany(oExpProgram) != 3u ||\
+     ExpProgram_countOperations(oExpProgram) != 3u)
+    printf("failed test 1\n");
+  //#0 = fma(a,b,c), #1 = fma(-e,f,d), #2 = fma(x,y,-#0)
+  ExpProgram_print(oExpProgram);
+  //the first output, #2, is now #1
+  ExpOut_string(ExpToken_getName(ExpTokenTree_getValue\
+				 ((TreeNode_T)LinkList_getValue(pllTrees))));
+  ExpOut_char('\n');
+  ExpOut_flush();
+  freeOutputs(pllTrees);
+  ExpProgram_free(oExpProgram);
+
+  //#0 = a*b shared by #1 = #0+c and #2 = #0-d
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("c")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(SUBTRACT, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("d")));
+  pllTrees = makeOutputs("#1", "#2");
+  if(ExpFMA_contract(oExpProgram, pllTrees, 0, &uiContracted) != 0 ||\
+     uiContracted != 0u || ExpProgram_howMany(oExpProgram) != 3u)
+    printf("failed test 2\n");
+  if(ExpFMA_contract(oExpProgram, pllTrees, 1, &uiContracted) != 0 ||\
+     uiContracted != 2u || ExpProgram_howMany(oExpProgram) != 2u)
+    printf("failed test 3\n");
+  //#0 = fma(a,b,c), #1 = fma(a,b,-d)
+  ExpProgram_print(oExpProgram);
+  ExpOut_flush();
+  freeOutputs(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
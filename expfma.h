@@ -0,0 +1,33 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expfma.h describes the contraction of multiply-add pairs in          */
+/*ExpPrograms into fused multiply-adds. A product that only feeds a sum*/
+/*or difference costs a second instruction and a second rounding on a  */
+/*target with a fused multiply-add, which does both at once            */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPFMA_INCLUDED
+#define EXPFMA_INCLUDED
+
+#include "linklist.h"
+#include "expprogram.h"
+
+/*---------------------------------------------------------------------*/
+/*Contract every sum or difference in oExpProgram one of whose operands*/
+/*is a product, x*y+z, z+x*y, x*y-z or z-x*y, into fma(x,y,z),         */
+/*fma(x,y,-z) or fma(-x,y,z), a sign already on the operand negated    */
+/*cancelling. The product may be written in the same statement, or be a*/
+/*temporary used nowhere else, whose statement is then removed. If     */
+/*iAll is nonzero, a temporary product used elsewhere too is contracted*/
+/*as well, as long as its factors are single operands or temporaries,  */
+/*which are copied, and it is removed once no use is left. The trees   */
+/*stored in the list pllTrees are the outputs of the program, count as */
+/*uses, and are renumbered along with it. Store the number of          */
+/*contractions in puiContracted if it is not NULL. Return 0 if         */
+/*successful, 1 if memory is insufficient, in which case the program is*/
+/*valid but may be only partly contracted                              */
+/*---------------------------------------------------------------------*/
+int ExpFMA_contract(ExpProgram_T oExpProgram, LinkList_T pllTrees,\
+		    int iAll, unsigned int* puiContracted);
+
+#endif
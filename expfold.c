@@ -0,0 +1,617 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expfold.c implements expfold.h. Trees are folded bottom up. At a sum */
+/*or product the constant part of each already folded operand is split */
+/*off, the constant parts are combined, and the operation is only      */
+/*rebuilt when that actually removes work, so the shape of the rest of */
+/*the tree, and with it the sharing found by ExpParser_simplify, is    */
+/*kept                                                                 */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expfold.h"
+#include "exprational.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the results of ExpFold_constant                               */
+/*---------------------------------------------------------------------*/
+#define FOLD_OK 0
+#define FOLD_MEMORY 1
+#define FOLD_TOO_LONG 2
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpFold_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return child number uiIndex of oTreeNode, counting from 0            */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFold_child(TreeNode_T oTreeNode,\
+				unsigned int uiIndex){
+  LinkList_T oLinkList;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  for(; uiIndex > 0u; uiIndex--)
+    oLinkList = LinkList_getNext(oLinkList);
+  assert(oLinkList != NULL);
+  return (TreeNode_T)LinkList_getValue(oLinkList);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new node of type ettType whose children are oTreeNode1 and, */
+/*for binary operators, oTreeNode2. The new node takes ownership of the*/
+/*children. If memory is insufficient, or a child that is needed is    */
+/*NULL because an earlier allocation failed, free the children and     */
+/*return NULL                                                          */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFold_newNode(enum ExpTokenType ettType,\
+				  TreeNode_T oTreeNode1,\
+				  TreeNode_T oTreeNode2){
+  ExpToken_T oExpToken = NULL;
+  TreeNode_T oTreeNode = NULL;
+  int iUnary;
+  iUnary = (ettType == NEGATIVE | ettType == POSITIVE |\
+	    ettType == RECIPROCAL);
+  if(oTreeNode1 != NULL && (iUnary || oTreeNode2 != NULL)){
+    oExpToken = ExpToken_new();
+    oTreeNode = ExpTokenTree_new();
+  }
+  if(oExpToken != NULL && oTreeNode != NULL){
+    ExpToken_setType(oExpToken, ettType);
+    ExpTokenTree_setValue(oTreeNode, oExpToken);
+    oExpToken = NULL;
+    if(ExpTokenTree_addChild(oTreeNode, oTreeNode1) == 0){
+      oTreeNode1 = NULL;
+      if(iUnary || ExpTokenTree_addChild(oTreeNode, oTreeNode2) == 0)
+	return oTreeNode;
+    }
+  }
+  if(oExpToken != NULL)
+    ExpToken_free(oExpToken);
+  if(oTreeNode != NULL)
+    ExpTokenTree_free(oTreeNode);
+  if(oTreeNode1 != NULL)
+    ExpTokenTree_free(oTreeNode1);
+  if(oTreeNode2 != NULL)
+    ExpTokenTree_free(oTreeNode2);
+  return NULL;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new operand whose name is the literal of the magnitude of   */
+/*rValue, and store FOLD_OK, FOLD_MEMORY or FOLD_TOO_LONG in piStatus  */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFold_literal(struct ExpRational rValue, int* piStatus){
+  char pcDigits[48];
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode;
+  unsigned int uiIndex, uiSize;
+  //a decimal too long for a name may still fit as a fraction
+  uiSize = ExpToken_maxChars() + 1u;
+  if(uiSize > sizeof(pcDigits))
+    uiSize = sizeof(pcDigits);
+  if(ExpRational_literal(rValue, pcDigits, uiSize) != 0){
+    *piStatus = FOLD_TOO_LONG;
+    return NULL;
+  }
+  *piStatus = FOLD_MEMORY;
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return NULL;
+  for(uiIndex = 0u; pcDigits[uiIndex] != '\0'; uiIndex++)
+    ExpToken_appendChar(oExpToken, pcDigits[uiIndex]);
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  *piStatus = FOLD_OK;
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in *poTreeNode a new tree for the constant rValue: one literal */
+/*operand, ex. 4, 0.25 or 1/3, or its negation. Return FOLD_OK,        */
+/*FOLD_MEMORY, or FOLD_TOO_LONG if the literal has more chars than an  */
+/*operand name can hold                                                */
+/*---------------------------------------------------------------------*/
+static int ExpFold_constant(struct ExpRational rValue,\
+			    TreeNode_T* poTreeNode){
+  TreeNode_T oTreeNode;
+  int iStatus;
+  *poTreeNode = NULL;
+  oTreeNode = ExpFold_literal(rValue, &iStatus);
+  if(iStatus != FOLD_OK)
+    return iStatus;
+  if(ExpRational_sign(rValue) < 0)
+    oTreeNode = ExpFold_newNode(NEGATIVE, oTreeNode, NULL);
+  *poTreeNode = oTreeNode;
+  return (oTreeNode == NULL) ? FOLD_MEMORY : FOLD_OK;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the value of the constant oTreeNode in *prValue                */
+/*---------------------------------------------------------------------*/
+int ExpFold_value(TreeNode_T oTreeNode, struct ExpRational* prValue){
+  struct ExpRational rNum, rDen;
+  switch(ExpFold_type(oTreeNode))
+    {
+    case OPERAND:
+      return ExpRational_parse\
+	(ExpToken_getName(ExpTokenTree_getValue(oTreeNode)), prValue) == 0;
+    case NEGATIVE:
+      if(ExpFold_value(ExpFold_child(oTreeNode, 0u), prValue) == 0)
+	return 0;
+      prValue -> llNum = -prValue -> llNum;
+      return 1;
+    case DIVIDE:
+      if(ExpFold_type(ExpFold_child(oTreeNode, 0u)) != OPERAND |\
+	 ExpFold_type(ExpFold_child(oTreeNode, 1u)) != OPERAND)
+	return 0;
+      if(ExpFold_value(ExpFold_child(oTreeNode, 0u), &rNum) == 0 ||\
+	 ExpFold_value(ExpFold_child(oTreeNode, 1u), &rDen) == 0)
+	return 0;
+      return ExpRational_divide(rNum, rDen, prValue) == 0;
+    default:
+      return 0;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a copy of child uiIndex of oTreeNode and free oTreeNode, or   */
+/*return NULL if memory is insufficient                                */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFold_keepChild(TreeNode_T oTreeNode,\
+				    unsigned int uiIndex){
+  TreeNode_T oTreeNodeChild;
+  oTreeNodeChild = ExpTokenTree_copy(ExpFold_child(oTreeNode, uiIndex));
+  ExpTokenTree_free(oTreeNode);
+  return oTreeNodeChild;
+}
+
+/*---------------------------------------------------------------------*/
+/*Split the folded operand oTreeNode of a sum into a constant part,    */
+/*stored in *prConstant, and the rest, stored in *poTreeNodeRest with  */
+/*its sign in *piRestSign. The rest points into oTreeNode, or is NULL  */
+/*if oTreeNode is constant. Return 1 if a constant part was found, 0 if*/
+/*not                                                                  */
+/*---------------------------------------------------------------------*/
+static int ExpFold_splitSum(TreeNode_T oTreeNode,\
+			    struct ExpRational* prConstant,\
+			    TreeNode_T* poTreeNodeRest, int* piRestSign){
+  enum ExpTokenType ettType;
+  *piRestSign = 1;
+  if(ExpFold_value(oTreeNode, prConstant) != 0){
+    *poTreeNodeRest = NULL;
+    return 1;
+  }
+  ettType = ExpFold_type(oTreeNode);
+  if(ettType == ADD | ettType == SUBTRACT){
+    if(ExpFold_value(ExpFold_child(oTreeNode, 1u), prConstant) != 0){
+      if(ettType == SUBTRACT)
+	prConstant -> llNum = -prConstant -> llNum;
+      *poTreeNodeRest = ExpFold_child(oTreeNode, 0u);
+      return 1;
+    }
+    if(ExpFold_value(ExpFold_child(oTreeNode, 0u), prConstant) != 0){
+      *poTreeNodeRest = ExpFold_child(oTreeNode, 1u);
+      *piRestSign = (ettType == ADD) ? 1 : -1;
+      return 1;
+    }
+  }
+  *prConstant = ExpRational_fromInt(0ll);
+  *poTreeNodeRest = oTreeNode;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Split the folded operand oTreeNode of a product into a constant      */
+/*factor, stored in *prConstant, and the rest, stored in               */
+/**poTreeNodeRest. The rest points into oTreeNode, or is NULL if       */
+/*oTreeNode is constant. Return 1 if a constant factor was found, 0 if */
+/*not                                                                  */
+/*---------------------------------------------------------------------*/
+static int ExpFold_splitProduct(TreeNode_T oTreeNode,\
+				struct ExpRational* prConstant,\
+				TreeNode_T* poTreeNodeRest){
+  if(ExpFold_value(oTreeNode, prConstant) != 0){
+    *poTreeNodeRest = NULL;
+    return 1;
+  }
+  if(ExpFold_type(oTreeNode) == MULTIPLY){
+    if(ExpFold_value(ExpFold_child(oTreeNode, 0u), prConstant) != 0){
+      *poTreeNodeRest = ExpFold_child(oTreeNode, 1u);
+      return 1;
+    }
+    if(ExpFold_value(ExpFold_child(oTreeNode, 1u), prConstant) != 0){
+      *poTreeNodeRest = ExpFold_child(oTreeNode, 0u);
+      return 1;
+    }
+  }
+  *prConstant = ExpRational_fromInt(1ll);
+  *poTreeNodeRest = oTreeNode;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Fold the sum or difference, of type ettType, of the folded operands  */
+/*oTreeNode1 and oTreeNode2, taking ownership of both. Return NULL if  */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFold_sum(enum ExpTokenType ettType,\
+			      TreeNode_T oTreeNode1,\
+			      TreeNode_T oTreeNode2){
+  struct ExpRational rConstant1, rConstant2, rConstant, rMagnitude;
+  TreeNode_T oTreeNodeRest1, oTreeNodeRest2, oTreeNodeRest, oTreeNodeK;
+  int iFound, iSign1, iSign2, iRestSign, iStatus;
+  iFound = ExpFold_splitSum(oTreeNode1, &rConstant1, &oTreeNodeRest1,\
+			    &iSign1);
+  iFound += ExpFold_splitSum(oTreeNode2, &rConstant2, &oTreeNodeRest2,\
+			     &iSign2);
+  if(ettType == SUBTRACT){
+    rConstant2.llNum = -rConstant2.llNum;
+    iSign2 = -iSign2;
+  }
+  //only rebuild if constants combine or a zero disappears
+  if(iFound == 0 ||\
+     ExpRational_add(rConstant1, rConstant2, &rConstant) != 0 ||\
+     (iFound == 1 && ExpRational_sign(rConstant) != 0))
+    return ExpFold_newNode(ettType, oTreeNode1, oTreeNode2);
+  oTreeNodeK = NULL;
+  if(ExpRational_sign(rConstant) != 0 ||\
+     (oTreeNodeRest1 == NULL && oTreeNodeRest2 == NULL)){
+    rMagnitude = rConstant;
+    if(oTreeNodeRest1 != NULL || oTreeNodeRest2 != NULL)
+      rMagnitude.llNum = (rMagnitude.llNum < 0ll) ?\
+	-rMagnitude.llNum : rMagnitude.llNum;
+    iStatus = ExpFold_constant(rMagnitude, &oTreeNodeK);
+    if(iStatus == FOLD_TOO_LONG)
+      return ExpFold_newNode(ettType, oTreeNode1, oTreeNode2);
+    if(iStatus == FOLD_MEMORY){
+      ExpTokenTree_free(oTreeNode1);
+      ExpTokenTree_free(oTreeNode2);
+      return NULL;
+    }
+    if(oTreeNodeRest1 == NULL && oTreeNodeRest2 == NULL){
+      ExpTokenTree_free(oTreeNode1);
+      ExpTokenTree_free(oTreeNode2);
+      return oTreeNodeK;
+    }
+  }
+  //combine what is left of the two operands
+  if(oTreeNodeRest1 != NULL)
+    oTreeNodeRest1 = ExpTokenTree_copy(oTreeNodeRest1);
+  if(oTreeNodeRest2 != NULL)
+    oTreeNodeRest2 = ExpTokenTree_copy(oTreeNodeRest2);
+  ExpTokenTree_free(oTreeNode1);
+  ExpTokenTree_free(oTreeNode2);
+  if(oTreeNodeRest1 == NULL){
+    oTreeNodeRest = oTreeNodeRest2;
+    iRestSign = iSign2;
+  }
+  else if(oTreeNodeRest2 == NULL){
+    oTreeNodeRest = oTreeNodeRest1;
+    iRestSign = iSign1;
+  }
+  else if(iSign1 > 0 | iSign2 > 0){
+    oTreeNodeRest = (iSign1 > 0) ?\
+      ExpFold_newNode((iSign2 > 0) ? ADD : SUBTRACT, oTreeNodeRest1,\
+		      oTreeNodeRest2) :\
+      ExpFold_newNode(SUBTRACT, oTreeNodeRest2, oTreeNodeRest1);
+    iRestSign = 1;
+  }
+  else{
+    oTreeNodeRest = ExpFold_newNode(ADD, oTreeNodeRest1, oTreeNodeRest2);
+    iRestSign = -1;
+  }
+  //then add the constant back in
+  if(oTreeNodeK == NULL)
+    return (iRestSign > 0) ? oTreeNodeRest :\
+      ExpFold_newNode(NEGATIVE, oTreeNodeRest, NULL);
+  if(iRestSign > 0)
+    return ExpFold_newNode((ExpRational_sign(rConstant) > 0) ?\
+			   ADD : SUBTRACT, oTreeNodeRest, oTreeNodeK);
+  if(ExpRational_sign(rConstant) > 0)
+    return ExpFold_newNode(SUBTRACT, oTreeNodeK, oTreeNodeRest);
+  return ExpFold_newNode(NEGATIVE,\
+			 ExpFold_newNode(ADD, oTreeNodeRest, oTreeNodeK),\
+			 NULL);
+}
+
+/*---------------------------------------------------------------------*/
+/*Fold the product of the folded operands oTreeNode1 and oTreeNode2,   */
+/*taking ownership of both. Return NULL if memory is insufficient      */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFold_product(TreeNode_T oTreeNode1,\
+				  TreeNode_T oTreeNode2){
+  struct ExpRational rConstant1, rConstant2, rConstant, rMagnitude;
+  TreeNode_T oTreeNodeRest1, oTreeNodeRest2, oTreeNodeRest, oTreeNodeK;
+  int iFound, iStatus, iSign;
+  iFound = ExpFold_splitProduct(oTreeNode1, &rConstant1, &oTreeNodeRest1);
+  iFound += ExpFold_splitProduct(oTreeNode2, &rConstant2, &oTreeNodeRest2);
+  //only rebuild if constants combine or the constant is 0, 1 or -1
+  if(iFound == 0 ||\
+     ExpRational_multiply(rConstant1, rConstant2, &rConstant) != 0 ||\
+     (iFound == 1 && ExpRational_equals(rConstant, 0ll) == 0 &&\
+      ExpRational_equals(rConstant, 1ll) == 0 &&\
+      ExpRational_equals(rConstant, -1ll) == 0))
+    return ExpFold_newNode(MULTIPLY, oTreeNode1, oTreeNode2);
+  if(ExpRational_sign(rConstant) == 0 ||\
+     (oTreeNodeRest1 == NULL && oTreeNodeRest2 == NULL)){
+    iStatus = ExpFold_constant(rConstant, &oTreeNodeK);
+    if(iStatus == FOLD_TOO_LONG)
+      return ExpFold_newNode(MULTIPLY, oTreeNode1, oTreeNode2);
+    ExpTokenTree_free(oTreeNode1);
+    ExpTokenTree_free(oTreeNode2);
+    return oTreeNodeK;
+  }
+  iSign = ExpRational_sign(rConstant);
+  rMagnitude = rConstant;
+  rMagnitude.llNum *= iSign;
+  oTreeNodeK = NULL;
+  if(ExpRational_equals(rMagnitude, 1ll) == 0){
+    iStatus = ExpFold_constant(rMagnitude, &oTreeNodeK);
+    if(iStatus == FOLD_TOO_LONG)
+      return ExpFold_newNode(MULTIPLY, oTreeNode1, oTreeNode2);
+    if(iStatus == FOLD_MEMORY){
+      ExpTokenTree_free(oTreeNode1);
+      ExpTokenTree_free(oTreeNode2);
+      return NULL;
+    }
+  }
+  //multiply what is left of the operands
+  if(oTreeNodeRest1 != NULL)
+    oTreeNodeRest1 = ExpTokenTree_copy(oTreeNodeRest1);
+  if(oTreeNodeRest2 != NULL)
+    oTreeNodeRest2 = ExpTokenTree_copy(oTreeNodeRest2);
+  ExpTokenTree_free(oTreeNode1);
+  ExpTokenTree_free(oTreeNode2);
+  if(oTreeNodeRest1 == NULL)
+    oTreeNodeRest = oTreeNodeRest2;
+  else if(oTreeNodeRest2 == NULL)
+    oTreeNodeRest = oTreeNodeRest1;
+  else
+    oTreeNodeRest = ExpFold_newNode(MULTIPLY, oTreeNodeRest1,\
+				    oTreeNodeRest2);
+  if(oTreeNodeK != NULL)
+    oTreeNodeRest = ExpFold_newNode(MULTIPLY, oTreeNodeK, oTreeNodeRest);
+  if(iSign < 0)
+    oTreeNodeRest = ExpFold_newNode(NEGATIVE, oTreeNodeRest, NULL);
+  return oTreeNodeRest;
+}
+
+/*---------------------------------------------------------------------*/
+/*Fold the operation of type ettType applied to the folded operands    */
+/*oTreeNode1 and, for binary operators, oTreeNode2, taking ownership of*/
+/*both. Return NULL if memory is insufficient                          */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpFold_combine(enum ExpTokenType ettType,\
+				  TreeNode_T oTreeNode1,\
+				  TreeNode_T oTreeNode2){
+  struct ExpRational rValue1, rValue2, rResult;
+  TreeNode_T oTreeNodeNew;
+  int iConst1, iConst2, iStatus;
+  iConst1 = ExpFold_value(oTreeNode1, &rValue1);
+  iConst2 = (oTreeNode2 != NULL) && ExpFold_value(oTreeNode2, &rValue2);
+  //evaluate operations on constants outright
+  iStatus = 1;
+  if(iConst1 != 0 && (oTreeNode2 == NULL || iConst2 != 0)){
+    switch(ettType)
+      {
+      case POSITIVE:
+	rResult = rValue1;
+	iStatus = 0;
+	break;
+      case NEGATIVE:
+	rResult = rValue1;
+	rResult.llNum = -rResult.llNum;
+	iStatus = 0;
+	break;
+      case RECIPROCAL:
+	iStatus = ExpRational_divide(ExpRational_fromInt(1ll), rValue1,\
+				     &rResult);
+	break;
+      case DIVIDE:
+	iStatus = ExpRational_divide(rValue1, rValue2, &rResult);
+	break;
+      case POWER:
+	iStatus = ExpRational_power(rValue1, rValue2, &rResult);
+	break;
+      default:
+	break;
+      }
+  }
+  if(iStatus == 0 &&\
+     ExpFold_constant(rResult, &oTreeNodeNew) != FOLD_TOO_LONG){
+    ExpTokenTree_free(oTreeNode1);
+    if(oTreeNode2 != NULL)
+      ExpTokenTree_free(oTreeNode2);
+    return oTreeNodeNew;
+  }
+  //otherwise remove identities
+  switch(ettType)
+    {
+    case POSITIVE:
+      return oTreeNode1;
+    case NEGATIVE:
+      //-(-x) = x
+      if(ExpFold_type(oTreeNode1) == NEGATIVE)
+	return ExpFold_keepChild(oTreeNode1, 0u);
+      break;
+    case RECIPROCAL:
+      //1/(1/x) = x
+      if(ExpFold_type(oTreeNode1) == RECIPROCAL)
+	return ExpFold_keepChild(oTreeNode1, 0u);
+      break;
+    case ADD:
+    case SUBTRACT:
+      return ExpFold_sum(ettType, oTreeNode1, oTreeNode2);
+    case MULTIPLY:
+      return ExpFold_product(oTreeNode1, oTreeNode2);
+    case DIVIDE:
+      //x/1 = x, x/(-1) = -x and 0/x = 0
+      if(iConst2 != 0 && ExpRational_equals(rValue2, 1ll) != 0){
+	ExpTokenTree_free(oTreeNode2);
+	return oTreeNode1;
+      }
+      if(iConst2 != 0 && ExpRational_equals(rValue2, -1ll) != 0){
+	ExpTokenTree_free(oTreeNode2);
+	return ExpFold_newNode(NEGATIVE, oTreeNode1, NULL);
+      }
+      if(iConst1 != 0 && ExpRational_sign(rValue1) == 0 &&\
+	 !(iConst2 != 0 && ExpRational_sign(rValue2) == 0)){
+	ExpTokenTree_free(oTreeNode2);
+	return oTreeNode1;
+      }
+      break;
+    case POWER:
+      //x^1 = x, x^0 = 1, 1^x = 1 and 0^n = 0 for positive n
+      if(iConst2 != 0 && ExpRational_equals(rValue2, 1ll) != 0){
+	ExpTokenTree_free(oTreeNode2);
+	return oTreeNode1;
+      }
+      if((iConst2 != 0 && ExpRational_sign(rValue2) == 0) ||\
+	 (iConst1 != 0 && ExpRational_equals(rValue1, 1ll) != 0)){
+	ExpTokenTree_free(oTreeNode1);
+	ExpTokenTree_free(oTreeNode2);
+	ExpFold_constant(ExpRational_fromInt(1ll), &oTreeNodeNew);
+	return oTreeNodeNew;
+      }
+      if(iConst1 != 0 && ExpRational_sign(rValue1) == 0 &&\
+	 iConst2 != 0 && ExpRational_sign(rValue2) > 0){
+	ExpTokenTree_free(oTreeNode2);
+	return oTreeNode1;
+      }
+      break;
+    default:
+      break;
+    }
+  return ExpFold_newNode(ettType, oTreeNode1, oTreeNode2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new folded copy of oTreeNode, or NULL if memory is          */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpFold_tree(TreeNode_T oTreeNode){
+  TreeNode_T oTreeNode1, oTreeNode2;
+  LinkList_T oLinkList;
+  assert(oTreeNode != NULL);
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return ExpTokenTree_copy(oTreeNode);
+  //fold the operands first
+  oTreeNode1 = ExpFold_tree((TreeNode_T)LinkList_getValue(oLinkList));
+  if(oTreeNode1 == NULL)
+    return NULL;
+  oTreeNode2 = NULL;
+  oLinkList = LinkList_getNext(oLinkList);
+  if(oLinkList != NULL){
+    oTreeNode2 = ExpFold_tree((TreeNode_T)LinkList_getValue(oLinkList));
+    if(oTreeNode2 == NULL){
+      ExpTokenTree_free(oTreeNode1);
+      return NULL;
+    }
+  }
+  return ExpFold_combine(ExpFold_type(oTreeNode), oTreeNode1, oTreeNode2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations in oTreeNode                         */
+/*---------------------------------------------------------------------*/
+unsigned int ExpFold_countOperations(TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned int uiCount;
+  assert(oTreeNode != NULL);
+  uiCount = (ExpFold_type(oTreeNode) != OPERAND);
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    uiCount +=\
+      ExpFold_countOperations((TreeNode_T)LinkList_getValue(oLinkList));
+  return uiCount;
+}
+
+/*---------------------------------------------------------------------*/
+/*Fold every tree stored in pllTrees. Return 0 if successful, 1 if     */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+int ExpFold_apply(LinkList_T pllTrees, unsigned int* puiBefore,\
+		  unsigned int* puiAfter){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNode, oTreeNodeNew;
+  unsigned int uiBefore = 0u, uiAfter = 0u;
+  int iResult = 0;
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNode = (TreeNode_T)LinkList_getValue(oLinkList);
+    uiBefore += ExpFold_countOperations(oTreeNode);
+    if(iResult == 0){
+      oTreeNodeNew = ExpFold_tree(oTreeNode);
+      if(oTreeNodeNew == NULL)
+	iResult = 1;
+      else{
+	ExpTokenTree_free(oTreeNode);
+	oTreeNode = oTreeNodeNew;
+	LinkList_setValue(oLinkList, oTreeNode);
+      }
+    }
+    uiAfter += ExpFold_countOperations(oTreeNode);
+  }
+  if(puiBefore != NULL)
+    *puiBefore = uiBefore;
+  if(puiAfter != NULL)
+    *puiAfter = uiAfter;
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expfold.c                                                       */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  TreeNode_T oTreeNode, oTreeNodeFolded;
+
+  //(x*1 + 0)*(2*3) should fold to 6*x
+  oTreeNode = ExpFold_newNode(MULTIPLY,\
+			      ExpFold_newNode(ADD,\
+					      ExpFold_newNode(MULTIPLY,\
+						ExpTokenTree_newLeaf("x"),\
+						ExpTokenTree_newLeaf("1")),\
+					      ExpTokenTree_newLeaf("0")),\
+			      ExpFold_newNode(MULTIPLY,\
+					      ExpTokenTree_newLeaf("2"),\
+					      ExpTokenTree_newLeaf("3")));
+  oTreeNodeFolded = ExpFold_tree(oTreeNode);
+  if(ExpFold_countOperations(oTreeNodeFolded) != 1u)
+    printf("failed test 1\n");
+  ExpTokenTree_print(oTreeNodeFolded);
+  printf("\n");
+  ExpTokenTree_free(oTreeNode);
+  ExpTokenTree_free(oTreeNodeFolded);
+  //1/6+1/6 should fold to the single literal 1/3
+  oTreeNode = ExpFold_newNode(ADD,\
+			      ExpFold_newNode(DIVIDE,\
+					      ExpTokenTree_newLeaf("1"),\
+					      ExpTokenTree_newLeaf("6")),\
+			      ExpFold_newNode(DIVIDE,\
+					      ExpTokenTree_newLeaf("1"),\
+					      ExpTokenTree_newLeaf("6")));
+  oTreeNodeFolded = ExpFold_tree(oTreeNode);
+  if(TreeNode_isLeaf(oTreeNodeFolded) == 0 ||\
+     strcmp(ExpToken_getName(ExpTokenTree_getValue(oTreeNodeFolded)),\
+	    "1/3") != 0)
+    printf("failed test 2\n");
+  ExpTokenTree_free(oTreeNode);
+  ExpTokenTree_free(oTreeNodeFolded);
+  return 0;
+}
+*/
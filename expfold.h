@@ -0,0 +1,50 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expfold.h describes constant folding and algebraic identity          */
+/*elimination for ExpTokenTrees. Literal constants are combined with   */
+/*exact rational arithmetic, and operations such as x*1, x+0, x^1, 0*y */
+/*and -(-x) are removed                                                */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPFOLD_INCLUDED
+#define EXPFOLD_INCLUDED
+
+#include "treenode.h"
+#include "exprational.h"
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree equal to oTreeNode with every constant             */
+/*subexpression evaluated and every identity operation removed.        */
+/*Constants that are not integers are written as a division of two     */
+/*integers, and negative constants as the negation of a positive one. A*/
+/*constant whose value does not fit is left unevaluated. Return NULL if*/
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpFold_tree(TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Replace every tree stored in the list pllTrees with its folded form. */
+/*Store the number of operations before and after in puiBefore and     */
+/*puiAfter if they are not NULL. Return 0 if successful, 1 if memory is*/
+/*insufficient, in which case the trees not yet folded are left as they*/
+/*were                                                                 */
+/*---------------------------------------------------------------------*/
+int ExpFold_apply(LinkList_T pllTrees, unsigned int* puiBefore,\
+		  unsigned int* puiAfter);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations, that is nodes other than operands,  */
+/*in oTreeNode                                                         */
+/*---------------------------------------------------------------------*/
+unsigned int ExpFold_countOperations(TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Return 1 and store the value of oTreeNode in *prValue if oTreeNode is*/
+/*a literal or a constant in one of the forms written by folding: an   */
+/*integer, a division of two integers, or the negation of either.      */
+/*Return 0 if not                                                      */
+/*---------------------------------------------------------------------*/
+int ExpFold_value(TreeNode_T oTreeNode, struct ExpRational* prValue);
+
+#endif
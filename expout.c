@@ -0,0 +1,113 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expout.c implements expout.h. The buffer is a single static array,   */
+/*since there is only one stdout, and it is written with fwrite once   */
+/*full, which a C library passes on as a single write                  */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*The chars appended and not yet written, and how many there are       */
+/*---------------------------------------------------------------------*/
+static char pcBuffer[EXPOUT_BUFFER_SIZE];
+static unsigned int uiUsed = 0u;
+
+/*---------------------------------------------------------------------*/
+/*Write everything appended so far                                     */
+/*---------------------------------------------------------------------*/
+void ExpOut_flush(void){
+  if(uiUsed > 0u)
+    fwrite(pcBuffer, 1u, uiUsed, stdout);
+  fflush(stdout);
+  uiUsed = 0u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Append pcString                                                      */
+/*---------------------------------------------------------------------*/
+void ExpOut_string(const char* pcString){
+  assert(pcString != NULL);
+  for(; *pcString != '\0'; pcString++){
+    if(uiUsed == EXPOUT_BUFFER_SIZE)
+      ExpOut_flush();
+    pcBuffer[uiUsed++] = *pcString;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Append c                                                             */
+/*---------------------------------------------------------------------*/
+void ExpOut_char(char c){
+  if(uiUsed == EXPOUT_BUFFER_SIZE)
+    ExpOut_flush();
+  pcBuffer[uiUsed++] = c;
+}
+
+/*---------------------------------------------------------------------*/
+/*Append uiValue in decimal                                            */
+/*---------------------------------------------------------------------*/
+void ExpOut_unsigned(unsigned int uiValue){
+  char pcDigits[16];
+  unsigned int uiDigits = 0u;
+  //the digits come out last first
+  do{
+    pcDigits[uiDigits++] = (char)('0' + uiValue % 10u);
+    uiValue /= 10u;
+  }while(uiValue != 0u);
+  while(uiDigits > 0u)
+    ExpOut_char(pcDigits[--uiDigits]);
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expout.c, and time printing a program of a million statements,  */
+/*ex. ./expout > /dev/null                                             */
+/*---------------------------------------------------------------------*/
+/*
+#include <time.h>
+#include "expprogram.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+#define BENCH_STATEMENTS 1000000u
+
+int main(void){
+  ExpProgram_T oExpProgram;
+  char pcName[16];
+  unsigned int uiIndex;
+  clock_t ctStart;
+
+  //a name with % must come out as it is
+  ExpOut_string("100%s ");
+  ExpOut_unsigned(0u);
+  ExpOut_char(' ');
+  ExpOut_unsigned(4294967295u);
+  ExpOut_char('\n');
+  ExpOut_flush();
+  fprintf(stderr, "The line above should be: 100%%s 0 4294967295\n");
+
+  //#k = #(k-1)*a_k+b, the first using a_0 alone
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("a_0"),\
+				      ExpTokenTree_newLeaf("b")));
+  for(uiIndex = 1u; uiIndex < BENCH_STATEMENTS; uiIndex++){
+    sprintf(pcName, "#%u", uiIndex - 1u);
+    ExpProgram_add(oExpProgram,\
+		   ExpTokenTree_newNode(ADD,\
+					ExpTokenTree_newNode(MULTIPLY,\
+					  ExpTokenTree_newLeaf(pcName),\
+					  ExpTokenTree_newLeaf("a_k")),\
+					ExpTokenTree_newLeaf("b")));
+  }
+  ctStart = clock();
+  ExpProgram_print(oExpProgram);
+  ExpOut_flush();
+  fprintf(stderr, "printed %u statements in %.3f s\n", BENCH_STATEMENTS,\
+	  (double)(clock() - ctStart) / CLOCKS_PER_SEC);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
@@ -0,0 +1,39 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expout.h describes the output layer every module prints to stdout    */
+/*through. Text is gathered in one large buffer and written a buffer at*/
+/*a time, rather than formatted and flushed token by token, and is     */
+/*always copied as it is, so an operand name is never read as a format */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPOUT_INCLUDED
+#define EXPOUT_INCLUDED
+
+/*---------------------------------------------------------------------*/
+/*Define the size of the output buffer, in chars                       */
+/*---------------------------------------------------------------------*/
+#define EXPOUT_BUFFER_SIZE 65536u
+
+/*---------------------------------------------------------------------*/
+/*Append the string pcString to the output                             */
+/*---------------------------------------------------------------------*/
+void ExpOut_string(const char* pcString);
+
+/*---------------------------------------------------------------------*/
+/*Append the char c to the output                                      */
+/*---------------------------------------------------------------------*/
+void ExpOut_char(char c);
+
+/*---------------------------------------------------------------------*/
+/*Append uiValue to the output in decimal                              */
+/*---------------------------------------------------------------------*/
+void ExpOut_unsigned(unsigned int uiValue);
+
+/*---------------------------------------------------------------------*/
+/*Write everything appended so far to stdout. The output must be       */
+/*flushed before the program exits, and before anything is printed to  */
+/*stdout other than through this layer                                 */
+/*---------------------------------------------------------------------*/
+void ExpOut_flush(void);
+
+#endif
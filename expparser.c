@@ -7,24 +7,111 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "expparser.h"
 #include "linklist.h"
 #include "exptokentreestack.h"
 #include "exptokenstack.h"
 #include "exptokentree.h"
 #include "exptoken.h"
+#include "expegraph.h"
+#include "exprecip.h"
+#include "exppower.h"
+#include "expsign.h"
+#include "expfold.h"
+#include "expbind.h"
+#include "expequiv.h"
+#include "expprogram.h"
+#include "exptopdown.h"
+#include "expbeam.h"
+#include "expbudget.h"
+#include "expbalance.h"
+#include "expstrength.h"
+#include "exppoly.h"
+#include "expsession.h"
+#include "expout.h"
+#include "expssa.h"
+#include "expcgen.h"
+#include "expsimd.h"
+#include "expslp.h"
+#include "expcpp.h"
+#include "expalloc.h"
+#include "expsched.h"
+#include "expfma.h"
 
 
 /*---------------------------------------------------------------------*/
 /*Define a character to signify that a variable is a new variable      */
 /*---------------------------------------------------------------------*/
-#define VAR_CHAR '#'
+#define VAR_CHAR EXPPROGRAM_TEMP_CHAR
+
+/*---------------------------------------------------------------------*/
+/*Define the default limits on equality saturation                     */
+/*---------------------------------------------------------------------*/
+#define EGRAPH_NODE_LIMIT 200000u
+#define EGRAPH_TIME_LIMIT 5.0
+
+/*---------------------------------------------------------------------*/
+/*Define the longest directive name or declaration read from the input */
+/*---------------------------------------------------------------------*/
+#define MAX_DIRECTIVE 64u
+
+/*---------------------------------------------------------------------*/
+/*Define the expression number meaning a session edit adds expressions */
+/*rather than replacing one                                            */
+/*---------------------------------------------------------------------*/
+#define NO_REPLACE (~0u)
+
+/*---------------------------------------------------------------------*/
+/*Define the default largest statement single use temporaries are      */
+/*inlined into, in operations                                          */
+/*---------------------------------------------------------------------*/
+#define INLINE_MAX_OPERATIONS 8u
+
+/*---------------------------------------------------------------------*/
+/*Define the default limits on the beam search over pairing orders     */
+/*---------------------------------------------------------------------*/
+#define BEAM_WIDTH 8u
+#define BEAM_TIME_LIMIT 2.0
+
+/*---------------------------------------------------------------------*/
+/*Define the share of the time and memory budget the passes before     */
+/*substitution may spend, so that substitution and the passes after it */
+/*always have the rest                                                 */
+/*---------------------------------------------------------------------*/
+#define SEARCH_SHARE 0.75
+
+/*---------------------------------------------------------------------*/
+/*Define the optimization level meaning no level was given, and the one*/
+/*meaning the level is chosen from the input                           */
+/*---------------------------------------------------------------------*/
+#define LEVEL_NONE -1
+#define LEVEL_AUTO 4
+
+/*---------------------------------------------------------------------*/
+/*Define the inputs the automatic level treats as small enough for the */
+/*search passes, in distinct subtrees, and for the algebraic passes, in*/
+/*nodes, and the share of distinct subtrees above which there is too   */
+/*little repetition for a search to find                               */
+/*---------------------------------------------------------------------*/
+#define AUTO_SEARCH_DISTINCT 2000u
+#define AUTO_ALGEBRAIC_NODES 200000u
+#define AUTO_DISTINCT_RATIO 0.9
 
 /*---------------------------------------------------------------------*/
 /*Define an enum type for states of the parsing DFA                    */
 /*---------------------------------------------------------------------*/
 enum DFAState {START, AFTER_OPERATOR, AFTER_OPERAND, ERROR, COMPLETE};
 
+/*---------------------------------------------------------------------*/
+/*Define an enum type for the formats the program may be written in:   */
+/*the text of the statements followed by the parser state, the static  */
+/*single assignment form in JSON or in binary, a C function, or a C    */
+/*kernel over a batch of instances                                     */
+/*---------------------------------------------------------------------*/
+enum EmitFormat {EMIT_TEXT, EMIT_JSON, EMIT_BINARY, EMIT_C, EMIT_SIMD,
+		EMIT_SLP, EMIT_CPP};
+
 /*---------------------------------------------------------------------*/
 /*ExpParsers have en exptoken for assembling multichar tokens, an      */
 /*an exptokenstack for storing operators during parsing, an            */
@@ -42,6 +129,74 @@ struct ExpParser
   ExpTokenTreeStack_T pettsOperandStack;
   /*storage for complete expressions*/
   LinkList_T pllExpressions;
+  /*values of known operands, or NULL if there are none*/
+  ExpBind_T oBind;
+  /*operand names declared equivalent, or NULL if there are none*/
+  ExpEquiv_T oEquiv;
+  /*time and memory budget, or NULL if there is none*/
+  ExpBudget_T oBudget;
+  /*the share of oBudget for the passes before substitution, or NULL*/
+  ExpBudget_T oSearchBudget;
+  /*operator costs for strength reduction, or NULL if it is not done*/
+  ExpStrength_T oStrength;
+  /*operation latencies for scheduling, or NULL if it is not done, and*/
+  /*the order scheduled for*/
+  ExpSched_T oSched;
+  enum ExpSchedMode esmSchedule;
+  /*configuration of the C function, or NULL if none was given*/
+  ExpCGen_T oCGen;
+  /*nonzero if constants are folded and identities removed*/
+  int iFold;
+  /*nonzero if polynomials are put into normal form*/
+  int iPoly;
+  /*nonzero if expressions are optimized by equality saturation*/
+  int iEGraph;
+  /*limits on equality saturation*/
+  unsigned int uiEGraphNodeLimit;
+  double dEGraphTimeLimit;
+  /*nonzero if signs are moved to canonical positions*/
+  int iSigns;
+  /*nonzero if integer powers are lowered into multiplication chains*/
+  int iPowers;
+  /*nonzero if reciprocals of repeated denominators are shared*/
+  int iReciprocal;
+  /*nonzero if the largest repeated subtrees are extracted first*/
+  int iTopDown;
+  /*nonzero if the size of the program and the time taken are reported*/
+  int iStats;
+  /*nonzero if single use temporaries are inlined into their user*/
+  int iInline;
+  /*largest statement a temporary is inlined into, in operations*/
+  unsigned int uiInlineMax;
+  /*nonzero if the pairing order of sums and products is searched*/
+  int iBeam;
+  /*states kept by the search, and its time limit*/
+  unsigned int uiBeamWidth;
+  double dBeamTimeLimit;
+  /*nonzero if sums and products are regrouped for a short critical path*/
+  int iBalance;
+  /*largest shared temporary copied to shorten it, in operations*/
+  unsigned int uiBalanceCopy;
+  /*nonzero if multiply-add pairs are fused, and if shared products are*/
+  /*copied into every sum they feed*/
+  int iFMA;
+  int iFMAAll;
+  /*nonzero if the program is held in a session and edited by the lines*/
+  /*after the expressions*/
+  int iSession;
+  /*format the program is written in*/
+  enum EmitFormat efEmit;
+  /*cache a tile of the batch kernel is kept within, in bytes*/
+  unsigned int uiSIMDCache;
+  unsigned int uiSLPWidth;
+  /*nonzero if results of the C function share locals, and the most*/
+  /*locals before the rest spill, or EXPALLOC_UNLIMITED*/
+  int iReuse;
+  unsigned int uiRegisters;
+  /*optimization level, LEVEL_NONE or LEVEL_AUTO*/
+  int iLevel;
+  /*nonzero if the trees are emitted without looking for common ones*/
+  int iEmitOnly;
 };
 
 /*---------------------------------------------------------------------*/
@@ -82,6 +237,42 @@ ExpParser_T ExpParser_new(void){
   }
   //The LinkList isn't initialized until a value needs to be stored
   oExpParser -> pllExpressions = NULL;
+  //optional optimizations are off until requested
+  oExpParser -> oBind = NULL;
+  oExpParser -> oEquiv = NULL;
+  oExpParser -> oBudget = NULL;
+  oExpParser -> oSearchBudget = NULL;
+  oExpParser -> oStrength = NULL;
+  oExpParser -> oSched = NULL;
+  oExpParser -> esmSchedule = EXPSCHED_LATENCY;
+  oExpParser -> oCGen = NULL;
+  oExpParser -> iFold = 0;
+  oExpParser -> iPoly = 0;
+  oExpParser -> iEGraph = 0;
+  oExpParser -> uiEGraphNodeLimit = EGRAPH_NODE_LIMIT;
+  oExpParser -> dEGraphTimeLimit = EGRAPH_TIME_LIMIT;
+  oExpParser -> iSigns = 0;
+  oExpParser -> iPowers = 0;
+  oExpParser -> iReciprocal = 0;
+  oExpParser -> iTopDown = 0;
+  oExpParser -> iStats = 0;
+  oExpParser -> iInline = 0;
+  oExpParser -> uiInlineMax = INLINE_MAX_OPERATIONS;
+  oExpParser -> iBeam = 0;
+  oExpParser -> uiBeamWidth = BEAM_WIDTH;
+  oExpParser -> dBeamTimeLimit = BEAM_TIME_LIMIT;
+  oExpParser -> iBalance = 0;
+  oExpParser -> uiBalanceCopy = 0u;
+  oExpParser -> iFMA = 0;
+  oExpParser -> iFMAAll = 0;
+  oExpParser -> iSession = 0;
+  oExpParser -> efEmit = EMIT_TEXT;
+  oExpParser -> uiSIMDCache = EXPSIMD_CACHE;
+  oExpParser -> uiSLPWidth = EXPSLP_WIDTH;
+  oExpParser -> iReuse = 0;
+  oExpParser -> uiRegisters = EXPALLOC_UNLIMITED;
+  oExpParser -> iLevel = LEVEL_NONE;
+  oExpParser -> iEmitOnly = 0;
   /*oExpParser -> pllExpressions = LinkList_new();
   if(oExpParser -> pllExpressions == NULL){
     ExpTokenTreeStack_free(oExpParser -> pettsOperandStack);
@@ -121,6 +312,27 @@ void ExpParser_free(ExpParser_T oExpParser){
     LinkList_free(oLinkList);
   }
   oExpParser -> pllExpressions = NULL;
+  if(oExpParser -> oBind != NULL)
+    ExpBind_free(oExpParser -> oBind);
+  oExpParser -> oBind = NULL;
+  if(oExpParser -> oEquiv != NULL)
+    ExpEquiv_free(oExpParser -> oEquiv);
+  oExpParser -> oEquiv = NULL;
+  if(oExpParser -> oBudget != NULL)
+    ExpBudget_free(oExpParser -> oBudget);
+  oExpParser -> oBudget = NULL;
+  if(oExpParser -> oSearchBudget != NULL)
+    ExpBudget_free(oExpParser -> oSearchBudget);
+  oExpParser -> oSearchBudget = NULL;
+  if(oExpParser -> oStrength != NULL)
+    ExpStrength_free(oExpParser -> oStrength);
+  oExpParser -> oStrength = NULL;
+  if(oExpParser -> oSched != NULL)
+    ExpSched_free(oExpParser -> oSched);
+  oExpParser -> oSched = NULL;
+  if(oExpParser -> oCGen != NULL)
+    ExpCGen_free(oExpParser -> oCGen);
+  oExpParser -> oCGen = NULL;
   free(oExpParser);
 }
 
@@ -418,25 +630,23 @@ static void ExpParser_print(ExpParser_T oExpParser){
   LinkList_T oLinkListPrint;
   unsigned int uiIndex = 0u;
   assert(oExpParser != NULL);
-  printf("---Assembly Token---\n");
-  fflush(stdout);
-  fprintf(stdout, "%s\n", ExpToken_toString(oExpParser -> petAssemble));
-  printf("---Operator Stack---\n");
-  fflush(stdout);
+  ExpOut_string("---Assembly Token---\n");
+  ExpOut_string(ExpToken_toString(oExpParser -> petAssemble));
+  ExpOut_char('\n');
+  ExpOut_string("---Operator Stack---\n");
   ExpTokenStack_print(oExpParser -> petsOperatorStack);
-  printf("---Operand Stack---\n");
-  fflush(stdout);
+  ExpOut_string("---Operand Stack---\n");
   ExpTokenTreeStack_print(oExpParser -> pettsOperandStack);
-  printf("---Expression List---\n");
-  fflush(stdout);
+  ExpOut_string("---Expression List---\n");
   for(oLinkListPrint = oExpParser -> pllExpressions;
       oLinkListPrint != NULL;
       oLinkListPrint = LinkList_getNext(oLinkListPrint)){
-    fprintf(stdout, "---Expression %u---\n", uiIndex);
-    fflush(stdout);
+    ExpOut_string("---Expression ");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string("---\n");
     uiIndex++;
     ExpTokenTree_print((TreeNode_T)LinkList_getValue(oLinkListPrint));
-    printf("\n");
+    ExpOut_char('\n');
   }
 }
 
@@ -1186,23 +1396,834 @@ static int ExpParser_replace(ExpParser_T oExpParser,\
   return 0;
 }
 
+/*---------------------------------------------------------------------*/
+/*Replace the bound operands in pllExpressions with their values, and  */
+/*print the number replaced to stderr. Return 0 if successful, 1 if    */
+/*memory was insufficient                                              */
+/*---------------------------------------------------------------------*/
+static int ExpParser_bind(ExpParser_T oExpParser){
+  unsigned int uiBound;
+  int iResult;
+  assert(oExpParser != NULL);
+  assert(oExpParser -> oBind != NULL);
+  iResult = ExpBind_apply(oExpParser -> oBind,\
+			  oExpParser -> pllExpressions, &uiBound);
+  fprintf(stderr, "ExpParser_bind: %u operands bound\n", uiBound);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rename the operands in pllExpressions to the representatives of their*/
+/*equivalence classes, and print the number renamed to stderr          */
+/*---------------------------------------------------------------------*/
+static void ExpParser_equiv(ExpParser_T oExpParser){
+  unsigned int uiRenamed;
+  assert(oExpParser != NULL);
+  assert(oExpParser -> oEquiv != NULL);
+  ExpEquiv_apply(oExpParser -> oEquiv, oExpParser -> pllExpressions,\
+		 &uiRenamed);
+  fprintf(stderr, "ExpParser_equiv: %u operands renamed\n", uiRenamed);
+}
+
+/*---------------------------------------------------------------------*/
+/*Fold the constants and remove the identity operations in             */
+/*pllExpressions. Print the number of operations before and after to   */
+/*stderr. Return 0 if successful, 1 if memory was insufficient         */
+/*---------------------------------------------------------------------*/
+static int ExpParser_fold(ExpParser_T oExpParser){
+  unsigned int uiBefore, uiAfter;
+  int iResult;
+  assert(oExpParser != NULL);
+  iResult = ExpFold_apply(oExpParser -> pllExpressions,\
+			  &uiBefore, &uiAfter);
+  fprintf(stderr, "ExpParser_fold: %u -> %u operations\n",\
+	  uiBefore, uiAfter);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Fold the twig oTreeNodeFind about to be substituted by               */
+/*ExpParser_simplify. If folding removes an operation, replace the twig*/
+/*by its folded form in every expression instead and return 1. Return 0*/
+/*if the twig must be substituted as usual                             */
+/*---------------------------------------------------------------------*/
+static int ExpParser_foldTwig(ExpParser_T oExpParser,\
+			      TreeNode_T oTreeNodeFind){
+  TreeNode_T oTreeNodeFolded;
+  int iFolded = 0;
+  assert(oExpParser != NULL);
+  assert(oTreeNodeFind != NULL);
+  oTreeNodeFolded = ExpFold_tree(oTreeNodeFind);
+  if(oTreeNodeFolded == NULL)
+    return 0;
+  //fewer operations every time guarantees the substitution loop ends
+  if(ExpFold_countOperations(oTreeNodeFolded) <\
+     ExpFold_countOperations(oTreeNodeFind))
+    iFolded = (ExpParser_replace(oExpParser, oTreeNodeFind,\
+				 oTreeNodeFolded) == 0);
+  ExpTokenTree_free(oTreeNodeFolded);
+  return iFolded;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the temporary oTreeNodeFind by oTreeNodeReplace in the       */
+/*statements of oExpProgram from uiFirst on and in pllExpressions.     */
+/*Return 0 if successful, 1 if memory was insufficient, in which case  */
+/*the trees not yet replaced still use the temporary                   */
+/*---------------------------------------------------------------------*/
+static int ExpParser_substitute(ExpParser_T oExpParser,\
+				ExpProgram_T oExpProgram, unsigned int uiFirst,\
+				TreeNode_T oTreeNodeFind,\
+				TreeNode_T oTreeNodeReplace){
+  LinkList_T oLinkListTree;
+  TreeNode_T oTreeNodeNew;
+  unsigned int uiIndex;
+  for(uiIndex = uiFirst; uiIndex < ExpProgram_howMany(oExpProgram);
+      uiIndex++){
+    oTreeNodeNew = ExpTokenTree_replace\
+      (ExpProgram_getValue(oExpProgram, uiIndex), oTreeNodeFind,\
+       oTreeNodeReplace);
+    if(oTreeNodeNew == NULL)
+      return 1;
+    ExpTokenTree_free(ExpProgram_take(oExpProgram, uiIndex));
+    ExpProgram_put(oExpProgram, uiIndex, oTreeNodeNew);
+  }
+  for(oLinkListTree = oExpParser -> pllExpressions;
+      oLinkListTree != NULL;
+      oLinkListTree = LinkList_getNext(oLinkListTree)){
+    oTreeNodeNew =\
+      ExpTokenTree_replace((TreeNode_T)LinkList_getValue(oLinkListTree),\
+			   oTreeNodeFind, oTreeNodeReplace);
+    if(oTreeNodeNew == NULL)
+      return 1;
+    ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkListTree));
+    LinkList_setValue(oLinkListTree, oTreeNodeNew);
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Fold the statements of oExpProgram written by the top-down strategy, */
+/*as ExpParser_foldTwig folds the twigs of the bottom-up one, keeping a*/
+/*folded statement only if it has fewer operations. A statement folded */
+/*to an operand is put in place of its temporary wherever it is used   */
+/*and removed, and the temporaries are renumbered. Print the operations*/
+/*before and after to stderr. Return 0 if successful, 1 if memory was  */
+/*insufficient, in which case the program is left valid                */
+/*---------------------------------------------------------------------*/
+static int ExpParser_foldStatements(ExpParser_T oExpParser,\
+				    ExpProgram_T oExpProgram){
+  TreeNode_T oTreeNode, oTreeNodeFolded, oTreeNodeTemp;
+  unsigned int* puiNumbers;
+  unsigned int uiIndex, uiBefore, uiRemoved = 0u;
+  int iResult = 0;
+  assert(oExpParser != NULL);
+  assert(oExpProgram != NULL);
+  uiBefore = ExpProgram_countOperations(oExpProgram);
+  puiNumbers = (unsigned int*)malloc((ExpProgram_howMany(oExpProgram) +\
+				      1u) * sizeof(unsigned int));
+  if(puiNumbers == NULL)
+    return 1;
+  //a statement only uses those before it, so they are folded first
+  for(uiIndex = 0u;
+      uiIndex < ExpProgram_howMany(oExpProgram) && iResult == 0;
+      uiIndex++){
+    oTreeNode = ExpProgram_getValue(oExpProgram, uiIndex);
+    oTreeNodeFolded = ExpFold_tree(oTreeNode);
+    if(oTreeNodeFolded == NULL){
+      iResult = 1;
+      break;
+    }
+    if(ExpFold_countOperations(oTreeNodeFolded) >=\
+       ExpFold_countOperations(oTreeNode)){
+      ExpTokenTree_free(oTreeNodeFolded);
+      continue;
+    }
+    if(ExpTokenTree_getChildren(oTreeNodeFolded) != NULL){
+      ExpTokenTree_free(ExpProgram_take(oExpProgram, uiIndex));
+      ExpProgram_put(oExpProgram, uiIndex, oTreeNodeFolded);
+      continue;
+    }
+    //the statement is only removed once nothing uses its temporary
+    oTreeNodeTemp = ExpParser_makeNewVar(uiIndex);
+    if(oTreeNodeTemp == NULL ||\
+       ExpParser_substitute(oExpParser, oExpProgram, uiIndex + 1u,\
+			    oTreeNodeTemp, oTreeNodeFolded) != 0)
+      iResult = 1;
+    else{
+      ExpTokenTree_free(ExpProgram_take(oExpProgram, uiIndex));
+      uiRemoved++;
+    }
+    if(oTreeNodeTemp != NULL)
+      ExpTokenTree_free(oTreeNodeTemp);
+    ExpTokenTree_free(oTreeNodeFolded);
+  }
+  if(uiRemoved != 0u)
+    ExpProgram_compact(oExpProgram, oExpParser -> pllExpressions,\
+		       puiNumbers);
+  free(puiNumbers);
+  fprintf(stderr, "ExpParser_foldStatements: %u -> %u operations\n",\
+	  uiBefore, ExpProgram_countOperations(oExpProgram));
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the cost of evaluating all of the trees stored in the list    */
+/*pllTrees with every common subexpression computed only once, which is*/
+/*what ExpParser_simplify will emit for them. Return 0 if memory is    */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static unsigned long ExpParser_sharedCost(LinkList_T pllTrees){
+  ExpEGraph_T oExpEGraph;
+  LinkList_T oLinkList;
+  unsigned long ulCost;
+  oExpEGraph = ExpEGraph_new(0u, 0.0);
+  if(oExpEGraph == NULL)
+    return 0ul;
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    if(ExpEGraph_addTree(oExpEGraph,\
+			 (TreeNode_T)LinkList_getValue(oLinkList)) < 0){
+      ExpEGraph_free(oExpEGraph);
+      return 0ul;
+    }
+  }
+  ulCost = ExpEGraph_totalCost(oExpEGraph);
+  ExpEGraph_free(oExpEGraph);
+  return ulCost;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the trees stored in the list pllTrees along with the list       */
+/*---------------------------------------------------------------------*/
+static void ExpParser_freeTrees(LinkList_T pllTrees){
+  LinkList_T oLinkList, oLinkListNext;
+  for(oLinkList = pllTrees; oLinkList != NULL; oLinkList = oLinkListNext){
+    oLinkListNext = LinkList_getNext(oLinkList);
+    if(LinkList_getValue(oLinkList) != NULL)
+      ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkList));
+    LinkList_free(oLinkList);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of nodes, operands included, in oTreeNode          */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpParser_countNodes(TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned int uiNodes = 1u;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    uiNodes += ExpParser_countNodes((TreeNode_T)LinkList_getValue(oLinkList));
+  return uiNodes;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the number of nodes in pllExpressions in puiNodes, and the     */
+/*number of distinct subtrees among them, up to the order of the       */
+/*operands of + and *, in puiDistinct. Return 0 if successful, 1 if    */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpParser_measure(ExpParser_T oExpParser, unsigned int* puiNodes,\
+			     unsigned int* puiDistinct){
+  ExpEGraph_T oExpEGraph;
+  LinkList_T oLinkList;
+  assert(oExpParser != NULL);
+  *puiNodes = 0u;
+  *puiDistinct = 0u;
+  //an e-graph that is never saturated is a hash consing of the trees
+  oExpEGraph = ExpEGraph_new(0u, 0.0);
+  if(oExpEGraph == NULL)
+    return 1;
+  for(oLinkList = oExpParser -> pllExpressions;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    *puiNodes +=\
+      ExpParser_countNodes((TreeNode_T)LinkList_getValue(oLinkList));
+    if(ExpEGraph_addTree(oExpEGraph,\
+			 (TreeNode_T)LinkList_getValue(oLinkList)) < 0){
+      ExpEGraph_free(oExpEGraph);
+      return 1;
+    }
+  }
+  *puiDistinct = ExpEGraph_numNodes(oExpEGraph);
+  ExpEGraph_free(oExpEGraph);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Turn on the passes of optimization level iLevel, from 0 to 3, in     */
+/*addition to any requested on their own. -O0 emits the trees as they  */
+/*are, -O1 extracts common subtrees by hashing, -O2 adds the algebraic */
+/*passes and -O3 the searches                                          */
+/*---------------------------------------------------------------------*/
+static void ExpParser_setLevel(ExpParser_T oExpParser, int iLevel){
+  assert(oExpParser != NULL);
+  assert(iLevel >= 0 && iLevel <= 3);
+  oExpParser -> iLevel = iLevel;
+  if(iLevel == 0){
+    oExpParser -> iEmitOnly = 1;
+    return;
+  }
+  oExpParser -> iTopDown = 1;
+  if(iLevel >= 2){
+    oExpParser -> iFold = 1;
+    oExpParser -> iSigns = 1;
+    oExpParser -> iPowers = 1;
+    oExpParser -> iReciprocal = 1;
+  }
+  if(iLevel >= 3){
+    oExpParser -> iEGraph = 1;
+    oExpParser -> iBeam = 1;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Choose the optimization level from the size of pllExpressions. The   */
+/*searches work on shared graphs, so they are used when the distinct   */
+/*subtrees are few and repeated often; the algebraic passes work on the*/
+/*trees, so they are used while the nodes are few enough; and anything */
+/*larger only gets the linear time extraction. Print the choice to     */
+/*stderr                                                               */
+/*---------------------------------------------------------------------*/
+static void ExpParser_autoLevel(ExpParser_T oExpParser){
+  unsigned int uiNodes, uiDistinct;
+  int iLevel = 1;
+  assert(oExpParser != NULL);
+  //without a measurement only the cheapest level is safe
+  if(ExpParser_measure(oExpParser, &uiNodes, &uiDistinct) != 0)
+    fprintf(stderr, "%s", "ExpParser_autoLevel: insufficient memory\n");
+  else if(uiDistinct <= AUTO_SEARCH_DISTINCT &&\
+	  (double)uiDistinct < AUTO_DISTINCT_RATIO * (double)uiNodes)
+    iLevel = 3;
+  else if(uiNodes <= AUTO_ALGEBRAIC_NODES)
+    iLevel = 2;
+  ExpParser_setLevel(oExpParser, iLevel);
+  fprintf(stderr, "ExpParser_autoLevel: %u nodes, %u distinct, -O%d\n",\
+	  uiNodes, uiDistinct, iLevel);
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the trees in pllExpressions by the cheapest equivalent trees */
+/*found by equality saturation. All of the expressions share one       */
+/*e-graph, so equal subexpressions are extracted identically and are   */
+/*then shared by ExpParser_simplify. The replacement only happens if it*/
+/*lowers the shared cost of the expressions. Print a summary to stderr.*/
+/*Return 0 if successful, 1 if memory was insufficient, in which case  */
+/*pllExpressions is left unchanged                                     */
+/*---------------------------------------------------------------------*/
+static int ExpParser_egraph(ExpParser_T oExpParser){
+  ExpEGraph_T oExpEGraph;
+  LinkList_T oLinkList, oLinkListNew, pllExtracted, oLinkListLast;
+  TreeNode_T* ppTrees;
+  int* piClasses;
+  unsigned int uiNumExpressions, uiIndex;
+  unsigned long ulCostBefore, ulCostAfter;
+  int iIterations;
+  assert(oExpParser != NULL);
+  uiNumExpressions = LinkList_getLength(oExpParser -> pllExpressions);
+  if(uiNumExpressions == 0u)
+    return 0;
+  oExpEGraph = ExpEGraph_new(oExpParser -> uiEGraphNodeLimit,\
+			     oExpParser -> dEGraphTimeLimit);
+  if(oExpEGraph == NULL)
+    return 1;
+  ExpEGraph_setBudget(oExpEGraph, oExpParser -> oSearchBudget);
+  piClasses = (int*)malloc(uiNumExpressions * sizeof(int));
+  if(piClasses == NULL){
+    ExpEGraph_free(oExpEGraph);
+    return 1;
+  }
+  //add every expression to the shared graph
+  for(oLinkList = oExpParser -> pllExpressions, uiIndex = 0u;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList), uiIndex++){
+    piClasses[uiIndex] =\
+      ExpEGraph_addTree(oExpEGraph,\
+			(TreeNode_T)LinkList_getValue(oLinkList));
+    if(piClasses[uiIndex] < 0){
+      free(piClasses);
+      ExpEGraph_free(oExpEGraph);
+      return 1;
+    }
+  }
+  //saturate, a memory failure still leaves a usable graph
+  iIterations = ExpEGraph_saturate(oExpEGraph);
+  //extract the cheapest forms of the expressions together
+  for(uiIndex = 0u; uiIndex < uiNumExpressions; uiIndex++)
+    piClasses[uiIndex] = ExpEGraph_find(oExpEGraph, piClasses[uiIndex]);
+  ppTrees = (TreeNode_T*)malloc(uiNumExpressions * sizeof(TreeNode_T));
+  if(ppTrees == NULL ||\
+     ExpEGraph_extractAll(oExpEGraph, piClasses, uiNumExpressions,\
+			  ppTrees) != 0){
+    free(ppTrees);
+    free(piClasses);
+    ExpEGraph_free(oExpEGraph);
+    return 1;
+  }
+  //then move them into a new list
+  pllExtracted = NULL;
+  oLinkListLast = NULL;
+  for(uiIndex = 0u; uiIndex < uiNumExpressions; uiIndex++){
+    oLinkListNew = LinkList_new();
+    if(oLinkListNew == NULL){
+      for(; uiIndex < uiNumExpressions; uiIndex++)
+	ExpTokenTree_free(ppTrees[uiIndex]);
+      ExpParser_freeTrees(pllExtracted);
+      free(ppTrees);
+      free(piClasses);
+      ExpEGraph_free(oExpEGraph);
+      return 1;
+    }
+    LinkList_setValue(oLinkListNew, ppTrees[uiIndex]);
+    if(pllExtracted == NULL)
+      pllExtracted = oLinkListNew;
+    else
+      LinkList_setNext(oLinkListLast, oLinkListNew);
+    oLinkListLast = oLinkListNew;
+  }
+  fprintf(stderr, "ExpParser_egraph: %d iterations%s, %u nodes, "\
+	  "%u classes", iIterations,\
+	  ExpEGraph_stopped(oExpEGraph) ? " (stopped at a limit)" : "",\
+	  ExpEGraph_numNodes(oExpEGraph), ExpEGraph_numClasses(oExpEGraph));
+  free(ppTrees);
+  free(piClasses);
+  ExpEGraph_free(oExpEGraph);
+  //keep whichever set of expressions is cheaper once shared
+  ulCostBefore = ExpParser_sharedCost(oExpParser -> pllExpressions);
+  ulCostAfter = ExpParser_sharedCost(pllExtracted);
+  fprintf(stderr, ", shared cost %lu -> %lu\n", ulCostBefore,\
+	  (ulCostAfter < ulCostBefore) ? ulCostAfter : ulCostBefore);
+  if(ulCostAfter != 0ul && ulCostAfter < ulCostBefore){
+    ExpParser_freeTrees(oExpParser -> pllExpressions);
+    oExpParser -> pllExpressions = pllExtracted;
+  }
+  else
+    ExpParser_freeTrees(pllExtracted);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Put the polynomial expressions in pllExpressions into normal form,   */
+/*and make the ones with equal normal forms identical. Print how many  */
+/*are polynomials and duplicates, and the operations before and after, */
+/*to stderr. Return 0 if successful, 1 if memory was insufficient      */
+/*---------------------------------------------------------------------*/
+static int ExpParser_poly(ExpParser_T oExpParser){
+  unsigned int uiPolynomials, uiDuplicates, uiBefore, uiAfter;
+  int iResult;
+  assert(oExpParser != NULL);
+  iResult = ExpPoly_apply(oExpParser -> pllExpressions, &uiPolynomials,\
+			  &uiDuplicates, &uiBefore, &uiAfter);
+  fprintf(stderr, "ExpParser_poly: %u of %u expressions polynomial, "\
+	  "%u duplicates, %u -> %u operations\n", uiPolynomials,\
+	  LinkList_getLength(oExpParser -> pllExpressions), uiDuplicates,\
+	  uiBefore, uiAfter);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Move the signs in pllExpressions to canonical positions so that      */
+/*differently signed forms of a subexpression can share one variable.  */
+/*Print the number of negations before and after to stderr. Return 0 if*/
+/*successful, 1 if memory was insufficient                             */
+/*---------------------------------------------------------------------*/
+static int ExpParser_signs(ExpParser_T oExpParser){
+  unsigned int uiBefore, uiAfter;
+  int iResult;
+  assert(oExpParser != NULL);
+  iResult = ExpSign_apply(oExpParser -> pllExpressions,\
+			  &uiBefore, &uiAfter);
+  fprintf(stderr, "ExpParser_signs: %u -> %u negations\n",\
+	  uiBefore, uiAfter);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Lower the integer powers in pllExpressions into shared multiplication*/
+/*chains. Print the number of powers lowered and the multiplications   */
+/*that replace them to stderr. Return 0 if successful, 1 if memory was */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpParser_powers(ExpParser_T oExpParser){
+  unsigned int uiPowers, uiMultiplies;
+  int iResult;
+  assert(oExpParser != NULL);
+  iResult = ExpPower_apply(oExpParser -> pllExpressions,\
+			   &uiPowers, &uiMultiplies);
+  fprintf(stderr, "ExpParser_powers: %u powers -> %u multiplies\n",\
+	  uiPowers, uiMultiplies);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Merge fractions over common denominators in pllExpressions and share */
+/*the reciprocals of repeated denominators. Print the number of        */
+/*division operations before and after to stderr. Return 0 if          */
+/*successful, 1 if memory was insufficient                             */
+/*---------------------------------------------------------------------*/
+static int ExpParser_reciprocal(ExpParser_T oExpParser){
+  unsigned int uiBefore, uiAfter;
+  int iResult;
+  assert(oExpParser != NULL);
+  iResult = ExpRecip_apply(oExpParser -> pllExpressions,\
+			   &uiBefore, &uiAfter);
+  fprintf(stderr, "ExpParser_reciprocal: %u -> %u divisions\n",\
+	  uiBefore, uiAfter);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Search for the pairing order of the sums and products in             */
+/*pllExpressions that shares the most. Print the number of operations */
+/*before and after to stderr. Return 0 if successful, 1 if memory was  */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpParser_beam(ExpParser_T oExpParser){
+  unsigned int uiBefore, uiAfter;
+  int iResult;
+  assert(oExpParser != NULL);
+  iResult = ExpBeam_apply(oExpParser -> pllExpressions,\
+			  oExpParser -> uiBeamWidth,\
+			  oExpParser -> dBeamTimeLimit,\
+			  oExpParser -> oSearchBudget,\
+			  &uiBefore, &uiAfter);
+  fprintf(stderr, "ExpParser_beam: %u -> %u operations\n",\
+	  uiBefore, uiAfter);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the budget of oExpParser allows the pass pcPass to run,  */
+/*or else print that it was skipped to stderr and return 0             */
+/*---------------------------------------------------------------------*/
+static int ExpParser_withinBudget(ExpParser_T oExpParser,\
+				  const char* pcPass){
+  assert(oExpParser != NULL);
+  if(ExpBudget_isExhausted(oExpParser -> oBudget) == 0)
+    return 1;
+  fprintf(stderr, "%s: budget exhausted, skipped\n", pcPass);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the share of the budget of oExpParser for the passes     */
+/*before substitution allows the pass pcPass to run, or else print that*/
+/*it was skipped to stderr and return 0                                */
+/*---------------------------------------------------------------------*/
+static int ExpParser_withinSearchBudget(ExpParser_T oExpParser,\
+					const char* pcPass){
+  assert(oExpParser != NULL);
+  if(ExpBudget_isExhausted(oExpParser -> oSearchBudget) == 0)
+    return 1;
+  fprintf(stderr, "%s: budget exhausted, skipped\n", pcPass);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Run every optimization enabled in oExpParser over pllExpressions, in */
+/*order, before they are simplified. A pass that runs out of memory    */
+/*leaves the expressions valid, so the remaining passes still run. Once*/
+/*their share of the budget is exhausted the remaining passes are      */
+/*skipped, except for bindings and equivalences, which are cheap and   */
+/*change the meaning of the operands                                   */
+/*---------------------------------------------------------------------*/
+static void ExpParser_optimize(ExpParser_T oExpParser){
+  assert(oExpParser != NULL);
+  if(oExpParser -> iLevel == LEVEL_AUTO)
+    ExpParser_autoLevel(oExpParser);
+  if(oExpParser -> oBind != NULL && ExpParser_bind(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  if(oExpParser -> oEquiv != NULL){
+    ExpParser_equiv(oExpParser);
+    //renaming may turn an operand into one that is bound
+    if(oExpParser -> oBind != NULL && ExpParser_bind(oExpParser) != 0)
+      fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  }
+  if(oExpParser -> iFold != 0 &&\
+     ExpParser_withinSearchBudget(oExpParser, "ExpParser_fold") &&\
+     ExpParser_fold(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  if(oExpParser -> iPoly != 0 &&\
+     ExpParser_withinSearchBudget(oExpParser, "ExpParser_poly") &&\
+     ExpParser_poly(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  if(oExpParser -> iEGraph != 0 &&\
+     ExpParser_withinSearchBudget(oExpParser, "ExpParser_egraph") &&\
+     ExpParser_egraph(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  if(oExpParser -> iSigns != 0 &&\
+     ExpParser_withinSearchBudget(oExpParser, "ExpParser_signs") &&\
+     ExpParser_signs(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  if(oExpParser -> iPowers != 0 &&\
+     ExpParser_withinSearchBudget(oExpParser, "ExpParser_powers") &&\
+     ExpParser_powers(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  if(oExpParser -> iReciprocal != 0 &&\
+     ExpParser_withinSearchBudget(oExpParser, "ExpParser_reciprocal") &&\
+     ExpParser_reciprocal(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+  if(oExpParser -> iBeam != 0 &&\
+     ExpParser_withinSearchBudget(oExpParser, "ExpParser_beam") &&\
+     ExpParser_beam(oExpParser) != 0)
+    fprintf(stderr, "%s", "ExpParser_optimize: insufficient memory\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Give every expression in pllExpressions that is not yet a single     */
+/*operand a statement of its own in oExpProgram, and replace it by the */
+/*temporary. This is the plain emission of the trees, used for whatever*/
+/*is left when simplifying stops early. Return 0 if successful, 1 if   */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpParser_emitRemaining(ExpParser_T oExpParser,\
+				   ExpProgram_T oExpProgram){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNode, oTreeNodeVar;
+  assert(oExpParser != NULL);
+  assert(oExpProgram != NULL);
+  for(oLinkList = oExpParser -> pllExpressions;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNode = (TreeNode_T)LinkList_getValue(oLinkList);
+    if(TreeNode_isLeaf(oTreeNode))
+      continue;
+    oTreeNodeVar = ExpParser_makeNewVar(ExpProgram_howMany(oExpProgram));
+    if(oTreeNodeVar == NULL)
+      return 1;
+    //the program takes the tree, and the list takes the temporary
+    if(ExpProgram_add(oExpProgram, oTreeNode) != 0){
+      ExpTokenTree_free(oTreeNodeVar);
+      return 1;
+    }
+    LinkList_setValue(oLinkList, oTreeNodeVar);
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Regroup the sums and products of oExpProgram for a short critical   */
+/*path. Print the critical path before and after, and the operations   */
+/*added by copies, to stderr                                           */
+/*---------------------------------------------------------------------*/
+static void ExpParser_balance(ExpParser_T oExpParser,\
+			      ExpProgram_T oExpProgram){
+  unsigned int uiBefore, uiAfter, uiCopied;
+  assert(oExpParser != NULL);
+  if(ExpBalance_apply(oExpProgram, oExpParser -> pllExpressions,\
+		      oExpParser -> uiBalanceCopy, &uiBefore, &uiAfter,\
+		      &uiCopied) != 0)
+    fprintf(stderr, "%s", "ExpParser_balance: insufficient memory\n");
+  fprintf(stderr, "ExpParser_balance: critical path %u -> %u, "\
+	  "%u operations copied\n", uiBefore, uiAfter, uiCopied);
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the operations of oExpProgram by cheaper equivalents under   */
+/*the operator costs of the target. Print the number of rewrites and   */
+/*the cost before and after to stderr                                  */
+/*---------------------------------------------------------------------*/
+static void ExpParser_strength(ExpParser_T oExpParser,\
+			       ExpProgram_T oExpProgram){
+  unsigned long ulBefore;
+  unsigned int uiRewrites;
+  assert(oExpParser != NULL);
+  assert(oExpParser -> oStrength != NULL);
+  ulBefore = ExpStrength_cost(oExpParser -> oStrength, oExpProgram);
+  if(ExpStrength_apply(oExpParser -> oStrength, oExpProgram,\
+		       &uiRewrites) != 0)
+    fprintf(stderr, "%s", "ExpParser_strength: insufficient memory\n");
+  fprintf(stderr, "ExpParser_strength: %u rewrites, cost %lu -> %lu\n",\
+	  uiRewrites, ulBefore,\
+	  ExpStrength_cost(oExpParser -> oStrength, oExpProgram));
+}
+
+/*---------------------------------------------------------------------*/
+/*Contract the multiply-add pairs of oExpProgram into fused            */
+/*multiply-adds. Print the number fused and the operations before and  */
+/*after to stderr                                                      */
+/*---------------------------------------------------------------------*/
+static void ExpParser_contract(ExpParser_T oExpParser,\
+			       ExpProgram_T oExpProgram){
+  unsigned int uiBefore, uiContracted;
+  assert(oExpParser != NULL);
+  uiBefore = ExpProgram_countOperations(oExpProgram);
+  if(ExpFMA_contract(oExpProgram, oExpParser -> pllExpressions,\
+		     oExpParser -> iFMAAll, &uiContracted) != 0)
+    fprintf(stderr, "%s", "ExpParser_contract: insufficient memory\n");
+  fprintf(stderr, "ExpParser_contract: %u multiply-adds fused, "\
+	  "%u -> %u operations\n", uiContracted, uiBefore,\
+	  ExpProgram_countOperations(oExpProgram));
+}
+
+/*---------------------------------------------------------------------*/
+/*Pack the instructions of oExpSSA into vectors and print them to      */
+/*stdout as a C function configured by the C function of oExpParser.   */
+/*Print the operations packed, and how many operand vectors are        */
+/*reordered or built lane by lane, to stderr. Return 0 if successful,  */
+/*1 if memory is insufficient, -1 if the function cannot be written as */
+/*configured                                                           */
+/*---------------------------------------------------------------------*/
+static int ExpParser_slp(ExpParser_T oExpParser, ExpSSA_T oExpSSA){
+  ExpSLP_T oExpSLP;
+  unsigned int uiPacked, uiPacks, uiPermutes, uiGathers;
+  int iResult;
+  assert(oExpParser != NULL);
+  oExpSLP = ExpSLP_new(oExpSSA, oExpParser -> uiSLPWidth);
+  if(oExpSLP == NULL){
+    fprintf(stderr, "%s", "ExpParser_slp: insufficient memory\n");
+    return 1;
+  }
+  ExpSLP_counts(oExpSLP, &uiPacked, &uiPacks, &uiPermutes, &uiGathers);
+  fprintf(stderr, "ExpParser_slp: %u of %u operations packed into %u "\
+	  "vectors, %u permuted and %u gathered operands\n", uiPacked,\
+	  ExpSSA_instructions(oExpSSA), uiPacks, uiPermutes, uiGathers);
+  iResult = ExpSLP_print(oExpSLP, oExpParser -> oCGen);
+  if(iResult == 1)
+    fprintf(stderr, "%s", "ExpParser_slp: insufficient memory\n");
+  ExpSLP_free(oExpSLP);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Place the results of the instructions of oExpSSA in shared locals,   */
+/*within the budget of registers of oExpParser, and print it to stdout */
+/*as a C function configured by the C function of oExpParser. Print the*/
+/*most results live at once, the registers and scratch slots used and  */
+/*the results spilled to stderr. Return 0 if successful, 1 if memory is*/
+/*insufficient, -1 if the function cannot be written as configured     */
+/*---------------------------------------------------------------------*/
+static int ExpParser_reuse(ExpParser_T oExpParser, ExpSSA_T oExpSSA){
+  ExpAlloc_T oExpAlloc;
+  unsigned int uiMaxLive, uiRegisters, uiScratch, uiSpilled;
+  int iResult;
+  assert(oExpParser != NULL);
+  oExpAlloc = ExpAlloc_new(oExpSSA, oExpParser -> uiRegisters);
+  if(oExpAlloc == NULL){
+    fprintf(stderr, "%s", "ExpParser_reuse: insufficient memory\n");
+    return 1;
+  }
+  ExpAlloc_counts(oExpAlloc, &uiMaxLive, &uiRegisters, &uiScratch,\
+		  &uiSpilled);
+  fprintf(stderr, "ExpParser_reuse: %u temporaries, at most %u live, in "\
+	  "%u registers and %u scratch slots, %u spilled\n",\
+	  ExpSSA_instructions(oExpSSA), uiMaxLive, uiRegisters, uiScratch,\
+	  uiSpilled);
+  iResult = ExpCGen_printAllocated(oExpParser -> oCGen, oExpSSA, oExpAlloc);
+  if(iResult == 1)
+    fprintf(stderr, "%s", "ExpParser_reuse: insufficient memory\n");
+  ExpAlloc_free(oExpAlloc);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Reorder the instructions of oExpSSA for the schedule of oExpParser.  */
+/*Print the most results live at once and the cycles taken on the      */
+/*modelled machine, before and after, to stderr                        */
+/*---------------------------------------------------------------------*/
+static void ExpParser_schedule(ExpParser_T oExpParser, ExpSSA_T oExpSSA){
+  ExpAlloc_T oExpAlloc;
+  unsigned int puiMaxLive[2], uiRegisters, uiScratch, uiSpilled, ui;
+  unsigned long pulCycles[2];
+  assert(oExpParser != NULL);
+  assert(oExpParser -> oSched != NULL);
+  for(ui = 0u; ui < 2u; ui++){
+    if(ui == 1u && ExpSched_apply(oExpParser -> oSched, oExpSSA,\
+				  oExpParser -> esmSchedule) == 1){
+      fprintf(stderr, "%s", "ExpParser_schedule: insufficient memory\n");
+      return;
+    }
+    oExpAlloc = ExpAlloc_new(oExpSSA, EXPALLOC_UNLIMITED);
+    if(oExpAlloc == NULL){
+      fprintf(stderr, "%s", "ExpParser_schedule: insufficient memory\n");
+      return;
+    }
+    ExpAlloc_counts(oExpAlloc, &puiMaxLive[ui], &uiRegisters, &uiScratch,\
+		    &uiSpilled);
+    ExpAlloc_free(oExpAlloc);
+    pulCycles[ui] = ExpSched_cycles(oExpParser -> oSched, oExpSSA);
+  }
+  fprintf(stderr, "ExpParser_schedule: at most %u -> %u live, %lu -> %lu "\
+	  "cycles\n", puiMaxLive[0], puiMaxLive[1], pulCycles[0],\
+	  pulCycles[1]);
+}
+
+/*---------------------------------------------------------------------*/
+/*Write oExpProgram, whose outputs are the trees in pllExpressions, to */
+/*stdout in the static single assignment form, in the format chosen. If*/
+/*an error occurs, print an informative message to stderr. Return 0 if */
+/*successful, 1 if memory is insufficient, -1 if the program cannot be */
+/*written as configured                                                */
+/*---------------------------------------------------------------------*/
+static int ExpParser_emit(ExpParser_T oExpParser, ExpProgram_T oExpProgram){
+  ExpSSA_T oExpSSA;
+  int iResult = 0;
+  assert(oExpParser != NULL);
+  oExpSSA = ExpSSA_new(oExpProgram, oExpParser -> pllExpressions);
+  if(oExpSSA == NULL){
+    fprintf(stderr, "%s", "ExpParser_emit: insufficient memory\n");
+    return 1;
+  }
+  if(oExpParser -> oSched != NULL)
+    ExpParser_schedule(oExpParser, oExpSSA);
+  if(oExpParser -> efEmit == EMIT_JSON)
+    ExpSSA_printJSON(oExpSSA);
+  else if(oExpParser -> efEmit == EMIT_BINARY)
+    ExpSSA_writeBinary(oExpSSA);
+  else if(oExpParser -> efEmit == EMIT_C && oExpParser -> iReuse != 0)
+    iResult = ExpParser_reuse(oExpParser, oExpSSA);
+  else if(oExpParser -> efEmit == EMIT_SLP)
+    iResult = ExpParser_slp(oExpParser, oExpSSA);
+  else{
+    if(oExpParser -> efEmit == EMIT_C)
+      iResult = ExpCGen_print(oExpParser -> oCGen, oExpSSA);
+    else if(oExpParser -> efEmit == EMIT_SIMD)
+      iResult = ExpSIMD_print(oExpParser -> oCGen, oExpSSA,\
+			      oExpParser -> uiSIMDCache);
+    else
+      iResult = ExpCpp_print(oExpParser -> oCGen, oExpSSA);
+    if(iResult == 1)
+      fprintf(stderr, "%s", "ExpParser_emit: insufficient memory\n");
+  }
+  ExpSSA_free(oExpSSA);
+  return iResult;
+}
+
 /*---------------------------------------------------------------------*/
 /*Iteratively simplify the expression trees in pllExpressions by       */
 /*substituting new variables for the twigs of the trees until no twigs */
-/*remain. Print an infix representation of each substitution to stdout */
-/*If an error occurs, print an informative message to stderr           */
+/*remain. Append each substitution to oExpProgram. If an error occurs, */
+/*print an informative message to stderr                               */
 /*---------------------------------------------------------------------*/
-static void ExpParser_simplify(ExpParser_T oExpParser){
+static void ExpParser_bottomUp(ExpParser_T oExpParser,\
+			       ExpProgram_T oExpProgram){
   TreeNode_T oTreeNodeFind, oTreeNodeReplace;
   unsigned int uiVarNum = 0u;
   assert(oExpParser != NULL);
-  //loop until no more twigs or memory insufficient
+  assert(oExpProgram != NULL);
+  //loop until no more twigs, memory insufficient or budget exhausted
   for(oTreeNodeFind =ExpParser_nextTwig(oExpParser);
       oTreeNodeFind != NULL;
       oTreeNodeFind =\
 	ExpParser_nextTwig(oExpParser)){
+    if(ExpBudget_isExhausted(oExpParser -> oBudget)){
+      fprintf(stderr, "%s", "ExpParser_simplify: budget exhausted, "\
+	      "emitting the remaining trees as they are\n");
+      if(ExpParser_emitRemaining(oExpParser, oExpProgram) != 0)
+	fprintf(stderr, "%s", "ExpParser_simplify: insufficient memory\n");
+      break;
+    }
     //copy the value of oTreeNodeFind
     oTreeNodeFind = ExpTokenTree_copy(oTreeNodeFind);
+    //constants exposed by substitution are folded, not emitted
+    if(oExpParser -> iFold != 0 &&\
+       ExpParser_foldTwig(oExpParser, oTreeNodeFind) != 0){
+      ExpTokenTree_free(oTreeNodeFind);
+      continue;
+    }
     //ExpParser_print(oExpParser);
     //ExpTokenTree_print(oTreeNodeFind);
     //generate the variable to substitute
@@ -1220,31 +2241,883 @@ static void ExpParser_simplify(ExpParser_T oExpParser){
       ExpTokenTree_free(oTreeNodeReplace);
       break;
     }
-    //print an infix representation of the substitution
-    ExpTokenTree_print(oTreeNodeReplace);
-    printf(" = ");
-    ExpTokenTree_print(oTreeNodeFind);
-    printf("\n");
     //free oTreeNodeReplace
     ExpTokenTree_free(oTreeNodeReplace);
-    //free oTreeNodeFind
-    ExpTokenTree_free(oTreeNodeFind);
+    //record the substitution, which takes oTreeNodeFind
+    if(ExpProgram_add(oExpProgram, oTreeNodeFind) != 0){
+      fprintf(stderr, "%s", "ExpParser_simplify: insufficient memory\n");
+      ExpTokenTree_free(oTreeNodeFind);
+      break;
+    }
     //update the variable number
     uiVarNum++;
   }
+}
+
+/*---------------------------------------------------------------------*/
+/*Simplify the expression trees in pllExpressions into a program of    */
+/*substitutions, by the bottom-up or the top-down strategy, and print  */
+/*it to stdout followed by a representation of the ExpParser. If an    */
+/*error occurs, print an informative message to stderr. Return 0 if the*/
+/*program was written, 1 if memory was insufficient, -1 if it cannot be*/
+/*written in the format configured                                     */
+/*---------------------------------------------------------------------*/
+static int ExpParser_simplify(ExpParser_T oExpParser){
+  ExpProgram_T oExpProgram;
+  unsigned int uiInlined, uiShared;
+  clock_t ctStart;
+  int iResult;
+  assert(oExpParser != NULL);
+  //the statements are held until all are found, so they can be revised
+  oExpProgram = ExpProgram_new();
+  if(oExpProgram == NULL){
+    fprintf(stderr, "%s", "ExpParser_simplify: insufficient memory\n");
+    return 1;
+  }
+  ctStart = clock();
+  if(oExpParser -> iEmitOnly != 0 && oExpParser -> iTopDown == 0){
+    if(ExpParser_emitRemaining(oExpParser, oExpProgram) != 0)
+      fprintf(stderr, "%s", "ExpParser_simplify: insufficient memory\n");
+  }
+  else if(oExpParser -> iTopDown == 0)
+    ExpParser_bottomUp(oExpParser, oExpProgram);
+  //top-down takes linear time, so it always runs to the end
+  else if(ExpTopDown_apply(oExpParser -> pllExpressions, oExpProgram,\
+			   NULL, &uiShared) != 0)
+    fprintf(stderr, "%s", "ExpParser_simplify: insufficient memory\n");
+  else{
+    fprintf(stderr, "ExpParser_topDown: %u shared subtrees\n", uiShared);
+    //constants exposed by substitution are folded, as in bottom-up
+    if(oExpParser -> iFold != 0 && oExpParser -> iEmitOnly == 0 &&\
+       ExpParser_withinBudget(oExpParser, "ExpParser_foldStatements") &&\
+       ExpParser_foldStatements(oExpParser, oExpProgram) != 0)
+      fprintf(stderr, "%s", "ExpParser_simplify: insufficient memory\n");
+  }
+  if(oExpParser -> iStats != 0)
+    fprintf(stderr, "ExpParser_simplify: %u statements, %u operations, "\
+	    "%.3f s\n", ExpProgram_howMany(oExpProgram),\
+	    ExpProgram_countOperations(oExpProgram),\
+	    (double)(clock() - ctStart) / CLOCKS_PER_SEC);
+  if(oExpParser -> iBalance != 0 &&\
+     ExpParser_withinBudget(oExpParser, "ExpParser_balance"))
+    ExpParser_balance(oExpParser, oExpProgram);
+  if(oExpParser -> iInline != 0 &&\
+     ExpParser_withinBudget(oExpParser, "ExpParser_inline")){
+    uiInlined = ExpProgram_inline(oExpProgram,\
+				  oExpParser -> pllExpressions,\
+				  oExpParser -> uiInlineMax);
+    fprintf(stderr, "ExpParser_inline: %u of %u temporaries inlined\n",\
+	    uiInlined, ExpProgram_howMany(oExpProgram) + uiInlined);
+  }
+  if(oExpParser -> oStrength != NULL &&\
+     ExpParser_withinBudget(oExpParser, "ExpParser_strength"))
+    ExpParser_strength(oExpParser, oExpProgram);
+  //fused last, as no other pass knows a fused multiply-add
+  if(oExpParser -> iFMA != 0 &&\
+     ExpParser_withinBudget(oExpParser, "ExpParser_contract"))
+    ExpParser_contract(oExpParser, oExpProgram);
+  if(oExpParser -> efEmit != EMIT_TEXT){
+    iResult = ExpParser_emit(oExpParser, oExpProgram);
+    ExpProgram_free(oExpProgram);
+    return iResult;
+  }
+  //print an infix representation of each substitution
+  ExpProgram_print(oExpProgram);
+  ExpProgram_free(oExpProgram);
   //print a representation of the completed ExpPaser
   ExpParser_print(oExpParser);
+  return 0;
 }
     
       
 
+/*---------------------------------------------------------------------*/
+/*Print the command line options to stderr                             */
+/*---------------------------------------------------------------------*/
+static void ExpParser_usage(void){
+  fprintf(stderr, "%s",\
+	  "usage: expparser [options] < input > output\n"\
+	  "  -O0                   emit the trees without simplifying\n"\
+	  "  -O1                   extract common subtrees by hashing\n"\
+	  "  -O2                   -O1 and the algebraic passes -f -s -p -r\n"\
+	  "  -O3                   -O2 and the searches -e --beam\n"\
+	  "  -Oauto                choose the level from the input size\n"\
+	  "  -f, --fold            fold constants and remove identities\n"\
+	  "  -b, --bind NAME=VALUE give the operand NAME a known value\n"\
+	  "  --bindings FILE       read NAME=VALUE bindings from FILE\n"\
+	  "  --equiv SPEC          declare operands equivalent, ex.\n"\
+	  "                        x=y or a{i}_{j}=a{j}_{i}\n"\
+	  "  --poly                put polynomials into normal form and\n"\
+	  "                        share the ones that are equal\n"\
+	  "  -e, --egraph          optimize by equality saturation first\n"\
+	  "  --egraph-nodes N      stop saturating at N e-graph nodes\n"\
+	  "  --egraph-time S       stop saturating after S seconds\n"\
+	  "  -s, --signs           move signs to canonical positions\n"\
+	  "  -p, --powers          lower integer powers to shared products\n"\
+	  "  -r, --reciprocal      merge fractions and share reciprocals\n"\
+	  "  --beam K              search the pairing order of sums and\n"\
+	  "                        products keeping K states (default 8)\n"\
+	  "  --beam-time S         stop searching after S seconds\n"\
+	  "  -t, --top-down        extract the largest repeated subtrees\n"\
+	  "                        first\n"\
+	  "  --time-budget S       stop optimizing after S seconds and emit\n"\
+	  "                        the best program found so far\n"\
+	  "  --memory-budget M     stop optimizing once M megabytes are used\n"\
+	  "  --stats               report the size of the program and the\n"\
+	  "                        time taken to simplify\n"\
+	  "  --balance             regroup sums and products for a short\n"\
+	  "                        critical path\n"\
+	  "  --balance-copy N      also copy shared sums and products of at\n"\
+	  "                        most N operations where that shortens it\n"\
+	  "  -i, --inline          inline temporaries that are used once\n"\
+	  "  --inline-max N        inline into statements of at most N\n"\
+	  "                        operations (default 8)\n"\
+	  "  --strength TARGET     replace operations by cheaper ones under\n"\
+	  "                        the costs of TARGET: generic, fpu or soft\n"\
+	  "  --strength-cost OP=N  make operator OP cost N, ex. multiply=3\n"\
+	  "  --fma                 fuse a product used once into the sum or\n"\
+	  "                        difference using it, as fma(x,y,z)\n"\
+	  "  --fma-all             --fma, also copying a shared product of\n"\
+	  "                        operands into every sum using it\n"\
+	  "  --emit FORMAT         write the program as text (default), in\n"\
+	  "                        static single assignment form as json or\n"\
+	  "                        binary, as a C function, c, as a C\n"\
+	  "                        kernel over a batch of instances, simd,\n"\
+	  "                        as a C function on vectors packed from\n"\
+	  "                        independent operations, slp, or as a C++\n"\
+	  "                        function template over the scalar type,\n"\
+	  "                        cpp\n"\
+	  "  --simd-cache KB       keep a tile of the batch kernel within KB\n"\
+	  "                        kilobytes of cache (default 32)\n"\
+	  "  --slp-width N         pack N operations per vector, 2 for SSE2\n"\
+	  "                        or 4 for AVX2 (default 4)\n"\
+	  "  --c-function NAME     name the C function NAME\n"\
+	  "  --c-struct TYPE       read its inputs from a struct TYPE\n"\
+	  "  --c-slot NAME=SLOT    read operand NAME from index or member SLOT\n"\
+	  "  --c-slots FILE        read every mapping NAME=SLOT in FILE\n"\
+	  "  --reuse               share the locals of the C function among\n"\
+	  "                        temporaries that are not live at once\n"\
+	  "  --registers N         also keep at most N locals and spill the\n"\
+	  "                        rest to a scratch array\n"\
+	  "  --schedule MODE       order the emitted instructions for few\n"\
+	  "                        live results, pressure, or to hide\n"\
+	  "                        latency, latency\n"\
+	  "  --latency OP=N        make operator OP take N cycles when\n"\
+	  "                        scheduling, ex. divide=20\n"\
+	  "  --session             hold the program in a session edited by\n"\
+	  "                        the @add, @remove and @replace lines\n"\
+	  "                        after the expressions\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the unsigned integer in pcArg in puiValue. Return 0 if         */
+/*successful, -1 if pcArg is not an unsigned integer                   */
+/*---------------------------------------------------------------------*/
+static int ExpParser_parseUnsigned(const char* pcArg,\
+				   unsigned int* puiValue){
+  char* pcEnd;
+  unsigned long ulValue;
+  if(pcArg == NULL || *pcArg < '0' || *pcArg > '9')
+    return -1;
+  ulValue = strtoul(pcArg, &pcEnd, 10);
+  if(*pcEnd != '\0' || ulValue > 0xFFFFFFFFul)
+    return -1;
+  *puiValue = (unsigned int)ulValue;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the non-negative number in pcArg in pdValue. Return 0 if       */
+/*successful, -1 if pcArg is not a non-negative number                 */
+/*---------------------------------------------------------------------*/
+static int ExpParser_parseDouble(const char* pcArg, double* pdValue){
+  char* pcEnd;
+  if(pcArg == NULL || *pcArg == '\0')
+    return -1;
+  *pdValue = strtod(pcArg, &pcEnd);
+  if(*pcEnd != '\0' || *pdValue < 0.0)
+    return -1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the binding pcArg to oExpParser if pcFile is NULL, or else every */
+/*binding in the file named pcFile. Bound operands are only worth      */
+/*substituting if the result is folded, so folding is turned on. Return*/
+/*0 if successful, 1 if memory is insufficient, -1 if a binding or the */
+/*file is bad                                                          */
+/*---------------------------------------------------------------------*/
+static int ExpParser_addBindings(ExpParser_T oExpParser,\
+				 const char* pcArg, const char* pcFile){
+  FILE* psFile;
+  int iResult;
+  assert(oExpParser != NULL);
+  if(pcArg == NULL && pcFile == NULL)
+    return -1;
+  if(oExpParser -> oBind == NULL)
+    oExpParser -> oBind = ExpBind_new();
+  if(oExpParser -> oBind == NULL)
+    return 1;
+  oExpParser -> iFold = 1;
+  if(pcFile == NULL)
+    return ExpBind_add(oExpParser -> oBind, pcArg);
+  psFile = fopen(pcFile, "r");
+  if(psFile == NULL){
+    fprintf(stderr, "ExpParser: cannot open '%s'\n", pcFile);
+    return -1;
+  }
+  iResult = ExpBind_read(oExpParser -> oBind, psFile);
+  fclose(psFile);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the equivalence declaration pcSpec to oExpParser. Return 0 if    */
+/*successful, 1 if memory is insufficient, -1 if pcSpec is malformed   */
+/*---------------------------------------------------------------------*/
+static int ExpParser_addEquiv(ExpParser_T oExpParser, const char* pcSpec){
+  assert(oExpParser != NULL);
+  if(pcSpec == NULL)
+    return -1;
+  if(oExpParser -> oEquiv == NULL)
+    oExpParser -> oEquiv = ExpEquiv_new();
+  if(oExpParser -> oEquiv == NULL)
+    return 1;
+  return ExpEquiv_add(oExpParser -> oEquiv, pcSpec);
+}
+
+/*---------------------------------------------------------------------*/
+/*Set the limit named by the option pcArg, --time-budget or            */
+/*--memory-budget, to pcValue, creating the budget of oExpParser if it */
+/*has none. Return 0 if successful, 1 if memory is insufficient, -1 if */
+/*pcValue is malformed                                                 */
+/*---------------------------------------------------------------------*/
+static int ExpParser_setBudget(ExpParser_T oExpParser, const char* pcArg,\
+			       const char* pcValue){
+  double dSeconds;
+  unsigned int uiMegabytes;
+  assert(oExpParser != NULL);
+  assert(pcArg != NULL);
+  if(oExpParser -> oBudget == NULL)
+    oExpParser -> oBudget = ExpBudget_new();
+  if(oExpParser -> oBudget == NULL)
+    return 1;
+  if(strcmp(pcArg, "--time-budget") == 0){
+    if(ExpParser_parseDouble(pcValue, &dSeconds) != 0)
+      return -1;
+    ExpBudget_setTime(oExpParser -> oBudget, dSeconds);
+    return 0;
+  }
+  if(ExpParser_parseUnsigned(pcValue, &uiMegabytes) != 0)
+    return -1;
+  ExpBudget_setMemory(oExpParser -> oBudget, (unsigned long)uiMegabytes);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Configure the strength reduction of oExpParser by the option pcArg,  */
+/*--strength or --strength-cost, with the value pcValue, creating its  */
+/*cost table if it has none. Return 0 if successful, 1 if memory is    */
+/*insufficient, -1 if pcValue is malformed                             */
+/*---------------------------------------------------------------------*/
+static int ExpParser_setStrength(ExpParser_T oExpParser, const char* pcArg,\
+				 const char* pcValue){
+  assert(oExpParser != NULL);
+  assert(pcArg != NULL);
+  if(pcValue == NULL)
+    return -1;
+  if(oExpParser -> oStrength == NULL)
+    oExpParser -> oStrength = ExpStrength_new();
+  if(oExpParser -> oStrength == NULL)
+    return 1;
+  if(strcmp(pcArg, "--strength") == 0)
+    return ExpStrength_setTarget(oExpParser -> oStrength, pcValue);
+  return ExpStrength_setCost(oExpParser -> oStrength, pcValue);
+}
+
+/*---------------------------------------------------------------------*/
+/*Configure the instruction scheduling of oExpParser by the option     */
+/*pcArg, --schedule or --latency, with the value pcValue, creating its */
+/*latency table if it has none. Return 0 if successful, 1 if memory is */
+/*insufficient, -1 if pcValue is malformed                             */
+/*---------------------------------------------------------------------*/
+static int ExpParser_setSchedule(ExpParser_T oExpParser, const char* pcArg,\
+				 const char* pcValue){
+  assert(oExpParser != NULL);
+  assert(pcArg != NULL);
+  if(pcValue == NULL)
+    return -1;
+  if(oExpParser -> oSched == NULL)
+    oExpParser -> oSched = ExpSched_new();
+  if(oExpParser -> oSched == NULL)
+    return 1;
+  if(strcmp(pcArg, "--latency") == 0)
+    return ExpSched_setLatency(oExpParser -> oSched, pcValue);
+  if(strcmp(pcValue, "pressure") == 0)
+    oExpParser -> esmSchedule = EXPSCHED_PRESSURE;
+  else if(strcmp(pcValue, "latency") == 0)
+    oExpParser -> esmSchedule = EXPSCHED_LATENCY;
+  else
+    return -1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Set the format oExpParser writes the program in to the one named     */
+/*pcValue. Return 0 if successful, -1 if pcValue is not a format       */
+/*---------------------------------------------------------------------*/
+static int ExpParser_setEmit(ExpParser_T oExpParser, const char* pcValue){
+  assert(oExpParser != NULL);
+  if(pcValue == NULL)
+    return -1;
+  if(strcmp(pcValue, "text") == 0)
+    oExpParser -> efEmit = EMIT_TEXT;
+  else if(strcmp(pcValue, "json") == 0)
+    oExpParser -> efEmit = EMIT_JSON;
+  else if(strcmp(pcValue, "binary") == 0)
+    oExpParser -> efEmit = EMIT_BINARY;
+  else if(strcmp(pcValue, "c") == 0)
+    oExpParser -> efEmit = EMIT_C;
+  else if(strcmp(pcValue, "simd") == 0)
+    oExpParser -> efEmit = EMIT_SIMD;
+  else if(strcmp(pcValue, "slp") == 0)
+    oExpParser -> efEmit = EMIT_SLP;
+  else if(strcmp(pcValue, "cpp") == 0)
+    oExpParser -> efEmit = EMIT_CPP;
+  else
+    return -1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Configure the C function of oExpParser by the option pcArg,          */
+/*--c-function, --c-struct, --c-slot or --c-slots, with the value      */
+/*pcValue, creating its configuration if it has none. Return 0 if      */
+/*successful, 1 if memory is insufficient, -1 if pcValue is malformed  */
+/*---------------------------------------------------------------------*/
+static int ExpParser_setCGen(ExpParser_T oExpParser, const char* pcArg,\
+			     const char* pcValue){
+  FILE* psFile;
+  int iResult;
+  assert(oExpParser != NULL);
+  assert(pcArg != NULL);
+  if(pcValue == NULL)
+    return -1;
+  if(oExpParser -> oCGen == NULL)
+    oExpParser -> oCGen = ExpCGen_new();
+  if(oExpParser -> oCGen == NULL)
+    return 1;
+  if(strcmp(pcArg, "--c-function") == 0)
+    return ExpCGen_setFunction(oExpParser -> oCGen, pcValue);
+  if(strcmp(pcArg, "--c-struct") == 0)
+    return ExpCGen_setStruct(oExpParser -> oCGen, pcValue);
+  if(strcmp(pcArg, "--c-slot") == 0)
+    return ExpCGen_addSlot(oExpParser -> oCGen, pcValue);
+  psFile = fopen(pcValue, "r");
+  if(psFile == NULL){
+    fprintf(stderr, "ExpParser: cannot open '%s'\n", pcValue);
+    return -1;
+  }
+  iResult = ExpCGen_readSlots(oExpParser -> oCGen, psFile);
+  fclose(psFile);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Configure oExpParser from the command line arguments. Return 0 if    */
+/*successful, -1 if an argument is not recognized or is malformed      */
+/*---------------------------------------------------------------------*/
+static int ExpParser_parseArgs(ExpParser_T oExpParser, int argc,\
+			       char* argv[]){
+  unsigned int uiKilobytes;
+  int iIndex, iCode;
+  const char* pcArg;
+  const char* pcValue;
+  assert(oExpParser != NULL);
+  for(iIndex = 1; iIndex < argc; iIndex++){
+    pcArg = argv[iIndex];
+    pcValue = (iIndex + 1 < argc) ? argv[iIndex + 1] : NULL;
+    if(strcmp(pcArg, "-f") == 0 || strcmp(pcArg, "--fold") == 0)
+      oExpParser -> iFold = 1;
+    else if(strcmp(pcArg, "-Oauto") == 0)
+      oExpParser -> iLevel = LEVEL_AUTO;
+    else if(strncmp(pcArg, "-O", 2u) == 0 && pcArg[2] >= '0' &&\
+	    pcArg[2] <= '3' && pcArg[3] == '\0')
+      ExpParser_setLevel(oExpParser, pcArg[2] - '0');
+    else if(strcmp(pcArg, "--poly") == 0)
+      oExpParser -> iPoly = 1;
+    else if(strcmp(pcArg, "--session") == 0)
+      oExpParser -> iSession = 1;
+    else if(strcmp(pcArg, "-e") == 0 || strcmp(pcArg, "--egraph") == 0)
+      oExpParser -> iEGraph = 1;
+    else if(strcmp(pcArg, "-s") == 0 || strcmp(pcArg, "--signs") == 0)
+      oExpParser -> iSigns = 1;
+    else if(strcmp(pcArg, "-p") == 0 || strcmp(pcArg, "--powers") == 0)
+      oExpParser -> iPowers = 1;
+    else if(strcmp(pcArg, "-r") == 0 || strcmp(pcArg, "--reciprocal") == 0)
+      oExpParser -> iReciprocal = 1;
+    else if(strcmp(pcArg, "-b") == 0 || strcmp(pcArg, "--bind") == 0){
+      if(ExpParser_addBindings(oExpParser, pcValue, NULL) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--bindings") == 0){
+      if(pcValue == NULL ||\
+	 ExpParser_addBindings(oExpParser, NULL, pcValue) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--equiv") == 0){
+      if(ExpParser_addEquiv(oExpParser, pcValue) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "-t") == 0 || strcmp(pcArg, "--top-down") == 0)
+      oExpParser -> iTopDown = 1;
+    else if(strcmp(pcArg, "--stats") == 0)
+      oExpParser -> iStats = 1;
+    else if(strcmp(pcArg, "--balance") == 0)
+      oExpParser -> iBalance = 1;
+    else if(strcmp(pcArg, "--fma") == 0)
+      oExpParser -> iFMA = 1;
+    else if(strcmp(pcArg, "--fma-all") == 0)
+      oExpParser -> iFMA = oExpParser -> iFMAAll = 1;
+    else if(strcmp(pcArg, "--balance-copy") == 0){
+      if(ExpParser_parseUnsigned(pcValue, &oExpParser -> uiBalanceCopy) != 0)
+	break;
+      oExpParser -> iBalance = 1;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "-i") == 0 || strcmp(pcArg, "--inline") == 0)
+      oExpParser -> iInline = 1;
+    else if(strcmp(pcArg, "--inline-max") == 0){
+      if(ExpParser_parseUnsigned(pcValue, &oExpParser -> uiInlineMax) != 0)
+	break;
+      oExpParser -> iInline = 1;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--strength") == 0 ||\
+	    strcmp(pcArg, "--strength-cost") == 0){
+      if(ExpParser_setStrength(oExpParser, pcArg, pcValue) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--emit") == 0){
+      if(ExpParser_setEmit(oExpParser, pcValue) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--c-function") == 0 ||\
+	    strcmp(pcArg, "--c-struct") == 0 ||\
+	    strcmp(pcArg, "--c-slot") == 0 ||\
+	    strcmp(pcArg, "--c-slots") == 0){
+      if(ExpParser_setCGen(oExpParser, pcArg, pcValue) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--simd-cache") == 0){
+      if(ExpParser_parseUnsigned(pcValue, &uiKilobytes) != 0 ||\
+	 uiKilobytes == 0u || uiKilobytes > 0xFFFFFFFFu / 1024u)
+	break;
+      oExpParser -> uiSIMDCache = uiKilobytes * 1024u;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--slp-width") == 0){
+      if(ExpParser_parseUnsigned(pcValue, &oExpParser -> uiSLPWidth) != 0 ||\
+	 (oExpParser -> uiSLPWidth != 2u && oExpParser -> uiSLPWidth != 4u))
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--reuse") == 0)
+      oExpParser -> iReuse = 1;
+    else if(strcmp(pcArg, "--registers") == 0){
+      if(ExpParser_parseUnsigned(pcValue, &oExpParser -> uiRegisters) != 0 ||\
+	 oExpParser -> uiRegisters == 0u)
+	break;
+      oExpParser -> iReuse = 1;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--schedule") == 0 ||\
+	    strcmp(pcArg, "--latency") == 0){
+      if(ExpParser_setSchedule(oExpParser, pcArg, pcValue) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--beam") == 0){
+      if(ExpParser_parseUnsigned(pcValue, &oExpParser -> uiBeamWidth) != 0 ||\
+	 oExpParser -> uiBeamWidth == 0u)
+	break;
+      oExpParser -> iBeam = 1;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--beam-time") == 0){
+      if(ExpParser_parseDouble\
+	 (pcValue, &oExpParser -> dBeamTimeLimit) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--time-budget") == 0 ||\
+	    strcmp(pcArg, "--memory-budget") == 0){
+      if(ExpParser_setBudget(oExpParser, pcArg, pcValue) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--egraph-nodes") == 0){
+      if(ExpParser_parseUnsigned\
+	 (pcValue, &oExpParser -> uiEGraphNodeLimit) != 0)
+	break;
+      iIndex++;
+    }
+    else if(strcmp(pcArg, "--egraph-time") == 0){
+      if(ExpParser_parseDouble\
+	 (pcValue, &oExpParser -> dEGraphTimeLimit) != 0)
+	break;
+      iIndex++;
+    }
+    else
+      break;
+  }
+  if(iIndex < argc){
+    fprintf(stderr, "ExpParser: bad option '%s'\n", argv[iIndex]);
+    return -1;
+  }
+  //configuring the C function or its schedule implies writing one
+  if((oExpParser -> oCGen != NULL || oExpParser -> iReuse != 0 ||\
+      oExpParser -> oSched != NULL) &&\
+     oExpParser -> efEmit == EMIT_TEXT)
+    oExpParser -> efEmit = EMIT_C;
+  iCode = (oExpParser -> efEmit == EMIT_C ||\
+	   oExpParser -> efEmit == EMIT_SIMD ||\
+	   oExpParser -> efEmit == EMIT_SLP ||\
+	   oExpParser -> efEmit == EMIT_CPP);
+  if(oExpParser -> oCGen != NULL && !iCode){
+    fprintf(stderr, "%s", "ExpParser: the --c- options only apply to "\
+	    "--emit c, simd, slp and cpp\n");
+    return -1;
+  }
+  if(oExpParser -> iReuse != 0 && oExpParser -> efEmit != EMIT_C){
+    fprintf(stderr, "%s", "ExpParser: --reuse and --registers only apply "\
+	    "to --emit c\n");
+    return -1;
+  }
+  if(iCode && oExpParser -> oCGen == NULL)
+    oExpParser -> oCGen = ExpCGen_new();
+  if(iCode && oExpParser -> oCGen == NULL){
+    fprintf(stderr, "%s", "ExpParser: insufficient memory\n");
+    return -1;
+  }
+  //a session keeps its own numbering of temporaries, printed as text
+  if(oExpParser -> iSession != 0 && oExpParser -> efEmit != EMIT_TEXT){
+    fprintf(stderr, "%s", "ExpParser: --emit only applies without "\
+	    "--session\n");
+    return -1;
+  }
+  //a session parses its edits, and fma is never parsed
+  if(oExpParser -> iSession != 0 && oExpParser -> iFMA != 0){
+    fprintf(stderr, "%s", "ExpParser: --fma only applies without "\
+	    "--session\n");
+    return -1;
+  }
+  //the passes over the simplified program would not survive an edit
+  if(oExpParser -> iSession != 0 && oExpParser -> iInline != 0){
+    fprintf(stderr, "%s", "ExpParser: -i only applies without "\
+	    "--session\n");
+    return -1;
+  }
+  if(oExpParser -> iSession != 0 && oExpParser -> iBalance != 0){
+    fprintf(stderr, "%s", "ExpParser: --balance only applies without "\
+	    "--session\n");
+    return -1;
+  }
+  if(oExpParser -> iSession != 0 && oExpParser -> oStrength != NULL){
+    fprintf(stderr, "%s", "ExpParser: --strength only applies without "\
+	    "--session\n");
+    return -1;
+  }
+  if(oExpParser -> oBudget != NULL){
+    oExpParser -> oSearchBudget =\
+      ExpBudget_newShare(oExpParser -> oBudget, SEARCH_SHARE);
+    if(oExpParser -> oSearchBudget == NULL){
+      fprintf(stderr, "%s", "ExpParser: insufficient memory\n");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Read the word starting at the next char of stdin into pcWord, which  */
+/*holds MAX_DIRECTIVE chars plus the terminating '\0'. A word ends at  */
+/*whitespace, a comma or EOF. Return the char that ended it, or 0 if   */
+/*the word is too long                                                 */
+/*---------------------------------------------------------------------*/
+static int ExpParser_readWord(char* pcWord){
+  unsigned int uiLength = 0u;
+  int iChar;
+  for(iChar = getchar();
+      iChar != EOF && iChar != ' ' && iChar != '\t' && iChar != ',' &&\
+	iChar != '\n' && iChar != '\r';
+      iChar = getchar()){
+    if(uiLength == MAX_DIRECTIVE)
+      return 0;
+    pcWord[uiLength++] = (char)iChar;
+  }
+  pcWord[uiLength] = '\0';
+  return iChar;
+}
+
+/*---------------------------------------------------------------------*/
+/*Read the directive lines at the start of stdin, before the first     */
+/*expression. A directive line starts with @. The only directive is    */
+/*@equiv, followed by equivalence declarations separated by whitespace */
+/*or commas. Return 0 if successful, 1 if memory is insufficient, -1 if*/
+/*a directive is malformed                                             */
+/*---------------------------------------------------------------------*/
+static int ExpParser_readDirectives(ExpParser_T oExpParser){
+  char pcWord[MAX_DIRECTIVE + 1u];
+  int iChar, iStatus;
+  assert(oExpParser != NULL);
+  for(iChar = getchar(); iChar == '@'; iChar = getchar()){
+    iChar = ExpParser_readWord(pcWord);
+    if(iChar == 0 || strcmp(pcWord, "equiv") != 0){
+      fprintf(stderr, "ExpParser: unknown directive '@%s'\n", pcWord);
+      return -1;
+    }
+    //read declarations until the end of the line
+    while(iChar != '\n' && iChar != EOF){
+      iChar = ExpParser_readWord(pcWord);
+      if(iChar == 0){
+	fprintf(stderr, "%s", "ExpParser: declaration too long\n");
+	return -1;
+      }
+      if(pcWord[0] == '\0')
+	continue;
+      iStatus = ExpParser_addEquiv(oExpParser, pcWord);
+      if(iStatus != 0)
+	return iStatus;
+    }
+    //skip blank lines between directives and expressions
+    do
+      iChar = getchar();
+    while(iChar == '\n' || iChar == '\r' || iChar == ' ');
+    if(iChar != EOF)
+      ungetc(iChar, stdin);
+  }
+  if(iChar != EOF)
+    ungetc(iChar, stdin);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Run the parsing DFA over the rest of the current line of stdin,      */
+/*appending the expressions read to pllExpressions. Return 0 if the    */
+/*line is complete, -1 if it is malformed or memory is insufficient    */
+/*---------------------------------------------------------------------*/
+static int ExpParser_parseLine(ExpParser_T oExpParser){
+  enum DFAState state = START;
+  assert(oExpParser != NULL);
+  //loop until you reach error or completion
+  while(0==0){
+    //print the state of the parser
+    //ExpParser_print(oExpParser);
+    //fprintf(stdout, "%u\n", ExpTokenTreeStack_howMany(oExpParser -> pettsOperandStack));
+    //fflush(stdout);
+    switch(state)
+      {
+      case START:
+	state = ExpParser_handleDFA_START(oExpParser);
+	break;
+      case AFTER_OPERATOR:
+	state = ExpParser_handleDFA_AFTER_OPERATOR(oExpParser);
+	break;
+      case AFTER_OPERAND:
+	state = ExpParser_handleDFA_AFTER_OPERAND(oExpParser);
+	break;
+      case ERROR:
+	return -1;
+      case COMPLETE:
+	return 0;
+      }
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print to stderr, under the name pcEdit, the statements oExpSession   */
+/*added and collected since it had added uiAdded and collected         */
+/*uiRemoved, and how many it holds                                     */
+/*---------------------------------------------------------------------*/
+static void ExpParser_sessionReport(ExpSession_T oExpSession,\
+				    const char* pcEdit, unsigned int uiAdded,\
+				    unsigned int uiRemoved){
+  unsigned int uiAddedAfter, uiRemovedAfter;
+  ExpSession_counts(oExpSession, &uiAddedAfter, &uiRemovedAfter);
+  fprintf(stderr, "ExpParser_session: %s, %u statements added, "\
+	  "%u collected, %u statements\n", pcEdit, uiAddedAfter - uiAdded,\
+	  uiRemovedAfter - uiRemoved, ExpSession_howMany(oExpSession));
+}
+
+/*---------------------------------------------------------------------*/
+/*Add every expression in pllExpressions to oExpSession, or if         */
+/*uiReplace is not the number of an expression, make the only one      */
+/*replace expression uiReplace, and free the list. Print the statements*/
+/*added and collected to stderr, under the name pcEdit. Return 0 if    */
+/*successful, 1 if memory is insufficient, -1 if the edit is malformed */
+/*---------------------------------------------------------------------*/
+static int ExpParser_sessionEdit(ExpParser_T oExpParser,\
+				 ExpSession_T oExpSession,\
+				 unsigned int uiReplace, const char* pcEdit){
+  LinkList_T oLinkList;
+  unsigned int uiId, uiAdded, uiRemoved;
+  int iStatus = 0;
+  assert(oExpParser != NULL);
+  assert(oExpSession != NULL);
+  ExpSession_counts(oExpSession, &uiAdded, &uiRemoved);
+  if(uiReplace != NO_REPLACE){
+    if(LinkList_getLength(oExpParser -> pllExpressions) != 1u){
+      fprintf(stderr, "%s", "ExpParser_session: @replace takes one "\
+	      "expression\n");
+      iStatus = -1;
+    }
+    else{
+      iStatus = ExpSession_replace\
+	(oExpSession, uiReplace,\
+	 (TreeNode_T)LinkList_getValue(oExpParser -> pllExpressions));
+      if(iStatus == -1)
+	fprintf(stderr, "ExpParser_session: no expression %u\n",\
+		uiReplace);
+    }
+  }
+  else
+    for(oLinkList = oExpParser -> pllExpressions;
+	oLinkList != NULL && iStatus == 0;
+	oLinkList = LinkList_getNext(oLinkList))
+      iStatus = ExpSession_add(oExpSession,\
+			       (TreeNode_T)LinkList_getValue(oLinkList),\
+			       &uiId);
+  //the session keeps copies, so the trees are no longer needed
+  ExpParser_freeTrees(oExpParser -> pllExpressions);
+  oExpParser -> pllExpressions = NULL;
+  if(iStatus != 0)
+    return iStatus;
+  ExpParser_sessionReport(oExpSession, pcEdit, uiAdded, uiRemoved);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Apply the edit lines remaining on stdin to oExpSession. An edit line */
+/*is @add followed by expressions, @remove followed by the number of an*/
+/*expression, or @replace followed by the number of an expression and  */
+/*the expression to replace it. The expressions of an edit are         */
+/*optimized like the first ones, on their own. Return 0 if successful, */
+/*1 if memory is insufficient, -1 if an edit is malformed              */
+/*---------------------------------------------------------------------*/
+static int ExpParser_sessionEdits(ExpParser_T oExpParser,\
+				  ExpSession_T oExpSession){
+  char pcWord[MAX_DIRECTIVE + 1u];
+  char pcNumber[MAX_DIRECTIVE + 1u];
+  unsigned int uiId, uiAdded, uiRemoved;
+  int iChar, iStatus;
+  assert(oExpParser != NULL);
+  assert(oExpSession != NULL);
+  for(iChar = getchar(); iChar != EOF; iChar = getchar()){
+    //skip blank lines
+    if(iChar == '\n' || iChar == '\r' || iChar == ' ')
+      continue;
+    uiId = NO_REPLACE;
+    if(iChar != '@'){
+      fprintf(stderr, "%s", "ExpParser_session: edit lines start with "\
+	      "@add, @remove or @replace\n");
+      return -1;
+    }
+    iChar = ExpParser_readWord(pcWord);
+    if(iChar == 0 || (strcmp(pcWord, "add") != 0 &&\
+		      strcmp(pcWord, "remove") != 0 &&\
+		      strcmp(pcWord, "replace") != 0)){
+      fprintf(stderr, "ExpParser_session: unknown edit '@%s'\n", pcWord);
+      return -1;
+    }
+    //@remove and @replace are followed by the number of an expression
+    if(strcmp(pcWord, "add") != 0){
+      pcNumber[0] = '\0';
+      if(iChar != '\n' && iChar != EOF)
+	iChar = ExpParser_readWord(pcNumber);
+      if(iChar == 0 || ExpParser_parseUnsigned(pcNumber, &uiId) != 0)
+	uiId = NO_REPLACE;
+      //no expression has the number that stands for none
+      if(uiId == NO_REPLACE){
+	fprintf(stderr, "ExpParser_session: @%s needs the number of an "\
+		"expression\n", pcWord);
+	return -1;
+      }
+    }
+    if(strcmp(pcWord, "remove") == 0){
+      //the rest of the line is ignored
+      while(iChar != '\n' && iChar != EOF)
+	iChar = getchar();
+      ExpSession_counts(oExpSession, &uiAdded, &uiRemoved);
+      iStatus = ExpSession_remove(oExpSession, uiId);
+      if(iStatus != 0)
+	fprintf(stderr, "ExpParser_session: no expression %u\n", uiId);
+      else
+	ExpParser_sessionReport(oExpSession, "@remove", uiAdded, uiRemoved);
+    }
+    else{
+      //the expressions are on the same line
+      if(iChar == '\n' || iChar == EOF){
+	fprintf(stderr, "ExpParser_session: @%s needs an expression\n",\
+		pcWord);
+	return -1;
+      }
+      if(ExpParser_parseLine(oExpParser) != 0)
+	return -1;
+      ExpParser_optimize(oExpParser);
+      iStatus = ExpParser_sessionEdit\
+	(oExpParser, oExpSession,\
+	 strcmp(pcWord, "add") == 0 ? NO_REPLACE : uiId,\
+	 strcmp(pcWord, "add") == 0 ? "@add" : "@replace");
+    }
+    if(iStatus == 1)
+      fprintf(stderr, "%s", "ExpParser_session: insufficient memory\n");
+    if(iStatus != 0)
+      return iStatus;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Hold the expressions in pllExpressions in a session, apply the edit  */
+/*lines after them, and print the program of the session to stdout.    */
+/*Return 0 if successful, 1 if memory is insufficient, -1 if an edit is*/
+/*malformed                                                            */
+/*---------------------------------------------------------------------*/
+static int ExpParser_session(ExpParser_T oExpParser){
+  ExpSession_T oExpSession;
+  int iStatus;
+  assert(oExpParser != NULL);
+  oExpSession = ExpSession_new();
+  if(oExpSession == NULL){
+    fprintf(stderr, "%s", "ExpParser_session: insufficient memory\n");
+    return 1;
+  }
+  iStatus = ExpParser_sessionEdit(oExpParser, oExpSession, NO_REPLACE,\
+				  "start");
+  if(iStatus == 1)
+    fprintf(stderr, "%s", "ExpParser_session: insufficient memory\n");
+  if(iStatus == 0)
+    iStatus = ExpParser_sessionEdits(oExpParser, oExpSession);
+  if(iStatus == 0)
+    ExpSession_print(oExpSession);
+  ExpSession_free(oExpSession);
+  return iStatus;
+}
+
 /*---------------------------------------------------------------------*/
 /*Read infix expressions in from stdin, ignoring whitespace and convert*/
 /*them to expression trees. Print the interpreted expressions back to  */
 /*stdout                                                               */
 /*---------------------------------------------------------------------*/
-int main(void){
-  enum DFAState state = START;
+int main(int argc, char* argv[]){
+  int iStatus = 0;
   ExpParser_T oExpParser = ExpParser_new();
   
   //TreeNode_T oTreeNodeMostCommon;
@@ -1262,6 +3135,15 @@ int main(void){
     fprintf(stderr, "%s", "ExpParser: insufficient memory\n");
     return EXIT_FAILURE;
   }
+  if(ExpParser_parseArgs(oExpParser, argc, argv) != 0){
+    ExpParser_usage();
+    ExpParser_free(oExpParser);
+    return EXIT_FAILURE;
+  }
+  if(ExpParser_readDirectives(oExpParser) != 0){
+    ExpParser_free(oExpParser);
+    return EXIT_FAILURE;
+  }
 
   //intialize things for testing
   /*
@@ -1272,71 +3154,60 @@ int main(void){
   ExpTokenTree_setValue(oTreeNodeSearch, oExpTokenSearch);
   */
 
-  //loop until you reach error or completion
-  while(0==0){
-    //print the state of the parser
-    //ExpParser_print(oExpParser);
-    //fprintf(stdout, "%u\n", ExpTokenTreeStack_howMany(oExpParser -> pettsOperandStack));
-    //fflush(stdout);
-    switch(state)
-      {
-      case START:
-	state = ExpParser_handleDFA_START(oExpParser);
-	break;
-      case AFTER_OPERATOR:
-	state = ExpParser_handleDFA_AFTER_OPERATOR(oExpParser);
-	break;
-      case AFTER_OPERAND:
-	state = ExpParser_handleDFA_AFTER_OPERAND(oExpParser);
-	break;
-      case ERROR:
-	//free the memory allocated
-	ExpParser_free(oExpParser);
-	//return an error signal
-	return EXIT_FAILURE;
-      case COMPLETE:
-	//Simplify and print the ExpParser
-	ExpParser_simplify(oExpParser);
-	
-	/*
-	//testing code
-	oTreeNodeMostCommon = ExpParser_mostCommonSubTree(oExpParser);
-	printf("Most Common Twig: ");
-	ExpTokenTree_print(oTreeNodeMostCommon);
-	printf("\n");
-	*/
-
-
-	/*
-	//testing code
-	oLinkListTwigs = ExpParser_expressionTwigs(oExpParser);
-	for(oLinkListScan = oLinkListTwigs;
-	    oLinkListScan != NULL;
-	    oLinkListScan = LinkList_getNext(oLinkListScan)){
-	  if(LinkList_isEmpty(oLinkListScan) == 0)
-	    break;
-	  fprintf(stdout, "---Twig %u---\n", uiTwig);
-	  ExpTokenTree_print\
-	    ((TreeNode_T)LinkList_getValue(oLinkListScan));
-	  printf("\n");
-	  uiTwig++;
-	}
-	LinkList_freeRecursive(oLinkListTwigs);
-	*/
-	
-	
-	//testing code
-	/*
-	  fprintf(stdout, "%i instances of '%s'\n",			\
-		ExpParser_howManySubTrees(oExpParser, oTreeNodeSearch),\
-		ExpToken_toString(oExpTokenSearch));
-	ExpTokenTree_free(oTreeNodeSearch);
-	*/
-	
-	//free the memory
-	ExpParser_free(oExpParser);
-	//return a successful exit status
-	return EXIT_SUCCESS;
-      }
+  //read the expressions, which end at the first newline
+  if(ExpParser_parseLine(oExpParser) != 0){
+    //free the memory allocated
+    ExpParser_free(oExpParser);
+    //return an error signal
+    return EXIT_FAILURE;
   }
+  //optionally rewrite the expressions into a cheaper form first
+  ExpParser_optimize(oExpParser);
+  //edit the program in a session, or simplify and print the ExpParser
+  if(oExpParser -> iSession != 0)
+    iStatus = ExpParser_session(oExpParser);
+  else
+    iStatus = ExpParser_simplify(oExpParser);
+  
+  /*
+  //testing code
+  oTreeNodeMostCommon = ExpParser_mostCommonSubTree(oExpParser);
+  printf("Most Common Twig: ");
+  ExpTokenTree_print(oTreeNodeMostCommon);
+  printf("\n");
+  */
+
+
+  /*
+  //testing code
+  oLinkListTwigs = ExpParser_expressionTwigs(oExpParser);
+  for(oLinkListScan = oLinkListTwigs;
+      oLinkListScan != NULL;
+      oLinkListScan = LinkList_getNext(oLinkListScan)){
+    if(LinkList_isEmpty(oLinkListScan) == 0)
+      break;
+    fprintf(stdout, "---Twig %u---\n", uiTwig);
+    ExpTokenTree_print\
+      ((TreeNode_T)LinkList_getValue(oLinkListScan));
+    printf("\n");
+    uiTwig++;
+  }
+  LinkList_freeRecursive(oLinkListTwigs);
+  */
+  
+  
+  //testing code
+  /*
+    fprintf(stdout, "%i instances of '%s'\n",			\
+	ExpParser_howManySubTrees(oExpParser, oTreeNodeSearch),\
+	ExpToken_toString(oExpTokenSearch));
+  ExpTokenTree_free(oTreeNodeSearch);
+  */
+  
+  //write out whatever is left in the output buffer
+  ExpOut_flush();
+  //free the memory
+  ExpParser_free(oExpParser);
+  //return the exit status
+  return iStatus == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
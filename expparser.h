@@ -41,9 +41,11 @@ void ExpParser_free(ExpParser_T oExpParser);
 /*substitutions that is close to the minimum number of operations      */
 /*needed to represent those expressions. Print this series to stdout.  */
 /*If oExpParser doesn't contain properly formatted expressions then    */
-/*print a warning to stderr instead                                    */
+/*print a warning to stderr instead. Return 0 if the series was        */
+/*written, 1 if memory was insufficient, -1 if it cannot be written in */
+/*the format configured                                                */
 /*---------------------------------------------------------------------*/
-//void ExpParser_simplify(ExpParser_T oExpParser);
+//int ExpParser_simplify(ExpParser_T oExpParser);
 
 
 #endif
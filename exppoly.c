@@ -0,0 +1,1137 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exppoly.c implements exppoly.h. A monomial is a sorted array of      */
+/*variable, exponent pairs, and the monomials of a polynomial are      */
+/*stored one after another in a single pool, with its terms kept sorted*/
+/*by monomial. Sums are then a merge of two sorted arrays, and products*/
+/*collect their terms in a hash table before sorting once              */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "exppoly.h"
+#include "expfold.h"
+#include "exprational.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the results of the conversions: POLY_NOT is returned for an   */
+/*expression that is not a polynomial, is too large, or whose          */
+/*coefficients do not fit                                              */
+/*---------------------------------------------------------------------*/
+#define POLY_OK 0
+#define POLY_MEMORY 1
+#define POLY_NOT -1
+
+/*---------------------------------------------------------------------*/
+/*Define the largest exponent of a variable in any monomial            */
+/*---------------------------------------------------------------------*/
+#define POLY_MAX_DEGREE 65536u
+
+/*---------------------------------------------------------------------*/
+/*A PolyTerm is a coefficient and the monomial it multiplies, which is */
+/*uiVars variable, exponent pairs starting at uiStart in the pool of   */
+/*its polynomial                                                       */
+/*---------------------------------------------------------------------*/
+struct PolyTerm
+{
+  unsigned int uiStart;
+  unsigned int uiVars;
+  struct ExpRational rCoef;
+};
+
+/*---------------------------------------------------------------------*/
+/*A Poly is a polynomial: its nonzero terms, sorted by monomial, and   */
+/*the pool holding their monomials                                     */
+/*---------------------------------------------------------------------*/
+struct Poly
+{
+  struct PolyTerm* ptTerms;
+  unsigned int uiTerms;
+  unsigned int uiTermCapacity;
+  unsigned int* puiPool;
+  unsigned int uiPool;
+  unsigned int uiPoolCapacity;
+};
+
+/*---------------------------------------------------------------------*/
+/*A PolyVars is the set of variables met so far. Variable k is the     */
+/*operand poLeaves[k], and puiSlots is an open addressing hash table of*/
+/*their numbers plus one, 0 marking an empty slot                      */
+/*---------------------------------------------------------------------*/
+struct PolyVars
+{
+  TreeNode_T* poLeaves;
+  unsigned int uiLength;
+  unsigned int uiCapacity;
+  unsigned int* puiSlots;
+  unsigned int uiSlots;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpPoly_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return child number uiIndex of oTreeNode, counting from 0            */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPoly_child(TreeNode_T oTreeNode, unsigned int uiIndex){
+  LinkList_T oLinkList;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  for(; uiIndex > 0u; uiIndex--)
+    oLinkList = LinkList_getNext(oLinkList);
+  assert(oLinkList != NULL);
+  return (TreeNode_T)LinkList_getValue(oLinkList);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the hash of the string pcName                                 */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpPoly_hashName(const char* pcName){
+  unsigned int uiHash = 5381u;
+  for(; *pcName != '\0'; pcName++)
+    uiHash = uiHash * 33u + (unsigned int)(unsigned char)*pcName;
+  return uiHash;
+}
+
+/*---------------------------------------------------------------------*/
+/*Make *ppPoly the zero polynomial, holding no memory                  */
+/*---------------------------------------------------------------------*/
+static void ExpPoly_init(struct Poly* ppPoly){
+  ppPoly -> ptTerms = NULL;
+  ppPoly -> uiTerms = 0u;
+  ppPoly -> uiTermCapacity = 0u;
+  ppPoly -> puiPool = NULL;
+  ppPoly -> uiPool = 0u;
+  ppPoly -> uiPoolCapacity = 0u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the memory held by *ppPoly and make it the zero polynomial      */
+/*---------------------------------------------------------------------*/
+static void ExpPoly_clear(struct Poly* ppPoly){
+  free(ppPoly -> ptTerms);
+  free(ppPoly -> puiPool);
+  ExpPoly_init(ppPoly);
+}
+
+/*---------------------------------------------------------------------*/
+/*Append to *ppPoly the term rCoef times the monomial of the uiVars    */
+/*pairs in puiPairs. The caller keeps the terms sorted. Return POLY_OK,*/
+/*POLY_MEMORY, or POLY_NOT if *ppPoly already has EXPPOLY_MAX_TERMS    */
+/*terms                                                                */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_append(struct Poly* ppPoly, const unsigned int* puiPairs,\
+			  unsigned int uiVars, struct ExpRational rCoef){
+  struct PolyTerm* ptTerms;
+  unsigned int* puiPool;
+  unsigned int uiCapacity;
+  if(ppPoly -> uiTerms == EXPPOLY_MAX_TERMS)
+    return POLY_NOT;
+  if(ppPoly -> uiTerms == ppPoly -> uiTermCapacity){
+    uiCapacity = (ppPoly -> uiTermCapacity == 0u) ?\
+      8u : 2u * ppPoly -> uiTermCapacity;
+    ptTerms = (struct PolyTerm*)realloc(ppPoly -> ptTerms,\
+				       uiCapacity * sizeof(struct PolyTerm));
+    if(ptTerms == NULL)
+      return POLY_MEMORY;
+    ppPoly -> ptTerms = ptTerms;
+    ppPoly -> uiTermCapacity = uiCapacity;
+  }
+  if(ppPoly -> uiPool + 2u * uiVars > ppPoly -> uiPoolCapacity){
+    uiCapacity = 2u * ppPoly -> uiPoolCapacity + 2u * uiVars + 16u;
+    puiPool = (unsigned int*)realloc(ppPoly -> puiPool,\
+				     uiCapacity * sizeof(unsigned int));
+    if(puiPool == NULL)
+      return POLY_MEMORY;
+    ppPoly -> puiPool = puiPool;
+    ppPoly -> uiPoolCapacity = uiCapacity;
+  }
+  ppPoly -> ptTerms[ppPoly -> uiTerms].uiStart = ppPoly -> uiPool;
+  ppPoly -> ptTerms[ppPoly -> uiTerms].uiVars = uiVars;
+  ppPoly -> ptTerms[ppPoly -> uiTerms].rCoef = rCoef;
+  ppPoly -> uiTerms++;
+  if(uiVars > 0u)
+    memcpy(ppPoly -> puiPool + ppPoly -> uiPool, puiPairs,\
+	   2u * uiVars * sizeof(unsigned int));
+  ppPoly -> uiPool += 2u * uiVars;
+  return POLY_OK;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the pairs of the monomial of term uiTerm of *ppPoly           */
+/*---------------------------------------------------------------------*/
+static const unsigned int* ExpPoly_pairs(const struct Poly* ppPoly,\
+					 unsigned int uiTerm){
+  return ppPoly -> puiPool + ppPoly -> ptTerms[uiTerm].uiStart;
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare the monomial of uiVars1 pairs in puiPairs1 with the one of   */
+/*uiVars2 pairs in puiPairs2. Return -1, 0 or 1 as the first sorts     */
+/*before, equal to or after the second                                 */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_compareMonomials(const unsigned int* puiPairs1,\
+				    unsigned int uiVars1,\
+				    const unsigned int* puiPairs2,\
+				    unsigned int uiVars2){
+  unsigned int uiIndex, uiLength;
+  uiLength = 2u * ((uiVars1 < uiVars2) ? uiVars1 : uiVars2);
+  for(uiIndex = 0u; uiIndex < uiLength; uiIndex++)
+    if(puiPairs1[uiIndex] != puiPairs2[uiIndex])
+      return (puiPairs1[uiIndex] < puiPairs2[uiIndex]) ? -1 : 1;
+  return (uiVars1 > uiVars2) - (uiVars1 < uiVars2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare term uiTerm1 of *ppPoly1 with term uiTerm2 of *ppPoly2 by    */
+/*monomial                                                             */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_compareTerms(const struct Poly* ppPoly1,\
+				unsigned int uiTerm1,\
+				const struct Poly* ppPoly2,\
+				unsigned int uiTerm2){
+  return ExpPoly_compareMonomials(ExpPoly_pairs(ppPoly1, uiTerm1),\
+				  ppPoly1 -> ptTerms[uiTerm1].uiVars,\
+				  ExpPoly_pairs(ppPoly2, uiTerm2),\
+				  ppPoly2 -> ptTerms[uiTerm2].uiVars);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in *ppResult, which must be the zero polynomial, the constant  */
+/*rValue. Return POLY_OK or POLY_MEMORY                                */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_constant(struct Poly* ppResult, struct ExpRational rValue){
+  if(ExpRational_sign(rValue) == 0)
+    return POLY_OK;
+  return ExpPoly_append(ppResult, NULL, 0u, rValue);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 and store the value of *ppPoly in *prValue if it is a       */
+/*constant, 0 if not                                                   */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_isConstant(const struct Poly* ppPoly,\
+			      struct ExpRational* prValue){
+  if(ppPoly -> uiTerms == 0u){
+    *prValue = ExpRational_fromInt(0ll);
+    return 1;
+  }
+  if(ppPoly -> uiTerms > 1u || ppPoly -> ptTerms[0].uiVars != 0u)
+    return 0;
+  *prValue = ppPoly -> ptTerms[0].rCoef;
+  return 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Multiply every coefficient of *ppPoly by rFactor. Return POLY_OK, or */
+/*POLY_NOT if a coefficient does not fit                               */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_scale(struct Poly* ppPoly, struct ExpRational rFactor){
+  unsigned int uiIndex;
+  if(ExpRational_sign(rFactor) == 0){
+    ppPoly -> uiTerms = 0u;
+    ppPoly -> uiPool = 0u;
+    return POLY_OK;
+  }
+  for(uiIndex = 0u; uiIndex < ppPoly -> uiTerms; uiIndex++)
+    if(ExpRational_multiply(ppPoly -> ptTerms[uiIndex].rCoef, rFactor,\
+			    &ppPoly -> ptTerms[uiIndex].rCoef) != 0)
+      return POLY_NOT;
+  return POLY_OK;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store *ppPoly1 + iSign * *ppPoly2 in *ppResult, which must be the    */
+/*zero polynomial, by merging their sorted terms. iSign is 1 or -1.    */
+/*Return POLY_OK, POLY_MEMORY or POLY_NOT                              */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_add(const struct Poly* ppPoly1, const struct Poly* ppPoly2,\
+		       int iSign, struct Poly* ppResult){
+  unsigned int uiIndex1 = 0u, uiIndex2 = 0u;
+  struct ExpRational rCoef;
+  int iCompare, iStatus = POLY_OK;
+  while(iStatus == POLY_OK &&\
+	(uiIndex1 < ppPoly1 -> uiTerms || uiIndex2 < ppPoly2 -> uiTerms)){
+    if(uiIndex1 == ppPoly1 -> uiTerms)
+      iCompare = 1;
+    else if(uiIndex2 == ppPoly2 -> uiTerms)
+      iCompare = -1;
+    else
+      iCompare = ExpPoly_compareTerms(ppPoly1, uiIndex1, ppPoly2, uiIndex2);
+    if(iCompare < 0){
+      iStatus = ExpPoly_append(ppResult, ExpPoly_pairs(ppPoly1, uiIndex1),\
+			       ppPoly1 -> ptTerms[uiIndex1].uiVars,\
+			       ppPoly1 -> ptTerms[uiIndex1].rCoef);
+      uiIndex1++;
+      continue;
+    }
+    rCoef = ppPoly2 -> ptTerms[uiIndex2].rCoef;
+    if(iSign < 0)
+      rCoef.llNum = -rCoef.llNum;
+    if(iCompare == 0 &&\
+       ExpRational_add(ppPoly1 -> ptTerms[uiIndex1++].rCoef, rCoef,\
+		       &rCoef) != 0)
+      iStatus = POLY_NOT;
+    else if(ExpRational_sign(rCoef) != 0)
+      iStatus = ExpPoly_append(ppResult, ExpPoly_pairs(ppPoly2, uiIndex2),\
+			       ppPoly2 -> ptTerms[uiIndex2].uiVars, rCoef);
+    uiIndex2++;
+  }
+  if(iStatus != POLY_OK)
+    ExpPoly_clear(ppResult);
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Sort the terms of *ppPoly by monomial with a merge sort, since qsort */
+/*cannot see the pool. Return POLY_OK or POLY_MEMORY                   */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_sort(struct Poly* ppPoly){
+  struct PolyTerm* ptTemp;
+  struct PolyTerm* ptSwap;
+  unsigned int uiWidth, uiStart, uiMiddle, uiEnd, uiIndex1, uiIndex2, uiOut;
+  if(ppPoly -> uiTerms < 2u)
+    return POLY_OK;
+  ptTemp = (struct PolyTerm*)malloc(ppPoly -> uiTerms *\
+				    sizeof(struct PolyTerm));
+  if(ptTemp == NULL)
+    return POLY_MEMORY;
+  for(uiWidth = 1u; uiWidth < ppPoly -> uiTerms; uiWidth *= 2u){
+    for(uiStart = 0u; uiStart < ppPoly -> uiTerms; uiStart += 2u * uiWidth){
+      uiMiddle = uiStart + uiWidth;
+      if(uiMiddle > ppPoly -> uiTerms)
+	uiMiddle = ppPoly -> uiTerms;
+      uiEnd = uiMiddle + uiWidth;
+      if(uiEnd > ppPoly -> uiTerms)
+	uiEnd = ppPoly -> uiTerms;
+      uiIndex1 = uiStart;
+      uiIndex2 = uiMiddle;
+      for(uiOut = uiStart; uiOut < uiEnd; uiOut++){
+	if(uiIndex2 == uiEnd ||\
+	   (uiIndex1 < uiMiddle &&\
+	    ExpPoly_compareTerms(ppPoly, uiIndex1, ppPoly, uiIndex2) <= 0))
+	  ptTemp[uiOut] = ppPoly -> ptTerms[uiIndex1++];
+	else
+	  ptTemp[uiOut] = ppPoly -> ptTerms[uiIndex2++];
+      }
+    }
+    ptSwap = ppPoly -> ptTerms;
+    ppPoly -> ptTerms = ptTemp;
+    ptTemp = ptSwap;
+  }
+  free(ptTemp);
+  //the array kept may be the one that was just big enough
+  ppPoly -> uiTermCapacity = ppPoly -> uiTerms;
+  return POLY_OK;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the hash of the monomial of uiVars pairs in puiPairs          */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpPoly_hashMonomial(const unsigned int* puiPairs,\
+					 unsigned int uiVars){
+  unsigned int uiHash = 2166136261u, uiIndex;
+  for(uiIndex = 0u; uiIndex < 2u * uiVars; uiIndex++)
+    uiHash = (uiHash ^ puiPairs[uiIndex]) * 16777619u;
+  return uiHash;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in puiPairs the product of the monomial of term uiTerm1 of     */
+/**ppPoly1 and that of term uiTerm2 of *ppPoly2, merging their sorted  */
+/*pairs, and in *puiVars its number of pairs. Return POLY_OK, or       */
+/*POLY_NOT if an exponent grows past POLY_MAX_DEGREE                   */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_multiplyMonomials(const struct Poly* ppPoly1,\
+				     unsigned int uiTerm1,\
+				     const struct Poly* ppPoly2,\
+				     unsigned int uiTerm2,\
+				     unsigned int* puiPairs,\
+				     unsigned int* puiVars){
+  const unsigned int* puiPairs1 = ExpPoly_pairs(ppPoly1, uiTerm1);
+  const unsigned int* puiPairs2 = ExpPoly_pairs(ppPoly2, uiTerm2);
+  unsigned int uiEnd1, uiEnd2, uiIndex1 = 0u, uiIndex2 = 0u, uiOut = 0u;
+  uiEnd1 = 2u * ppPoly1 -> ptTerms[uiTerm1].uiVars;
+  uiEnd2 = 2u * ppPoly2 -> ptTerms[uiTerm2].uiVars;
+  while(uiIndex1 < uiEnd1 || uiIndex2 < uiEnd2){
+    if(uiIndex2 == uiEnd2 ||\
+       (uiIndex1 < uiEnd1 && puiPairs1[uiIndex1] < puiPairs2[uiIndex2])){
+      puiPairs[uiOut] = puiPairs1[uiIndex1];
+      puiPairs[uiOut + 1u] = puiPairs1[uiIndex1 + 1u];
+      uiIndex1 += 2u;
+    }
+    else if(uiIndex1 == uiEnd1 || puiPairs2[uiIndex2] < puiPairs1[uiIndex1]){
+      puiPairs[uiOut] = puiPairs2[uiIndex2];
+      puiPairs[uiOut + 1u] = puiPairs2[uiIndex2 + 1u];
+      uiIndex2 += 2u;
+    }
+    else{
+      puiPairs[uiOut] = puiPairs1[uiIndex1];
+      puiPairs[uiOut + 1u] = puiPairs1[uiIndex1 + 1u] +\
+	puiPairs2[uiIndex2 + 1u];
+      if(puiPairs[uiOut + 1u] > POLY_MAX_DEGREE)
+	return POLY_NOT;
+      uiIndex1 += 2u;
+      uiIndex2 += 2u;
+    }
+    uiOut += 2u;
+  }
+  *puiVars = uiOut / 2u;
+  return POLY_OK;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the largest number of variables in a monomial of *ppPoly      */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpPoly_maxVars(const struct Poly* ppPoly){
+  unsigned int uiIndex, uiMax = 0u;
+  for(uiIndex = 0u; uiIndex < ppPoly -> uiTerms; uiIndex++)
+    if(ppPoly -> ptTerms[uiIndex].uiVars > uiMax)
+      uiMax = ppPoly -> ptTerms[uiIndex].uiVars;
+  return uiMax;
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the term rCoef times the monomial of uiVars pairs in puiPairs to */
+/*the unsorted *ppResult, using the hash table puiSlots of uiSlots     */
+/*slots, a power of two, holding the numbers of its terms plus one.    */
+/*Return POLY_OK, POLY_MEMORY or POLY_NOT                              */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_accumulate(struct Poly* ppResult, unsigned int* puiSlots,\
+			      unsigned int uiSlots,\
+			      const unsigned int* puiPairs,\
+			      unsigned int uiVars, struct ExpRational rCoef){
+  struct PolyTerm* ptTerm;
+  unsigned int uiSlot;
+  int iStatus;
+  for(uiSlot = ExpPoly_hashMonomial(puiPairs, uiVars) & (uiSlots - 1u);
+      puiSlots[uiSlot] != 0u;
+      uiSlot = (uiSlot + 1u) & (uiSlots - 1u)){
+    ptTerm = &ppResult -> ptTerms[puiSlots[uiSlot] - 1u];
+    if(ExpPoly_compareMonomials(ppResult -> puiPool + ptTerm -> uiStart,\
+				ptTerm -> uiVars, puiPairs, uiVars) == 0)
+      return (ExpRational_add(ptTerm -> rCoef, rCoef,\
+			      &ptTerm -> rCoef) != 0) ? POLY_NOT : POLY_OK;
+  }
+  iStatus = ExpPoly_append(ppResult, puiPairs, uiVars, rCoef);
+  if(iStatus == POLY_OK)
+    puiSlots[uiSlot] = ppResult -> uiTerms;
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store *ppPoly1 * *ppPoly2 in *ppResult, which must be the zero       */
+/*polynomial. Return POLY_OK, POLY_MEMORY or POLY_NOT                  */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_multiply(const struct Poly* ppPoly1,\
+			    const struct Poly* ppPoly2,\
+			    struct Poly* ppResult){
+  unsigned int* puiPairs;
+  unsigned int* puiSlots;
+  unsigned long ulProducts;
+  unsigned int uiSlots = 16u, uiIndex1, uiIndex2, uiVars, uiKept;
+  struct ExpRational rCoef;
+  int iStatus = POLY_OK;
+  if(ppPoly1 -> uiTerms == 0u || ppPoly2 -> uiTerms == 0u)
+    return POLY_OK;
+  //the table never holds more than EXPPOLY_MAX_TERMS terms
+  ulProducts = (unsigned long)ppPoly1 -> uiTerms * ppPoly2 -> uiTerms;
+  if(ulProducts > EXPPOLY_MAX_TERMS)
+    ulProducts = EXPPOLY_MAX_TERMS;
+  while(uiSlots < 2ul * ulProducts)
+    uiSlots *= 2u;
+  puiPairs = (unsigned int*)malloc((2u * (ExpPoly_maxVars(ppPoly1) +\
+					  ExpPoly_maxVars(ppPoly2)) + 1u) *\
+				   sizeof(unsigned int));
+  puiSlots = (unsigned int*)calloc(uiSlots, sizeof(unsigned int));
+  if(puiPairs == NULL || puiSlots == NULL)
+    iStatus = POLY_MEMORY;
+  for(uiIndex1 = 0u;
+      uiIndex1 < ppPoly1 -> uiTerms && iStatus == POLY_OK;
+      uiIndex1++)
+    for(uiIndex2 = 0u;
+	uiIndex2 < ppPoly2 -> uiTerms && iStatus == POLY_OK;
+	uiIndex2++){
+      if(ExpRational_multiply(ppPoly1 -> ptTerms[uiIndex1].rCoef,\
+			      ppPoly2 -> ptTerms[uiIndex2].rCoef,\
+			      &rCoef) != 0)
+	iStatus = POLY_NOT;
+      else
+	iStatus = ExpPoly_multiplyMonomials(ppPoly1, uiIndex1, ppPoly2,\
+					    uiIndex2, puiPairs, &uiVars);
+      if(iStatus == POLY_OK)
+	iStatus = ExpPoly_accumulate(ppResult, puiSlots, uiSlots, puiPairs,\
+				     uiVars, rCoef);
+    }
+  free(puiPairs);
+  free(puiSlots);
+  //terms that cancelled are dropped before sorting
+  uiKept = 0u;
+  for(uiIndex1 = 0u; uiIndex1 < ppResult -> uiTerms; uiIndex1++)
+    if(ExpRational_sign(ppResult -> ptTerms[uiIndex1].rCoef) != 0)
+      ppResult -> ptTerms[uiKept++] = ppResult -> ptTerms[uiIndex1];
+  ppResult -> uiTerms = uiKept;
+  if(iStatus == POLY_OK)
+    iStatus = ExpPoly_sort(ppResult);
+  if(iStatus != POLY_OK)
+    ExpPoly_clear(ppResult);
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store *ppPoly raised to the power uiExponent in *ppResult, which must*/
+/*be the zero polynomial, by repeated squaring. Return POLY_OK,        */
+/*POLY_MEMORY or POLY_NOT                                              */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_power(const struct Poly* ppPoly, unsigned int uiExponent,\
+			 struct Poly* ppResult){
+  struct Poly pBase, pNext, pZero;
+  int iStatus;
+  ExpPoly_init(&pBase);
+  ExpPoly_init(&pNext);
+  ExpPoly_init(&pZero);
+  iStatus = ExpPoly_constant(ppResult, ExpRational_fromInt(1ll));
+  //the base starts as a copy of *ppPoly
+  if(iStatus == POLY_OK)
+    iStatus = ExpPoly_add(ppPoly, &pZero, 1, &pBase);
+  while(iStatus == POLY_OK && uiExponent > 0u){
+    if(uiExponent % 2u == 1u){
+      iStatus = ExpPoly_multiply(ppResult, &pBase, &pNext);
+      ExpPoly_clear(ppResult);
+      *ppResult = pNext;
+      ExpPoly_init(&pNext);
+    }
+    uiExponent /= 2u;
+    if(iStatus == POLY_OK && uiExponent > 0u){
+      iStatus = ExpPoly_multiply(&pBase, &pBase, &pNext);
+      ExpPoly_clear(&pBase);
+      pBase = pNext;
+      ExpPoly_init(&pNext);
+    }
+  }
+  ExpPoly_clear(&pBase);
+  if(iStatus != POLY_OK)
+    ExpPoly_clear(ppResult);
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the memory held by *pvVars                                      */
+/*---------------------------------------------------------------------*/
+static void ExpPoly_freeVars(struct PolyVars* pvVars){
+  unsigned int uiIndex;
+  for(uiIndex = 0u; uiIndex < pvVars -> uiLength; uiIndex++)
+    ExpTokenTree_free(pvVars -> poLeaves[uiIndex]);
+  free(pvVars -> poLeaves);
+  free(pvVars -> puiSlots);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in *puiIndex the number of the variable named by the operand   */
+/*oTreeNode, adding it to *pvVars if it is new. Return POLY_OK or      */
+/*POLY_MEMORY                                                          */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_variable(struct PolyVars* pvVars, TreeNode_T oTreeNode,\
+			    unsigned int* puiIndex){
+  const char* pcName;
+  TreeNode_T* poLeaves;
+  unsigned int* puiSlots;
+  unsigned int uiSlot, uiSlots, uiIndex;
+  pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNode));
+  for(uiSlot = ExpPoly_hashName(pcName) & (pvVars -> uiSlots - 1u);
+      pvVars -> puiSlots[uiSlot] != 0u;
+      uiSlot = (uiSlot + 1u) & (pvVars -> uiSlots - 1u)){
+    uiIndex = pvVars -> puiSlots[uiSlot] - 1u;
+    if(strcmp(pcName, ExpToken_getName\
+	      (ExpTokenTree_getValue(pvVars -> poLeaves[uiIndex]))) == 0){
+      *puiIndex = uiIndex;
+      return POLY_OK;
+    }
+  }
+  //the table is kept at most half full, so growing it rehashes
+  if(2u * (pvVars -> uiLength + 1u) > pvVars -> uiSlots){
+    uiSlots = 2u * pvVars -> uiSlots;
+    puiSlots = (unsigned int*)calloc(uiSlots, sizeof(unsigned int));
+    if(puiSlots == NULL)
+      return POLY_MEMORY;
+    for(uiIndex = 0u; uiIndex < pvVars -> uiLength; uiIndex++){
+      for(uiSlot = ExpPoly_hashName(ExpToken_getName(ExpTokenTree_getValue\
+		    (pvVars -> poLeaves[uiIndex]))) & (uiSlots - 1u);
+	  puiSlots[uiSlot] != 0u;
+	  uiSlot = (uiSlot + 1u) & (uiSlots - 1u))
+	;
+      puiSlots[uiSlot] = uiIndex + 1u;
+    }
+    free(pvVars -> puiSlots);
+    pvVars -> puiSlots = puiSlots;
+    pvVars -> uiSlots = uiSlots;
+    for(uiSlot = ExpPoly_hashName(pcName) & (uiSlots - 1u);
+	puiSlots[uiSlot] != 0u;
+	uiSlot = (uiSlot + 1u) & (uiSlots - 1u))
+      ;
+  }
+  if(pvVars -> uiLength == pvVars -> uiCapacity){
+    poLeaves = (TreeNode_T*)realloc(pvVars -> poLeaves,\
+				    2u * pvVars -> uiCapacity *\
+				    sizeof(TreeNode_T));
+    if(poLeaves == NULL)
+      return POLY_MEMORY;
+    pvVars -> poLeaves = poLeaves;
+    pvVars -> uiCapacity *= 2u;
+  }
+  pvVars -> poLeaves[pvVars -> uiLength] = ExpTokenTree_copy(oTreeNode);
+  if(pvVars -> poLeaves[pvVars -> uiLength] == NULL)
+    return POLY_MEMORY;
+  pvVars -> puiSlots[uiSlot] = pvVars -> uiLength + 1u;
+  *puiIndex = pvVars -> uiLength++;
+  return POLY_OK;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the polynomial of the operand oTreeNode in *ppResult, which    */
+/*must be the zero polynomial. Return POLY_OK or POLY_MEMORY           */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_fromOperand(TreeNode_T oTreeNode, struct PolyVars* pvVars,\
+			       struct Poly* ppResult){
+  struct ExpRational rValue;
+  unsigned int puiPair[2];
+  int iStatus;
+  if(ExpFold_value(oTreeNode, &rValue))
+    return ExpPoly_constant(ppResult, rValue);
+  iStatus = ExpPoly_variable(pvVars, oTreeNode, &puiPair[0]);
+  if(iStatus != POLY_OK)
+    return iStatus;
+  puiPair[1] = 1u;
+  return ExpPoly_append(ppResult, puiPair, 1u, ExpRational_fromInt(1ll));
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the polynomial of oTreeNode in *ppResult, which must be the    */
+/*zero polynomial. Return POLY_OK, POLY_MEMORY, or POLY_NOT if         */
+/*oTreeNode is not a polynomial that can be held                       */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_fromTree(TreeNode_T oTreeNode, struct PolyVars* pvVars,\
+			    struct Poly* ppResult){
+  struct Poly pPoly1, pPoly2;
+  struct ExpRational rValue, rExponent;
+  enum ExpTokenType ettType;
+  int iStatus;
+  ettType = ExpPoly_type(oTreeNode);
+  if(ettType == OPERAND)
+    return ExpPoly_fromOperand(oTreeNode, pvVars, ppResult);
+  if(ettType != POSITIVE && ettType != NEGATIVE && ettType != RECIPROCAL &&\
+     ettType != ADD && ettType != SUBTRACT && ettType != MULTIPLY &&\
+     ettType != DIVIDE && ettType != POWER)
+    return POLY_NOT;
+  ExpPoly_init(&pPoly1);
+  ExpPoly_init(&pPoly2);
+  iStatus = ExpPoly_fromTree(ExpPoly_child(oTreeNode, 0u), pvVars, &pPoly1);
+  if(iStatus == POLY_OK && ettType != POSITIVE && ettType != NEGATIVE &&\
+     ettType != RECIPROCAL)
+    iStatus = ExpPoly_fromTree(ExpPoly_child(oTreeNode, 1u), pvVars,\
+			       &pPoly2);
+  if(iStatus != POLY_OK){
+    ExpPoly_clear(&pPoly1);
+    ExpPoly_clear(&pPoly2);
+    return iStatus;
+  }
+  switch(ettType)
+    {
+    case POSITIVE:
+      *ppResult = pPoly1;
+      ExpPoly_init(&pPoly1);
+      break;
+    case NEGATIVE:
+      iStatus = ExpPoly_scale(&pPoly1, ExpRational_fromInt(-1ll));
+      *ppResult = pPoly1;
+      ExpPoly_init(&pPoly1);
+      break;
+    case ADD:
+      iStatus = ExpPoly_add(&pPoly1, &pPoly2, 1, ppResult);
+      break;
+    case SUBTRACT:
+      iStatus = ExpPoly_add(&pPoly1, &pPoly2, -1, ppResult);
+      break;
+    case MULTIPLY:
+      iStatus = ExpPoly_multiply(&pPoly1, &pPoly2, ppResult);
+      break;
+    case RECIPROCAL:
+    case DIVIDE:
+      //only a division by a nonzero constant keeps a polynomial
+      if(ettType == RECIPROCAL){
+	pPoly2 = pPoly1;
+	ExpPoly_init(&pPoly1);
+	iStatus = ExpPoly_constant(&pPoly1, ExpRational_fromInt(1ll));
+      }
+      if(iStatus == POLY_OK &&\
+	 (ExpPoly_isConstant(&pPoly2, &rValue) == 0 ||\
+	  ExpRational_divide(ExpRational_fromInt(1ll), rValue,\
+			     &rValue) != 0))
+	iStatus = POLY_NOT;
+      if(iStatus == POLY_OK)
+	iStatus = ExpPoly_scale(&pPoly1, rValue);
+      *ppResult = pPoly1;
+      ExpPoly_init(&pPoly1);
+      break;
+    case POWER:
+      //a constant base may have any integer exponent
+      if(ExpPoly_isConstant(&pPoly2, &rExponent) == 0 ||\
+	 rExponent.llDen != 1ll)
+	iStatus = POLY_NOT;
+      else if(ExpPoly_isConstant(&pPoly1, &rValue))
+	iStatus = (ExpRational_power(rValue, rExponent, &rValue) != 0) ?\
+	  POLY_NOT : ExpPoly_constant(ppResult, rValue);
+      else if(rExponent.llNum < 0ll ||\
+	      rExponent.llNum > (long long)EXPPOLY_MAX_EXPONENT)
+	iStatus = POLY_NOT;
+      else
+	iStatus = ExpPoly_power(&pPoly1, (unsigned int)rExponent.llNum,\
+				ppResult);
+      break;
+    default:
+      assert(0);
+    }
+  ExpPoly_clear(&pPoly1);
+  ExpPoly_clear(&pPoly2);
+  if(iStatus != POLY_OK)
+    ExpPoly_clear(ppResult);
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a hash of *ppPoly, equal for equal polynomials                */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpPoly_hash(const struct Poly* ppPoly){
+  unsigned int uiHash = 0u, uiIndex;
+  const struct PolyTerm* ptTerm;
+  for(uiIndex = 0u; uiIndex < ppPoly -> uiTerms; uiIndex++){
+    ptTerm = &ppPoly -> ptTerms[uiIndex];
+    uiHash = uiHash * 31u +\
+      ExpPoly_hashMonomial(ExpPoly_pairs(ppPoly, uiIndex), ptTerm -> uiVars);
+    uiHash = uiHash * 31u + (unsigned int)ptTerm -> rCoef.llNum;
+    uiHash = uiHash * 31u + (unsigned int)ptTerm -> rCoef.llDen;
+  }
+  return uiHash;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if *ppPoly1 and *ppPoly2 are equal, 0 if not                */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_equals(const struct Poly* ppPoly1,\
+			  const struct Poly* ppPoly2){
+  unsigned int uiIndex;
+  if(ppPoly1 -> uiTerms != ppPoly2 -> uiTerms)
+    return 0;
+  for(uiIndex = 0u; uiIndex < ppPoly1 -> uiTerms; uiIndex++)
+    if(ppPoly1 -> ptTerms[uiIndex].rCoef.llNum !=\
+       ppPoly2 -> ptTerms[uiIndex].rCoef.llNum ||\
+       ppPoly1 -> ptTerms[uiIndex].rCoef.llDen !=\
+       ppPoly2 -> ptTerms[uiIndex].rCoef.llDen ||\
+       ExpPoly_compareTerms(ppPoly1, uiIndex, ppPoly2, uiIndex) != 0)
+      return 0;
+  return 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new node of type ettType whose children are oTreeNode1 and, */
+/*for binary operators, oTreeNode2, taking ownership of them. If memory*/
+/*is insufficient, or a child that is needed is NULL, free the children*/
+/*and return NULL                                                      */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPoly_newNode(enum ExpTokenType ettType,\
+				  TreeNode_T oTreeNode1,\
+				  TreeNode_T oTreeNode2){
+  ExpToken_T oExpToken = NULL;
+  TreeNode_T oTreeNode = NULL;
+  int iUnary;
+  iUnary = (ettType == NEGATIVE);
+  if(oTreeNode1 != NULL && (iUnary || oTreeNode2 != NULL)){
+    oExpToken = ExpToken_new();
+    oTreeNode = ExpTokenTree_new();
+  }
+  if(oExpToken != NULL && oTreeNode != NULL){
+    ExpToken_setType(oExpToken, ettType);
+    ExpTokenTree_setValue(oTreeNode, oExpToken);
+    oExpToken = NULL;
+    if(ExpTokenTree_addChild(oTreeNode, oTreeNode1) == 0){
+      oTreeNode1 = NULL;
+      if(iUnary || ExpTokenTree_addChild(oTreeNode, oTreeNode2) == 0)
+	return oTreeNode;
+    }
+  }
+  if(oExpToken != NULL)
+    ExpToken_free(oExpToken);
+  if(oTreeNode != NULL)
+    ExpTokenTree_free(oTreeNode);
+  if(oTreeNode1 != NULL)
+    ExpTokenTree_free(oTreeNode1);
+  if(oTreeNode2 != NULL)
+    ExpTokenTree_free(oTreeNode2);
+  return NULL;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new operand named by the literal of the magnitude of rValue,*/
+/*as folding writes it, and store POLY_OK, POLY_MEMORY, or POLY_NOT if */
+/*it has too many chars, in *piStatus                                  */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPoly_literal(struct ExpRational rValue, int* piStatus){
+  char pcDigits[48];
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode;
+  unsigned int uiIndex, uiSize;
+  uiSize = ExpToken_maxChars() + 1u;
+  if(uiSize > sizeof(pcDigits))
+    uiSize = sizeof(pcDigits);
+  if(ExpRational_literal(rValue, pcDigits, uiSize) != 0){
+    *piStatus = POLY_NOT;
+    return NULL;
+  }
+  *piStatus = POLY_MEMORY;
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return NULL;
+  for(uiIndex = 0u; pcDigits[uiIndex] != '\0'; uiIndex++)
+    ExpToken_appendChar(oExpToken, pcDigits[uiIndex]);
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  *piStatus = POLY_OK;
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree for the magnitude of term uiTerm of *ppPoly: the   */
+/*product of the powers of its variables, in order, times its          */
+/*coefficient unless that is 1. Store the status in *piStatus          */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPoly_term(const struct Poly* ppPoly,\
+			       unsigned int uiTerm,\
+			       const struct PolyVars* pvVars,\
+			       int* piStatus){
+  const struct PolyTerm* ptTerm = &ppPoly -> ptTerms[uiTerm];
+  const unsigned int* puiPairs = ExpPoly_pairs(ppPoly, uiTerm);
+  struct ExpRational rMagnitude = ptTerm -> rCoef;
+  TreeNode_T oTreeNode = NULL, oTreeNodeFactor;
+  unsigned int uiIndex;
+  rMagnitude.llNum = (rMagnitude.llNum < 0ll) ? -rMagnitude.llNum :\
+    rMagnitude.llNum;
+  *piStatus = POLY_OK;
+  if(ptTerm -> uiVars == 0u || ExpRational_equals(rMagnitude, 1ll) == 0){
+    oTreeNode = ExpPoly_literal(rMagnitude, piStatus);
+    if(*piStatus != POLY_OK)
+      return NULL;
+  }
+  for(uiIndex = 0u; uiIndex < ptTerm -> uiVars; uiIndex++){
+    oTreeNodeFactor =\
+      ExpTokenTree_copy(pvVars -> poLeaves[puiPairs[2u * uiIndex]]);
+    if(oTreeNodeFactor != NULL && puiPairs[2u * uiIndex + 1u] > 1u)
+      oTreeNodeFactor =\
+	ExpPoly_newNode(POWER, oTreeNodeFactor,\
+			ExpPoly_literal(ExpRational_fromInt\
+					((long long)puiPairs[2u * uiIndex + 1u]),\
+					piStatus));
+    if(oTreeNodeFactor != NULL && oTreeNode != NULL)
+      oTreeNodeFactor = ExpPoly_newNode(MULTIPLY, oTreeNode,\
+					oTreeNodeFactor);
+    else if(oTreeNode != NULL)
+      ExpTokenTree_free(oTreeNode);
+    oTreeNode = oTreeNodeFactor;
+    if(oTreeNode == NULL){
+      //an exponent always fits, so only memory can fail here
+      *piStatus = POLY_MEMORY;
+      return NULL;
+    }
+  }
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree for *ppPoly, its terms summed in order, each added */
+/*or subtracted by the sign of its coefficient. The first term with a  */
+/*positive coefficient leads, so that no term is negated unless every  */
+/*one is. Store the status in *piStatus                                */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPoly_toTree(const struct Poly* ppPoly,\
+				 const struct PolyVars* pvVars,\
+				 int* piStatus){
+  TreeNode_T oTreeNode, oTreeNodeTerm;
+  unsigned int uiIndex, uiLead;
+  if(ppPoly -> uiTerms == 0u)
+    return ExpPoly_literal(ExpRational_fromInt(0ll), piStatus);
+  for(uiLead = 0u; uiLead < ppPoly -> uiTerms; uiLead++)
+    if(ExpRational_sign(ppPoly -> ptTerms[uiLead].rCoef) > 0)
+      break;
+  if(uiLead == ppPoly -> uiTerms)
+    uiLead = 0u;
+  oTreeNode = ExpPoly_term(ppPoly, uiLead, pvVars, piStatus);
+  if(oTreeNode != NULL &&\
+     ExpRational_sign(ppPoly -> ptTerms[uiLead].rCoef) < 0){
+    oTreeNode = ExpPoly_newNode(NEGATIVE, oTreeNode, NULL);
+    if(oTreeNode == NULL)
+      *piStatus = POLY_MEMORY;
+  }
+  for(uiIndex = 0u;
+      uiIndex < ppPoly -> uiTerms && oTreeNode != NULL;
+      uiIndex++){
+    if(uiIndex == uiLead)
+      continue;
+    oTreeNodeTerm = ExpPoly_term(ppPoly, uiIndex, pvVars, piStatus);
+    if(oTreeNodeTerm == NULL){
+      ExpTokenTree_free(oTreeNode);
+      return NULL;
+    }
+    oTreeNode =\
+      ExpPoly_newNode((ExpRational_sign(ppPoly -> ptTerms[uiIndex].rCoef) < 0)\
+		      ? SUBTRACT : ADD, oTreeNode, oTreeNodeTerm);
+    if(oTreeNode == NULL)
+      *piStatus = POLY_MEMORY;
+  }
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the tree stored in oLinkList by oTreeNode, freeing the old   */
+/*one                                                                  */
+/*---------------------------------------------------------------------*/
+static void ExpPoly_replace(LinkList_T oLinkList, TreeNode_T oTreeNode){
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkList));
+  LinkList_setValue(oLinkList, oTreeNode);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations in the trees stored in pllTrees      */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpPoly_countOperations(LinkList_T pllTrees){
+  unsigned int uiCount = 0u;
+  for(; pllTrees != NULL; pllTrees = LinkList_getNext(pllTrees))
+    uiCount +=\
+      ExpFold_countOperations((TreeNode_T)LinkList_getValue(pllTrees));
+  return uiCount;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in puiFirst the number of the first expression with the same   */
+/*polynomial as each of the uiLength expressions whose polynomials are */
+/*in ppPolys, found by hashing. An expression that is not a polynomial,*/
+/*marked by a nonzero piStatus, is its own first. Return POLY_OK or    */
+/*POLY_MEMORY                                                          */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_findDuplicates(const struct Poly* ppPolys,\
+				  const int* piStatus, unsigned int uiLength,\
+				  unsigned int* puiFirst){
+  unsigned int* puiSlots;
+  unsigned int uiSlots = 16u, uiIndex, uiSlot;
+  while(uiSlots < 2u * uiLength)
+    uiSlots *= 2u;
+  puiSlots = (unsigned int*)calloc(uiSlots, sizeof(unsigned int));
+  if(puiSlots == NULL)
+    return POLY_MEMORY;
+  for(uiIndex = 0u; uiIndex < uiLength; uiIndex++){
+    puiFirst[uiIndex] = uiIndex;
+    if(piStatus[uiIndex] != POLY_OK)
+      continue;
+    for(uiSlot = ExpPoly_hash(&ppPolys[uiIndex]) & (uiSlots - 1u);
+	puiSlots[uiSlot] != 0u;
+	uiSlot = (uiSlot + 1u) & (uiSlots - 1u))
+      if(ExpPoly_equals(&ppPolys[uiIndex], &ppPolys[puiSlots[uiSlot] - 1u])){
+	puiFirst[uiIndex] = puiSlots[uiSlot] - 1u;
+	break;
+      }
+    if(puiSlots[uiSlot] == 0u)
+      puiSlots[uiSlot] = uiIndex + 1u;
+  }
+  free(puiSlots);
+  return POLY_OK;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the expressions stored in pllTrees given their polynomials in*/
+/*ppPolys, the status of their conversion in piStatus, and the first   */
+/*expression equal to each in puiFirst. Store the number of duplicates */
+/*replaced in *puiDuplicates. Return 0 if successful, 1 if memory is   */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpPoly_rewrite(LinkList_T pllTrees, const struct Poly* ppPolys,\
+			   const int* piStatus, const unsigned int* puiFirst,\
+			   const struct PolyVars* pvVars,\
+			   unsigned int* puiDuplicates){
+  LinkList_T oLinkList, oLinkListFirst;
+  TreeNode_T oTreeNode;
+  unsigned int uiIndex, uiStep;
+  int iStatus, iResult = 0;
+  *puiDuplicates = 0u;
+  for(oLinkList = pllTrees, uiIndex = 0u;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList), uiIndex++){
+    if(piStatus[uiIndex] != POLY_OK)
+      continue;
+    //the first expression with a polynomial was rewritten already
+    if(puiFirst[uiIndex] != uiIndex){
+      oLinkListFirst = pllTrees;
+      for(uiStep = 0u; uiStep < puiFirst[uiIndex]; uiStep++)
+	oLinkListFirst = LinkList_getNext(oLinkListFirst);
+      oTreeNode =\
+	ExpTokenTree_copy((TreeNode_T)LinkList_getValue(oLinkListFirst));
+      if(oTreeNode == NULL){
+	iResult = 1;
+	continue;
+      }
+      ExpPoly_replace(oLinkList, oTreeNode);
+      (*puiDuplicates)++;
+      continue;
+    }
+    oTreeNode = ExpPoly_toTree(&ppPolys[uiIndex], pvVars, &iStatus);
+    if(iStatus == POLY_MEMORY)
+      iResult = 1;
+    if(oTreeNode == NULL)
+      continue;
+    if(ExpFold_countOperations(oTreeNode) <=\
+       ExpFold_countOperations((TreeNode_T)LinkList_getValue(oLinkList)))
+      ExpPoly_replace(oLinkList, oTreeNode);
+    else
+      ExpTokenTree_free(oTreeNode);
+  }
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Put the polynomial trees stored in pllTrees into normal form         */
+/*---------------------------------------------------------------------*/
+int ExpPoly_apply(LinkList_T pllTrees, unsigned int* puiPolynomials,\
+		  unsigned int* puiDuplicates, unsigned int* puiBefore,\
+		  unsigned int* puiAfter){
+  struct PolyVars vVars;
+  struct Poly* ppPolys;
+  int* piStatus;
+  unsigned int* puiFirst;
+  LinkList_T oLinkList;
+  unsigned int uiLength, uiIndex, uiPolynomials = 0u, uiDuplicates = 0u;
+  int iResult = 0;
+  uiLength = LinkList_getLength(pllTrees);
+  if(puiBefore != NULL)
+    *puiBefore = ExpPoly_countOperations(pllTrees);
+  vVars.uiLength = 0u;
+  vVars.uiCapacity = 16u;
+  vVars.uiSlots = 32u;
+  vVars.poLeaves = (TreeNode_T*)malloc(vVars.uiCapacity * sizeof(TreeNode_T));
+  vVars.puiSlots = (unsigned int*)calloc(vVars.uiSlots, sizeof(unsigned int));
+  ppPolys = (struct Poly*)malloc((uiLength + 1u) * sizeof(struct Poly));
+  piStatus = (int*)malloc((uiLength + 1u) * sizeof(int));
+  puiFirst = (unsigned int*)malloc((uiLength + 1u) * sizeof(unsigned int));
+  if(vVars.poLeaves == NULL || vVars.puiSlots == NULL || ppPolys == NULL ||\
+     piStatus == NULL || puiFirst == NULL)
+    iResult = 1;
+  for(oLinkList = pllTrees, uiIndex = 0u;
+      oLinkList != NULL && iResult == 0;
+      oLinkList = LinkList_getNext(oLinkList), uiIndex++){
+    ExpPoly_init(&ppPolys[uiIndex]);
+    piStatus[uiIndex] =\
+      ExpPoly_fromTree((TreeNode_T)LinkList_getValue(oLinkList), &vVars,\
+		       &ppPolys[uiIndex]);
+    if(piStatus[uiIndex] == POLY_MEMORY)
+      iResult = 1;
+    else if(piStatus[uiIndex] == POLY_OK)
+      uiPolynomials++;
+  }
+  if(iResult == 0 &&\
+     ExpPoly_findDuplicates(ppPolys, piStatus, uiLength, puiFirst) != POLY_OK)
+    iResult = 1;
+  if(iResult == 0)
+    iResult = ExpPoly_rewrite(pllTrees, ppPolys, piStatus, puiFirst, &vVars,\
+			      &uiDuplicates);
+  //every polynomial up to uiIndex was initialized
+  if(ppPolys != NULL)
+    while(uiIndex > 0u)
+      ExpPoly_clear(&ppPolys[--uiIndex]);
+  if(vVars.poLeaves != NULL)
+    ExpPoly_freeVars(&vVars);
+  else
+    free(vVars.puiSlots);
+  free(ppPolys);
+  free(piStatus);
+  free(puiFirst);
+  if(puiPolynomials != NULL)
+    *puiPolynomials = uiPolynomials;
+  if(puiDuplicates != NULL)
+    *puiDuplicates = uiDuplicates;
+  if(puiAfter != NULL)
+    *puiAfter = ExpPoly_countOperations(pllTrees);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test exppoly.c                                                       */
+/*---------------------------------------------------------------------*/
+/*
+#include <stdio.h>
+
+int main(void){
+  LinkList_T pllTrees, pllSecond;
+  unsigned int uiPolynomials, uiDuplicates, uiBefore, uiAfter;
+
+  //(x+y)^2 and x*x+2*x*y+y*y are the same polynomial
+  pllTrees = LinkList_new();
+  pllSecond = LinkList_new();
+  LinkList_setValue(pllTrees,\
+		    ExpPoly_newNode(POWER,\
+		      ExpPoly_newNode(ADD, ExpTokenTree_newLeaf("x"),\
+				      ExpTokenTree_newLeaf("y")),\
+		      ExpTokenTree_newLeaf("2")));
+  LinkList_setValue(pllSecond,\
+		    ExpPoly_newNode(ADD,\
+				    ExpPoly_newNode(ADD,\
+				      ExpPoly_newNode(MULTIPLY,\
+					ExpTokenTree_newLeaf("x"),\
+					ExpTokenTree_newLeaf("x")),\
+				      ExpPoly_newNode(MULTIPLY,\
+					ExpPoly_newNode(MULTIPLY,\
+					  ExpTokenTree_newLeaf("2"),\
+					  ExpTokenTree_newLeaf("x")),\
+					ExpTokenTree_newLeaf("y"))),\
+				    ExpPoly_newNode(MULTIPLY,\
+				      ExpTokenTree_newLeaf("y"),\
+				      ExpTokenTree_newLeaf("y"))));
+  LinkList_setNext(pllTrees, pllSecond);
+  if(ExpPoly_apply(pllTrees, &uiPolynomials, &uiDuplicates, &uiBefore,\
+		   &uiAfter) != 0)
+    printf("failed test 1\n");
+  if(uiPolynomials != 2u || uiDuplicates != 1u)
+    printf("failed test 2\n");
+  if(ExpTokenTree_compare((TreeNode_T)LinkList_getValue(pllTrees),\
+			  (TreeNode_T)LinkList_getValue(pllSecond)) != 0)
+    printf("failed test 3\n");
+  if(uiBefore != 8u || uiAfter != 4u)
+    printf("failed test 4\n");
+  ExpTokenTree_printBracketed((TreeNode_T)LinkList_getValue(pllSecond));
+  printf("\n");
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllSecond));
+  LinkList_freeRecursive(pllTrees);
+  //(x+1)*(x-1) is x^2-1, led by its positive term
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees,\
+		    ExpPoly_newNode(MULTIPLY,\
+		      ExpPoly_newNode(ADD, ExpTokenTree_newLeaf("x"),\
+				      ExpTokenTree_newLeaf("1")),\
+		      ExpPoly_newNode(SUBTRACT, ExpTokenTree_newLeaf("x"),\
+				      ExpTokenTree_newLeaf("1"))));
+  if(ExpPoly_apply(pllTrees, &uiPolynomials, &uiDuplicates, &uiBefore,\
+		   &uiAfter) != 0 || uiAfter != 2u ||\
+     ExpToken_getType(ExpTokenTree_getValue\
+		      ((TreeNode_T)LinkList_getValue(pllTrees))) != SUBTRACT)
+    printf("failed test 5\n");
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_freeRecursive(pllTrees);
+  return 0;
+}
+*/
@@ -0,0 +1,42 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exppoly.h describes a pass over a list of ExpTokenTrees that puts    */
+/*polynomial expressions into a sparse normal form, a sum of monomials */
+/*with rational coefficients. Two expressions written differently but  */
+/*equal as polynomials get the same normal form, so the sharing hidden */
+/*by the way they were written is found                                */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPPOLY_INCLUDED
+#define EXPPOLY_INCLUDED
+
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the most terms a polynomial may have, and the largest integer */
+/*power that is expanded. An expression that needs more is not treated */
+/*as a polynomial                                                      */
+/*---------------------------------------------------------------------*/
+#define EXPPOLY_MAX_TERMS 4096u
+#define EXPPOLY_MAX_EXPONENT 64
+
+/*---------------------------------------------------------------------*/
+/*Convert every tree stored in the list pllTrees that is a polynomial  */
+/*in its operands, that is built from literals and operands by signs,  */
+/*sums, products, integer powers and divisions by constants, to its    */
+/*normal form. Expressions with the same normal form are all replaced  */
+/*by the tree of the first of them, so they are extracted as one. Any  */
+/*other expression is replaced by its normal form, rebuilt as a sum of */
+/*products of powers in a fixed order of the operands, when that needs */
+/*no more operations than it has. Store the number of polynomial       */
+/*expressions in puiPolynomials, the number found equal to an earlier  */
+/*one in puiDuplicates, and the number of operations before and after  */
+/*in puiBefore and puiAfter if they are not NULL. Return 0 if          */
+/*successful, 1 if memory is insufficient, in which case the trees are */
+/*still valid but may be only partially rewritten                      */
+/*---------------------------------------------------------------------*/
+int ExpPoly_apply(LinkList_T pllTrees, unsigned int* puiPolynomials,\
+		  unsigned int* puiDuplicates, unsigned int* puiBefore,\
+		  unsigned int* puiAfter);
+
+#endif
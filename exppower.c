@@ -0,0 +1,458 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exppower.c implements exppower.h. Addition chains are found by an    */
+/*iterative deepening search over ascending chains, bounded by a       */
+/*budget, and the union of binary method chains is used whenever the   */
+/*search cannot improve on it in time                                  */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "exppower.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the number of chains the search may visit for each base before*/
+/*settling for the best chain found so far                             */
+/*---------------------------------------------------------------------*/
+#define SEARCH_BUDGET 200000ul
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of the base and power arrays             */
+/*---------------------------------------------------------------------*/
+#define INITIAL_ITEMS 16u
+
+/*---------------------------------------------------------------------*/
+/*A PowerBase is a distinct base raised to integer powers somewhere in */
+/*the trees. aiLeft describes its addition chain: for every n in the   */
+/*chain other than 1, x^n is computed as x^aiLeft[n] * x^(n-aiLeft[n]).*/
+/*aiLeft[n] is 0 if n is not in the chain                              */
+/*---------------------------------------------------------------------*/
+struct PowerBase
+{
+  /*the base, owned by the trees*/
+  TreeNode_T oTreeNodeBase;
+  /*nonzero for every exponent applied to the base*/
+  char acTarget[EXPPOWER_MAX_EXPONENT + 1];
+  /*the addition chain*/
+  int aiLeft[EXPPOWER_MAX_EXPONENT + 1];
+};
+
+/*---------------------------------------------------------------------*/
+/*A PowerNode is a POWER node in the trees that is to be lowered       */
+/*---------------------------------------------------------------------*/
+struct PowerNode
+{
+  /*the POWER node, owned by the trees*/
+  TreeNode_T oTreeNode;
+  /*index of its base*/
+  unsigned int uiBase;
+  /*its exponent*/
+  int iExponent;
+};
+
+/*---------------------------------------------------------------------*/
+/*A PowerSet holds every base and every POWER node found in the trees  */
+/*---------------------------------------------------------------------*/
+struct PowerSet
+{
+  struct PowerBase* ppbBases;
+  unsigned int uiNumBases, uiMaxBases;
+  struct PowerNode* ppnNodes;
+  unsigned int uiNumNodes, uiMaxNodes;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpPower_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return child number uiIndex of oTreeNode, counting from 0            */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPower_child(TreeNode_T oTreeNode,\
+				 unsigned int uiIndex){
+  LinkList_T oLinkList;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  for(; uiIndex > 0u; uiIndex--)
+    oLinkList = LinkList_getNext(oLinkList);
+  assert(oLinkList != NULL);
+  return (TreeNode_T)LinkList_getValue(oLinkList);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the exponent of the POWER node oTreeNode if it is an integer  */
+/*literal between 1 and EXPPOWER_MAX_EXPONENT, and 0 otherwise         */
+/*---------------------------------------------------------------------*/
+static int ExpPower_exponent(TreeNode_T oTreeNode){
+  TreeNode_T oTreeNodeExp;
+  const char* pcName;
+  int iExponent = 0;
+  oTreeNodeExp = ExpPower_child(oTreeNode, 1u);
+  if(ExpPower_type(oTreeNodeExp) != OPERAND)
+    return 0;
+  pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNodeExp));
+  if(*pcName == '\0')
+    return 0;
+  for(; *pcName != '\0'; pcName++){
+    if(*pcName < '0' || *pcName > '9')
+      return 0;
+    iExponent = 10 * iExponent + (*pcName - '0');
+    if(iExponent > EXPPOWER_MAX_EXPONENT)
+      return 0;
+  }
+  return iExponent;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if oTreeNode1 and oTreeNode2 are equivalent, 0 if not. The  */
+/*exact comparison is tried first since it is far cheaper than the     */
+/*associative one on large trees and usually decides the question      */
+/*---------------------------------------------------------------------*/
+static int ExpPower_equal(TreeNode_T oTreeNode1, TreeNode_T oTreeNode2){
+  if(ExpTokenTree_compare(oTreeNode1, oTreeNode2) == 0)
+    return 1;
+  return ExpTokenTree_compareAssociative(oTreeNode1, oTreeNode2) == 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Record the POWER node oTreeNode with exponent iExponent in ppsSet,   */
+/*adding its base if it has not been seen before. Return 0 if          */
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpPower_record(struct PowerSet* ppsSet, TreeNode_T oTreeNode,\
+			   int iExponent){
+  TreeNode_T oTreeNodeBase;
+  struct PowerBase* ppbBases;
+  struct PowerNode* ppnNodes;
+  unsigned int uiBase, uiNewMax;
+  oTreeNodeBase = ExpPower_child(oTreeNode, 0u);
+  for(uiBase = 0u; uiBase < ppsSet -> uiNumBases; uiBase++)
+    if(ExpPower_equal(ppsSet -> ppbBases[uiBase].oTreeNodeBase,\
+		      oTreeNodeBase))
+      break;
+  if(uiBase == ppsSet -> uiNumBases){
+    if(ppsSet -> uiNumBases == ppsSet -> uiMaxBases){
+      uiNewMax = (ppsSet -> uiMaxBases == 0u) ?\
+	INITIAL_ITEMS : 2u * ppsSet -> uiMaxBases;
+      ppbBases = (struct PowerBase*)\
+	realloc(ppsSet -> ppbBases, uiNewMax * sizeof(struct PowerBase));
+      if(ppbBases == NULL)
+	return 1;
+      ppsSet -> ppbBases = ppbBases;
+      ppsSet -> uiMaxBases = uiNewMax;
+    }
+    memset(&ppsSet -> ppbBases[uiBase], 0, sizeof(struct PowerBase));
+    ppsSet -> ppbBases[uiBase].oTreeNodeBase = oTreeNodeBase;
+    ppsSet -> uiNumBases++;
+  }
+  if(ppsSet -> uiNumNodes == ppsSet -> uiMaxNodes){
+    uiNewMax = (ppsSet -> uiMaxNodes == 0u) ?\
+      INITIAL_ITEMS : 2u * ppsSet -> uiMaxNodes;
+    ppnNodes = (struct PowerNode*)\
+      realloc(ppsSet -> ppnNodes, uiNewMax * sizeof(struct PowerNode));
+    if(ppnNodes == NULL)
+      return 1;
+    ppsSet -> ppnNodes = ppnNodes;
+    ppsSet -> uiMaxNodes = uiNewMax;
+  }
+  ppsSet -> ppnNodes[ppsSet -> uiNumNodes].oTreeNode = oTreeNode;
+  ppsSet -> ppnNodes[ppsSet -> uiNumNodes].uiBase = uiBase;
+  ppsSet -> ppnNodes[ppsSet -> uiNumNodes].iExponent = iExponent;
+  ppsSet -> uiNumNodes++;
+  ppsSet -> ppbBases[uiBase].acTarget[iExponent] = 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Record every POWER node in oTreeNode that is to be lowered in ppsSet.*/
+/*Return 0 if successful, 1 if memory is insufficient                  */
+/*---------------------------------------------------------------------*/
+static int ExpPower_collect(TreeNode_T oTreeNode,\
+			    struct PowerSet* ppsSet){
+  LinkList_T oLinkList;
+  int iExponent;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(ExpPower_collect((TreeNode_T)LinkList_getValue(oLinkList),\
+			ppsSet) != 0)
+      return 1;
+  if(ExpPower_type(oTreeNode) != POWER)
+    return 0;
+  iExponent = ExpPower_exponent(oTreeNode);
+  if(iExponent == 0)
+    return 0;
+  return ExpPower_record(ppsSet, oTreeNode, iExponent);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in aiLeft the union of the binary method chains for every      */
+/*exponent in acTarget, which is always a valid chain for the whole    */
+/*set. Return the number of multiplications it needs                   */
+/*---------------------------------------------------------------------*/
+static int ExpPower_binaryChain(const char* acTarget, int* aiLeft){
+  int iTarget, iBit, iValue, iCount = 0;
+  for(iTarget = 2; iTarget <= EXPPOWER_MAX_EXPONENT; iTarget++){
+    if(acTarget[iTarget] == 0)
+      continue;
+    for(iBit = 0; (iTarget >> (iBit + 1)) != 0; iBit++)
+      ;
+    for(iValue = 1, iBit--; iBit >= 0; iBit--){
+      //double, then add one for every set bit
+      if(aiLeft[2 * iValue] == 0){
+	aiLeft[2 * iValue] = iValue;
+	iCount++;
+      }
+      iValue *= 2;
+      if(((iTarget >> iBit) & 1) != 0){
+	if(aiLeft[iValue + 1] == 0){
+	  aiLeft[iValue + 1] = 1;
+	  iCount++;
+	}
+	iValue++;
+      }
+    }
+  }
+  return iCount;
+}
+
+/*---------------------------------------------------------------------*/
+/*Extend the ascending addition chain aiChain of length iLength to     */
+/*cover every exponent in acTarget within iLimit elements, recording   */
+/*the chain in aiLeft. iMissing is the number of targets not yet in the*/
+/*chain and iMax the largest target. Return 1 if a chain was found, 0  */
+/*if not or if the budget at pulBudget ran out                         */
+/*---------------------------------------------------------------------*/
+static int ExpPower_search(int* aiChain, int iLength, int iLimit,\
+			   const char* acTarget, int iMissing, int iMax,\
+			   int* aiLeft, unsigned long* pulBudget){
+  char acTried[EXPPOWER_MAX_EXPONENT + 1];
+  int iI, iJ, iValue, iLast;
+  if(iMissing == 0)
+    return 1;
+  if(*pulBudget == 0ul)
+    return 0;
+  (*pulBudget)--;
+  //every missing target needs at least one more element
+  if(iLength + iMissing > iLimit)
+    return 0;
+  //doubling is the fastest the chain can grow
+  iLast = aiChain[iLength - 1];
+  for(iI = iLength; iI < iLimit && iLast < iMax; iI++)
+    iLast *= 2;
+  if(iLast < iMax)
+    return 0;
+  iLast = aiChain[iLength - 1];
+  memset(acTried, 0, sizeof(acTried));
+  for(iI = iLength - 1; iI >= 0; iI--){
+    if(2 * aiChain[iI] <= iLast)
+      break;
+    for(iJ = iI; iJ >= 0; iJ--){
+      iValue = aiChain[iI] + aiChain[iJ];
+      if(iValue <= iLast)
+	break;
+      if(iValue > iMax || acTried[iValue] != 0)
+	continue;
+      acTried[iValue] = 1;
+      aiChain[iLength] = iValue;
+      aiLeft[iValue] = aiChain[iI];
+      if(ExpPower_search(aiChain, iLength + 1, iLimit, acTarget,\
+			 iMissing - (acTarget[iValue] != 0), iMax,\
+			 aiLeft, pulBudget) != 0)
+	return 1;
+      aiLeft[iValue] = 0;
+    }
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Find a short addition chain covering every exponent applied to       */
+/*ppbBase and store it in its aiLeft. Return the number of             */
+/*multiplications the chain needs                                      */
+/*---------------------------------------------------------------------*/
+static int ExpPower_chain(struct PowerBase* ppbBase){
+  int aiChain[EXPPOWER_MAX_EXPONENT + 1];
+  int aiLeft[EXPPOWER_MAX_EXPONENT + 1];
+  int iTarget, iMissing = 0, iMax = 1, iLimit, iBest;
+  unsigned long ulBudget = SEARCH_BUDGET;
+  for(iTarget = 2; iTarget <= EXPPOWER_MAX_EXPONENT; iTarget++){
+    if(ppbBase -> acTarget[iTarget] != 0){
+      iMissing++;
+      iMax = iTarget;
+    }
+  }
+  if(iMissing == 0)
+    return 0;
+  //the binary method is the fallback and the bound to beat
+  iBest = ExpPower_binaryChain(ppbBase -> acTarget, ppbBase -> aiLeft);
+  aiChain[0] = 1;
+  for(iLimit = 1; iLimit < iBest + 1 && ulBudget != 0ul; iLimit++){
+    memset(aiLeft, 0, sizeof(aiLeft));
+    if(ExpPower_search(aiChain, 1, iLimit + 1, ppbBase -> acTarget,\
+		       iMissing, iMax, aiLeft, &ulBudget) != 0){
+      memcpy(ppbBase -> aiLeft, aiLeft, sizeof(aiLeft));
+      return iLimit;
+    }
+  }
+  return iBest;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new node multiplying oTreeNode1 by oTreeNode2, taking       */
+/*ownership of both. If memory is insufficient, or either is NULL      */
+/*because an earlier allocation failed, free them and return NULL      */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPower_multiply(TreeNode_T oTreeNode1,\
+				   TreeNode_T oTreeNode2){
+  ExpToken_T oExpToken = NULL;
+  TreeNode_T oTreeNode = NULL;
+  if(oTreeNode1 != NULL && oTreeNode2 != NULL){
+    oExpToken = ExpToken_new();
+    oTreeNode = ExpTokenTree_new();
+  }
+  if(oExpToken != NULL && oTreeNode != NULL){
+    ExpToken_setType(oExpToken, MULTIPLY);
+    ExpTokenTree_setValue(oTreeNode, oExpToken);
+    oExpToken = NULL;
+    if(ExpTokenTree_addChild(oTreeNode, oTreeNode1) == 0){
+      oTreeNode1 = NULL;
+      if(ExpTokenTree_addChild(oTreeNode, oTreeNode2) == 0)
+	return oTreeNode;
+    }
+  }
+  if(oExpToken != NULL)
+    ExpToken_free(oExpToken);
+  if(oTreeNode != NULL)
+    ExpTokenTree_free(oTreeNode);
+  if(oTreeNode1 != NULL)
+    ExpTokenTree_free(oTreeNode1);
+  if(oTreeNode2 != NULL)
+    ExpTokenTree_free(oTreeNode2);
+  return NULL;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree computing oTreeNodeBase^iExponent by following the */
+/*chain in aiLeft, or NULL if memory is insufficient. Equal powers are */
+/*built identically so that ExpParser_simplify computes each only once */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpPower_build(TreeNode_T oTreeNodeBase,\
+				 const int* aiLeft, int iExponent){
+  if(iExponent == 1)
+    return ExpTokenTree_copy(oTreeNodeBase);
+  assert(aiLeft[iExponent] != 0);
+  return ExpPower_multiply\
+    (ExpPower_build(oTreeNodeBase, aiLeft, aiLeft[iExponent]),\
+     ExpPower_build(oTreeNodeBase, aiLeft,\
+		    iExponent - aiLeft[iExponent]));
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace every recorded POWER node in the tree stored at *poTreeNode, */
+/*children first, so that a base containing powers is lowered before it*/
+/*is copied. Return 0 if successful, 1 if memory is insufficient       */
+/*---------------------------------------------------------------------*/
+static int ExpPower_rewrite(TreeNode_T* poTreeNode,\
+			    const struct PowerSet* ppsSet){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild, oTreeNodeNew;
+  unsigned int uiIndex;
+  const struct PowerNode* ppnNode;
+  for(oLinkList = ExpTokenTree_getChildren(*poTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    if(ExpPower_rewrite(&oTreeNodeChild, ppsSet) != 0)
+      return 1;
+    LinkList_setValue(oLinkList, oTreeNodeChild);
+  }
+  if(ExpPower_type(*poTreeNode) != POWER)
+    return 0;
+  for(uiIndex = 0u; uiIndex < ppsSet -> uiNumNodes; uiIndex++)
+    if(ppsSet -> ppnNodes[uiIndex].oTreeNode == *poTreeNode)
+      break;
+  if(uiIndex == ppsSet -> uiNumNodes)
+    return 0;
+  ppnNode = &ppsSet -> ppnNodes[uiIndex];
+  oTreeNodeNew =\
+    ExpPower_build(ExpPower_child(*poTreeNode, 0u),\
+		   ppsSet -> ppbBases[ppnNode -> uiBase].aiLeft,\
+		   ppnNode -> iExponent);
+  if(oTreeNodeNew == NULL)
+    return 1;
+  ExpTokenTree_free(*poTreeNode);
+  *poTreeNode = oTreeNodeNew;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Lower the integer powers in the trees stored in pllTrees. Return 0 if*/
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+int ExpPower_apply(LinkList_T pllTrees, unsigned int* puiPowers,\
+		   unsigned int* puiMultiplies){
+  struct PowerSet psSet = {NULL, 0u, 0u, NULL, 0u, 0u};
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNode;
+  unsigned int uiBase, uiMultiplies = 0u;
+  int iResult = 0;
+  for(oLinkList = pllTrees;
+      oLinkList != NULL && iResult == 0;
+      oLinkList = LinkList_getNext(oLinkList))
+    iResult = ExpPower_collect((TreeNode_T)LinkList_getValue(oLinkList),\
+			       &psSet);
+  if(iResult == 0){
+    //one chain per base serves every exponent applied to it
+    for(uiBase = 0u; uiBase < psSet.uiNumBases; uiBase++)
+      uiMultiplies +=\
+	(unsigned int)ExpPower_chain(&psSet.ppbBases[uiBase]);
+    for(oLinkList = pllTrees;
+	oLinkList != NULL && iResult == 0;
+	oLinkList = LinkList_getNext(oLinkList)){
+      oTreeNode = (TreeNode_T)LinkList_getValue(oLinkList);
+      iResult = ExpPower_rewrite(&oTreeNode, &psSet);
+      LinkList_setValue(oLinkList, oTreeNode);
+    }
+  }
+  if(puiPowers != NULL)
+    *puiPowers = psSet.uiNumNodes;
+  if(puiMultiplies != NULL)
+    *puiMultiplies = uiMultiplies;
+  free(psSet.ppbBases);
+  free(psSet.ppnNodes);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test exppower.c                                                      */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  struct PowerBase pbBase;
+  int iExponent;
+
+  //x^15 needs 5 multiplies, the binary method needs 6
+  memset(&pbBase, 0, sizeof(pbBase));
+  pbBase.acTarget[15] = 1;
+  if(ExpPower_chain(&pbBase) != 5)
+    printf("failed test 1\n");
+
+  //x^2, x^3 and x^5 together need 3
+  memset(&pbBase, 0, sizeof(pbBase));
+  pbBase.acTarget[2] = pbBase.acTarget[3] = pbBase.acTarget[5] = 1;
+  if(ExpPower_chain(&pbBase) != 3)
+    printf("failed test 2\n");
+
+  for(iExponent = 2; iExponent <= EXPPOWER_MAX_EXPONENT; iExponent++)
+    if(pbBase.aiLeft[iExponent] != 0)
+      printf("x^%i = x^%i * x^%i\n", iExponent, pbBase.aiLeft[iExponent],\
+	     iExponent - pbBase.aiLeft[iExponent]);
+  return 0;
+}
+*/
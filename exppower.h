@@ -0,0 +1,33 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exppower.h describes a pass over a list of ExpTokenTrees that lowers */
+/*integer powers into chains of multiplications. All of the exponents  */
+/*applied to the same base, across every tree, are served by one       */
+/*addition chain, so intermediate powers are computed once and shared  */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPPOWER_INCLUDED
+#define EXPPOWER_INCLUDED
+
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the largest exponent that is lowered. Larger powers are left  */
+/*as POWER operations                                                  */
+/*---------------------------------------------------------------------*/
+#define EXPPOWER_MAX_EXPONENT 64
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the trees stored in the list pllTrees in place, replacing    */
+/*every x^n with 1 <= n <= EXPPOWER_MAX_EXPONENT by a product of powers*/
+/*of x taken from the shortest addition chain found for the set of     */
+/*exponents applied to x. Store the number of powers lowered in        */
+/*puiPowers and the number of multiplications the chains need in       */
+/*puiMultiplies if they are not NULL. Return 0 if successful, 1 if     */
+/*memory is insufficient, in which case the trees are still valid but  */
+/*may be only partially rewritten                                      */
+/*---------------------------------------------------------------------*/
+int ExpPower_apply(LinkList_T pllTrees, unsigned int* puiPowers,\
+		   unsigned int* puiMultiplies);
+
+#endif
@@ -0,0 +1,370 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expprogram.c implements expprogram.h. Statements are kept in an array*/
+/*indexed by temporary number. Inlining moves subtrees from one        */
+/*statement to another rather than copying them, so it never allocates */
+/*and cannot fail                                                      */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expprogram.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of an ExpProgram                         */
+/*---------------------------------------------------------------------*/
+#define INITIAL_STATEMENTS 64u
+
+/*---------------------------------------------------------------------*/
+/*An ExpProgram holds the expression of each statement                 */
+/*---------------------------------------------------------------------*/
+struct ExpProgram
+{
+  /*the expression assigned by each statement*/
+  TreeNode_T* poValues;
+  /*number of statements stored*/
+  unsigned int uiLength;
+  /*number of statements that fit*/
+  unsigned int uiMax;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpProgram                                       */
+/*---------------------------------------------------------------------*/
+ExpProgram_T ExpProgram_new(void){
+  ExpProgram_T oExpProgram =\
+    (ExpProgram_T)malloc(sizeof(struct ExpProgram));
+  if(oExpProgram == NULL)
+    return NULL;
+  oExpProgram -> poValues =\
+    (TreeNode_T*)malloc(INITIAL_STATEMENTS * sizeof(TreeNode_T));
+  if(oExpProgram -> poValues == NULL){
+    free(oExpProgram);
+    return NULL;
+  }
+  oExpProgram -> uiLength = 0u;
+  oExpProgram -> uiMax = INITIAL_STATEMENTS;
+  return oExpProgram;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpProgram                                                     */
+/*---------------------------------------------------------------------*/
+void ExpProgram_free(ExpProgram_T oExpProgram){
+  unsigned int uiIndex;
+  assert(oExpProgram != NULL);
+  for(uiIndex = 0u; uiIndex < oExpProgram -> uiLength; uiIndex++)
+    ExpTokenTree_free(oExpProgram -> poValues[uiIndex]);
+  free(oExpProgram -> poValues);
+  free(oExpProgram);
+}
+
+/*---------------------------------------------------------------------*/
+/*Append a statement assigning oTreeNode                               */
+/*---------------------------------------------------------------------*/
+int ExpProgram_add(ExpProgram_T oExpProgram, TreeNode_T oTreeNode){
+  TreeNode_T* poValues;
+  assert(oExpProgram != NULL);
+  assert(oTreeNode != NULL);
+  if(oExpProgram -> uiLength == oExpProgram -> uiMax){
+    poValues = (TreeNode_T*)realloc(oExpProgram -> poValues,\
+				    2u * oExpProgram -> uiMax *\
+				    sizeof(TreeNode_T));
+    if(poValues == NULL)
+      return 1;
+    oExpProgram -> poValues = poValues;
+    oExpProgram -> uiMax *= 2u;
+  }
+  oExpProgram -> poValues[oExpProgram -> uiLength++] = oTreeNode;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of statements in oExpProgram                       */
+/*---------------------------------------------------------------------*/
+unsigned int ExpProgram_howMany(ExpProgram_T oExpProgram){
+  assert(oExpProgram != NULL);
+  return oExpProgram -> uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the expression of statement uiIndex                           */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpProgram_getValue(ExpProgram_T oExpProgram,\
+			       unsigned int uiIndex){
+  assert(oExpProgram != NULL);
+  assert(uiIndex < oExpProgram -> uiLength);
+  return oExpProgram -> poValues[uiIndex];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if pcName names a temporary                                 */
+/*---------------------------------------------------------------------*/
+int ExpProgram_isTemp(const char* pcName, unsigned int* puiIndex){
+  unsigned int uiIndex = 0u;
+  assert(pcName != NULL);
+  if(*pcName++ != EXPPROGRAM_TEMP_CHAR || *pcName == '\0')
+    return 0;
+  for(; *pcName != '\0'; pcName++){
+    if(*pcName < '0' || *pcName > '9')
+      return 0;
+    uiIndex = 10u * uiIndex + (unsigned int)(*pcName - '0');
+  }
+  if(puiIndex != NULL)
+    *puiIndex = uiIndex;
+  return 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations in oTreeNode                         */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpProgram_operations(TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild;
+  unsigned int uiOperations = 0u, uiChild = 0u;
+  int iFused;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return 0u;
+  iFused = (ExpToken_getType(ExpTokenTree_getValue(oTreeNode)) == FMA);
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    uiOperations += ExpProgram_operations(oTreeNodeChild);
+    //a fused multiply-add negates its product or its addend for free
+    if(iFused && uiChild != 1u &&\
+       ExpTokenTree_getChildren(oTreeNodeChild) != NULL &&\
+       ExpToken_getType(ExpTokenTree_getValue(oTreeNodeChild)) == NEGATIVE)
+      uiOperations--;
+    uiChild++;
+  }
+  return uiOperations + 1u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Move the expressions of the single use temporaries under oTreeNode   */
+/*into it, while *puiOperations, the size of the statement being built,*/
+/*stays within uiMaxOperations. Set the statements moved to NULL.      */
+/*Return the number moved                                              */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpProgram_inlineInto(ExpProgram_T oExpProgram,\
+					  TreeNode_T oTreeNode,\
+					  unsigned int* puiUses,\
+					  unsigned int* puiOperations,\
+					  unsigned int uiMaxOperations){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild, oTreeNodeValue;
+  unsigned int uiIndex, uiInlined = 0u, uiOperations;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    if(TreeNode_isLeaf(oTreeNodeChild) == 0){
+      uiInlined += ExpProgram_inlineInto(oExpProgram, oTreeNodeChild,\
+					 puiUses, puiOperations,\
+					 uiMaxOperations);
+      continue;
+    }
+    if(ExpProgram_isTemp(ExpToken_getName(ExpTokenTree_getValue\
+					  (oTreeNodeChild)), &uiIndex) == 0\
+       || uiIndex >= oExpProgram -> uiLength || puiUses[uiIndex] != 1u)
+      continue;
+    oTreeNodeValue = oExpProgram -> poValues[uiIndex];
+    uiOperations = ExpProgram_operations(oTreeNodeValue);
+    if(*puiOperations + uiOperations > uiMaxOperations)
+      continue;
+    //its own single use temporaries were inlined when it was visited
+    LinkList_setValue(oLinkList, oTreeNodeValue);
+    ExpTokenTree_free(oTreeNodeChild);
+    oExpProgram -> poValues[uiIndex] = NULL;
+    *puiOperations += uiOperations;
+    uiInlined++;
+  }
+  return uiInlined;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the total number of operations in oExpProgram                 */
+/*---------------------------------------------------------------------*/
+unsigned int ExpProgram_countOperations(ExpProgram_T oExpProgram){
+  unsigned int uiIndex, uiOperations = 0u;
+  assert(oExpProgram != NULL);
+  for(uiIndex = 0u; uiIndex < oExpProgram -> uiLength; uiIndex++)
+    uiOperations += ExpProgram_operations(oExpProgram -> poValues[uiIndex]);
+  return uiOperations;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rename every temporary under oTreeNode to its number in puiNumbers   */
+/*---------------------------------------------------------------------*/
+void ExpProgram_renumberTree(TreeNode_T oTreeNode,\
+			     unsigned int* puiNumbers,\
+			     unsigned int uiLength){
+  LinkList_T oLinkList;
+  unsigned int uiIndex;
+  char* pcName;
+  assert(oTreeNode != NULL);
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL){
+    pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNode));
+    //a name holds the temp char and 9 digits
+    if(ExpProgram_isTemp(pcName, &uiIndex) && uiIndex < uiLength){
+      assert(puiNumbers[uiIndex] < 1000000000u);
+      sprintf(pcName + 1, "%u", puiNumbers[uiIndex]);
+    }
+    return;
+  }
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    ExpProgram_renumberTree((TreeNode_T)LinkList_getValue(oLinkList),\
+			    puiNumbers, uiLength);
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the number of times oTreeNode uses each temporary to puiUses     */
+/*---------------------------------------------------------------------*/
+void ExpProgram_countUses(TreeNode_T oTreeNode, unsigned int* puiUses,\
+			  unsigned int uiLength){
+  LinkList_T oLinkList;
+  unsigned int uiIndex;
+  assert(oTreeNode != NULL);
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL){
+    if(ExpProgram_isTemp(ExpToken_getName(ExpTokenTree_getValue\
+					  (oTreeNode)), &uiIndex) &&\
+       uiIndex < uiLength)
+      puiUses[uiIndex]++;
+    return;
+  }
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    ExpProgram_countUses((TreeNode_T)LinkList_getValue(oLinkList),\
+			 puiUses, uiLength);
+}
+
+/*---------------------------------------------------------------------*/
+/*Take the expression of statement uiIndex                             */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpProgram_take(ExpProgram_T oExpProgram, unsigned int uiIndex){
+  TreeNode_T oTreeNode;
+  assert(oExpProgram != NULL);
+  assert(uiIndex < oExpProgram -> uiLength);
+  oTreeNode = oExpProgram -> poValues[uiIndex];
+  oExpProgram -> poValues[uiIndex] = NULL;
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Fill the empty statement uiIndex with oTreeNode                      */
+/*---------------------------------------------------------------------*/
+void ExpProgram_put(ExpProgram_T oExpProgram, unsigned int uiIndex,\
+		    TreeNode_T oTreeNode){
+  assert(oExpProgram != NULL);
+  assert(uiIndex < oExpProgram -> uiLength);
+  assert(oExpProgram -> poValues[uiIndex] == NULL);
+  assert(oTreeNode != NULL);
+  oExpProgram -> poValues[uiIndex] = oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Remove the empty statements of oExpProgram and renumber the rest     */
+/*---------------------------------------------------------------------*/
+void ExpProgram_compact(ExpProgram_T oExpProgram, LinkList_T pllTrees,\
+			unsigned int* puiNumbers){
+  LinkList_T oLinkList;
+  unsigned int uiIndex, uiLength;
+  assert(oExpProgram != NULL);
+  assert(puiNumbers != NULL || oExpProgram -> uiLength == 0u);
+  uiLength = oExpProgram -> uiLength;
+  oExpProgram -> uiLength = 0u;
+  for(uiIndex = 0u; uiIndex < uiLength; uiIndex++){
+    puiNumbers[uiIndex] = oExpProgram -> uiLength;
+    if(oExpProgram -> poValues[uiIndex] != NULL)
+      oExpProgram -> poValues[oExpProgram -> uiLength++] =\
+	oExpProgram -> poValues[uiIndex];
+  }
+  for(uiIndex = 0u; uiIndex < oExpProgram -> uiLength; uiIndex++)
+    ExpProgram_renumberTree(oExpProgram -> poValues[uiIndex],\
+			    puiNumbers, uiLength);
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(LinkList_getValue(oLinkList) != NULL)
+      ExpProgram_renumberTree((TreeNode_T)LinkList_getValue(oLinkList),\
+			      puiNumbers, uiLength);
+}
+
+/*---------------------------------------------------------------------*/
+/*Inline the single use temporaries of oExpProgram                     */
+/*---------------------------------------------------------------------*/
+unsigned int ExpProgram_inline(ExpProgram_T oExpProgram,\
+			       LinkList_T pllTrees,\
+			       unsigned int uiMaxOperations){
+  LinkList_T oLinkList;
+  unsigned int* puiUses;
+  unsigned int uiIndex, uiLength, uiOperations, uiInlined = 0u;
+  assert(oExpProgram != NULL);
+  uiLength = oExpProgram -> uiLength;
+  if(uiLength == 0u)
+    return 0u;
+  puiUses = (unsigned int*)calloc(uiLength, sizeof(unsigned int));
+  if(puiUses == NULL)
+    return 0u;
+  for(uiIndex = 0u; uiIndex < uiLength; uiIndex++)
+    ExpProgram_countUses(oExpProgram -> poValues[uiIndex],\
+			 puiUses, uiLength);
+  //an output is a use that can never be inlined
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(LinkList_getValue(oLinkList) != NULL)
+      ExpProgram_countUses((TreeNode_T)LinkList_getValue(oLinkList),\
+			   puiUses, uiLength);
+  for(uiIndex = 0u; uiIndex < uiLength; uiIndex++){
+    uiOperations = ExpProgram_operations(oExpProgram -> poValues[uiIndex]);
+    uiInlined += ExpProgram_inlineInto(oExpProgram,\
+				       oExpProgram -> poValues[uiIndex],\
+				       puiUses, &uiOperations,\
+				       uiMaxOperations);
+  }
+  //the same array holds the new numbers
+  ExpProgram_compact(oExpProgram, pllTrees, puiUses);
+  free(puiUses);
+  return uiInlined;
+}
+
+/*---------------------------------------------------------------------*/
+/*Print every statement of oExpProgram                                 */
+/*---------------------------------------------------------------------*/
+void ExpProgram_print(ExpProgram_T oExpProgram){
+  unsigned int uiIndex;
+  assert(oExpProgram != NULL);
+  for(uiIndex = 0u; uiIndex < oExpProgram -> uiLength; uiIndex++){
+    ExpOut_char(EXPPROGRAM_TEMP_CHAR);
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string(" = ");
+    ExpTokenTree_printBracketed(oExpProgram -> poValues[uiIndex]);
+    ExpOut_char('\n');
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expprogram.c                                                    */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  unsigned int uiIndex;
+
+  if(ExpProgram_isTemp("#12", &uiIndex) != 1 || uiIndex != 12u)
+    printf("failed test 1\n");
+  if(ExpProgram_isTemp("#", &uiIndex) != 0)
+    printf("failed test 2\n");
+  if(ExpProgram_isTemp("a12", &uiIndex) != 0)
+    printf("failed test 3\n");
+  if(ExpProgram_isTemp("#1a", &uiIndex) != 0)
+    printf("failed test 4\n");
+  return 0;
+}
+*/
@@ -0,0 +1,127 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expprogram.h describes the program ExpParser_simplify emits: a list  */
+/*of statements, each assigning an expression to a new temporary.      */
+/*Holding the whole program before printing it lets passes run over the*/
+/*emitted code, ex. inlining temporaries that are used only once       */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPPROGRAM_INCLUDED
+#define EXPPROGRAM_INCLUDED
+
+#include "treenode.h"
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the character that starts the name of a temporary. Temporary  */
+/*number k is named by this character followed by k in decimal         */
+/*---------------------------------------------------------------------*/
+#define EXPPROGRAM_TEMP_CHAR '#'
+
+/*---------------------------------------------------------------------*/
+/*An ExpProgram is a list of statements. Statement k assigns its       */
+/*expression to temporary k, and may only use temporaries before it    */
+/*---------------------------------------------------------------------*/
+typedef struct ExpProgram* ExpProgram_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpProgram, or NULL if memory is insufficient    */
+/*---------------------------------------------------------------------*/
+ExpProgram_T ExpProgram_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpProgram, including its expressions   */
+/*---------------------------------------------------------------------*/
+void ExpProgram_free(ExpProgram_T oExpProgram);
+
+/*---------------------------------------------------------------------*/
+/*Append a statement assigning oTreeNode to the next temporary. The    */
+/*program takes ownership of oTreeNode. Return 0 if successful, 1 if   */
+/*memory is insufficient, in which case oTreeNode is not taken         */
+/*---------------------------------------------------------------------*/
+int ExpProgram_add(ExpProgram_T oExpProgram, TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of statements in oExpProgram                       */
+/*---------------------------------------------------------------------*/
+unsigned int ExpProgram_howMany(ExpProgram_T oExpProgram);
+
+/*---------------------------------------------------------------------*/
+/*Return the expression of statement uiIndex of oExpProgram. The       */
+/*program keeps ownership                                              */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpProgram_getValue(ExpProgram_T oExpProgram,\
+			       unsigned int uiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Return 1 and store the number of the temporary in *puiIndex if pcName*/
+/*names a temporary, 0 if not                                          */
+/*---------------------------------------------------------------------*/
+int ExpProgram_isTemp(const char* pcName, unsigned int* puiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Return the total number of operations in the statements of           */
+/*oExpProgram. A fused multiply-add is one operation, along with a sign*/
+/*on its first factor or its addend, which it applies for free         */
+/*---------------------------------------------------------------------*/
+unsigned int ExpProgram_countOperations(ExpProgram_T oExpProgram);
+
+/*---------------------------------------------------------------------*/
+/*Rename every temporary k under oTreeNode with k < uiLength to        */
+/*temporary puiNumbers[k]. The new numbers must have at most 9 digits  */
+/*---------------------------------------------------------------------*/
+void ExpProgram_renumberTree(TreeNode_T oTreeNode,\
+			     unsigned int* puiNumbers,\
+			     unsigned int uiLength);
+
+/*---------------------------------------------------------------------*/
+/*Add the number of times oTreeNode uses each temporary k with k <     */
+/*uiLength to puiUses[k]                                               */
+/*---------------------------------------------------------------------*/
+void ExpProgram_countUses(TreeNode_T oTreeNode, unsigned int* puiUses,\
+			  unsigned int uiLength);
+
+/*---------------------------------------------------------------------*/
+/*Return the expression of statement uiIndex of oExpProgram and leave  */
+/*the statement empty. The caller takes ownership. An empty statement  */
+/*must not be used, and is removed by ExpProgram_compact               */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpProgram_take(ExpProgram_T oExpProgram, unsigned int uiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Make oTreeNode the expression of the empty statement uiIndex of      */
+/*oExpProgram. The program takes ownership of oTreeNode                */
+/*---------------------------------------------------------------------*/
+void ExpProgram_put(ExpProgram_T oExpProgram, unsigned int uiIndex,\
+		    TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Remove the empty statements of oExpProgram and renumber the remaining*/
+/*temporaries in order, in the statements and in the trees stored in   */
+/*the list pllTrees. puiNumbers, which must hold one entry per         */
+/*statement, is overwritten with the new numbers, so that compacting   */
+/*cannot fail                                                          */
+/*---------------------------------------------------------------------*/
+void ExpProgram_compact(ExpProgram_T oExpProgram, LinkList_T pllTrees,\
+			unsigned int* puiNumbers);
+
+/*---------------------------------------------------------------------*/
+/*Move the expression of every temporary used exactly once, by a later */
+/*statement, into that statement, as long as the statement is left with*/
+/*at most uiMaxOperations operations. Temporaries used by the trees    */
+/*stored in the list pllTrees, which are the outputs of the program,   */
+/*count as uses and are never inlined. The remaining temporaries are   */
+/*renumbered in order, in the statements and in pllTrees. Return the   */
+/*number of temporaries inlined                                        */
+/*---------------------------------------------------------------------*/
+unsigned int ExpProgram_inline(ExpProgram_T oExpProgram,\
+			       LinkList_T pllTrees,\
+			       unsigned int uiMaxOperations);
+
+/*---------------------------------------------------------------------*/
+/*Print every statement of oExpProgram to stdout, one per line, as the */
+/*temporary, " = ", and the expression                                 */
+/*---------------------------------------------------------------------*/
+void ExpProgram_print(ExpProgram_T oExpProgram);
+
+#endif
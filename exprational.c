@@ -0,0 +1,402 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exprational.c implements exprational.h. Magnitudes are kept below    */
+/*RATIONAL_LIMIT so that negation never overflows and every overflow   */
+/*check can be done before the operation it guards                     */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "exprational.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the largest magnitude a numerator or denominator may have     */
+/*---------------------------------------------------------------------*/
+#define RATIONAL_LIMIT 0x3FFFFFFFFFFFFFFFll
+
+/*---------------------------------------------------------------------*/
+/*Return the greatest common divisor of the non-negative llA and llB   */
+/*---------------------------------------------------------------------*/
+static long long ExpRational_gcd(long long llA, long long llB){
+  long long llTemp;
+  while(llB != 0ll){
+    llTemp = llA % llB;
+    llA = llB;
+    llB = llTemp;
+  }
+  return llA;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the magnitude of llValue                                      */
+/*---------------------------------------------------------------------*/
+static long long ExpRational_abs(long long llValue){
+  return (llValue < 0ll) ? -llValue : llValue;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store llA * llB in *pllResult. Return 0 if successful, 1 if the      */
+/*magnitude of the result would exceed RATIONAL_LIMIT                  */
+/*---------------------------------------------------------------------*/
+static int ExpRational_mulInt(long long llA, long long llB,\
+			      long long* pllResult){
+  if(llA != 0ll &&\
+     ExpRational_abs(llB) > RATIONAL_LIMIT / ExpRational_abs(llA))
+    return 1;
+  *pllResult = llA * llB;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store llA + llB in *pllResult. Return 0 if successful, 1 if the      */
+/*magnitude of the result would exceed RATIONAL_LIMIT                  */
+/*---------------------------------------------------------------------*/
+static int ExpRational_addInt(long long llA, long long llB,\
+			      long long* pllResult){
+  //both are below the limit, so the sum cannot overflow a long long
+  *pllResult = llA + llB;
+  return ExpRational_abs(*pllResult) > RATIONAL_LIMIT;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store llNum/llDen in lowest terms with a positive denominator in     */
+/**prResult. llDen must not be 0                                       */
+/*---------------------------------------------------------------------*/
+static void ExpRational_reduce(long long llNum, long long llDen,\
+			       struct ExpRational* prResult){
+  long long llGcd;
+  assert(llDen != 0ll);
+  if(llDen < 0ll){
+    llNum = -llNum;
+    llDen = -llDen;
+  }
+  llGcd = ExpRational_gcd(ExpRational_abs(llNum), llDen);
+  prResult -> llNum = llNum / llGcd;
+  prResult -> llDen = llDen / llGcd;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if pcName is a literal, 0 if not                            */
+/*---------------------------------------------------------------------*/
+int ExpRational_isLiteral(const char* pcName){
+  int iSeenDigit = 0, iSeenPoint = 0, iSeenSlash = 0, iNonzero = 0;
+  assert(pcName != NULL);
+  for(; *pcName != '\0'; pcName++){
+    if(*pcName == '.' && iSeenPoint == 0 && iSeenSlash == 0)
+      iSeenPoint = 1;
+    else if(*pcName == '/' && iSeenDigit != 0 && iSeenPoint == 0 &&\
+	    iSeenSlash == 0){
+      iSeenSlash = 1;
+      iSeenDigit = 0;
+      iNonzero = 0;
+    }
+    else if(*pcName >= '0' && *pcName <= '9'){
+      iSeenDigit = 1;
+      iNonzero |= (*pcName != '0');
+    }
+    else
+      return 0;
+  }
+  //the denominator of a fraction must not be zero
+  return iSeenDigit != 0 && (iSeenSlash == 0 || iNonzero != 0);
+}
+
+/*---------------------------------------------------------------------*/
+/*Parse the uiLength chars at pcDigits, digits with at most one decimal*/
+/*point, into *prValue. Return 0 if successful, -1 if the value does   */
+/*not fit                                                              */
+/*---------------------------------------------------------------------*/
+static int ExpRational_parseDecimal(const char* pcDigits, size_t uiLength,\
+				    struct ExpRational* prValue){
+  long long llNum = 0ll, llDen = 1ll;
+  int iSeenPoint = 0;
+  for(; uiLength > 0u; pcDigits++, uiLength--){
+    if(*pcDigits == '.'){
+      iSeenPoint = 1;
+      continue;
+    }
+    if(ExpRational_mulInt(llNum, 10ll, &llNum) != 0 ||\
+       ExpRational_addInt(llNum, (long long)(*pcDigits - '0'), &llNum) != 0)
+      return -1;
+    if(iSeenPoint != 0 && ExpRational_mulInt(llDen, 10ll, &llDen) != 0)
+      return -1;
+  }
+  ExpRational_reduce(llNum, llDen, prValue);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Parse the literal pcName into *prValue                               */
+/*---------------------------------------------------------------------*/
+int ExpRational_parse(const char* pcName, struct ExpRational* prValue){
+  struct ExpRational rDen;
+  const char* pcSlash;
+  assert(pcName != NULL);
+  assert(prValue != NULL);
+  if(ExpRational_isLiteral(pcName) == 0)
+    return -1;
+  pcSlash = strchr(pcName, '/');
+  if(pcSlash == NULL)
+    return ExpRational_parseDecimal(pcName, strlen(pcName), prValue);
+  if(ExpRational_parseDecimal(pcName, (size_t)(pcSlash - pcName),\
+			      prValue) != 0 ||\
+     ExpRational_parseDecimal(pcSlash + 1, strlen(pcSlash + 1), &rDen) != 0 ||\
+     ExpRational_divide(*prValue, rDen, prValue) != 0)
+    return -1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the value of the literal pcName as a double                   */
+/*---------------------------------------------------------------------*/
+double ExpRational_literalValue(const char* pcName){
+  char* pcEnd;
+  double dValue;
+  assert(ExpRational_isLiteral(pcName));
+  dValue = strtod(pcName, &pcEnd);
+  if(*pcEnd == '/')
+    dValue /= strtod(pcEnd + 1, NULL);
+  return dValue;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the rational equal to llValue                                 */
+/*---------------------------------------------------------------------*/
+struct ExpRational ExpRational_fromInt(long long llValue){
+  struct ExpRational rValue;
+  assert(ExpRational_abs(llValue) <= RATIONAL_LIMIT);
+  rValue.llNum = llValue;
+  rValue.llDen = 1ll;
+  return rValue;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 + rValue2 in *prResult                                 */
+/*---------------------------------------------------------------------*/
+int ExpRational_add(struct ExpRational rValue1, struct ExpRational rValue2,\
+		    struct ExpRational* prResult){
+  long long llNum1, llNum2, llDen;
+  if(ExpRational_mulInt(rValue1.llNum, rValue2.llDen, &llNum1) != 0 ||\
+     ExpRational_mulInt(rValue2.llNum, rValue1.llDen, &llNum2) != 0 ||\
+     ExpRational_addInt(llNum1, llNum2, &llNum1) != 0 ||\
+     ExpRational_mulInt(rValue1.llDen, rValue2.llDen, &llDen) != 0)
+    return 1;
+  ExpRational_reduce(llNum1, llDen, prResult);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 - rValue2 in *prResult                                 */
+/*---------------------------------------------------------------------*/
+int ExpRational_subtract(struct ExpRational rValue1,\
+			 struct ExpRational rValue2,\
+			 struct ExpRational* prResult){
+  rValue2.llNum = -rValue2.llNum;
+  return ExpRational_add(rValue1, rValue2, prResult);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 * rValue2 in *prResult                                 */
+/*---------------------------------------------------------------------*/
+int ExpRational_multiply(struct ExpRational rValue1,\
+			 struct ExpRational rValue2,\
+			 struct ExpRational* prResult){
+  long long llNum, llDen;
+  if(ExpRational_mulInt(rValue1.llNum, rValue2.llNum, &llNum) != 0 ||\
+     ExpRational_mulInt(rValue1.llDen, rValue2.llDen, &llDen) != 0)
+    return 1;
+  ExpRational_reduce(llNum, llDen, prResult);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 / rValue2 in *prResult                                 */
+/*---------------------------------------------------------------------*/
+int ExpRational_divide(struct ExpRational rValue1,\
+		       struct ExpRational rValue2,\
+		       struct ExpRational* prResult){
+  struct ExpRational rInverse;
+  if(rValue2.llNum == 0ll)
+    return -1;
+  rInverse.llNum = rValue2.llDen;
+  rInverse.llDen = rValue2.llNum;
+  if(rInverse.llDen < 0ll){
+    rInverse.llNum = -rInverse.llNum;
+    rInverse.llDen = -rInverse.llDen;
+  }
+  return ExpRational_multiply(rValue1, rInverse, prResult);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store rBase^rExponent in *prResult                                   */
+/*---------------------------------------------------------------------*/
+int ExpRational_power(struct ExpRational rBase,\
+		      struct ExpRational rExponent,\
+		      struct ExpRational* prResult){
+  struct ExpRational rResult = ExpRational_fromInt(1ll);
+  long long llCount;
+  if(rExponent.llDen != 1ll)
+    return 1;
+  if(rExponent.llNum < 0ll){
+    if(rBase.llNum == 0ll)
+      return -1;
+    if(ExpRational_divide(rResult, rBase, &rBase) != 0)
+      return 1;
+  }
+  //any base other than 0 and +-1 overflows long before 64 steps
+  for(llCount = ExpRational_abs(rExponent.llNum); llCount > 0ll; llCount--){
+    if(ExpRational_multiply(rResult, rBase, &rResult) != 0)
+      return 1;
+    if(ExpRational_abs(rResult.llNum) <= 1ll && rResult.llDen == 1ll &&\
+       llCount > 2ll)
+      llCount = 2ll - (llCount % 2ll);
+  }
+  *prResult = rResult;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the sign of rValue                                            */
+/*---------------------------------------------------------------------*/
+int ExpRational_sign(struct ExpRational rValue){
+  return (rValue.llNum > 0ll) - (rValue.llNum < 0ll);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if rValue equals llValue, 0 if not                          */
+/*---------------------------------------------------------------------*/
+int ExpRational_equals(struct ExpRational rValue, long long llValue){
+  return rValue.llDen == 1ll && rValue.llNum == llValue;
+}
+
+/*---------------------------------------------------------------------*/
+/*Write the digits of the magnitude of llValue to pcBuffer             */
+/*---------------------------------------------------------------------*/
+int ExpRational_digits(long long llValue, char* pcBuffer,\
+		       unsigned int uiSize){
+  int iLength;
+  assert(pcBuffer != NULL);
+  iLength = snprintf(pcBuffer, uiSize, "%lld", ExpRational_abs(llValue));
+  return iLength < 0 || (unsigned int)iLength >= uiSize;
+}
+
+/*---------------------------------------------------------------------*/
+/*Write the magnitude of rValue as a decimal literal to pcBuffer       */
+/*---------------------------------------------------------------------*/
+int ExpRational_decimal(struct ExpRational rValue, char* pcBuffer,\
+			unsigned int uiSize){
+  char pcDigits[32];
+  long long llDen, llNum;
+  unsigned int uiTwos = 0u, uiFives = 0u, uiPlaces, uiLength, uiIndex;
+  assert(pcBuffer != NULL);
+  //the denominator must divide a power of ten
+  for(llDen = rValue.llDen; llDen % 2ll == 0ll; llDen /= 2ll)
+    uiTwos++;
+  for(; llDen % 5ll == 0ll; llDen /= 5ll)
+    uiFives++;
+  if(llDen != 1ll)
+    return 1;
+  //scale the fraction to one over exactly that power of ten
+  llNum = ExpRational_abs(rValue.llNum);
+  uiPlaces = (uiTwos > uiFives) ? uiTwos : uiFives;
+  for(; uiTwos < uiPlaces; uiTwos++)
+    if(ExpRational_mulInt(llNum, 2ll, &llNum) != 0)
+      return 1;
+  for(; uiFives < uiPlaces; uiFives++)
+    if(ExpRational_mulInt(llNum, 5ll, &llNum) != 0)
+      return 1;
+  if(ExpRational_digits(llNum, pcDigits, sizeof(pcDigits)) != 0)
+    return 1;
+  //the digits are padded with zeros so the point has one to its left
+  uiLength = (unsigned int)strlen(pcDigits);
+  if(uiPlaces == 0u){
+    if(uiLength >= uiSize)
+      return 1;
+    strcpy(pcBuffer, pcDigits);
+    return 0;
+  }
+  if(uiLength <= uiPlaces){
+    memmove(pcDigits + uiPlaces + 1u - uiLength, pcDigits, uiLength + 1u);
+    memset(pcDigits, '0', uiPlaces + 1u - uiLength);
+    uiLength = uiPlaces + 1u;
+  }
+  if(uiLength + 1u >= uiSize)
+    return 1;
+  for(uiIndex = 0u; uiIndex < uiLength - uiPlaces; uiIndex++)
+    pcBuffer[uiIndex] = pcDigits[uiIndex];
+  pcBuffer[uiIndex] = '.';
+  strcpy(pcBuffer + uiIndex + 1u, pcDigits + uiIndex);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Write the magnitude of rValue as a literal to pcBuffer               */
+/*---------------------------------------------------------------------*/
+int ExpRational_literal(struct ExpRational rValue, char* pcBuffer,\
+			unsigned int uiSize){
+  int iLength;
+  assert(pcBuffer != NULL);
+  if(ExpRational_decimal(rValue, pcBuffer, uiSize) == 0)
+    return 0;
+  iLength = snprintf(pcBuffer, uiSize, "%lld/%lld",\
+		     ExpRational_abs(rValue.llNum), rValue.llDen);
+  return iLength < 0 || (unsigned int)iLength >= uiSize;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test exprational.c                                                   */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  struct ExpRational rValue1, rValue2, rResult;
+  char pcBuffer[32];
+
+  if(ExpRational_parse("0.25", &rValue1) != 0)
+    printf("failed test 1\n");
+  if(rValue1.llNum != 1ll || rValue1.llDen != 4ll)
+    printf("failed test 2\n");
+  rValue2 = ExpRational_fromInt(3ll);
+  if(ExpRational_add(rValue1, rValue2, &rResult) != 0 ||\
+     rResult.llNum != 13ll || rResult.llDen != 4ll)
+    printf("failed test 3\n");
+  if(ExpRational_divide(rValue2, ExpRational_fromInt(0ll), &rResult) != -1)
+    printf("failed test 4\n");
+  if(ExpRational_power(ExpRational_fromInt(2ll), ExpRational_fromInt(70ll),\
+		       &rResult) != 1)
+    printf("failed test 5\n");
+  if(ExpRational_power(ExpRational_fromInt(-1ll),\
+		       ExpRational_fromInt(1000001ll), &rResult) != 0 ||\
+     ExpRational_equals(rResult, -1ll) == 0)
+    printf("failed test 6\n");
+  if(ExpRational_decimal(rValue1, pcBuffer, sizeof(pcBuffer)) != 0 ||\
+     strcmp(pcBuffer, "0.25") != 0)
+    printf("failed test 7\n");
+  if(ExpRational_parse("0.003", &rValue1) != 0 ||\
+     ExpRational_decimal(rValue1, pcBuffer, sizeof(pcBuffer)) != 0 ||\
+     strcmp(pcBuffer, "0.003") != 0)
+    printf("failed test 8\n");
+  if(ExpRational_divide(ExpRational_fromInt(1ll), ExpRational_fromInt(3ll),\
+			&rResult) != 0 ||\
+     ExpRational_decimal(rResult, pcBuffer, sizeof(pcBuffer)) != 1)
+    printf("failed test 9\n");
+  //a literal too large to parse is still a literal
+  if(ExpRational_isLiteral(".5") == 0 ||\
+     ExpRational_isLiteral("123456789012345678901234") == 0 ||\
+     ExpRational_isLiteral("1e3") != 0 ||\
+     ExpRational_isLiteral("0x10") != 0 ||\
+     ExpRational_isLiteral("inf") != 0 ||\
+     ExpRational_isLiteral(".") != 0 ||\
+     ExpRational_isLiteral("1.2.3") != 0)
+    printf("failed test 10\n");
+  //a fraction is written as one when it has no finite decimal
+  if(ExpRational_literal(rResult, pcBuffer, sizeof(pcBuffer)) != 0 ||\
+     strcmp(pcBuffer, "1/3") != 0 ||\
+     ExpRational_parse(pcBuffer, &rValue1) != 0 ||\
+     rValue1.llNum != 1ll || rValue1.llDen != 3ll ||\
+     ExpRational_isLiteral("1/0") != 0 || ExpRational_isLiteral("1/") != 0)
+    printf("failed test 11\n");
+  return 0;
+}
+*/
@@ -0,0 +1,127 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exprational.h describes exact rational numbers used to fold the      */
+/*literal constants in expressions. Every operation reports overflow   */
+/*rather than losing precision, so a constant is only ever folded into */
+/*a value that is exactly right                                        */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPRATIONAL_INCLUDED
+#define EXPRATIONAL_INCLUDED
+
+/*---------------------------------------------------------------------*/
+/*An ExpRational is a small value type, passed and returned by value.  */
+/*It is always kept in lowest terms with a positive denominator        */
+/*---------------------------------------------------------------------*/
+struct ExpRational
+{
+  /*numerator*/
+  long long llNum;
+  /*denominator, always positive*/
+  long long llDen;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if pcName is a literal, 0 if not: digits with at most one   */
+/*decimal point among them (ex. 12, 0.25 or .5), or the fraction of two*/
+/*integers that folding writes for a constant with no finite decimal   */
+/*(ex. 1/3). Every pass and backend takes a leaf for a constant by this*/
+/*test, so 1e3, 0x10 or inf are operands everywhere                    */
+/*---------------------------------------------------------------------*/
+int ExpRational_isLiteral(const char* pcName);
+
+/*---------------------------------------------------------------------*/
+/*Store the literal pcName in *prValue. Integers (ex. 12), decimals    */
+/*(ex. 0.25) and fractions (ex. 1/3) are accepted. Return 0 if         */
+/*successful, -1 if pcName is not a literal or does not fit            */
+/*---------------------------------------------------------------------*/
+int ExpRational_parse(const char* pcName, struct ExpRational* prValue);
+
+/*---------------------------------------------------------------------*/
+/*Return the value of the literal pcName as the double nearest to it   */
+/*when its numerator and denominator are exact doubles                 */
+/*---------------------------------------------------------------------*/
+double ExpRational_literalValue(const char* pcName);
+
+/*---------------------------------------------------------------------*/
+/*Return the rational equal to the integer llValue                     */
+/*---------------------------------------------------------------------*/
+struct ExpRational ExpRational_fromInt(long long llValue);
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 + rValue2 in *prResult. Return 0 if successful, 1 if   */
+/*the result does not fit                                              */
+/*---------------------------------------------------------------------*/
+int ExpRational_add(struct ExpRational rValue1, struct ExpRational rValue2,\
+		    struct ExpRational* prResult);
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 - rValue2 in *prResult. Return 0 if successful, 1 if   */
+/*the result does not fit                                              */
+/*---------------------------------------------------------------------*/
+int ExpRational_subtract(struct ExpRational rValue1,\
+			 struct ExpRational rValue2,\
+			 struct ExpRational* prResult);
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 * rValue2 in *prResult. Return 0 if successful, 1 if   */
+/*the result does not fit                                              */
+/*---------------------------------------------------------------------*/
+int ExpRational_multiply(struct ExpRational rValue1,\
+			 struct ExpRational rValue2,\
+			 struct ExpRational* prResult);
+
+/*---------------------------------------------------------------------*/
+/*Store rValue1 / rValue2 in *prResult. Return 0 if successful, 1 if   */
+/*the result does not fit, -1 if rValue2 is zero                       */
+/*---------------------------------------------------------------------*/
+int ExpRational_divide(struct ExpRational rValue1,\
+		       struct ExpRational rValue2,\
+		       struct ExpRational* prResult);
+
+/*---------------------------------------------------------------------*/
+/*Store rBase raised to the power rExponent in *prResult. The exponent */
+/*must be an integer. Return 0 if successful, 1 if the result does not */
+/*fit or is not rational, -1 if zero is raised to a negative power     */
+/*---------------------------------------------------------------------*/
+int ExpRational_power(struct ExpRational rBase,\
+		      struct ExpRational rExponent,\
+		      struct ExpRational* prResult);
+
+/*---------------------------------------------------------------------*/
+/*Return the sign of rValue: -1, 0 or 1                                */
+/*---------------------------------------------------------------------*/
+int ExpRational_sign(struct ExpRational rValue);
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if rValue equals the integer llValue, 0 if not              */
+/*---------------------------------------------------------------------*/
+int ExpRational_equals(struct ExpRational rValue, long long llValue);
+
+/*---------------------------------------------------------------------*/
+/*Write the decimal digits of the magnitude of llValue to pcBuffer,    */
+/*which holds uiSize chars including the terminating '\0'. Return 0 if */
+/*successful, 1 if pcBuffer is too small                               */
+/*---------------------------------------------------------------------*/
+int ExpRational_digits(long long llValue, char* pcBuffer,\
+		       unsigned int uiSize);
+
+/*---------------------------------------------------------------------*/
+/*Write the magnitude of rValue as a decimal literal (ex. 0.25 or 4) to*/
+/*pcBuffer, which holds uiSize chars including the terminating '\0'.   */
+/*Return 0 if successful, 1 if rValue has no finite decimal expansion  */
+/*or pcBuffer is too small                                             */
+/*---------------------------------------------------------------------*/
+int ExpRational_decimal(struct ExpRational rValue, char* pcBuffer,\
+			unsigned int uiSize);
+
+/*---------------------------------------------------------------------*/
+/*Write the magnitude of rValue as a literal to pcBuffer, which holds  */
+/*uiSize chars including the terminating '\0': its decimal (ex. 4 or   */
+/*0.25) if that fits, or else the fraction in lowest terms (ex. 1/3).  */
+/*Return 0 if successful, 1 if pcBuffer is too small                   */
+/*---------------------------------------------------------------------*/
+int ExpRational_literal(struct ExpRational rValue, char* pcBuffer,\
+			unsigned int uiSize);
+
+#endif
@@ -0,0 +1,509 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exprecip.c implements exprecip.h, a pass that merges fractions over a*/
+/*common denominator and shares the reciprocals of repeated            */
+/*denominators                                                         */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "exprecip.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of a NodeList                            */
+/*---------------------------------------------------------------------*/
+#define INITIAL_NODES 16u
+
+/*---------------------------------------------------------------------*/
+/*A NodeList is a growable array of tree nodes. For the terms of a sum */
+/*each node also carries a sign, +1 if it is added and -1 if it is     */
+/*subtracted                                                           */
+/*---------------------------------------------------------------------*/
+struct NodeList
+{
+  /*the nodes*/
+  TreeNode_T* poNodes;
+  /*the sign of each node*/
+  int* piSigns;
+  /*number of nodes stored*/
+  unsigned int uiLength;
+  /*number of nodes that fit*/
+  unsigned int uiMax;
+};
+
+/*---------------------------------------------------------------------*/
+/*Append oTreeNode with sign iSign to pnlList. Return 0 if successful, */
+/*1 if memory is insufficient                                          */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_push(struct NodeList* pnlList, TreeNode_T oTreeNode,\
+			 int iSign){
+  TreeNode_T* poNodes;
+  int* piSigns;
+  unsigned int uiNewMax;
+  assert(pnlList != NULL);
+  if(pnlList -> uiLength == pnlList -> uiMax){
+    uiNewMax = (pnlList -> uiMax == 0u) ?\
+      INITIAL_NODES : 2u * pnlList -> uiMax;
+    poNodes = (TreeNode_T*)realloc(pnlList -> poNodes,\
+				   uiNewMax * sizeof(TreeNode_T));
+    if(poNodes == NULL)
+      return 1;
+    pnlList -> poNodes = poNodes;
+    piSigns = (int*)realloc(pnlList -> piSigns, uiNewMax * sizeof(int));
+    if(piSigns == NULL)
+      return 1;
+    pnlList -> piSigns = piSigns;
+    pnlList -> uiMax = uiNewMax;
+  }
+  pnlList -> poNodes[pnlList -> uiLength] = oTreeNode;
+  pnlList -> piSigns[pnlList -> uiLength] = iSign;
+  pnlList -> uiLength++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the arrays held by pnlList, but not the nodes they point to     */
+/*---------------------------------------------------------------------*/
+static void ExpRecip_clear(struct NodeList* pnlList){
+  assert(pnlList != NULL);
+  free(pnlList -> poNodes);
+  free(pnlList -> piSigns);
+  pnlList -> poNodes = NULL;
+  pnlList -> piSigns = NULL;
+  pnlList -> uiLength = 0u;
+  pnlList -> uiMax = 0u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpRecip_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return child number uiIndex of oTreeNode, counting from 0            */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpRecip_child(TreeNode_T oTreeNode,\
+				 unsigned int uiIndex){
+  LinkList_T oLinkList;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  for(; uiIndex > 0u; uiIndex--)
+    oLinkList = LinkList_getNext(oLinkList);
+  assert(oLinkList != NULL);
+  return (TreeNode_T)LinkList_getValue(oLinkList);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new node of type ettType whose children are oTreeNode1 and, */
+/*for binary operators, oTreeNode2. The new node takes ownership of the*/
+/*children. If memory is insufficient, or a child that is needed is    */
+/*NULL because an earlier allocation failed, free the children and     */
+/*return NULL                                                          */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpRecip_newNode(enum ExpTokenType ettType,\
+				   TreeNode_T oTreeNode1,\
+				   TreeNode_T oTreeNode2){
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode;
+  int iUnary;
+  iUnary = (ettType == NEGATIVE | ettType == RECIPROCAL);
+  oExpToken = NULL;
+  oTreeNode = NULL;
+  if(oTreeNode1 != NULL && (iUnary || oTreeNode2 != NULL)){
+    oExpToken = ExpToken_new();
+    oTreeNode = ExpTokenTree_new();
+  }
+  if(oExpToken == NULL | oTreeNode == NULL){
+    if(oExpToken != NULL)
+      ExpToken_free(oExpToken);
+    if(oTreeNode != NULL)
+      TreeNode_free(oTreeNode);
+    if(oTreeNode1 != NULL)
+      ExpTokenTree_free(oTreeNode1);
+    if(oTreeNode2 != NULL)
+      ExpTokenTree_free(oTreeNode2);
+    return NULL;
+  }
+  ExpToken_setType(oExpToken, ettType);
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  if(ExpTokenTree_addChild(oTreeNode, oTreeNode1) != 0){
+    ExpTokenTree_free(oTreeNode);
+    ExpTokenTree_free(oTreeNode1);
+    if(oTreeNode2 != NULL)
+      ExpTokenTree_free(oTreeNode2);
+    return NULL;
+  }
+  if(!iUnary && ExpTokenTree_addChild(oTreeNode, oTreeNode2) != 0){
+    ExpTokenTree_free(oTreeNode);
+    ExpTokenTree_free(oTreeNode2);
+    return NULL;
+  }
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Append the terms of the sum rooted at oTreeNode to pnlTerms,         */
+/*flattening nested additions and subtractions. iSign is the sign of   */
+/*the whole sum. Return 0 if successful, 1 if memory is insufficient   */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_collectTerms(TreeNode_T oTreeNode, int iSign,\
+				 struct NodeList* pnlTerms){
+  switch(ExpRecip_type(oTreeNode))
+    {
+    case ADD:
+      if(ExpRecip_collectTerms(ExpRecip_child(oTreeNode, 0u), iSign,\
+			       pnlTerms) != 0)
+	return 1;
+      return ExpRecip_collectTerms(ExpRecip_child(oTreeNode, 1u), iSign,\
+				   pnlTerms);
+    case SUBTRACT:
+      if(ExpRecip_collectTerms(ExpRecip_child(oTreeNode, 0u), iSign,\
+			       pnlTerms) != 0)
+	return 1;
+      return ExpRecip_collectTerms(ExpRecip_child(oTreeNode, 1u), -iSign,\
+				   pnlTerms);
+    default:
+      return ExpRecip_push(pnlTerms, oTreeNode, iSign);
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if oTreeNode1 and oTreeNode2 are equivalent, 0 if not. The  */
+/*exact comparison is tried first since it is far cheaper than the     */
+/*associative one on large trees and usually decides the question      */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_equal(TreeNode_T oTreeNode1, TreeNode_T oTreeNode2){
+  if(ExpTokenTree_compare(oTreeNode1, oTreeNode2) == 0)
+    return 1;
+  return ExpTokenTree_compareAssociative(oTreeNode1, oTreeNode2) == 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if oTreeNode1 and oTreeNode2 are both divisions by the same */
+/*denominator, 0 if not                                                */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_sameDenominator(TreeNode_T oTreeNode1,\
+				    TreeNode_T oTreeNode2){
+  if(ExpRecip_type(oTreeNode1) != DIVIDE |\
+     ExpRecip_type(oTreeNode2) != DIVIDE)
+    return 0;
+  return ExpRecip_equal(ExpRecip_child(oTreeNode1, 1u),\
+			ExpRecip_child(oTreeNode2, 1u));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree for the sum rooted at oTreeNode in which every     */
+/*group of fractions over the same denominator has been merged into one*/
+/*fraction. Return oTreeNode itself if there is nothing to merge, and  */
+/*NULL if memory is insufficient. oTreeNode is never altered           */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpRecip_mergeSum(TreeNode_T oTreeNode){
+  struct NodeList nlTerms = {NULL, NULL, 0u, 0u};
+  TreeNode_T oTreeNodeNew, oTreeNodeTerm, oTreeNodeNum;
+  int* piLeader;
+  unsigned int uiI, uiJ;
+  int iMerged = 0;
+  if(ExpRecip_collectTerms(oTreeNode, 1, &nlTerms) != 0){
+    ExpRecip_clear(&nlTerms);
+    return NULL;
+  }
+  piLeader = (int*)malloc(nlTerms.uiLength * sizeof(int));
+  if(piLeader == NULL){
+    ExpRecip_clear(&nlTerms);
+    return NULL;
+  }
+  //group every fraction with the first fraction over its denominator
+  for(uiI = 0u; uiI < nlTerms.uiLength; uiI++)
+    piLeader[uiI] = -1;
+  for(uiI = 0u; uiI < nlTerms.uiLength; uiI++){
+    if(piLeader[uiI] != -1)
+      continue;
+    piLeader[uiI] = (int)uiI;
+    for(uiJ = uiI + 1u; uiJ < nlTerms.uiLength; uiJ++){
+      if(piLeader[uiJ] == -1 &&\
+	 ExpRecip_sameDenominator(nlTerms.poNodes[uiI],\
+				  nlTerms.poNodes[uiJ])){
+	piLeader[uiJ] = (int)uiI;
+	iMerged = 1;
+      }
+    }
+  }
+  if(iMerged == 0){
+    free(piLeader);
+    ExpRecip_clear(&nlTerms);
+    return oTreeNode;
+  }
+  //rebuild the sum from copies, one term per group
+  oTreeNodeNew = NULL;
+  for(uiI = 0u; uiI < nlTerms.uiLength; uiI++){
+    if(piLeader[uiI] != (int)uiI)
+      continue;
+    oTreeNodeTerm = nlTerms.poNodes[uiI];
+    //numerators join the group leader's sign, so (+a/b)-(c/b)=(a-c)/b
+    for(uiJ = uiI + 1u; uiJ < nlTerms.uiLength; uiJ++)
+      if(piLeader[uiJ] == (int)uiI)
+	break;
+    if(uiJ == nlTerms.uiLength)
+      oTreeNodeTerm = ExpTokenTree_copy(oTreeNodeTerm);
+    else{
+      oTreeNodeNum = ExpTokenTree_copy(ExpRecip_child(oTreeNodeTerm, 0u));
+      for(; uiJ < nlTerms.uiLength; uiJ++){
+	if(piLeader[uiJ] != (int)uiI)
+	  continue;
+	oTreeNodeNum =\
+	  ExpRecip_newNode((nlTerms.piSigns[uiJ] == nlTerms.piSigns[uiI])\
+			   ? ADD : SUBTRACT, oTreeNodeNum,\
+			   ExpTokenTree_copy\
+			   (ExpRecip_child(nlTerms.poNodes[uiJ], 0u)));
+      }
+      oTreeNodeTerm =\
+	ExpRecip_newNode(DIVIDE, oTreeNodeNum,\
+			 ExpTokenTree_copy(ExpRecip_child(oTreeNodeTerm, 1u)));
+    }
+    if(oTreeNodeNew == NULL && oTreeNodeTerm != NULL)
+      oTreeNodeNew = (nlTerms.piSigns[uiI] > 0) ? oTreeNodeTerm :\
+	ExpRecip_newNode(NEGATIVE, oTreeNodeTerm, NULL);
+    else
+      oTreeNodeNew =\
+	ExpRecip_newNode((nlTerms.piSigns[uiI] > 0) ? ADD : SUBTRACT,\
+			 oTreeNodeNew, oTreeNodeTerm);
+    if(oTreeNodeNew == NULL)
+      break;
+  }
+  free(piLeader);
+  ExpRecip_clear(&nlTerms);
+  return oTreeNodeNew;
+}
+
+/*---------------------------------------------------------------------*/
+/*Merge the fractions in every sum of the tree stored at *poTreeNode,  */
+/*replacing *poTreeNode if its root sum changes. iInSum is 1 if the    */
+/*parent of *poTreeNode is itself an addition or subtraction, in which */
+/*case the parent handles the whole sum. Return 0 if successful, 1 if  */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_merge(TreeNode_T* poTreeNode, int iInSum){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeChild, oTreeNodeNew;
+  enum ExpTokenType ettType;
+  int iIsSum;
+  ettType = ExpRecip_type(*poTreeNode);
+  iIsSum = (ettType == ADD | ettType == SUBTRACT);
+  //fractions in the terms are merged before the sum itself
+  for(oLinkList = ExpTokenTree_getChildren(*poTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    if(ExpRecip_merge(&oTreeNodeChild, iIsSum) != 0)
+      return 1;
+    LinkList_setValue(oLinkList, oTreeNodeChild);
+  }
+  if(!iIsSum || iInSum)
+    return 0;
+  oTreeNodeNew = ExpRecip_mergeSum(*poTreeNode);
+  if(oTreeNodeNew == NULL)
+    return 1;
+  if(oTreeNodeNew != *poTreeNode){
+    ExpTokenTree_free(*poTreeNode);
+    *poTreeNode = oTreeNodeNew;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Append every node of oTreeNode whose type is iType1 or iType2 to     */
+/*pnlNodes, parents before children. Return 0 if successful, 1 if      */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_collectNodes(TreeNode_T oTreeNode,\
+				 enum ExpTokenType ettType1,\
+				 enum ExpTokenType ettType2,\
+				 struct NodeList* pnlNodes){
+  LinkList_T oLinkList;
+  enum ExpTokenType ettType;
+  ettType = ExpRecip_type(oTreeNode);
+  if(ettType == ettType1 | ettType == ettType2)
+    if(ExpRecip_push(pnlNodes, oTreeNode, 0) != 0)
+      return 1;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(ExpRecip_collectNodes((TreeNode_T)LinkList_getValue(oLinkList),\
+			     ettType1, ettType2, pnlNodes) != 0)
+      return 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Collect the division and reciprocal nodes of every tree in pllTrees  */
+/*into pnlNodes. Return 0 if successful, 1 if memory is insufficient   */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_collectDivisions(LinkList_T pllTrees,\
+				     struct NodeList* pnlNodes){
+  LinkList_T oLinkList;
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(ExpRecip_collectNodes((TreeNode_T)LinkList_getValue(oLinkList),\
+			     DIVIDE, RECIPROCAL, pnlNodes) != 0)
+      return 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of distinct division and reciprocal operations in  */
+/*the trees of pllTrees, which is how many ExpParser_simplify will emit*/
+/*---------------------------------------------------------------------*/
+static unsigned int ExpRecip_countDivisions(LinkList_T pllTrees){
+  struct NodeList nlNodes = {NULL, NULL, 0u, 0u};
+  unsigned int uiI, uiJ, uiCount = 0u;
+  if(ExpRecip_collectDivisions(pllTrees, &nlNodes) != 0){
+    ExpRecip_clear(&nlNodes);
+    return 0u;
+  }
+  for(uiI = 0u; uiI < nlNodes.uiLength; uiI++){
+    for(uiJ = 0u; uiJ < uiI; uiJ++)
+      if(ExpRecip_equal(nlNodes.poNodes[uiI], nlNodes.poNodes[uiJ]))
+	break;
+    if(uiJ == uiI)
+      uiCount++;
+  }
+  ExpRecip_clear(&nlNodes);
+  return uiCount;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if oTreeNode is the operand 1, 0 if not                     */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_isOne(TreeNode_T oTreeNode){
+  ExpToken_T oExpToken = ExpTokenTree_getValue(oTreeNode);
+  return ExpToken_getType(oExpToken) == OPERAND &&\
+    strcmp(ExpToken_getName(oExpToken), "1") == 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the division oTreeNode in place as a reciprocal if its       */
+/*numerator is 1, and as a multiplication by the reciprocal of its     */
+/*denominator otherwise. Return 0 if successful, 1 if memory is        */
+/*insufficient, in which case oTreeNode is unchanged                   */
+/*---------------------------------------------------------------------*/
+static int ExpRecip_toReciprocal(TreeNode_T oTreeNode){
+  LinkList_T oLinkListNum, oLinkListDen;
+  TreeNode_T oTreeNodeRecip;
+  oLinkListNum = ExpTokenTree_getChildren(oTreeNode);
+  oLinkListDen = LinkList_getNext(oLinkListNum);
+  if(ExpRecip_isOne((TreeNode_T)LinkList_getValue(oLinkListNum))){
+    //1/y: drop the numerator and keep y as the only child
+    ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkListNum));
+    LinkList_setValue(oLinkListNum, LinkList_getValue(oLinkListDen));
+    LinkList_setNext(oLinkListNum, NULL);
+    LinkList_free(oLinkListDen);
+    ExpToken_setType(ExpTokenTree_getValue(oTreeNode), RECIPROCAL);
+    return 0;
+  }
+  //x/y: becomes x*(1/y)
+  oTreeNodeRecip =\
+    ExpRecip_newNode(RECIPROCAL,\
+		     (TreeNode_T)LinkList_getValue(oLinkListDen), NULL);
+  if(oTreeNodeRecip == NULL)
+    return 1;
+  LinkList_setValue(oLinkListDen, oTreeNodeRecip);
+  ExpToken_setType(ExpTokenTree_getValue(oTreeNode), MULTIPLY);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the trees stored in the list pllTrees to merge fractions and */
+/*share reciprocals. Return 0 if successful, 1 if memory is            */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+int ExpRecip_apply(LinkList_T pllTrees, unsigned int* puiBefore,\
+		   unsigned int* puiAfter){
+  struct NodeList nlNodes = {NULL, NULL, 0u, 0u};
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNode;
+  unsigned int uiI, uiJ;
+  int* piShared;
+  int iResult = 0;
+  if(puiBefore != NULL)
+    *puiBefore = ExpRecip_countDivisions(pllTrees);
+  //merge a/b + c/b into (a+c)/b
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNode = (TreeNode_T)LinkList_getValue(oLinkList);
+    iResult = ExpRecip_merge(&oTreeNode, 0);
+    LinkList_setValue(oLinkList, oTreeNode);
+    if(iResult != 0)
+      break;
+  }
+  //find every denominator used by more than one division
+  if(iResult == 0)
+    iResult = ExpRecip_collectDivisions(pllTrees, &nlNodes);
+  piShared = NULL;
+  if(iResult == 0 && nlNodes.uiLength > 0u){
+    piShared = (int*)calloc(nlNodes.uiLength, sizeof(int));
+    iResult = (piShared == NULL);
+  }
+  if(iResult == 0){
+    for(uiI = 0u; uiI < nlNodes.uiLength; uiI++){
+      if(piShared[uiI] != 0)
+	continue;
+      for(uiJ = uiI + 1u; uiJ < nlNodes.uiLength; uiJ++){
+	if(ExpRecip_sameDenominator(nlNodes.poNodes[uiI],\
+				    nlNodes.poNodes[uiJ])){
+	  piShared[uiI] = 1;
+	  piShared[uiJ] = 1;
+	}
+      }
+    }
+    //only now rewrite, so that comparisons all saw the original trees
+    for(uiI = 0u; uiI < nlNodes.uiLength && iResult == 0; uiI++){
+      if(ExpRecip_type(nlNodes.poNodes[uiI]) != DIVIDE)
+	continue;
+      if(piShared[uiI] != 0 ||\
+	 ExpRecip_isOne(ExpRecip_child(nlNodes.poNodes[uiI], 0u)))
+	iResult = ExpRecip_toReciprocal(nlNodes.poNodes[uiI]);
+    }
+  }
+  free(piShared);
+  ExpRecip_clear(&nlNodes);
+  if(puiAfter != NULL)
+    *puiAfter = ExpRecip_countDivisions(pllTrees);
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test exprecip.c                                                      */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  TreeNode_T oTreeNodeSum;
+  LinkList_T oLinkList;
+  unsigned int uiBefore, uiAfter;
+
+  //a/b + c/b should become (a+c)/b
+  oTreeNodeSum = ExpRecip_newNode(ADD,\
+				  ExpRecip_newNode(DIVIDE,\
+						   ExpTokenTree_newLeaf("a"),\
+						   ExpTokenTree_newLeaf("b")),\
+				  ExpRecip_newNode(DIVIDE,\
+						   ExpTokenTree_newLeaf("c"),\
+						   ExpTokenTree_newLeaf("b")));
+  oLinkList = LinkList_new();
+  LinkList_setValue(oLinkList, oTreeNodeSum);
+  if(ExpRecip_apply(oLinkList, &uiBefore, &uiAfter) != 0)
+    printf("failed test 1\n");
+  if(uiBefore != 2u || uiAfter != 1u)
+    printf("failed test 2\n");
+  ExpTokenTree_print((TreeNode_T)LinkList_getValue(oLinkList));
+  printf("\n");
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkList));
+  LinkList_free(oLinkList);
+  return 0;
+}
+*/
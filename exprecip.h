@@ -0,0 +1,28 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exprecip.h describes a pass over a list of ExpTokenTrees that cuts   */
+/*the number of divisions needed to evaluate them. Sums of fractions   */
+/*over the same denominator are merged into a single fraction, and     */
+/*every denominator that is divided by more than once has its          */
+/*reciprocal computed once and multiplied in instead                   */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPRECIP_INCLUDED
+#define EXPRECIP_INCLUDED
+
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the trees stored in the list pllTrees in place so that a/b + */
+/*c/b becomes (a+c)/b, and x/y becomes x*(1/y) wherever y is the       */
+/*denominator of more than one division, so that 1/y can be shared.    */
+/*Divisions with a numerator of 1 always become reciprocals. Store the */
+/*number of divisions before and after the pass in puiBefore and       */
+/*puiAfter if they are not NULL. Return 0 if successful, 1 if memory is*/
+/*insufficient, in which case the trees are still valid and equivalent */
+/*to the originals but may be only partially rewritten                 */
+/*---------------------------------------------------------------------*/
+int ExpRecip_apply(LinkList_T pllTrees, unsigned int* puiBefore,\
+		   unsigned int* puiAfter);
+
+#endif
@@ -0,0 +1,582 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsched.c implements expsched.h. Both modes work out a new order of */
+/*the instruction numbers and hand it to ExpSSA_reorder. The depth     */
+/*first walk keeps its own stack, since a long chain of operations     */
+/*would overflow the call stack, and the list scheduler keeps the      */
+/*instructions whose operands are all issued in two heaps, one by the  */
+/*cycle their operands are done and one by their priority              */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expsched.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the longest latency an operation may be given                 */
+/*---------------------------------------------------------------------*/
+#define SCHED_MAX_LATENCY 1000000L
+
+/*---------------------------------------------------------------------*/
+/*Define the states of an instruction in the depth first walk          */
+/*---------------------------------------------------------------------*/
+#define WALK_NEW 0
+#define WALK_OPEN 1
+#define WALK_DONE 2
+
+/*---------------------------------------------------------------------*/
+/*An ExpSched is the latency of each operation                         */
+/*---------------------------------------------------------------------*/
+struct ExpSched
+{
+  unsigned long pulLatency[EXPSSA_FNMS + 1];
+};
+
+/*---------------------------------------------------------------------*/
+/*A SchedName is the name by which the latency of an operation is set, */
+/*with its default, that of the fpu target of expstrength.h            */
+/*---------------------------------------------------------------------*/
+struct SchedName
+{
+  const char* pcName;
+  enum ExpSSAOp esoOp;
+  unsigned long ulLatency;
+};
+
+static const struct SchedName pnNames[] = {
+  {"add", EXPSSA_ADD, 4ul}, {"subtract", EXPSSA_SUBTRACT, 4ul},
+  {"multiply", EXPSSA_MULTIPLY, 4ul}, {"divide", EXPSSA_DIVIDE, 14ul},
+  {"power", EXPSSA_POWER, 40ul}, {"reciprocal", EXPSSA_RECIPROCAL, 14ul},
+  {"sqrt", EXPSSA_SQRT, 16ul}, {"negative", EXPSSA_NEGATIVE, 1ul},
+  {"fma", EXPSSA_FMA, 4ul}, {"fms", EXPSSA_FMS, 4ul},
+  {"fnma", EXPSSA_FNMA, 4ul}, {"fnms", EXPSSA_FNMS, 4ul}
+};
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpSched with the default latencies                     */
+/*---------------------------------------------------------------------*/
+ExpSched_T ExpSched_new(void){
+  ExpSched_T oExpSched;
+  unsigned int uiIndex;
+  oExpSched = (ExpSched_T)malloc(sizeof(struct ExpSched));
+  if(oExpSched == NULL)
+    return NULL;
+  for(uiIndex = 0u; uiIndex < sizeof(pnNames) / sizeof(pnNames[0]);
+      uiIndex++)
+    oExpSched -> pulLatency[pnNames[uiIndex].esoOp] =\
+      pnNames[uiIndex].ulLatency;
+  return oExpSched;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpSched                                                       */
+/*---------------------------------------------------------------------*/
+void ExpSched_free(ExpSched_T oExpSched){
+  assert(oExpSched != NULL);
+  free(oExpSched);
+}
+
+/*---------------------------------------------------------------------*/
+/*Set the latency named in pcLatency                                   */
+/*---------------------------------------------------------------------*/
+int ExpSched_setLatency(ExpSched_T oExpSched, const char* pcLatency){
+  const char* pcEquals;
+  char* pcEnd;
+  size_t stLength;
+  unsigned int uiIndex;
+  long lLatency;
+  assert(oExpSched != NULL);
+  if(pcLatency == NULL)
+    return -1;
+  pcEquals = strchr(pcLatency, '=');
+  if(pcEquals == NULL || pcEquals[1] < '0' || pcEquals[1] > '9')
+    return -1;
+  stLength = (size_t)(pcEquals - pcLatency);
+  lLatency = strtol(pcEquals + 1, &pcEnd, 10);
+  if(*pcEnd != '\0' || lLatency < 1L || lLatency > SCHED_MAX_LATENCY)
+    return -1;
+  for(uiIndex = 0u; uiIndex < sizeof(pnNames) / sizeof(pnNames[0]);
+      uiIndex++)
+    if(strlen(pnNames[uiIndex].pcName) == stLength &&\
+       strncmp(pcLatency, pnNames[uiIndex].pcName, stLength) == 0){
+      oExpSched -> pulLatency[pnNames[uiIndex].esoOp] =\
+	(unsigned long)lLatency;
+      return 0;
+    }
+  return -1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the latency under oExpSched of instruction uiInstruction of   */
+/*oExpSSA                                                              */
+/*---------------------------------------------------------------------*/
+static unsigned long ExpSched_latency(ExpSched_T oExpSched, ExpSSA_T oExpSSA,\
+				      unsigned int uiInstruction){
+  return oExpSched -> pulLatency\
+    [ExpSSA_instruction(oExpSSA, uiInstruction) -> esoOp];
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in *puiArgs the instructions instruction uiInstruction of      */
+/*oExpSSA uses, once each, and return how many there are               */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSched_args(ExpSSA_T oExpSSA,\
+				  unsigned int uiInstruction,\
+				  unsigned int* puiArgs){
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned int uiArg, uiSeen, uiFirst, uiArgs = 0u;
+  piInstruction = ExpSSA_instruction(oExpSSA, uiInstruction);
+  uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++){
+    if(piInstruction -> puiArgs[uiArg] < uiFirst)
+      continue;
+    //x*x waits for x once
+    for(uiSeen = 0u; uiSeen < uiArgs; uiSeen++)
+      if(puiArgs[uiSeen] == piInstruction -> puiArgs[uiArg] - uiFirst)
+	break;
+    if(uiSeen == uiArgs)
+      puiArgs[uiArgs++] = piInstruction -> puiArgs[uiArg] - uiFirst;
+  }
+  return uiArgs;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the cycles of oExpSSA in order                                */
+/*---------------------------------------------------------------------*/
+unsigned long ExpSched_cycles(ExpSched_T oExpSched, ExpSSA_T oExpSSA){
+  unsigned long* pulDone;
+  unsigned long ulCycle = 0ul, ulStart, ulEnd = 0ul;
+  unsigned int puiArgs[EXPSSA_MAX_ARGS];
+  unsigned int uiInstruction, uiArgs, uiArg, uiIssued = 0u;
+  assert(oExpSched != NULL);
+  assert(oExpSSA != NULL);
+  pulDone = (unsigned long*)malloc((ExpSSA_instructions(oExpSSA) + 1u) *\
+				   sizeof(unsigned long));
+  if(pulDone == NULL)
+    return 0ul;
+  for(uiInstruction = 0u; uiInstruction < ExpSSA_instructions(oExpSSA);\
+      uiInstruction++){
+    ulStart = ulCycle;
+    uiArgs = ExpSched_args(oExpSSA, uiInstruction, puiArgs);
+    for(uiArg = 0u; uiArg < uiArgs; uiArg++)
+      if(pulDone[puiArgs[uiArg]] > ulStart)
+	ulStart = pulDone[puiArgs[uiArg]];
+    //in order, a stalled instruction holds back every one after it
+    if(ulStart > ulCycle){
+      ulCycle = ulStart;
+      uiIssued = 0u;
+    }
+    pulDone[uiInstruction] = ulCycle +\
+      ExpSched_latency(oExpSched, oExpSSA, uiInstruction);
+    if(pulDone[uiInstruction] > ulEnd)
+      ulEnd = pulDone[uiInstruction];
+    if(++uiIssued == EXPSCHED_ISSUE){
+      ulCycle++;
+      uiIssued = 0u;
+    }
+  }
+  free(pulDone);
+  return ulEnd;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return nonzero if instruction uiFirst comes out of a heap over       */
+/*pulKeys before instruction uiSecond: by the larger key if iMax, else */
+/*by the smaller, then by the lower number                             */
+/*---------------------------------------------------------------------*/
+static int ExpSched_before(const unsigned long* pulKeys, int iMax,\
+			   unsigned int uiFirst, unsigned int uiSecond){
+  if(pulKeys[uiFirst] != pulKeys[uiSecond])
+    return (iMax != 0) == (pulKeys[uiFirst] > pulKeys[uiSecond]);
+  return uiFirst < uiSecond;
+}
+
+/*---------------------------------------------------------------------*/
+/*Push instruction uiInstruction onto the heap puiHeap of *puiSize     */
+/*instructions ordered over pulKeys as by ExpSched_before              */
+/*---------------------------------------------------------------------*/
+static void ExpSched_push(unsigned int* puiHeap, unsigned int* puiSize,\
+			  const unsigned long* pulKeys, int iMax,\
+			  unsigned int uiInstruction){
+  unsigned int uiIndex = (*puiSize)++;
+  for(; uiIndex > 0u &&\
+	ExpSched_before(pulKeys, iMax, uiInstruction,\
+			puiHeap[(uiIndex - 1u) / 2u]);\
+      uiIndex = (uiIndex - 1u) / 2u)
+    puiHeap[uiIndex] = puiHeap[(uiIndex - 1u) / 2u];
+  puiHeap[uiIndex] = uiInstruction;
+}
+
+/*---------------------------------------------------------------------*/
+/*Pop the first instruction off the heap puiHeap of *puiSize           */
+/*instructions ordered over pulKeys as by ExpSched_before, and return  */
+/*it                                                                   */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSched_pop(unsigned int* puiHeap, unsigned int* puiSize,\
+				 const unsigned long* pulKeys, int iMax){
+  unsigned int uiTop = puiHeap[0], uiLast, uiIndex = 0u, uiChild;
+  uiLast = puiHeap[--(*puiSize)];
+  for(uiChild = 1u; uiChild < *puiSize; uiChild = 2u * uiIndex + 1u){
+    if(uiChild + 1u < *puiSize &&\
+       ExpSched_before(pulKeys, iMax, puiHeap[uiChild + 1u],\
+		       puiHeap[uiChild]))
+      uiChild++;
+    if(!ExpSched_before(pulKeys, iMax, puiHeap[uiChild], uiLast))
+      break;
+    puiHeap[uiIndex] = puiHeap[uiChild];
+    uiIndex = uiChild;
+  }
+  puiHeap[uiIndex] = uiLast;
+  return uiTop;
+}
+
+/*---------------------------------------------------------------------*/
+/*Sort the uiCount numbers of puiItems, at most EXPSSA_MAX_ARGS,       */
+/*largest key first, those with equal keys keeping their order. The key*/
+/*of an item is the entry of puiKeys it indexes, or the item itself if */
+/*puiKeys is NULL                                                      */
+/*---------------------------------------------------------------------*/
+static void ExpSched_sortLabels(unsigned int* puiItems,\
+				const unsigned int* puiKeys,\
+				unsigned int uiCount){
+  unsigned int uiIndex, uiPlace, uiItem;
+  for(uiIndex = 1u; uiIndex < uiCount; uiIndex++){
+    uiItem = puiItems[uiIndex];
+    for(uiPlace = uiIndex; uiPlace > 0u; uiPlace--){
+      if(puiKeys == NULL ? puiItems[uiPlace - 1u] >= uiItem :\
+	 puiKeys[puiItems[uiPlace - 1u]] >= puiKeys[uiItem])
+	break;
+      puiItems[uiPlace] = puiItems[uiPlace - 1u];
+    }
+    puiItems[uiPlace] = uiItem;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in puiOrder the order of the instructions of oExpSSA that      */
+/*evaluates each output, then each instruction no output uses, depth   */
+/*first, the operand with the larger Sethi-Ullman number first, using  */
+/*puiLabels, with room for a number per instruction, for those numbers */
+/*and puiStack, with room for three, for the walk. Return 0 if         */
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpSched_pressure(ExpSSA_T oExpSSA, unsigned int* puiOrder,\
+			     unsigned int* puiLabels,\
+			     unsigned int* puiStack){
+  const struct ExpSSAInstruction* piInstruction;
+  char* pcStates;
+  unsigned int puiArgs[EXPSSA_MAX_ARGS], puiLabel[EXPSSA_MAX_ARGS];
+  unsigned int uiInstruction, uiRoot, uiArgs, uiArg, uiFirst, uiTop = 0u;
+  unsigned int uiOrdered = 0u, uiInstructions = ExpSSA_instructions(oExpSSA);
+  uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  pcStates = (char*)calloc(uiInstructions + 1u, sizeof(char));
+  if(pcStates == NULL)
+    return 1;
+  //an input or constant needs no register of its own, and the k-th
+  //largest number of an operand evaluated k-th needs k more held
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++){
+    piInstruction = ExpSSA_instruction(oExpSSA, uiInstruction);
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++)
+      puiLabel[uiArg] = (piInstruction -> puiArgs[uiArg] < uiFirst) ? 0u :\
+	puiLabels[piInstruction -> puiArgs[uiArg] - uiFirst];
+    ExpSched_sortLabels(puiLabel, NULL, piInstruction -> uiArgs);
+    puiLabels[uiInstruction] = 1u;
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++)
+      if(puiLabel[uiArg] + uiArg > puiLabels[uiInstruction])
+	puiLabels[uiInstruction] = puiLabel[uiArg] + uiArg;
+  }
+  for(uiRoot = 0u; uiRoot < ExpSSA_outputs(oExpSSA) + uiInstructions;\
+      uiRoot++){
+    if(uiRoot < ExpSSA_outputs(oExpSSA)){
+      if(ExpSSA_output(oExpSSA, uiRoot) < uiFirst)
+	continue;
+      uiInstruction = ExpSSA_output(oExpSSA, uiRoot) - uiFirst;
+    }
+    else
+      uiInstruction = uiRoot - ExpSSA_outputs(oExpSSA);
+    if(pcStates[uiInstruction] != WALK_NEW)
+      continue;
+    puiStack[uiTop++] = uiInstruction;
+    while(uiTop > 0u){
+      uiInstruction = puiStack[uiTop - 1u];
+      if(pcStates[uiInstruction] == WALK_DONE){
+	uiTop--;
+	continue;
+      }
+      if(pcStates[uiInstruction] == WALK_OPEN){
+	pcStates[uiInstruction] = WALK_DONE;
+	puiOrder[uiOrdered++] = uiInstruction;
+	uiTop--;
+	continue;
+      }
+      //the operand walked first is pushed last
+      pcStates[uiInstruction] = WALK_OPEN;
+      uiArgs = ExpSched_args(oExpSSA, uiInstruction, puiArgs);
+      ExpSched_sortLabels(puiArgs, puiLabels, uiArgs);
+      for(uiArg = uiArgs; uiArg-- > 0u;)
+	if(pcStates[puiArgs[uiArg]] == WALK_NEW)
+	  puiStack[uiTop++] = puiArgs[uiArg];
+    }
+  }
+  free(pcStates);
+  assert(uiOrdered == uiInstructions);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the most results of oExpSSA live at once if its instructions  */
+/*run in the order puiOrder, or in their own order if puiOrder is NULL,*/
+/*a result being live from its instruction to its last use, using      */
+/*puiWork, with room for three numbers per instruction                 */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSched_maxLive(ExpSSA_T oExpSSA,\
+				     const unsigned int* puiOrder,\
+				     unsigned int* puiWork){
+  unsigned int* puiPosition = puiWork;
+  unsigned int* puiLast;
+  unsigned int* puiEnded;
+  unsigned int puiArgs[EXPSSA_MAX_ARGS];
+  unsigned int uiInstruction, uiArgs, uiArg, uiEnded = 0u, uiMaxLive = 0u;
+  unsigned int uiInstructions = ExpSSA_instructions(oExpSSA);
+  puiLast = puiWork + uiInstructions;
+  puiEnded = puiLast + uiInstructions;
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++){
+    puiPosition[(puiOrder == NULL) ? uiInstruction : puiOrder[uiInstruction]]\
+      = uiInstruction;
+    puiEnded[uiInstruction] = 0u;
+  }
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++)
+    puiLast[uiInstruction] = puiPosition[uiInstruction];
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++){
+    uiArgs = ExpSched_args(oExpSSA, uiInstruction, puiArgs);
+    for(uiArg = 0u; uiArg < uiArgs; uiArg++)
+      if(puiPosition[uiInstruction] > puiLast[puiArgs[uiArg]])
+	puiLast[puiArgs[uiArg]] = puiPosition[uiInstruction];
+  }
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++)
+    puiEnded[puiLast[uiInstruction]]++;
+  //every position starts one result, and those ended before it are dead
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++){
+    if(uiInstruction + 1u - uiEnded > uiMaxLive)
+      uiMaxLive = uiInstruction + 1u - uiEnded;
+    uiEnded += puiEnded[uiInstruction];
+  }
+  return uiMaxLive;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in puiOrder the order of the instructions of oExpSSA a list    */
+/*scheduler issues them in on the machine of ExpSched_cycles under the */
+/*latencies of oExpSched. Return 0 if successful, 1 if memory is       */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpSched_latencyOrder(ExpSched_T oExpSched, ExpSSA_T oExpSSA,\
+				 unsigned int* puiOrder){
+  unsigned long* pulPriority;
+  unsigned long* pulReady;
+  unsigned int* puiStart;
+  unsigned int* puiUsers;
+  unsigned int* puiWaits;
+  unsigned int* puiWaiting;
+  unsigned int* puiAvailable;
+  unsigned int puiArgs[EXPSSA_MAX_ARGS];
+  unsigned int uiInstruction, uiArgs, uiArg, uiUser, uiOrdered;
+  unsigned int uiWaiting = 0u, uiAvailable = 0u, uiIssued = 0u;
+  unsigned int uiInstructions = ExpSSA_instructions(oExpSSA);
+  unsigned long ulCycle = 0ul, ulDone;
+  pulPriority = (unsigned long*)malloc((uiInstructions + 1u) *\
+				       sizeof(unsigned long));
+  pulReady = (unsigned long*)calloc(uiInstructions + 1u,\
+				    sizeof(unsigned long));
+  puiStart = (unsigned int*)calloc(uiInstructions + 2u, sizeof(unsigned int));
+  puiUsers = (unsigned int*)malloc((2u * uiInstructions + 1u) *\
+				   sizeof(unsigned int));
+  puiWaits = (unsigned int*)malloc((uiInstructions + 1u) *\
+				   sizeof(unsigned int));
+  puiWaiting = (unsigned int*)malloc((uiInstructions + 1u) *\
+				     sizeof(unsigned int));
+  puiAvailable = (unsigned int*)malloc((uiInstructions + 1u) *\
+				       sizeof(unsigned int));
+  if(pulPriority == NULL || pulReady == NULL || puiStart == NULL ||\
+     puiUsers == NULL || puiWaits == NULL || puiWaiting == NULL ||\
+     puiAvailable == NULL){
+    free(pulPriority);
+    free(pulReady);
+    free(puiStart);
+    free(puiUsers);
+    free(puiWaits);
+    free(puiWaiting);
+    free(puiAvailable);
+    return 1;
+  }
+  //the users of instruction i are puiUsers[puiStart[i]] up to, not
+  //including, puiUsers[puiStart[i + 1]]
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++){
+    uiArgs = ExpSched_args(oExpSSA, uiInstruction, puiArgs);
+    puiWaits[uiInstruction] = uiArgs;
+    for(uiArg = 0u; uiArg < uiArgs; uiArg++)
+      puiStart[puiArgs[uiArg] + 2u]++;
+  }
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++)
+    puiStart[uiInstruction + 2u] += puiStart[uiInstruction + 1u];
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++){
+    uiArgs = ExpSched_args(oExpSSA, uiInstruction, puiArgs);
+    for(uiArg = 0u; uiArg < uiArgs; uiArg++)
+      puiUsers[puiStart[puiArgs[uiArg] + 1u]++] = uiInstruction;
+  }
+  //the priority is the longest chain of latencies from an instruction on
+  for(uiInstruction = uiInstructions; uiInstruction-- > 0u;){
+    pulPriority[uiInstruction] = 0ul;
+    for(uiUser = puiStart[uiInstruction];\
+	uiUser < puiStart[uiInstruction + 1u]; uiUser++)
+      if(pulPriority[puiUsers[uiUser]] > pulPriority[uiInstruction])
+	pulPriority[uiInstruction] = pulPriority[puiUsers[uiUser]];
+    pulPriority[uiInstruction] +=\
+      ExpSched_latency(oExpSched, oExpSSA, uiInstruction);
+  }
+  for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++)
+    if(puiWaits[uiInstruction] == 0u)
+      ExpSched_push(puiWaiting, &uiWaiting, pulReady, 0, uiInstruction);
+  for(uiOrdered = 0u; uiOrdered < uiInstructions; uiOrdered++){
+    //with nothing ready this cycle, skip to when something is
+    if(uiAvailable == 0u && pulReady[puiWaiting[0]] > ulCycle){
+      ulCycle = pulReady[puiWaiting[0]];
+      uiIssued = 0u;
+    }
+    while(uiWaiting > 0u && pulReady[puiWaiting[0]] <= ulCycle)
+      ExpSched_push(puiAvailable, &uiAvailable, pulPriority, 1,\
+		    ExpSched_pop(puiWaiting, &uiWaiting, pulReady, 0));
+    uiInstruction = ExpSched_pop(puiAvailable, &uiAvailable, pulPriority, 1);
+    puiOrder[uiOrdered] = uiInstruction;
+    ulDone = ulCycle + ExpSched_latency(oExpSched, oExpSSA, uiInstruction);
+    for(uiUser = puiStart[uiInstruction];\
+	uiUser < puiStart[uiInstruction + 1u]; uiUser++){
+      if(pulReady[puiUsers[uiUser]] < ulDone)
+	pulReady[puiUsers[uiUser]] = ulDone;
+      if(--puiWaits[puiUsers[uiUser]] == 0u)
+	ExpSched_push(puiWaiting, &uiWaiting, pulReady, 0,\
+		      puiUsers[uiUser]);
+    }
+    if(++uiIssued == EXPSCHED_ISSUE){
+      ulCycle++;
+      uiIssued = 0u;
+    }
+  }
+  free(pulPriority);
+  free(pulReady);
+  free(puiStart);
+  free(puiUsers);
+  free(puiWaits);
+  free(puiWaiting);
+  free(puiAvailable);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Reorder the instructions of oExpSSA for esmMode                      */
+/*---------------------------------------------------------------------*/
+int ExpSched_apply(ExpSched_T oExpSched, ExpSSA_T oExpSSA,\
+		   enum ExpSchedMode esmMode){
+  unsigned int* puiOrder;
+  unsigned int* puiLabels;
+  unsigned int* puiStack;
+  unsigned int uiInstructions, uiInstruction;
+  int iStatus;
+  assert(oExpSched != NULL);
+  assert(oExpSSA != NULL);
+  uiInstructions = ExpSSA_instructions(oExpSSA);
+  puiOrder = (unsigned int*)malloc((uiInstructions + 1u) *\
+				   sizeof(unsigned int));
+  if(puiOrder == NULL)
+    return 1;
+  if(esmMode == EXPSCHED_LATENCY)
+    iStatus = ExpSched_latencyOrder(oExpSched, oExpSSA, puiOrder);
+  else{
+    puiLabels = (unsigned int*)malloc((uiInstructions + 1u) *\
+				      sizeof(unsigned int));
+    puiStack = (unsigned int*)malloc((3u * uiInstructions + 1u) *\
+				     sizeof(unsigned int));
+    iStatus = (puiLabels == NULL || puiStack == NULL) ? 1 :\
+      ExpSched_pressure(oExpSSA, puiOrder, puiLabels, puiStack);
+    //a walk of a shared operand may hold it longer than the given order
+    if(iStatus == 0 &&\
+       ExpSched_maxLive(oExpSSA, puiOrder, puiStack) >\
+       ExpSched_maxLive(oExpSSA, NULL, puiStack))
+      for(uiInstruction = 0u; uiInstruction < uiInstructions; uiInstruction++)
+	puiOrder[uiInstruction] = uiInstruction;
+    free(puiLabels);
+    free(puiStack);
+  }
+  if(iStatus == 0)
+    iStatus = ExpSSA_reorder(oExpSSA, puiOrder);
+  free(puiOrder);
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expsched.c                                                      */
+/*---------------------------------------------------------------------*/
+/*
+#include <stdio.h>
+#include "exptokentree.h"
+#include "exptoken.h"
+
+int main(void){
+  ExpProgram_T oExpProgram;
+  ExpSSA_T oExpSSA;
+  ExpSched_T oExpSched;
+  LinkList_T pllTrees;
+
+  //#0 = a/b, #1 = #0/c, #2 = d+e, #3 = #2+f, output #1*#3: the chain
+  //of divisions is the longer, so its second division goes before d+e
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(DIVIDE, ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(DIVIDE, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("c")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("d"),\
+				      ExpTokenTree_newLeaf("e")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("#2"),\
+				      ExpTokenTree_newLeaf("f")));
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees,\
+		    ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("#1"),\
+					 ExpTokenTree_newLeaf("#3")));
+  oExpSSA = ExpSSA_new(oExpProgram, pllTrees);
+  oExpSched = ExpSched_new();
+  if(oExpSSA == NULL || oExpSched == NULL)
+    printf("failed test 1\n");
+  if(ExpSched_setLatency(oExpSched, "divide") != -1 ||\
+     ExpSched_setLatency(oExpSched, "divide=0") != -1 ||\
+     ExpSched_setLatency(oExpSched, "modulo=3") != -1 ||\
+     ExpSched_setLatency(oExpSched, "divide=20") != 0)
+    printf("failed test 2\n");
+  //in order, a/b and d+e issue together, #0/c waits 20 cycles, #2+f
+  //behind it, and the product 20 more: 44 cycles
+  if(ExpSched_cycles(oExpSched, oExpSSA) != 44ul)
+    printf("failed test 3\n");
+  //d+e and #2+f issue while the divisions run: 44 cycles still, as the
+  //divisions are the critical path, with d+e moved ahead of #0/c
+  if(ExpSched_apply(oExpSched, oExpSSA, EXPSCHED_LATENCY) != 0 ||\
+     ExpSched_cycles(oExpSched, oExpSSA) != 44ul ||\
+     ExpSSA_instruction(oExpSSA, 1u) -> esoOp != EXPSSA_ADD)
+    printf("failed test 4\n");
+  //depth first, both chains have the Sethi-Ullman number 1, so #1 is
+  //evaluated whole before #3
+  if(ExpSched_apply(oExpSched, oExpSSA, EXPSCHED_PRESSURE) != 0 ||\
+     ExpSSA_instruction(oExpSSA, 1u) -> esoOp != EXPSSA_DIVIDE ||\
+     ExpSSA_instruction(oExpSSA, 4u) -> esoOp != EXPSSA_MULTIPLY)
+    printf("failed test 5\n");
+  ExpSched_free(oExpSched);
+  ExpSSA_free(oExpSSA);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
@@ -0,0 +1,73 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsched.h describes instruction scheduling over the static single   */
+/*assignment form of a program. The instructions are reordered, within */
+/*the order their operands impose, either to keep few results live at  */
+/*once or to start long chains early and interleave independent ones,  */
+/*under a table of operation latencies                                 */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPSCHED_INCLUDED
+#define EXPSCHED_INCLUDED
+
+#include "expssa.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the instructions the modelled machine issues per cycle        */
+/*---------------------------------------------------------------------*/
+#define EXPSCHED_ISSUE 2u
+
+/*---------------------------------------------------------------------*/
+/*Define the orders a program is scheduled for: few results live at    */
+/*once, or a short time to finish on the modelled machine              */
+/*---------------------------------------------------------------------*/
+enum ExpSchedMode {EXPSCHED_PRESSURE, EXPSCHED_LATENCY};
+
+/*---------------------------------------------------------------------*/
+/*An ExpSched is a table of the latency of each operation, in cycles   */
+/*---------------------------------------------------------------------*/
+typedef struct ExpSched* ExpSched_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpSched holding the latencies of a pipelined floating  */
+/*point unit, those of the fpu target of expstrength.h, or NULL if     */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+ExpSched_T ExpSched_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpSched                                */
+/*---------------------------------------------------------------------*/
+void ExpSched_free(ExpSched_T oExpSched);
+
+/*---------------------------------------------------------------------*/
+/*Set one latency of oExpSched from pcLatency, of the form             */
+/*operator=cycles, where operator is one of add, subtract, multiply,   */
+/*divide, power, reciprocal, sqrt, negative or the fused multiply-adds */
+/*fma, fms, fnma and fnms, ex. divide=20, and cycles is at least 1.    */
+/*Return 0 if successful, -1 if pcLatency is malformed                 */
+/*---------------------------------------------------------------------*/
+int ExpSched_setLatency(ExpSched_T oExpSched, const char* pcLatency);
+
+/*---------------------------------------------------------------------*/
+/*Return the cycles the instructions of oExpSSA take, in their order,  */
+/*on a machine issuing up to EXPSCHED_ISSUE of them per cycle in order,*/
+/*each once its operands are done, under the latencies of oExpSched    */
+/*---------------------------------------------------------------------*/
+unsigned long ExpSched_cycles(ExpSched_T oExpSched, ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Reorder the instructions of oExpSSA for esmMode. EXPSCHED_PRESSURE   */
+/*evaluates each output depth first, the operand that needs more       */
+/*registers by its Sethi-Ullman number first, so a result is computed  */
+/*just before it is used, unless the order given holds fewer results   */
+/*live at once. EXPSCHED_LATENCY list schedules the                    */
+/*instructions on the machine of ExpSched_cycles, issuing among those  */
+/*whose operands are done the one with the longest chain of latencies  */
+/*after it. Return 0 if successful, 1 if memory is insufficient, in    */
+/*which case oExpSSA is unchanged                                      */
+/*---------------------------------------------------------------------*/
+int ExpSched_apply(ExpSched_T oExpSched, ExpSSA_T oExpSSA,\
+		   enum ExpSchedMode esmMode);
+
+#endif
@@ -0,0 +1,596 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsession.c implements expsession.h. Statements are kept in an array*/
+/*indexed by temporary number and chained into a hash table by their   */
+/*expression, an operator over operands and temporaries with the       */
+/*operands of + and * in a fixed order. Each statement counts its uses */
+/*by later statements and by the expressions, and is collected when the*/
+/*count reaches zero                                                   */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expsession.h"
+#include "expprogram.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of the statements, of the hash table,    */
+/*which is a power of two, and of the expressions                      */
+/*---------------------------------------------------------------------*/
+#define INITIAL_STATEMENTS 64u
+#define INITIAL_BUCKETS 64u
+#define INITIAL_EXPRESSIONS 16u
+
+/*---------------------------------------------------------------------*/
+/*Define the statement number that ends a hash chain                   */
+/*---------------------------------------------------------------------*/
+#define NO_STATEMENT (~0u)
+
+/*---------------------------------------------------------------------*/
+/*An ExpSession holds its statements, the hash chains through them, and*/
+/*the root of each expression                                          */
+/*---------------------------------------------------------------------*/
+struct ExpSession
+{
+  /*the expression assigned by each statement, or NULL if collected*/
+  TreeNode_T* poValues;
+  /*hash of each expression*/
+  unsigned long* pulHashes;
+  /*number of uses of each temporary*/
+  unsigned int* puiUses;
+  /*next statement in the same hash chain*/
+  unsigned int* puiNext;
+  /*number of temporaries numbered so far*/
+  unsigned int uiLength;
+  /*number of statements that fit*/
+  unsigned int uiMax;
+  /*first statement of each hash chain*/
+  unsigned int* puiBuckets;
+  /*number of hash chains, a power of two*/
+  unsigned int uiBuckets;
+  /*number of statements not collected*/
+  unsigned int uiLive;
+  /*the operand or temporary computing each expression, or NULL if it*/
+  /*was removed*/
+  TreeNode_T* poOutputs;
+  /*number of expressions numbered so far*/
+  unsigned int uiOutputs;
+  /*number of expressions that fit*/
+  unsigned int uiMaxOutputs;
+  /*statements appended and collected since the session was created*/
+  unsigned int uiAdded;
+  unsigned int uiRemoved;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpSession_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the operands of the binary operator at oTreeNode may be  */
+/*swapped, 0 if not                                                    */
+/*---------------------------------------------------------------------*/
+static int ExpSession_isCommutative(TreeNode_T oTreeNode){
+  return ExpSession_type(oTreeNode) == ADD |\
+    ExpSession_type(oTreeNode) == MULTIPLY;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a negative number, zero or a positive number as the leaf      */
+/*oTreeNode1 orders before, with or after the leaf oTreeNode2, by type */
+/*and then by name                                                     */
+/*---------------------------------------------------------------------*/
+static int ExpSession_order(TreeNode_T oTreeNode1, TreeNode_T oTreeNode2){
+  if(ExpSession_type(oTreeNode1) != ExpSession_type(oTreeNode2))
+    return (int)ExpSession_type(oTreeNode1) -\
+      (int)ExpSession_type(oTreeNode2);
+  return strcmp(ExpToken_getName(ExpTokenTree_getValue(oTreeNode1)),\
+		ExpToken_getName(ExpTokenTree_getValue(oTreeNode2)));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a hash of the name and type of the token at oTreeNode,        */
+/*continuing from ulHash                                               */
+/*---------------------------------------------------------------------*/
+static unsigned long ExpSession_hashToken(TreeNode_T oTreeNode,\
+					  unsigned long ulHash){
+  const char* pcName;
+  ulHash = (ulHash ^ (unsigned long)ExpSession_type(oTreeNode)) *\
+    16777619ul;
+  for(pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNode));
+      *pcName != '\0'; pcName++)
+    ulHash = (ulHash ^ (unsigned char)*pcName) * 16777619ul;
+  return ulHash;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a hash of the statement expression oTreeNode, an operator     */
+/*whose operands are leaves                                            */
+/*---------------------------------------------------------------------*/
+static unsigned long ExpSession_hash(TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned long ulHash;
+  ulHash = ExpSession_hashToken(oTreeNode, 2166136261ul);
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    ulHash = ExpSession_hashToken((TreeNode_T)LinkList_getValue(oLinkList),\
+				  ulHash * 1099511628211ul);
+  return ulHash;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new operand naming temporary uiIndex, or NULL if memory is  */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpSession_newTemp(unsigned int uiIndex){
+  char pcName[16];
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode;
+  unsigned int uiChar;
+  sprintf(pcName, "%c%u", EXPPROGRAM_TEMP_CHAR, uiIndex);
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return NULL;
+  for(uiChar = 0u; pcName[uiChar] != '\0'; uiChar++)
+    ExpToken_appendChar(oExpToken, pcName[uiChar]);
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Double the number of statements that fit in oExpSession. Return 0 if */
+/*successful, 1 if memory is insufficient, in which case the statements*/
+/*still fit as before                                                  */
+/*---------------------------------------------------------------------*/
+static int ExpSession_grow(ExpSession_T oExpSession){
+  TreeNode_T* poValues;
+  unsigned long* pulHashes;
+  unsigned int* puiUses;
+  unsigned int* puiNext;
+  unsigned int uiMax = 2u * oExpSession -> uiMax;
+  //an array already grown is kept, which only wastes its new space
+  poValues = (TreeNode_T*)realloc(oExpSession -> poValues,\
+				  uiMax * sizeof(TreeNode_T));
+  if(poValues == NULL)
+    return 1;
+  oExpSession -> poValues = poValues;
+  pulHashes = (unsigned long*)realloc(oExpSession -> pulHashes,\
+				      uiMax * sizeof(unsigned long));
+  if(pulHashes == NULL)
+    return 1;
+  oExpSession -> pulHashes = pulHashes;
+  puiUses = (unsigned int*)realloc(oExpSession -> puiUses,\
+				   uiMax * sizeof(unsigned int));
+  if(puiUses == NULL)
+    return 1;
+  oExpSession -> puiUses = puiUses;
+  puiNext = (unsigned int*)realloc(oExpSession -> puiNext,\
+				   uiMax * sizeof(unsigned int));
+  if(puiNext == NULL)
+    return 1;
+  oExpSession -> puiNext = puiNext;
+  oExpSession -> uiMax = uiMax;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Double the number of hash chains of oExpSession and rechain its      */
+/*statements. If memory is insufficient the chains are kept as they    */
+/*are, which only makes them longer                                    */
+/*---------------------------------------------------------------------*/
+static void ExpSession_rehash(ExpSession_T oExpSession){
+  unsigned int* puiBuckets;
+  unsigned int uiBuckets = 2u * oExpSession -> uiBuckets;
+  unsigned int uiIndex, uiSlot;
+  puiBuckets = (unsigned int*)malloc(uiBuckets * sizeof(unsigned int));
+  if(puiBuckets == NULL)
+    return;
+  for(uiSlot = 0u; uiSlot < uiBuckets; uiSlot++)
+    puiBuckets[uiSlot] = NO_STATEMENT;
+  for(uiIndex = 0u; uiIndex < oExpSession -> uiLength; uiIndex++){
+    if(oExpSession -> poValues[uiIndex] == NULL)
+      continue;
+    uiSlot = (unsigned int)oExpSession -> pulHashes[uiIndex] &\
+      (uiBuckets - 1u);
+    oExpSession -> puiNext[uiIndex] = puiBuckets[uiSlot];
+    puiBuckets[uiSlot] = uiIndex;
+  }
+  free(oExpSession -> puiBuckets);
+  oExpSession -> puiBuckets = puiBuckets;
+  oExpSession -> uiBuckets = uiBuckets;
+}
+
+static void ExpSession_release(ExpSession_T oExpSession,\
+			       TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Collect statement uiIndex of oExpSession, which is no longer used,   */
+/*and release the temporaries it uses                                  */
+/*---------------------------------------------------------------------*/
+static void ExpSession_collect(ExpSession_T oExpSession,\
+			       unsigned int uiIndex){
+  LinkList_T oLinkList;
+  unsigned int* puiLink;
+  //unlink the statement from its hash chain
+  for(puiLink = &oExpSession -> puiBuckets\
+	[(unsigned int)oExpSession -> pulHashes[uiIndex] &\
+	 (oExpSession -> uiBuckets - 1u)];
+      *puiLink != uiIndex;
+      puiLink = &oExpSession -> puiNext[*puiLink])
+    assert(*puiLink != NO_STATEMENT);
+  *puiLink = oExpSession -> puiNext[uiIndex];
+  for(oLinkList = ExpTokenTree_getChildren(oExpSession -> poValues[uiIndex]);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    ExpSession_release(oExpSession, (TreeNode_T)LinkList_getValue(oLinkList));
+  ExpTokenTree_free(oExpSession -> poValues[uiIndex]);
+  oExpSession -> poValues[uiIndex] = NULL;
+  oExpSession -> uiLive--;
+  oExpSession -> uiRemoved++;
+}
+
+/*---------------------------------------------------------------------*/
+/*Drop one use of the temporary named by the leaf oTreeNode, if it     */
+/*names one, collecting the statement if that was its last use. The    */
+/*leaf itself is left to the caller                                    */
+/*---------------------------------------------------------------------*/
+static void ExpSession_release(ExpSession_T oExpSession,\
+			       TreeNode_T oTreeNode){
+  unsigned int uiIndex;
+  if(ExpProgram_isTemp(ExpToken_getName(ExpTokenTree_getValue(oTreeNode)),\
+		       &uiIndex) == 0 ||\
+     uiIndex >= oExpSession -> uiLength ||\
+     oExpSession -> poValues[uiIndex] == NULL)
+    return;
+  assert(oExpSession -> puiUses[uiIndex] > 0u);
+  if(--oExpSession -> puiUses[uiIndex] == 0u)
+    ExpSession_collect(oExpSession, uiIndex);
+}
+
+/*---------------------------------------------------------------------*/
+/*Release every operand of the statement expression oTreeNode and free */
+/*it                                                                   */
+/*---------------------------------------------------------------------*/
+static void ExpSession_discard(ExpSession_T oExpSession,\
+			       TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    ExpSession_release(oExpSession, (TreeNode_T)LinkList_getValue(oLinkList));
+  ExpTokenTree_free(oTreeNode);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new leaf computing oTreeNode in oExpSession, which holds one*/
+/*use of it: a copy of oTreeNode if it is a leaf, otherwise a temporary*/
+/*whose statement is found by hashing or appended. Return NULL if      */
+/*memory is insufficient, in which case the session holds the same     */
+/*program                                                              */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpSession_intern(ExpSession_T oExpSession,\
+				    TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeValue, oTreeNodeChild, oTreeNodeTemp;
+  ExpToken_T oExpToken;
+  unsigned long ulHash;
+  unsigned int uiIndex;
+  if(TreeNode_isLeaf(oTreeNode))
+    return ExpTokenTree_copy(oTreeNode);
+  //build the statement expression over the leaves of the operands
+  oTreeNodeValue = ExpTokenTree_new();
+  if(oTreeNodeValue == NULL)
+    return NULL;
+  oExpToken = ExpToken_copy(ExpTokenTree_getValue(oTreeNode));
+  if(oExpToken == NULL){
+    ExpTokenTree_free(oTreeNodeValue);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNodeValue, oExpToken);
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeChild = ExpSession_intern\
+      (oExpSession, (TreeNode_T)LinkList_getValue(oLinkList));
+    if(oTreeNodeChild == NULL){
+      ExpSession_discard(oExpSession, oTreeNodeValue);
+      return NULL;
+    }
+    if(ExpTokenTree_addChild(oTreeNodeValue, oTreeNodeChild) != 0){
+      ExpSession_release(oExpSession, oTreeNodeChild);
+      ExpTokenTree_free(oTreeNodeChild);
+      ExpSession_discard(oExpSession, oTreeNodeValue);
+      return NULL;
+    }
+  }
+  //put the operands of + and * in order, so a+b and b+a are one statement
+  oLinkList = ExpTokenTree_getChildren(oTreeNodeValue);
+  if(ExpSession_isCommutative(oTreeNodeValue) &&\
+     LinkList_getNext(oLinkList) != NULL &&\
+     ExpSession_order((TreeNode_T)LinkList_getValue(oLinkList),\
+		      (TreeNode_T)LinkList_getValue\
+		      (LinkList_getNext(oLinkList))) > 0){
+    oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+    LinkList_setValue(oLinkList,\
+		      LinkList_getValue(LinkList_getNext(oLinkList)));
+    LinkList_setValue(LinkList_getNext(oLinkList), oTreeNodeChild);
+  }
+  ulHash = ExpSession_hash(oTreeNodeValue);
+  for(uiIndex = oExpSession -> puiBuckets[(unsigned int)ulHash &\
+					  (oExpSession -> uiBuckets - 1u)];
+      uiIndex != NO_STATEMENT;
+      uiIndex = oExpSession -> puiNext[uiIndex])
+    if(oExpSession -> pulHashes[uiIndex] == ulHash &&\
+       ExpTokenTree_compare(oExpSession -> poValues[uiIndex],\
+			    oTreeNodeValue) == 0)
+      break;
+  if(uiIndex != NO_STATEMENT){
+    //reuse the statement, whose operands are already counted by it
+    oTreeNodeTemp = ExpSession_newTemp(uiIndex);
+    if(oTreeNodeTemp != NULL)
+      oExpSession -> puiUses[uiIndex]++;
+    ExpSession_discard(oExpSession, oTreeNodeValue);
+    return oTreeNodeTemp;
+  }
+  if(oExpSession -> uiLength == oExpSession -> uiMax &&\
+     ExpSession_grow(oExpSession) != 0){
+    ExpSession_discard(oExpSession, oTreeNodeValue);
+    return NULL;
+  }
+  oTreeNodeTemp = ExpSession_newTemp(oExpSession -> uiLength);
+  if(oTreeNodeTemp == NULL){
+    ExpSession_discard(oExpSession, oTreeNodeValue);
+    return NULL;
+  }
+  if(oExpSession -> uiLive >= oExpSession -> uiBuckets)
+    ExpSession_rehash(oExpSession);
+  uiIndex = oExpSession -> uiLength++;
+  oExpSession -> poValues[uiIndex] = oTreeNodeValue;
+  oExpSession -> pulHashes[uiIndex] = ulHash;
+  oExpSession -> puiUses[uiIndex] = 1u;
+  oExpSession -> puiNext[uiIndex] = oExpSession -> puiBuckets\
+    [(unsigned int)ulHash & (oExpSession -> uiBuckets - 1u)];
+  oExpSession -> puiBuckets[(unsigned int)ulHash &\
+			    (oExpSession -> uiBuckets - 1u)] = uiIndex;
+  oExpSession -> uiLive++;
+  oExpSession -> uiAdded++;
+  return oTreeNodeTemp;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpSession                                       */
+/*---------------------------------------------------------------------*/
+ExpSession_T ExpSession_new(void){
+  ExpSession_T oExpSession;
+  unsigned int uiSlot;
+  oExpSession = (ExpSession_T)calloc(1u, sizeof(struct ExpSession));
+  if(oExpSession == NULL)
+    return NULL;
+  oExpSession -> poValues =\
+    (TreeNode_T*)malloc(INITIAL_STATEMENTS * sizeof(TreeNode_T));
+  oExpSession -> pulHashes =\
+    (unsigned long*)malloc(INITIAL_STATEMENTS * sizeof(unsigned long));
+  oExpSession -> puiUses =\
+    (unsigned int*)malloc(INITIAL_STATEMENTS * sizeof(unsigned int));
+  oExpSession -> puiNext =\
+    (unsigned int*)malloc(INITIAL_STATEMENTS * sizeof(unsigned int));
+  oExpSession -> puiBuckets =\
+    (unsigned int*)malloc(INITIAL_BUCKETS * sizeof(unsigned int));
+  oExpSession -> poOutputs =\
+    (TreeNode_T*)malloc(INITIAL_EXPRESSIONS * sizeof(TreeNode_T));
+  if(oExpSession -> poValues == NULL || oExpSession -> pulHashes == NULL ||\
+     oExpSession -> puiUses == NULL || oExpSession -> puiNext == NULL ||\
+     oExpSession -> puiBuckets == NULL || oExpSession -> poOutputs == NULL){
+    ExpSession_free(oExpSession);
+    return NULL;
+  }
+  oExpSession -> uiMax = INITIAL_STATEMENTS;
+  oExpSession -> uiBuckets = INITIAL_BUCKETS;
+  for(uiSlot = 0u; uiSlot < INITIAL_BUCKETS; uiSlot++)
+    oExpSession -> puiBuckets[uiSlot] = NO_STATEMENT;
+  oExpSession -> uiMaxOutputs = INITIAL_EXPRESSIONS;
+  return oExpSession;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpSession                                                     */
+/*---------------------------------------------------------------------*/
+void ExpSession_free(ExpSession_T oExpSession){
+  unsigned int uiIndex;
+  assert(oExpSession != NULL);
+  for(uiIndex = 0u; uiIndex < oExpSession -> uiLength; uiIndex++)
+    if(oExpSession -> poValues[uiIndex] != NULL)
+      ExpTokenTree_free(oExpSession -> poValues[uiIndex]);
+  for(uiIndex = 0u; uiIndex < oExpSession -> uiOutputs; uiIndex++)
+    if(oExpSession -> poOutputs[uiIndex] != NULL)
+      ExpTokenTree_free(oExpSession -> poOutputs[uiIndex]);
+  free(oExpSession -> poValues);
+  free(oExpSession -> pulHashes);
+  free(oExpSession -> puiUses);
+  free(oExpSession -> puiNext);
+  free(oExpSession -> puiBuckets);
+  free(oExpSession -> poOutputs);
+  free(oExpSession);
+}
+
+/*---------------------------------------------------------------------*/
+/*Add the expression oTreeNode to oExpSession                          */
+/*---------------------------------------------------------------------*/
+int ExpSession_add(ExpSession_T oExpSession, TreeNode_T oTreeNode,\
+		   unsigned int* puiId){
+  TreeNode_T* poOutputs;
+  TreeNode_T oTreeNodeOutput;
+  assert(oExpSession != NULL);
+  assert(oTreeNode != NULL);
+  assert(puiId != NULL);
+  if(oExpSession -> uiOutputs == oExpSession -> uiMaxOutputs){
+    poOutputs = (TreeNode_T*)realloc(oExpSession -> poOutputs,\
+				     2u * oExpSession -> uiMaxOutputs *\
+				     sizeof(TreeNode_T));
+    if(poOutputs == NULL)
+      return 1;
+    oExpSession -> poOutputs = poOutputs;
+    oExpSession -> uiMaxOutputs *= 2u;
+  }
+  oTreeNodeOutput = ExpSession_intern(oExpSession, oTreeNode);
+  if(oTreeNodeOutput == NULL)
+    return 1;
+  oExpSession -> poOutputs[oExpSession -> uiOutputs] = oTreeNodeOutput;
+  *puiId = oExpSession -> uiOutputs++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Remove expression uiId from oExpSession                              */
+/*---------------------------------------------------------------------*/
+int ExpSession_remove(ExpSession_T oExpSession, unsigned int uiId){
+  assert(oExpSession != NULL);
+  if(uiId >= oExpSession -> uiOutputs ||\
+     oExpSession -> poOutputs[uiId] == NULL)
+    return -1;
+  ExpSession_release(oExpSession, oExpSession -> poOutputs[uiId]);
+  ExpTokenTree_free(oExpSession -> poOutputs[uiId]);
+  oExpSession -> poOutputs[uiId] = NULL;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace expression uiId of oExpSession by oTreeNode                  */
+/*---------------------------------------------------------------------*/
+int ExpSession_replace(ExpSession_T oExpSession, unsigned int uiId,\
+		       TreeNode_T oTreeNode){
+  TreeNode_T oTreeNodeOutput;
+  assert(oExpSession != NULL);
+  assert(oTreeNode != NULL);
+  if(uiId >= oExpSession -> uiOutputs ||\
+     oExpSession -> poOutputs[uiId] == NULL)
+    return -1;
+  //the new expression is added first, so the statements it shares with
+  //the old one are never collected
+  oTreeNodeOutput = ExpSession_intern(oExpSession, oTreeNode);
+  if(oTreeNodeOutput == NULL)
+    return 1;
+  ExpSession_release(oExpSession, oExpSession -> poOutputs[uiId]);
+  ExpTokenTree_free(oExpSession -> poOutputs[uiId]);
+  oExpSession -> poOutputs[uiId] = oTreeNodeOutput;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of statements of oExpSession                       */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSession_howMany(ExpSession_T oExpSession){
+  assert(oExpSession != NULL);
+  return oExpSession -> uiLive;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the number of statements appended and collected                */
+/*---------------------------------------------------------------------*/
+void ExpSession_counts(ExpSession_T oExpSession, unsigned int* puiAdded,\
+		       unsigned int* puiRemoved){
+  assert(oExpSession != NULL);
+  if(puiAdded != NULL)
+    *puiAdded = oExpSession -> uiAdded;
+  if(puiRemoved != NULL)
+    *puiRemoved = oExpSession -> uiRemoved;
+}
+
+/*---------------------------------------------------------------------*/
+/*Print every statement and expression of oExpSession                  */
+/*---------------------------------------------------------------------*/
+void ExpSession_print(ExpSession_T oExpSession){
+  unsigned int uiIndex;
+  assert(oExpSession != NULL);
+  for(uiIndex = 0u; uiIndex < oExpSession -> uiLength; uiIndex++){
+    if(oExpSession -> poValues[uiIndex] == NULL)
+      continue;
+    ExpOut_char(EXPPROGRAM_TEMP_CHAR);
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string(" = ");
+    ExpTokenTree_printBracketed(oExpSession -> poValues[uiIndex]);
+    ExpOut_char('\n');
+  }
+  ExpOut_string("---Expression List---\n");
+  for(uiIndex = 0u; uiIndex < oExpSession -> uiOutputs; uiIndex++){
+    if(oExpSession -> poOutputs[uiIndex] == NULL)
+      continue;
+    ExpOut_string("---Expression ");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string("---\n");
+    ExpTokenTree_print(oExpSession -> poOutputs[uiIndex]);
+    ExpOut_char('\n');
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expsession.c                                                    */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  ExpSession_T oExpSession;
+  TreeNode_T oTreeNode1, oTreeNode2, oTreeNode3;
+  unsigned int uiId1, uiId2, uiAdded, uiRemoved;
+
+  oExpSession = ExpSession_new();
+  //(a+b)*c and c*(b+a) share both statements
+  oTreeNode1 = ExpTokenTree_newNode(MULTIPLY,\
+				    ExpTokenTree_newNode(ADD,\
+				      ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")),\
+				    ExpTokenTree_newLeaf("c"));
+  oTreeNode2 = ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("c"),\
+				    ExpTokenTree_newNode(ADD,\
+				      ExpTokenTree_newLeaf("b"),\
+				      ExpTokenTree_newLeaf("a")));
+  if(ExpSession_add(oExpSession, oTreeNode1, &uiId1) != 0 ||\
+     ExpSession_add(oExpSession, oTreeNode2, &uiId2) != 0)
+    printf("failed test 1\n");
+  if(uiId1 != 0u || uiId2 != 1u || ExpSession_howMany(oExpSession) != 2u)
+    printf("failed test 2\n");
+  //replacing the second by (a+b)-c keeps #0 and adds one statement
+  oTreeNode3 = ExpTokenTree_newNode(SUBTRACT,\
+				    ExpTokenTree_newNode(ADD,\
+				      ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("b")),\
+				    ExpTokenTree_newLeaf("c"));
+  if(ExpSession_replace(oExpSession, uiId2, oTreeNode3) != 0)
+    printf("failed test 3\n");
+  ExpSession_counts(oExpSession, &uiAdded, &uiRemoved);
+  if(ExpSession_howMany(oExpSession) != 3u || uiAdded != 3u ||\
+     uiRemoved != 0u)
+    printf("failed test 4\n");
+  //removing the first collects #1 only, removing both collects all
+  if(ExpSession_remove(oExpSession, uiId1) != 0 ||\
+     ExpSession_howMany(oExpSession) != 2u)
+    printf("failed test 5\n");
+  ExpSession_print(oExpSession);
+  ExpOut_flush();
+  if(ExpSession_remove(oExpSession, uiId1) != -1 ||\
+     ExpSession_remove(oExpSession, uiId2) != 0 ||\
+     ExpSession_howMany(oExpSession) != 0u)
+    printf("failed test 6\n");
+  ExpSession_counts(oExpSession, &uiAdded, &uiRemoved);
+  if(uiRemoved != 3u)
+    printf("failed test 7\n");
+  ExpTokenTree_free(oTreeNode1);
+  ExpTokenTree_free(oTreeNode2);
+  ExpTokenTree_free(oTreeNode3);
+  ExpSession_free(oExpSession);
+  return 0;
+}
+*/
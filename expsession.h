@@ -0,0 +1,80 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsession.h describes a session that holds a simplified program     */
+/*while its expressions are added, removed or replaced. Each operation */
+/*is a statement of its own, found by hashing, so an edit only visits  */
+/*the operations of the expressions it adds, and the statements no     */
+/*longer used by any expression are collected                          */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPSESSION_INCLUDED
+#define EXPSESSION_INCLUDED
+
+#include "treenode.h"
+
+/*---------------------------------------------------------------------*/
+/*An ExpSession is a program of statements together with the list of   */
+/*expressions it computes. Temporaries keep their number for the life  */
+/*of the session, and a removed temporary's number is never used again,*/
+/*so every statement only uses temporaries before it                   */
+/*---------------------------------------------------------------------*/
+typedef struct ExpSession* ExpSession_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new, empty ExpSession, or NULL if memory is insufficient    */
+/*---------------------------------------------------------------------*/
+ExpSession_T ExpSession_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpSession                              */
+/*---------------------------------------------------------------------*/
+void ExpSession_free(ExpSession_T oExpSession);
+
+/*---------------------------------------------------------------------*/
+/*Add the expression oTreeNode to oExpSession, reusing the statement of*/
+/*every operation already in the program and appending one for every   */
+/*other, and store the number of the new expression in *puiId. The     */
+/*session does not take oTreeNode. Return 0 if successful, 1 if memory */
+/*is insufficient, in which case the session is unchanged              */
+/*---------------------------------------------------------------------*/
+int ExpSession_add(ExpSession_T oExpSession, TreeNode_T oTreeNode,\
+		   unsigned int* puiId);
+
+/*---------------------------------------------------------------------*/
+/*Remove expression uiId from oExpSession, and every statement that is */
+/*then no longer used. Return 0 if successful, -1 if there is no       */
+/*expression uiId                                                      */
+/*---------------------------------------------------------------------*/
+int ExpSession_remove(ExpSession_T oExpSession, unsigned int uiId);
+
+/*---------------------------------------------------------------------*/
+/*Replace expression uiId of oExpSession by oTreeNode, keeping its     */
+/*number. The statements shared by the old and the new expression are  */
+/*kept. The session does not take oTreeNode. Return 0 if successful, 1 */
+/*if memory is insufficient, in which case the session is unchanged, -1*/
+/*if there is no expression uiId                                       */
+/*---------------------------------------------------------------------*/
+int ExpSession_replace(ExpSession_T oExpSession, unsigned int uiId,\
+		       TreeNode_T oTreeNode);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of statements of oExpSession                       */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSession_howMany(ExpSession_T oExpSession);
+
+/*---------------------------------------------------------------------*/
+/*Store the total number of statements appended to oExpSession in      */
+/**puiAdded, and the total number collected in *puiRemoved, since it   */
+/*was created                                                          */
+/*---------------------------------------------------------------------*/
+void ExpSession_counts(ExpSession_T oExpSession, unsigned int* puiAdded,\
+		       unsigned int* puiRemoved);
+
+/*---------------------------------------------------------------------*/
+/*Print every statement of oExpSession to stdout in order, one per     */
+/*line, as the temporary, " = ", and the expression, then every        */
+/*expression of the session under its number                           */
+/*---------------------------------------------------------------------*/
+void ExpSession_print(ExpSession_T oExpSession);
+
+#endif
@@ -0,0 +1,421 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsign.c implements expsign.h. Each subtree is rebuilt as a         */
+/*magnitude and a sign, and the sign is only turned back into a        */
+/*NEGATIVE node where no enclosing operation can absorb it             */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expsign.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of a TermList                            */
+/*---------------------------------------------------------------------*/
+#define INITIAL_TERMS 16u
+
+/*---------------------------------------------------------------------*/
+/*A TermList holds the terms of a flattened sum, each with the sign it */
+/*is added with                                                        */
+/*---------------------------------------------------------------------*/
+struct TermList
+{
+  /*the terms*/
+  TreeNode_T* poTerms;
+  /*+1 if the term is added, -1 if it is subtracted*/
+  int* piSigns;
+  /*number of terms stored*/
+  unsigned int uiLength;
+  /*number of terms that fit*/
+  unsigned int uiMax;
+};
+
+static TreeNode_T ExpSign_canon(TreeNode_T oTreeNode, int* piSign);
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpSign_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return child number uiIndex of oTreeNode, counting from 0            */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpSign_child(TreeNode_T oTreeNode,\
+				unsigned int uiIndex){
+  LinkList_T oLinkList;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  for(; uiIndex > 0u; uiIndex--)
+    oLinkList = LinkList_getNext(oLinkList);
+  assert(oLinkList != NULL);
+  return (TreeNode_T)LinkList_getValue(oLinkList);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new node of type ettType whose children are oTreeNode1 and, */
+/*for binary operators, oTreeNode2. The new node takes ownership of the*/
+/*children. If memory is insufficient, or a child that is needed is    */
+/*NULL because an earlier allocation failed, free the children and     */
+/*return NULL                                                          */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpSign_newNode(enum ExpTokenType ettType,\
+				  TreeNode_T oTreeNode1,\
+				  TreeNode_T oTreeNode2){
+  ExpToken_T oExpToken = NULL;
+  TreeNode_T oTreeNode = NULL;
+  int iUnary;
+  iUnary = (ettType == NEGATIVE | ettType == POSITIVE |\
+	    ettType == RECIPROCAL);
+  if(oTreeNode1 != NULL && (iUnary || oTreeNode2 != NULL)){
+    oExpToken = ExpToken_new();
+    oTreeNode = ExpTokenTree_new();
+  }
+  if(oExpToken != NULL && oTreeNode != NULL){
+    ExpToken_setType(oExpToken, ettType);
+    ExpTokenTree_setValue(oTreeNode, oExpToken);
+    oExpToken = NULL;
+    if(ExpTokenTree_addChild(oTreeNode, oTreeNode1) == 0){
+      oTreeNode1 = NULL;
+      if(iUnary || ExpTokenTree_addChild(oTreeNode, oTreeNode2) == 0)
+	return oTreeNode;
+    }
+  }
+  if(oExpToken != NULL)
+    ExpToken_free(oExpToken);
+  if(oTreeNode != NULL)
+    ExpTokenTree_free(oTreeNode);
+  if(oTreeNode1 != NULL)
+    ExpTokenTree_free(oTreeNode1);
+  if(oTreeNode2 != NULL)
+    ExpTokenTree_free(oTreeNode2);
+  return NULL;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return oTreeNode wrapped in a NEGATIVE node if iSign is negative, and*/
+/*oTreeNode itself otherwise. Return NULL if memory is insufficient, or*/
+/*if oTreeNode is NULL                                                 */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpSign_materialize(TreeNode_T oTreeNode, int iSign){
+  if(oTreeNode == NULL || iSign > 0)
+    return oTreeNode;
+  return ExpSign_newNode(NEGATIVE, oTreeNode, NULL);
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare oTreeNode1 and oTreeNode2 under a fixed total order on trees:*/
+/*by type, then by operand name, then child by child. Return a negative*/
+/*number if oTreeNode1 comes first, 0 if they are identical and a      */
+/*positive number if oTreeNode2 comes first                            */
+/*---------------------------------------------------------------------*/
+static int ExpSign_order(TreeNode_T oTreeNode1, TreeNode_T oTreeNode2){
+  LinkList_T oLinkList1, oLinkList2;
+  int iCompare;
+  iCompare = (int)ExpSign_type(oTreeNode1) - (int)ExpSign_type(oTreeNode2);
+  if(iCompare != 0)
+    return iCompare;
+  iCompare = strcmp(ExpToken_getName(ExpTokenTree_getValue(oTreeNode1)),\
+		    ExpToken_getName(ExpTokenTree_getValue(oTreeNode2)));
+  if(iCompare != 0)
+    return iCompare;
+  for(oLinkList1 = ExpTokenTree_getChildren(oTreeNode1),\
+	oLinkList2 = ExpTokenTree_getChildren(oTreeNode2);
+      oLinkList1 != NULL && oLinkList2 != NULL;
+      oLinkList1 = LinkList_getNext(oLinkList1),\
+	oLinkList2 = LinkList_getNext(oLinkList2)){
+    iCompare = ExpSign_order((TreeNode_T)LinkList_getValue(oLinkList1),\
+			     (TreeNode_T)LinkList_getValue(oLinkList2));
+    if(iCompare != 0)
+      return iCompare;
+  }
+  return (oLinkList1 != NULL) - (oLinkList2 != NULL);
+}
+
+/*---------------------------------------------------------------------*/
+/*Append oTreeNode with sign iSign to ptlTerms. Return 0 if successful,*/
+/*1 if memory is insufficient                                          */
+/*---------------------------------------------------------------------*/
+static int ExpSign_push(struct TermList* ptlTerms, TreeNode_T oTreeNode,\
+			int iSign){
+  TreeNode_T* poTerms;
+  int* piSigns;
+  unsigned int uiNewMax;
+  if(ptlTerms -> uiLength == ptlTerms -> uiMax){
+    uiNewMax = (ptlTerms -> uiMax == 0u) ?\
+      INITIAL_TERMS : 2u * ptlTerms -> uiMax;
+    poTerms = (TreeNode_T*)realloc(ptlTerms -> poTerms,\
+				   uiNewMax * sizeof(TreeNode_T));
+    if(poTerms == NULL)
+      return 1;
+    ptlTerms -> poTerms = poTerms;
+    piSigns = (int*)realloc(ptlTerms -> piSigns, uiNewMax * sizeof(int));
+    if(piSigns == NULL)
+      return 1;
+    ptlTerms -> piSigns = piSigns;
+    ptlTerms -> uiMax = uiNewMax;
+  }
+  ptlTerms -> poTerms[ptlTerms -> uiLength] = oTreeNode;
+  ptlTerms -> piSigns[ptlTerms -> uiLength] = iSign;
+  ptlTerms -> uiLength++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Append the canonical terms of the sum rooted at oTreeNode to         */
+/*ptlTerms, looking through nested sums and explicit signs. iSign is   */
+/*the sign of the whole of oTreeNode. The terms appended are new trees */
+/*owned by ptlTerms. Return 0 if successful, 1 if memory is            */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpSign_collect(TreeNode_T oTreeNode, int iSign,\
+			   struct TermList* ptlTerms){
+  TreeNode_T oTreeNodeTerm;
+  int iTermSign;
+  switch(ExpSign_type(oTreeNode))
+    {
+    case ADD:
+    case SUBTRACT:
+      if(ExpSign_collect(ExpSign_child(oTreeNode, 0u), iSign,\
+			 ptlTerms) != 0)
+	return 1;
+      return ExpSign_collect(ExpSign_child(oTreeNode, 1u),\
+			     (ExpSign_type(oTreeNode) == ADD) ? iSign : -iSign,\
+			     ptlTerms);
+    case POSITIVE:
+      return ExpSign_collect(ExpSign_child(oTreeNode, 0u), iSign,\
+			     ptlTerms);
+    case NEGATIVE:
+      return ExpSign_collect(ExpSign_child(oTreeNode, 0u), -iSign,\
+			     ptlTerms);
+    default:
+      oTreeNodeTerm = ExpSign_canon(oTreeNode, &iTermSign);
+      if(oTreeNodeTerm == NULL)
+	return 1;
+      if(ExpSign_push(ptlTerms, oTreeNodeTerm, iSign * iTermSign) != 0){
+	ExpTokenTree_free(oTreeNodeTerm);
+	return 1;
+      }
+      return 0;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new canonical tree for the sum rooted at oTreeNode and store*/
+/*its sign in piSign. The sum is scaled so that its smallest term is   */
+/*added, and the first added term is moved to the front so that no sum */
+/*starts with a negation. Return NULL if memory is insufficient        */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpSign_canonSum(TreeNode_T oTreeNode, int* piSign){
+  struct TermList tlTerms = {NULL, NULL, 0u, 0u};
+  TreeNode_T oTreeNodeSum;
+  unsigned int uiIndex, uiMin, uiFirst;
+  int iFailed;
+  iFailed = ExpSign_collect(oTreeNode, 1, &tlTerms);
+  oTreeNodeSum = NULL;
+  if(iFailed == 0 && tlTerms.uiLength > 0u){
+    //scale the sum so that its smallest term is positive
+    for(uiMin = 0u, uiIndex = 1u; uiIndex < tlTerms.uiLength; uiIndex++)
+      if(ExpSign_order(tlTerms.poTerms[uiIndex],\
+		       tlTerms.poTerms[uiMin]) < 0)
+	uiMin = uiIndex;
+    *piSign = tlTerms.piSigns[uiMin];
+    for(uiIndex = 0u; uiIndex < tlTerms.uiLength; uiIndex++)
+      tlTerms.piSigns[uiIndex] *= *piSign;
+    //lead with the first added term, then keep the original order
+    for(uiFirst = 0u; tlTerms.piSigns[uiFirst] < 0; uiFirst++)
+      ;
+    oTreeNodeSum = tlTerms.poTerms[uiFirst];
+    tlTerms.poTerms[uiFirst] = NULL;
+    for(uiIndex = 0u; uiIndex < tlTerms.uiLength; uiIndex++){
+      if(uiIndex == uiFirst)
+	continue;
+      oTreeNodeSum =\
+	ExpSign_newNode((tlTerms.piSigns[uiIndex] > 0) ? ADD : SUBTRACT,\
+			oTreeNodeSum, tlTerms.poTerms[uiIndex]);
+      tlTerms.poTerms[uiIndex] = NULL;
+    }
+  }
+  //terms not consumed by the new sum belong to the list
+  for(uiIndex = 0u; uiIndex < tlTerms.uiLength; uiIndex++)
+    if(tlTerms.poTerms[uiIndex] != NULL)
+      ExpTokenTree_free(tlTerms.poTerms[uiIndex]);
+  free(tlTerms.poTerms);
+  free(tlTerms.piSigns);
+  return oTreeNodeSum;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the integer literal oTreeNode modulo 2, or -1 if oTreeNode is */
+/*not an integer literal                                               */
+/*---------------------------------------------------------------------*/
+static int ExpSign_parity(TreeNode_T oTreeNode){
+  const char* pcName;
+  if(ExpSign_type(oTreeNode) != OPERAND)
+    return -1;
+  pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNode));
+  if(*pcName == '\0')
+    return -1;
+  for(; pcName[1] != '\0'; pcName++)
+    if(*pcName < '0' || *pcName > '9')
+      return -1;
+  if(*pcName < '0' || *pcName > '9')
+    return -1;
+  return (*pcName - '0') % 2;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree holding the magnitude of oTreeNode in canonical    */
+/*form and store its sign, +1 or -1, in piSign. Return NULL if memory  */
+/*is insufficient                                                      */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpSign_canon(TreeNode_T oTreeNode, int* piSign){
+  TreeNode_T oTreeNode1, oTreeNode2, oTreeNodeSwap;
+  enum ExpTokenType ettType;
+  int iSign1, iSign2, iParity;
+  ettType = ExpSign_type(oTreeNode);
+  switch(ettType)
+    {
+    case OPERAND:
+      *piSign = 1;
+      return ExpTokenTree_copy(oTreeNode);
+    case ADD:
+    case SUBTRACT:
+      return ExpSign_canonSum(oTreeNode, piSign);
+    case POSITIVE:
+      return ExpSign_canon(ExpSign_child(oTreeNode, 0u), piSign);
+    case NEGATIVE:
+      oTreeNode1 = ExpSign_canon(ExpSign_child(oTreeNode, 0u), piSign);
+      *piSign = -*piSign;
+      return oTreeNode1;
+    case RECIPROCAL:
+      oTreeNode1 = ExpSign_canon(ExpSign_child(oTreeNode, 0u), piSign);
+      return ExpSign_newNode(RECIPROCAL, oTreeNode1, NULL);
+    case MULTIPLY:
+    case DIVIDE:
+      //(-a)*b, a*(-b) and -(a*b) all carry one sign
+      oTreeNode1 = ExpSign_canon(ExpSign_child(oTreeNode, 0u), &iSign1);
+      oTreeNode2 = ExpSign_canon(ExpSign_child(oTreeNode, 1u), &iSign2);
+      *piSign = iSign1 * iSign2;
+      if(ettType == MULTIPLY && oTreeNode1 != NULL && oTreeNode2 != NULL &&\
+	 ExpSign_order(oTreeNode2, oTreeNode1) < 0){
+	oTreeNodeSwap = oTreeNode1;
+	oTreeNode1 = oTreeNode2;
+	oTreeNode2 = oTreeNodeSwap;
+      }
+      return ExpSign_newNode(ettType, oTreeNode1, oTreeNode2);
+    case POWER:
+      //a sign passes through odd integer powers and vanishes in even ones
+      oTreeNode1 = ExpSign_canon(ExpSign_child(oTreeNode, 0u), &iSign1);
+      oTreeNode2 = ExpSign_canon(ExpSign_child(oTreeNode, 1u), &iSign2);
+      oTreeNode2 = ExpSign_materialize(oTreeNode2, iSign2);
+      iParity = ExpSign_parity(ExpSign_child(oTreeNode, 1u));
+      *piSign = 1;
+      if(iSign1 < 0 && iParity == 1)
+	*piSign = -1;
+      else if(iSign1 < 0 && iParity != 0)
+	oTreeNode1 = ExpSign_materialize(oTreeNode1, iSign1);
+      return ExpSign_newNode(POWER, oTreeNode1, oTreeNode2);
+    default:
+      assert(0);
+      return NULL;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of NEGATIVE nodes in oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSign_countNegations(TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned int uiCount;
+  uiCount = (ExpSign_type(oTreeNode) == NEGATIVE);
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    uiCount +=\
+      ExpSign_countNegations((TreeNode_T)LinkList_getValue(oLinkList));
+  return uiCount;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the trees stored in pllTrees into canonical signed form.     */
+/*Return 0 if successful, 1 if memory is insufficient                  */
+/*---------------------------------------------------------------------*/
+int ExpSign_apply(LinkList_T pllTrees, unsigned int* puiBefore,\
+		  unsigned int* puiAfter){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNode, oTreeNodeNew;
+  unsigned int uiBefore = 0u, uiAfter = 0u;
+  int iSign, iResult = 0;
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNode = (TreeNode_T)LinkList_getValue(oLinkList);
+    uiBefore += ExpSign_countNegations(oTreeNode);
+    if(iResult == 0){
+      //a whole expression has nowhere to pass its sign, so keep it
+      oTreeNodeNew = ExpSign_canon(oTreeNode, &iSign);
+      oTreeNodeNew = ExpSign_materialize(oTreeNodeNew, iSign);
+      if(oTreeNodeNew == NULL)
+	iResult = 1;
+      else{
+	ExpTokenTree_free(oTreeNode);
+	oTreeNode = oTreeNodeNew;
+	LinkList_setValue(oLinkList, oTreeNode);
+      }
+    }
+    uiAfter += ExpSign_countNegations(oTreeNode);
+  }
+  if(puiBefore != NULL)
+    *puiBefore = uiBefore;
+  if(puiAfter != NULL)
+    *puiAfter = uiAfter;
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expsign.c                                                       */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  TreeNode_T oTreeNode1, oTreeNode2, oTreeNodeCanon1, oTreeNodeCanon2;
+  int iSign1, iSign2;
+
+  //(-a)*b and -(b*a) should share a magnitude and a sign
+  oTreeNode1 = ExpSign_newNode(MULTIPLY,\
+			       ExpSign_newNode(NEGATIVE,\
+					       ExpTokenTree_newLeaf("a"),\
+					       NULL),\
+			       ExpTokenTree_newLeaf("b"));
+  oTreeNode2 = ExpSign_newNode(NEGATIVE,\
+			       ExpSign_newNode(MULTIPLY,\
+					       ExpTokenTree_newLeaf("b"),\
+					       ExpTokenTree_newLeaf("a")),\
+			       NULL);
+  oTreeNodeCanon1 = ExpSign_canon(oTreeNode1, &iSign1);
+  oTreeNodeCanon2 = ExpSign_canon(oTreeNode2, &iSign2);
+  if(ExpTokenTree_compare(oTreeNodeCanon1, oTreeNodeCanon2) != 0)
+    printf("failed test 1\n");
+  if(iSign1 != -1 || iSign2 != -1)
+    printf("failed test 2\n");
+
+  //b-a is -(a-b)
+  ExpTokenTree_free(oTreeNode1);
+  ExpTokenTree_free(oTreeNodeCanon1);
+  oTreeNode1 = ExpSign_newNode(SUBTRACT, ExpTokenTree_newLeaf("b"),\
+			       ExpTokenTree_newLeaf("a"));
+  oTreeNodeCanon1 = ExpSign_canon(oTreeNode1, &iSign1);
+  ExpTokenTree_print(oTreeNodeCanon1);
+  printf(" %i\n", iSign1);
+  if(iSign1 != -1)
+    printf("failed test 3\n");
+  ExpTokenTree_free(oTreeNode1);
+  ExpTokenTree_free(oTreeNode2);
+  ExpTokenTree_free(oTreeNodeCanon1);
+  ExpTokenTree_free(oTreeNodeCanon2);
+  return 0;
+}
+*/
@@ -0,0 +1,28 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsign.h describes a pass over a list of ExpTokenTrees that moves   */
+/*every sign to a canonical position, so that forms such as -(a*b),    */
+/*(-a)*b and a*(-b), or a-b and -(b-a), become the same tree and can be*/
+/*computed once                                                        */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPSIGN_INCLUDED
+#define EXPSIGN_INCLUDED
+
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*Rewrite every tree stored in the list pllTrees into canonical signed */
+/*form. Signs are carried up through products, quotients, reciprocals  */
+/*and odd powers until a sum absorbs them as subtractions, and each sum*/
+/*is scaled by -1 if needed so that its smallest term, in a fixed order*/
+/*on trees, is added. Explicit negations remain only where a negative  */
+/*value is actually needed. Store the number of NEGATIVE operations    */
+/*before and after in puiBefore and puiAfter if they are not NULL.     */
+/*Return 0 if successful, 1 if memory is insufficient, in which case   */
+/*the trees are still valid but may be only partially rewritten        */
+/*---------------------------------------------------------------------*/
+int ExpSign_apply(LinkList_T pllTrees, unsigned int* puiBefore,\
+		  unsigned int* puiAfter);
+
+#endif
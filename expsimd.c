@@ -0,0 +1,730 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsimd.c implements expsimd.h. Every version of the kernel is the   */
+/*same straight line code, one statement per instruction, printed      */
+/*through a table of the vector type and intrinsics of each extension. */
+/*Interleaving independent vectors of instances hides the latency of a */
+/*program whose instructions mostly wait on each other, but multiplies */
+/*the values live at once, so vectors are only interleaved as far as   */
+/*the program needs and the cache allows                               */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "expsimd.h"
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the preprocessor condition under which the vector versions are*/
+/*compiled: a compiler with GNU C extensions targeting x86             */
+/*---------------------------------------------------------------------*/
+#define X86_CONDITION "#if defined(__GNUC__) && "\
+  "(defined(__x86_64__) || defined(__i386__))\n"
+
+/*---------------------------------------------------------------------*/
+/*A SIMDTarget is one vector extension: the suffix of its version of   */
+/*the kernel, the name of the extension for the target attribute and   */
+/*for __builtin_cpu_supports, the further extension its fused          */
+/*multiply-adds need, if any, its vector of doubles, the prefix of its */
+/*intrinsics, and the doubles in a vector                              */
+/*---------------------------------------------------------------------*/
+struct SIMDTarget
+{
+  const char* pcSuffix;
+  const char* pcExtension;
+  const char* pcFused;
+  const char* pcVector;
+  const char* pcPrefix;
+  unsigned int uiWidth;
+};
+
+/*---------------------------------------------------------------------*/
+/*Define the targets, widest first, the order in which the host is     */
+/*tested for them                                                      */
+/*---------------------------------------------------------------------*/
+static const struct SIMDTarget ptTargets[] =
+  {{"avx512", "avx512f", NULL, "__m512d", "_mm512", 8u},
+   {"avx2", "avx2", "fma", "__m256d", "_mm256", 4u},
+   {"sse2", "sse2", "fma", "__m128d", "_mm", 2u}};
+#define TARGETS (sizeof(ptTargets) / sizeof(ptTargets[0]))
+
+/*---------------------------------------------------------------------*/
+/*A SIMDKernel is what every part of the kernel is printed from: the   */
+/*program, the name of the kernel, the row of every input, the rows of */
+/*the input array, and which operations the program uses that need a   */
+/*helper or a constant of their own                                    */
+/*---------------------------------------------------------------------*/
+struct SIMDKernel
+{
+  ExpSSA_T oExpSSA;
+  const char* pcFunction;
+  unsigned int* puiRows;
+  unsigned int uiRows;
+  /*values live at once at the peak, inputs and constants included*/
+  unsigned int uiPeak;
+  /*depth of the deepest instruction*/
+  unsigned int uiDepth;
+  int iPower;
+  int iNegative;
+  int iReciprocal;
+  int iFused;
+};
+
+/*---------------------------------------------------------------------*/
+/*Store in *puiPeak the most values of oExpSSA live at once while its  */
+/*instructions are evaluated in order, counting every input and        */
+/*constant as live from the start, and every output as live to the end.*/
+/*Return 0 if successful, 1 if memory is insufficient                  */
+/*---------------------------------------------------------------------*/
+static int ExpSIMD_peak(ExpSSA_T oExpSSA, unsigned int* puiPeak){
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned int* puiLast;
+  unsigned int* puiDeaths;
+  unsigned int uiFirst, uiInstructions, uiValue, uiIndex, uiArg, uiLive;
+  uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  uiInstructions = ExpSSA_instructions(oExpSSA);
+  puiLast = (unsigned int*)malloc((uiFirst + uiInstructions + 1u) *\
+				  sizeof(unsigned int));
+  puiDeaths = (unsigned int*)calloc(uiInstructions + 1u,\
+				    sizeof(unsigned int));
+  if(puiLast == NULL || puiDeaths == NULL){
+    free(puiLast);
+    free(puiDeaths);
+    return 1;
+  }
+  //a value dies at the last instruction that uses it, or else its own
+  for(uiValue = 0u; uiValue < uiFirst + uiInstructions; uiValue++)
+    puiLast[uiValue] = (uiValue < uiFirst) ? 0u : uiValue - uiFirst;
+  for(uiIndex = 0u; uiIndex < uiInstructions; uiIndex++){
+    piInstruction = ExpSSA_instruction(oExpSSA, uiIndex);
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++)
+      puiLast[piInstruction -> puiArgs[uiArg]] = uiIndex;
+  }
+  for(uiIndex = 0u; uiIndex < ExpSSA_outputs(oExpSSA); uiIndex++)
+    puiLast[ExpSSA_output(oExpSSA, uiIndex)] = uiInstructions;
+  for(uiValue = 0u; uiValue < uiFirst + uiInstructions; uiValue++)
+    puiDeaths[puiLast[uiValue]]++;
+  *puiPeak = uiLive = uiFirst;
+  for(uiIndex = 0u; uiIndex < uiInstructions; uiIndex++){
+    uiLive++;
+    if(uiLive > *puiPeak)
+      *puiPeak = uiLive;
+    uiLive -= puiDeaths[uiIndex];
+  }
+  free(puiLast);
+  free(puiDeaths);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of vectors of ptTarget interleaved in a tile of the*/
+/*kernel of pkKernel: enough, with the instructions of one vector that */
+/*may run side by side, the instructions per level of depth, to have   */
+/*EXPSIMD_IN_FLIGHT running at once, but no more than                  */
+/*EXPSIMD_MAX_INTERLEAVE nor more than keep the values live at once    */
+/*within uiCache bytes, and at least one                               */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSIMD_interleave(const struct SIMDKernel* pkKernel,\
+				       const struct SIMDTarget* ptTarget,\
+				       unsigned int uiCache){
+  unsigned long ulVectorBytes;
+  unsigned int uiInterleave;
+  ulVectorBytes = (unsigned long)pkKernel -> uiPeak * ptTarget -> uiWidth *\
+    sizeof(double);
+  for(uiInterleave = 1u; uiInterleave < EXPSIMD_MAX_INTERLEAVE;\
+      uiInterleave *= 2u)
+    if((unsigned long)uiInterleave * ExpSSA_instructions(pkKernel -> oExpSSA)\
+       >= (unsigned long)EXPSIMD_IN_FLIGHT * pkKernel -> uiDepth)
+      break;
+  for(; uiInterleave > 1u; uiInterleave /= 2u)
+    if(ulVectorBytes * uiInterleave <= (unsigned long)uiCache)
+      break;
+  return uiInterleave;
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the index of row uiRow of instance i in an array of n instances*/
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printRow(unsigned int uiRow){
+  if(uiRow > 1u){
+    ExpOut_unsigned(uiRow);
+    ExpOut_string(" * ");
+  }
+  if(uiRow > 0u)
+    ExpOut_string("n + ");
+  ExpOut_char('i');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print value uiValue of the program of pkKernel as it is named in the */
+/*version of the kernel for ptTarget, for the vector uiVector of a     */
+/*tile, or in the plain C version if ptTarget is NULL: an input as its */
+/*vector or else read from in, a constant as its vector or else as a   */
+/*literal, and an instruction as its local                             */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printValue(const struct SIMDKernel* pkKernel,\
+			       const struct SIMDTarget* ptTarget,\
+			       unsigned int uiValue, unsigned int uiVector){
+  ExpSSA_T oExpSSA = pkKernel -> oExpSSA;
+  if(uiValue < ExpSSA_inputs(oExpSSA) && ptTarget == NULL){
+    ExpOut_string("in[");
+    ExpSIMD_printRow(pkKernel -> puiRows[uiValue]);
+    ExpOut_char(']');
+    return;
+  }
+  if(uiValue >= ExpSSA_inputs(oExpSSA) &&\
+     uiValue < ExpSSA_firstInstruction(oExpSSA)){
+    uiValue -= ExpSSA_inputs(oExpSSA);
+    if(ptTarget == NULL)
+      ExpCGen_printLiteral(ExpSSA_constantValue(oExpSSA, uiValue));
+    else{
+      ExpOut_char('c');
+      ExpOut_unsigned(uiValue);
+    }
+    return;
+  }
+  if(uiValue < ExpSSA_inputs(oExpSSA)){
+    ExpOut_char('x');
+    ExpOut_unsigned(uiValue);
+  }
+  else{
+    ExpOut_char('t');
+    ExpOut_unsigned(uiValue - ExpSSA_firstInstruction(oExpSSA));
+  }
+  if(ptTarget != NULL){
+    ExpOut_char('_');
+    ExpOut_unsigned(uiVector);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the intrinsic of ptTarget named pcOperation, ex. _mm256_add_pd */
+/*for add                                                              */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printIntrinsic(const struct SIMDTarget* ptTarget,\
+				   const char* pcOperation){
+  ExpOut_string(ptTarget -> pcPrefix);
+  ExpOut_char('_');
+  ExpOut_string(pcOperation);
+  ExpOut_string("_pd(");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the fused multiply-add piInstruction of the program of pkKernel*/
+/*as the intrinsic of ptTarget of its signs, for the vector uiVector of*/
+/*a tile, or as a call to fma, the signs on its operands, if ptTarget  */
+/*is NULL                                                              */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printFused\
+(const struct SIMDKernel* pkKernel, const struct SIMDTarget* ptTarget,\
+ const struct ExpSSAInstruction* piInstruction, unsigned int uiVector){
+  int iNegateProduct, iNegateAddend;
+  iNegateProduct = (piInstruction -> esoOp == EXPSSA_FNMA ||\
+		    piInstruction -> esoOp == EXPSSA_FNMS);
+  iNegateAddend = (piInstruction -> esoOp == EXPSSA_FMS ||\
+		   piInstruction -> esoOp == EXPSSA_FNMS);
+  if(ptTarget != NULL)
+    ExpSIMD_printIntrinsic(ptTarget, iNegateProduct ?\
+			   (iNegateAddend ? "fnmsub" : "fnmadd") :\
+			   (iNegateAddend ? "fmsub" : "fmadd"));
+  else
+    ExpOut_string(iNegateProduct ? "fma(-" : "fma(");
+  ExpSIMD_printValue(pkKernel, ptTarget, piInstruction -> puiArgs[0],\
+		     uiVector);
+  ExpOut_string(", ");
+  ExpSIMD_printValue(pkKernel, ptTarget, piInstruction -> puiArgs[1],\
+		     uiVector);
+  ExpOut_string(iNegateAddend && ptTarget == NULL ? ", -" : ", ");
+  ExpSIMD_printValue(pkKernel, ptTarget, piInstruction -> puiArgs[2],\
+		     uiVector);
+  ExpOut_char(')');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the target attribute of the version of the kernel of pkKernel  */
+/*for ptTarget, naming the extension of fused multiply-adds too if the */
+/*program has them                                                     */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printAttribute(const struct SIMDKernel* pkKernel,\
+				   const struct SIMDTarget* ptTarget){
+  ExpOut_string("__attribute__((target(\"");
+  ExpOut_string(ptTarget -> pcExtension);
+  if(pkKernel -> iFused && ptTarget -> pcFused != NULL){
+    ExpOut_char(',');
+    ExpOut_string(ptTarget -> pcFused);
+  }
+  ExpOut_string("\")))\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the condition under which the host supports the version of the */
+/*kernel of pkKernel for ptTarget                                      */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printSupports(const struct SIMDKernel* pkKernel,\
+				  const struct SIMDTarget* ptTarget){
+  ExpOut_string("__builtin_cpu_supports(\"");
+  ExpOut_string(ptTarget -> pcExtension);
+  if(pkKernel -> iFused && ptTarget -> pcFused != NULL){
+    ExpOut_string("\") &&\n     __builtin_cpu_supports(\"");
+    ExpOut_string(ptTarget -> pcFused);
+  }
+  ExpOut_string("\")");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the instruction piInstruction of the program of pkKernel as an */
+/*expression of the version of the kernel for ptTarget, for the vector */
+/*uiVector of a tile, or of the plain C version if ptTarget is NULL    */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printInstruction\
+(const struct SIMDKernel* pkKernel, const struct SIMDTarget* ptTarget,\
+ const struct ExpSSAInstruction* piInstruction, unsigned int uiVector){
+  const char* pcOperator = NULL;
+  const char* pcOperation = NULL;
+  switch(piInstruction -> esoOp)
+    {
+    case EXPSSA_FMA:
+    case EXPSSA_FMS:
+    case EXPSSA_FNMA:
+    case EXPSSA_FNMS:
+      ExpSIMD_printFused(pkKernel, ptTarget, piInstruction, uiVector);
+      return;
+    case EXPSSA_ADD:
+      pcOperator = " + ";
+      pcOperation = "add";
+      break;
+    case EXPSSA_SUBTRACT:
+      pcOperator = " - ";
+      pcOperation = "sub";
+      break;
+    case EXPSSA_MULTIPLY:
+    case EXPSSA_NEGATIVE:
+      pcOperator = " * ";
+      pcOperation = "mul";
+      break;
+    case EXPSSA_DIVIDE:
+    case EXPSSA_RECIPROCAL:
+      pcOperator = " / ";
+      pcOperation = "div";
+      break;
+    case EXPSSA_POWER:
+      pcOperator = ", ";
+      break;
+    case EXPSSA_SQRT:
+      pcOperation = "sqrt";
+      break;
+    }
+  //there is no vector power, so each double of a vector is raised alone
+  if(piInstruction -> esoOp == EXPSSA_POWER && ptTarget != NULL){
+    ExpOut_string(pkKernel -> pcFunction);
+    ExpOut_string("_pow_");
+    ExpOut_string(ptTarget -> pcSuffix);
+    ExpOut_char('(');
+  }
+  else if(piInstruction -> esoOp == EXPSSA_POWER)
+    ExpOut_string("pow(");
+  else if(ptTarget != NULL)
+    ExpSIMD_printIntrinsic(ptTarget, pcOperation);
+  else if(piInstruction -> esoOp == EXPSSA_SQRT)
+    ExpOut_string("sqrt(");
+  else if(piInstruction -> esoOp == EXPSSA_NEGATIVE){
+    ExpOut_char('-');
+    pcOperator = NULL;
+  }
+  //a reciprocal is 1 divided by its operand, a negation it times -1
+  if(piInstruction -> esoOp == EXPSSA_RECIPROCAL)
+    ExpOut_string(ptTarget != NULL ? "one" : "1.0");
+  else
+    ExpSIMD_printValue(pkKernel, ptTarget, piInstruction -> puiArgs[0],\
+		       uiVector);
+  if(pcOperator != NULL)
+    ExpOut_string(ptTarget != NULL ? ", " : pcOperator);
+  if(piInstruction -> esoOp == EXPSSA_RECIPROCAL)
+    ExpSIMD_printValue(pkKernel, ptTarget, piInstruction -> puiArgs[0],\
+		       uiVector);
+  else if(piInstruction -> esoOp == EXPSSA_NEGATIVE && ptTarget != NULL)
+    ExpOut_string("minus_one");
+  else if(piInstruction -> uiArgs > 1u)
+    ExpSIMD_printValue(pkKernel, ptTarget, piInstruction -> puiArgs[1],\
+		       uiVector);
+  if(ptTarget != NULL || piInstruction -> esoOp == EXPSSA_POWER ||\
+     piInstruction -> esoOp == EXPSSA_SQRT)
+    ExpOut_char(')');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the start of a definition of a version of the kernel of        */
+/*pkKernel, of the given suffix, up to the parameters, which take a    */
+/*further pcParameters                                                 */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printHead(const struct SIMDKernel* pkKernel,\
+			      const char* pcSuffix,\
+			      const char* pcParameters){
+  ExpOut_string("static size_t ");
+  ExpOut_string(pkKernel -> pcFunction);
+  ExpOut_char('_');
+  ExpOut_string(pcSuffix);
+  ExpOut_string("(const double* restrict in,\n"\
+		"    double* restrict out, size_t n");
+  ExpOut_string(pcParameters);
+  ExpOut_string("){\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the plain C version of the kernel of pkKernel, which evaluates */
+/*instances i to n-1 one at a time and returns n                       */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printScalar(const struct SIMDKernel* pkKernel){
+  ExpSSA_T oExpSSA = pkKernel -> oExpSSA;
+  unsigned int uiIndex;
+  ExpSIMD_printHead(pkKernel, "scalar", ", size_t i");
+  ExpOut_string("  for(; i < n; i++){\n");
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++){
+    ExpOut_string("    const double t");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string(" = ");
+    ExpSIMD_printInstruction(pkKernel, NULL,\
+			     ExpSSA_instruction(oExpSSA, uiIndex), 0u);
+    ExpOut_string(";\n");
+  }
+  for(uiIndex = 0u; uiIndex < ExpSSA_outputs(oExpSSA); uiIndex++){
+    ExpOut_string("    out[");
+    ExpSIMD_printRow(uiIndex);
+    ExpOut_string("] = ");
+    ExpSIMD_printValue(pkKernel, NULL, ExpSSA_output(oExpSSA, uiIndex), 0u);
+    ExpOut_string(";\n");
+  }
+  ExpOut_string("  }\n  return i;\n}\n\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the vector declaration of pcName, of ptTarget, set to every    */
+/*double being pcValue                                                 */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printBroadcast(const struct SIMDTarget* ptTarget,\
+				   const char* pcName, const char* pcValue){
+  ExpOut_string("  const ");
+  ExpOut_string(ptTarget -> pcVector);
+  ExpOut_char(' ');
+  ExpOut_string(pcName);
+  ExpOut_string(" = ");
+  ExpSIMD_printIntrinsic(ptTarget, "set1");
+  ExpOut_string(pcValue);
+  ExpOut_string(");\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the address of the double of row uiRow of pcArray that starts  */
+/*vector uiVector of a tile of vectors of uiWidth doubles              */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printAddress(const char* pcArray, unsigned int uiRow,\
+				 unsigned int uiVector, unsigned int uiWidth){
+  ExpOut_string(pcArray);
+  ExpOut_string(" + ");
+  ExpSIMD_printRow(uiRow);
+  if(uiVector > 0u){
+    ExpOut_string(" + ");
+    ExpOut_unsigned(uiVector * uiWidth);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the version of the kernel of pkKernel for ptTarget, with       */
+/*uiInterleave vectors in a tile, which evaluates every whole tile of  */
+/*the n instances and returns the number evaluated, along with the     */
+/*helper raising each double of a vector to a power if the program has */
+/*powers                                                               */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printVector(const struct SIMDKernel* pkKernel,\
+				const struct SIMDTarget* ptTarget,\
+				unsigned int uiInterleave){
+  ExpSSA_T oExpSSA = pkKernel -> oExpSSA;
+  unsigned int uiIndex, uiVector, uiTile;
+  uiTile = uiInterleave * ptTarget -> uiWidth;
+  if(pkKernel -> iPower){
+    ExpSIMD_printAttribute(pkKernel, ptTarget);
+    ExpOut_string("static ");
+    ExpOut_string(ptTarget -> pcVector);
+    ExpOut_char(' ');
+    ExpOut_string(pkKernel -> pcFunction);
+    ExpOut_string("_pow_");
+    ExpOut_string(ptTarget -> pcSuffix);
+    ExpOut_char('(');
+    ExpOut_string(ptTarget -> pcVector);
+    ExpOut_string(" a, ");
+    ExpOut_string(ptTarget -> pcVector);
+    ExpOut_string(" b){\n  double pa[");
+    ExpOut_unsigned(ptTarget -> uiWidth);
+    ExpOut_string("], pb[");
+    ExpOut_unsigned(ptTarget -> uiWidth);
+    ExpOut_string("];\n  int k;\n  ");
+    ExpSIMD_printIntrinsic(ptTarget, "storeu");
+    ExpOut_string("pa, a);\n  ");
+    ExpSIMD_printIntrinsic(ptTarget, "storeu");
+    ExpOut_string("pb, b);\n  for(k = 0; k < ");
+    ExpOut_unsigned(ptTarget -> uiWidth);
+    ExpOut_string("; k++)\n    pa[k] = pow(pa[k], pb[k]);\n  return ");
+    ExpSIMD_printIntrinsic(ptTarget, "loadu");
+    ExpOut_string("pa);\n}\n\n");
+  }
+  ExpOut_string("//");
+  ExpOut_unsigned(uiInterleave);
+  ExpOut_string(uiInterleave == 1u ? " vector of " : " vectors of ");
+  ExpOut_unsigned(ptTarget -> uiWidth);
+  ExpOut_string(" instances a tile\n");
+  ExpSIMD_printAttribute(pkKernel, ptTarget);
+  ExpSIMD_printHead(pkKernel, ptTarget -> pcSuffix, "");
+  //constants are set once, outside the loop
+  for(uiIndex = 0u; uiIndex < ExpSSA_constants(oExpSSA); uiIndex++){
+    ExpOut_string("  const ");
+    ExpOut_string(ptTarget -> pcVector);
+    ExpOut_string(" c");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string(" = ");
+    ExpSIMD_printIntrinsic(ptTarget, "set1");
+    ExpCGen_printLiteral(ExpSSA_constantValue(oExpSSA, uiIndex));
+    ExpOut_string(");\n");
+  }
+  if(pkKernel -> iReciprocal)
+    ExpSIMD_printBroadcast(ptTarget, "one", "1.0");
+  if(pkKernel -> iNegative)
+    ExpSIMD_printBroadcast(ptTarget, "minus_one", "-1.0");
+  ExpOut_string("  size_t i;\n  for(i = 0; i + ");
+  ExpOut_unsigned(uiTile);
+  ExpOut_string(" <= n; i += ");
+  ExpOut_unsigned(uiTile);
+  ExpOut_string("){\n");
+  for(uiIndex = 0u; uiIndex < ExpSSA_inputs(oExpSSA); uiIndex++)
+    for(uiVector = 0u; uiVector < uiInterleave; uiVector++){
+      ExpOut_string("    const ");
+      ExpOut_string(ptTarget -> pcVector);
+      ExpOut_char(' ');
+      ExpSIMD_printValue(pkKernel, ptTarget, uiIndex, uiVector);
+      ExpOut_string(" = ");
+      ExpSIMD_printIntrinsic(ptTarget, "loadu");
+      ExpSIMD_printAddress("in", pkKernel -> puiRows[uiIndex], uiVector,\
+			   ptTarget -> uiWidth);
+      ExpOut_string(");\n");
+    }
+  //the vectors of a tile are independent, and interleaved
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++)
+    for(uiVector = 0u; uiVector < uiInterleave; uiVector++){
+      ExpOut_string("    const ");
+      ExpOut_string(ptTarget -> pcVector);
+      ExpOut_string(" t");
+      ExpOut_unsigned(uiIndex);
+      ExpOut_char('_');
+      ExpOut_unsigned(uiVector);
+      ExpOut_string(" = ");
+      ExpSIMD_printInstruction(pkKernel, ptTarget,\
+			       ExpSSA_instruction(oExpSSA, uiIndex),\
+			       uiVector);
+      ExpOut_string(";\n");
+    }
+  for(uiIndex = 0u; uiIndex < ExpSSA_outputs(oExpSSA); uiIndex++)
+    for(uiVector = 0u; uiVector < uiInterleave; uiVector++){
+      ExpOut_string("    ");
+      ExpSIMD_printIntrinsic(ptTarget, "storeu");
+      ExpSIMD_printAddress("out", uiIndex, uiVector, ptTarget -> uiWidth);
+      ExpOut_string(", ");
+      ExpSIMD_printValue(pkKernel, ptTarget, ExpSSA_output(oExpSSA, uiIndex),\
+			 uiVector);
+      ExpOut_string(");\n");
+    }
+  ExpOut_string("  }\n  return i;\n}\n\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the type of a version of the kernel of pkKernel, the version   */
+/*evaluating no instances for hosts without a vector extension, the    */
+/*choice of a version for the host, and the kernel itself              */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printDispatch(const struct SIMDKernel* pkKernel){
+  const char* pcFunction = pkKernel -> pcFunction;
+  unsigned int uiTarget;
+  ExpOut_string("typedef size_t (*");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_version)(const double* restrict, double* restrict,\n"\
+		"    size_t);\n\n");
+  ExpSIMD_printHead(pkKernel, "none", "");
+  ExpOut_string("  (void)in;\n  (void)out;\n  (void)n;\n"\
+		"  return 0;\n}\n\nstatic ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_version ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_select(void){\n" X86_CONDITION\
+		"  __builtin_cpu_init();\n");
+  for(uiTarget = 0u; uiTarget < TARGETS; uiTarget++){
+    ExpOut_string("  if(");
+    ExpSIMD_printSupports(pkKernel, &ptTargets[uiTarget]);
+    ExpOut_string(")\n    return ");
+    ExpOut_string(pcFunction);
+    ExpOut_char('_');
+    ExpOut_string(ptTargets[uiTarget].pcSuffix);
+    ExpOut_string(";\n");
+  }
+  ExpOut_string("#endif\n  return ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_none;\n}\n\nvoid ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("(const double* restrict in, double* restrict out, "\
+		"size_t n){\n  static ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_version version = NULL;\n"\
+		"  if(version == NULL)\n    version = ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_select();\n  ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_scalar(in, out, n, version(in, out, n));\n}\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the main function measuring the instances per second of every  */
+/*version of the kernel of pkKernel the host supports, compiled if     */
+/*EXPPARSER_BENCHMARK is defined                                       */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printBenchmark(const struct SIMDKernel* pkKernel){
+  const char* pcFunction = pkKernel -> pcFunction;
+  unsigned int uiTarget;
+  ExpOut_string("\n#ifdef EXPPARSER_BENCHMARK\n#include <stdio.h>\n"\
+		"#include <stdlib.h>\n#include <time.h>\n\n"\
+		"static double ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_rate(");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_version version, const double* in,\n"\
+		"    double* out, size_t n){\n"\
+		"  clock_t start = clock(), elapsed;\n"\
+		"  unsigned long runs = 0;\n  do{\n    ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_scalar(in, out, n, version(in, out, n));\n"\
+		"    runs++;\n    elapsed = clock() - start;\n"\
+		"  }while(elapsed < CLOCKS_PER_SEC / 2);\n"\
+		"  return (double)runs * n * CLOCKS_PER_SEC / elapsed;\n"\
+		"}\n\nint main(int argc, char* argv[]){\n"\
+		"  size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 65536;\n"\
+		"  size_t i;\n  double* in = malloc(");
+  ExpOut_unsigned(pkKernel -> uiRows);
+  ExpOut_string(" * n * sizeof(double));\n  double* out = malloc(");
+  ExpOut_unsigned(ExpSSA_outputs(pkKernel -> oExpSSA));
+  ExpOut_string(" * n * sizeof(double));\n"\
+		"  if(in == NULL || out == NULL)\n    return 1;\n"\
+		"  for(i = 0; i < ");
+  ExpOut_unsigned(pkKernel -> uiRows);
+  ExpOut_string(" * n; i++)\n"\
+		"    in[i] = 1.0 + (double)(i % 1021) / 1021.0;\n"\
+		"  printf(\"scalar %.4g instances/s\\n\", ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_rate(");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_none, in, out, n));\n" X86_CONDITION\
+		"  __builtin_cpu_init();\n");
+  for(uiTarget = TARGETS; uiTarget > 0u; uiTarget--){
+    ExpOut_string("  if(");
+    ExpSIMD_printSupports(pkKernel, &ptTargets[uiTarget - 1u]);
+    ExpOut_string(")\n    printf(\"");
+    ExpOut_string(ptTargets[uiTarget - 1u].pcSuffix);
+    ExpOut_string(" %.4g instances/s\\n\",\n           ");
+    ExpOut_string(pcFunction);
+    ExpOut_string("_rate(");
+    ExpOut_string(pcFunction);
+    ExpOut_char('_');
+    ExpOut_string(ptTargets[uiTarget - 1u].pcSuffix);
+    ExpOut_string(", in, out, n));\n");
+  }
+  ExpOut_string("#endif\n  free(in);\n  free(out);\n  return 0;\n}\n"\
+		"#endif\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print a comment describing the kernel of pkKernel and the row every  */
+/*input is read from                                                   */
+/*---------------------------------------------------------------------*/
+static void ExpSIMD_printComment(const struct SIMDKernel* pkKernel){
+  ExpSSA_T oExpSSA = pkKernel -> oExpSSA;
+  unsigned int uiInput;
+  ExpOut_string("/*\n * Generated by expparser: ");
+  ExpOut_unsigned(ExpSSA_inputs(oExpSSA));
+  ExpOut_string(" inputs, ");
+  ExpOut_unsigned(ExpSSA_instructions(oExpSSA));
+  ExpOut_string(" operations, ");
+  ExpOut_unsigned(ExpSSA_outputs(oExpSSA));
+  ExpOut_string(" outputs,\n * at most ");
+  ExpOut_unsigned(pkKernel -> uiPeak);
+  ExpOut_string(" values live at once.\n * ");
+  ExpOut_string(pkKernel -> pcFunction);
+  ExpOut_string("(in, out, n) evaluates n instances stored as "\
+		"structures of\n * arrays: operand k of instance i is "\
+		"in[k*n + i], and expression j of\n * instance i is "\
+		"stored in out[j*n + i]. The operands are read from\n *\n");
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++){
+    ExpOut_string(" *   ");
+    ExpOut_string(ExpSSA_inputName(oExpSSA, uiInput));
+    ExpOut_string("  ");
+    ExpSIMD_printValue(pkKernel, NULL, uiInput, 0u);
+    ExpOut_char('\n');
+  }
+  ExpOut_string(" */\n#include <math.h>\n#include <stddef.h>\n"\
+		X86_CONDITION "#include <immintrin.h>\n#endif\n\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the kernel of oExpSSA                                          */
+/*---------------------------------------------------------------------*/
+int ExpSIMD_print(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+		  unsigned int uiCache){
+  struct SIMDKernel kKernel;
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned int uiIndex, uiTarget;
+  int iStatus;
+  assert(oExpCGen != NULL);
+  assert(oExpSSA != NULL);
+  kKernel.oExpSSA = oExpSSA;
+  kKernel.pcFunction = ExpCGen_function(oExpCGen);
+  kKernel.puiRows = (unsigned int*)malloc((ExpSSA_inputs(oExpSSA) + 1u) *\
+					  sizeof(unsigned int));
+  if(kKernel.puiRows == NULL)
+    return 1;
+  iStatus = ExpCGen_indexes(oExpCGen, oExpSSA, kKernel.puiRows);
+  if(iStatus == 0)
+    iStatus = ExpSIMD_peak(oExpSSA, &kKernel.uiPeak);
+  if(iStatus != 0){
+    free(kKernel.puiRows);
+    return iStatus;
+  }
+  kKernel.uiRows = 0u;
+  for(uiIndex = 0u; uiIndex < ExpSSA_inputs(oExpSSA); uiIndex++)
+    if(kKernel.puiRows[uiIndex] >= kKernel.uiRows)
+      kKernel.uiRows = kKernel.puiRows[uiIndex] + 1u;
+  kKernel.iPower = kKernel.iNegative = kKernel.iReciprocal = 0;
+  kKernel.iFused = 0;
+  kKernel.uiDepth = 0u;
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++){
+    piInstruction = ExpSSA_instruction(oExpSSA, uiIndex);
+    if(piInstruction -> uiDepth > kKernel.uiDepth)
+      kKernel.uiDepth = piInstruction -> uiDepth;
+    kKernel.iPower |= (piInstruction -> esoOp == EXPSSA_POWER);
+    kKernel.iNegative |= (piInstruction -> esoOp == EXPSSA_NEGATIVE);
+    kKernel.iReciprocal |= (piInstruction -> esoOp == EXPSSA_RECIPROCAL);
+    kKernel.iFused |= (piInstruction -> uiArgs == 3u);
+  }
+  ExpSIMD_printComment(&kKernel);
+  //products and sums are rounded one at a time, as in the C function,
+  //unless the program asks for fused multiply-adds itself
+  if(kKernel.iFused == 0)
+    ExpOut_string("#if defined(__clang__)\n#pragma STDC FP_CONTRACT OFF\n"\
+		  "#elif defined(__GNUC__)\n"\
+		  "#pragma GCC optimize(\"fp-contract=off\")\n#endif\n\n");
+  ExpSIMD_printScalar(&kKernel);
+  ExpOut_string(X86_CONDITION);
+  for(uiTarget = 0u; uiTarget < TARGETS; uiTarget++)
+    ExpSIMD_printVector(&kKernel, &ptTargets[uiTarget],\
+			ExpSIMD_interleave(&kKernel, &ptTargets[uiTarget],\
+					   uiCache));
+  ExpOut_string("#endif\n\n");
+  ExpSIMD_printDispatch(&kKernel);
+  ExpSIMD_printBenchmark(&kKernel);
+  free(kKernel.puiRows);
+  return 0;
+}
@@ -0,0 +1,53 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expsimd.h describes a code generator that writes the static single   */
+/*assignment form of a program as a C kernel evaluating it for a batch */
+/*of independent instances at once, with a version for each x86 vector */
+/*extension and one for plain C, chosen when the kernel is first called*/
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPSIMD_INCLUDED
+#define EXPSIMD_INCLUDED
+
+#include "expcgen.h"
+#include "expssa.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the default size of the data cache the working set of a tile  */
+/*of instances is kept within, in bytes                                */
+/*---------------------------------------------------------------------*/
+#define EXPSIMD_CACHE 32768u
+
+/*---------------------------------------------------------------------*/
+/*Define the most vectors of instances interleaved in one tile, and the*/
+/*instructions a tile should have ready to run at once to keep the     */
+/*vector units of a core busy, about their number times their latency  */
+/*---------------------------------------------------------------------*/
+#define EXPSIMD_MAX_INTERLEAVE 4u
+#define EXPSIMD_IN_FLIGHT 8u
+
+/*---------------------------------------------------------------------*/
+/*Print to stdout a C kernel computing oExpSSA for n instances stored  */
+/*as structures of arrays, named and with its inputs mapped to rows by */
+/*oExpCGen: operand k of instance i is read from in[k*n + i] and       */
+/*expression j of instance i is stored in out[j*n + i]. The kernel has */
+/*a version for SSE2, AVX2 and AVX-512 intrinsics, each of which       */
+/*evaluates tiles of one or more vectors of instances, interleaved when*/
+/*one vector has too few instructions that may run side by side, but   */
+/*only as many as keep the values live at once within uiCache bytes.   */
+/*The version for the host is chosen at the first call, the SSE2 and   */
+/*AVX2 versions of a program with fused multiply-adds only on a host   */
+/*with FMA too, and the instances left over after the last whole tile  */
+/*are evaluated one at a time in plain C. A program without fused      */
+/*multiply-adds turns off floating-point contraction, so every version */
+/*rounds each operation as the plain C function does. A main function  */
+/*measuring the instances per second of every version the host supports*/
+/*is included if EXPPARSER_BENCHMARK is defined. Return 0 if           */
+/*successful, 1 if memory is insufficient, -1 if oExpCGen reads the    */
+/*inputs from a struct or maps one to something other than a row, in   */
+/*which case nothing is printed                                        */
+/*---------------------------------------------------------------------*/
+int ExpSIMD_print(ExpCGen_T oExpCGen, ExpSSA_T oExpSSA,\
+		  unsigned int uiCache);
+
+#endif
@@ -0,0 +1,1281 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expslp.c implements expslp.h. Two instructions at the same depth     */
+/*cannot use each other, since an instruction is deeper than every     */
+/*instruction it uses, so the instructions of a depth are packed by    */
+/*operation alone. What a pack costs beyond its one vector instruction */
+/*is building its operand vectors: free when an operand is an earlier  */
+/*pack as it is, one permute when it is an earlier pack reordered, and */
+/*a broadcast or an insertion per lane otherwise. The lanes of a pack  */
+/*are therefore ordered by the pack and lane of their first operand,   */
+/*the operands of a sum or product swapped to put a lane first, and a  */
+/*pack is cut short rather than let it straddle two packs its operands */
+/*come from                                                            */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "expslp.h"
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the preprocessor condition under which the vector function is */
+/*compiled: a compiler with GNU C extensions targeting x86             */
+/*---------------------------------------------------------------------*/
+#define X86_CONDITION "#if defined(__GNUC__) && "\
+  "(defined(__x86_64__) || defined(__i386__))\n"
+
+/*---------------------------------------------------------------------*/
+/*Define the pack of an instruction that is in none                    */
+/*---------------------------------------------------------------------*/
+#define NO_PACK 0xFFFFFFFFu
+
+/*---------------------------------------------------------------------*/
+/*An SLPTarget is one vector extension: its name for the target        */
+/*attribute, its vector of doubles, the prefix of its intrinsics, and  */
+/*the doubles in a vector                                              */
+/*---------------------------------------------------------------------*/
+struct SLPTarget
+{
+  const char* pcExtension;
+  const char* pcVector;
+  const char* pcPrefix;
+  unsigned int uiWidth;
+};
+
+/*---------------------------------------------------------------------*/
+/*Define the targets, one per width                                    */
+/*---------------------------------------------------------------------*/
+static const struct SLPTarget ptTargets[] =
+  {{"sse2", "__m128d", "_mm", 2u},
+   {"avx2", "__m256d", "_mm256", 4u}};
+#define TARGETS (sizeof(ptTargets) / sizeof(ptTargets[0]))
+
+/*---------------------------------------------------------------------*/
+/*How an operand vector of a pack is built: as an earlier pack, an     */
+/*earlier pack with its lanes reordered, one value in every lane, or   */
+/*one value per lane                                                   */
+/*---------------------------------------------------------------------*/
+enum SLPOperand {SLP_DIRECT, SLP_PERMUTE, SLP_BROADCAST, SLP_GATHER};
+
+/*---------------------------------------------------------------------*/
+/*An SLPPack is one vector instruction: its operation, the lanes in    */
+/*use, the instruction in each, how each operand vector is built and,  */
+/*for an earlier pack, which one and the selector of the permute, or   */
+/*else the operand that builds the same vector first, numbered twice   */
+/*its pack plus its place, and whether its lanes are also read one at a*/
+/*time, so it is stored to an array                                    */
+/*---------------------------------------------------------------------*/
+struct SLPPack
+{
+  enum ExpSSAOp esoOp;
+  unsigned int uiDepth;
+  unsigned int uiLanes;
+  unsigned int puiMembers[EXPSLP_MAX_WIDTH];
+  enum SLPOperand psoOperands[2];
+  unsigned int puiSources[2];
+  unsigned int puiSelectors[2];
+  unsigned int puiBuilders[2];
+  int iStored;
+  //instructions building its operands, and those it saves other packs
+  unsigned int uiCost;
+  unsigned int uiPenalty;
+};
+
+/*---------------------------------------------------------------------*/
+/*An SLPCandidate is an instruction waiting to be packed, with the     */
+/*class and key of each of its operands it is ordered by: class 0 for a*/
+/*lane of a pack, keyed by the pack and lane, class 1 otherwise, keyed */
+/*by the value                                                         */
+/*---------------------------------------------------------------------*/
+struct SLPCandidate
+{
+  unsigned int uiInstruction;
+  unsigned int puiClasses[2];
+  unsigned int puiKeys[2];
+};
+
+struct ExpSLP
+{
+  ExpSSA_T oExpSSA;
+  const struct SLPTarget* ptTarget;
+  //pack and lane of every instruction, NO_PACK if in none
+  unsigned int* puiPacks;
+  unsigned int* puiLanes;
+  //whether the operands of an instruction are read in reverse
+  int* piSwapped;
+  //instructions in order of depth, the order they are printed in
+  unsigned int* puiOrder;
+  struct SLPPack* ppPacks;
+  unsigned int uiPacks;
+  //open addressing hash table of the operands that build a vector
+  unsigned int* puiBuilders;
+  unsigned int uiMask;
+  unsigned int uiPacked;
+  unsigned int uiPermutes;
+  unsigned int uiGathers;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return operand uiArg of instruction uiInstruction of oExpSLP, in the */
+/*order the pack of the instruction reads them                         */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSLP_arg(ExpSLP_T oExpSLP, unsigned int uiInstruction,\
+			       unsigned int uiArg){
+  const struct ExpSSAInstruction* piInstruction;
+  piInstruction = ExpSSA_instruction(oExpSLP -> oExpSSA, uiInstruction);
+  if(oExpSLP -> piSwapped[uiInstruction] != 0)
+    uiArg = 1u - uiArg;
+  return piInstruction -> puiArgs[uiArg];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the pack of value uiValue of oExpSLP, or NO_PACK if it is not */
+/*an instruction in a pack                                             */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSLP_packOf(ExpSLP_T oExpSLP, unsigned int uiValue){
+  unsigned int uiFirst = ExpSSA_firstInstruction(oExpSLP -> oExpSSA);
+  if(uiValue < uiFirst)
+    return NO_PACK;
+  return oExpSLP -> puiPacks[uiValue - uiFirst];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the lane of value uiValue of oExpSLP, which is in a pack      */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSLP_laneOf(ExpSLP_T oExpSLP, unsigned int uiValue){
+  return oExpSLP -> puiLanes[uiValue -\
+			     ExpSSA_firstInstruction(oExpSLP -> oExpSSA)];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the value in lane uiLane of operand uiArg of the pack ppPack  */
+/*of oExpSLP, where the lanes the pack does not use repeat its first   */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSLP_lane(ExpSLP_T oExpSLP,\
+				const struct SLPPack* ppPack,\
+				unsigned int uiArg, unsigned int uiLane){
+  if(uiLane >= ppPack -> uiLanes)
+    uiLane = 0u;
+  return ExpSLP_arg(oExpSLP, ppPack -> puiMembers[uiLane], uiArg);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store in puiClass and puiKey the class and key of value uiValue of   */
+/*oExpSLP as an operand of a candidate                                 */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_key(ExpSLP_T oExpSLP, unsigned int uiValue,\
+		       unsigned int* puiClass, unsigned int* puiKey){
+  unsigned int uiPack = ExpSLP_packOf(oExpSLP, uiValue);
+  if(uiPack == NO_PACK){
+    *puiClass = 1u;
+    *puiKey = uiValue;
+  }
+  else{
+    *puiClass = 0u;
+    *puiKey = uiPack * EXPSLP_MAX_WIDTH + ExpSLP_laneOf(oExpSLP, uiValue);
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare the SLPCandidates pvCandidate1 and pvCandidate2 by the class */
+/*and key of their first operand, then of their second, then by        */
+/*instruction, for qsort                                               */
+/*---------------------------------------------------------------------*/
+static int ExpSLP_compare(const void* pvCandidate1,\
+			  const void* pvCandidate2){
+  const struct SLPCandidate* pcCandidate1 =\
+    (const struct SLPCandidate*)pvCandidate1;
+  const struct SLPCandidate* pcCandidate2 =\
+    (const struct SLPCandidate*)pvCandidate2;
+  unsigned int uiArg;
+  for(uiArg = 0u; uiArg < 2u; uiArg++){
+    if(pcCandidate1 -> puiClasses[uiArg] != pcCandidate2 -> puiClasses[uiArg])
+      return (pcCandidate1 -> puiClasses[uiArg] <\
+	      pcCandidate2 -> puiClasses[uiArg]) ? -1 : 1;
+    if(pcCandidate1 -> puiKeys[uiArg] != pcCandidate2 -> puiKeys[uiArg])
+      return (pcCandidate1 -> puiKeys[uiArg] <\
+	      pcCandidate2 -> puiKeys[uiArg]) ? -1 : 1;
+  }
+  if(pcCandidate1 -> uiInstruction != pcCandidate2 -> uiInstruction)
+    return (pcCandidate1 -> uiInstruction <\
+	    pcCandidate2 -> uiInstruction) ? -1 : 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Fill pcCandidate for instruction uiInstruction of oExpSLP, swapping  */
+/*the operands of a sum or product if the second orders first          */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_candidate(ExpSLP_T oExpSLP, unsigned int uiInstruction,\
+			     struct SLPCandidate* pcCandidate){
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned int uiArg;
+  piInstruction = ExpSSA_instruction(oExpSLP -> oExpSSA, uiInstruction);
+  pcCandidate -> uiInstruction = uiInstruction;
+  pcCandidate -> puiClasses[1] = pcCandidate -> puiKeys[1] = 0u;
+  for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++)
+    ExpSLP_key(oExpSLP, piInstruction -> puiArgs[uiArg],\
+	       &pcCandidate -> puiClasses[uiArg],\
+	       &pcCandidate -> puiKeys[uiArg]);
+  if((piInstruction -> esoOp != EXPSSA_ADD &&\
+      piInstruction -> esoOp != EXPSSA_MULTIPLY) ||\
+     pcCandidate -> puiClasses[0] < pcCandidate -> puiClasses[1] ||\
+     (pcCandidate -> puiClasses[0] == pcCandidate -> puiClasses[1] &&\
+      pcCandidate -> puiKeys[0] <= pcCandidate -> puiKeys[1]))
+    return;
+  oExpSLP -> piSwapped[uiInstruction] = 1;
+  uiArg = pcCandidate -> puiClasses[0];
+  pcCandidate -> puiClasses[0] = pcCandidate -> puiClasses[1];
+  pcCandidate -> puiClasses[1] = uiArg;
+  uiArg = pcCandidate -> puiKeys[0];
+  pcCandidate -> puiKeys[0] = pcCandidate -> puiKeys[1];
+  pcCandidate -> puiKeys[1] = uiArg;
+}
+
+/*---------------------------------------------------------------------*/
+/*Mark the pack of value uiValue of oExpSLP, if any, as read one lane  */
+/*at a time                                                            */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_store(ExpSLP_T oExpSLP, unsigned int uiValue){
+  unsigned int uiPack = ExpSLP_packOf(oExpSLP, uiValue);
+  if(uiPack != NO_PACK)
+    oExpSLP -> ppPacks[uiPack].iStored = 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the operand of oExpSLP, numbered twice its pack plus its      */
+/*place, that first builds the same vector as operand uiArg of pack    */
+/*uiPack, and enter the operand in the table if none does before it    */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSLP_builder(ExpSLP_T oExpSLP, unsigned int uiPack,\
+				   unsigned int uiArg){
+  const struct SLPPack* ppPack = &oExpSLP -> ppPacks[uiPack];
+  const struct SLPPack* ppOther;
+  unsigned int uiHash = 0u, uiLane, uiSlot, uiWidth, uiOther;
+  uiWidth = oExpSLP -> ptTarget -> uiWidth;
+  for(uiLane = 0u; uiLane < uiWidth; uiLane++)
+    uiHash = uiHash * 31u + ExpSLP_lane(oExpSLP, ppPack, uiArg, uiLane);
+  for(uiSlot = uiHash & oExpSLP -> uiMask;\
+      oExpSLP -> puiBuilders[uiSlot] != NO_PACK;\
+      uiSlot = (uiSlot + 1u) & oExpSLP -> uiMask){
+    uiOther = oExpSLP -> puiBuilders[uiSlot];
+    ppOther = &oExpSLP -> ppPacks[uiOther / 2u];
+    for(uiLane = 0u; uiLane < uiWidth; uiLane++)
+      if(ExpSLP_lane(oExpSLP, ppPack, uiArg, uiLane) !=\
+	 ExpSLP_lane(oExpSLP, ppOther, uiOther % 2u, uiLane))
+	break;
+    if(uiLane == uiWidth)
+      return uiOther;
+  }
+  oExpSLP -> puiBuilders[uiSlot] = uiPack * 2u + uiArg;
+  return uiPack * 2u + uiArg;
+}
+
+/*---------------------------------------------------------------------*/
+/*Decide how operand uiArg of pack uiPack of oExpSLP is built, from the*/
+/*packs and operands before it, count it, and return the instructions  */
+/*it costs: none for an earlier pack as it is or a vector an earlier   */
+/*operand builds, one for a permute or for a broadcast of anything but */
+/*a constant, which the instruction reads from memory itself, and one  */
+/*per lane to gather. Add to an earlier pack it is built from what it  */
+/*would cost to gather instead                                         */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSLP_operand(ExpSLP_T oExpSLP, unsigned int uiPack,\
+				   unsigned int uiArg){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  struct SLPPack* ppPack = &oExpSLP -> ppPacks[uiPack];
+  unsigned int uiLane, uiFirst, uiValue, uiSource, uiBits, uiCost;
+  int iSame = 1, iInPlace = 1;
+  uiFirst = ExpSLP_lane(oExpSLP, ppPack, uiArg, 0u);
+  uiSource = ExpSLP_packOf(oExpSLP, uiFirst);
+  //a selector has a field per lane wide enough for any lane
+  uiBits = (oExpSLP -> ptTarget -> uiWidth > 2u) ? 2u : 1u;
+  ppPack -> puiSelectors[uiArg] = 0u;
+  for(uiLane = 0u; uiLane < ppPack -> uiLanes; uiLane++){
+    uiValue = ExpSLP_lane(oExpSLP, ppPack, uiArg, uiLane);
+    iSame &= (uiValue == uiFirst);
+    if(uiSource != NO_PACK && ExpSLP_packOf(oExpSLP, uiValue) == uiSource){
+      iInPlace &= (ExpSLP_laneOf(oExpSLP, uiValue) == uiLane);
+      ppPack -> puiSelectors[uiArg] |=\
+	ExpSLP_laneOf(oExpSLP, uiValue) << (uiLane * uiBits);
+    }
+    else
+      uiSource = NO_PACK;
+  }
+  ppPack -> puiSources[uiArg] = uiSource;
+  if(uiSource != NO_PACK && iSame == 0){
+    ppPack -> psoOperands[uiArg] = (iInPlace != 0) ? SLP_DIRECT : SLP_PERMUTE;
+    uiCost = (iInPlace != 0) ? 0u : 1u;
+    oExpSLP -> uiPermutes += uiCost;
+    oExpSLP -> ppPacks[uiSource].uiPenalty += ppPack -> uiLanes - uiCost;
+    return uiCost;
+  }
+  ppPack -> psoOperands[uiArg] = (iSame != 0) ? SLP_BROADCAST : SLP_GATHER;
+  ppPack -> puiBuilders[uiArg] = ExpSLP_builder(oExpSLP, uiPack, uiArg);
+  if(ppPack -> puiBuilders[uiArg] != uiPack * 2u + uiArg)
+    return 0u;
+  oExpSLP -> uiGathers++;
+  for(uiLane = 0u; uiLane < ppPack -> uiLanes; uiLane++)
+    ExpSLP_store(oExpSLP, ExpSLP_lane(oExpSLP, ppPack, uiArg, uiLane));
+  if(iSame == 0)
+    return ppPack -> uiLanes;
+  return (uiFirst >= ExpSSA_inputs(oExpSSA) &&\
+	  uiFirst < ExpSSA_firstInstruction(oExpSSA)) ? 0u : 1u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Make a pack of oExpSLP of the uiLanes instructions of pcCandidates,  */
+/*if there are at least two                                            */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_pack(ExpSLP_T oExpSLP,\
+			const struct SLPCandidate* pcCandidates,\
+			unsigned int uiLanes){
+  struct SLPPack* ppPack;
+  unsigned int uiLane;
+  if(uiLanes < 2u)
+    return;
+  ppPack = &oExpSLP -> ppPacks[oExpSLP -> uiPacks];
+  ppPack -> esoOp = ExpSSA_instruction(oExpSLP -> oExpSSA,\
+				       pcCandidates[0].uiInstruction) -> esoOp;
+  ppPack -> uiDepth = ExpSSA_instruction(oExpSLP -> oExpSSA,\
+					 pcCandidates[0].uiInstruction) -> uiDepth;
+  ppPack -> uiLanes = uiLanes;
+  for(uiLane = 0u; uiLane < uiLanes; uiLane++){
+    ppPack -> puiMembers[uiLane] = pcCandidates[uiLane].uiInstruction;
+    oExpSLP -> puiPacks[pcCandidates[uiLane].uiInstruction] =\
+      oExpSLP -> uiPacks;
+    oExpSLP -> puiLanes[pcCandidates[uiLane].uiInstruction] = uiLane;
+  }
+  oExpSLP -> uiPacks++;
+}
+
+/*---------------------------------------------------------------------*/
+/*Pack the uiCandidates instructions of pcCandidates, of one operation */
+/*and depth, into packs of oExpSLP, in the order of their operands. A  */
+/*pack is cut short where the next candidate takes its first operand   */
+/*from lane 0 of a pack other than the one the pack does               */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_packAll(ExpSLP_T oExpSLP,\
+			   struct SLPCandidate* pcCandidates,\
+			   unsigned int uiCandidates){
+  unsigned int uiStart = 0u, uiIndex, uiWidth;
+  uiWidth = oExpSLP -> ptTarget -> uiWidth;
+  qsort(pcCandidates, uiCandidates, sizeof(struct SLPCandidate),\
+	ExpSLP_compare);
+  for(uiIndex = 0u; uiIndex < uiCandidates; uiIndex++){
+    if(uiIndex > uiStart && pcCandidates[uiIndex].puiClasses[0] == 0u &&\
+       pcCandidates[uiIndex].puiKeys[0] % EXPSLP_MAX_WIDTH == 0u &&\
+       pcCandidates[uiIndex].puiKeys[0] / EXPSLP_MAX_WIDTH !=\
+       pcCandidates[uiStart].puiKeys[0] / EXPSLP_MAX_WIDTH){
+      ExpSLP_pack(oExpSLP, &pcCandidates[uiStart], uiIndex - uiStart);
+      uiStart = uiIndex;
+    }
+    if(uiIndex + 1u - uiStart == uiWidth){
+      ExpSLP_pack(oExpSLP, &pcCandidates[uiStart], uiWidth);
+      uiStart = uiIndex + 1u;
+    }
+  }
+  ExpSLP_pack(oExpSLP, &pcCandidates[uiStart], uiCandidates - uiStart);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the pack of oExpSLP whose lanes are, in order, outputs        */
+/*uiOutput onward, so they are stored as one vector, or NO_PACK if     */
+/*there is none                                                        */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSLP_outputPack(ExpSLP_T oExpSLP,\
+				      unsigned int uiOutput){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  unsigned int uiPack, uiLane, uiWidth;
+  uiWidth = oExpSLP -> ptTarget -> uiWidth;
+  if(uiOutput + uiWidth > ExpSSA_outputs(oExpSSA))
+    return NO_PACK;
+  uiPack = ExpSLP_packOf(oExpSLP, ExpSSA_output(oExpSSA, uiOutput));
+  if(uiPack == NO_PACK || oExpSLP -> ppPacks[uiPack].uiLanes != uiWidth)
+    return NO_PACK;
+  for(uiLane = 0u; uiLane < uiWidth; uiLane++)
+    if(ExpSSA_output(oExpSSA, uiOutput + uiLane) !=\
+       oExpSLP -> ppPacks[uiPack].puiMembers[uiLane] +\
+       ExpSSA_firstInstruction(oExpSSA))
+      return NO_PACK;
+  return uiPack;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the operation of value uiValue of oExpSLP, or -1 if it is not */
+/*an instruction                                                       */
+/*---------------------------------------------------------------------*/
+static int ExpSLP_kind(ExpSLP_T oExpSLP, unsigned int uiValue){
+  unsigned int uiFirst = ExpSSA_firstInstruction(oExpSLP -> oExpSSA);
+  if(uiValue < uiFirst)
+    return -1;
+  return (int)ExpSSA_instruction(oExpSLP -> oExpSSA, uiValue - uiFirst) ->\
+    esoOp;
+}
+
+/*---------------------------------------------------------------------*/
+/*Pack the values puiValues, one per lane of the target of oExpSLP, if */
+/*they are distinct instructions in no pack, of the same operation     */
+/*other than a power or a fused multiply-add, and at the same depth.   */
+/*The operands of a sum or product in a lane are swapped where that    */
+/*gives its first operand the operation of the first operand in the    */
+/*first lane                                                           */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_packValues(ExpSLP_T oExpSLP, const unsigned int* puiValues){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  const struct ExpSSAInstruction* piFirst;
+  const struct ExpSSAInstruction* piInstruction;
+  struct SLPCandidate pcLanes[EXPSLP_MAX_WIDTH];
+  unsigned int uiLane, uiOther, uiWidth;
+  int iKind;
+  uiWidth = oExpSLP -> ptTarget -> uiWidth;
+  if(ExpSLP_kind(oExpSLP, puiValues[0]) < 0)
+    return;
+  piFirst = ExpSSA_instruction(oExpSSA, puiValues[0] -\
+			       ExpSSA_firstInstruction(oExpSSA));
+  for(uiLane = 0u; uiLane < uiWidth; uiLane++){
+    if(ExpSLP_kind(oExpSLP, puiValues[uiLane]) < 0)
+      return;
+    pcLanes[uiLane].uiInstruction = puiValues[uiLane] -\
+      ExpSSA_firstInstruction(oExpSSA);
+    piInstruction = ExpSSA_instruction(oExpSSA,\
+				       pcLanes[uiLane].uiInstruction);
+    if(oExpSLP -> puiPacks[pcLanes[uiLane].uiInstruction] != NO_PACK ||\
+       piInstruction -> esoOp != piFirst -> esoOp ||\
+       piInstruction -> esoOp == EXPSSA_POWER ||\
+       piInstruction -> uiArgs > 2u ||\
+       piInstruction -> uiDepth != piFirst -> uiDepth)
+      return;
+    for(uiOther = 0u; uiOther < uiLane; uiOther++)
+      if(puiValues[uiOther] == puiValues[uiLane])
+	return;
+  }
+  if(piFirst -> esoOp == EXPSSA_ADD || piFirst -> esoOp == EXPSSA_MULTIPLY){
+    iKind = ExpSLP_kind(oExpSLP, piFirst -> puiArgs[0]);
+    for(uiLane = 1u; uiLane < uiWidth; uiLane++){
+      piInstruction = ExpSSA_instruction(oExpSSA,\
+					 pcLanes[uiLane].uiInstruction);
+      oExpSLP -> piSwapped[pcLanes[uiLane].uiInstruction] =\
+	(ExpSLP_kind(oExpSLP, piInstruction -> puiArgs[0]) != iKind &&\
+	 ExpSLP_kind(oExpSLP, piInstruction -> puiArgs[1]) == iKind);
+    }
+  }
+  ExpSLP_pack(oExpSLP, pcLanes, uiWidth);
+}
+
+/*---------------------------------------------------------------------*/
+/*Pack every run of consecutive outputs of oExpSLP that fills a vector,*/
+/*and then, for every pack made so, the operands in the same place of  */
+/*its lanes, so the packs follow the trees below the outputs with their*/
+/*lanes in line                                                        */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_packTrees(ExpSLP_T oExpSLP){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  unsigned int puiValues[EXPSLP_MAX_WIDTH];
+  unsigned int uiOutput, uiPack, uiLane, uiArg, uiWidth;
+  uiWidth = oExpSLP -> ptTarget -> uiWidth;
+  for(uiOutput = 0u; uiOutput + uiWidth <= ExpSSA_outputs(oExpSSA);\
+      uiOutput += uiWidth){
+    uiPack = oExpSLP -> uiPacks;
+    for(uiLane = 0u; uiLane < uiWidth; uiLane++)
+      puiValues[uiLane] = ExpSSA_output(oExpSSA, uiOutput + uiLane);
+    ExpSLP_packValues(oExpSLP, puiValues);
+    //the packs made from this run are a queue to follow
+    for(; uiPack < oExpSLP -> uiPacks; uiPack++)
+      for(uiArg = 0u; uiArg < ExpSSA_instruction\
+	    (oExpSSA, oExpSLP -> ppPacks[uiPack].puiMembers[0]) -> uiArgs;\
+	  uiArg++){
+	for(uiLane = 0u; uiLane < uiWidth; uiLane++)
+	  puiValues[uiLane] = ExpSLP_lane(oExpSLP, &oExpSLP -> ppPacks[uiPack],\
+					  uiArg, uiLane);
+	ExpSLP_packValues(oExpSLP, puiValues);
+      }
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Compare the SLPPacks pvPack1 and pvPack2 by depth, then by the       */
+/*instruction in their first lane, for qsort                           */
+/*---------------------------------------------------------------------*/
+static int ExpSLP_comparePacks(const void* pvPack1, const void* pvPack2){
+  const struct SLPPack* ppPack1 = (const struct SLPPack*)pvPack1;
+  const struct SLPPack* ppPack2 = (const struct SLPPack*)pvPack2;
+  if(ppPack1 -> uiDepth != ppPack2 -> uiDepth)
+    return (ppPack1 -> uiDepth < ppPack2 -> uiDepth) ? -1 : 1;
+  if(ppPack1 -> puiMembers[0] != ppPack2 -> puiMembers[0])
+    return (ppPack1 -> puiMembers[0] < ppPack2 -> puiMembers[0]) ? -1 : 1;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Sort the packs of oExpSLP by depth, so each is printed after the     */
+/*packs it is built from, and renumber them                            */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_sortPacks(ExpSLP_T oExpSLP){
+  const struct SLPPack* ppPack;
+  unsigned int uiPack, uiLane;
+  qsort(oExpSLP -> ppPacks, oExpSLP -> uiPacks, sizeof(struct SLPPack),\
+	ExpSLP_comparePacks);
+  for(uiPack = 0u; uiPack < oExpSLP -> uiPacks; uiPack++){
+    ppPack = &oExpSLP -> ppPacks[uiPack];
+    for(uiLane = 0u; uiLane < ppPack -> uiLanes; uiLane++)
+      oExpSLP -> puiPacks[ppPack -> puiMembers[uiLane]] = uiPack;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Order the instructions of oExpSLP by depth into puiOrder, and pack   */
+/*those of each depth and operation. Return 0 if successful, 1 if      */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpSLP_packDepths(ExpSLP_T oExpSLP){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  struct SLPCandidate* pcCandidates;
+  unsigned int* puiStarts;
+  unsigned int uiInstructions, uiDepth, uiIndex, uiStart, uiEnd, uiArg;
+  unsigned int uiCandidates;
+  enum ExpSSAOp esoOp;
+  uiInstructions = ExpSSA_instructions(oExpSSA);
+  uiDepth = 0u;
+  for(uiIndex = 0u; uiIndex < uiInstructions; uiIndex++)
+    if(ExpSSA_instruction(oExpSSA, uiIndex) -> uiDepth > uiDepth)
+      uiDepth = ExpSSA_instruction(oExpSSA, uiIndex) -> uiDepth;
+  puiStarts = (unsigned int*)calloc(uiDepth + 2u, sizeof(unsigned int));
+  pcCandidates = (struct SLPCandidate*)malloc((uiInstructions + 1u) *\
+					      sizeof(struct SLPCandidate));
+  if(puiStarts == NULL || pcCandidates == NULL){
+    free(puiStarts);
+    free(pcCandidates);
+    return 1;
+  }
+  //counting sort by depth, which keeps the order within a depth
+  for(uiIndex = 0u; uiIndex < uiInstructions; uiIndex++)
+    puiStarts[ExpSSA_instruction(oExpSSA, uiIndex) -> uiDepth]++;
+  for(uiStart = 0u, uiIndex = 0u; uiIndex <= uiDepth; uiIndex++){
+    uiEnd = puiStarts[uiIndex];
+    puiStarts[uiIndex] = uiStart;
+    uiStart += uiEnd;
+  }
+  puiStarts[uiDepth + 1u] = uiInstructions;
+  for(uiIndex = 0u; uiIndex < uiInstructions; uiIndex++)
+    oExpSLP -> puiOrder[puiStarts[ExpSSA_instruction(oExpSSA, uiIndex) ->\
+				  uiDepth]++] = uiIndex;
+  //puiStarts[d] now holds the end of depth d, the start of depth d+1
+  for(uiStart = 0u, uiIndex = 1u; uiIndex <= uiDepth; uiIndex++){
+    uiEnd = puiStarts[uiIndex];
+    //fused multiply-adds, after the square root, are never packed
+    for(esoOp = EXPSSA_ADD; esoOp <= EXPSSA_SQRT; esoOp++){
+      //there is no vector power
+      if(esoOp == EXPSSA_POWER)
+	continue;
+      uiCandidates = 0u;
+      for(uiArg = uiStart; uiArg < uiEnd; uiArg++)
+	if(oExpSLP -> puiPacks[oExpSLP -> puiOrder[uiArg]] == NO_PACK &&\
+	   ExpSSA_instruction(oExpSSA, oExpSLP -> puiOrder[uiArg]) ->\
+	   esoOp == esoOp)
+	  ExpSLP_candidate(oExpSLP, oExpSLP -> puiOrder[uiArg],\
+			   &pcCandidates[uiCandidates++]);
+      ExpSLP_packAll(oExpSLP, pcCandidates, uiCandidates);
+    }
+    uiStart = uiEnd;
+  }
+  free(puiStarts);
+  free(pcCandidates);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return nonzero if pack uiPack of oExpSLP has not been pruned         */
+/*---------------------------------------------------------------------*/
+static int ExpSLP_isLive(ExpSLP_T oExpSLP, unsigned int uiPack){
+  return oExpSLP -> puiPacks[oExpSLP -> ppPacks[uiPack].puiMembers[0]] ==\
+    uiPack;
+}
+
+/*---------------------------------------------------------------------*/
+/*Decide how every operand of the packs of oExpSLP that have not been  */
+/*pruned is built, and mark the packs whose lanes are read one at a    */
+/*time, by a gather, an instruction in no pack or an output not stored */
+/*as a vector                                                          */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_classify(ExpSLP_T oExpSLP){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  const struct ExpSSAInstruction* piInstruction;
+  struct SLPPack* ppPack;
+  unsigned int uiIndex, uiArg, uiPack;
+  oExpSLP -> uiPermutes = oExpSLP -> uiGathers = 0u;
+  for(uiIndex = 0u; uiIndex <= oExpSLP -> uiMask; uiIndex++)
+    oExpSLP -> puiBuilders[uiIndex] = NO_PACK;
+  for(uiPack = 0u; uiPack < oExpSLP -> uiPacks; uiPack++){
+    oExpSLP -> ppPacks[uiPack].iStored = 0;
+    oExpSLP -> ppPacks[uiPack].uiCost = oExpSLP -> ppPacks[uiPack].uiPenalty\
+      = 0u;
+  }
+  for(uiPack = 0u; uiPack < oExpSLP -> uiPacks; uiPack++){
+    if(ExpSLP_isLive(oExpSLP, uiPack) == 0)
+      continue;
+    ppPack = &oExpSLP -> ppPacks[uiPack];
+    for(uiArg = 0u; uiArg < ExpSSA_instruction\
+	  (oExpSSA, ppPack -> puiMembers[0]) -> uiArgs; uiArg++)
+      ppPack -> uiCost += ExpSLP_operand(oExpSLP, uiPack, uiArg);
+  }
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++){
+    if(oExpSLP -> puiPacks[uiIndex] != NO_PACK)
+      continue;
+    piInstruction = ExpSSA_instruction(oExpSSA, uiIndex);
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++)
+      ExpSLP_store(oExpSLP, piInstruction -> puiArgs[uiArg]);
+  }
+  for(uiIndex = 0u; uiIndex < ExpSSA_outputs(oExpSSA); uiIndex++){
+    uiPack = ExpSLP_outputPack(oExpSLP, uiIndex);
+    if(uiPack == NO_PACK){
+      ExpSLP_store(oExpSLP, ExpSSA_output(oExpSSA, uiIndex));
+      continue;
+    }
+    //without the pack, its lanes would be stored one at a time
+    oExpSLP -> ppPacks[uiPack].uiPenalty += oExpSLP -> ptTarget -> uiWidth -\
+      1u;
+    uiIndex += oExpSLP -> ptTarget -> uiWidth - 1u;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the instructions pack uiPack of oExpSLP saves over evaluating */
+/*its lanes one at a time, which may be none or fewer: its lanes but   */
+/*one, and whatever the packs and stores of outputs built from it as a */
+/*vector and the earlier packs it is built from would cost without it, */
+/*less the instructions building its operands and storing its lanes    */
+/*---------------------------------------------------------------------*/
+static long ExpSLP_saving(ExpSLP_T oExpSLP, unsigned int uiPack){
+  const struct SLPPack* ppPack = &oExpSLP -> ppPacks[uiPack];
+  unsigned int uiArg, uiArgs, puiSources[2];
+  long lSaving;
+  lSaving = (long)ppPack -> uiLanes + (long)ppPack -> uiPenalty -\
+    (1l + (long)ppPack -> uiCost + (long)ppPack -> iStored);
+  uiArgs = ExpSSA_instruction(oExpSLP -> oExpSSA,\
+			      ppPack -> puiMembers[0]) -> uiArgs;
+  //lanes its instructions would read one at a time must be stored
+  for(uiArg = 0u; uiArg < uiArgs; uiArg++){
+    puiSources[uiArg] = ppPack -> puiSources[uiArg];
+    if(ppPack -> psoOperands[uiArg] == SLP_BROADCAST ||\
+       ppPack -> psoOperands[uiArg] == SLP_GATHER ||\
+       oExpSLP -> ppPacks[puiSources[uiArg]].iStored != 0)
+      puiSources[uiArg] = NO_PACK;
+    if(puiSources[uiArg] != NO_PACK &&\
+       (uiArg == 0u || puiSources[0] != puiSources[1]))
+      lSaving--;
+  }
+  return lSaving;
+}
+
+/*---------------------------------------------------------------------*/
+/*Prune every pack of oExpSLP that saves no instructions, until every  */
+/*pack left does, then number the packs left in order. Pruning a pack  */
+/*only adds to what the others cost, as their operands built from it   */
+/*must be gathered and the earlier packs it is built from stored, so   */
+/*whatever is pruned in a pass would be pruned one at a time too       */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_prune(ExpSLP_T oExpSLP){
+  struct SLPPack* ppPack;
+  unsigned int uiPack, uiLane, uiLive;
+  int iPruned;
+  do{
+    ExpSLP_classify(oExpSLP);
+    iPruned = 0;
+    for(uiPack = 0u; uiPack < oExpSLP -> uiPacks; uiPack++){
+      if(ExpSLP_isLive(oExpSLP, uiPack) == 0 ||\
+	 ExpSLP_saving(oExpSLP, uiPack) > 0l)
+	continue;
+      ppPack = &oExpSLP -> ppPacks[uiPack];
+      for(uiLane = 0u; uiLane < ppPack -> uiLanes; uiLane++)
+	oExpSLP -> puiPacks[ppPack -> puiMembers[uiLane]] = NO_PACK;
+      iPruned = 1;
+    }
+  } while(iPruned != 0);
+  uiLive = oExpSLP -> uiPacked = 0u;
+  for(uiPack = 0u; uiPack < oExpSLP -> uiPacks; uiPack++){
+    if(ExpSLP_isLive(oExpSLP, uiPack) == 0)
+      continue;
+    ppPack = &oExpSLP -> ppPacks[uiLive];
+    *ppPack = oExpSLP -> ppPacks[uiPack];
+    for(uiLane = 0u; uiLane < ppPack -> uiLanes; uiLane++)
+      oExpSLP -> puiPacks[ppPack -> puiMembers[uiLane]] = uiLive;
+    oExpSLP -> uiPacked += ppPack -> uiLanes;
+    uiLive++;
+  }
+  oExpSLP -> uiPacks = uiLive;
+  ExpSLP_classify(oExpSLP);
+}
+
+/*---------------------------------------------------------------------*/
+/*Pack the instructions of oExpSSA                                     */
+/*---------------------------------------------------------------------*/
+ExpSLP_T ExpSLP_new(ExpSSA_T oExpSSA, unsigned int uiWidth){
+  ExpSLP_T oExpSLP;
+  unsigned int uiInstructions, uiIndex;
+  assert(oExpSSA != NULL);
+  oExpSLP = (ExpSLP_T)malloc(sizeof(struct ExpSLP));
+  if(oExpSLP == NULL)
+    return NULL;
+  uiInstructions = ExpSSA_instructions(oExpSSA);
+  oExpSLP -> oExpSSA = oExpSSA;
+  oExpSLP -> ptTarget = &ptTargets[0];
+  for(uiIndex = 0u; uiIndex < TARGETS; uiIndex++)
+    if(ptTargets[uiIndex].uiWidth == uiWidth)
+      oExpSLP -> ptTarget = &ptTargets[uiIndex];
+  assert(oExpSLP -> ptTarget -> uiWidth == uiWidth);
+  oExpSLP -> puiPacks = (unsigned int*)malloc((uiInstructions + 1u) *\
+					      sizeof(unsigned int));
+  oExpSLP -> puiLanes = (unsigned int*)calloc(uiInstructions + 1u,\
+					      sizeof(unsigned int));
+  oExpSLP -> piSwapped = (int*)calloc(uiInstructions + 1u, sizeof(int));
+  oExpSLP -> puiOrder = (unsigned int*)malloc((uiInstructions + 1u) *\
+					      sizeof(unsigned int));
+  //every pack holds at least two instructions
+  oExpSLP -> ppPacks = (struct SLPPack*)malloc((uiInstructions / 2u + 1u) *\
+					       sizeof(struct SLPPack));
+  //the table is at most half full with two operands per pack
+  oExpSLP -> uiMask = 1u;
+  while(oExpSLP -> uiMask < 2u * uiInstructions + 4u)
+    oExpSLP -> uiMask *= 2u;
+  oExpSLP -> puiBuilders = (unsigned int*)malloc(oExpSLP -> uiMask *\
+						 sizeof(unsigned int));
+  oExpSLP -> uiMask--;
+  oExpSLP -> uiPacks = oExpSLP -> uiPacked = 0u;
+  oExpSLP -> uiPermutes = oExpSLP -> uiGathers = 0u;
+  if(oExpSLP -> puiPacks == NULL || oExpSLP -> puiLanes == NULL ||\
+     oExpSLP -> piSwapped == NULL || oExpSLP -> puiOrder == NULL ||\
+     oExpSLP -> ppPacks == NULL || oExpSLP -> puiBuilders == NULL){
+    ExpSLP_free(oExpSLP);
+    return NULL;
+  }
+  for(uiIndex = 0u; uiIndex < uiInstructions; uiIndex++)
+    oExpSLP -> puiPacks[uiIndex] = NO_PACK;
+  ExpSLP_packTrees(oExpSLP);
+  if(ExpSLP_packDepths(oExpSLP) != 0){
+    ExpSLP_free(oExpSLP);
+    return NULL;
+  }
+  ExpSLP_sortPacks(oExpSLP);
+  ExpSLP_prune(oExpSLP);
+  return oExpSLP;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpSLP                                                         */
+/*---------------------------------------------------------------------*/
+void ExpSLP_free(ExpSLP_T oExpSLP){
+  if(oExpSLP == NULL)
+    return;
+  free(oExpSLP -> puiPacks);
+  free(oExpSLP -> puiLanes);
+  free(oExpSLP -> piSwapped);
+  free(oExpSLP -> puiOrder);
+  free(oExpSLP -> ppPacks);
+  free(oExpSLP -> puiBuilders);
+  free(oExpSLP);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the counts of oExpSLP                                          */
+/*---------------------------------------------------------------------*/
+void ExpSLP_counts(ExpSLP_T oExpSLP, unsigned int* puiPacked,\
+		   unsigned int* puiPacks, unsigned int* puiPermutes,\
+		   unsigned int* puiGathers){
+  assert(oExpSLP != NULL);
+  *puiPacked = oExpSLP -> uiPacked;
+  *puiPacks = oExpSLP -> uiPacks;
+  *puiPermutes = oExpSLP -> uiPermutes;
+  *puiGathers = oExpSLP -> uiGathers;
+}
+
+/*---------------------------------------------------------------------*/
+/*Print value uiValue of oExpSLP as a double of the generated function,*/
+/*with its inputs at puiIndexes: an input read from in, a constant as a*/
+/*literal, and an instruction as its lane of the array its pack is     */
+/*stored to if iPacked and it is in a pack, or else as its local       */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printValue(ExpSLP_T oExpSLP,\
+			      const unsigned int* puiIndexes,\
+			      unsigned int uiValue, int iPacked){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  unsigned int uiPack = ExpSLP_packOf(oExpSLP, uiValue);
+  if(uiValue < ExpSSA_inputs(oExpSSA)){
+    ExpOut_string("in[");
+    ExpOut_unsigned(puiIndexes[uiValue]);
+    ExpOut_char(']');
+  }
+  else if(uiValue < ExpSSA_firstInstruction(oExpSSA))
+    ExpCGen_printLiteral(ExpSSA_constantValue\
+			 (oExpSSA, uiValue - ExpSSA_inputs(oExpSSA)));
+  else if(iPacked != 0 && uiPack != NO_PACK){
+    ExpOut_char('a');
+    ExpOut_unsigned(uiPack);
+    ExpOut_char('[');
+    ExpOut_unsigned(ExpSLP_laneOf(oExpSLP, uiValue));
+    ExpOut_char(']');
+  }
+  else{
+    ExpOut_char('t');
+    ExpOut_unsigned(uiValue - ExpSSA_firstInstruction(oExpSSA));
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Print instruction uiInstruction of oExpSLP as a local of the         */
+/*generated function, with its inputs at puiIndexes and its operands   */
+/*read as by ExpSLP_printValue                                         */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printInstruction(ExpSLP_T oExpSLP,\
+				    const unsigned int* puiIndexes,\
+				    unsigned int uiInstruction, int iPacked){
+  const struct ExpSSAInstruction* piInstruction;
+  const char* pcOperator = NULL;
+  piInstruction = ExpSSA_instruction(oExpSLP -> oExpSSA, uiInstruction);
+  ExpOut_string("  const double t");
+  ExpOut_unsigned(uiInstruction);
+  ExpOut_string(" = ");
+  switch(piInstruction -> esoOp)
+    {
+    case EXPSSA_ADD:
+      pcOperator = " + ";
+      break;
+    case EXPSSA_SUBTRACT:
+      pcOperator = " - ";
+      break;
+    case EXPSSA_MULTIPLY:
+      pcOperator = " * ";
+      break;
+    case EXPSSA_DIVIDE:
+      pcOperator = " / ";
+      break;
+    case EXPSSA_POWER:
+      pcOperator = ", ";
+      ExpOut_string("pow(");
+      break;
+    case EXPSSA_NEGATIVE:
+      ExpOut_char('-');
+      break;
+    case EXPSSA_RECIPROCAL:
+      ExpOut_string("1.0 / ");
+      break;
+    case EXPSSA_SQRT:
+      ExpOut_string("sqrt(");
+      break;
+    case EXPSSA_FMA:
+    case EXPSSA_FMS:
+    case EXPSSA_FNMA:
+    case EXPSSA_FNMS:
+      ExpOut_string(piInstruction -> esoOp == EXPSSA_FNMA ||\
+		    piInstruction -> esoOp == EXPSSA_FNMS ? "fma(-" : "fma(");
+      pcOperator = ", ";
+      break;
+    }
+  ExpSLP_printValue(oExpSLP, puiIndexes, piInstruction -> puiArgs[0],\
+		    iPacked);
+  if(pcOperator != NULL){
+    ExpOut_string(pcOperator);
+    ExpSLP_printValue(oExpSLP, puiIndexes, piInstruction -> puiArgs[1],\
+		      iPacked);
+  }
+  if(piInstruction -> uiArgs > 2u){
+    ExpOut_string(piInstruction -> esoOp == EXPSSA_FMS ||\
+		  piInstruction -> esoOp == EXPSSA_FNMS ? ", -" : ", ");
+    ExpSLP_printValue(oExpSLP, puiIndexes, piInstruction -> puiArgs[2],\
+		      iPacked);
+  }
+  if(piInstruction -> esoOp == EXPSSA_POWER ||\
+     piInstruction -> esoOp == EXPSSA_SQRT || piInstruction -> uiArgs > 2u)
+    ExpOut_char(')');
+  ExpOut_string(";\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the intrinsic of the target of oExpSLP named pcOperation, ex.  */
+/*_mm256_add_pd for add                                                */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printIntrinsic(ExpSLP_T oExpSLP, const char* pcOperation){
+  ExpOut_string(oExpSLP -> ptTarget -> pcPrefix);
+  ExpOut_char('_');
+  ExpOut_string(pcOperation);
+  ExpOut_string("_pd(");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print operand uiArg of the pack ppPack of oExpSLP as a vector: the   */
+/*pack it is, a permute of it, or the local of the operand that builds */
+/*it                                                                   */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printOperand(ExpSLP_T oExpSLP,\
+				const struct SLPPack* ppPack,\
+				unsigned int uiArg){
+  unsigned int uiSource = ppPack -> puiSources[uiArg];
+  switch(ppPack -> psoOperands[uiArg])
+    {
+    case SLP_DIRECT:
+      ExpOut_char('v');
+      ExpOut_unsigned(uiSource);
+      return;
+    case SLP_PERMUTE:
+      //a permute across the halves of a 256 bit vector needs AVX2
+      ExpSLP_printIntrinsic(oExpSLP, (oExpSLP -> ptTarget -> uiWidth > 2u) ?\
+			    "permute4x64" : "shuffle");
+      ExpOut_char('v');
+      ExpOut_unsigned(uiSource);
+      if(oExpSLP -> ptTarget -> uiWidth == 2u){
+	ExpOut_string(", v");
+	ExpOut_unsigned(uiSource);
+      }
+      ExpOut_string(", ");
+      ExpOut_unsigned(ppPack -> puiSelectors[uiArg]);
+      break;
+    case SLP_BROADCAST:
+    case SLP_GATHER:
+      ExpOut_char('g');
+      ExpOut_unsigned(ppPack -> puiBuilders[uiArg] / 2u);
+      ExpOut_char('_');
+      ExpOut_unsigned(ppPack -> puiBuilders[uiArg] % 2u);
+      return;
+    }
+  ExpOut_char(')');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the vector local operand uiArg of pack uiPack of oExpSLP       */
+/*builds, with its inputs at puiIndexes, if it is gathered or broadcast*/
+/*and no operand before it builds the same vector                      */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printBuilder(ExpSLP_T oExpSLP,\
+				const unsigned int* puiIndexes,\
+				unsigned int uiPack, unsigned int uiArg){
+  const struct SLPPack* ppPack = &oExpSLP -> ppPacks[uiPack];
+  unsigned int uiLane;
+  if((ppPack -> psoOperands[uiArg] != SLP_BROADCAST &&\
+      ppPack -> psoOperands[uiArg] != SLP_GATHER) ||\
+     ppPack -> puiBuilders[uiArg] != uiPack * 2u + uiArg)
+    return;
+  ExpOut_string("  const ");
+  ExpOut_string(oExpSLP -> ptTarget -> pcVector);
+  ExpOut_string(" g");
+  ExpOut_unsigned(uiPack);
+  ExpOut_char('_');
+  ExpOut_unsigned(uiArg);
+  ExpOut_string(" = ");
+  if(ppPack -> psoOperands[uiArg] == SLP_BROADCAST){
+    ExpSLP_printIntrinsic(oExpSLP, "set1");
+    ExpSLP_printValue(oExpSLP, puiIndexes,\
+		      ExpSLP_lane(oExpSLP, ppPack, uiArg, 0u), 1);
+  }
+  else{
+    ExpSLP_printIntrinsic(oExpSLP, "setr");
+    for(uiLane = 0u; uiLane < oExpSLP -> ptTarget -> uiWidth; uiLane++){
+      if(uiLane > 0u)
+	ExpOut_string(", ");
+      ExpSLP_printValue(oExpSLP, puiIndexes,\
+			ExpSLP_lane(oExpSLP, ppPack, uiArg, uiLane), 1);
+    }
+  }
+  ExpOut_string(");\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print pack uiPack of oExpSLP as a vector local of the generated      */
+/*function, with its inputs at puiIndexes, followed by the array it is */
+/*stored to if its lanes are read one at a time                        */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printPack(ExpSLP_T oExpSLP,\
+			     const unsigned int* puiIndexes,\
+			     unsigned int uiPack){
+  const struct SLPPack* ppPack = &oExpSLP -> ppPacks[uiPack];
+  const char* pcOperation = NULL;
+  switch(ppPack -> esoOp)
+    {
+    case EXPSSA_ADD:
+      pcOperation = "add";
+      break;
+    case EXPSSA_SUBTRACT:
+      pcOperation = "sub";
+      break;
+    case EXPSSA_MULTIPLY:
+    case EXPSSA_NEGATIVE:
+      pcOperation = "mul";
+      break;
+    case EXPSSA_DIVIDE:
+    case EXPSSA_RECIPROCAL:
+      pcOperation = "div";
+      break;
+    case EXPSSA_POWER:
+    case EXPSSA_FMA:
+    case EXPSSA_FMS:
+    case EXPSSA_FNMA:
+    case EXPSSA_FNMS:
+      //never packed
+      break;
+    case EXPSSA_SQRT:
+      pcOperation = "sqrt";
+      break;
+    }
+  assert(pcOperation != NULL);
+  ExpSLP_printBuilder(oExpSLP, puiIndexes, uiPack, 0u);
+  if(ExpSSA_instruction(oExpSLP -> oExpSSA,\
+			ppPack -> puiMembers[0]) -> uiArgs > 1u)
+    ExpSLP_printBuilder(oExpSLP, puiIndexes, uiPack, 1u);
+  ExpOut_string("  const ");
+  ExpOut_string(oExpSLP -> ptTarget -> pcVector);
+  ExpOut_string(" v");
+  ExpOut_unsigned(uiPack);
+  ExpOut_string(" = ");
+  ExpSLP_printIntrinsic(oExpSLP, pcOperation);
+  //a reciprocal is 1 divided by its operand, a negation it times -1
+  if(ppPack -> esoOp == EXPSSA_RECIPROCAL){
+    ExpSLP_printIntrinsic(oExpSLP, "set1");
+    ExpOut_string("1.0), ");
+  }
+  ExpSLP_printOperand(oExpSLP, ppPack, 0u);
+  if(ppPack -> esoOp == EXPSSA_NEGATIVE){
+    ExpOut_string(", ");
+    ExpSLP_printIntrinsic(oExpSLP, "set1");
+    ExpOut_string("-1.0)");
+  }
+  else if(ExpSSA_instruction(oExpSLP -> oExpSSA,\
+			     ppPack -> puiMembers[0]) -> uiArgs > 1u){
+    ExpOut_string(", ");
+    ExpSLP_printOperand(oExpSLP, ppPack, 1u);
+  }
+  ExpOut_string(");\n");
+  if(ppPack -> iStored == 0)
+    return;
+  ExpOut_string("  double a");
+  ExpOut_unsigned(uiPack);
+  ExpOut_char('[');
+  ExpOut_unsigned(oExpSLP -> ptTarget -> uiWidth);
+  ExpOut_string("];\n  ");
+  ExpSLP_printIntrinsic(oExpSLP, "storeu");
+  ExpOut_char('a');
+  ExpOut_unsigned(uiPack);
+  ExpOut_string(", v");
+  ExpOut_unsigned(uiPack);
+  ExpOut_string(");\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the definition of the generated function of oExpSLP named      */
+/*pcFunction, with its inputs at puiIndexes, with its packs as vectors */
+/*if iPacked or else in plain C. A function with a pcSuffix is a static*/
+/*version of it, named pcFunction_pcSuffix                             */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printFunction(ExpSLP_T oExpSLP, const char* pcFunction,\
+				 const char* pcSuffix,\
+				 const unsigned int* puiIndexes, int iPacked){
+  ExpSSA_T oExpSSA = oExpSLP -> oExpSSA;
+  unsigned int uiIndex, uiInstruction, uiPack, uiNext = 0u;
+  if(iPacked != 0){
+    ExpOut_string("__attribute__((target(\"");
+    ExpOut_string(oExpSLP -> ptTarget -> pcExtension);
+    ExpOut_string("\")))\n");
+  }
+  ExpOut_string((pcSuffix != NULL) ? "static void " : "void ");
+  ExpOut_string(pcFunction);
+  if(pcSuffix != NULL){
+    ExpOut_char('_');
+    ExpOut_string(pcSuffix);
+  }
+  ExpOut_string("(const double* restrict in, double* restrict out){\n");
+  //the packs of a depth, in order, come before the rest of it, and
+  //every operand is at a lower depth, so is printed before it
+  for(uiIndex = 0u; uiIndex < ExpSSA_instructions(oExpSSA); uiIndex++){
+    uiInstruction = (iPacked != 0) ? oExpSLP -> puiOrder[uiIndex] : uiIndex;
+    for(; iPacked != 0 && uiNext < oExpSLP -> uiPacks &&\
+	  ExpSSA_instruction(oExpSSA, oExpSLP -> ppPacks[uiNext].puiMembers[0])\
+	  -> uiDepth <= ExpSSA_instruction(oExpSSA, uiInstruction) -> uiDepth;\
+	uiNext++)
+      ExpSLP_printPack(oExpSLP, puiIndexes, uiNext);
+    if(iPacked == 0 || oExpSLP -> puiPacks[uiInstruction] == NO_PACK)
+      ExpSLP_printInstruction(oExpSLP, puiIndexes, uiInstruction, iPacked);
+  }
+  for(uiIndex = 0u; uiIndex < ExpSSA_outputs(oExpSSA); uiIndex++){
+    uiPack = (iPacked != 0) ? ExpSLP_outputPack(oExpSLP, uiIndex) : NO_PACK;
+    if(uiPack != NO_PACK){
+      ExpOut_string("  ");
+      ExpSLP_printIntrinsic(oExpSLP, "storeu");
+      ExpOut_string("out + ");
+      ExpOut_unsigned(uiIndex);
+      ExpOut_string(", v");
+      ExpOut_unsigned(uiPack);
+      ExpOut_string(");\n");
+      uiIndex += oExpSLP -> ptTarget -> uiWidth - 1u;
+      continue;
+    }
+    ExpOut_string("  out[");
+    ExpOut_unsigned(uiIndex);
+    ExpOut_string("] = ");
+    ExpSLP_printValue(oExpSLP, puiIndexes, ExpSSA_output(oExpSSA, uiIndex),\
+		      iPacked);
+    ExpOut_string(";\n");
+  }
+  ExpOut_string("}\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the function of oExpSLP named pcFunction, which calls the      */
+/*vector version if the host supports its extension and the plain C    */
+/*version otherwise, choosing once                                     */
+/*---------------------------------------------------------------------*/
+static void ExpSLP_printDispatch(ExpSLP_T oExpSLP, const char* pcFunction){
+  const char* pcExtension = oExpSLP -> ptTarget -> pcExtension;
+  ExpOut_string("typedef void (*");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_version)(const double* restrict,\n"\
+		"    double* restrict);\n\nstatic ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_version ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_select(void){\n" X86_CONDITION\
+		"  __builtin_cpu_init();\n  if(__builtin_cpu_supports(\"");
+  ExpOut_string(pcExtension);
+  ExpOut_string("\"))\n    return ");
+  ExpOut_string(pcFunction);
+  ExpOut_char('_');
+  ExpOut_string(pcExtension);
+  ExpOut_string(";\n#endif\n  return ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_scalar;\n}\n\nvoid ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("(const double* restrict in, double* restrict out){\n"\
+		"  static ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_version version = NULL;\n"\
+		"  if(version == NULL)\n    version = ");
+  ExpOut_string(pcFunction);
+  ExpOut_string("_select();\n  version(in, out);\n}\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Print the function of oExpSLP, after a comment describing it and the */
+/*index every input is read from. If any operations are packed, a      */
+/*vector version, compiled only with GNU C extensions on x86, and a    */
+/*plain C version are printed, and the function calls the one the host*/
+/*supports; otherwise the function is printed in plain C alone         */
+/*---------------------------------------------------------------------*/
+int ExpSLP_print(ExpSLP_T oExpSLP, ExpCGen_T oExpCGen){
+  ExpSSA_T oExpSSA;
+  const char* pcFunction;
+  unsigned int* puiIndexes;
+  unsigned int uiInput;
+  int iStatus;
+  assert(oExpSLP != NULL);
+  assert(oExpCGen != NULL);
+  oExpSSA = oExpSLP -> oExpSSA;
+  puiIndexes = (unsigned int*)malloc((ExpSSA_inputs(oExpSSA) + 1u) *\
+				     sizeof(unsigned int));
+  if(puiIndexes == NULL)
+    return 1;
+  iStatus = ExpCGen_indexes(oExpCGen, oExpSSA, puiIndexes);
+  if(iStatus != 0){
+    free(puiIndexes);
+    return iStatus;
+  }
+  ExpOut_string("/*\n * Generated by expparser: ");
+  ExpOut_unsigned(ExpSSA_inputs(oExpSSA));
+  ExpOut_string(" inputs, ");
+  ExpOut_unsigned(ExpSSA_instructions(oExpSSA));
+  ExpOut_string(" operations, ");
+  ExpOut_unsigned(ExpSSA_outputs(oExpSSA));
+  ExpOut_string(" outputs,\n * ");
+  ExpOut_unsigned(oExpSLP -> uiPacked);
+  ExpOut_string(" operations packed into ");
+  ExpOut_unsigned(oExpSLP -> uiPacks);
+  ExpOut_char(' ');
+  ExpOut_string(oExpSLP -> ptTarget -> pcExtension);
+  ExpOut_string(" vectors.\n * out[i] is expression i, and the operands "\
+		"are read from\n *\n");
+  for(uiInput = 0u; uiInput < ExpSSA_inputs(oExpSSA); uiInput++){
+    ExpOut_string(" *   ");
+    ExpOut_string(ExpSSA_inputName(oExpSSA, uiInput));
+    ExpOut_string("  ");
+    ExpSLP_printValue(oExpSLP, puiIndexes, uiInput, 0);
+    ExpOut_char('\n');
+  }
+  ExpOut_string(" */\n#include <math.h>\n");
+  pcFunction = ExpCGen_function(oExpCGen);
+  if(oExpSLP -> uiPacked == 0u){
+    ExpOut_char('\n');
+    ExpSLP_printFunction(oExpSLP, pcFunction, NULL, puiIndexes, 0);
+    free(puiIndexes);
+    return 0;
+  }
+  ExpOut_string("#include <stddef.h>\n" X86_CONDITION\
+		"#include <immintrin.h>\n\n");
+  ExpSLP_printFunction(oExpSLP, pcFunction, oExpSLP -> ptTarget ->\
+		       pcExtension, puiIndexes, 1);
+  ExpOut_string("#endif\n\n");
+  ExpSLP_printFunction(oExpSLP, pcFunction, "scalar", puiIndexes, 0);
+  ExpOut_char('\n');
+  ExpSLP_printDispatch(oExpSLP, pcFunction);
+  free(puiIndexes);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expslp.c                                                        */
+/*---------------------------------------------------------------------*/
+/*
+#include "exptokentree.h"
+#include "exptoken.h"
+
+int main(void){
+  ExpProgram_T oExpProgram;
+  ExpSSA_T oExpSSA;
+  ExpSLP_T oExpSLP;
+  ExpCGen_T oExpCGen;
+  LinkList_T pllTrees;
+  unsigned int uiPacked, uiPacks, uiPermutes, uiGathers;
+
+  //#0 = a*a, #1 = b*b, #2 = #0*#0, #3 = #1*#1, outputs #2 and #3
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("a"),\
+				      ExpTokenTree_newLeaf("a")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("b"),\
+				      ExpTokenTree_newLeaf("b")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("#0")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("#1"),\
+				      ExpTokenTree_newLeaf("#1")));
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf("#2"));
+  LinkList_setNext(pllTrees, LinkList_new());
+  LinkList_setValue(LinkList_getNext(pllTrees), ExpTokenTree_newLeaf("#3"));
+  oExpSSA = ExpSSA_new(oExpProgram, pllTrees);
+  oExpSLP = ExpSLP_new(oExpSSA, 2u);
+  oExpCGen = ExpCGen_new();
+  if(oExpSSA == NULL || oExpSLP == NULL || oExpCGen == NULL)
+    printf("failed test 1\n");
+  //the first pack gathers a and b once for both operands, and the
+  //second takes it as it is and is stored to out as a vector
+  ExpSLP_counts(oExpSLP, &uiPacked, &uiPacks, &uiPermutes, &uiGathers);
+  if(uiPacked != 4u || uiPacks != 2u || uiPermutes != 0u ||\
+     uiGathers != 1u)
+    printf("failed test 2\n");
+  if(ExpSLP_print(oExpSLP, oExpCGen) != 0)
+    printf("failed test 3\n");
+  ExpCGen_setStruct(oExpCGen, "Point");
+  if(ExpSLP_print(oExpSLP, oExpCGen) != -1)
+    printf("failed test 4\n");
+  ExpOut_flush();
+  ExpCGen_free(oExpCGen);
+  ExpSLP_free(oExpSLP);
+  ExpSSA_free(oExpSSA);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(LinkList_getNext(pllTrees)));
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(LinkList_getNext(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
@@ -0,0 +1,76 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expslp.h describes a superword level parallelism pass over the static*/
+/*single assignment form of a program. Independent instructions of the */
+/*same operation are packed into the lanes of one vector instruction,  */
+/*so a single evaluation of the program takes fewer instructions, and  */
+/*the result is written as a C function built on x86 vector intrinsics */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPSLP_INCLUDED
+#define EXPSLP_INCLUDED
+
+#include "expcgen.h"
+#include "expssa.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the most lanes of a vector, and the default, the lanes of an  */
+/*AVX2 vector of doubles                                               */
+/*---------------------------------------------------------------------*/
+#define EXPSLP_MAX_WIDTH 4u
+#define EXPSLP_WIDTH 4u
+
+/*---------------------------------------------------------------------*/
+/*An ExpSLP is a program in static single assignment form with its     */
+/*instructions packed into vectors. Every instruction is in at most one*/
+/*pack, and the instructions of a pack are of the same operation and at*/
+/*the same depth, so none uses another                                 */
+/*---------------------------------------------------------------------*/
+typedef struct ExpSLP* ExpSLP_T;
+
+/*---------------------------------------------------------------------*/
+/*Pack the instructions of oExpSSA into vectors of uiWidth lanes, 2 for*/
+/*SSE2 or 4 for AVX2, and return the result, or NULL if memory is      */
+/*insufficient. The ExpSLP refers to oExpSSA, which must outlive it.   */
+/*Runs of outputs are packed first, then the operands they use, then   */
+/*what is left of each depth, with the instructions of an operation    */
+/*ordered by the lanes of their operands, so a pack whose operands are */
+/*the lanes of an earlier pack, in order, takes that pack as it is. A  */
+/*pack that saves no instructions once its operand vectors are built is*/
+/*left as scalars. Powers, which have no vector instruction, and fused */
+/*multiply-adds, which need an extension SSE2 and AVX2 do not imply,   */
+/*are never packed                                                     */
+/*---------------------------------------------------------------------*/
+ExpSLP_T ExpSLP_new(ExpSSA_T oExpSSA, unsigned int uiWidth);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpSLP                                  */
+/*---------------------------------------------------------------------*/
+void ExpSLP_free(ExpSLP_T oExpSLP);
+
+/*---------------------------------------------------------------------*/
+/*Store in *puiPacked the number of instructions of oExpSLP in a pack, */
+/*in *puiPacks the number of packs, in *puiPermutes the number of      */
+/*operands of packs that are an earlier pack with its lanes reordered, */
+/*and in *puiGathers the number assembled lane by lane or broadcast    */
+/*from one value                                                       */
+/*---------------------------------------------------------------------*/
+void ExpSLP_counts(ExpSLP_T oExpSLP, unsigned int* puiPacked,\
+		   unsigned int* puiPacks, unsigned int* puiPermutes,\
+		   unsigned int* puiGathers);
+
+/*---------------------------------------------------------------------*/
+/*Print to stdout a C function computing the program of oExpSLP for one*/
+/*instance, named and with its inputs read from the indexes of an array*/
+/*given by oExpCGen, as for ExpCGen_print. Every pack is one vector    */
+/*instruction on SSE2 or AVX2 intrinsics, according to the width, in a */
+/*version compiled for that extension whatever the compiler flags; the */
+/*function calls it on hosts that support the extension and a plain C  */
+/*version elsewhere. If nothing is packed, only the plain C function is*/
+/*printed. Return 0 if successful, 1 if memory is insufficient, -1 if  */
+/*oExpCGen reads the inputs from a struct or maps one to something     */
+/*other than an index, in which case nothing is printed                */
+/*---------------------------------------------------------------------*/
+int ExpSLP_print(ExpSLP_T oExpSLP, ExpCGen_T oExpCGen);
+
+#endif
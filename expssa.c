@@ -0,0 +1,821 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expssa.c implements expssa.h. The statements are flattened in order, */
+/*each operation becoming one instruction, so the instructions of a    */
+/*temporary are all numbered before any that use it. While flattening, */
+/*a value is referred to by its kind and its index among its kind,     */
+/*since the number of inputs and constants, which come first, is only  */
+/*known at the end                                                     */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expssa.h"
+#include "exprational.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+#include "expout.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of the lists of an ExpSSA                */
+/*---------------------------------------------------------------------*/
+#define INITIAL_NAMES 16u
+#define INITIAL_INSTRUCTIONS 64u
+
+/*---------------------------------------------------------------------*/
+/*Define the kinds of value a reference made while flattening may name.*/
+/*A reference is the index of the value among its kind, shifted left by*/
+/*2, or'ed with the kind                                               */
+/*---------------------------------------------------------------------*/
+#define REF_INPUT 0u
+#define REF_CONSTANT 1u
+#define REF_INSTRUCTION 2u
+
+/*---------------------------------------------------------------------*/
+/*Define the operand written for a unary instruction's missing second  */
+/*operand in the binary encoding                                       */
+/*---------------------------------------------------------------------*/
+#define NO_ARG 0xFFFFFFFFul
+
+/*---------------------------------------------------------------------*/
+/*An SSANames is a list of distinct names with a hash table over them, */
+/*holding the index of each name plus one, or 0 in an empty slot       */
+/*---------------------------------------------------------------------*/
+struct SSANames
+{
+  char** ppcNames;
+  unsigned int uiLength;
+  unsigned int uiMax;
+  unsigned int* puiSlots;
+  /*number of slots, a power of two*/
+  unsigned int uiSlots;
+};
+
+/*---------------------------------------------------------------------*/
+/*An ExpSSA holds its inputs, constants, instructions and outputs      */
+/*---------------------------------------------------------------------*/
+struct ExpSSA
+{
+  struct SSANames nInputs;
+  /*the literals of the constants, and their values*/
+  struct SSANames nConstants;
+  double* pdConstants;
+  struct ExpSSAInstruction* piInstructions;
+  unsigned int uiInstructions;
+  unsigned int uiMaxInstructions;
+  unsigned int* puiOutputs;
+  unsigned int uiOutputs;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return a hash of pcName                                              */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSSA_hashName(const char* pcName){
+  unsigned int uiHash = 2166136261u;
+  for(; *pcName != '\0'; pcName++)
+    uiHash = (uiHash ^ (unsigned char)*pcName) * 16777619u;
+  return uiHash;
+}
+
+/*---------------------------------------------------------------------*/
+/*Initialize pnNames to an empty list. Return 0 if successful, 1 if    */
+/*memory is insufficient                                               */
+/*---------------------------------------------------------------------*/
+static int ExpSSA_namesInit(struct SSANames* pnNames){
+  pnNames -> uiLength = 0u;
+  pnNames -> uiMax = INITIAL_NAMES;
+  pnNames -> uiSlots = 2u * INITIAL_NAMES;
+  pnNames -> ppcNames = (char**)malloc(INITIAL_NAMES * sizeof(char*));
+  pnNames -> puiSlots =\
+    (unsigned int*)calloc(pnNames -> uiSlots, sizeof(unsigned int));
+  return pnNames -> ppcNames == NULL || pnNames -> puiSlots == NULL;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the names of pnNames and its arrays                             */
+/*---------------------------------------------------------------------*/
+static void ExpSSA_namesFree(struct SSANames* pnNames){
+  unsigned int uiIndex;
+  if(pnNames -> ppcNames != NULL)
+    for(uiIndex = 0u; uiIndex < pnNames -> uiLength; uiIndex++)
+      free(pnNames -> ppcNames[uiIndex]);
+  free(pnNames -> ppcNames);
+  free(pnNames -> puiSlots);
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the index of pcName in pnNames in *puiIndex, appending a copy  */
+/*of it if it is not there. Return 0 if successful, 1 if memory is     */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpSSA_namesAdd(struct SSANames* pnNames, const char* pcName,\
+			   unsigned int* puiIndex){
+  char** ppcNames;
+  unsigned int* puiSlots;
+  unsigned int uiSlot, uiIndex, uiSlots;
+  for(uiSlot = ExpSSA_hashName(pcName) & (pnNames -> uiSlots - 1u);
+      pnNames -> puiSlots[uiSlot] != 0u;
+      uiSlot = (uiSlot + 1u) & (pnNames -> uiSlots - 1u))
+    if(strcmp(pnNames -> ppcNames[pnNames -> puiSlots[uiSlot] - 1u],\
+	      pcName) == 0){
+      *puiIndex = pnNames -> puiSlots[uiSlot] - 1u;
+      return 0;
+    }
+  if(pnNames -> uiLength == pnNames -> uiMax){
+    ppcNames = (char**)realloc(pnNames -> ppcNames,\
+			       2u * pnNames -> uiMax * sizeof(char*));
+    if(ppcNames == NULL)
+      return 1;
+    pnNames -> ppcNames = ppcNames;
+    //keep the table at most half full
+    uiSlots = 4u * pnNames -> uiMax;
+    puiSlots = (unsigned int*)calloc(uiSlots, sizeof(unsigned int));
+    if(puiSlots == NULL)
+      return 1;
+    for(uiIndex = 0u; uiIndex < pnNames -> uiLength; uiIndex++){
+      for(uiSlot = ExpSSA_hashName(pnNames -> ppcNames[uiIndex]) &\
+	    (uiSlots - 1u);
+	  puiSlots[uiSlot] != 0u;
+	  uiSlot = (uiSlot + 1u) & (uiSlots - 1u));
+      puiSlots[uiSlot] = uiIndex + 1u;
+    }
+    free(pnNames -> puiSlots);
+    pnNames -> puiSlots = puiSlots;
+    pnNames -> uiSlots = uiSlots;
+    pnNames -> uiMax *= 2u;
+    for(uiSlot = ExpSSA_hashName(pcName) & (uiSlots - 1u);
+	puiSlots[uiSlot] != 0u;
+	uiSlot = (uiSlot + 1u) & (uiSlots - 1u));
+  }
+  pnNames -> ppcNames[pnNames -> uiLength] =\
+    (char*)malloc(strlen(pcName) + 1u);
+  if(pnNames -> ppcNames[pnNames -> uiLength] == NULL)
+    return 1;
+  strcpy(pnNames -> ppcNames[pnNames -> uiLength], pcName);
+  pnNames -> puiSlots[uiSlot] = pnNames -> uiLength + 1u;
+  *puiIndex = pnNames -> uiLength++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 and store its value in *pdValue if pcName is a literal, as  */
+/*the passes take it, 0 if not                                         */
+/*---------------------------------------------------------------------*/
+static int ExpSSA_isLiteral(const char* pcName, double* pdValue){
+  if(ExpRational_isLiteral(pcName) == 0)
+    return 0;
+  *pdValue = ExpRational_literalValue(pcName);
+  return 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store a reference to the constant or input named pcName in *puiRef,  */
+/*adding it if it is new. Return 0 if successful, 1 if memory is       */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpSSA_leaf(ExpSSA_T oExpSSA, const char* pcName,\
+		       unsigned int* puiRef){
+  double* pdConstants;
+  double dValue;
+  unsigned int uiIndex;
+  if(ExpSSA_isLiteral(pcName, &dValue) == 0){
+    if(ExpSSA_namesAdd(&oExpSSA -> nInputs, pcName, &uiIndex) != 0)
+      return 1;
+    *puiRef = uiIndex << 2 | REF_INPUT;
+    return 0;
+  }
+  if(ExpSSA_namesAdd(&oExpSSA -> nConstants, pcName, &uiIndex) != 0)
+    return 1;
+  //the values grow along with the list of literals
+  if(uiIndex == oExpSSA -> nConstants.uiLength - 1u){
+    pdConstants = (double*)realloc(oExpSSA -> pdConstants,\
+				   oExpSSA -> nConstants.uiMax *\
+				   sizeof(double));
+    if(pdConstants == NULL){
+      oExpSSA -> nConstants.uiLength--;
+      free(oExpSSA -> nConstants.ppcNames[uiIndex]);
+      return 1;
+    }
+    oExpSSA -> pdConstants = pdConstants;
+    pdConstants[uiIndex] = dValue;
+  }
+  *puiRef = uiIndex << 2 | REF_CONSTANT;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Store the operation of the token type ettType in *pesoOp. Return 0 if*/
+/*successful, -1 if ettType is not an operation                        */
+/*---------------------------------------------------------------------*/
+static int ExpSSA_op(enum ExpTokenType ettType, enum ExpSSAOp* pesoOp){
+  switch(ettType)
+    {
+    case ADD:
+      *pesoOp = EXPSSA_ADD;
+      return 0;
+    case SUBTRACT:
+      *pesoOp = EXPSSA_SUBTRACT;
+      return 0;
+    case MULTIPLY:
+      *pesoOp = EXPSSA_MULTIPLY;
+      return 0;
+    case DIVIDE:
+      *pesoOp = EXPSSA_DIVIDE;
+      return 0;
+    case POWER:
+      *pesoOp = EXPSSA_POWER;
+      return 0;
+    case NEGATIVE:
+      *pesoOp = EXPSSA_NEGATIVE;
+      return 0;
+    case RECIPROCAL:
+      *pesoOp = EXPSSA_RECIPROCAL;
+      return 0;
+    case SQRT:
+      *pesoOp = EXPSSA_SQRT;
+      return 0;
+    case FMA:
+      *pesoOp = EXPSSA_FMA;
+      return 0;
+    default:
+      return -1;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Flatten oTreeNode into instructions of oExpSSA and store a reference */
+/*to its value in *puiRef. Temporary k stands for the value            */
+/*puiTemps[k], for k < uiTemps. Return 0 if successful, 1 if memory is */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static int ExpSSA_flatten(ExpSSA_T oExpSSA, TreeNode_T oTreeNode,\
+			  unsigned int* puiTemps, unsigned int uiTemps,\
+			  unsigned int* puiRef){
+  struct ExpSSAInstruction* piInstructions;
+  struct ExpSSAInstruction iInstruction;
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeArg;
+  const char* pcName;
+  unsigned int uiIndex;
+  int iFused;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL){
+    pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNode));
+    if(ExpProgram_isTemp(pcName, &uiIndex) && uiIndex < uiTemps){
+      *puiRef = puiTemps[uiIndex];
+      return 0;
+    }
+    return ExpSSA_leaf(oExpSSA, pcName, puiRef);
+  }
+  //a sign stands for the value of its operand
+  if(ExpToken_getType(ExpTokenTree_getValue(oTreeNode)) == POSITIVE)
+    return ExpSSA_flatten(oExpSSA, (TreeNode_T)LinkList_getValue(oLinkList),\
+			  puiTemps, uiTemps, puiRef);
+  if(ExpSSA_op(ExpToken_getType(ExpTokenTree_getValue(oTreeNode)),\
+	       &iInstruction.esoOp) != 0){
+    assert(0);
+    return 1;
+  }
+  iFused = (iInstruction.esoOp == EXPSSA_FMA);
+  for(iInstruction.uiArgs = 0u;
+      oLinkList != NULL && iInstruction.uiArgs < EXPSSA_MAX_ARGS;
+      oLinkList = LinkList_getNext(oLinkList)){
+    oTreeNodeArg = (TreeNode_T)LinkList_getValue(oLinkList);
+    //a sign on the first factor or the addend is part of the operation
+    if(iFused && iInstruction.uiArgs != 1u &&\
+       ExpTokenTree_getChildren(oTreeNodeArg) != NULL &&\
+       ExpToken_getType(ExpTokenTree_getValue(oTreeNodeArg)) == NEGATIVE){
+      if(iInstruction.uiArgs == 0u)
+	iInstruction.esoOp = EXPSSA_FNMA;
+      else
+	iInstruction.esoOp = (iInstruction.esoOp == EXPSSA_FMA) ?\
+	  EXPSSA_FMS : EXPSSA_FNMS;
+      oTreeNodeArg =\
+	(TreeNode_T)LinkList_getValue(ExpTokenTree_getChildren(oTreeNodeArg));
+    }
+    if(ExpSSA_flatten(oExpSSA, oTreeNodeArg, puiTemps, uiTemps,\
+		      &iInstruction.puiArgs[iInstruction.uiArgs++]) != 0)
+      return 1;
+  }
+  for(uiIndex = iInstruction.uiArgs; uiIndex < EXPSSA_MAX_ARGS; uiIndex++)
+    iInstruction.puiArgs[uiIndex] = 0u;
+  if(oExpSSA -> uiInstructions == oExpSSA -> uiMaxInstructions){
+    piInstructions = (struct ExpSSAInstruction*)\
+      realloc(oExpSSA -> piInstructions, 2u *\
+	      oExpSSA -> uiMaxInstructions *\
+	      sizeof(struct ExpSSAInstruction));
+    if(piInstructions == NULL)
+      return 1;
+    oExpSSA -> piInstructions = piInstructions;
+    oExpSSA -> uiMaxInstructions *= 2u;
+  }
+  iInstruction.uiUses = 0u;
+  iInstruction.uiDepth = 0u;
+  oExpSSA -> piInstructions[oExpSSA -> uiInstructions] = iInstruction;
+  *puiRef = oExpSSA -> uiInstructions++ << 2 | REF_INSTRUCTION;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of the value a reference made while flattening     */
+/*refers to                                                            */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpSSA_resolve(ExpSSA_T oExpSSA, unsigned int uiRef){
+  switch(uiRef & 3u)
+    {
+    case REF_INPUT:
+      return uiRef >> 2;
+    case REF_CONSTANT:
+      return oExpSSA -> nInputs.uiLength + (uiRef >> 2);
+    default:
+      return ExpSSA_firstInstruction(oExpSSA) + (uiRef >> 2);
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Number the operands and outputs of oExpSSA, which were references,   */
+/*and count the uses and depth of each instruction                     */
+/*---------------------------------------------------------------------*/
+static void ExpSSA_finish(ExpSSA_T oExpSSA){
+  struct ExpSSAInstruction* piInstruction;
+  unsigned int uiIndex, uiArg, uiFirst, uiDepth;
+  uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiInstructions; uiIndex++){
+    piInstruction = &oExpSSA -> piInstructions[uiIndex];
+    uiDepth = 0u;
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++){
+      piInstruction -> puiArgs[uiArg] =\
+	ExpSSA_resolve(oExpSSA, piInstruction -> puiArgs[uiArg]);
+      if(piInstruction -> puiArgs[uiArg] < uiFirst)
+	continue;
+      oExpSSA -> piInstructions[piInstruction -> puiArgs[uiArg] - uiFirst]\
+	.uiUses++;
+      if(oExpSSA -> piInstructions[piInstruction -> puiArgs[uiArg] -\
+				   uiFirst].uiDepth > uiDepth)
+	uiDepth = oExpSSA -> piInstructions\
+	  [piInstruction -> puiArgs[uiArg] - uiFirst].uiDepth;
+    }
+    piInstruction -> uiDepth = uiDepth + 1u;
+  }
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiOutputs; uiIndex++){
+    oExpSSA -> puiOutputs[uiIndex] =\
+      ExpSSA_resolve(oExpSSA, oExpSSA -> puiOutputs[uiIndex]);
+    if(oExpSSA -> puiOutputs[uiIndex] >= uiFirst)
+      oExpSSA -> piInstructions[oExpSSA -> puiOutputs[uiIndex] - uiFirst]\
+	.uiUses++;
+  }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the static single assignment form of oExpProgram              */
+/*---------------------------------------------------------------------*/
+ExpSSA_T ExpSSA_new(ExpProgram_T oExpProgram, LinkList_T pllTrees){
+  ExpSSA_T oExpSSA;
+  LinkList_T oLinkList;
+  unsigned int* puiTemps;
+  unsigned int uiIndex, uiTemps;
+  int iStatus = 0;
+  assert(oExpProgram != NULL);
+  oExpSSA = (ExpSSA_T)calloc(1u, sizeof(struct ExpSSA));
+  if(oExpSSA == NULL)
+    return NULL;
+  uiTemps = ExpProgram_howMany(oExpProgram);
+  puiTemps = (unsigned int*)malloc((uiTemps + 1u) * sizeof(unsigned int));
+  oExpSSA -> uiMaxInstructions = INITIAL_INSTRUCTIONS;
+  oExpSSA -> piInstructions = (struct ExpSSAInstruction*)\
+    malloc(INITIAL_INSTRUCTIONS * sizeof(struct ExpSSAInstruction));
+  oExpSSA -> puiOutputs = (unsigned int*)\
+    malloc((LinkList_getLength(pllTrees) + 1u) * sizeof(unsigned int));
+  if(ExpSSA_namesInit(&oExpSSA -> nInputs) != 0 ||\
+     ExpSSA_namesInit(&oExpSSA -> nConstants) != 0 ||\
+     puiTemps == NULL || oExpSSA -> piInstructions == NULL ||\
+     oExpSSA -> puiOutputs == NULL)
+    iStatus = 1;
+  //each statement may only use the temporaries before it
+  for(uiIndex = 0u; uiIndex < uiTemps && iStatus == 0; uiIndex++)
+    iStatus = ExpSSA_flatten(oExpSSA,\
+			     ExpProgram_getValue(oExpProgram, uiIndex),\
+			     puiTemps, uiIndex, &puiTemps[uiIndex]);
+  for(oLinkList = pllTrees;
+      oLinkList != NULL && iStatus == 0;
+      oLinkList = LinkList_getNext(oLinkList))
+    iStatus = ExpSSA_flatten(oExpSSA,\
+			     (TreeNode_T)LinkList_getValue(oLinkList),\
+			     puiTemps, uiTemps,\
+			     &oExpSSA -> puiOutputs[oExpSSA -> uiOutputs++]);
+  free(puiTemps);
+  if(iStatus != 0){
+    ExpSSA_free(oExpSSA);
+    return NULL;
+  }
+  ExpSSA_finish(oExpSSA);
+  return oExpSSA;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free oExpSSA                                                         */
+/*---------------------------------------------------------------------*/
+void ExpSSA_free(ExpSSA_T oExpSSA){
+  assert(oExpSSA != NULL);
+  ExpSSA_namesFree(&oExpSSA -> nInputs);
+  ExpSSA_namesFree(&oExpSSA -> nConstants);
+  free(oExpSSA -> pdConstants);
+  free(oExpSSA -> piInstructions);
+  free(oExpSSA -> puiOutputs);
+  free(oExpSSA);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of inputs                                          */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_inputs(ExpSSA_T oExpSSA){
+  assert(oExpSSA != NULL);
+  return oExpSSA -> nInputs.uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the name of input uiIndex                                     */
+/*---------------------------------------------------------------------*/
+const char* ExpSSA_inputName(ExpSSA_T oExpSSA, unsigned int uiIndex){
+  assert(oExpSSA != NULL);
+  assert(uiIndex < oExpSSA -> nInputs.uiLength);
+  return oExpSSA -> nInputs.ppcNames[uiIndex];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of constants                                       */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_constants(ExpSSA_T oExpSSA){
+  assert(oExpSSA != NULL);
+  return oExpSSA -> nConstants.uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the literal of constant uiIndex                               */
+/*---------------------------------------------------------------------*/
+const char* ExpSSA_constantText(ExpSSA_T oExpSSA, unsigned int uiIndex){
+  assert(oExpSSA != NULL);
+  assert(uiIndex < oExpSSA -> nConstants.uiLength);
+  return oExpSSA -> nConstants.ppcNames[uiIndex];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the value of constant uiIndex                                 */
+/*---------------------------------------------------------------------*/
+double ExpSSA_constantValue(ExpSSA_T oExpSSA, unsigned int uiIndex){
+  assert(oExpSSA != NULL);
+  assert(uiIndex < oExpSSA -> nConstants.uiLength);
+  return oExpSSA -> pdConstants[uiIndex];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of instructions                                    */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_instructions(ExpSSA_T oExpSSA){
+  assert(oExpSSA != NULL);
+  return oExpSSA -> uiInstructions;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return instruction uiIndex                                           */
+/*---------------------------------------------------------------------*/
+const struct ExpSSAInstruction* ExpSSA_instruction(ExpSSA_T oExpSSA,\
+						   unsigned int uiIndex){
+  assert(oExpSSA != NULL);
+  assert(uiIndex < oExpSSA -> uiInstructions);
+  return &oExpSSA -> piInstructions[uiIndex];
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of the value of the first instruction              */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_firstInstruction(ExpSSA_T oExpSSA){
+  assert(oExpSSA != NULL);
+  return oExpSSA -> nInputs.uiLength + oExpSSA -> nConstants.uiLength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of outputs                                         */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_outputs(ExpSSA_T oExpSSA){
+  assert(oExpSSA != NULL);
+  return oExpSSA -> uiOutputs;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the value of output uiIndex                                   */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_output(ExpSSA_T oExpSSA, unsigned int uiIndex){
+  assert(oExpSSA != NULL);
+  assert(uiIndex < oExpSSA -> uiOutputs);
+  return oExpSSA -> puiOutputs[uiIndex];
+}
+
+/*---------------------------------------------------------------------*/
+/*Renumber the instructions of oExpSSA in the order puiOrder           */
+/*---------------------------------------------------------------------*/
+int ExpSSA_reorder(ExpSSA_T oExpSSA, const unsigned int* puiOrder){
+  struct ExpSSAInstruction* piInstructions;
+  struct ExpSSAInstruction* piInstruction;
+  unsigned int* puiPositions;
+  unsigned int uiIndex, uiArg, uiFirst;
+  assert(oExpSSA != NULL);
+  assert(puiOrder != NULL);
+  uiFirst = ExpSSA_firstInstruction(oExpSSA);
+  piInstructions = (struct ExpSSAInstruction*)\
+    malloc((oExpSSA -> uiInstructions + 1u) *\
+	   sizeof(struct ExpSSAInstruction));
+  puiPositions = (unsigned int*)malloc((oExpSSA -> uiInstructions + 1u) *\
+				       sizeof(unsigned int));
+  if(piInstructions == NULL || puiPositions == NULL){
+    free(piInstructions);
+    free(puiPositions);
+    return 1;
+  }
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiInstructions; uiIndex++){
+    assert(puiOrder[uiIndex] < oExpSSA -> uiInstructions);
+    puiPositions[puiOrder[uiIndex]] = uiIndex;
+  }
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiInstructions; uiIndex++){
+    piInstruction = &piInstructions[uiIndex];
+    *piInstruction = oExpSSA -> piInstructions[puiOrder[uiIndex]];
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++){
+      if(piInstruction -> puiArgs[uiArg] < uiFirst)
+	continue;
+      piInstruction -> puiArgs[uiArg] = uiFirst +\
+	puiPositions[piInstruction -> puiArgs[uiArg] - uiFirst];
+      assert(piInstruction -> puiArgs[uiArg] < uiFirst + uiIndex);
+    }
+  }
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiOutputs; uiIndex++)
+    if(oExpSSA -> puiOutputs[uiIndex] >= uiFirst)
+      oExpSSA -> puiOutputs[uiIndex] = uiFirst +\
+	puiPositions[oExpSSA -> puiOutputs[uiIndex] - uiFirst];
+  free(oExpSSA -> piInstructions);
+  oExpSSA -> piInstructions = piInstructions;
+  oExpSSA -> uiMaxInstructions = oExpSSA -> uiInstructions + 1u;
+  free(puiPositions);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the name of esoOp                                             */
+/*---------------------------------------------------------------------*/
+const char* ExpSSA_opName(enum ExpSSAOp esoOp){
+  switch(esoOp)
+    {
+    case EXPSSA_ADD:
+      return "add";
+    case EXPSSA_SUBTRACT:
+      return "sub";
+    case EXPSSA_MULTIPLY:
+      return "mul";
+    case EXPSSA_DIVIDE:
+      return "div";
+    case EXPSSA_POWER:
+      return "pow";
+    case EXPSSA_NEGATIVE:
+      return "neg";
+    case EXPSSA_RECIPROCAL:
+      return "recip";
+    case EXPSSA_SQRT:
+      return "sqrt";
+    case EXPSSA_FMA:
+      return "fma";
+    case EXPSSA_FMS:
+      return "fms";
+    case EXPSSA_FNMA:
+      return "fnma";
+    case EXPSSA_FNMS:
+      return "fnms";
+    }
+  assert(0);
+  return "";
+}
+
+/*---------------------------------------------------------------------*/
+/*Print pcString as a JSON string, escaping the chars JSON requires    */
+/*---------------------------------------------------------------------*/
+static void ExpSSA_printString(const char* pcString){
+  char pcEscape[8];
+  ExpOut_char('"');
+  for(; *pcString != '\0'; pcString++){
+    if(*pcString == '"' || *pcString == '\\'){
+      ExpOut_char('\\');
+      ExpOut_char(*pcString);
+    }
+    else if((unsigned char)*pcString < 0x20u){
+      sprintf(pcEscape, "\\u%04x", (unsigned int)(unsigned char)*pcString);
+      ExpOut_string(pcEscape);
+    }
+    else
+      ExpOut_char(*pcString);
+  }
+  ExpOut_char('"');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print dValue as a JSON number, with the fewest digits that read back */
+/*as the same double. A value too large for a double is printed as the */
+/*string of its literal pcText                                         */
+/*---------------------------------------------------------------------*/
+static void ExpSSA_printNumber(double dValue, const char* pcText){
+  char pcNumber[32];
+  int iPrecision;
+  if(dValue - dValue != 0.0){
+    ExpSSA_printString(pcText);
+    return;
+  }
+  for(iPrecision = 1; iPrecision < 17; iPrecision++){
+    sprintf(pcNumber, "%.*g", iPrecision, dValue);
+    if(strtod(pcNumber, NULL) == dValue)
+      break;
+  }
+  sprintf(pcNumber, "%.*g", iPrecision, dValue);
+  ExpOut_string(pcNumber);
+}
+
+/*---------------------------------------------------------------------*/
+/*Print oExpSSA as JSON                                                */
+/*---------------------------------------------------------------------*/
+void ExpSSA_printJSON(ExpSSA_T oExpSSA){
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned int uiIndex, uiArg;
+  assert(oExpSSA != NULL);
+  ExpOut_string("{\"format\":\"expparser-ssa\",\"version\":");
+  ExpOut_unsigned(EXPSSA_VERSION);
+  ExpOut_string(",\n\"inputs\":[");
+  for(uiIndex = 0u; uiIndex < oExpSSA -> nInputs.uiLength; uiIndex++){
+    if(uiIndex > 0u)
+      ExpOut_char(',');
+    ExpSSA_printString(oExpSSA -> nInputs.ppcNames[uiIndex]);
+  }
+  ExpOut_string("],\n\"constants\":[");
+  for(uiIndex = 0u; uiIndex < oExpSSA -> nConstants.uiLength; uiIndex++){
+    if(uiIndex > 0u)
+      ExpOut_char(',');
+    ExpSSA_printNumber(oExpSSA -> pdConstants[uiIndex],\
+		       oExpSSA -> nConstants.ppcNames[uiIndex]);
+  }
+  ExpOut_string("],\n\"instructions\":[");
+  //one instruction per line keeps the output easy to compare
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiInstructions; uiIndex++){
+    piInstruction = &oExpSSA -> piInstructions[uiIndex];
+    ExpOut_string(uiIndex > 0u ? ",\n{\"op\":\"" : "\n{\"op\":\"");
+    ExpOut_string(ExpSSA_opName(piInstruction -> esoOp));
+    ExpOut_string("\",\"args\":[");
+    for(uiArg = 0u; uiArg < piInstruction -> uiArgs; uiArg++){
+      if(uiArg > 0u)
+	ExpOut_char(',');
+      ExpOut_unsigned(piInstruction -> puiArgs[uiArg]);
+    }
+    ExpOut_string("],\"uses\":");
+    ExpOut_unsigned(piInstruction -> uiUses);
+    ExpOut_string(",\"depth\":");
+    ExpOut_unsigned(piInstruction -> uiDepth);
+    ExpOut_char('}');
+  }
+  ExpOut_string("],\n\"outputs\":[");
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiOutputs; uiIndex++){
+    if(uiIndex > 0u)
+      ExpOut_char(',');
+    ExpOut_unsigned(oExpSSA -> puiOutputs[uiIndex]);
+  }
+  ExpOut_string("]}\n");
+}
+
+/*---------------------------------------------------------------------*/
+/*Write the low 32 bits of ulValue, least significant byte first       */
+/*---------------------------------------------------------------------*/
+static void ExpSSA_write32(unsigned long ulValue){
+  unsigned int uiByte;
+  for(uiByte = 0u; uiByte < 4u; uiByte++)
+    ExpOut_char((char)((ulValue >> 8u * uiByte) & 0xFFul));
+}
+
+/*---------------------------------------------------------------------*/
+/*Write oExpSSA in the binary encoding                                 */
+/*---------------------------------------------------------------------*/
+void ExpSSA_writeBinary(ExpSSA_T oExpSSA){
+  const struct ExpSSAInstruction* piInstruction;
+  unsigned long long ullBits;
+  const char* pcName;
+  unsigned int uiIndex, uiByte;
+  assert(oExpSSA != NULL);
+  assert(sizeof(double) == sizeof(unsigned long long));
+  ExpOut_string("ESSA");
+  ExpSSA_write32(EXPSSA_VERSION);
+  ExpSSA_write32(oExpSSA -> nInputs.uiLength);
+  ExpSSA_write32(oExpSSA -> nConstants.uiLength);
+  ExpSSA_write32(oExpSSA -> uiInstructions);
+  ExpSSA_write32(oExpSSA -> uiOutputs);
+  for(uiIndex = 0u; uiIndex < oExpSSA -> nInputs.uiLength; uiIndex++){
+    pcName = oExpSSA -> nInputs.ppcNames[uiIndex];
+    ExpSSA_write32(strlen(pcName));
+    ExpOut_string(pcName);
+  }
+  for(uiIndex = 0u; uiIndex < oExpSSA -> nConstants.uiLength; uiIndex++){
+    memcpy(&ullBits, &oExpSSA -> pdConstants[uiIndex], sizeof(double));
+    for(uiByte = 0u; uiByte < 8u; uiByte++)
+      ExpOut_char((char)((ullBits >> 8u * uiByte) & 0xFFull));
+  }
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiInstructions; uiIndex++){
+    piInstruction = &oExpSSA -> piInstructions[uiIndex];
+    ExpOut_char((char)piInstruction -> esoOp);
+    ExpOut_char((char)piInstruction -> uiArgs);
+    ExpOut_char('\0');
+    ExpOut_char('\0');
+    ExpSSA_write32(piInstruction -> puiArgs[0]);
+    ExpSSA_write32(piInstruction -> uiArgs > 1u ?\
+		   piInstruction -> puiArgs[1] : NO_ARG);
+    if(piInstruction -> uiArgs > 2u)
+      ExpSSA_write32(piInstruction -> puiArgs[2]);
+    ExpSSA_write32(piInstruction -> uiUses);
+    ExpSSA_write32(piInstruction -> uiDepth);
+  }
+  for(uiIndex = 0u; uiIndex < oExpSSA -> uiOutputs; uiIndex++)
+    ExpSSA_write32(oExpSSA -> puiOutputs[uiIndex]);
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expssa.c                                                        */
+/*---------------------------------------------------------------------*/
+/*
+int main(void){
+  ExpProgram_T oExpProgram;
+  ExpSSA_T oExpSSA;
+  LinkList_T pllTrees;
+  TreeNode_T oTreeNode;
+  const struct ExpSSAInstruction* piInstruction;
+
+  //#0 = a*b+2, #1 = #0*#0, outputs #1 and a
+  oExpProgram = ExpProgram_new();
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(ADD,\
+				      ExpTokenTree_newNode(MULTIPLY,\
+					ExpTokenTree_newLeaf("a"),\
+					ExpTokenTree_newLeaf("b")),\
+				      ExpTokenTree_newLeaf("2")));
+  ExpProgram_add(oExpProgram,\
+		 ExpTokenTree_newNode(MULTIPLY, ExpTokenTree_newLeaf("#0"),\
+				      ExpTokenTree_newLeaf("#0")));
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf("#1"));
+  LinkList_setNext(pllTrees, LinkList_new());
+  LinkList_setValue(LinkList_getNext(pllTrees), ExpTokenTree_newLeaf("a"));
+  oExpSSA = ExpSSA_new(oExpProgram, pllTrees);
+  if(oExpSSA == NULL)
+    printf("failed test 1\n");
+  //values: a 0, b 1, 2 2, a*b 3, +2 4, #0*#0 5
+  if(ExpSSA_inputs(oExpSSA) != 2u || ExpSSA_constants(oExpSSA) != 1u ||\
+     ExpSSA_instructions(oExpSSA) != 3u ||\
+     ExpSSA_firstInstruction(oExpSSA) != 3u)
+    printf("failed test 2\n");
+  piInstruction = ExpSSA_instruction(oExpSSA, 2u);
+  if(piInstruction -> esoOp != EXPSSA_MULTIPLY ||\
+     piInstruction -> puiArgs[0] != 4u || piInstruction -> puiArgs[1] != 4u ||\
+     piInstruction -> uiDepth != 3u || piInstruction -> uiUses != 1u)
+    printf("failed test 3\n");
+  if(ExpSSA_instruction(oExpSSA, 1u) -> uiUses != 2u ||\
+     ExpSSA_output(oExpSSA, 0u) != 5u || ExpSSA_output(oExpSSA, 1u) != 0u)
+    printf("failed test 4\n");
+  ExpSSA_printJSON(oExpSSA);
+  ExpOut_flush();
+  ExpSSA_free(oExpSSA);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(LinkList_getNext(pllTrees)));
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(LinkList_getNext(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+
+  //#0 = fma(-a,b,-c), whose signs fold into the operation
+  oExpProgram = ExpProgram_new();
+  oTreeNode = ExpTokenTree_newNode(FMA,\
+				   ExpTokenTree_newNode(NEGATIVE,\
+				     ExpTokenTree_newLeaf("a"), NULL),\
+				   ExpTokenTree_newLeaf("b"));
+  ExpTokenTree_addChild(oTreeNode,\
+			ExpTokenTree_newNode(NEGATIVE,\
+					     ExpTokenTree_newLeaf("c"), NULL));
+  ExpProgram_add(oExpProgram, oTreeNode);
+  pllTrees = LinkList_new();
+  LinkList_setValue(pllTrees, ExpTokenTree_newLeaf("#0"));
+  oExpSSA = ExpSSA_new(oExpProgram, pllTrees);
+  if(oExpSSA == NULL || ExpSSA_instructions(oExpSSA) != 1u)
+    printf("failed test 5\n");
+  piInstruction = ExpSSA_instruction(oExpSSA, 0u);
+  if(piInstruction -> esoOp != EXPSSA_FNMS || piInstruction -> uiArgs != 3u ||\
+     piInstruction -> puiArgs[0] != 0u || piInstruction -> puiArgs[1] != 1u ||\
+     piInstruction -> puiArgs[2] != 2u || piInstruction -> uiDepth != 1u)
+    printf("failed test 6\n");
+  ExpSSA_printJSON(oExpSSA);
+  ExpOut_flush();
+  ExpSSA_free(oExpSSA);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(pllTrees));
+  LinkList_free(pllTrees);
+  ExpProgram_free(oExpProgram);
+  return 0;
+}
+*/
@@ -0,0 +1,167 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expssa.h describes the static single assignment form of a simplified */
+/*program, the form the program is handed to other tools and code      */
+/*generators in. Every operation is one instruction of at most         */
+/*EXPSSA_MAX_ARGS operands, three for a fused multiply-add and two or  */
+/*one for the rest, and every value, whether an input, a constant or   */
+/*the result of an instruction, has a number                           */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPSSA_INCLUDED
+#define EXPSSA_INCLUDED
+
+#include "expprogram.h"
+#include "linklist.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the version of the JSON and binary encodings, raised whenever */
+/*either changes                                                       */
+/*---------------------------------------------------------------------*/
+#define EXPSSA_VERSION 2u
+
+/*---------------------------------------------------------------------*/
+/*Define the most operands of an instruction                           */
+/*---------------------------------------------------------------------*/
+#define EXPSSA_MAX_ARGS 3u
+
+/*---------------------------------------------------------------------*/
+/*Define the operations of instructions, numbered as in the binary     */
+/*encoding, so new operations are only ever appended. A sign +x is not */
+/*an operation, and stands for the value of x. The fused multiply-adds */
+/*of x, y and z are x*y+z, x*y-z, -(x*y)+z and -(x*y)-z, each rounded  */
+/*once                                                                 */
+/*---------------------------------------------------------------------*/
+enum ExpSSAOp {EXPSSA_ADD, EXPSSA_SUBTRACT, EXPSSA_MULTIPLY, EXPSSA_DIVIDE,\
+	       EXPSSA_POWER, EXPSSA_NEGATIVE, EXPSSA_RECIPROCAL, EXPSSA_SQRT,\
+	       EXPSSA_FMA, EXPSSA_FMS, EXPSSA_FNMA, EXPSSA_FNMS};
+
+/*---------------------------------------------------------------------*/
+/*An ExpSSAInstruction is one operation on one to three values, with   */
+/*the number of times its result is used, by instructions and as an    */
+/*output, and its depth, the number of operations on the longest chain */
+/*from the inputs to it                                                */
+/*---------------------------------------------------------------------*/
+struct ExpSSAInstruction
+{
+  enum ExpSSAOp esoOp;
+  /*number of operands, 1 to EXPSSA_MAX_ARGS*/
+  unsigned int uiArgs;
+  /*the values operated on*/
+  unsigned int puiArgs[EXPSSA_MAX_ARGS];
+  unsigned int uiUses;
+  unsigned int uiDepth;
+};
+
+/*---------------------------------------------------------------------*/
+/*An ExpSSA is a list of inputs, constants and instructions and the    */
+/*values of the outputs. Values are numbered inputs first, then        */
+/*constants, then instructions in order, and an instruction only uses  */
+/*values numbered before it                                            */
+/*---------------------------------------------------------------------*/
+typedef struct ExpSSA* ExpSSA_T;
+
+/*---------------------------------------------------------------------*/
+/*Return the static single assignment form of oExpProgram, whose       */
+/*outputs are the trees stored in the list pllTrees, or NULL if memory */
+/*is insufficient. Operands named by a literal become constants, and   */
+/*the rest inputs, in order of first use                               */
+/*---------------------------------------------------------------------*/
+ExpSSA_T ExpSSA_new(ExpProgram_T oExpProgram, LinkList_T pllTrees);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpSSA                                  */
+/*---------------------------------------------------------------------*/
+void ExpSSA_free(ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of inputs of oExpSSA                               */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_inputs(ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Return the name of input uiIndex of oExpSSA                          */
+/*---------------------------------------------------------------------*/
+const char* ExpSSA_inputName(ExpSSA_T oExpSSA, unsigned int uiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of constants of oExpSSA                            */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_constants(ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Return the literal of constant uiIndex of oExpSSA as it was written  */
+/*---------------------------------------------------------------------*/
+const char* ExpSSA_constantText(ExpSSA_T oExpSSA, unsigned int uiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Return the value of constant uiIndex of oExpSSA                      */
+/*---------------------------------------------------------------------*/
+double ExpSSA_constantValue(ExpSSA_T oExpSSA, unsigned int uiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of instructions of oExpSSA                         */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_instructions(ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Return instruction uiIndex of oExpSSA, the value numbered            */
+/*ExpSSA_firstInstruction(oExpSSA) + uiIndex. The ExpSSA keeps         */
+/*ownership                                                            */
+/*---------------------------------------------------------------------*/
+const struct ExpSSAInstruction* ExpSSA_instruction(ExpSSA_T oExpSSA,\
+						   unsigned int uiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of the value of the first instruction of oExpSSA,  */
+/*which is the number of inputs and constants                          */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_firstInstruction(ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Return the number of outputs of oExpSSA                              */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_outputs(ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Return the value of output uiIndex of oExpSSA                        */
+/*---------------------------------------------------------------------*/
+unsigned int ExpSSA_output(ExpSSA_T oExpSSA, unsigned int uiIndex);
+
+/*---------------------------------------------------------------------*/
+/*Renumber the instructions of oExpSSA so instruction k is the one     */
+/*numbered puiOrder[k] before, updating every operand and output.      */
+/*puiOrder must hold every instruction once, each after the            */
+/*instructions it uses. The uses and depth of an instruction are       */
+/*unchanged. Return 0 if successful, 1 if memory is insufficient, in   */
+/*which case oExpSSA is unchanged                                      */
+/*---------------------------------------------------------------------*/
+int ExpSSA_reorder(ExpSSA_T oExpSSA, const unsigned int* puiOrder);
+
+/*---------------------------------------------------------------------*/
+/*Return the name of the operation esoOp in the JSON encoding, ex.     */
+/*"mul"                                                                */
+/*---------------------------------------------------------------------*/
+const char* ExpSSA_opName(enum ExpSSAOp esoOp);
+
+/*---------------------------------------------------------------------*/
+/*Print oExpSSA to stdout as one JSON object with the members format,  */
+/*version, inputs, an array of names, constants, an array of numbers,  */
+/*instructions, an array of objects with the members op, args, uses and*/
+/*depth, and outputs, an array of value numbers                        */
+/*---------------------------------------------------------------------*/
+void ExpSSA_printJSON(ExpSSA_T oExpSSA);
+
+/*---------------------------------------------------------------------*/
+/*Write oExpSSA to stdout in the binary encoding, little endian        */
+/*throughout: the magic bytes ESSA, then the version, the number of    */
+/*inputs, constants, instructions and outputs as 32 bit integers; each */
+/*input as a 32 bit length and its chars; each constant as a 64 bit    */
+/*IEEE double; each instruction as 8 bit op, 8 bit number of operands, */
+/*16 zero bits, and 32 bit first and second operands, a missing one    */
+/*being 0xFFFFFFFF, the third operand only if there are three, uses and*/
+/*depth; and each output as a 32 bit value number                      */
+/*---------------------------------------------------------------------*/
+void ExpSSA_writeBinary(ExpSSA_T oExpSSA);
+
+#endif
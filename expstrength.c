@@ -0,0 +1,443 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expstrength.c implements expstrength.h. Each statement is rewritten  */
+/*bottom up, and a node is rewritten by changing the type of its token */
+/*and replacing its constant operand, so the rest of the statement is  */
+/*never copied                                                         */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expstrength.h"
+#include "expfold.h"
+#include "exprational.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the largest cost an operator may be given                     */
+/*---------------------------------------------------------------------*/
+#define STRENGTH_MAX_COST 1000000
+
+/*---------------------------------------------------------------------*/
+/*An ExpStrength is the cost of each token type                        */
+/*---------------------------------------------------------------------*/
+struct ExpStrength
+{
+  int piCost[RIGHT_BRACKET + 1];
+};
+
+/*---------------------------------------------------------------------*/
+/*A StrengthTarget is a named set of costs. Subtraction costs as much  */
+/*as addition, a reciprocal as much as a division, and a positive sign */
+/*as much as a negative one                                            */
+/*---------------------------------------------------------------------*/
+struct StrengthTarget
+{
+  const char* pcName;
+  int iAdd;
+  int iMultiply;
+  int iDivide;
+  int iPower;
+  int iSqrt;
+  int iNegative;
+};
+
+/*---------------------------------------------------------------------*/
+/*The targets other than generic, whose costs are those of             */
+/*ExpToken_typeCost                                                    */
+/*---------------------------------------------------------------------*/
+static const struct StrengthTarget ptTargets[] = {
+  {"fpu", 4, 4, 14, 40, 16, 1},
+  {"soft", 20, 30, 90, 400, 120, 2}
+};
+
+/*---------------------------------------------------------------------*/
+/*A StrengthName is the name by which the cost of a token type is set  */
+/*---------------------------------------------------------------------*/
+struct StrengthName
+{
+  const char* pcName;
+  enum ExpTokenType ettType;
+};
+
+static const struct StrengthName pnNames[] = {
+  {"add", ADD}, {"subtract", SUBTRACT}, {"multiply", MULTIPLY},
+  {"divide", DIVIDE}, {"power", POWER}, {"reciprocal", RECIPROCAL},
+  {"sqrt", SQRT}, {"negative", NEGATIVE}
+};
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpStrength with the generic costs                      */
+/*---------------------------------------------------------------------*/
+ExpStrength_T ExpStrength_new(void){
+  ExpStrength_T oExpStrength;
+  oExpStrength = (ExpStrength_T)malloc(sizeof(struct ExpStrength));
+  if(oExpStrength == NULL)
+    return NULL;
+  ExpStrength_setTarget(oExpStrength, "generic");
+  return oExpStrength;
+}
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpStrength                             */
+/*---------------------------------------------------------------------*/
+void ExpStrength_free(ExpStrength_T oExpStrength){
+  assert(oExpStrength != NULL);
+  free(oExpStrength);
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace the costs of oExpStrength by those of the target pcTarget    */
+/*---------------------------------------------------------------------*/
+int ExpStrength_setTarget(ExpStrength_T oExpStrength, const char* pcTarget){
+  const struct StrengthTarget* ptTarget;
+  unsigned int uiIndex;
+  int iType;
+  assert(oExpStrength != NULL);
+  assert(pcTarget != NULL);
+  if(strcmp(pcTarget, "generic") == 0){
+    for(iType = 0; iType <= (int)RIGHT_BRACKET; iType++)
+      oExpStrength -> piCost[iType] =\
+	ExpToken_typeCost((enum ExpTokenType)iType);
+    return 0;
+  }
+  for(uiIndex = 0u;
+      uiIndex < sizeof(ptTargets) / sizeof(ptTargets[0]);
+      uiIndex++)
+    if(strcmp(pcTarget, ptTargets[uiIndex].pcName) == 0)
+      break;
+  if(uiIndex == sizeof(ptTargets) / sizeof(ptTargets[0]))
+    return -1;
+  ptTarget = &ptTargets[uiIndex];
+  oExpStrength -> piCost[ADD] = ptTarget -> iAdd;
+  oExpStrength -> piCost[SUBTRACT] = ptTarget -> iAdd;
+  oExpStrength -> piCost[MULTIPLY] = ptTarget -> iMultiply;
+  //a fused multiply-add issues and finishes like a product
+  oExpStrength -> piCost[FMA] = ptTarget -> iMultiply;
+  oExpStrength -> piCost[DIVIDE] = ptTarget -> iDivide;
+  oExpStrength -> piCost[RECIPROCAL] = ptTarget -> iDivide;
+  oExpStrength -> piCost[POWER] = ptTarget -> iPower;
+  oExpStrength -> piCost[SQRT] = ptTarget -> iSqrt;
+  oExpStrength -> piCost[POSITIVE] = ptTarget -> iNegative;
+  oExpStrength -> piCost[NEGATIVE] = ptTarget -> iNegative;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Set the cost named in pcCost                                         */
+/*---------------------------------------------------------------------*/
+int ExpStrength_setCost(ExpStrength_T oExpStrength, const char* pcCost){
+  const char* pcEquals;
+  char* pcEnd;
+  size_t stLength;
+  unsigned int uiIndex;
+  long lCost;
+  assert(oExpStrength != NULL);
+  if(pcCost == NULL)
+    return -1;
+  pcEquals = strchr(pcCost, '=');
+  if(pcEquals == NULL || pcEquals[1] < '0' || pcEquals[1] > '9')
+    return -1;
+  stLength = (size_t)(pcEquals - pcCost);
+  lCost = strtol(pcEquals + 1, &pcEnd, 10);
+  if(*pcEnd != '\0' || lCost > STRENGTH_MAX_COST)
+    return -1;
+  for(uiIndex = 0u; uiIndex < sizeof(pnNames) / sizeof(pnNames[0]);
+      uiIndex++)
+    if(strlen(pnNames[uiIndex].pcName) == stLength &&\
+       strncmp(pcCost, pnNames[uiIndex].pcName, stLength) == 0){
+      oExpStrength -> piCost[pnNames[uiIndex].ettType] = (int)lCost;
+      return 0;
+    }
+  return -1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpStrength_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the cost of oTreeNode under the costs of oExpStrength         */
+/*---------------------------------------------------------------------*/
+static unsigned long ExpStrength_treeCost(ExpStrength_T oExpStrength,\
+					  TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned long ulCost;
+  ulCost = (unsigned long)oExpStrength -> piCost[ExpStrength_type(oTreeNode)];
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    ulCost += ExpStrength_treeCost(oExpStrength,\
+				   (TreeNode_T)LinkList_getValue(oLinkList));
+  return ulCost;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the cost of oExpProgram                                       */
+/*---------------------------------------------------------------------*/
+unsigned long ExpStrength_cost(ExpStrength_T oExpStrength,\
+			       ExpProgram_T oExpProgram){
+  unsigned long ulCost = 0ul;
+  unsigned int uiIndex;
+  assert(oExpStrength != NULL);
+  assert(oExpProgram != NULL);
+  for(uiIndex = 0u; uiIndex < ExpProgram_howMany(oExpProgram); uiIndex++)
+    ulCost += ExpStrength_treeCost(oExpStrength,\
+				   ExpProgram_getValue(oExpProgram, uiIndex));
+  return ulCost;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the costs of oExpStrength make ettCheap strictly cheaper */
+/*than ettDear, 0 if not                                               */
+/*---------------------------------------------------------------------*/
+static int ExpStrength_cheaper(ExpStrength_T oExpStrength,\
+			       enum ExpTokenType ettCheap,\
+			       enum ExpTokenType ettDear){
+  return oExpStrength -> piCost[ettCheap] < oExpStrength -> piCost[ettDear];
+}
+
+/*---------------------------------------------------------------------*/
+/*Free the operand uiIndex, 0 or 1, of the binary oTreeNode and put    */
+/*oTreeNodeNew in its place, then give oTreeNode the type ettType      */
+/*---------------------------------------------------------------------*/
+static void ExpStrength_replace(TreeNode_T oTreeNode, unsigned int uiIndex,\
+				TreeNode_T oTreeNodeNew,\
+				enum ExpTokenType ettType){
+  LinkList_T oLinkList;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(uiIndex == 1u)
+    oLinkList = LinkList_getNext(oLinkList);
+  ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkList));
+  LinkList_setValue(oLinkList, oTreeNodeNew);
+  ExpToken_setType(ExpTokenTree_getValue(oTreeNode), ettType);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new operand named pcName, or NULL if memory is insufficient */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpStrength_operand(const char* pcName){
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode;
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return NULL;
+  for(; *pcName != '\0'; pcName++)
+    ExpToken_appendChar(oExpToken, *pcName);
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the power oTreeNode, with base oTreeNodeBase and constant    */
+/*exponent rExponent: x^2 to x*x and x^0.5 to sqrt(x). Return 0 if     */
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpStrength_power(ExpStrength_T oExpStrength,\
+			     TreeNode_T oTreeNode,\
+			     TreeNode_T oTreeNodeBase,\
+			     struct ExpRational rExponent,\
+			     unsigned int* puiRewrites){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeCopy;
+  if(ExpRational_equals(rExponent, 2ll) &&\
+     TreeNode_isLeaf(oTreeNodeBase) &&\
+     ExpStrength_cheaper(oExpStrength, MULTIPLY, POWER)){
+    oTreeNodeCopy = ExpTokenTree_copy(oTreeNodeBase);
+    if(oTreeNodeCopy == NULL)
+      return 1;
+    ExpStrength_replace(oTreeNode, 1u, oTreeNodeCopy, MULTIPLY);
+    (*puiRewrites)++;
+  }
+  else if(rExponent.llNum == 1ll && rExponent.llDen == 2ll &&\
+	  ExpStrength_cheaper(oExpStrength, SQRT, POWER)){
+    //the exponent is dropped, leaving the base as the only operand
+    oLinkList = LinkList_getNext(ExpTokenTree_getChildren(oTreeNode));
+    ExpTokenTree_free((TreeNode_T)LinkList_getValue(oLinkList));
+    LinkList_setNext(ExpTokenTree_getChildren(oTreeNode), NULL);
+    LinkList_free(oLinkList);
+    ExpToken_setType(ExpTokenTree_getValue(oTreeNode), SQRT);
+    (*puiRewrites)++;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the division oTreeNode by the positive constant rDivisor into*/
+/*a multiplication by its reciprocal, if that is a literal an operand  */
+/*name can hold. Return 0 if successful, 1 if memory is insufficient   */
+/*---------------------------------------------------------------------*/
+static int ExpStrength_divide(ExpStrength_T oExpStrength,\
+			      TreeNode_T oTreeNode,\
+			      struct ExpRational rDivisor,\
+			      unsigned int* puiRewrites){
+  char pcDigits[32];
+  struct ExpRational rReciprocal;
+  TreeNode_T oTreeNodeLiteral;
+  if(ExpRational_sign(rDivisor) <= 0 ||\
+     ExpStrength_cheaper(oExpStrength, MULTIPLY, DIVIDE) == 0)
+    return 0;
+  if(ExpRational_divide(ExpRational_fromInt(1ll), rDivisor,\
+			&rReciprocal) != 0 ||\
+     ExpRational_decimal(rReciprocal, pcDigits, sizeof(pcDigits)) != 0 ||\
+     strlen(pcDigits) > ExpToken_maxChars())
+    return 0;
+  oTreeNodeLiteral = ExpStrength_operand(pcDigits);
+  if(oTreeNodeLiteral == NULL)
+    return 1;
+  ExpStrength_replace(oTreeNode, 1u, oTreeNodeLiteral, MULTIPLY);
+  (*puiRewrites)++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the product oTreeNode of the literal 2, operand uiIndex, and */
+/*the single operand oTreeNodeOther into oTreeNodeOther+oTreeNodeOther.*/
+/*Return 0 if successful, 1 if memory is insufficient                  */
+/*---------------------------------------------------------------------*/
+static int ExpStrength_double(ExpStrength_T oExpStrength,\
+			      TreeNode_T oTreeNode,\
+			      unsigned int uiIndex,\
+			      TreeNode_T oTreeNodeOther,\
+			      unsigned int* puiRewrites){
+  struct ExpRational rValue;
+  TreeNode_T oTreeNodeCopy;
+  //a product of two constants is left to folding
+  if(TreeNode_isLeaf(oTreeNodeOther) == 0 ||\
+     ExpFold_value(oTreeNodeOther, &rValue) ||\
+     ExpStrength_cheaper(oExpStrength, ADD, MULTIPLY) == 0)
+    return 0;
+  oTreeNodeCopy = ExpTokenTree_copy(oTreeNodeOther);
+  if(oTreeNodeCopy == NULL)
+    return 1;
+  ExpStrength_replace(oTreeNode, uiIndex, oTreeNodeCopy, ADD);
+  (*puiRewrites)++;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite oTreeNode and every node below it. Return 0 if successful, 1 */
+/*if memory is insufficient                                            */
+/*---------------------------------------------------------------------*/
+static int ExpStrength_rewrite(ExpStrength_T oExpStrength,\
+			       TreeNode_T oTreeNode,\
+			       unsigned int* puiRewrites){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeLeft, oTreeNodeRight;
+  struct ExpRational rValue;
+  for(oLinkList = ExpTokenTree_getChildren(oTreeNode);
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    if(ExpStrength_rewrite(oExpStrength,\
+			   (TreeNode_T)LinkList_getValue(oLinkList),\
+			   puiRewrites) != 0)
+      return 1;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL || LinkList_getNext(oLinkList) == NULL)
+    return 0;
+  oTreeNodeLeft = (TreeNode_T)LinkList_getValue(oLinkList);
+  oTreeNodeRight = (TreeNode_T)LinkList_getValue(LinkList_getNext(oLinkList));
+  if(ExpStrength_type(oTreeNode) == POWER){
+    if(ExpFold_value(oTreeNodeRight, &rValue) == 0)
+      return 0;
+    return ExpStrength_power(oExpStrength, oTreeNode, oTreeNodeLeft,\
+			     rValue, puiRewrites);
+  }
+  //a division of two literals is left to folding, and any other
+  //division by a constant may become a product for the rule below
+  if(ExpStrength_type(oTreeNode) == DIVIDE &&\
+     ExpFold_value(oTreeNode, &rValue) == 0 &&\
+     ExpFold_value(oTreeNodeRight, &rValue) &&\
+     ExpStrength_divide(oExpStrength, oTreeNode, rValue, puiRewrites) != 0)
+    return 1;
+  if(ExpStrength_type(oTreeNode) != MULTIPLY)
+    return 0;
+  oTreeNodeRight = (TreeNode_T)LinkList_getValue(LinkList_getNext(oLinkList));
+  if(ExpFold_value(oTreeNodeLeft, &rValue) &&\
+     ExpRational_equals(rValue, 2ll))
+    return ExpStrength_double(oExpStrength, oTreeNode, 0u, oTreeNodeRight,\
+			      puiRewrites);
+  if(ExpFold_value(oTreeNodeRight, &rValue) &&\
+     ExpRational_equals(rValue, 2ll))
+    return ExpStrength_double(oExpStrength, oTreeNode, 1u, oTreeNodeLeft,\
+			      puiRewrites);
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the statements of oExpProgram under the costs of oExpStrength*/
+/*---------------------------------------------------------------------*/
+int ExpStrength_apply(ExpStrength_T oExpStrength, ExpProgram_T oExpProgram,\
+		      unsigned int* puiRewrites){
+  unsigned int uiIndex, uiRewrites = 0u;
+  int iResult = 0;
+  assert(oExpStrength != NULL);
+  assert(oExpProgram != NULL);
+  for(uiIndex = 0u;
+      uiIndex < ExpProgram_howMany(oExpProgram) && iResult == 0;
+      uiIndex++)
+    iResult = ExpStrength_rewrite(oExpStrength,\
+				  ExpProgram_getValue(oExpProgram, uiIndex),\
+				  &uiRewrites);
+  if(puiRewrites != NULL)
+    *puiRewrites = uiRewrites;
+  return iResult;
+}
+
+/*---------------------------------------------------------------------*/
+/*Test expstrength.c                                                   */
+/*---------------------------------------------------------------------*/
+/*
+#include <stdio.h>
+
+int main(void){
+  ExpStrength_T oExpStrength;
+  ExpProgram_T oExpProgram;
+  unsigned int uiRewrites;
+
+  oExpStrength = ExpStrength_new();
+  oExpProgram = ExpProgram_new();
+  //x^2, x^0.5, x/4, 2*x and x/3
+  ExpProgram_add(oExpProgram, ExpTokenTree_newNode(POWER,\
+    ExpTokenTree_newLeaf("x"), ExpTokenTree_newLeaf("2")));
+  ExpProgram_add(oExpProgram, ExpTokenTree_newNode(POWER,\
+    ExpTokenTree_newLeaf("x"), ExpTokenTree_newLeaf("0.5")));
+  ExpProgram_add(oExpProgram, ExpTokenTree_newNode(DIVIDE,\
+    ExpTokenTree_newLeaf("x"), ExpTokenTree_newLeaf("4")));
+  ExpProgram_add(oExpProgram, ExpTokenTree_newNode(MULTIPLY,\
+    ExpTokenTree_newLeaf("2"), ExpTokenTree_newLeaf("x")));
+  ExpProgram_add(oExpProgram, ExpTokenTree_newNode(DIVIDE,\
+    ExpTokenTree_newLeaf("x"), ExpTokenTree_newLeaf("3")));
+  if(ExpStrength_cost(oExpStrength, oExpProgram) != 25ul)
+    printf("failed test 1\n");
+  //generic costs: adds and multiplies cost the same, so 2*x is kept
+  if(ExpStrength_apply(oExpStrength, oExpProgram, &uiRewrites) != 0 ||\
+     uiRewrites != 3u)
+    printf("failed test 2\n");
+  if(ExpStrength_cost(oExpStrength, oExpProgram) != 11ul)
+    printf("failed test 3\n");
+  if(ExpStrength_setTarget(oExpStrength, "soft") != 0 ||\
+     ExpStrength_apply(oExpStrength, oExpProgram, &uiRewrites) != 0 ||\
+     uiRewrites != 1u)
+    printf("failed test 4\n");
+  if(ExpStrength_setTarget(oExpStrength, "vax") != -1 ||\
+     ExpStrength_setCost(oExpStrength, "multiply=") != -1 ||\
+     ExpStrength_setCost(oExpStrength, "modulo=3") != -1 ||\
+     ExpStrength_setCost(oExpStrength, "multiply=3") != 0)
+    printf("failed test 5\n");
+  ExpProgram_print(oExpProgram);
+  ExpProgram_free(oExpProgram);
+  ExpStrength_free(oExpStrength);
+  return 0;
+}
+*/
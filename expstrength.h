@@ -0,0 +1,69 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*expstrength.h describes strength reduction for ExpPrograms. An       */
+/*operation with a constant operand often has a cheaper equivalent, ex.*/
+/*x*x for x^2, but which one is cheaper depends on the machine, so     */
+/*every rewrite is decided by a table of operator costs chosen for the */
+/*target                                                               */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPSTRENGTH_INCLUDED
+#define EXPSTRENGTH_INCLUDED
+
+#include "expprogram.h"
+
+/*---------------------------------------------------------------------*/
+/*An ExpStrength is a table of operator costs for one target           */
+/*---------------------------------------------------------------------*/
+typedef struct ExpStrength* ExpStrength_T;
+
+/*---------------------------------------------------------------------*/
+/*Return a new ExpStrength holding the costs of the generic target, or */
+/*NULL if memory is insufficient                                       */
+/*---------------------------------------------------------------------*/
+ExpStrength_T ExpStrength_new(void);
+
+/*---------------------------------------------------------------------*/
+/*Free all memory occupied by oExpStrength                             */
+/*---------------------------------------------------------------------*/
+void ExpStrength_free(ExpStrength_T oExpStrength);
+
+/*---------------------------------------------------------------------*/
+/*Replace every cost in oExpStrength by the costs of the target named  */
+/*pcTarget. The targets are generic, the operator cost model used by   */
+/*the other optimizers; fpu, the latencies of a pipelined floating     */
+/*point unit; and soft, software floating point, where a multiplication*/
+/*costs more than an addition. Return 0 if successful, -1 if pcTarget  */
+/*is not a target                                                      */
+/*---------------------------------------------------------------------*/
+int ExpStrength_setTarget(ExpStrength_T oExpStrength, const char* pcTarget);
+
+/*---------------------------------------------------------------------*/
+/*Set one cost of oExpStrength from pcCost, of the form operator=cost, */
+/*where operator is one of add, subtract, multiply, divide, power,     */
+/*reciprocal, sqrt or negative, ex. multiply=3. Return 0 if successful,*/
+/*-1 if pcCost is malformed                                            */
+/*---------------------------------------------------------------------*/
+int ExpStrength_setCost(ExpStrength_T oExpStrength, const char* pcCost);
+
+/*---------------------------------------------------------------------*/
+/*Return the cost of oExpProgram under the costs of oExpStrength       */
+/*---------------------------------------------------------------------*/
+unsigned long ExpStrength_cost(ExpStrength_T oExpStrength,\
+			       ExpProgram_T oExpProgram);
+
+/*---------------------------------------------------------------------*/
+/*Rewrite the statements of oExpProgram in place wherever the costs of */
+/*oExpStrength make the rewritten form cheaper: x^2 becomes x*x, x^0.5 */
+/*becomes sqrt(x), x/c becomes x*d where d is the literal 1/c, and 2*x */
+/*becomes x+x. Operands are only duplicated if they are a single       */
+/*operand or temporary. A divisor whose reciprocal has no short decimal*/
+/*form is kept. Store the number of rewrites in puiRewrites if it is   */
+/*not NULL. Return 0 if successful, 1 if memory is insufficient, in    */
+/*which case the program is still valid but may be only partially      */
+/*rewritten                                                            */
+/*---------------------------------------------------------------------*/
+int ExpStrength_apply(ExpStrength_T oExpStrength, ExpProgram_T oExpProgram,\
+		      unsigned int* puiRewrites);
+
+#endif
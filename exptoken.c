@@ -94,6 +94,13 @@ int ExpToken_appendChar(ExpToken_T oExpToken, char c){
    return 1;
 }
 
+/*---------------------------------------------------------------------*/
+/*Return MAX_CHARS, the maximum number of characters in a name         */
+/*---------------------------------------------------------------------*/
+unsigned int ExpToken_maxChars(void){
+   return MAX_CHARS;
+}
+
 /*---------------------------------------------------------------------*/
 /*Compare two ExpTokens. Return 0 if they are equivalent, 1 if not.    */
 /*---------------------------------------------------------------------*/
@@ -138,6 +145,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  return -1;
 	case POWER:
 	  return -1;
+	case RECIPROCAL:
+	  return -2;
+	case SQRT:
+	  return -2;
+	case FMA:
+	  return -2;
 	case LEFT_BRACKET:
 	  return -2;
 	case RIGHT_BRACKET:
@@ -166,6 +179,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  return -1;
 	case POWER:
 	  return -1;
+	case RECIPROCAL:
+	  return -2;
+	case SQRT:
+	  return -2;
+	case FMA:
+	  return -2;
 	case LEFT_BRACKET:
 	  return -2;
 	case RIGHT_BRACKET:
@@ -194,6 +213,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  return -1;
 	case POWER:
 	  return -1;
+	case RECIPROCAL:
+	  return -2;
+	case SQRT:
+	  return -2;
+	case FMA:
+	  return -2;
 	case LEFT_BRACKET:
 	  return -2;
 	case RIGHT_BRACKET:
@@ -222,6 +247,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  return -1;
 	case POWER:
 	  return -1;
+	case RECIPROCAL:
+	  return -2;
+	case SQRT:
+	  return -2;
+	case FMA:
+	  return -2;
 	case LEFT_BRACKET:
 	  return -2;
 	case RIGHT_BRACKET:
@@ -250,6 +281,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  return 0;
 	case POWER:
 	  return -1;
+	case RECIPROCAL:
+	  return -2;
+	case SQRT:
+	  return -2;
+	case FMA:
+	  return -2;
 	case LEFT_BRACKET:
 	  return -2;
 	case RIGHT_BRACKET:
@@ -278,6 +315,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  return 0;
 	case POWER:
 	  return -1;
+	case RECIPROCAL:
+	  return -2;
+	case SQRT:
+	  return -2;
+	case FMA:
+	  return -2;
 	case LEFT_BRACKET:
 	  return -2;
 	case RIGHT_BRACKET:
@@ -306,6 +349,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  return 1;
 	case POWER:
 	  return 0;
+	case RECIPROCAL:
+	  return -2;
+	case SQRT:
+	  return -2;
+	case FMA:
+	  return -2;
 	case LEFT_BRACKET:
 	  return -2;
 	case RIGHT_BRACKET:
@@ -315,6 +364,12 @@ int ExpToken_precedence(ExpToken_T oExpToken1, ExpToken_T oExpToken2){
 	  break;
 	}
       break;
+    case RECIPROCAL:
+      return -2;
+    case SQRT:
+      return -2;
+    case FMA:
+      return -2;
     case LEFT_BRACKET:
       return -2;
     case RIGHT_BRACKET:
@@ -363,6 +418,12 @@ int ExpToken_numOperands(ExpToken_T oExpToken){
       return 2;
     case POWER:
       return 2;
+    case RECIPROCAL:
+      return 1;
+    case SQRT:
+      return 1;
+    case FMA:
+      return 3;
     case LEFT_BRACKET:
       return 0;
     case RIGHT_BRACKET:
@@ -396,6 +457,12 @@ char* ExpToken_toString(ExpToken_T oExpToken){
       return "/";
     case POWER:
       return "^";
+    case RECIPROCAL:
+      return "1/";
+    case SQRT:
+      return "sqrt";
+    case FMA:
+      return "fma";
     case LEFT_BRACKET:
       return "(";
     case RIGHT_BRACKET:
@@ -428,6 +495,12 @@ int ExpToken_isAssociative(ExpToken_T oExpToken){
       return 0;
     case POWER:
       return 0;
+    case RECIPROCAL:
+      return 0;
+    case SQRT:
+      return 0;
+    case FMA:
+      return 0;
     case LEFT_BRACKET:
       return 0;
     case RIGHT_BRACKET:
@@ -438,6 +511,54 @@ int ExpToken_isAssociative(ExpToken_T oExpToken){
     }
 }
 
+/*---------------------------------------------------------------------*/
+/*Return the cost of one operation of type ettType. Division and powers*/
+/*are far more expensive than the other arithmetic operators on every  */
+/*target we care about, so they are weighted accordingly               */
+/*---------------------------------------------------------------------*/
+int ExpToken_typeCost(enum ExpTokenType ettType){
+  switch(ettType)
+    {
+    case OPERAND:
+      return 0;
+    case POSITIVE:
+      return 1;
+    case NEGATIVE:
+      return 1;
+    case ADD:
+      return 1;
+    case SUBTRACT:
+      return 1;
+    case MULTIPLY:
+      return 1;
+    case DIVIDE:
+      return 4;
+    case POWER:
+      return 8;
+    case RECIPROCAL:
+      return 4;
+    case SQRT:
+      return 4;
+    case FMA:
+      return 1;
+    case LEFT_BRACKET:
+      return 0;
+    case RIGHT_BRACKET:
+      return 0;
+    default:
+      assert(0);
+      return 0;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the cost of evaluating oExpToken under the operator cost model*/
+/*---------------------------------------------------------------------*/
+int ExpToken_cost(ExpToken_T oExpToken){
+  assert(oExpToken != NULL);
+  return ExpToken_typeCost(oExpToken -> ettType);
+}
+
 /*---------------------------------------------------------------------*/
 /*Test exptoken.c                                                      */
 /*---------------------------------------------------------------------*/
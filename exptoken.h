@@ -23,6 +23,12 @@
 /*multiply (ex. x*y): binary, multiply the two operands                */
 /*divide (ex. x/y): binary, divide the first operand by the second     */
 /*power (ex. x^y): binary, exponentiate the first operand by the second*/
+/*reciprocal (ex. 1/x): unary, divide one by the operand. Never parsed,*/
+/*only introduced by the optimizers                                    */
+/*square root (ex. sqrt(x)): unary, the square root of the operand.    */
+/*Never parsed, only introduced by strength reduction                  */
+/*fused multiply-add (ex. fma(x,y,z)): ternary, x*y+z with a single    */
+/*rounding. Never parsed, only introduced by contraction               */
 /*                                                                     */
 /*Other token types are:                                               */
 /*left_bracket (ex. ( or ] ): start of a nested statement              */
@@ -30,7 +36,8 @@
 /*operand (ex. x): a variable or number                                */
 /*---------------------------------------------------------------------*/
 enum ExpTokenType {OPERAND, POSITIVE, NEGATIVE, ADD, SUBTRACT, MULTIPLY,\
-                   DIVIDE, POWER, LEFT_BRACKET, RIGHT_BRACKET};
+                   DIVIDE, POWER, RECIPROCAL, SQRT, FMA, LEFT_BRACKET,\
+                   RIGHT_BRACKET};
 
 /*---------------------------------------------------------------------*/
 /*An ExpToken is a distinct element in a mathematical expression       */
@@ -73,6 +80,11 @@ void ExpToken_setType(ExpToken_T oExpToken, enum ExpTokenType ettType);
 /*---------------------------------------------------------------------*/
 int ExpToken_appendChar(ExpToken_T oExpToken, char c);
 
+/*---------------------------------------------------------------------*/
+/*Return the maximum number of characters an ExpToken's name may hold  */
+/*---------------------------------------------------------------------*/
+unsigned int ExpToken_maxChars(void);
+
 /*---------------------------------------------------------------------*/
 /*Compare two ExpTokens. Return 0 if they are equivalent, 1 if not.    */
 /*---------------------------------------------------------------------*/
@@ -109,4 +121,16 @@ char* ExpToken_toString(ExpToken_T oExpToken);
 /*---------------------------------------------------------------------*/
 int ExpToken_isAssociative(ExpToken_T oExpToken);
 
+/*---------------------------------------------------------------------*/
+/*Return the cost of evaluating one operation of type ettType under the*/
+/*operator cost model used by the optimizers. Operands cost nothing and*/
+/*every operator costs at least 1                                      */
+/*---------------------------------------------------------------------*/
+int ExpToken_typeCost(enum ExpTokenType ettType);
+
+/*---------------------------------------------------------------------*/
+/*Return the cost of evaluating oExpToken under the operator cost model*/
+/*---------------------------------------------------------------------*/
+int ExpToken_cost(ExpToken_T oExpToken);
+
 #endif
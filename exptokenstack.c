@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include "exptokenstack.h"
 #include "linkstack.h"
+#include "expout.h"
 
 /*---------------------------------------------------------------------*/
 /*ExpTokenStack's have a stack that stores exptokens                   */
@@ -127,8 +128,9 @@ void ExpTokenStack_print(ExpTokenStack_T oExpTokenStack){
   for(oLinkListStack = LinkStack_getList(oExpTokenStack -> plsStack);
       uiIndex < LinkStack_howMany(oExpTokenStack -> plsStack);
       oLinkListStack = LinkList_getNext(oLinkListStack)){
-    fprintf(stdout, "%s\n", ExpToken_toString\
-	    ((ExpToken_T)LinkList_getValue(oLinkListStack)));
+    ExpOut_string(ExpToken_toString\
+		  ((ExpToken_T)LinkList_getValue(oLinkListStack)));
+    ExpOut_char('\n');
     uiIndex ++;
   }
 }
@@ -163,6 +165,7 @@ int main(void){
   ExpTokenStack_push(oExpTokenStack, oExpToken2);
   printf("The printout should have * on top of x:\n");
   ExpTokenStack_print(oExpTokenStack);
+  ExpOut_flush();
   oExpTokenPop = ExpTokenStack_pop(oExpTokenStack);
   if(oExpTokenPop != oExpToken2)
     printf("Failed Test 1\n");
@@ -8,7 +8,9 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "exptokentree.h"
+#include "expout.h"
 
 /*---------------------------------------------------------------------*/
 /*Return a new empty TreeNode. If memory is insufficient return NULL   */
@@ -37,6 +39,62 @@ void ExpTokenTree_free(TreeNode_T oTreeNode){
   TreeNode_free(oTreeNode);
 }
 
+/*---------------------------------------------------------------------*/
+/*Return a new leaf holding the operand pcName                         */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpTokenTree_newLeaf(const char* pcName){
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode;
+  assert(pcName != NULL);
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return NULL;
+  for(; *pcName != '\0'; pcName++)
+    ExpToken_appendChar(oExpToken, *pcName);
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree whose root is the operator ettType over oTreeNode1 */
+/*and oTreeNode2                                                       */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpTokenTree_newNode(enum ExpTokenType ettType,\
+				TreeNode_T oTreeNode1,\
+				TreeNode_T oTreeNode2){
+  ExpToken_T oExpToken = NULL;
+  TreeNode_T oTreeNode = NULL;
+  if(oTreeNode1 != NULL){
+    oExpToken = ExpToken_new();
+    oTreeNode = ExpTokenTree_new();
+  }
+  if(oExpToken != NULL && oTreeNode != NULL){
+    ExpToken_setType(oExpToken, ettType);
+    ExpTokenTree_setValue(oTreeNode, oExpToken);
+    oExpToken = NULL;
+    if(ExpTokenTree_addChild(oTreeNode, oTreeNode1) == 0){
+      oTreeNode1 = NULL;
+      if(oTreeNode2 == NULL ||\
+	 ExpTokenTree_addChild(oTreeNode, oTreeNode2) == 0)
+	return oTreeNode;
+    }
+  }
+  if(oExpToken != NULL)
+    ExpToken_free(oExpToken);
+  if(oTreeNode != NULL)
+    ExpTokenTree_free(oTreeNode);
+  if(oTreeNode1 != NULL)
+    ExpTokenTree_free(oTreeNode1);
+  if(oTreeNode2 != NULL)
+    ExpTokenTree_free(oTreeNode2);
+  return NULL;
+}
+
 /*---------------------------------------------------------------------*/
 /*Return a pointer to the value of oTreeNode                           */
 /*---------------------------------------------------------------------*/
@@ -247,10 +305,9 @@ TreeNode_T ExpTokenTree_copy(TreeNode_T oTreeNode){
 /*---------------------------------------------------------------------*/
 static void ExpTokenTree_printValue(TreeNode_T oTreeNode){
   if(ExpTokenTree_getValue(oTreeNode) == NULL)
-    printf("NULL");
+    ExpOut_string("NULL");
   else
-    printf(ExpToken_toString(ExpTokenTree_getValue(oTreeNode)));
-  fflush(stdout);
+    ExpOut_string(ExpToken_toString(ExpTokenTree_getValue(oTreeNode)));
 }
 
 
@@ -287,6 +344,104 @@ void ExpTokenTree_print(TreeNode_T oTreeNode){
   }
 }
 
+/*---------------------------------------------------------------------*/
+/*A helper function for ExpTokenTree_printBracketed. Return how tightly*/
+/*the operator at oTreeNode binds as it is printed: higher binds       */
+/*tighter                                                              */
+/*---------------------------------------------------------------------*/
+static int ExpTokenTree_printPrecedence(TreeNode_T oTreeNode){
+  switch(ExpToken_getType(ExpTokenTree_getValue(oTreeNode)))
+    {
+    case ADD:
+    case SUBTRACT:
+      return 1;
+    case MULTIPLY:
+    case DIVIDE:
+    case RECIPROCAL://printed as 1/x, so it binds like a division
+      return 2;
+    case NEGATIVE:
+    case POSITIVE:
+      return 3;
+    case POWER:
+      return 4;
+    case OPERAND://a constant folded to a fraction, ex. 1/3, is a division
+      return (strchr(ExpToken_getName(ExpTokenTree_getValue(oTreeNode)),\
+		     '/') != NULL) ? 2 : 5;
+    default:
+      return 5;
+    }
+}
+
+/*---------------------------------------------------------------------*/
+/*A helper function for ExpTokenTree_printBracketed. Print oTreeNode,  */
+/*in brackets if iBracket is nonzero                                   */
+/*---------------------------------------------------------------------*/
+static void ExpTokenTree_printChild(TreeNode_T oTreeNode, int iBracket){
+  if(iBracket)
+    ExpOut_char('(');
+  ExpTokenTree_printBracketed(oTreeNode);
+  if(iBracket)
+    ExpOut_char(')');
+}
+
+/*---------------------------------------------------------------------*/
+/*Print oTreeNode with the brackets needed to read it back             */
+/*---------------------------------------------------------------------*/
+void ExpTokenTree_printBracketed(TreeNode_T oTreeNode){
+  LinkList_T oLinkListChild;
+  TreeNode_T oTreeNodeLeft, oTreeNodeRight;
+  int iPrecedence;
+  assert(oTreeNode != NULL);
+  oLinkListChild = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkListChild == NULL){
+    ExpTokenTree_printValue(oTreeNode);
+    return;
+  }
+  iPrecedence = ExpTokenTree_printPrecedence(oTreeNode);
+  oTreeNodeLeft = (TreeNode_T)LinkList_getValue(oLinkListChild);
+  //a unary operator brackets everything but an operand that is not a
+  //fraction, and a square root is written as a call, so it brackets
+  //everything
+  if(LinkList_getNext(oLinkListChild) == NULL){
+    ExpTokenTree_printValue(oTreeNode);
+    ExpTokenTree_printChild(oTreeNodeLeft,\
+			    TreeNode_isLeaf(oTreeNodeLeft) == 0 |\
+			    ExpTokenTree_printPrecedence(oTreeNodeLeft) < 5 |\
+			    ExpToken_getType(ExpTokenTree_getValue(oTreeNode))\
+			    == SQRT);
+    return;
+  }
+  //a fused multiply-add is written as a call, its operands apart
+  if(LinkList_getNext(LinkList_getNext(oLinkListChild)) != NULL){
+    ExpTokenTree_printValue(oTreeNode);
+    ExpOut_char('(');
+    for(; oLinkListChild != NULL;
+	oLinkListChild = LinkList_getNext(oLinkListChild)){
+      ExpTokenTree_printBracketed\
+	((TreeNode_T)LinkList_getValue(oLinkListChild));
+      if(LinkList_getNext(oLinkListChild) != NULL)
+	ExpOut_char(',');
+    }
+    ExpOut_char(')');
+    return;
+  }
+  oTreeNodeRight =\
+    (TreeNode_T)LinkList_getValue(LinkList_getNext(oLinkListChild));
+  //the left operand only needs brackets if it binds more loosely, or
+  //if it is anything but an operand under a power
+  ExpTokenTree_printChild\
+    (oTreeNodeLeft,\
+     ExpTokenTree_printPrecedence(oTreeNodeLeft) < iPrecedence |\
+     (iPrecedence == 4 && TreeNode_isLeaf(oTreeNodeLeft) == 0));
+  ExpTokenTree_printValue(oTreeNode);
+  //the right operand is bracketed unless it binds strictly tighter,
+  //and a sign is always bracketed so that it never follows an operator
+  ExpTokenTree_printChild\
+    (oTreeNodeRight,\
+     ExpTokenTree_printPrecedence(oTreeNodeRight) <= iPrecedence |\
+     ExpTokenTree_printPrecedence(oTreeNodeRight) == 3);
+}
+
 /*---------------------------------------------------------------------*/
 /*Create a copy of oTreeNodeSource where all instances of oTreeNodeFind*/
 /*have been replaced by oTreeNodeReplace. Return NULL if memory is     */
@@ -434,7 +589,7 @@ int main(void){
     oExpToken6_2, oExpToken6_3;
   TreeNode_T oTreeNode1_1, oTreeNode1_2, oTreeNode1_3, oTreeNode2_1,\
     oTreeNode2_2, oTreeNode2_3, oTreeNode3, oTreeNode4, oTreeNode5,\
-    oTreeNode6_1, oTreeNode6_2, oTreeNode6_3;
+    oTreeNode6_1, oTreeNode6_2, oTreeNode6_3, oTreeNode7;
   LinkList_T oLinkList, oLinkListNext;
   
   printf("----------------------------------------\n");
@@ -543,21 +698,33 @@ int main(void){
 
   printf("The next line should be: x+x\n");
   ExpTokenTree_print(oTreeNode3);
+  ExpOut_flush();
   printf("\n");
 
   oTreeNode5 = ExpTokenTree_replace(oTreeNode3, oTreeNode1_2, oTreeNode4);
   printf("The next line should be:y+y\n");
   ExpTokenTree_print(oTreeNode5);
+  ExpOut_flush();
   printf("\n");
 
   ExpTokenTree_free(oTreeNode5);
   oTreeNode5 = ExpTokenTree_replace(oTreeNode3, oTreeNode3, oTreeNode4);
   printf("The next line should be:y\n");
   ExpTokenTree_print(oTreeNode5);
+  ExpOut_flush();
   printf("\n");
 
   if(ExpTokenTree_compareAssociative(oTreeNode1_1, oTreeNode6_1) != 0)
     printf("Failed Test 8\n");
+
+  //the helpers the other test mains build their trees with
+  oTreeNode7 = ExpTokenTree_newNode(ADD, ExpTokenTree_newLeaf("x"),\
+				    ExpTokenTree_newLeaf("y"));
+  if(ExpTokenTree_compare(oTreeNode7, oTreeNode1_1) != 0)
+    printf("Failed Test 9\n");
+  ExpTokenTree_free(oTreeNode7);
+  if(ExpTokenTree_newNode(NEGATIVE, NULL, ExpTokenTree_newLeaf("x")) != NULL)
+    printf("Failed Test 10\n");
   
   
   ExpTokenTree_free(oTreeNode1_1);
@@ -21,6 +21,24 @@ TreeNode_T ExpTokenTree_new(void);
 /*---------------------------------------------------------------------*/
 void ExpTokenTree_free(TreeNode_T oTreeNode);
 
+/*---------------------------------------------------------------------*/
+/*Return a new leaf holding the operand pcName, or NULL if memory is   */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpTokenTree_newLeaf(const char* pcName);
+
+/*---------------------------------------------------------------------*/
+/*Return a new tree whose root is the operator ettType over oTreeNode1 */
+/*and, unless it is NULL for a unary operator, oTreeNode2. The new tree*/
+/*takes ownership of the children. If memory is insufficient, or       */
+/*oTreeNode1 is NULL because an earlier allocation failed, free the    */
+/*children and return NULL, so calls can be nested to build a whole    */
+/*expression                                                           */
+/*---------------------------------------------------------------------*/
+TreeNode_T ExpTokenTree_newNode(enum ExpTokenType ettType,\
+				TreeNode_T oTreeNode1,\
+				TreeNode_T oTreeNode2);
+
 /*---------------------------------------------------------------------*/
 /*Return a pointer to the value of oTreeNode                           */
 /*---------------------------------------------------------------------*/
@@ -78,6 +96,15 @@ TreeNode_T ExpTokenTree_copy(TreeNode_T oTreeNode);
 /*---------------------------------------------------------------------*/
 void ExpTokenTree_print(TreeNode_T oTreeNode);
 
+/*---------------------------------------------------------------------*/
+/*Print an infix representation of oTreeNode to STDOUT with the        */
+/*brackets needed to read it back unambiguously. Unlike                */
+/*ExpTokenTree_print this is correct for trees of any depth. Unary and */
+/*binary operators are written infix, and a square root and the        */
+/*three-operand fused multiply-add as calls, ex. sqrt(x) and fma(x,y,z)*/
+/*---------------------------------------------------------------------*/
+void ExpTokenTree_printBracketed(TreeNode_T oTreeNode);
+
 /*---------------------------------------------------------------------*/
 /*Create a copy of oTreeNodeSource where all instances of oTreeNodeFind*/
 /*have been replaced by oTreeNodeReplace. Return NULL if memory is     */
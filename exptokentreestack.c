@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include "exptokentreestack.h"
 #include "linkstack.h"
+#include "expout.h"
 
 /*---------------------------------------------------------------------*/
 /*ExpTokenTreeStacks have a stack that stores ExpTokenTrees            */
@@ -114,7 +115,7 @@ void ExpTokenTreeStack_print(ExpTokenTreeStack_T oExpTokenTreeStack){
       oLinkListStack = LinkList_getNext(oLinkListStack)){
     ExpTokenTree_print\
       ((TreeNode_T)LinkList_getValue(oLinkListStack));
-    printf("\n\n");
+    ExpOut_string("\n\n");
     uiIndex++;
   }
 }
@@ -151,6 +152,7 @@ int main(void){
 
   printf("The printout below should have * on top of +\n");
   ExpTokenTreeStack_print(oExpTokenTreeStack);
+  ExpOut_flush();
 
   oTreeNode3 = ExpTokenTreeStack_pop(oExpTokenTreeStack);
   if(oTreeNode3 != oTreeNode2)
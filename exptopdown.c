@@ -0,0 +1,462 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exptopdown.c implements exptopdown.h. Each round hashes every subtree*/
+/*of the trees and of the statements found so far into an open         */
+/*addressing table, counting equal subtrees, and extracts the largest  */
+/*one that repeats. A subtree is always extracted before any smaller   */
+/*subtree inside it, so reversing the order of extraction gives an     */
+/*order in which every temporary is assigned before it is used         */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "exptopdown.h"
+#include "exptokentree.h"
+#include "exptoken.h"
+
+/*---------------------------------------------------------------------*/
+/*Define the initial capacity of the list of extracted statements      */
+/*---------------------------------------------------------------------*/
+#define INITIAL_STATEMENTS 64u
+
+/*---------------------------------------------------------------------*/
+/*A TopDownEntry counts the occurrences of one class of equal subtrees */
+/*---------------------------------------------------------------------*/
+struct TopDownEntry
+{
+  /*hash of the subtrees*/
+  unsigned long ulHash;
+  /*the first subtree found, or NULL if the entry is empty*/
+  TreeNode_T oTreeNode;
+  /*number of nodes in the subtree*/
+  unsigned int uiSize;
+  /*number of occurrences*/
+  unsigned int uiCount;
+};
+
+/*---------------------------------------------------------------------*/
+/*A TopDownTable is an open addressing hash table of TopDownEntries    */
+/*---------------------------------------------------------------------*/
+struct TopDownTable
+{
+  /*the entries*/
+  struct TopDownEntry* peEntries;
+  /*number of entries, a power of two*/
+  unsigned int uiSize;
+};
+
+/*---------------------------------------------------------------------*/
+/*A TopDownForest is the trees being simplified together with the      */
+/*statements extracted from them so far                                */
+/*---------------------------------------------------------------------*/
+struct TopDownForest
+{
+  /*the trees*/
+  LinkList_T pllTrees;
+  /*the expression of each extracted statement, in extraction order*/
+  TreeNode_T* poValues;
+  /*number of statements*/
+  unsigned int uiLength;
+  /*number of statements that fit*/
+  unsigned int uiMax;
+  /*budget that stops the extraction early, or NULL*/
+  ExpBudget_T oExpBudget;
+};
+
+/*---------------------------------------------------------------------*/
+/*Return the type of the token stored at oTreeNode                     */
+/*---------------------------------------------------------------------*/
+static enum ExpTokenType ExpTopDown_type(TreeNode_T oTreeNode){
+  return ExpToken_getType(ExpTokenTree_getValue(oTreeNode));
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if the operands of the binary operator at oTreeNode may be  */
+/*swapped, 0 if not                                                    */
+/*---------------------------------------------------------------------*/
+static int ExpTopDown_isCommutative(TreeNode_T oTreeNode){
+  return ExpTopDown_type(oTreeNode) == ADD |\
+    ExpTopDown_type(oTreeNode) == MULTIPLY;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return 1 if oTreeNode1 and oTreeNode2 are equal up to the order of   */
+/*the operands of + and *, 0 if not                                    */
+/*---------------------------------------------------------------------*/
+static int ExpTopDown_equal(TreeNode_T oTreeNode1, TreeNode_T oTreeNode2){
+  LinkList_T oLinkList1, oLinkList2;
+  TreeNode_T oTreeNodeLeft1, oTreeNodeLeft2;
+  if(ExpToken_compare(ExpTokenTree_getValue(oTreeNode1),\
+		      ExpTokenTree_getValue(oTreeNode2)) != 0)
+    return 0;
+  oLinkList1 = ExpTokenTree_getChildren(oTreeNode1);
+  oLinkList2 = ExpTokenTree_getChildren(oTreeNode2);
+  if(LinkList_getLength(oLinkList1) != LinkList_getLength(oLinkList2))
+    return 0;
+  if(oLinkList1 == NULL)
+    return 1;
+  oTreeNodeLeft1 = (TreeNode_T)LinkList_getValue(oLinkList1);
+  oTreeNodeLeft2 = (TreeNode_T)LinkList_getValue(oLinkList2);
+  oLinkList1 = LinkList_getNext(oLinkList1);
+  oLinkList2 = LinkList_getNext(oLinkList2);
+  if(oLinkList1 == NULL)
+    return ExpTopDown_equal(oTreeNodeLeft1, oTreeNodeLeft2);
+  if(ExpTopDown_equal(oTreeNodeLeft1, oTreeNodeLeft2) &&\
+     ExpTopDown_equal((TreeNode_T)LinkList_getValue(oLinkList1),\
+		      (TreeNode_T)LinkList_getValue(oLinkList2)))
+    return 1;
+  return ExpTopDown_isCommutative(oTreeNode1) &&\
+    ExpTopDown_equal(oTreeNodeLeft1,\
+		     (TreeNode_T)LinkList_getValue(oLinkList2)) &&\
+    ExpTopDown_equal((TreeNode_T)LinkList_getValue(oLinkList1),\
+		     oTreeNodeLeft2);
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a hash of oTreeNode that is the same for subtrees that        */
+/*ExpTopDown_equal finds equal, and store its number of nodes in       */
+/**puiSize                                                             */
+/*---------------------------------------------------------------------*/
+static unsigned long ExpTopDown_hash(TreeNode_T oTreeNode,\
+				     unsigned int* puiSize){
+  LinkList_T oLinkList;
+  const char* pcName;
+  unsigned long ulHash, ulLeft, ulRight;
+  unsigned int uiSize;
+  ulHash = 2166136261ul + (unsigned long)ExpTopDown_type(oTreeNode);
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL){
+    for(pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNode));
+	*pcName != '\0'; pcName++)
+      ulHash = (ulHash ^ (unsigned char)*pcName) * 16777619ul;
+    *puiSize = 1u;
+    return ulHash;
+  }
+  ulLeft = ExpTopDown_hash((TreeNode_T)LinkList_getValue(oLinkList),\
+			   puiSize);
+  oLinkList = LinkList_getNext(oLinkList);
+  if(oLinkList == NULL){
+    (*puiSize)++;
+    return (ulHash ^ ulLeft) * 16777619ul;
+  }
+  ulRight = ExpTopDown_hash((TreeNode_T)LinkList_getValue(oLinkList),\
+			    &uiSize);
+  *puiSize += uiSize + 1u;
+  //a symmetric combination for operands that may be swapped
+  if(ExpTopDown_isCommutative(oTreeNode))
+    return (ulHash ^ (ulLeft + ulRight) ^ (ulLeft * ulRight)) * 16777619ul;
+  return ((ulHash ^ ulLeft) * 16777619ul ^ ulRight) * 1099511628211ul;
+}
+
+/*---------------------------------------------------------------------*/
+/*Count oTreeNode and every operation under it in poTable. Return 0 if */
+/*successful, 1 if the table is full                                   */
+/*---------------------------------------------------------------------*/
+static int ExpTopDown_count(struct TopDownTable* poTable,\
+			    TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  struct TopDownEntry* peEntry;
+  unsigned long ulHash;
+  unsigned int uiSize, uiSlot, uiProbe;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return 0;
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    if(ExpTopDown_count(poTable,\
+			(TreeNode_T)LinkList_getValue(oLinkList)) != 0)
+      return 1;
+  //hashing again from each node is quadratic only in the tree depth
+  ulHash = ExpTopDown_hash(oTreeNode, &uiSize);
+  uiSlot = (unsigned int)ulHash & (poTable -> uiSize - 1u);
+  for(uiProbe = 0u; uiProbe < poTable -> uiSize; uiProbe++){
+    peEntry = &poTable -> peEntries[(uiSlot + uiProbe) &\
+				    (poTable -> uiSize - 1u)];
+    if(peEntry -> oTreeNode == NULL){
+      peEntry -> ulHash = ulHash;
+      peEntry -> oTreeNode = oTreeNode;
+      peEntry -> uiSize = uiSize;
+      peEntry -> uiCount = 1u;
+      return 0;
+    }
+    if(peEntry -> ulHash == ulHash &&\
+       ExpTopDown_equal(peEntry -> oTreeNode, oTreeNode)){
+      peEntry -> uiCount++;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return the number of operations in oTreeNode                         */
+/*---------------------------------------------------------------------*/
+static unsigned int ExpTopDown_operations(TreeNode_T oTreeNode){
+  LinkList_T oLinkList;
+  unsigned int uiOperations = 0u;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return 0u;
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    uiOperations +=\
+      ExpTopDown_operations((TreeNode_T)LinkList_getValue(oLinkList));
+  return uiOperations + 1u;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new copy of the largest subtree in poForest that occurs more*/
+/*than once, or NULL if there is none or memory is insufficient, in    */
+/*which case *piStatus is set to 1                                     */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpTopDown_largest(struct TopDownForest* poForest,\
+				     int* piStatus){
+  struct TopDownTable tTable;
+  struct TopDownEntry* peBest = NULL;
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeBest;
+  unsigned int uiIndex, uiOperations = 0u;
+  //size the table for at most half full
+  for(oLinkList = poForest -> pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    uiOperations +=\
+      ExpTopDown_operations((TreeNode_T)LinkList_getValue(oLinkList));
+  for(uiIndex = 0u; uiIndex < poForest -> uiLength; uiIndex++)
+    uiOperations += ExpTopDown_operations(poForest -> poValues[uiIndex]);
+  for(tTable.uiSize = 16u; tTable.uiSize < 2u * uiOperations;
+      tTable.uiSize *= 2u);
+  tTable.peEntries = (struct TopDownEntry*)\
+    calloc(tTable.uiSize, sizeof(struct TopDownEntry));
+  if(tTable.peEntries == NULL){
+    *piStatus = 1;
+    return NULL;
+  }
+  for(oLinkList = poForest -> pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    ExpTopDown_count(&tTable, (TreeNode_T)LinkList_getValue(oLinkList));
+  //a statement's own root is its temporary, which is not a use
+  for(uiIndex = 0u; uiIndex < poForest -> uiLength; uiIndex++)
+    for(oLinkList = ExpTokenTree_getChildren(poForest -> poValues[uiIndex]);
+	oLinkList != NULL;
+	oLinkList = LinkList_getNext(oLinkList))
+      ExpTopDown_count(&tTable, (TreeNode_T)LinkList_getValue(oLinkList));
+  //prefer the largest, then the most repeated
+  for(uiIndex = 0u; uiIndex < tTable.uiSize; uiIndex++)
+    if(tTable.peEntries[uiIndex].uiCount > 1u &&\
+       (peBest == NULL ||\
+	tTable.peEntries[uiIndex].uiSize > peBest -> uiSize ||\
+	(tTable.peEntries[uiIndex].uiSize == peBest -> uiSize &&\
+	 tTable.peEntries[uiIndex].uiCount > peBest -> uiCount)))
+      peBest = &tTable.peEntries[uiIndex];
+  oTreeNodeBest = NULL;
+  if(peBest != NULL){
+    oTreeNodeBest = ExpTokenTree_copy(peBest -> oTreeNode);
+    if(oTreeNodeBest == NULL)
+      *piStatus = 1;
+  }
+  free(tTable.peEntries);
+  return oTreeNodeBest;
+}
+
+/*---------------------------------------------------------------------*/
+/*Return a new operand naming temporary uiIndex, or NULL if memory is  */
+/*insufficient                                                         */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpTopDown_newTemp(unsigned int uiIndex){
+  char pcName[16];
+  ExpToken_T oExpToken;
+  TreeNode_T oTreeNode;
+  unsigned int uiChar;
+  sprintf(pcName, "%c%u", EXPPROGRAM_TEMP_CHAR, uiIndex);
+  oExpToken = ExpToken_new();
+  if(oExpToken == NULL)
+    return NULL;
+  for(uiChar = 0u; pcName[uiChar] != '\0'; uiChar++)
+    ExpToken_appendChar(oExpToken, pcName[uiChar]);
+  oTreeNode = ExpTokenTree_new();
+  if(oTreeNode == NULL){
+    ExpToken_free(oExpToken);
+    return NULL;
+  }
+  ExpTokenTree_setValue(oTreeNode, oExpToken);
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Replace every subtree of oTreeNode equal to oTreeNodeFind, whose hash*/
+/*is ulHash, by a new operand naming temporary uiIndex, and return the */
+/*result, which is oTreeNode unless oTreeNode itself is replaced. Set  */
+/**piStatus to 1 if memory is insufficient, in which case the subtrees */
+/*not yet replaced are left in place                                   */
+/*---------------------------------------------------------------------*/
+static TreeNode_T ExpTopDown_replace(TreeNode_T oTreeNode,\
+				     TreeNode_T oTreeNodeFind,\
+				     unsigned long ulHash,\
+				     unsigned int uiIndex, int* piStatus){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeTemp;
+  unsigned int uiSize;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL)
+    return oTreeNode;
+  if(ExpTopDown_hash(oTreeNode, &uiSize) == ulHash &&\
+     ExpTopDown_equal(oTreeNode, oTreeNodeFind)){
+    oTreeNodeTemp = ExpTopDown_newTemp(uiIndex);
+    if(oTreeNodeTemp == NULL){
+      *piStatus = 1;
+      return oTreeNode;
+    }
+    ExpTokenTree_free(oTreeNode);
+    return oTreeNodeTemp;
+  }
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    LinkList_setValue(oLinkList, ExpTopDown_replace\
+		      ((TreeNode_T)LinkList_getValue(oLinkList),\
+		       oTreeNodeFind, ulHash, uiIndex, piStatus));
+  return oTreeNode;
+}
+
+/*---------------------------------------------------------------------*/
+/*Append oTreeNode to the statements of poForest. Return 0 if          */
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpTopDown_push(struct TopDownForest* poForest,\
+			   TreeNode_T oTreeNode){
+  TreeNode_T* poValues;
+  if(poForest -> uiLength == poForest -> uiMax){
+    poValues = (TreeNode_T*)realloc(poForest -> poValues,\
+				    2u * poForest -> uiMax *\
+				    sizeof(TreeNode_T));
+    if(poValues == NULL)
+      return 1;
+    poForest -> poValues = poValues;
+    poForest -> uiMax *= 2u;
+  }
+  poForest -> poValues[poForest -> uiLength++] = oTreeNode;
+  return 0;
+}
+
+/*---------------------------------------------------------------------*/
+/*Extract the repeated subtrees of poForest, largest first. Return 0 if*/
+/*successful, 1 if memory is insufficient                              */
+/*---------------------------------------------------------------------*/
+static int ExpTopDown_extract(struct TopDownForest* poForest){
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeFind, oTreeNodeChild;
+  unsigned long ulHash;
+  unsigned int uiIndex, uiSize;
+  int iStatus = 0;
+  //whatever is not extracted in time is left in the trees
+  while(iStatus == 0 && ExpBudget_isExhausted(poForest -> oExpBudget) == 0){
+    oTreeNodeFind = ExpTopDown_largest(poForest, &iStatus);
+    if(oTreeNodeFind == NULL)
+      break;
+    //the statement must exist before its temporary is used
+    if(ExpTopDown_push(poForest, oTreeNodeFind) != 0){
+      ExpTokenTree_free(oTreeNodeFind);
+      return 1;
+    }
+    ulHash = ExpTopDown_hash(oTreeNodeFind, &uiSize);
+    for(oLinkList = poForest -> pllTrees;
+	oLinkList != NULL;
+	oLinkList = LinkList_getNext(oLinkList))
+      LinkList_setValue(oLinkList, ExpTopDown_replace\
+			((TreeNode_T)LinkList_getValue(oLinkList),\
+			 oTreeNodeFind, ulHash, poForest -> uiLength - 1u,\
+			 &iStatus));
+    for(uiIndex = 0u; uiIndex + 1u < poForest -> uiLength; uiIndex++)
+      for(oLinkList = ExpTokenTree_getChildren(poForest -> poValues[uiIndex]);
+	  oLinkList != NULL;
+	  oLinkList = LinkList_getNext(oLinkList)){
+	oTreeNodeChild = (TreeNode_T)LinkList_getValue(oLinkList);
+	LinkList_setValue(oLinkList, ExpTopDown_replace\
+			  (oTreeNodeChild, oTreeNodeFind, ulHash,\
+			   poForest -> uiLength - 1u, &iStatus));
+      }
+  }
+  return iStatus;
+}
+
+/*---------------------------------------------------------------------*/
+/*Renumber the temporaries under oTreeNode so that the first uiShared, */
+/*the shared subtrees, come in reverse order of extraction             */
+/*---------------------------------------------------------------------*/
+static void ExpTopDown_renumber(TreeNode_T oTreeNode, unsigned int uiShared){
+  LinkList_T oLinkList;
+  unsigned int uiIndex;
+  char* pcName;
+  oLinkList = ExpTokenTree_getChildren(oTreeNode);
+  if(oLinkList == NULL){
+    pcName = ExpToken_getName(ExpTokenTree_getValue(oTreeNode));
+    //the new number is never longer than the old one
+    if(ExpProgram_isTemp(pcName, &uiIndex) && uiIndex < uiShared)
+      sprintf(pcName + 1, "%u", uiShared - 1u - uiIndex);
+    return;
+  }
+  for(; oLinkList != NULL; oLinkList = LinkList_getNext(oLinkList))
+    ExpTopDown_renumber((TreeNode_T)LinkList_getValue(oLinkList), uiShared);
+}
+
+/*---------------------------------------------------------------------*/
+/*Extract the common subtrees of pllTrees into oExpProgram             */
+/*---------------------------------------------------------------------*/
+int ExpTopDown_apply(LinkList_T pllTrees, ExpProgram_T oExpProgram,\
+		     ExpBudget_T oExpBudget, unsigned int* puiShared){
+  struct TopDownForest fForest;
+  LinkList_T oLinkList;
+  TreeNode_T oTreeNodeTemp;
+  unsigned int uiIndex, uiShared;
+  int iStatus;
+  assert(oExpProgram != NULL);
+  assert(ExpProgram_howMany(oExpProgram) == 0u);
+  fForest.pllTrees = pllTrees;
+  fForest.poValues =\
+    (TreeNode_T*)malloc(INITIAL_STATEMENTS * sizeof(TreeNode_T));
+  if(fForest.poValues == NULL)
+    return 1;
+  fForest.uiLength = 0u;
+  fForest.uiMax = INITIAL_STATEMENTS;
+  fForest.oExpBudget = oExpBudget;
+  iStatus = ExpTopDown_extract(&fForest);
+  uiShared = fForest.uiLength;
+  //every tree that is left becomes one statement
+  for(oLinkList = pllTrees;
+      oLinkList != NULL && iStatus == 0;
+      oLinkList = LinkList_getNext(oLinkList)){
+    if(TreeNode_isLeaf((TreeNode_T)LinkList_getValue(oLinkList)))
+      continue;
+    oTreeNodeTemp = ExpTopDown_newTemp(fForest.uiLength);
+    if(oTreeNodeTemp == NULL ||\
+       ExpTopDown_push(&fForest,\
+		       (TreeNode_T)LinkList_getValue(oLinkList)) != 0){
+      if(oTreeNodeTemp != NULL)
+	ExpTokenTree_free(oTreeNodeTemp);
+      iStatus = 1;
+      break;
+    }
+    LinkList_setValue(oLinkList, oTreeNodeTemp);
+  }
+  //shared subtrees in reverse order of extraction, then the trees
+  for(uiIndex = 0u; uiIndex < fForest.uiLength; uiIndex++)
+    ExpTopDown_renumber(fForest.poValues[uiIndex], uiShared);
+  for(oLinkList = pllTrees;
+      oLinkList != NULL;
+      oLinkList = LinkList_getNext(oLinkList))
+    ExpTopDown_renumber((TreeNode_T)LinkList_getValue(oLinkList),\
+			uiShared);
+  for(uiIndex = 0u; uiIndex < fForest.uiLength; uiIndex++){
+    oTreeNodeTemp = (uiIndex < uiShared) ?\
+      fForest.poValues[uiShared - 1u - uiIndex] : fForest.poValues[uiIndex];
+    if(iStatus == 0 && ExpProgram_add(oExpProgram, oTreeNodeTemp) != 0)
+      iStatus = 1;
+    //a statement that could not be added is lost with the rest
+    if(ExpProgram_howMany(oExpProgram) <= uiIndex)
+      ExpTokenTree_free(oTreeNodeTemp);
+  }
+  if(puiShared != NULL)
+    *puiShared = uiShared;
+  free(fForest.poValues);
+  return iStatus;
+}
@@ -0,0 +1,34 @@
+/*---------------------------------------------------------------------*/
+/*Author: Owen Larrabee Coyle                                          */
+/*exptopdown.h describes a top-down strategy for extracting common     */
+/*subexpressions. Where ExpParser_simplify works up from the twigs,    */
+/*this names the largest repeated subtree first, so that a repeated    */
+/*subtree becomes a single temporary instead of being dismantled into  */
+/*many                                                                 */
+/*---------------------------------------------------------------------*/
+
+#ifndef EXPTOPDOWN_INCLUDED
+#define EXPTOPDOWN_INCLUDED
+
+#include "linklist.h"
+#include "expprogram.h"
+#include "expbudget.h"
+
+/*---------------------------------------------------------------------*/
+/*Repeatedly find the largest subtree that occurs at least twice in the*/
+/*trees stored in the list pllTrees, counting the statements already   */
+/*extracted, and replace every occurrence by a new temporary. Subtrees */
+/*are matched by a hash and compared up to the order of the operands of*/
+/*+ and *. Then give every tree that is not yet a single operand a     */
+/*temporary of its own, so that pllTrees is left holding only operands.*/
+/*The statements are appended to oExpProgram, which must be empty, in  */
+/*an order in which every temporary is assigned before it is used.     */
+/*Store the number of repeated subtrees extracted in puiShared if it is*/
+/*not NULL. Extraction stops early once oExpBudget, which may be NULL, */
+/*is exhausted. Return 0 if successful, 1 if memory is insufficient, in*/
+/*which case the program may be incomplete                             */
+/*---------------------------------------------------------------------*/
+int ExpTopDown_apply(LinkList_T pllTrees, ExpProgram_T oExpProgram,\
+		     ExpBudget_T oExpBudget, unsigned int* puiShared);
+
+#endif